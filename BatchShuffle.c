@@ -0,0 +1,350 @@
+#include "BatchShuffle.h"
+/* Seeds of the lanes */
+#include "PokerRandom.h"
+
+/* The vector path is only built for x86-64, other processors use scalar */
+#if defined(__x86_64__) && defined(__GNUC__)
+#define BATCH_SHUFFLE_AVX2 1
+/* immintrin.h is included for the AVX2 intrinsics. */
+#include <immintrin.h>
+#endif
+
+/* Rotate a 32 bit lane left */
+#define rotateLane(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
+
+/*
+  Function to seed the lanes of a batch generator.
+
+  Input   = {batchRng *: rng, uint64_t: seed, uint64_t: stream}
+  Output  = {void: NULL}
+*/
+void seedBatchRng(batchRng * rng, uint64_t seed, uint64_t stream)
+{
+  pokerRng seeder;
+  uint64_t bits = 0;
+  int laneNum = 0;
+  int wordNum = 0;
+
+  seedRng(& seeder, seed, stream);
+  for(laneNum = 0; laneNum < SHUFFLE_LANES; laneNum ++)
+  {
+    for(wordNum = 0; wordNum < BATCH_RNG_WORDS; wordNum += 2)
+    {
+      bits = nextRandom(& seeder);
+      rng->state[wordNum][laneNum] = (uint32_t)bits;
+      rng->state[wordNum + 1][laneNum] = (uint32_t)(bits >> 32);
+    }
+    /* A lane must never be all zero */
+    if((rng->state[0][laneNum] | rng->state[1][laneNum] |
+      rng->state[2][laneNum] | rng->state[3][laneNum]) == 0)
+    {
+      rng->state[0][laneNum] = 1;
+    }
+  }
+}
+
+/*
+  Function to fill a batch of decks with unshuffled cards.
+
+  Input   = {unsigned char *: decks, int: numOfDecks, int: deckSize}
+  Output  = {void: NULL}
+*/
+void initDeckBatch(unsigned char * decks, int numOfDecks, int deckSize)
+{
+  int cardNum = 0;
+  int deckNum = 0;
+  for(deckNum = 0; deckNum < numOfDecks; deckNum ++)
+  {
+    for(cardNum = 0; cardNum < deckSize; cardNum ++)
+    {
+      decks[deckNum * deckSize + cardNum] = cardNum;
+    }
+  }
+}
+
+/*
+  Function to step one lane of a batch generator, xoshiro128**.
+
+  Input   = {batchRng *: rng, int: laneNum}
+  Output  = {uint32_t: bits}
+*/
+static inline uint32_t nextLane(batchRng * rng, int laneNum)
+{
+  uint32_t s0 = rng->state[0][laneNum];
+  uint32_t s1 = rng->state[1][laneNum];
+  uint32_t s2 = rng->state[2][laneNum];
+  uint32_t s3 = rng->state[3][laneNum];
+  const uint32_t product = s1 * 5;
+  const uint32_t result = rotateLane(product, 7) * 9;
+  const uint32_t shifted = s1 << 9;
+
+  s2 ^= s0;
+  s3 ^= s1;
+  s1 ^= s2;
+  s0 ^= s3;
+  s2 ^= shifted;
+  s3 = rotateLane(s3, 11);
+  rng->state[0][laneNum] = s0;
+  rng->state[1][laneNum] = s1;
+  rng->state[2][laneNum] = s2;
+  rng->state[3][laneNum] = s3;
+  return result;
+}
+
+/*
+  Function to draw a value in [0, range) from one lane, rejecting the low
+  products that would over-represent small values. The rejection threshold,
+  2^32 mod range, is below range, so it is only worked out for the rare
+  products whose low word is below range.
+
+  Input   = {batchRng *: rng, int: laneNum, uint32_t: range}
+  Output  = {uint32_t: value}
+*/
+static inline uint32_t boundedLane(batchRng * rng, int laneNum,
+  uint32_t range)
+{
+  uint64_t product = (uint64_t)nextLane(rng, laneNum) * range;
+  uint32_t threshold = 0;
+  if((uint32_t)product < range)
+  {
+    threshold = (uint32_t)(- range) % range;
+    while((uint32_t)product < threshold)
+    {
+      product = (uint64_t)nextLane(rng, laneNum) * range;
+    }
+  }
+  return (uint32_t)(product >> 32);
+}
+
+/*
+  Function to swap a card of each deck of a group with the card each lane
+  selected further down the same deck.
+
+  Input   = {unsigned char *: decks, int: deckSize, int: firstDeck,
+            int: numOfLanes, int: cardNum, uint32_t *: offsets}
+  Output  = {void: NULL}
+*/
+static inline void swapGroupCards(unsigned char * decks, int deckSize,
+  int firstDeck, int numOfLanes, int cardNum, const uint32_t * offsets)
+{
+  unsigned char * position = decks + (size_t)firstDeck * deckSize + cardNum;
+  unsigned char tempCard = 0;
+  int laneNum = 0;
+  for(laneNum = 0; laneNum < numOfLanes; laneNum ++)
+  {
+    tempCard = position[0];
+    position[0] = position[offsets[laneNum]];
+    position[offsets[laneNum]] = tempCard;
+    position += deckSize;
+  }
+}
+
+/*
+  Function to shuffle one group of up to SHUFFLE_LANES decks one lane at a
+  time. This is the reference the vector path has to match.
+
+  Input   = {batchRng *: rng, unsigned char *: decks, int: deckSize,
+            int: dealt, int: firstDeck, int: numOfLanes}
+  Output  = {void: NULL}
+*/
+static void shuffleGroupScalar(batchRng * rng, unsigned char * decks,
+  int deckSize, int dealt, int firstDeck, int numOfLanes)
+{
+  uint32_t offsets[SHUFFLE_LANES];
+  uint32_t range = 0;
+  int cardNum = 0;
+  int laneNum = 0;
+  for(cardNum = 0; cardNum < dealt; cardNum ++)
+  {
+    range = deckSize - cardNum;
+    for(laneNum = 0; laneNum < numOfLanes; laneNum ++)
+    {
+      offsets[laneNum] = boundedLane(rng, laneNum, range);
+    }
+    swapGroupCards(decks, deckSize, firstDeck, numOfLanes, cardNum, offsets);
+  }
+}
+
+#ifdef BATCH_SHUFFLE_AVX2
+/*
+  Function to shuffle a number of full groups of SHUFFLE_LANES decks with
+  all lanes stepped and reduced in AVX2 registers. A lane whose product is
+  rejected redraws on its own with boundedLane, which keeps every lane's
+  sequence identical to the scalar path. As in boundedLane, lanes are first
+  compared with range, and only then with the threshold.
+
+  Input   = {batchRng *: rng, unsigned char *: decks, int: deckSize,
+            int: dealt, int: numOfGroups}
+  Output  = {void: NULL}
+*/
+__attribute__((target("avx2")))
+static void shuffleGroupsAvx2(batchRng * rng, unsigned char * decks,
+  int deckSize, int dealt, int numOfGroups)
+{
+  const __m256i signBit = _mm256_set1_epi32((int)0x80000000u);
+  __m256i s0 = _mm256_loadu_si256((const __m256i *)rng->state[0]);
+  __m256i s1 = _mm256_loadu_si256((const __m256i *)rng->state[1]);
+  __m256i s2 = _mm256_loadu_si256((const __m256i *)rng->state[2]);
+  __m256i s3 = _mm256_loadu_si256((const __m256i *)rng->state[3]);
+  __m256i result;
+  __m256i shifted;
+  __m256i rangeVector;
+  __m256i evenProducts;
+  __m256i oddProducts;
+  __m256i highWords;
+  __m256i lowWords;
+  uint32_t offsets[SHUFFLE_LANES];
+  uint32_t lowParts[SHUFFLE_LANES];
+  uint32_t range = 0;
+  uint32_t threshold = 0;
+  int suspect = 0;
+  int rejected = 0;
+  int groupNum = 0;
+  int cardNum = 0;
+  int laneNum = 0;
+
+  for(groupNum = 0; groupNum < numOfGroups; groupNum ++)
+  {
+    for(cardNum = 0; cardNum < dealt; cardNum ++)
+    {
+      range = deckSize - cardNum;
+      rangeVector = _mm256_set1_epi32((int)range);
+
+      /* xoshiro128** on every lane */
+      result = _mm256_add_epi32(_mm256_slli_epi32(s1, 2), s1);
+      result = _mm256_or_si256(_mm256_slli_epi32(result, 7),
+        _mm256_srli_epi32(result, 25));
+      result = _mm256_add_epi32(_mm256_slli_epi32(result, 3), result);
+      shifted = _mm256_slli_epi32(s1, 9);
+      s2 = _mm256_xor_si256(s2, s0);
+      s3 = _mm256_xor_si256(s3, s1);
+      s1 = _mm256_xor_si256(s1, s2);
+      s0 = _mm256_xor_si256(s0, s3);
+      s2 = _mm256_xor_si256(s2, shifted);
+      s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11),
+        _mm256_srli_epi32(s3, 21));
+
+      /* 32 x 32 bit products, even lanes then odd lanes */
+      evenProducts = _mm256_mul_epu32(result, rangeVector);
+      oddProducts = _mm256_mul_epu32(_mm256_srli_epi64(result, 32),
+        rangeVector);
+      highWords = _mm256_blend_epi32(_mm256_srli_epi64(evenProducts, 32),
+        oddProducts, 0xAA);
+      lowWords = _mm256_blend_epi32(evenProducts,
+        _mm256_slli_epi64(oddProducts, 32), 0xAA);
+      _mm256_storeu_si256((__m256i *)offsets, highWords);
+      /* Unsigned low < range, by comparing with the sign bits flipped */
+      suspect = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(
+        _mm256_xor_si256(rangeVector, signBit),
+        _mm256_xor_si256(lowWords, signBit))));
+      if(suspect != 0)
+      {
+        _mm256_storeu_si256((__m256i *)lowParts, lowWords);
+        threshold = (uint32_t)(- range) % range;
+        rejected = 0;
+        for(laneNum = 0; laneNum < SHUFFLE_LANES; laneNum ++)
+        {
+          if(((suspect >> laneNum) & 1) && (lowParts[laneNum] < threshold))
+          {
+            rejected |= 1 << laneNum;
+          }
+        }
+        if(rejected != 0)
+        {
+          _mm256_storeu_si256((__m256i *)rng->state[0], s0);
+          _mm256_storeu_si256((__m256i *)rng->state[1], s1);
+          _mm256_storeu_si256((__m256i *)rng->state[2], s2);
+          _mm256_storeu_si256((__m256i *)rng->state[3], s3);
+          for(laneNum = 0; laneNum < SHUFFLE_LANES; laneNum ++)
+          {
+            if((rejected >> laneNum) & 1)
+            {
+              offsets[laneNum] = boundedLane(rng, laneNum, range);
+            }
+          }
+          s0 = _mm256_loadu_si256((const __m256i *)rng->state[0]);
+          s1 = _mm256_loadu_si256((const __m256i *)rng->state[1]);
+          s2 = _mm256_loadu_si256((const __m256i *)rng->state[2]);
+          s3 = _mm256_loadu_si256((const __m256i *)rng->state[3]);
+        }
+      }
+      swapGroupCards(decks, deckSize, groupNum * SHUFFLE_LANES,
+        SHUFFLE_LANES, cardNum, offsets);
+    }
+  }
+  _mm256_storeu_si256((__m256i *)rng->state[0], s0);
+  _mm256_storeu_si256((__m256i *)rng->state[1], s1);
+  _mm256_storeu_si256((__m256i *)rng->state[2], s2);
+  _mm256_storeu_si256((__m256i *)rng->state[3], s3);
+}
+#endif
+
+/*
+  Function to determine the path shuffleDeckBatch uses on this processor.
+
+  Input   = {void: NULL}
+  Output  = {shufflePath: path}
+*/
+shufflePath batchShufflePath(void)
+{
+#ifdef BATCH_SHUFFLE_AVX2
+  /* libgcc fills in the processor features before main runs */
+  if(__builtin_cpu_supports("avx2"))
+  {
+    return ShuffleAvx2;
+  }
+#endif
+  return ShuffleScalar;
+}
+
+/*
+  Function to shuffle a batch of decks on a chosen path.
+
+  Input   = {batchRng *: rng, unsigned char *: decks, int: numOfDecks,
+            int: deckSize, int: dealt, shufflePath: path}
+  Output  = {void: NULL}
+*/
+void shuffleDeckBatchOn(batchRng * rng, unsigned char * decks, int numOfDecks,
+  int deckSize, int dealt, shufflePath path)
+{
+  int firstDeck = 0;
+  int numOfLanes = 0;
+
+  if(dealt > deckSize - 1)
+  {
+    dealt = deckSize - 1;
+  }
+  if(dealt < 1)
+  {
+    return;
+  }
+#ifdef BATCH_SHUFFLE_AVX2
+  if((path == ShuffleAvx2) && (batchShufflePath() == ShuffleAvx2))
+  {
+    shuffleGroupsAvx2(rng, decks, deckSize, dealt,
+      numOfDecks / SHUFFLE_LANES);
+    firstDeck = numOfDecks - numOfDecks % SHUFFLE_LANES;
+  }
+#endif
+  /* Scalar path, and the last partial group of the vector path */
+  for(; firstDeck < numOfDecks; firstDeck += SHUFFLE_LANES)
+  {
+    numOfLanes = (numOfDecks - firstDeck < SHUFFLE_LANES) ?
+      numOfDecks - firstDeck : SHUFFLE_LANES;
+    shuffleGroupScalar(rng, decks, deckSize, dealt, firstDeck, numOfLanes);
+  }
+}
+
+/*
+  Function to shuffle a batch of decks on the fastest path.
+
+  Input   = {batchRng *: rng, unsigned char *: decks, int: numOfDecks,
+            int: deckSize, int: dealt}
+  Output  = {void: NULL}
+*/
+void shuffleDeckBatch(batchRng * rng, unsigned char * decks, int numOfDecks,
+  int deckSize, int dealt)
+{
+  shuffleDeckBatchOn(rng, decks, numOfDecks, deckSize, dealt,
+    batchShufflePath());
+}
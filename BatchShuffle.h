@@ -0,0 +1,88 @@
+#ifndef BatchShuffle_h
+#define BatchShuffle_h
+
+/* Macros of the simulated Poker Table. */
+#include "PokerTable.h"
+
+/*
+  stdint.h is included for the 32 bit generator lanes.
+*/
+#include <stdint.h>
+
+/* Generator lanes, one deck each, shuffled side by side */
+#define SHUFFLE_LANES 8
+/* Words of the state of one xoshiro128** lane */
+#define BATCH_RNG_WORDS 4
+
+/*
+  Batch generator structure
+
+  SHUFFLE_LANES independent xoshiro128** generators stored word by word, so
+  that word w of every lane sits in state[w] and a whole step of all lanes is
+  a handful of vector instructions.
+*/
+typedef struct batchRng
+{
+  uint32_t state[BATCH_RNG_WORDS][SHUFFLE_LANES];
+} batchRng;
+
+/* Code paths of the batch shuffle */
+typedef enum shufflePath
+{
+  ShuffleScalar, ShuffleAvx2
+} shufflePath;
+
+/*
+  Function to seed the lanes of a batch generator from a seed and a stream
+  number, the same way seedRng seeds a pokerRng.
+
+  Input   = {batchRng *: rng, uint64_t: seed, uint64_t: stream}
+  Output  = {void: NULL}
+*/
+void seedBatchRng(batchRng *, uint64_t, uint64_t);
+
+/*
+  Function to fill a batch of decks with the unshuffled card indices. The
+  decks of a batch lie back to back, card c of deck d is
+  decks[d * deckSize + c].
+
+  Input   = {unsigned char *: decks, int: numOfDecks, int: deckSize}
+  Output  = {void: NULL}
+*/
+void initDeckBatch(unsigned char *, int, int);
+
+/*
+  Function to shuffle a batch of decks with Fisher-Yates. Decks are taken
+  SHUFFLE_LANES at a time, deck d drawing from lane d % SHUFFLE_LANES, so one
+  step of all lanes supplies the next swap of a whole group of decks. Each
+  draw is reduced to its range with Lemire's multiply and reject method. As
+  with shuffleCardIndices only the first dealt cards of each deck are
+  guaranteed to be a uniform random selection. Both paths give identical
+  decks and leave the generator in the same state.
+
+  Input   = {batchRng *: rng, unsigned char *: decks, int: numOfDecks,
+            int: deckSize, int: dealt}
+  Output  = {void: NULL}
+*/
+void shuffleDeckBatch(batchRng *, unsigned char *, int, int, int);
+
+/*
+  Function to shuffle a batch of decks on a chosen path, falling back to the
+  scalar path when the processor lacks AVX2.
+
+  Input   = {batchRng *: rng, unsigned char *: decks, int: numOfDecks,
+            int: deckSize, int: dealt, shufflePath: path}
+  Output  = {void: NULL}
+*/
+void shuffleDeckBatchOn(batchRng *, unsigned char *, int, int, int,
+  shufflePath);
+
+/*
+  Function to determine the path shuffleDeckBatch uses on this processor.
+
+  Input   = {void: NULL}
+  Output  = {shufflePath: path}
+*/
+shufflePath batchShufflePath(void);
+
+#endif /* BatchShuffle_h */
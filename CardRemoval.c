@@ -0,0 +1,228 @@
+#include "CardRemoval.h"
+/* Binomial coefficients */
+#include "Combinatorics.h"
+
+/* string.h is included for memset. */
+#include <string.h>
+
+/* Cards in a hand of every rank distinct, and straights counting the wheel */
+#define DISTINCT_RANKS CARDS_PER_HAND
+#define NUM_OF_STRAIGHTS 10
+/* Ranks of a straight as bits, from its lowest rank, the Ace low */
+#define STRAIGHT_BITS 0x1F
+/* Ten to Ace, the Ace being rank 0 */
+#define BROADWAY_BITS (0x1E00 | 0x1)
+
+/*
+  Function to give the ranks of a straight as bits, numbered from its
+  lowest rank, A-2-3-4-5 being 0 and T-J-Q-K-A 9.
+
+  Input   = {int: straightNum}
+  Output  = {unsigned int: rankBits}
+*/
+static unsigned int straightRanks(int straightNum)
+{
+  if(straightNum == NUM_OF_STRAIGHTS - 1)
+  {
+    return BROADWAY_BITS;
+  }
+  return STRAIGHT_BITS << straightNum;
+}
+
+/*
+  Function to give the elementary symmetric sums of the cards left of each
+  rank, sums[k] being the ways to pick k cards of k different ranks.
+
+  Input   = {int *: left, uint64_t *: sums}
+  Output  = {void: NULL}
+*/
+static void symmetricSums(const int left[NUM_OF_RANKS],
+  uint64_t sums[DISTINCT_RANKS + 1])
+{
+  int rankNum = NUM_INIT;
+  int size = NUM_INIT;
+
+  memset(sums, 0, sizeof(uint64_t) * (DISTINCT_RANKS + 1));
+  sums[0] = 1;
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_RANKS; rankNum ++)
+  {
+    for(size = DISTINCT_RANKS; size > 0; size --)
+    {
+      sums[size] += sums[size - 1] * left[rankNum];
+    }
+  }
+}
+
+/*
+  Function to take one rank out of elementary symmetric sums, leaving the
+  ways to pick cards of different ranks none of which is that rank.
+
+  Input   = {uint64_t *: sums, int: count, uint64_t *: without}
+  Output  = {void: NULL}
+*/
+static void sumsWithout(const uint64_t sums[DISTINCT_RANKS + 1], int count,
+  uint64_t without[DISTINCT_RANKS + 1])
+{
+  int size = NUM_INIT;
+
+  without[0] = 1;
+  for(size = 1; size <= DISTINCT_RANKS; size ++)
+  {
+    without[size] = sums[size] - count * without[size - 1];
+  }
+}
+
+/*
+  Function to count the hands made of repeated ranks: pairs, two pairs,
+  trips, full houses and quads.
+
+  Input   = {int *: left, int: numOfUnseen, uint64_t *: sums,
+            uint64_t *: counts}
+  Output  = {void: NULL}
+*/
+static void countRepeatedRanks(const int left[NUM_OF_RANKS], int numOfUnseen,
+  const uint64_t sums[DISTINCT_RANKS + 1], uint64_t * counts)
+{
+  uint64_t without[DISTINCT_RANKS + 1];
+  uint64_t pairsLeft = 0;
+  int rankNum = NUM_INIT;
+  int otherNum = NUM_INIT;
+
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_RANKS; rankNum ++)
+  {
+    pairsLeft += choose(left[rankNum], 2);
+  }
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_RANKS; rankNum ++)
+  {
+    if(left[rankNum] < 2)
+    {
+      continue;
+    }
+    sumsWithout(sums, left[rankNum], without);
+    counts[Pair] += choose(left[rankNum], 2) * without[3];
+    counts[ThreeOfAKind] += choose(left[rankNum], 3) * without[2];
+    counts[FullHouse] += choose(left[rankNum], 3) *
+      (pairsLeft - choose(left[rankNum], 2));
+    counts[FourOfAKind] += choose(left[rankNum], 4) *
+      (numOfUnseen - left[rankNum]);
+    for(otherNum = rankNum + 1; otherNum < NUM_OF_RANKS; otherNum ++)
+    {
+      counts[TwoPair] += choose(left[rankNum], 2) *
+        choose(left[otherNum], 2) *
+        (numOfUnseen - left[rankNum] - left[otherNum]);
+    }
+  }
+}
+
+/*
+  Function to count the hands of five different ranks: straight flushes,
+  flushes, straights and high cards.
+
+  Input   = {int *: left, unsigned int *: suitRanks, uint64_t *: sums,
+            uint64_t *: counts}
+  Output  = {void: NULL}
+*/
+static void countDistinctRanks(const int left[NUM_OF_RANKS],
+  const unsigned int suitRanks[NUM_OF_SUITS],
+  const uint64_t sums[DISTINCT_RANKS + 1], uint64_t * counts)
+{
+  uint64_t straights = 0;
+  uint64_t flushes = 0;
+  uint64_t straightFlushes = 0;
+  uint64_t product = 0;
+  unsigned int ranks = 0;
+  int straightNum = NUM_INIT;
+  int suitNum = NUM_INIT;
+  int rankNum = NUM_INIT;
+
+  for(straightNum = NUM_INIT; straightNum < NUM_OF_STRAIGHTS; straightNum ++)
+  {
+    ranks = straightRanks(straightNum);
+    product = 1;
+    for(rankNum = NUM_INIT; rankNum < NUM_OF_RANKS; rankNum ++)
+    {
+      if((ranks >> rankNum) & 1)
+      {
+        product *= left[rankNum];
+      }
+    }
+    straights += product;
+    for(suitNum = NUM_INIT; suitNum < NUM_OF_SUITS; suitNum ++)
+    {
+      if((suitRanks[suitNum] & ranks) == ranks)
+      {
+        straightFlushes ++;
+      }
+    }
+  }
+  for(suitNum = NUM_INIT; suitNum < NUM_OF_SUITS; suitNum ++)
+  {
+    flushes += choose(__builtin_popcount(suitRanks[suitNum]), DISTINCT_RANKS);
+  }
+  counts[StraightFlush] = straightFlushes;
+  counts[Flush] = flushes - straightFlushes;
+  counts[Straight] = straights - straightFlushes;
+  counts[HighCard] = sums[DISTINCT_RANKS] - straights - flushes +
+    straightFlushes;
+}
+
+/*
+  Function to count the five card hands an unseen opponent can hold in each
+  category.
+
+  Input   = {unsigned char *: seen, int: numOfSeen, removalOdds *: odds}
+  Output  = {bool: success}
+*/
+bool cardRemovalOdds(const unsigned char * seen, int numOfSeen,
+  removalOdds * odds)
+{
+  uint64_t seenCards = 0;
+  uint64_t sums[DISTINCT_RANKS + 1];
+  unsigned int suitRanks[NUM_OF_SUITS];
+  int left[NUM_OF_RANKS];
+  int cardNum = NUM_INIT;
+  int rankNum = NUM_INIT;
+  int suitNum = NUM_INIT;
+
+  if((numOfSeen < 0) || (numOfSeen > STD_DECK_SIZE - CARDS_PER_HAND))
+  {
+    return FALSE;
+  }
+  for(cardNum = NUM_INIT; cardNum < numOfSeen; cardNum ++)
+  {
+    if((seen[cardNum] >= STD_DECK_SIZE) ||
+      ((seenCards >> seen[cardNum]) & 1))
+    {
+      return FALSE;
+    }
+    seenCards |= 1ULL << seen[cardNum];
+  }
+
+  memset(odds, 0, sizeof(removalOdds));
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_RANKS; rankNum ++)
+  {
+    left[rankNum] = NUM_OF_SUITS;
+  }
+  for(suitNum = NUM_INIT; suitNum < NUM_OF_SUITS; suitNum ++)
+  {
+    suitRanks[suitNum] = (1U << NUM_OF_RANKS) - 1;
+  }
+  for(cardNum = NUM_INIT; cardNum < numOfSeen; cardNum ++)
+  {
+    left[seen[cardNum] / NUM_OF_SUITS] --;
+    suitRanks[seen[cardNum] % NUM_OF_SUITS] &=
+      ~(1U << (seen[cardNum] / NUM_OF_SUITS));
+  }
+  odds->numOfUnseen = STD_DECK_SIZE - numOfSeen;
+  odds->numOfHands = choose(odds->numOfUnseen, CARDS_PER_HAND);
+
+  symmetricSums(left, sums);
+  countRepeatedRanks(left, odds->numOfUnseen, sums, odds->counts);
+  countDistinctRanks(left, suitRanks, sums, odds->counts);
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+  {
+    odds->probabilities[rankNum] = (double)odds->counts[rankNum] /
+      odds->numOfHands;
+  }
+  return TRUE;
+}
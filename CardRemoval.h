@@ -0,0 +1,44 @@
+#ifndef CardRemoval_h
+#define CardRemoval_h
+
+/* Cards and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+
+/*
+  stdint.h is included for the hand counts.
+*/
+#include <stdint.h>
+
+/*
+  Removal odds structure, the chances of the five card hands that can be
+  dealt from the unseen cards.
+
+    numOfUnseen   - cards left to deal from
+    numOfHands    - five card hands among them
+    counts        - hands of each category
+    probabilities - counts over numOfHands
+*/
+typedef struct removalOdds
+{
+  int numOfUnseen;
+  uint64_t numOfHands;
+  uint64_t counts[NUM_OF_HAND_RANKS];
+  double probabilities[NUM_OF_HAND_RANKS];
+} removalOdds;
+
+/*
+  Function to count, for each hand category, the five card hands an unseen
+  opponent can hold once some cards have been seen. Nothing is enumerated:
+  pairs, trips, quads and full houses are counted from how many cards of
+  each rank are left, with elementary symmetric sums over the other ranks
+  for the kickers, and hands of five distinct ranks from the cards left of
+  each suit and of each of the ten straights. It takes well under a
+  microsecond and can be called from decision loops.
+
+  Input   = {unsigned char *: seen, int: numOfSeen, removalOdds *: odds}
+  Output  = {bool: success}, FALSE when a card repeats or is not a card,
+            or fewer than five are unseen
+*/
+bool cardRemovalOdds(const unsigned char *, int, removalOdds *);
+
+#endif /* CardRemoval_h */
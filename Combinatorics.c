@@ -0,0 +1,110 @@
+#include "Combinatorics.h"
+
+uint64_t binomialTable[MAX_CHOOSE_N + 1][MAX_CHOOSE_N + 1];
+
+/*
+  Function to fill the binomial table with Pascal's rule, run before main so
+  no caller has to remember to initialize it.
+
+  Input   = {void: NULL}
+  Output  = {void: NULL}
+*/
+__attribute__((constructor(101))) static void fillBinomialTable(void)
+{
+  int n = 0;
+  int k = 0;
+  for(n = 0; n <= MAX_CHOOSE_N; n ++)
+  {
+    binomialTable[n][0] = 1;
+    for(k = 1; k <= n; k ++)
+    {
+      binomialTable[n][k] = binomialTable[n - 1][k - 1] +
+        ((k < n) ? binomialTable[n - 1][k] : 0);
+    }
+  }
+}
+
+/*
+  Function to determine the colex index of a combination.
+
+  Input   = {unsigned char *: positions, int: size}
+  Output  = {uint64_t: index}
+*/
+uint64_t rankCombination(const unsigned char * positions, int size)
+{
+  uint64_t index = 0;
+  int memberNum = 0;
+  for(memberNum = 0; memberNum < size; memberNum ++)
+  {
+    index += choose(positions[memberNum], memberNum + 1);
+  }
+  return index;
+}
+
+/*
+  Function to find the combination with a given colex index. The largest
+  member is the largest position whose C(position, size) still fits in the
+  index, then the remainder is unranked one member smaller.
+
+  Input   = {uint64_t: index, int: size, unsigned char *: positions}
+  Output  = {void: NULL}
+*/
+void unrankCombination(uint64_t index, int size, unsigned char * positions)
+{
+  int memberNum = 0;
+  int position = MAX_CHOOSE_N;
+  for(memberNum = size - 1; memberNum >= 0; memberNum --)
+  {
+    while(choose(position, memberNum + 1) > index)
+    {
+      position --;
+    }
+    positions[memberNum] = position;
+    index -= choose(position, memberNum + 1);
+    position --;
+  }
+}
+
+/*
+  Function to step a combination to the combination with the next colex
+  index. The lowest member that can move up one place does so and every
+  member below it returns to the bottom.
+
+  Input   = {unsigned char *: positions, int: size, int: poolSize}
+  Output  = {bool: stepped}
+*/
+bool nextCombination(unsigned char * positions, int size, int poolSize)
+{
+  int memberNum = 0;
+  int lowerNum = 0;
+  int limit = 0;
+  for(memberNum = 0; memberNum < size; memberNum ++)
+  {
+    limit = (memberNum + 1 < size) ? positions[memberNum + 1] : poolSize;
+    if(positions[memberNum] + 1 < limit)
+    {
+      positions[memberNum] ++;
+      for(lowerNum = 0; lowerNum < memberNum; lowerNum ++)
+      {
+        positions[lowerNum] = lowerNum;
+      }
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/*
+  Function to multiply two counts, reporting overflow.
+
+  Input   = {uint64_t: first, uint64_t: second, uint64_t *: product}
+  Output  = {bool: success}
+*/
+bool multiplyCounts(uint64_t first, uint64_t second, uint64_t * product)
+{
+  if(__builtin_mul_overflow(first, second, product))
+  {
+    return FALSE;
+  }
+  return TRUE;
+}
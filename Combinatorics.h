@@ -0,0 +1,63 @@
+#ifndef Combinatorics_h
+#define Combinatorics_h
+
+/* Macros for the simulated Poker Table. */
+#include "PokerTable.h"
+
+/*
+  stdint.h is included for the 64 bit combination counts.
+*/
+#include <stdint.h>
+
+/* Largest n of the binomial table, one deck of cards */
+#define MAX_CHOOSE_N STD_DECK_SIZE
+
+/*
+  Table of binomial coefficients C(n, k) for 0 <= k <= n <= MAX_CHOOSE_N. It
+  is filled before main runs.
+*/
+extern uint64_t binomialTable[MAX_CHOOSE_N + 1][MAX_CHOOSE_N + 1];
+
+/* Binomial coefficient, zero when k is out of range */
+#define choose(n, k) \
+  (((int64_t)(k) < 0 || (int64_t)(k) > (int64_t)(n)) ? 0 : \
+  binomialTable[(n)][(k)])
+
+/*
+  Function to determine the colex index of a combination, given the positions
+  of its members in ascending order. The index is the sum of C(position, i + 1)
+  over the members, so combinations of the first n positions are numbered
+  0 to C(n, k) - 1.
+
+  Input   = {unsigned char *: positions, int: size}
+  Output  = {uint64_t: index}
+*/
+uint64_t rankCombination(const unsigned char *, int);
+
+/*
+  Function to find the combination with a given colex index, writing the
+  positions of its members in ascending order.
+
+  Input   = {uint64_t: index, int: size, unsigned char *: positions}
+  Output  = {void: NULL}
+*/
+void unrankCombination(uint64_t, int, unsigned char *);
+
+/*
+  Function to step a combination of positions below a pool size to the
+  combination with the next colex index.
+
+  Input   = {unsigned char *: positions, int: size, int: poolSize}
+  Output  = {bool: stepped}, FALSE after the last combination
+*/
+bool nextCombination(unsigned char *, int, int);
+
+/*
+  Function to multiply two counts, reporting overflow.
+
+  Input   = {uint64_t: first, uint64_t: second, uint64_t *: product}
+  Output  = {bool: success}
+*/
+bool multiplyCounts(uint64_t, uint64_t, uint64_t *);
+
+#endif /* Combinatorics_h */
@@ -0,0 +1,603 @@
+#include "DrawSolver.h"
+/* Binomial coefficients and colex combination indices */
+#include "Combinatorics.h"
+/* Colex hand indices */
+#include "HandIndex.h"
+/* Suit canonical classes, one hand of each to list the strengths */
+#include "SuitIsomorphism.h"
+/* Worker threads */
+#include "PokerThreads.h"
+
+/* pthread.h is included for the lock around building the tables. */
+#include <pthread.h>
+/* stdatomic.h is included for the chunk counters and the ready flag. */
+#include <stdatomic.h>
+/* string.h is included for memset. */
+#include <string.h>
+
+/* Sizes of the card sets whose hands are tabled */
+#define MIN_TABLED_SET 1
+#define MAX_TABLED_SET (CARDS_PER_HAND - 1)
+/* Card sets handed to a thread at a time */
+#define SETS_PER_CHUNK 1024
+
+/*
+  Outcomes of the five card hands containing a set of cards: how many end in
+  each hand rank, and the sum of their dense strength ranks. A set of one
+  card is in C(51, 4) hands, so even the rank sums fit in 32 bits.
+*/
+typedef struct drawTally
+{
+  uint32_t categoryCounts[NUM_OF_HAND_RANKS];
+  uint32_t rankSum;
+} drawTally;
+
+/* Outcomes in 64 bits, for sums over several tallies */
+typedef struct wideTally
+{
+  int64_t categoryCounts[NUM_OF_HAND_RANKS];
+  int64_t rankSum;
+} wideTally;
+
+/* State shared by the threads building one level of the tables */
+typedef struct buildContext
+{
+  int setSize;
+  uint64_t numOfSets;
+  atomic_ullong nextChunk;
+} buildContext;
+
+/* State shared by the threads solving a table */
+typedef struct tableContext
+{
+  const unsigned char (* hands)[CARDS_PER_HAND];
+  int numOfHands;
+  drawObjective objective;
+  drawSolution * solutions;
+  atomic_int nextHand;
+  atomic_int failures;
+} tableContext;
+
+/* Every distinct strength in ascending order, its position is its rank */
+static handStrength distinctStrengths[NUM_OF_DISTINCT_STRENGTHS];
+static int numOfDistinctStrengths = 0;
+/* Dense rank of every five card hand by colex index, while building */
+static unsigned short * handDenseRanks = NULL;
+/* Tallies of the card sets of each size, by colex index */
+static drawTally * setTallies[MAX_TABLED_SET + 1];
+/* Tally of every five card hand, the empty set */
+static wideTally allHandsTally;
+static pthread_mutex_t prepareLock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int solverReady = 0;
+
+/* Order strengths for qsort */
+static int compareStrengths(const void * first, const void * second)
+{
+  const handStrength firstStrength = * (const handStrength *)first;
+  const handStrength secondStrength = * (const handStrength *)second;
+  return (firstStrength > secondStrength) - (firstStrength < secondStrength);
+}
+
+/*
+  Function to find the dense rank of a five card strength by binary search.
+
+  Input   = {handStrength: strength}
+  Output  = {int: denseRank}
+*/
+int strengthDenseRank(handStrength strength)
+{
+  int low = 0;
+  int high = numOfDistinctStrengths - 1;
+  int middle = 0;
+
+  if(numOfDistinctStrengths != NUM_OF_DISTINCT_STRENGTHS)
+  {
+    return INVALID_INT;
+  }
+  while(low < high)
+  {
+    middle = (low + high) / 2;
+    if(distinctStrengths[middle] < strength)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  return (distinctStrengths[low] == strength) ? low : INVALID_INT;
+}
+
+/*
+  Function to list the distinct strengths from one hand of every suit class.
+
+  Input   = {void: NULL}
+  Output  = {bool: success}
+*/
+static bool listDistinctStrengths(void)
+{
+  const canonicalClass * classes = NULL;
+  handStrength * strengths = NULL;
+  unsigned char cards[CARDS_PER_HAND];
+  int numOfClasses = 0;
+  int classNum = 0;
+
+  classes = canonicalFiveCardClasses(& numOfClasses);
+  strengths = malloc(sizeof(handStrength) * numOfClasses);
+  if((classes == NULL) || (strengths == NULL))
+  {
+    free(strengths);
+    return FALSE;
+  }
+  for(classNum = 0; classNum < numOfClasses; classNum ++)
+  {
+    unrankHandIndices(classes[classNum].index, cards);
+    strengths[classNum] = evaluateCardIndices(cards, CARDS_PER_HAND);
+  }
+  qsort(strengths, numOfClasses, sizeof(handStrength), compareStrengths);
+  numOfDistinctStrengths = 0;
+  for(classNum = 0; classNum < numOfClasses; classNum ++)
+  {
+    if((classNum == 0) || (strengths[classNum] != strengths[classNum - 1]))
+    {
+      if(numOfDistinctStrengths == NUM_OF_DISTINCT_STRENGTHS)
+      {
+        numOfDistinctStrengths ++;
+        break;
+      }
+      distinctStrengths[numOfDistinctStrengths ++] = strengths[classNum];
+    }
+  }
+  free(strengths);
+  return (numOfDistinctStrengths == NUM_OF_DISTINCT_STRENGTHS) ? TRUE : FALSE;
+}
+
+/*
+  Function run by each thread ranking every five card hand, taking the
+  hands with one highest card at a time.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void rankHandsWorker(void * argument, int threadNum)
+{
+  buildContext * context = argument;
+  unsigned char cards[CARDS_PER_HAND];
+  uint64_t topCard = 0;
+  handIndex index = 0;
+  handIndex lastIndex = 0;
+  (void)threadNum;
+
+  while((topCard = atomic_fetch_add(& context->nextChunk, 1)) <
+    context->numOfSets)
+  {
+    topCard += CARDS_PER_HAND - 1;
+    index = (handIndex)choose((int)topCard, CARDS_PER_HAND);
+    lastIndex = (handIndex)choose((int)topCard + 1, CARDS_PER_HAND);
+    unrankHandIndices(index, cards);
+    do
+    {
+      handDenseRanks[index] = (unsigned short)strengthDenseRank(
+        evaluateCardIndices(cards, CARDS_PER_HAND));
+      index ++;
+    } while((index < lastIndex) &&
+      (nextCombination(cards, CARDS_PER_HAND, STD_DECK_SIZE) == TRUE));
+  }
+}
+
+/*
+  Function to add one card to a sorted set of cards, keeping it sorted.
+
+  Input   = {unsigned char *: set, int: setSize, unsigned char: card,
+            unsigned char *: larger}
+  Output  = {void: NULL}
+*/
+static void insertCard(const unsigned char * set, int setSize,
+  unsigned char card, unsigned char * larger)
+{
+  int memberNum = 0;
+  int largerNum = 0;
+  for(memberNum = 0; memberNum < setSize; memberNum ++)
+  {
+    if((card < set[memberNum]) && (largerNum == memberNum))
+    {
+      larger[largerNum ++] = card;
+    }
+    larger[largerNum ++] = set[memberNum];
+  }
+  if(largerNum == setSize)
+  {
+    larger[largerNum] = card;
+  }
+}
+
+/*
+  Function run by each thread filling the tallies of the card sets of one
+  size. Sets of four cards add up the hands they complete; smaller sets add
+  up the tallies of the sets one card larger, which counts every hand once
+  for each card it has beyond the set, and divide by that number.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void tallySetsWorker(void * argument, int threadNum)
+{
+  buildContext * context = argument;
+  const int setSize = context->setSize;
+  const uint32_t repeats = CARDS_PER_HAND - setSize;
+  const drawTally * largerTallies = (setSize < MAX_TABLED_SET) ?
+    setTallies[setSize + 1] : NULL;
+  drawTally * tally = NULL;
+  unsigned char set[MAX_TABLED_SET];
+  unsigned char larger[CARDS_PER_HAND];
+  uint64_t chunk = 0;
+  uint64_t setNum = 0;
+  uint64_t lastSet = 0;
+  uint64_t sums[NUM_OF_HAND_RANKS + 1];
+  unsigned short denseRank = 0;
+  int card = 0;
+  int memberNum = 0;
+  int rankNum = 0;
+  (void)threadNum;
+
+  while((chunk = atomic_fetch_add(& context->nextChunk, 1)) * SETS_PER_CHUNK <
+    context->numOfSets)
+  {
+    setNum = chunk * SETS_PER_CHUNK;
+    lastSet = setNum + SETS_PER_CHUNK;
+    if(lastSet > context->numOfSets)
+    {
+      lastSet = context->numOfSets;
+    }
+    for(; setNum < lastSet; setNum ++)
+    {
+      unrankCombination(setNum, setSize, set);
+      tally = & setTallies[setSize][setNum];
+      memset(sums, 0, sizeof(sums));
+      memberNum = 0;
+      for(card = 0; card < STD_DECK_SIZE; card ++)
+      {
+        if((memberNum < setSize) && (set[memberNum] == card))
+        {
+          memberNum ++;
+          continue;
+        }
+        insertCard(set, setSize, card, larger);
+        if(setSize == MAX_TABLED_SET)
+        {
+          denseRank = handDenseRanks[rankCombination(larger, CARDS_PER_HAND)];
+          sums[strengthCategory(distinctStrengths[denseRank])] ++;
+          sums[NUM_OF_HAND_RANKS] += denseRank;
+        }
+        else
+        {
+          const drawTally * largerTally =
+            & largerTallies[rankCombination(larger, setSize + 1)];
+          for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+          {
+            sums[rankNum] += largerTally->categoryCounts[rankNum];
+          }
+          sums[NUM_OF_HAND_RANKS] += largerTally->rankSum;
+        }
+      }
+      for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+      {
+        tally->categoryCounts[rankNum] = (uint32_t)(sums[rankNum] / repeats);
+      }
+      tally->rankSum = (uint32_t)(sums[NUM_OF_HAND_RANKS] / repeats);
+    }
+  }
+}
+
+/*
+  Function to run one building step on a number of threads.
+
+  Input   = {parallelTask: task, int: setSize, uint64_t: numOfSets,
+            int: numOfThreads}
+  Output  = {void: NULL}
+*/
+static void runBuildStep(parallelTask task, int setSize, uint64_t numOfSets,
+  int numOfThreads)
+{
+  buildContext context;
+  context.setSize = setSize;
+  context.numOfSets = numOfSets;
+  atomic_init(& context.nextChunk, 0);
+  runParallel(numOfThreads, task, & context);
+}
+
+/*
+  Function to build the tables of the solver.
+
+  Input   = {int: numOfThreads}
+  Output  = {bool: success}
+*/
+bool prepareDrawSolver(int numOfThreads)
+{
+  const drawTally * singles = NULL;
+  int setSize = 0;
+  int card = 0;
+  int rankNum = 0;
+  bool success = TRUE;
+
+  if(atomic_load_explicit(& solverReady, memory_order_acquire) != 0)
+  {
+    return TRUE;
+  }
+  pthread_mutex_lock(& prepareLock);
+  if(atomic_load_explicit(& solverReady, memory_order_relaxed) != 0)
+  {
+    pthread_mutex_unlock(& prepareLock);
+    return TRUE;
+  }
+  if(listDistinctStrengths() == FALSE)
+  {
+    pthread_mutex_unlock(& prepareLock);
+    return FALSE;
+  }
+  handDenseRanks = malloc(sizeof(unsigned short) * NUM_OF_FIVE_CARD_HANDS);
+  for(setSize = MIN_TABLED_SET; setSize <= MAX_TABLED_SET; setSize ++)
+  {
+    setTallies[setSize] = malloc(sizeof(drawTally) *
+      choose(STD_DECK_SIZE, setSize));
+    success = ((setTallies[setSize] != NULL) && (success == TRUE)) ?
+      TRUE : FALSE;
+  }
+  if((handDenseRanks == NULL) || (success == FALSE))
+  {
+    for(setSize = MIN_TABLED_SET; setSize <= MAX_TABLED_SET; setSize ++)
+    {
+      free(setTallies[setSize]);
+      setTallies[setSize] = NULL;
+    }
+    free(handDenseRanks);
+    handDenseRanks = NULL;
+    pthread_mutex_unlock(& prepareLock);
+    return FALSE;
+  }
+
+  runBuildStep(rankHandsWorker, CARDS_PER_HAND,
+    STD_DECK_SIZE - CARDS_PER_HAND + 1, numOfThreads);
+  for(setSize = MAX_TABLED_SET; setSize >= MIN_TABLED_SET; setSize --)
+  {
+    runBuildStep(tallySetsWorker, setSize, choose(STD_DECK_SIZE, setSize),
+      numOfThreads);
+  }
+  free(handDenseRanks);
+  handDenseRanks = NULL;
+
+  /* Every hand holds five single cards */
+  memset(& allHandsTally, 0, sizeof(allHandsTally));
+  singles = setTallies[MIN_TABLED_SET];
+  for(card = 0; card < STD_DECK_SIZE; card ++)
+  {
+    for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+    {
+      allHandsTally.categoryCounts[rankNum] +=
+        singles[card].categoryCounts[rankNum];
+    }
+    allHandsTally.rankSum += singles[card].rankSum;
+  }
+  for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+  {
+    allHandsTally.categoryCounts[rankNum] /= CARDS_PER_HAND;
+  }
+  allHandsTally.rankSum /= CARDS_PER_HAND;
+
+  atomic_store_explicit(& solverReady, 1, memory_order_release);
+  pthread_mutex_unlock(& prepareLock);
+  return TRUE;
+}
+
+/*
+  Function to find the tally of the hands containing a set of cards of a
+  hand, given as a mask over the hand's positions.
+
+  Input   = {unsigned char *: hand, int: mask, wideTally *: tally}
+  Output  = {bool: success}
+*/
+static bool subsetTally(const unsigned char * hand, int mask,
+  wideTally * tally)
+{
+  const drawTally * tabled = NULL;
+  unsigned char set[CARDS_PER_HAND];
+  unsigned char swapped = 0;
+  int setSize = 0;
+  int cardNum = 0;
+  int denseRank = 0;
+  int rankNum = 0;
+
+  for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    if((mask >> cardNum) & 1)
+    {
+      set[setSize ++] = hand[cardNum];
+    }
+  }
+  if(setSize == 0)
+  {
+    * tally = allHandsTally;
+    return TRUE;
+  }
+  memset(tally, 0, sizeof(* tally));
+  if(setSize == CARDS_PER_HAND)
+  {
+    denseRank = strengthDenseRank(evaluateCardIndices(set, CARDS_PER_HAND));
+    if(denseRank == INVALID_INT)
+    {
+      return FALSE;
+    }
+    tally->categoryCounts[strengthCategory(distinctStrengths[denseRank])] = 1;
+    tally->rankSum = denseRank;
+    return TRUE;
+  }
+  /* Insertion sort, the colex index needs ascending cards */
+  for(cardNum = 1; cardNum < setSize; cardNum ++)
+  {
+    for(rankNum = cardNum; (rankNum > 0) && (set[rankNum] < set[rankNum - 1]);
+      rankNum --)
+    {
+      swapped = set[rankNum];
+      set[rankNum] = set[rankNum - 1];
+      set[rankNum - 1] = swapped;
+    }
+  }
+  tabled = & setTallies[setSize][rankCombination(set, setSize)];
+  for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+  {
+    tally->categoryCounts[rankNum] = tabled->categoryCounts[rankNum];
+  }
+  tally->rankSum = tabled->rankSum;
+  return TRUE;
+}
+
+/*
+  Function to solve one hand.
+
+  Input   = {unsigned char [CARDS_PER_HAND]: hand, drawObjective: objective,
+            drawSolution *: solution}
+  Output  = {bool: success}
+*/
+bool solveDraw(const unsigned char hand[CARDS_PER_HAND],
+  drawObjective objective, drawSolution * solution)
+{
+  wideTally tallies[NUM_OF_DRAW_OPTIONS];
+  const int allCards = NUM_OF_DRAW_OPTIONS - 1;
+  drawOption * option = NULL;
+  uint64_t seen = 0;
+  int64_t sums[NUM_OF_HAND_RANKS + 1];
+  int64_t sign = 1;
+  double score = 0.0;
+  double bestScore = -1.0;
+  int held = 0;
+  int extra = 0;
+  int cardNum = 0;
+  int rankNum = 0;
+
+  if(atomic_load_explicit(& solverReady, memory_order_acquire) == 0)
+  {
+    return FALSE;
+  }
+  for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    if((hand[cardNum] >= STD_DECK_SIZE) || ((seen >> hand[cardNum]) & 1))
+    {
+      return FALSE;
+    }
+    seen |= 1ULL << hand[cardNum];
+  }
+  for(held = 0; held < NUM_OF_DRAW_OPTIONS; held ++)
+  {
+    if(subsetTally(hand, held, & tallies[held]) == FALSE)
+    {
+      return FALSE;
+    }
+  }
+
+  solution->best = 0;
+  for(held = 0; held < NUM_OF_DRAW_OPTIONS; held ++)
+  {
+    /*
+      Hands containing the held cards but none of the discards: add the
+      hands containing the held cards and any subset of the discards,
+      alternating in sign with the size of the subset.
+    */
+    memset(sums, 0, sizeof(sums));
+    extra = allCards & ~held;
+    while(1)
+    {
+      sign = (__builtin_popcount(extra) & 1) ? -1 : 1;
+      for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+      {
+        sums[rankNum] += sign * tallies[held | extra].categoryCounts[rankNum];
+      }
+      sums[NUM_OF_HAND_RANKS] += sign * tallies[held | extra].rankSum;
+      if(extra == 0)
+      {
+        break;
+      }
+      extra = (extra - 1) & allCards & ~held;
+    }
+
+    option = & solution->options[held];
+    option->held = held;
+    option->numDrawn = CARDS_PER_HAND - __builtin_popcount(held);
+    option->outcomes = 0;
+    option->expectedCategory = 0.0;
+    for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+    {
+      option->categoryCounts[rankNum] = (uint64_t)sums[rankNum];
+      option->outcomes += option->categoryCounts[rankNum];
+      option->expectedCategory += (double)rankNum * sums[rankNum];
+    }
+    option->expectedCategory /= (double)option->outcomes;
+    option->expectedStrength = (double)sums[NUM_OF_HAND_RANKS] /
+      (double)option->outcomes / (double)(NUM_OF_DISTINCT_STRENGTHS - 1);
+
+    score = (objective == DrawForCategory) ?
+      option->expectedCategory : option->expectedStrength;
+    if((score > bestScore) || ((score == bestScore) &&
+      (__builtin_popcount(held) > __builtin_popcount(solution->best))))
+    {
+      bestScore = score;
+      solution->best = held;
+    }
+  }
+  return TRUE;
+}
+
+/*
+  Function run by each thread solving the hands of a table.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void solveTableWorker(void * argument, int threadNum)
+{
+  tableContext * context = argument;
+  int handNum = 0;
+  (void)threadNum;
+
+  while((handNum = atomic_fetch_add(& context->nextHand, 1)) <
+    context->numOfHands)
+  {
+    if(solveDraw(context->hands[handNum], context->objective,
+      & context->solutions[handNum]) == FALSE)
+    {
+      atomic_fetch_add(& context->failures, 1);
+    }
+  }
+}
+
+/*
+  Function to solve the hands of a table on a number of threads.
+
+  Input   = {unsigned char [][CARDS_PER_HAND]: hands, int: numOfHands,
+            drawObjective: objective, int: numOfThreads,
+            drawSolution *: solutions}
+  Output  = {bool: success}
+*/
+bool solveDrawTable(const unsigned char hands[][CARDS_PER_HAND],
+  int numOfHands, drawObjective objective, int numOfThreads,
+  drawSolution * solutions)
+{
+  tableContext context;
+
+  if(prepareDrawSolver(numOfThreads) == FALSE)
+  {
+    return FALSE;
+  }
+  context.hands = hands;
+  context.numOfHands = numOfHands;
+  context.objective = objective;
+  context.solutions = solutions;
+  atomic_init(& context.nextHand, 0);
+  atomic_init(& context.failures, 0);
+  if(numOfThreads > numOfHands)
+  {
+    numOfThreads = numOfHands;
+  }
+  runParallel(numOfThreads, solveTableWorker, & context);
+  return (atomic_load(& context.failures) == 0) ? TRUE : FALSE;
+}
@@ -0,0 +1,107 @@
+#ifndef DrawSolver_h
+#define DrawSolver_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Hand strengths */
+#include "HandEvaluator.h"
+
+/*
+  stdint.h is included for the outcome counts.
+*/
+#include <stdint.h>
+
+/* Ways to hold or discard the cards of a five card hand */
+#define NUM_OF_DRAW_OPTIONS 32
+/* Cards left to draw from once a hand has been dealt */
+#define DRAW_POOL_SIZE (STD_DECK_SIZE - CARDS_PER_HAND)
+/* Distinct strengths of a five card hand */
+#define NUM_OF_DISTINCT_STRENGTHS 7462
+
+/* What a draw option is chosen for */
+typedef enum drawObjective
+{
+  DrawForStrength, DrawForCategory
+} drawObjective;
+
+/*
+  Draw option structure
+
+  The outcomes of keeping some cards of a hand and drawing the rest from the
+  47 cards the player has not seen.
+
+    held             - bit i set when card i of the hand is kept
+    numDrawn         - cards drawn
+    outcomes         - possible draws, C(47, numDrawn)
+    categoryCounts   - draws ending in each hand rank
+    expectedCategory - mean hand rank, 0 for High Card up to 8
+    expectedStrength - mean dense strength rank scaled to [0, 1], 1 for a
+                       royal flush
+*/
+typedef struct drawOption
+{
+  unsigned char held;
+  int numDrawn;
+  uint64_t outcomes;
+  uint64_t categoryCounts[NUM_OF_HAND_RANKS];
+  double expectedCategory;
+  double expectedStrength;
+} drawOption;
+
+/*
+  Draw solution structure
+
+  Every option of one hand, indexed by its held mask, and the best of them.
+*/
+typedef struct drawSolution
+{
+  drawOption options[NUM_OF_DRAW_OPTIONS];
+  int best;
+} drawSolution;
+
+/*
+  Function to build the tables of the solver: the dense rank of every
+  strength and, for every set of one to four cards, the outcomes of all five
+  card hands containing it. They take about 12 MB, are built once on a
+  number of threads, and are shared by every later call.
+
+  Input   = {int: numOfThreads}
+  Output  = {bool: success}
+*/
+bool prepareDrawSolver(int);
+
+/*
+  Function to find the dense rank of a five card strength, 0 for the worst
+  high card up to NUM_OF_DISTINCT_STRENGTHS - 1 for a royal flush.
+
+  Input   = {handStrength: strength}
+  Output  = {int: denseRank}, INVALID_INT before the tables are built or for
+            a strength no five card hand has
+*/
+int strengthDenseRank(handStrength);
+
+/*
+  Function to solve one hand: the exact outcomes of all 32 hold options,
+  found by inclusion and exclusion over the table of hands containing each
+  set of held cards, and the best option for an objective. Ties go to the
+  option holding more cards.
+
+  Input   = {unsigned char [CARDS_PER_HAND]: hand, drawObjective: objective,
+            drawSolution *: solution}
+  Output  = {bool: success}
+*/
+bool solveDraw(const unsigned char [CARDS_PER_HAND], drawObjective,
+  drawSolution *);
+
+/*
+  Function to solve the hands of a table on a number of threads.
+
+  Input   = {unsigned char [][CARDS_PER_HAND]: hands, int: numOfHands,
+            drawObjective: objective, int: numOfThreads,
+            drawSolution *: solutions}
+  Output  = {bool: success}
+*/
+bool solveDrawTable(const unsigned char [][CARDS_PER_HAND], int,
+  drawObjective, int, drawSolution *);
+
+#endif /* DrawSolver_h */
@@ -0,0 +1,209 @@
+#include "DynamicTable.h"
+/* Five of a kind, the category only repeated cards make */
+#include "WildCards.h"
+
+/* string.h is included for memcpy and memset. */
+#include <string.h>
+
+/*
+  Function to create a table of some seats dealt from a shoe of some decks.
+  Strengths come first in the block so they are aligned; the card arrays
+  follow.
+
+  Input   = {dynamicTable *: table, int: numOfSeats, int: numOfDecks}
+  Output  = {bool: success}
+*/
+bool createDynamicTable(dynamicTable * table, int numOfSeats, int numOfDecks)
+{
+  size_t blockSize = 0;
+  unsigned char * block = NULL;
+  int cardNum = NUM_INIT;
+
+  memset(table, 0, sizeof(dynamicTable));
+  if((numOfDecks < 1) || (numOfDecks > MAX_SHOE_DECKS) ||
+    (numOfSeats < MIN_PLAYERS) || (numOfSeats > maxShoeSeats(numOfDecks)))
+  {
+    return FALSE;
+  }
+  table->numOfSeats = numOfSeats;
+  table->numOfDecks = numOfDecks;
+  table->shoeSize = numOfDecks * STD_DECK_SIZE;
+  table->standard = ((numOfDecks == 1) && (numOfSeats <= MAX_PLAYERS)) ?
+    TRUE : FALSE;
+  blockSize = sizeof(handStrength) * numOfSeats + table->shoeSize +
+    numOfSeats * CARDS_PER_HAND + numOfSeats;
+  block = malloc(blockSize);
+  if(block == NULL)
+  {
+    return FALSE;
+  }
+  table->block = block;
+  table->strengths = (handStrength *)block;
+  table->shoe = block + sizeof(handStrength) * numOfSeats;
+  table->hands = table->shoe + table->shoeSize;
+  table->winners = table->hands + numOfSeats * CARDS_PER_HAND;
+  for(cardNum = NUM_INIT; cardNum < table->shoeSize; cardNum ++)
+  {
+    table->shoe[cardNum] = cardNum % STD_DECK_SIZE;
+  }
+  return TRUE;
+}
+
+/*
+  Function to free the memory of a table.
+
+  Input   = {dynamicTable *: table}
+  Output  = {void: NULL}
+*/
+void freeDynamicTable(dynamicTable * table)
+{
+  free(table->block);
+  memset(table, 0, sizeof(dynamicTable));
+}
+
+/*
+  Function to shuffle the cards the seats need to the front of the shoe and
+  deal them. The shoe is not put back in order between deals; a partial
+  shuffle of any order deals every set of cards equally often.
+
+  Input   = {dynamicTable *: table, pokerRng *: rng}
+  Output  = {void: NULL}
+*/
+void dealDynamicTable(dynamicTable * table, pokerRng * rng)
+{
+  const int numOfDealt = table->numOfSeats * CARDS_PER_HAND;
+
+  shuffleCardIndices(rng, table->shoe, table->shoeSize, numOfDealt);
+  memcpy(table->hands, table->shoe, numOfDealt);
+}
+
+/*
+  Function to sort the cards of every seat by rank with insertion sort.
+
+  Input   = {dynamicTable *: table}
+  Output  = {void: NULL}
+*/
+void sortDynamicHands(dynamicTable * table)
+{
+  unsigned char * hand = NULL;
+  unsigned char inserted = 0;
+  int seatNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+  int slot = NUM_INIT;
+
+  for(seatNum = NUM_INIT; seatNum < table->numOfSeats; seatNum ++)
+  {
+    hand = table->hands + seatNum * CARDS_PER_HAND;
+    for(cardNum = 1; cardNum < CARDS_PER_HAND; cardNum ++)
+    {
+      inserted = hand[cardNum];
+      for(slot = cardNum; (slot > 0) && (hand[slot - 1] > inserted); slot --)
+      {
+        hand[slot] = hand[slot - 1];
+      }
+      hand[slot] = inserted;
+    }
+  }
+}
+
+/*
+  Function to determine the strength of five cards of a shoe. Cards of five
+  different values are evaluated as usual. evaluateCardIndices also counts
+  repeated values right, so only five of a kind and flushes holding a
+  repeated card, whose suit masks count a card once, are mended.
+
+  Input   = {unsigned char *: cards}
+  Output  = {handStrength: strength}
+*/
+handStrength evaluateShoeHand(const unsigned char * cards)
+{
+  unsigned char values[CARDS_PER_HAND];
+  handStrength strength = 0;
+  uint32_t seen = 0;
+  uint32_t bit = 0;
+  unsigned int suits = 0;
+  unsigned char inserted = 0;
+  bool repeated = FALSE;
+  int cardNum = NUM_INIT;
+  int slot = NUM_INIT;
+
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    bit = 1u << cardIndexValue[cards[cardNum]];
+    repeated = ((seen & bit) != 0) ? TRUE : repeated;
+    seen |= bit;
+    suits |= 1u << cardIndexSuit(cards[cardNum]);
+  }
+  if(repeated == FALSE)
+  {
+    return evaluateCardIndices(cards, CARDS_PER_HAND);
+  }
+  if(__builtin_popcount(seen) == 1)
+  {
+    return fiveOfAKindStrength(cardIndexValue[cards[0]]);
+  }
+  strength = evaluateCardIndices(cards, CARDS_PER_HAND);
+  if(((suits & (suits - 1)) != 0) || (strengthCategory(strength) >= Flush))
+  {
+    return strength;
+  }
+  /* A flush holding a pair, two pairs or three of a kind */
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    inserted = cardIndexValue[cards[cardNum]];
+    for(slot = cardNum; (slot > 0) && (values[slot - 1] < inserted); slot --)
+    {
+      values[slot] = values[slot - 1];
+    }
+    values[slot] = inserted;
+  }
+  strength = (handStrength)Flush << STRENGTH_CATEGORY_SHIFT;
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    strength |= (handStrength)values[cardNum] <<
+      ((STRENGTH_VALUES - 1 - cardNum) * STRENGTH_VALUE_BITS);
+  }
+  return strength;
+}
+
+/*
+  Function to find the strength of every seat and mark the winners.
+
+  Input   = {dynamicTable *: table}
+  Output  = {int: numOfWinners}
+*/
+int evaluateDynamicTable(dynamicTable * table)
+{
+  handStrength best = 0;
+  unsigned int winnerMask = 0;
+  int numOfWinners = NUM_INIT;
+  int seatNum = NUM_INIT;
+
+  if(table->standard == TRUE)
+  {
+    for(seatNum = NUM_INIT; seatNum < table->numOfSeats; seatNum ++)
+    {
+      table->strengths[seatNum] = evaluateCardIndices(table->hands +
+        seatNum * CARDS_PER_HAND, CARDS_PER_HAND);
+    }
+    winnerMask = findWinners(table->strengths, table->numOfSeats);
+    for(seatNum = NUM_INIT; seatNum < table->numOfSeats; seatNum ++)
+    {
+      table->winners[seatNum] = (winnerMask >> seatNum) & 1u;
+    }
+    return __builtin_popcount(winnerMask);
+  }
+  for(seatNum = NUM_INIT; seatNum < table->numOfSeats; seatNum ++)
+  {
+    table->strengths[seatNum] = evaluateShoeHand(table->hands +
+      seatNum * CARDS_PER_HAND);
+    best = (table->strengths[seatNum] > best) ? table->strengths[seatNum] :
+      best;
+  }
+  for(seatNum = NUM_INIT; seatNum < table->numOfSeats; seatNum ++)
+  {
+    table->winners[seatNum] = (table->strengths[seatNum] == best);
+    numOfWinners += table->winners[seatNum];
+  }
+  return numOfWinners;
+}
@@ -0,0 +1,105 @@
+#ifndef DynamicTable_h
+#define DynamicTable_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Hand strengths */
+#include "HandEvaluator.h"
+/* Generator streams */
+#include "PokerRandom.h"
+
+/* Most standard decks a shoe holds */
+#define MAX_SHOE_DECKS 16
+/* Most seats a shoe deals five cards to */
+#define maxShoeSeats(numOfDecks) \
+  ((numOfDecks) * STD_DECK_SIZE / CARDS_PER_HAND)
+
+/*
+  Dynamic table structure
+
+  A table whose number of seats and shoe of decks are chosen at run time.
+  The shoe, the hands, the strengths and the winners share one block of
+  memory. With several decks a hand can repeat a card, so five of a kind
+  (category FIVE_OF_A_KIND of WildCards.h) and flushes holding a pair are
+  possible. A table of one deck and at most MAX_PLAYERS seats is standard
+  and evaluated as a pokerTable is.
+
+    numOfSeats - seats dealt
+    numOfDecks - standard decks in the shoe
+    shoeSize   - cards in the shoe, numOfDecks * STD_DECK_SIZE
+    standard   - TRUE for one deck and at most MAX_PLAYERS seats
+    shoe       - card indices of the shoe, the dealt ones first
+    hands      - card indices of every seat, seat s at s * CARDS_PER_HAND
+    strengths  - strength of every seat
+    winners    - one for every seat holding the greatest strength, else zero
+    block      - memory of all the arrays
+*/
+typedef struct dynamicTable
+{
+  int numOfSeats;
+  int numOfDecks;
+  int shoeSize;
+  bool standard;
+  unsigned char * shoe;
+  unsigned char * hands;
+  handStrength * strengths;
+  unsigned char * winners;
+  void * block;
+} dynamicTable;
+
+/*
+  Function to create a table of some seats dealt from a shoe of some decks,
+  the shoe in deck order.
+
+  Input   = {dynamicTable *: table, int: numOfSeats, int: numOfDecks}
+  Output  = {bool: success}, FALSE when the shoe cannot deal the seats, for
+            more than MAX_SHOE_DECKS decks or too little memory
+*/
+bool createDynamicTable(dynamicTable *, int, int);
+
+/*
+  Function to free the memory of a table.
+
+  Input   = {dynamicTable *: table}
+  Output  = {void: NULL}
+*/
+void freeDynamicTable(dynamicTable *);
+
+/*
+  Function to shuffle the cards the seats need to the front of the shoe and
+  deal five to every seat, a seat's cards in a row.
+
+  Input   = {dynamicTable *: table, pokerRng *: rng}
+  Output  = {void: NULL}
+*/
+void dealDynamicTable(dynamicTable *, pokerRng *);
+
+/*
+  Function to sort the cards of every seat by rank, as sortHands does.
+
+  Input   = {dynamicTable *: table}
+  Output  = {void: NULL}
+*/
+void sortDynamicHands(dynamicTable *);
+
+/*
+  Function to determine the strength of five cards of a shoe, which may
+  repeat a card. Five of a kind ranks above a straight flush and five cards
+  of one suit are a flush even when they hold a pair, two pairs or three of
+  a kind; the values of such a flush are its cards' values, highest first.
+
+  Input   = {unsigned char *: cards}
+  Output  = {handStrength: strength}
+*/
+handStrength evaluateShoeHand(const unsigned char *);
+
+/*
+  Function to find the strength of every seat and mark the winners. A
+  standard table uses evaluateCardIndices and findWinners.
+
+  Input   = {dynamicTable *: table}
+  Output  = {int: numOfWinners}
+*/
+int evaluateDynamicTable(dynamicTable *);
+
+#endif /* DynamicTable_h */
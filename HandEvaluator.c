@@ -0,0 +1,450 @@
+#include "HandEvaluator.h"
+
+/* Ace high value of every card index, aces are the first four cards */
+const unsigned char cardIndexValue[STD_DECK_SIZE] =
+{
+  12, 12, 12, 12, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+  4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7, 8, 8, 8, 8,
+  9, 9, 9, 9, 10, 10, 10, 10, 11, 11, 11, 11
+};
+
+/*
+  Function to convert a card to its index in a freshly created deck.
+
+  Input   = {card *: cardPTR}
+  Output  = {unsigned char: index}
+*/
+unsigned char cardToIndex(const card * cardPTR)
+{
+  return makeCardIndex(cardPTR->cardRank, cardPTR->cardSuit);
+}
+
+/*
+  Function to convert a card index back to a card.
+
+  Input   = {unsigned char: index, card *: cardPTR}
+  Output  = {bool: success}
+*/
+bool indexToCard(unsigned char index, card * cardPTR)
+{
+  if(index >= STD_DECK_SIZE)
+  {
+    return FALSE;
+  }
+  return createCard(cardPTR, cardIndexRank(index), cardIndexSuit(index));
+}
+
+/*
+  Function to print a card given by its index.
+
+  Input   = {unsigned char: index}
+  Output  = {void: NULL}
+*/
+void printCardIndex(unsigned char index)
+{
+  card printed;
+  if(indexToCard(index, & printed) == TRUE)
+  {
+    printCard(& printed);
+  }
+}
+
+/*
+  Function to read a card written as by printCard.
+
+  Input   = {char *: text, unsigned char *: index}
+  Output  = {bool: success}
+*/
+bool parseCardIndex(const char * text, unsigned char * index)
+{
+  const char * rankNames = "A23456789TJQK";
+  const char * suitNames = "HDCS";
+  int rankNum = NUM_INIT;
+  int suitNum = NUM_INIT;
+  char rankChar = text[0];
+  char suitChar = (rankChar != '\0') ? text[1] : '\0';
+
+  /* Accept lower case as well */
+  if(rankChar >= 'a' && rankChar <= 'z')
+  {
+    rankChar = rankChar - 'a' + 'A';
+  }
+  if(suitChar >= 'a' && suitChar <= 'z')
+  {
+    suitChar = suitChar - 'a' + 'A';
+  }
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_RANKS; rankNum ++)
+  {
+    if(rankNames[rankNum] == rankChar)
+    {
+      break;
+    }
+  }
+  for(suitNum = NUM_INIT; suitNum < NUM_OF_SUITS; suitNum ++)
+  {
+    if(suitNames[suitNum] == suitChar)
+    {
+      break;
+    }
+  }
+  if((rankNum == NUM_OF_RANKS) || (suitNum == NUM_OF_SUITS))
+  {
+    return FALSE;
+  }
+  * index = makeCardIndex(rankNum, suitNum);
+  return TRUE;
+}
+
+/*
+  Function to read a list of cards separated by spaces, commas or dashes.
+
+  Input   = {char *: text, unsigned char *: indices, int: maxCards}
+  Output  = {int: numOfCards}
+*/
+int parseCardList(const char * text, unsigned char * indices, int maxCards)
+{
+  int numOfCards = NUM_INIT;
+  while(* text != '\0')
+  {
+    if((* text == ' ') || (* text == ',') || (* text == '-') ||
+      (* text == '?'))
+    {
+      text ++;
+      continue;
+    }
+    if((numOfCards == maxCards) ||
+      (parseCardIndex(text, & indices[numOfCards]) == FALSE))
+    {
+      return INVALID_INT;
+    }
+    numOfCards ++;
+    text += 2;
+  }
+  return numOfCards;
+}
+
+/* Index of the highest set bit of a non-zero rank mask */
+static inline int highestValue(uint32_t mask)
+{
+  return 31 - __builtin_clz(mask);
+}
+
+/*
+  Append the highest count values of a rank mask to a strength under
+  construction, returning the number of values appended.
+*/
+static inline int appendValues(uint32_t * packed, int used, uint32_t mask,
+  int count)
+{
+  int value = 0;
+  while((count > 0) && (mask != 0) && (used < STRENGTH_VALUES))
+  {
+    value = highestValue(mask);
+    mask &= ~(1u << value);
+    * packed |= (uint32_t)value <<
+      ((STRENGTH_VALUES - 1 - used) * STRENGTH_VALUE_BITS);
+    used ++;
+    count --;
+  }
+  return used;
+}
+
+/*
+  High card value of the best straight in a rank mask, or negative one. The
+  mask is shifted up by one so an Ace can also sit below the Two.
+*/
+static inline int straightHighValue(uint32_t mask)
+{
+  uint32_t lowAce = (mask << 1) | ((mask >> ACE_HIGH_VALUE) & 1u);
+  uint32_t runs = lowAce & (lowAce >> 1) & (lowAce >> 2) & (lowAce >> 3) &
+    (lowAce >> 4);
+  if(runs == 0)
+  {
+    return INVALID_INT;
+  }
+  /* A run starting at shifted bit b ends on the value b + 3 */
+  return highestValue(runs) + CARDS_PER_HAND - 2;
+}
+
+/*
+  Function to determine the strength of the best poker hand that can be made
+  from one to seven distinct cards. The cards are reduced to rank masks, one
+  per suit and one per number of copies, so no sorting is needed. It is
+  always inlined, so a caller passing a constant number of cards gets the
+  card loop unrolled and the tests on the number folded away.
+
+  Input   = {unsigned char *: cards, int: numOfCards}
+  Output  = {handStrength: strength}
+*/
+static inline __attribute__((always_inline)) handStrength evaluateIndices(
+  const unsigned char * cards, int numOfCards)
+{
+  uint32_t suitMasks[NUM_OF_SUITS] = {0, 0, 0, 0};
+  uint32_t seen = 0;
+  uint32_t twice = 0;
+  uint32_t thrice = 0;
+  uint32_t four = 0;
+  uint32_t flushMask = 0;
+  uint32_t bit = 0;
+  uint32_t packed = 0;
+  int cardNum = 0;
+  int suitNum = 0;
+  int value = 0;
+  int other = 0;
+  int used = 0;
+
+  for(cardNum = 0; cardNum < numOfCards; cardNum ++)
+  {
+    bit = 1u << cardIndexValue[cards[cardNum]];
+    suitMasks[cardIndexSuit(cards[cardNum])] |= bit;
+    four |= thrice & bit;
+    thrice |= twice & bit;
+    twice |= seen & bit;
+    seen |= bit;
+  }
+  if(numOfCards >= CARDS_PER_HAND)
+  {
+    for(suitNum = 0; suitNum < NUM_OF_SUITS; suitNum ++)
+    {
+      if(__builtin_popcount(suitMasks[suitNum]) >= CARDS_PER_HAND)
+      {
+        flushMask = suitMasks[suitNum];
+      }
+    }
+    if(flushMask != 0)
+    {
+      value = straightHighValue(flushMask);
+      if(value >= 0)
+      {
+        return ((uint32_t)StraightFlush << STRENGTH_CATEGORY_SHIFT) |
+          ((uint32_t)value << ((STRENGTH_VALUES - 1) * STRENGTH_VALUE_BITS));
+      }
+    }
+  }
+  if(four != 0)
+  {
+    value = highestValue(four);
+    used = appendValues(& packed, used, 1u << value, 1);
+    appendValues(& packed, used, seen & ~(1u << value), 1);
+    return ((uint32_t)FourOfAKind << STRENGTH_CATEGORY_SHIFT) | packed;
+  }
+  if(thrice != 0)
+  {
+    value = highestValue(thrice);
+    if((twice & ~(1u << value)) != 0)
+    {
+      other = highestValue(twice & ~(1u << value));
+      used = appendValues(& packed, used, 1u << value, 1);
+      appendValues(& packed, used, 1u << other, 1);
+      return ((uint32_t)FullHouse << STRENGTH_CATEGORY_SHIFT) | packed;
+    }
+  }
+  if(flushMask != 0)
+  {
+    appendValues(& packed, used, flushMask, CARDS_PER_HAND);
+    return ((uint32_t)Flush << STRENGTH_CATEGORY_SHIFT) | packed;
+  }
+  if(numOfCards >= CARDS_PER_HAND)
+  {
+    value = straightHighValue(seen);
+    if(value >= 0)
+    {
+      return ((uint32_t)Straight << STRENGTH_CATEGORY_SHIFT) |
+        ((uint32_t)value << ((STRENGTH_VALUES - 1) * STRENGTH_VALUE_BITS));
+    }
+  }
+  if(thrice != 0)
+  {
+    value = highestValue(thrice);
+    used = appendValues(& packed, used, 1u << value, 1);
+    appendValues(& packed, used, seen & ~(1u << value), 2);
+    return ((uint32_t)ThreeOfAKind << STRENGTH_CATEGORY_SHIFT) | packed;
+  }
+  if(twice != 0)
+  {
+    value = highestValue(twice);
+    if((twice & ~(1u << value)) != 0)
+    {
+      other = highestValue(twice & ~(1u << value));
+      used = appendValues(& packed, used, 1u << value, 1);
+      used = appendValues(& packed, used, 1u << other, 1);
+      appendValues(& packed, used, seen & ~((1u << value) | (1u << other)), 1);
+      return ((uint32_t)TwoPair << STRENGTH_CATEGORY_SHIFT) | packed;
+    }
+    used = appendValues(& packed, used, 1u << value, 1);
+    appendValues(& packed, used, seen & ~(1u << value), 3);
+    return ((uint32_t)Pair << STRENGTH_CATEGORY_SHIFT) | packed;
+  }
+  appendValues(& packed, used, seen, CARDS_PER_HAND);
+  return ((uint32_t)HighCard << STRENGTH_CATEGORY_SHIFT) | packed;
+}
+
+/*
+  Function to determine the strength of the best poker hand that can be made
+  from one to seven distinct cards.
+
+  Input   = {unsigned char *: cards, int: numOfCards}
+  Output  = {handStrength: strength}
+*/
+handStrength evaluateCardIndices(const unsigned char * cards, int numOfCards)
+{
+  return evaluateIndices(cards, numOfCards);
+}
+
+/*
+  Function to determine the strength of a hand of the poker table.
+
+  Input   = {card [CARDS_PER_HAND][MAX_PLAYERS]: hands, int: hand}
+  Output  = {handStrength: strength}
+*/
+handStrength evaluateHand(card hands[CARDS_PER_HAND][MAX_PLAYERS], int hand)
+{
+  unsigned char cards[CARDS_PER_HAND];
+  int cardNum = NUM_INIT;
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    cards[cardNum] = cardToIndex(& hands[cardNum][hand]);
+  }
+  return evaluateCardIndices(cards, CARDS_PER_HAND);
+}
+
+/*
+  Function to determine the rank of a hand with the fast evaluator.
+
+  Input   = {card [CARDS_PER_HAND][MAX_PLAYERS]: hands, int: hand}
+  Output  = {pokerRank: handRank}
+*/
+pokerRank fastAssignRank(card hands[CARDS_PER_HAND][MAX_PLAYERS], int hand)
+{
+  return strengthCategory(evaluateHand(hands, hand));
+}
+
+/*
+  Function to find the seats holding the greatest strength.
+
+  Input   = {handStrength *: strengths, int: numOfHands}
+  Output  = {unsigned int: winnerMask}
+*/
+unsigned int findWinners(const handStrength * strengths, int numOfHands)
+{
+  handStrength best = 0;
+  unsigned int winners = 0;
+  int playrNum = NUM_INIT;
+  for(playrNum = NUM_INIT; playrNum < numOfHands; playrNum ++)
+  {
+    if(strengths[playrNum] > best)
+    {
+      best = strengths[playrNum];
+      winners = 1u << playrNum;
+    }
+    else if(strengths[playrNum] == best)
+    {
+      winners |= 1u << playrNum;
+    }
+  }
+  return winners;
+}
+
+/*
+  Function to determine a winner or winners using full hand strengths.
+
+  Input   = {int [numOfHands]: winners,
+            card [CARDS_PER_HAND][MAX_PLAYERS]: hands, int: numOfhands}
+  Output  = {int *: winners}
+*/
+int * determineWinnerByStrength(int winners[],
+  card hands[CARDS_PER_HAND][MAX_PLAYERS], int numOfHands)
+{
+  handStrength strengths[MAX_PLAYERS];
+  unsigned int winnerMask = 0;
+  int playrNum = NUM_INIT;
+  for(playrNum = NUM_INIT; playrNum < numOfHands; playrNum ++)
+  {
+    strengths[playrNum] = evaluateHand(hands, playrNum);
+  }
+  winnerMask = findWinners(strengths, numOfHands);
+  for(playrNum = NUM_INIT; playrNum < numOfHands; playrNum ++)
+  {
+    /* Winners are marked by the number one, all other are negative one */
+    winners[playrNum] = ((winnerMask >> playrNum) & 1u) ? 1 : -1;
+  }
+  return winners;
+}
+
+/*
+  Function to hold a showdown of five card hands dealt back to back. It is
+  always inlined into the kernels below, where the number of players is a
+  constant. The loop over the hands keeps that fixed trip count but is not
+  unrolled, since ten inlined evaluations made larger and slower kernels;
+  only the winner loop is unrolled, gathering the winners without branches.
+
+  Input   = {unsigned char *: cards, handStrength *: strengths,
+            int: numOfPlayers}
+  Output  = {unsigned int: winners}, bit p set when hand p wins
+*/
+static inline __attribute__((always_inline)) unsigned int showdownHands(
+  const unsigned char * cards, handStrength strengths[MAX_PLAYERS],
+  int numOfPlayers)
+{
+  handStrength best = 0;
+  unsigned int winners = 0;
+  int playrNum = 0;
+
+  for(playrNum = 0; playrNum < numOfPlayers; playrNum ++)
+  {
+    strengths[playrNum] = evaluateIndices(cards + playrNum * CARDS_PER_HAND,
+      CARDS_PER_HAND);
+    best = (strengths[playrNum] > best) ? strengths[playrNum] : best;
+  }
+#pragma GCC unroll 16
+  for(playrNum = 0; playrNum < numOfPlayers; playrNum ++)
+  {
+    winners |= (unsigned int)(strengths[playrNum] == best) << playrNum;
+  }
+  return winners;
+}
+
+/* Defines the showdown kernel of a fixed number of players */
+#define DEFINE_SHOWDOWN_KERNEL(players) \
+  static unsigned int showdown##players(const unsigned char * cards, \
+    handStrength strengths[MAX_PLAYERS]) \
+  { \
+    return showdownHands(cards, strengths, players); \
+  }
+
+DEFINE_SHOWDOWN_KERNEL(1)
+DEFINE_SHOWDOWN_KERNEL(2)
+DEFINE_SHOWDOWN_KERNEL(3)
+DEFINE_SHOWDOWN_KERNEL(4)
+DEFINE_SHOWDOWN_KERNEL(5)
+DEFINE_SHOWDOWN_KERNEL(6)
+DEFINE_SHOWDOWN_KERNEL(7)
+DEFINE_SHOWDOWN_KERNEL(8)
+DEFINE_SHOWDOWN_KERNEL(9)
+DEFINE_SHOWDOWN_KERNEL(10)
+
+#if MAX_PLAYERS != 10
+#error "Define a showdown kernel for every number of players"
+#endif
+
+/* Kernel of every number of players, by number of players */
+static const showdownKernel showdownKernels[MAX_PLAYERS + 1] =
+{
+  NULL, showdown1, showdown2, showdown3, showdown4, showdown5, showdown6,
+  showdown7, showdown8, showdown9, showdown10
+};
+
+/*
+  Function to select the showdown kernel of a number of players.
+
+  Input   = {int: numOfPlayers}
+  Output  = {showdownKernel: kernel}
+*/
+showdownKernel selectShowdownKernel(int numOfPlayers)
+{
+  if((numOfPlayers < MIN_PLAYERS) || (numOfPlayers > MAX_PLAYERS))
+  {
+    return NULL;
+  }
+  return showdownKernels[numOfPlayers];
+}
@@ -0,0 +1,149 @@
+#ifndef HandEvaluator_h
+#define HandEvaluator_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+
+/*
+  stdint.h is included for the fixed width hand strength type.
+*/
+#include <stdint.h>
+
+/*
+  A hand strength packs the pokerRank of a hand above five 4 bit tie-break
+  values, so two hands are compared with a single integer comparison. Rank
+  values inside a strength run from 0 for a Two up to 12 for an Ace.
+*/
+#define STRENGTH_CATEGORY_SHIFT 20
+#define STRENGTH_VALUE_BITS 4
+#define STRENGTH_VALUES 5
+#define ACE_HIGH_VALUE 12
+#define WHEEL_HIGH_VALUE 3
+#define MAX_EVALUATED_CARDS 7
+
+/* Card indices follow the order of createDeck, index = rank * 4 + suit. */
+#define cardIndexRank(index) ((rank)((index) >> 2))
+#define cardIndexSuit(index) ((suit)((index) & 3))
+#define makeCardIndex(cardRank, cardSuit) \
+  ((unsigned char)((cardRank) * NUM_OF_SUITS + (cardSuit)))
+#define strengthCategory(strength) \
+  ((pokerRank)((strength) >> STRENGTH_CATEGORY_SHIFT))
+
+/* Hand strength type, greater strengths win */
+typedef uint32_t handStrength;
+
+/* Ace high value (0 for a Two, 12 for an Ace) of every card index */
+extern const unsigned char cardIndexValue[STD_DECK_SIZE];
+
+/*
+  Function to convert a card to its index in a freshly created deck.
+
+  Input   = {card *: cardPTR}
+  Output  = {unsigned char: index}
+*/
+unsigned char cardToIndex(const card *);
+
+/*
+  Function to convert a card index back to a card.
+
+  Input   = {unsigned char: index, card *: cardPTR}
+  Output  = {bool: success}
+*/
+bool indexToCard(unsigned char, card *);
+
+/*
+  Function to print a card given by its index, in the format of printCard.
+
+  Input   = {unsigned char: index}
+  Output  = {void: NULL}
+*/
+void printCardIndex(unsigned char);
+
+/*
+  Function to read a card written as by printCard, a rank character from
+  A23456789TJQK followed by a suit character from HDCS, in either case.
+
+  Input   = {char *: text, unsigned char *: index}
+  Output  = {bool: success}
+*/
+bool parseCardIndex(const char *, unsigned char *);
+
+/*
+  Function to read a list of cards separated by spaces, commas or dashes.
+  Question marks stand for unknown cards and are skipped.
+
+  Input   = {char *: text, unsigned char *: indices, int: maxCards}
+  Output  = {int: numOfCards}, INVALID_INT when the list cannot be read
+*/
+int parseCardList(const char *, unsigned char *, int);
+
+/*
+  Function to determine the strength of the best poker hand that can be made
+  from one to seven distinct cards. With fewer than five cards only pairs,
+  triples, quads and high cards are possible.
+
+  Input   = {unsigned char *: cards, int: numOfCards}
+  Output  = {handStrength: strength}
+*/
+handStrength evaluateCardIndices(const unsigned char *, int);
+
+/*
+  Function to determine the strength of a hand of the poker table. Unlike
+  assignRank the hands are neither sorted nor otherwise modified.
+
+  Input   = {card [CARDS_PER_HAND][MAX_PLAYERS]: hands, int: hand}
+  Output  = {handStrength: strength}
+*/
+handStrength evaluateHand(card [CARDS_PER_HAND][MAX_PLAYERS], int);
+
+/*
+  Function to determine the rank of a hand with the fast evaluator, a drop in
+  replacement for assignRank.
+
+  Input   = {card [CARDS_PER_HAND][MAX_PLAYERS]: hands, int: hand}
+  Output  = {pokerRank: handRank}
+*/
+pokerRank fastAssignRank(card [CARDS_PER_HAND][MAX_PLAYERS], int);
+
+/*
+  Function to find the seats holding the greatest strength.
+
+  Input   = {handStrength *: strengths, int: numOfHands}
+  Output  = {unsigned int: winnerMask}
+*/
+unsigned int findWinners(const handStrength *, int);
+
+/*
+  Function to determine a winner or winners using full hand strengths, so
+  equal ranks are split by their kickers. Winners are marked as by
+  determineWinner, one for a winner and negative one for everybody else.
+
+  Input   = {int [numOfHands]: winners,
+            card [CARDS_PER_HAND][MAX_PLAYERS]: hands, int: numOfhands}
+  Output  = {int *: winners}
+*/
+int * determineWinnerByStrength(int *,
+  card [CARDS_PER_HAND][MAX_PLAYERS], int);
+
+/*
+  Showdown kernel type
+
+  A kernel evaluates the five card hands of a fixed number of players, dealt
+  back to back from the cards, writes their strengths and returns the
+  winner mask, exactly as evaluateCardIndices and findWinners would. Every
+  number of players has its own kernel with its loops unrolled, so a run
+  selects one once and calls it for every table.
+*/
+typedef unsigned int (* showdownKernel)(const unsigned char *,
+  handStrength [MAX_PLAYERS]);
+
+/*
+  Function to select the showdown kernel of a number of players.
+
+  Input   = {int: numOfPlayers}
+  Output  = {showdownKernel: kernel}, NULL outside MIN_PLAYERS to
+            MAX_PLAYERS
+*/
+showdownKernel selectShowdownKernel(int);
+
+#endif /* HandEvaluator_h */
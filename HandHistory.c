@@ -0,0 +1,725 @@
+#include "HandHistory.h"
+/* Hand strengths and showdowns */
+#include "HandEvaluator.h"
+/* Binary deal files */
+#include "PokerPipeline.h"
+/* Hand rank names */
+#include "RareHands.h"
+
+/* string.h is included for memcmp, memset and strncmp. */
+#include <string.h>
+/* ctype.h is included for isspace, isdigit and isalnum. */
+#include <ctype.h>
+/*
+  fcntl.h, sys/mman.h, sys/stat.h and unistd.h are included to map an index
+  file.
+*/
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Bitmaps of each seat, one per hand rank and outcome */
+#define SEAT_BITMAPS (NUM_OF_HAND_RANKS * NUM_OF_OUTCOMES)
+/* Container data starts on multiples of this */
+#define INDEX_ALIGNMENT 8
+/* Longest word of a query term */
+#define QUERY_WORD_SIZE 32
+/* Deepest nesting of parentheses a query may have */
+#define QUERY_MAX_DEPTH 256
+
+/*
+  Index builder structure, the state of buildHistoryIndex
+
+    deals       - deal file being indexed
+    output      - index file being written
+    dealHeader  - header of the deal file
+    header      - header of the index, written last
+    codes       - bitmap of each seat of each deal of the current block
+    sorted      - deal ids of one seat of the block, grouped by bitmap
+    entries     - container entries of every bitmap, numOfBlocks each
+    numEntries  - entries of every bitmap so far
+    numOfBlocks - blocks of CONTAINER_IDS deals in the file
+    position    - bytes written to the index
+*/
+typedef struct indexBuilder
+{
+  FILE * deals;
+  FILE * output;
+  dealFileHeader dealHeader;
+  historyIndexHeader * header;
+  unsigned char * codes;
+  uint16_t * sorted;
+  indexEntry * entries;
+  uint64_t * numEntries;
+  uint64_t numOfBlocks;
+  uint64_t position;
+} indexBuilder;
+
+/*
+  Query parser structure
+
+    index    - index the terms are loaded from
+    query    - text of the query
+    position - next character to read
+    depth    - parentheses open at the position
+*/
+typedef struct queryParser
+{
+  const historyIndex * index;
+  const char * query;
+  int position;
+  int depth;
+} queryParser;
+
+/*
+  Function to write one container of deal ids to an index file, as an array
+  or as a bitmap, and note where it went.
+
+  Input   = {FILE *: output, uint64_t *: position, uint32_t: key,
+            uint16_t *: values, uint32_t: count, indexEntry *: entry}
+  Output  = {bool: success}
+*/
+static bool writeIndexContainer(FILE * output, uint64_t * position,
+  uint32_t key, const uint16_t * values, uint32_t count, indexEntry * entry)
+{
+  static const unsigned char padding[INDEX_ALIGNMENT] = {0};
+  uint64_t words[CONTAINER_WORDS];
+  size_t size = 0;
+  uint32_t valueNum = 0;
+
+  entry->key = key;
+  entry->cardinality = count;
+  entry->offset = * position;
+  if(count <= ARRAY_CONTAINER_LIMIT)
+  {
+    size = sizeof(uint16_t) * count;
+    if(fwrite(values, sizeof(uint16_t), count, output) != count)
+    {
+      return FALSE;
+    }
+    if(size % INDEX_ALIGNMENT != 0)
+    {
+      if(fwrite(padding, 1, INDEX_ALIGNMENT - size % INDEX_ALIGNMENT,
+        output) != INDEX_ALIGNMENT - size % INDEX_ALIGNMENT)
+      {
+        return FALSE;
+      }
+      size += INDEX_ALIGNMENT - size % INDEX_ALIGNMENT;
+    }
+  }
+  else
+  {
+    memset(words, 0, sizeof(words));
+    for(valueNum = 0; valueNum < count; valueNum ++)
+    {
+      words[values[valueNum] >> 6] |= 1ULL << (values[valueNum] & 63);
+    }
+    size = sizeof(words);
+    if(fwrite(words, sizeof(words), 1, output) != 1)
+    {
+      return FALSE;
+    }
+  }
+  * position += size;
+  return TRUE;
+}
+
+/*
+  Function to rank every seat of one block of deals and write the block's
+  container of each bitmap.
+
+  Input   = {indexBuilder *: builder, uint64_t: blockNum}
+  Output  = {bool: success}
+*/
+static bool indexBlock(indexBuilder * builder, uint64_t blockNum)
+{
+  const int numOfPlayers = (int)builder->dealHeader.numOfPlayers;
+  unsigned char cards[MAX_PLAYERS * CARDS_PER_HAND];
+  uint32_t starts[SEAT_BITMAPS + 1];
+  uint64_t bitmapNum = 0;
+  unsigned int winners = 0;
+  uint32_t numInBlock = CONTAINER_IDS;
+  uint32_t dealNum = 0;
+  int playrNum = NUM_INIT;
+  int code = 0;
+
+  if(blockNum == builder->numOfBlocks - 1)
+  {
+    numInBlock = (uint32_t)(builder->dealHeader.numOfTables -
+      blockNum * CONTAINER_IDS);
+  }
+  for(dealNum = 0; dealNum < numInBlock; dealNum ++)
+  {
+    if(readDealRecord(builder->deals, & builder->dealHeader, cards,
+      & winners) == FALSE)
+    {
+      return FALSE;
+    }
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      code = strengthCategory(evaluateCardIndices(cards +
+        playrNum * CARDS_PER_HAND, CARDS_PER_HAND)) * NUM_OF_OUTCOMES;
+      if(((winners >> playrNum) & 1u) == 0)
+      {
+        code += OutcomeLost;
+      }
+      else if(__builtin_popcount(winners) > 1)
+      {
+        code += OutcomeSplit;
+      }
+      builder->codes[playrNum * CONTAINER_IDS + dealNum] =
+        (unsigned char)code;
+    }
+  }
+
+  /* A counting sort groups each seat's deal ids by bitmap, in order */
+  for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+  {
+    memset(starts, 0, sizeof(starts));
+    for(dealNum = 0; dealNum < numInBlock; dealNum ++)
+    {
+      starts[builder->codes[playrNum * CONTAINER_IDS + dealNum] + 1] ++;
+    }
+    for(code = 0; code < SEAT_BITMAPS; code ++)
+    {
+      starts[code + 1] += starts[code];
+    }
+    for(dealNum = 0; dealNum < numInBlock; dealNum ++)
+    {
+      builder->sorted[starts[builder->codes[playrNum * CONTAINER_IDS +
+        dealNum]] ++] = (uint16_t)dealNum;
+    }
+    /* Each start has moved on to the next bitmap's */
+    for(code = SEAT_BITMAPS; code > 0; code --)
+    {
+      starts[code] = starts[code - 1];
+    }
+    starts[0] = 0;
+    for(code = 0; code < SEAT_BITMAPS; code ++)
+    {
+      if(starts[code + 1] == starts[code])
+      {
+        continue;
+      }
+      bitmapNum = playrNum * SEAT_BITMAPS + code;
+      if(writeIndexContainer(builder->output, & builder->position,
+        (uint32_t)blockNum, builder->sorted + starts[code],
+        starts[code + 1] - starts[code], & builder->entries[bitmapNum *
+        builder->numOfBlocks + builder->numEntries[bitmapNum]]) == FALSE)
+      {
+        return FALSE;
+      }
+      builder->numEntries[bitmapNum] ++;
+    }
+  }
+  return TRUE;
+}
+
+/*
+  Function to write the directories after the containers and the header,
+  pointing to them, over the placeholder at the start of the file.
+
+  Input   = {indexBuilder *: builder}
+  Output  = {bool: success}
+*/
+static bool writeIndexDirectories(indexBuilder * builder)
+{
+  historyIndexHeader * header = builder->header;
+  indexDirectory * directory = NULL;
+  uint64_t bitmapNum = 0;
+  int playrNum = NUM_INIT;
+  int code = 0;
+
+  memcpy(header->magic, HISTORY_INDEX_MAGIC, HISTORY_MAGIC_SIZE);
+  header->numOfPlayers = builder->dealHeader.numOfPlayers;
+  header->numOfTables = builder->dealHeader.numOfTables;
+  for(playrNum = NUM_INIT; playrNum < (int)header->numOfPlayers; playrNum ++)
+  {
+    for(code = 0; code < SEAT_BITMAPS; code ++)
+    {
+      bitmapNum = playrNum * SEAT_BITMAPS + code;
+      directory = & header->directories[playrNum][code / NUM_OF_OUTCOMES]
+        [code % NUM_OF_OUTCOMES];
+      directory->offset = builder->position;
+      directory->numOfContainers = builder->numEntries[bitmapNum];
+      if(fwrite(& builder->entries[bitmapNum * builder->numOfBlocks],
+        sizeof(indexEntry), directory->numOfContainers, builder->output) !=
+        directory->numOfContainers)
+      {
+        return FALSE;
+      }
+      builder->position += sizeof(indexEntry) * directory->numOfContainers;
+    }
+  }
+  return ((fseek(builder->output, 0, SEEK_SET) == 0) &&
+    (fwrite(header, sizeof(historyIndexHeader), 1, builder->output) == 1)) ?
+    TRUE : FALSE;
+}
+
+/*
+  Function to index a binary deal file.
+
+  Input   = {char *: dealPath, char *: indexPath, uint64_t *: numIndexed}
+  Output  = {bool: success}
+*/
+bool buildHistoryIndex(const char * dealPath, const char * indexPath,
+  uint64_t * numIndexed)
+{
+  indexBuilder builder;
+  uint64_t blockNum = 0;
+  bool success = FALSE;
+
+  * numIndexed = 0;
+  memset(& builder, 0, sizeof(builder));
+  builder.deals = fopen(dealPath, "rb");
+  builder.header = calloc(1, sizeof(historyIndexHeader));
+  builder.position = sizeof(historyIndexHeader);
+  if((builder.deals != NULL) && (builder.header != NULL) &&
+    (readDealHeader(builder.deals, & builder.dealHeader) == TRUE) &&
+    (builder.dealHeader.numOfTables <= MAX_INDEXED_DEALS))
+  {
+    builder.numOfBlocks = (builder.dealHeader.numOfTables +
+      CONTAINER_IDS - 1) / CONTAINER_IDS;
+    builder.codes = malloc((size_t)MAX_PLAYERS * CONTAINER_IDS);
+    builder.sorted = malloc(sizeof(uint16_t) * CONTAINER_IDS);
+    builder.entries = malloc(sizeof(indexEntry) *
+      builder.dealHeader.numOfPlayers * SEAT_BITMAPS *
+      (builder.numOfBlocks + 1));
+    builder.numEntries = calloc(builder.dealHeader.numOfPlayers *
+      SEAT_BITMAPS, sizeof(uint64_t));
+    builder.output = fopen(indexPath, "wb");
+    success = ((builder.codes != NULL) && (builder.sorted != NULL) &&
+      (builder.entries != NULL) && (builder.numEntries != NULL) &&
+      (builder.output != NULL) && (fwrite(builder.header,
+      sizeof(historyIndexHeader), 1, builder.output) == 1)) ? TRUE : FALSE;
+  }
+  for(blockNum = 0; (success == TRUE) && (blockNum < builder.numOfBlocks);
+    blockNum ++)
+  {
+    success = indexBlock(& builder, blockNum);
+  }
+  if(success == TRUE)
+  {
+    * numIndexed = builder.dealHeader.numOfTables;
+    success = writeIndexDirectories(& builder);
+  }
+
+  if((builder.output != NULL) && (fclose(builder.output) != 0))
+  {
+    success = FALSE;
+  }
+  if(builder.deals != NULL)
+  {
+    fclose(builder.deals);
+  }
+  free(builder.header);
+  free(builder.codes);
+  free(builder.sorted);
+  free(builder.entries);
+  free(builder.numEntries);
+  return success;
+}
+
+/*
+  Function to map an index file and check its header.
+
+  Input   = {historyIndex *: index, char *: path}
+  Output  = {bool: success}
+*/
+bool openHistoryIndex(historyIndex * index, const char * path)
+{
+  struct stat status;
+  void * mapped = MAP_FAILED;
+  int descriptor = open(path, O_RDONLY);
+
+  memset(index, 0, sizeof(* index));
+  if(descriptor < 0)
+  {
+    return FALSE;
+  }
+  if((fstat(descriptor, & status) == 0) &&
+    ((size_t)status.st_size >= sizeof(historyIndexHeader)))
+  {
+    mapped = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor,
+      0);
+  }
+  close(descriptor);
+  if(mapped == MAP_FAILED)
+  {
+    return FALSE;
+  }
+  index->mapped = mapped;
+  index->mappedSize = status.st_size;
+  index->header = mapped;
+  if((memcmp(index->header->magic, HISTORY_INDEX_MAGIC,
+    HISTORY_MAGIC_SIZE) != 0) || (index->header->numOfPlayers < MIN_PLAYERS) ||
+    (index->header->numOfPlayers > MAX_PLAYERS) ||
+    (index->header->numOfTables > MAX_INDEXED_DEALS))
+  {
+    closeHistoryIndex(index);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*
+  Function to unmap an index file.
+
+  Input   = {historyIndex *: index}
+  Output  = {void: NULL}
+*/
+void closeHistoryIndex(historyIndex * index)
+{
+  if(index->mapped != NULL)
+  {
+    munmap((void *)index->mapped, index->mappedSize);
+  }
+  memset(index, 0, sizeof(* index));
+}
+
+/*
+  Function to load a bitmap of the index, borrowing the mapped containers.
+
+  Input   = {historyIndex *: index, int: seat, pokerRank: category,
+            dealOutcome: outcome, roaringBitmap *: bitmap}
+  Output  = {bool: success}
+*/
+bool loadIndexBitmap(const historyIndex * index, int seat,
+  pokerRank category, dealOutcome outcome, roaringBitmap * bitmap)
+{
+  const indexDirectory * directory = NULL;
+  const indexEntry * entries = NULL;
+  bitmapContainer container;
+  uint64_t entryNum = 0;
+  size_t size = 0;
+
+  initBitmap(bitmap);
+  bitmap->borrowed = TRUE;
+  if((seat < 0) || (seat >= (int)index->header->numOfPlayers))
+  {
+    return FALSE;
+  }
+  directory = & index->header->directories[seat][category][outcome];
+  if((directory->offset > index->mappedSize) ||
+    (directory->numOfContainers > (index->mappedSize - directory->offset) /
+    sizeof(indexEntry)))
+  {
+    return FALSE;
+  }
+  entries = (const indexEntry *)(index->mapped + directory->offset);
+  for(entryNum = 0; entryNum < directory->numOfContainers; entryNum ++)
+  {
+    memset(& container, 0, sizeof(container));
+    container.key = entries[entryNum].key;
+    container.cardinality = entries[entryNum].cardinality;
+    size = (container.cardinality <= ARRAY_CONTAINER_LIMIT) ?
+      sizeof(uint16_t) * container.cardinality :
+      sizeof(uint64_t) * CONTAINER_WORDS;
+    if((container.cardinality == 0) ||
+      (container.cardinality > CONTAINER_IDS) ||
+      (entries[entryNum].offset > index->mappedSize) ||
+      (size > index->mappedSize - entries[entryNum].offset) ||
+      ((entryNum > 0) && (container.key <= entries[entryNum - 1].key)))
+    {
+      freeBitmap(bitmap);
+      return FALSE;
+    }
+    if(container.cardinality <= ARRAY_CONTAINER_LIMIT)
+    {
+      container.values = (uint16_t *)(index->mapped +
+        entries[entryNum].offset);
+    }
+    else
+    {
+      container.words = (uint64_t *)(index->mapped +
+        entries[entryNum].offset);
+    }
+    if(appendContainer(bitmap, & container) == FALSE)
+    {
+      freeBitmap(bitmap);
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/* Skip the spaces before the next character of a query */
+static char peekQuery(queryParser * parser)
+{
+  while(isspace((unsigned char)parser->query[parser->position]))
+  {
+    parser->position ++;
+  }
+  return parser->query[parser->position];
+}
+
+/* Replace a bitmap with the result of an operation, freeing both operands */
+static bool combineInto(roaringBitmap * target, roaringBitmap * operand,
+  bool (* operation)(roaringBitmap *, const roaringBitmap *,
+  const roaringBitmap *))
+{
+  roaringBitmap result;
+  bool success = FALSE;
+
+  initBitmap(& result);
+  success = operation(& result, target, operand);
+  freeBitmap(target);
+  freeBitmap(operand);
+  * target = result;
+  if(success == FALSE)
+  {
+    freeBitmap(target);
+  }
+  return success;
+}
+
+/*
+  Function to read a term: all, or a seat with an optional rank and
+  outcome, giving the union of the bitmaps it covers.
+
+  Input   = {queryParser *: parser, roaringBitmap *: result}
+  Output  = {bool: success}
+*/
+static bool parseQueryTerm(queryParser * parser, roaringBitmap * result)
+{
+  char word[QUERY_WORD_SIZE];
+  roaringBitmap loaded;
+  int start = 0;
+  int seat = 0;
+  int category = INVALID_INT;
+  int outcome = INVALID_INT;
+  int length = 0;
+  int rankNum = 0;
+  int outcomeNum = 0;
+
+  initBitmap(result);
+  peekQuery(parser);
+  if((strncmp(parser->query + parser->position, "all", 3) == 0) &&
+    (isalnum((unsigned char)parser->query[parser->position + 3]) == 0))
+  {
+    parser->position += 3;
+    return bitmapRange(result, parser->index->header->numOfTables);
+  }
+  if((parser->query[parser->position] != 's') ||
+    (isdigit((unsigned char)parser->query[parser->position + 1]) == 0))
+  {
+    return FALSE;
+  }
+  start = parser->position ++;
+  while(isdigit((unsigned char)parser->query[parser->position]))
+  {
+    seat = seat * 10 + parser->query[parser->position ++] - '0';
+    seat = (seat > MAX_PLAYERS) ? MAX_PLAYERS + 1 : seat;
+  }
+  if((seat < 1) || (seat > (int)parser->index->header->numOfPlayers))
+  {
+    parser->position = start;
+    return FALSE;
+  }
+  while(parser->query[parser->position] == '.')
+  {
+    parser->position ++;
+    length = 0;
+    while((isalnum((unsigned char)parser->query[parser->position])) &&
+      (length < QUERY_WORD_SIZE - 1))
+    {
+      word[length ++] = parser->query[parser->position ++];
+    }
+    word[length] = '\0';
+    if((outcome == INVALID_INT) && (strcmp(word, "won") == 0))
+    {
+      outcome = OutcomeWon;
+    }
+    else if((outcome == INVALID_INT) && (strcmp(word, "split") == 0))
+    {
+      outcome = OutcomeSplit;
+    }
+    else if((outcome == INVALID_INT) && (strcmp(word, "lost") == 0))
+    {
+      outcome = OutcomeLost;
+    }
+    else if((category == INVALID_INT) && (length > 0) &&
+      (parseHandRank(word) != INVALID_INT))
+    {
+      category = parseHandRank(word);
+    }
+    else
+    {
+      parser->position -= length;
+      return FALSE;
+    }
+  }
+  for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+  {
+    for(outcomeNum = 0; outcomeNum < NUM_OF_OUTCOMES; outcomeNum ++)
+    {
+      if(((category != INVALID_INT) && (category != rankNum)) ||
+        ((outcome != INVALID_INT) && (outcome != outcomeNum)))
+      {
+        continue;
+      }
+      if((loadIndexBitmap(parser->index, seat - 1, rankNum, outcomeNum,
+        & loaded) == FALSE) || (combineInto(result, & loaded, bitmapOr) ==
+        FALSE))
+      {
+        freeBitmap(result);
+        return FALSE;
+      }
+    }
+  }
+  return TRUE;
+}
+
+/* Forward declaration, a parenthesis holds a whole query */
+static bool parseQueryOr(queryParser *, roaringBitmap *);
+
+/*
+  Function to read any number of negations, then a parenthesis or a term.
+  The negations are counted rather than read one call each, so only
+  parentheses nest, and no deeper than QUERY_MAX_DEPTH.
+
+  Input   = {queryParser *: parser, roaringBitmap *: result}
+  Output  = {bool: success}
+*/
+static bool parseQueryFactor(queryParser * parser, roaringBitmap * result)
+{
+  roaringBitmap operand;
+  bool negated = FALSE;
+
+  initBitmap(result);
+  while(peekQuery(parser) == '!')
+  {
+    parser->position ++;
+    negated = (negated == FALSE) ? TRUE : FALSE;
+  }
+  if(peekQuery(parser) == '(')
+  {
+    if(parser->depth >= QUERY_MAX_DEPTH)
+    {
+      return FALSE;
+    }
+    parser->position ++;
+    parser->depth ++;
+    if(parseQueryOr(parser, & operand) == FALSE)
+    {
+      return FALSE;
+    }
+    if(peekQuery(parser) != ')')
+    {
+      freeBitmap(& operand);
+      return FALSE;
+    }
+    parser->position ++;
+    parser->depth --;
+  }
+  else if(parseQueryTerm(parser, & operand) == FALSE)
+  {
+    return FALSE;
+  }
+  if(negated == FALSE)
+  {
+    * result = operand;
+    return TRUE;
+  }
+  if(bitmapRange(result, parser->index->header->numOfTables) == FALSE)
+  {
+    freeBitmap(& operand);
+    freeBitmap(result);
+    return FALSE;
+  }
+  return combineInto(result, & operand, bitmapAndNot);
+}
+
+/*
+  Function to read factors joined by & and -.
+
+  Input   = {queryParser *: parser, roaringBitmap *: result}
+  Output  = {bool: success}
+*/
+static bool parseQueryAnd(queryParser * parser, roaringBitmap * result)
+{
+  roaringBitmap operand;
+  char next = '\0';
+
+  if(parseQueryFactor(parser, result) == FALSE)
+  {
+    return FALSE;
+  }
+  while(((next = peekQuery(parser)) == '&') || (next == '-'))
+  {
+    parser->position ++;
+    if(parseQueryFactor(parser, & operand) == FALSE)
+    {
+      freeBitmap(result);
+      return FALSE;
+    }
+    if(combineInto(result, & operand, (next == '&') ? bitmapAnd :
+      bitmapAndNot) == FALSE)
+    {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/*
+  Function to read terms joined by |.
+
+  Input   = {queryParser *: parser, roaringBitmap *: result}
+  Output  = {bool: success}
+*/
+static bool parseQueryOr(queryParser * parser, roaringBitmap * result)
+{
+  roaringBitmap operand;
+
+  if(parseQueryAnd(parser, result) == FALSE)
+  {
+    return FALSE;
+  }
+  while(peekQuery(parser) == '|')
+  {
+    parser->position ++;
+    if(parseQueryAnd(parser, & operand) == FALSE)
+    {
+      freeBitmap(result);
+      return FALSE;
+    }
+    if(combineInto(result, & operand, bitmapOr) == FALSE)
+    {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/*
+  Function to find the deals matching a query.
+
+  Input   = {historyIndex *: index, char *: query, roaringBitmap *: result,
+            int *: errorAt}
+  Output  = {bool: success}
+*/
+bool queryHistoryIndex(const historyIndex * index, const char * query,
+  roaringBitmap * result, int * errorAt)
+{
+  queryParser parser;
+
+  parser.index = index;
+  parser.query = query;
+  parser.position = 0;
+  parser.depth = 0;
+  if(parseQueryOr(& parser, result) == FALSE)
+  {
+    * errorAt = parser.position;
+    return FALSE;
+  }
+  if(peekQuery(& parser) != '\0')
+  {
+    freeBitmap(result);
+    * errorAt = parser.position;
+    return FALSE;
+  }
+  * errorAt = INVALID_INT;
+  return TRUE;
+}
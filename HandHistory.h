@@ -0,0 +1,154 @@
+#ifndef HandHistory_h
+#define HandHistory_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Compressed sets of deal ids */
+#include "RoaringBitmap.h"
+
+/*
+  stdint.h is included for the file offsets and stddef.h for the size of the
+  mapped index.
+*/
+#include <stdint.h>
+#include <stddef.h>
+
+/* Magic number starting a history index file */
+#define HISTORY_INDEX_MAGIC "PKRINDX1"
+#define HISTORY_MAGIC_SIZE 8
+/* How a seat ends a deal */
+#define NUM_OF_OUTCOMES 3
+/* Most deals an index holds, every deal id fits 32 bits */
+#define MAX_INDEXED_DEALS (1ULL << 32)
+
+/* Outcome of a seat at a deal: won outright, split the pot or lost */
+typedef enum dealOutcome
+{
+  OutcomeWon, OutcomeSplit, OutcomeLost
+} dealOutcome;
+
+/*
+  Index directory structure, where the containers of one bitmap are listed
+  in the index file.
+
+    offset          - file offset of the first indexEntry
+    numOfContainers - entries listed
+*/
+typedef struct indexDirectory
+{
+  uint64_t offset;
+  uint64_t numOfContainers;
+} indexDirectory;
+
+/*
+  Index entry structure, one container of a bitmap. Array containers are
+  stored as cardinality 16 bit values and bitmap containers as
+  CONTAINER_WORDS 64 bit words, each starting on an 8 byte boundary so they
+  can be used in place from a mapped file.
+
+    key         - top 16 bits of the deal ids
+    cardinality - deal ids in the container
+    offset      - file offset of the values or words
+*/
+typedef struct indexEntry
+{
+  uint32_t key;
+  uint32_t cardinality;
+  uint64_t offset;
+} indexEntry;
+
+/*
+  History index header structure, at the start of an index file. The file
+  holds one bitmap of deal ids for every seat, hand rank and outcome, the
+  deals at which the seat held a hand of that rank and ended that way.
+  Numbers are stored in the byte order of the machine.
+
+    magic        - HISTORY_INDEX_MAGIC
+    numOfPlayers - seats at every deal
+    reserved     - 0
+    numOfTables  - deals indexed, their ids running from 0
+    directories  - where each bitmap's containers are listed
+*/
+typedef struct historyIndexHeader
+{
+  char magic[HISTORY_MAGIC_SIZE];
+  uint32_t numOfPlayers;
+  uint32_t reserved;
+  uint64_t numOfTables;
+  indexDirectory directories[MAX_PLAYERS][NUM_OF_HAND_RANKS][NUM_OF_OUTCOMES];
+} historyIndexHeader;
+
+/*
+  History index structure, an index file mapped into memory. Bitmaps loaded
+  from it borrow the mapped containers, so opening an index and answering a
+  query only touch the parts of the file the query needs.
+
+    mapped     - the mapped file
+    mappedSize - bytes mapped
+    header     - header at the start of the mapping
+*/
+typedef struct historyIndex
+{
+  const unsigned char * mapped;
+  size_t mappedSize;
+  const historyIndexHeader * header;
+} historyIndex;
+
+/*
+  Function to index a binary deal file written by the pipeline: every seat
+  of every deal is ranked again and its deal id, the record number, added to
+  the bitmap of its seat, hand rank and outcome. Deals are taken 65536 at a
+  time, one container of each bitmap, so the memory used does not grow with
+  the file beyond the bitmap directories.
+
+  Input   = {char *: dealPath, char *: indexPath, uint64_t *: numIndexed}
+  Output  = {bool: success}
+*/
+bool buildHistoryIndex(const char *, const char *, uint64_t *);
+
+/*
+  Function to map an index file and check its header.
+
+  Input   = {historyIndex *: index, char *: path}
+  Output  = {bool: success}
+*/
+bool openHistoryIndex(historyIndex *, const char *);
+
+/*
+  Function to unmap an index file.
+
+  Input   = {historyIndex *: index}
+  Output  = {void: NULL}
+*/
+void closeHistoryIndex(historyIndex *);
+
+/*
+  Function to load the bitmap of a seat, counted from 0, a hand rank and an
+  outcome. The bitmap borrows the mapped file and must be freed before the
+  index is closed.
+
+  Input   = {historyIndex *: index, int: seat, pokerRank: category,
+            dealOutcome: outcome, roaringBitmap *: bitmap}
+  Output  = {bool: success}, FALSE when the file is damaged
+*/
+bool loadIndexBitmap(const historyIndex *, int, pokerRank, dealOutcome,
+  roaringBitmap *);
+
+/*
+  Function to find the deals matching a query. A query combines terms with
+  ! (not), & (and), - (and not) and | (or), tightest first, and
+  parentheses. A term is "all", or a seat s1, s2 and so on followed by any
+  of a hand rank and an outcome, each after a dot, as in s3.flush.lost; the
+  rank is a number or a name without spaces, such as twopairs, and the
+  outcome is won, split or lost. A term leaving out the rank or the outcome
+  matches any. Parentheses nest at most 256 deep.
+
+  Input   = {historyIndex *: index, char *: query, roaringBitmap *: result,
+            int *: errorAt}
+  Output  = {bool: success}, FALSE with the position of the first character
+            not understood in errorAt
+*/
+bool queryHistoryIndex(const historyIndex *, const char *, roaringBitmap *,
+  int *);
+
+#endif /* HandHistory_h */
@@ -0,0 +1,203 @@
+#include "HandIndex.h"
+/* Card indices */
+#include "HandEvaluator.h"
+/* Binomial coefficients */
+#include "Combinatorics.h"
+
+/*
+  Binomial coefficients C(c, k + 1) as 32 bit values, one row per member of
+  a hand, padded to 64 entries so the binary search below never leaves the
+  row.
+*/
+#define SEARCH_ROW_SIZE 64
+static uint32_t colexTable[CARDS_PER_HAND][SEARCH_ROW_SIZE];
+
+/*
+  The three lowest cards of every colex index below C(52, 3), packed one
+  byte per card, so unranking only searches for the two highest cards.
+*/
+#define LOW_MEMBERS 3
+#define NUM_OF_LOW_COMBINATIONS 22100
+static uint32_t lowMembersTable[NUM_OF_LOW_COMBINATIONS];
+
+/*
+  Function to fill the colex table from the binomial table, run before main.
+
+  Input   = {void: NULL}
+  Output  = {void: NULL}
+*/
+__attribute__((constructor(102))) static void fillColexTable(void)
+{
+  unsigned char members[LOW_MEMBERS];
+  int memberNum = 0;
+  int cardNum = 0;
+  uint32_t index = 0;
+  for(memberNum = 0; memberNum < CARDS_PER_HAND; memberNum ++)
+  {
+    for(cardNum = 0; cardNum < SEARCH_ROW_SIZE; cardNum ++)
+    {
+      /* Entries past the deck can never be chosen */
+      colexTable[memberNum][cardNum] = (cardNum <= STD_DECK_SIZE) ?
+        (uint32_t)choose(cardNum, memberNum + 1) : UINT32_MAX;
+    }
+  }
+  for(index = 0; index < NUM_OF_LOW_COMBINATIONS; index ++)
+  {
+    unrankCombination(index, LOW_MEMBERS, members);
+    lowMembersTable[index] = members[0] | (members[1] << 8) |
+      (members[2] << 16);
+  }
+}
+
+/* Order two card indices */
+#define sortPair(first, second) \
+  do \
+  { \
+    unsigned char low = (first) < (second) ? (first) : (second); \
+    unsigned char high = (first) < (second) ? (second) : (first); \
+    (first) = low; \
+    (second) = high; \
+  } while(0)
+
+/*
+  Function to determine the colex index of five distinct card indices. The
+  cards are put in order with a nine comparison sorting network.
+
+  Input   = {unsigned char [CARDS_PER_HAND]: cards}
+  Output  = {handIndex: index}
+*/
+handIndex rankHandIndices(const unsigned char cards[CARDS_PER_HAND])
+{
+  unsigned char c0 = cards[0];
+  unsigned char c1 = cards[1];
+  unsigned char c2 = cards[2];
+  unsigned char c3 = cards[3];
+  unsigned char c4 = cards[4];
+
+  sortPair(c0, c1);
+  sortPair(c3, c4);
+  sortPair(c2, c4);
+  sortPair(c2, c3);
+  sortPair(c1, c4);
+  sortPair(c0, c3);
+  sortPair(c0, c2);
+  sortPair(c1, c3);
+  sortPair(c1, c2);
+  return colexTable[0][c0] + colexTable[1][c1] + colexTable[2][c2] +
+    colexTable[3][c3] + colexTable[4][c4];
+}
+
+/*
+  Largest card index c with C(c, member + 1) no greater than the remaining
+  index, by a branch free binary search over the table row.
+*/
+static inline int findMember(const uint32_t * row, uint32_t remaining)
+{
+  int position = 0;
+  int step = SEARCH_ROW_SIZE / 2;
+  for(; step > 0; step >>= 1)
+  {
+    position += (row[position + step] <= remaining) ? step : 0;
+  }
+  return position;
+}
+
+/*
+  Function to find the five card indices of a colex index. The two highest
+  cards are searched for, the three lowest are looked up.
+
+  Input   = {handIndex: index, unsigned char [CARDS_PER_HAND]: cards}
+  Output  = {void: NULL}
+*/
+void unrankHandIndices(handIndex index, unsigned char cards[CARDS_PER_HAND])
+{
+  uint32_t lowMembers = 0;
+  int position = 0;
+
+  position = findMember(colexTable[4], index);
+  cards[4] = position;
+  index -= colexTable[4][position];
+  position = findMember(colexTable[3], index);
+  cards[3] = position;
+  index -= colexTable[3][position];
+  lowMembers = lowMembersTable[index];
+  cards[0] = lowMembers & 0xFF;
+  cards[1] = (lowMembers >> 8) & 0xFF;
+  cards[2] = (lowMembers >> 16) & 0xFF;
+}
+
+/*
+  Function to determine the colex index of a hand of the poker table.
+
+  Input   = {card [CARDS_PER_HAND][MAX_PLAYERS]: hands, int: hand}
+  Output  = {handIndex: index}
+*/
+handIndex rankHand(card hands[CARDS_PER_HAND][MAX_PLAYERS], int hand)
+{
+  unsigned char cards[CARDS_PER_HAND];
+  int cardNum = NUM_INIT;
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    cards[cardNum] = cardToIndex(& hands[cardNum][hand]);
+  }
+  return rankHandIndices(cards);
+}
+
+/*
+  Function to place the hand of a colex index into a hand of the poker
+  table.
+
+  Input   = {handIndex: index, card [CARDS_PER_HAND][MAX_PLAYERS]: hands,
+            int: hand}
+  Output  = {bool: success}
+*/
+bool unrankHand(handIndex index, card hands[CARDS_PER_HAND][MAX_PLAYERS],
+  int hand)
+{
+  unsigned char cards[CARDS_PER_HAND];
+  int cardNum = NUM_INIT;
+  if(index >= NUM_OF_FIVE_CARD_HANDS)
+  {
+    return FALSE;
+  }
+  unrankHandIndices(index, cards);
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    indexToCard(cards[cardNum], & hands[cardNum][hand]);
+  }
+  return TRUE;
+}
+
+/*
+  Function to rank a batch of hands.
+
+  Input   = {unsigned char [][CARDS_PER_HAND]: hands, handIndex *: indices,
+            size_t: count}
+  Output  = {void: NULL}
+*/
+void rankHandBatch(const unsigned char (* hands)[CARDS_PER_HAND],
+  handIndex * indices, size_t count)
+{
+  size_t handNum = 0;
+  for(handNum = 0; handNum < count; handNum ++)
+  {
+    indices[handNum] = rankHandIndices(hands[handNum]);
+  }
+}
+
+/*
+  Function to unrank a batch of colex indices.
+
+  Input   = {handIndex *: indices, unsigned char [][CARDS_PER_HAND]: hands,
+            size_t: count}
+  Output  = {void: NULL}
+*/
+void unrankHandBatch(const handIndex * indices,
+  unsigned char (* hands)[CARDS_PER_HAND], size_t count)
+{
+  size_t handNum = 0;
+  for(handNum = 0; handNum < count; handNum ++)
+  {
+    unrankHandIndices(indices[handNum], hands[handNum]);
+  }
+}
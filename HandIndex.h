@@ -0,0 +1,87 @@
+#ifndef HandIndex_h
+#define HandIndex_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+
+/*
+  stdint.h is included for the 32 bit hand index type, and stddef.h for the
+  size_t batch lengths.
+*/
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+  Number of distinct five card hands, C(52, 5). Every hand has a colex index
+  below it, so a hand fits in 22 bits and can index a per-hand array.
+*/
+#define NUM_OF_FIVE_CARD_HANDS 2598960
+#define HAND_INDEX_BITS 22
+
+/*
+  Hand index type
+
+  The colex index of a five card hand: with the card indices sorted as
+  c0 < c1 < c2 < c3 < c4 it is C(c0, 1) + C(c1, 2) + C(c2, 3) + C(c3, 4) +
+  C(c4, 5). Hands whose highest card is c therefore form the contiguous
+  range [C(c, 5), C(c + 1, 5)), which is what range partitioning relies on.
+*/
+typedef uint32_t handIndex;
+
+/*
+  Function to determine the colex index of five distinct card indices given
+  in any order.
+
+  Input   = {unsigned char [CARDS_PER_HAND]: cards}
+  Output  = {handIndex: index}
+*/
+handIndex rankHandIndices(const unsigned char [CARDS_PER_HAND]);
+
+/*
+  Function to find the five card indices, in ascending order, of a colex
+  index.
+
+  Input   = {handIndex: index, unsigned char [CARDS_PER_HAND]: cards}
+  Output  = {void: NULL}
+*/
+void unrankHandIndices(handIndex, unsigned char [CARDS_PER_HAND]);
+
+/*
+  Function to determine the colex index of a hand of the poker table.
+
+  Input   = {card [CARDS_PER_HAND][MAX_PLAYERS]: hands, int: hand}
+  Output  = {handIndex: index}
+*/
+handIndex rankHand(card [CARDS_PER_HAND][MAX_PLAYERS], int);
+
+/*
+  Function to place the hand of a colex index into a hand of the poker
+  table, in ascending card order.
+
+  Input   = {handIndex: index, card [CARDS_PER_HAND][MAX_PLAYERS]: hands,
+            int: hand}
+  Output  = {bool: success}
+*/
+bool unrankHand(handIndex, card [CARDS_PER_HAND][MAX_PLAYERS], int);
+
+/*
+  Function to rank a batch of hands.
+
+  Input   = {unsigned char [][CARDS_PER_HAND]: hands, handIndex *: indices,
+            size_t: count}
+  Output  = {void: NULL}
+*/
+void rankHandBatch(const unsigned char (*)[CARDS_PER_HAND], handIndex *,
+  size_t);
+
+/*
+  Function to unrank a batch of colex indices.
+
+  Input   = {handIndex *: indices, unsigned char [][CARDS_PER_HAND]: hands,
+            size_t: count}
+  Output  = {void: NULL}
+*/
+void unrankHandBatch(const handIndex *, unsigned char (*)[CARDS_PER_HAND],
+  size_t);
+
+#endif /* HandIndex_h */
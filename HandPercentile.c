@@ -0,0 +1,577 @@
+#include "HandPercentile.h"
+/* Hand strengths */
+#include "HandEvaluator.h"
+/* Colex hand indices */
+#include "HandIndex.h"
+/* Suit canonical classes */
+#include "SuitIsomorphism.h"
+/* Colex combinations and binomial coefficients */
+#include "Combinatorics.h"
+/* Generator streams and shuffles */
+#include "PokerRandom.h"
+/* Worker threads */
+#include "PokerThreads.h"
+
+/* stdatomic.h is included for the class counter. */
+#include <stdatomic.h>
+/* math.h is included for sqrt, for the standard errors. */
+#include <math.h>
+/* stdlib.h is included for malloc, calloc, free and qsort. */
+#include <stdlib.h>
+/* string.h is included for memcmp, memcpy and memset. */
+#include <string.h>
+/* stdio.h is included for writing the table file. */
+#include <stdio.h>
+/*
+  fcntl.h, sys/mman.h, sys/stat.h and unistd.h are included to map a table
+  file.
+*/
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Cards left for the opponents once a hand is dealt */
+#define OPPONENT_POOL (STD_DECK_SIZE - CARDS_PER_HAND)
+/* Subsets of a hand's cards as bit masks, all but the empty and full ones */
+#define NUM_OF_SUBSET_MASKS ((1 << CARDS_PER_HAND) - 1)
+/* Classes each thread samples before taking more */
+#define PERCENTILE_CHUNK_CLASSES 64
+/* Bits of a sort key below the strength, those of the colex index */
+#define SORT_INDEX_MASK ((1ULL << HAND_INDEX_BITS) - 1)
+
+/*
+  Counts of the hands swept so far that hold each set of one to four cards,
+  by the set's colex index, for inclusion and exclusion.
+
+    numOfHands - hands swept
+    counts     - counts[s] for sets of s cards
+*/
+typedef struct sweepCounts
+{
+  uint64_t numOfHands;
+  uint32_t * counts[CARDS_PER_HAND];
+} sweepCounts;
+
+/* State shared by the sampling threads */
+typedef struct percentileContext
+{
+  const percentileBuild * build;
+  const canonicalClass * classes;
+  int numOfClasses;
+  atomic_int nextClass;
+  percentileOdds * odds;
+  float * errors;
+} percentileContext;
+
+/*
+  Function to find the colex index of every subset of one to four of a
+  hand's cards, subset mask m holding the cards of the set bits.
+
+  Input   = {unsigned char *: cards, uint32_t *: subsets}
+  Output  = {void: NULL}
+*/
+static void handSubsets(const unsigned char cards[CARDS_PER_HAND],
+  uint32_t subsets[NUM_OF_SUBSET_MASKS])
+{
+  unsigned char members[CARDS_PER_HAND];
+  int mask = NUM_INIT;
+  int size = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  for(mask = 1; mask < NUM_OF_SUBSET_MASKS; mask ++)
+  {
+    size = NUM_INIT;
+    for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+    {
+      if((mask >> cardNum) & 1)
+      {
+        members[size ++] = cards[cardNum];
+      }
+    }
+    subsets[mask] = (uint32_t)rankCombination(members, size);
+  }
+}
+
+/*
+  Function to count the swept hands sharing no card with a hand: all of
+  them, less those holding each of its cards, plus those holding each pair
+  and so on, less the hand itself once it has been swept.
+
+  Input   = {sweepCounts *: sweep, uint32_t *: subsets, bool: selfSwept}
+  Output  = {uint64_t: disjointHands}
+*/
+static uint64_t disjointHands(const sweepCounts * sweep,
+  const uint32_t subsets[NUM_OF_SUBSET_MASKS], bool selfSwept)
+{
+  int64_t disjoint = (int64_t)sweep->numOfHands - (selfSwept == TRUE);
+  int mask = NUM_INIT;
+  int size = NUM_INIT;
+
+  for(mask = 1; mask < NUM_OF_SUBSET_MASKS; mask ++)
+  {
+    size = __builtin_popcount(mask);
+    if(size % 2 == 1)
+    {
+      disjoint -= sweep->counts[size][subsets[mask]];
+    }
+    else
+    {
+      disjoint += sweep->counts[size][subsets[mask]];
+    }
+  }
+  return (uint64_t)disjoint;
+}
+
+/*
+  Function to add a hand to the sweep counts.
+
+  Input   = {sweepCounts *: sweep, uint32_t *: subsets}
+  Output  = {void: NULL}
+*/
+static void sweepHand(sweepCounts * sweep,
+  const uint32_t subsets[NUM_OF_SUBSET_MASKS])
+{
+  int mask = NUM_INIT;
+
+  sweep->numOfHands ++;
+  for(mask = 1; mask < NUM_OF_SUBSET_MASKS; mask ++)
+  {
+    sweep->counts[__builtin_popcount(mask)][subsets[mask]] ++;
+  }
+}
+
+/* Order sort keys, strength above colex index */
+static int compareSortKeys(const void * first, const void * second)
+{
+  const uint64_t a = * (const uint64_t *)first;
+  const uint64_t b = * (const uint64_t *)second;
+  return (a > b) - (a < b);
+}
+
+/*
+  Function to count exactly, for every class, the hands of one opponent its
+  hand beats and ties, sweeping every hand in order of strength, a group of
+  equal strengths at a time.
+
+  Input   = {uint32_t *: classOfHand, canonicalClass *: classes,
+            percentileOdds *: odds}
+  Output  = {bool: success}
+*/
+static bool sweepOneOpponent(const uint32_t * classOfHand,
+  const canonicalClass * classes, percentileOdds * odds)
+{
+  const double opponentHands = (double)choose(OPPONENT_POOL, CARDS_PER_HAND);
+  uint64_t * keys = malloc(sizeof(uint64_t) * NUM_OF_FIVE_CARD_HANDS);
+  uint64_t * beaten = malloc(sizeof(uint64_t) *
+    NUM_OF_CANONICAL_FIVE_CARD_HANDS);
+  unsigned char cards[CARDS_PER_HAND];
+  uint32_t subsets[NUM_OF_SUBSET_MASKS];
+  sweepCounts sweep;
+  handIndex index = 0;
+  uint32_t classNum = 0;
+  bool success = (keys != NULL) && (beaten != NULL);
+  int groupStart = NUM_INIT;
+  int groupEnd = NUM_INIT;
+  int handNum = NUM_INIT;
+  int size = NUM_INIT;
+
+  memset(& sweep, 0, sizeof(sweep));
+  for(size = 1; size < CARDS_PER_HAND; size ++)
+  {
+    sweep.counts[size] = calloc(choose(STD_DECK_SIZE, size),
+      sizeof(uint32_t));
+    success = success && (sweep.counts[size] != NULL);
+  }
+  for(index = 0; success == TRUE && index < NUM_OF_FIVE_CARD_HANDS; index ++)
+  {
+    unrankHandIndices(index, cards);
+    keys[index] = ((uint64_t)evaluateCardIndices(cards, CARDS_PER_HAND) <<
+      HAND_INDEX_BITS) | index;
+  }
+  if(success == TRUE)
+  {
+    qsort(keys, NUM_OF_FIVE_CARD_HANDS, sizeof(uint64_t), compareSortKeys);
+  }
+
+  for(groupStart = NUM_INIT; success == TRUE &&
+    groupStart < NUM_OF_FIVE_CARD_HANDS; groupStart = groupEnd)
+  {
+    for(groupEnd = groupStart; (groupEnd < NUM_OF_FIVE_CARD_HANDS) &&
+      ((keys[groupEnd] >> HAND_INDEX_BITS) ==
+      (keys[groupStart] >> HAND_INDEX_BITS)); groupEnd ++)
+    {
+      index = keys[groupEnd] & SORT_INDEX_MASK;
+      classNum = classOfHand[index];
+      if(classes[classNum].index == index)
+      {
+        unrankHandIndices(index, cards);
+        handSubsets(cards, subsets);
+        beaten[classNum] = disjointHands(& sweep, subsets, FALSE);
+      }
+    }
+    for(handNum = groupStart; handNum < groupEnd; handNum ++)
+    {
+      unrankHandIndices(keys[handNum] & SORT_INDEX_MASK, cards);
+      handSubsets(cards, subsets);
+      sweepHand(& sweep, subsets);
+    }
+    for(handNum = groupStart; handNum < groupEnd; handNum ++)
+    {
+      index = keys[handNum] & SORT_INDEX_MASK;
+      classNum = classOfHand[index];
+      if(classes[classNum].index == index)
+      {
+        unrankHandIndices(index, cards);
+        handSubsets(cards, subsets);
+        odds[classNum * MAX_OPPONENTS].win = beaten[classNum] /
+          opponentHands;
+        odds[classNum * MAX_OPPONENTS].tie = (disjointHands(& sweep, subsets,
+          TRUE) - beaten[classNum]) / opponentHands;
+      }
+    }
+  }
+
+  for(size = 1; size < CARDS_PER_HAND; size ++)
+  {
+    free(sweep.counts[size]);
+  }
+  free(keys);
+  free(beaten);
+  return success;
+}
+
+/*
+  Function to estimate a chance against k opponents from the exact chance
+  against one: the share of the deals passing the first opponent that also
+  pass the next k - 1 scales it, a binomial share whose standard error is
+  noted.
+
+  Input   = {double: exact, uint64_t: passedFirst, uint64_t: passedAll,
+            float *: error}
+  Output  = {double: chance}
+*/
+static double scaleExactOdds(double exact, uint64_t passedFirst,
+  uint64_t passedAll, float * error)
+{
+  const double share = (passedFirst > 0) ?
+    (double)passedAll / passedFirst : 0.0;
+  /* With no deal passing the first opponent the chance is at most exact */
+  const double shareError = (passedFirst > 0) ?
+    sqrt(share * (1.0 - share) / passedFirst) : 1.0;
+
+  if(exact * shareError > * error)
+  {
+    * error = exact * shareError;
+  }
+  return exact * share;
+}
+
+/*
+  Function to sample the odds of one class against 2 to MAX_OPPONENTS
+  opponents. An opponent's cards are dealt only when the deal reaches it,
+  and once an opponent is stronger every larger table is lost too.
+
+  Input   = {percentileContext *: context, int: classNum}
+  Output  = {void: NULL}
+*/
+static void sampleClass(percentileContext * context, int classNum)
+{
+  const uint64_t samples = context->build->samples;
+  percentileOdds * odds = context->odds + classNum * MAX_OPPONENTS;
+  unsigned char cards[CARDS_PER_HAND];
+  unsigned char deck[STD_DECK_SIZE];
+  uint64_t wins[MAX_OPPONENTS];
+  uint64_t ties[MAX_OPPONENTS];
+  uint64_t held = 0;
+  uint64_t sampleNum = 0;
+  double notStronger = 0.0;
+  handStrength strength = 0;
+  handStrength opponent = 0;
+  handStrength best = 0;
+  pokerRng rng;
+  int numOfLeft = NUM_INIT;
+  int cardNum = NUM_INIT;
+  int opponentNum = NUM_INIT;
+
+  unrankHandIndices(context->classes[classNum].index, cards);
+  strength = evaluateCardIndices(cards, CARDS_PER_HAND);
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    held |= 1ULL << cards[cardNum];
+  }
+  for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    if(((held >> cardNum) & 1) == 0)
+    {
+      deck[numOfLeft ++] = cardNum;
+    }
+  }
+  memset(wins, 0, sizeof(wins));
+  memset(ties, 0, sizeof(ties));
+  seedRng(& rng, context->build->seed, classNum);
+  for(sampleNum = 0; sampleNum < samples; sampleNum ++)
+  {
+    best = 0;
+    for(opponentNum = NUM_INIT; opponentNum < MAX_OPPONENTS; opponentNum ++)
+    {
+      /* Carries on the partial shuffle of the cards dealt so far */
+      shuffleCardIndices(& rng, deck + opponentNum * CARDS_PER_HAND,
+        OPPONENT_POOL - opponentNum * CARDS_PER_HAND, CARDS_PER_HAND);
+      opponent = evaluateCardIndices(
+        deck + opponentNum * CARDS_PER_HAND, CARDS_PER_HAND);
+      best = (opponent > best) ? opponent : best;
+      if(best > strength)
+      {
+        break;
+      }
+      wins[opponentNum] += (best < strength);
+      ties[opponentNum] += (best == strength);
+    }
+  }
+  /* Against one opponent the sweep's exact odds are kept and scaled */
+  context->errors[classNum] = 0.0f;
+  for(opponentNum = 1; opponentNum < MAX_OPPONENTS; opponentNum ++)
+  {
+    odds[opponentNum].win = scaleExactOdds(odds[0].win, wins[0],
+      wins[opponentNum], & context->errors[classNum]);
+    notStronger = scaleExactOdds((double)odds[0].win + odds[0].tie,
+      wins[0] + ties[0], wins[opponentNum] + ties[opponentNum],
+      & context->errors[classNum]);
+    odds[opponentNum].tie = (notStronger > odds[opponentNum].win) ?
+      notStronger - odds[opponentNum].win : 0.0;
+  }
+}
+
+/*
+  Function run by every sampling thread: take chunks of classes until none
+  are left.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void percentileWorker(void * contextPTR, int threadNum)
+{
+  percentileContext * context = (percentileContext *)contextPTR;
+  int first = NUM_INIT;
+  int classNum = NUM_INIT;
+
+  (void)threadNum;
+  for(;;)
+  {
+    first = atomic_fetch_add_explicit(& context->nextClass,
+      PERCENTILE_CHUNK_CLASSES, memory_order_relaxed);
+    if(first >= context->numOfClasses)
+    {
+      break;
+    }
+    for(classNum = first; (classNum < first + PERCENTILE_CHUNK_CLASSES) &&
+      (classNum < context->numOfClasses); classNum ++)
+    {
+      sampleClass(context, classNum);
+    }
+  }
+}
+
+/*
+  Function to write a table file.
+
+  Input   = {char *: path, percentileHeader *: header,
+            uint32_t *: classOfHand, percentileOdds *: odds}
+  Output  = {bool: success}
+*/
+static bool writePercentileTable(const char * path,
+  const percentileHeader * header, const uint32_t * classOfHand,
+  const percentileOdds * odds)
+{
+  FILE * output = fopen(path, "wb");
+  bool success = FALSE;
+
+  if(output == NULL)
+  {
+    return FALSE;
+  }
+  success = ((fwrite(header, sizeof(percentileHeader), 1, output) == 1) &&
+    (fwrite(classOfHand, sizeof(uint32_t), NUM_OF_FIVE_CARD_HANDS, output) ==
+    NUM_OF_FIVE_CARD_HANDS) && (fwrite(odds, sizeof(percentileOdds),
+    (size_t)header->numOfClasses * MAX_OPPONENTS, output) ==
+    (size_t)header->numOfClasses * MAX_OPPONENTS)) ? TRUE : FALSE;
+  if(fclose(output) != 0)
+  {
+    success = FALSE;
+  }
+  return success;
+}
+
+/*
+  Function to build a percentile table file.
+
+  Input   = {char *: path, percentileBuild *: build}
+  Output  = {bool: success}
+*/
+bool buildPercentileTable(const char * path, const percentileBuild * build)
+{
+  percentileContext context;
+  percentileHeader header;
+  uint32_t * classOfHand = NULL;
+  unsigned char cards[CARDS_PER_HAND];
+  handIndex index = 0;
+  int classNum = NUM_INIT;
+  bool success = FALSE;
+
+  if(build->samples < 1)
+  {
+    return FALSE;
+  }
+  context.build = build;
+  context.classes = canonicalFiveCardClasses(& context.numOfClasses);
+  atomic_init(& context.nextClass, 0);
+  if((context.classes == NULL) ||
+    (context.numOfClasses != NUM_OF_CANONICAL_FIVE_CARD_HANDS))
+  {
+    return FALSE;
+  }
+  classOfHand = malloc(sizeof(uint32_t) * NUM_OF_FIVE_CARD_HANDS);
+  context.odds = calloc((size_t)context.numOfClasses * MAX_OPPONENTS,
+    sizeof(percentileOdds));
+  context.errors = calloc(context.numOfClasses, sizeof(float));
+  if((classOfHand != NULL) && (context.odds != NULL) &&
+    (context.errors != NULL))
+  {
+    for(index = 0; index < NUM_OF_FIVE_CARD_HANDS; index ++)
+    {
+      unrankHandIndices(index, cards);
+      classOfHand[index] = canonicalClassNumber(cards);
+    }
+    success = sweepOneOpponent(classOfHand, context.classes, context.odds);
+  }
+  if(success == TRUE)
+  {
+    runParallel(build->numOfThreads, percentileWorker, & context);
+    memset(& header, 0, sizeof(header));
+    memcpy(header.magic, PERCENTILE_MAGIC, PERCENTILE_MAGIC_SIZE);
+    header.numOfClasses = context.numOfClasses;
+    header.numOfOpponents = MAX_OPPONENTS;
+    header.samples = build->samples;
+    header.seed = build->seed;
+    for(classNum = NUM_INIT; classNum < context.numOfClasses; classNum ++)
+    {
+      if(context.errors[classNum] > header.standardError)
+      {
+        header.standardError = context.errors[classNum];
+      }
+    }
+    success = writePercentileTable(path, & header, classOfHand,
+      context.odds);
+  }
+  free(classOfHand);
+  free(context.odds);
+  free(context.errors);
+  return success;
+}
+
+/*
+  Function to map a table file and check its header.
+
+  Input   = {percentileTable *: table, char *: path}
+  Output  = {bool: success}
+*/
+bool openPercentileTable(percentileTable * table, const char * path)
+{
+  const size_t expectedSize = sizeof(percentileHeader) +
+    sizeof(uint32_t) * NUM_OF_FIVE_CARD_HANDS + sizeof(percentileOdds) *
+    NUM_OF_CANONICAL_FIVE_CARD_HANDS * MAX_OPPONENTS;
+  struct stat status;
+  void * mapped = MAP_FAILED;
+  int descriptor = open(path, O_RDONLY);
+
+  memset(table, 0, sizeof(* table));
+  if(descriptor < 0)
+  {
+    return FALSE;
+  }
+  if((fstat(descriptor, & status) == 0) &&
+    ((size_t)status.st_size == expectedSize))
+  {
+    mapped = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor,
+      0);
+  }
+  close(descriptor);
+  if(mapped == MAP_FAILED)
+  {
+    return FALSE;
+  }
+  table->mapped = mapped;
+  table->mappedSize = status.st_size;
+  table->header = mapped;
+  table->classOfHand = (const uint32_t *)(table->mapped +
+    sizeof(percentileHeader));
+  table->odds = (const percentileOdds *)(table->classOfHand +
+    NUM_OF_FIVE_CARD_HANDS);
+  if((memcmp(table->header->magic, PERCENTILE_MAGIC,
+    PERCENTILE_MAGIC_SIZE) != 0) ||
+    (table->header->numOfClasses != NUM_OF_CANONICAL_FIVE_CARD_HANDS) ||
+    (table->header->numOfOpponents != MAX_OPPONENTS))
+  {
+    closePercentileTable(table);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*
+  Function to unmap a table file.
+
+  Input   = {percentileTable *: table}
+  Output  = {void: NULL}
+*/
+void closePercentileTable(percentileTable * table)
+{
+  if(table->mapped != NULL)
+  {
+    munmap((void *)table->mapped, table->mappedSize);
+  }
+  memset(table, 0, sizeof(* table));
+}
+
+/*
+  Function to look up the odds of five card indices, all zero when the
+  number of opponents is out of range.
+
+  Input   = {percentileTable *: table, unsigned char *: cards,
+            int: numOfOpponents}
+  Output  = {percentileOdds: odds}
+*/
+percentileOdds lookupPercentile(const percentileTable * table,
+  const unsigned char cards[CARDS_PER_HAND], int numOfOpponents)
+{
+  const percentileOdds none = {0.0f, 0.0f};
+
+  if((numOfOpponents < 1) || (numOfOpponents > MAX_OPPONENTS))
+  {
+    return none;
+  }
+  return table->odds[(size_t)table->classOfHand[rankHandIndices(cards)] *
+    MAX_OPPONENTS + numOfOpponents - 1];
+}
+
+/*
+  Function to look up the odds of a hand of the poker table.
+
+  Input   = {percentileTable *: table,
+            card [CARDS_PER_HAND][MAX_PLAYERS]: hands, int: hand,
+            int: numOfOpponents}
+  Output  = {percentileOdds: odds}
+*/
+percentileOdds handPercentile(const percentileTable * table,
+  card hands[CARDS_PER_HAND][MAX_PLAYERS], int hand, int numOfOpponents)
+{
+  unsigned char cards[CARDS_PER_HAND];
+  int cardNum = NUM_INIT;
+
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    cards[cardNum] = cardToIndex(& hands[cardNum][hand]);
+  }
+  return lookupPercentile(table, cards, numOfOpponents);
+}
@@ -0,0 +1,151 @@
+#ifndef HandPercentile_h
+#define HandPercentile_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+
+/*
+  stdint.h is included for the class numbers and stddef.h for the size of
+  the mapped table.
+*/
+#include <stdint.h>
+#include <stddef.h>
+
+/* Magic number starting a percentile table file */
+#define PERCENTILE_MAGIC "PKRPCTL2"
+#define PERCENTILE_MAGIC_SIZE 8
+/* Most random opponents a table covers */
+#define MAX_OPPONENTS (MAX_PLAYERS - 1)
+/* Deals sampled for each class against two or more opponents by default */
+#define DEFAULT_PERCENTILE_SAMPLES 65536
+
+/*
+  Percentile odds structure, the chances of a hand against some random
+  opponents dealt from the other 47 cards.
+
+    win - no opponent's hand is as strong
+    tie - no opponent's hand is stronger and at least one is as strong
+*/
+typedef struct percentileOdds
+{
+  float win;
+  float tie;
+} percentileOdds;
+
+/*
+  Percentile header structure, at the start of a table file. The header is
+  followed by the suit class number of every five card hand, a uint32_t in
+  colex order, then by the odds of every class against 1 to MAX_OPPONENTS
+  opponents. Odds against one opponent are exact; against more they are
+  estimated from samples deals of each class. Numbers are stored in the
+  byte order of the machine.
+
+    magic          - PERCENTILE_MAGIC
+    numOfClasses   - suit classes, NUM_OF_CANONICAL_FIVE_CARD_HANDS
+    numOfOpponents - MAX_OPPONENTS
+    samples        - deals sampled for each class
+    seed           - seed of the sampled deals
+    standardError  - largest standard error of any estimated chance to win,
+                     or to win or tie, over every class and number of
+                     opponents
+*/
+typedef struct percentileHeader
+{
+  char magic[PERCENTILE_MAGIC_SIZE];
+  uint32_t numOfClasses;
+  uint32_t numOfOpponents;
+  uint64_t samples;
+  uint64_t seed;
+  double standardError;
+} percentileHeader;
+
+/*
+  Percentile table structure, a table file mapped into memory.
+
+    mapped      - the mapped file
+    mappedSize  - bytes mapped
+    header      - header at the start of the mapping
+    classOfHand - suit class number of every hand by colex index
+    odds        - odds of class c against k opponents at
+                  odds[c * MAX_OPPONENTS + k - 1]
+*/
+typedef struct percentileTable
+{
+  const unsigned char * mapped;
+  size_t mappedSize;
+  const percentileHeader * header;
+  const uint32_t * classOfHand;
+  const percentileOdds * odds;
+} percentileTable;
+
+/*
+  Percentile build structure, how a table is built.
+
+    samples      - deals sampled for each class against 2 or more opponents
+    seed         - seed of the sampled deals
+    numOfThreads - threads sampling
+*/
+typedef struct percentileBuild
+{
+  uint64_t samples;
+  uint64_t seed;
+  int numOfThreads;
+} percentileBuild;
+
+/*
+  Function to build a percentile table file. Against one opponent every
+  hand's wins and ties are counted exactly: the hands are swept in order of
+  strength while counters of every set of one to four cards dealt so far
+  give, by inclusion and exclusion, the weaker and equal hands sharing no
+  card with it. Against more opponents each suit class is dealt samples
+  deals of MAX_OPPONENTS opponents on the threads, every class on its own
+  generator stream. The deals only estimate the share of the hands beating
+  the first opponent that also beat the next k - 1, which scales the exact
+  odds against one, so the first opponent adds no sampling error and the
+  odds never grow with k.
+
+  Input   = {char *: path, percentileBuild *: build}
+  Output  = {bool: success}
+*/
+bool buildPercentileTable(const char *, const percentileBuild *);
+
+/*
+  Function to map a table file and check its header.
+
+  Input   = {percentileTable *: table, char *: path}
+  Output  = {bool: success}
+*/
+bool openPercentileTable(percentileTable *, const char *);
+
+/*
+  Function to unmap a table file.
+
+  Input   = {percentileTable *: table}
+  Output  = {void: NULL}
+*/
+void closePercentileTable(percentileTable *);
+
+/*
+  Function to look up the odds of five card indices against 1 to
+  MAX_OPPONENTS random opponents, a colex index and two array reads.
+
+  Input   = {percentileTable *: table, unsigned char *: cards,
+            int: numOfOpponents}
+  Output  = {percentileOdds: odds}
+*/
+percentileOdds lookupPercentile(const percentileTable *,
+  const unsigned char [CARDS_PER_HAND], int);
+
+/*
+  Function to look up the odds of a hand of the poker table, alongside
+  assignRank.
+
+  Input   = {percentileTable *: table,
+            card [CARDS_PER_HAND][MAX_PLAYERS]: hands, int: hand,
+            int: numOfOpponents}
+  Output  = {percentileOdds: odds}
+*/
+percentileOdds handPercentile(const percentileTable *,
+  card [CARDS_PER_HAND][MAX_PLAYERS], int, int);
+
+#endif /* HandPercentile_h */
@@ -0,0 +1,914 @@
+#include "HandRange.h"
+/* Hand strengths and card lists */
+#include "HandEvaluator.h"
+/* Colex combinations and binomial coefficients */
+#include "Combinatorics.h"
+/* Worker threads */
+#include "PokerThreads.h"
+
+/* stdatomic.h is included for the block counter. */
+#include <stdatomic.h>
+/* stdlib.h is included for malloc, calloc, free, qsort and strtod. */
+#include <stdlib.h>
+/* string.h is included for memset, strlen, strchr and strcpy. */
+#include <string.h>
+/* strings.h is included for strcasecmp. */
+#include <strings.h>
+/* ctype.h is included for isspace and toupper. */
+#include <ctype.h>
+
+/* Hands of the first range each block of the pairs engine holds */
+#define RANGE_BLOCK_HANDS 64
+/* Hands of the second range a block meets at a time, about 32 KB of them */
+#define RANGE_TILE_HANDS 2048
+/* Subsets of a hand's cards as bit masks, all but the empty one */
+#define NUM_OF_SUBSET_MASKS (1 << CARDS_PER_HAND)
+/* Strongest possible strength, the top of open ended terms */
+#define MAX_RANGE_STRENGTH ((handStrength)UINT32_MAX)
+/* Bits of a sort key below the strength, those of the entry number */
+#define SORT_ENTRY_MASK ((1ULL << HAND_INDEX_BITS) - 1)
+
+/* Category names of range terms, by pokerRank */
+static const char * const categoryNames[StraightFlush + 1] =
+{
+  "high-card", "pair", "two-pair", "trips", "straight", "flush",
+  "full-house", "quads", "straight-flush"
+};
+
+/* Rank characters by ace high value */
+static const char rangeRanks[] = "23456789TJQKA";
+
+/*
+  Range term structure, one term of an expression. A hand matches when its
+  strength lies from low to high and it holds every card of cards.
+
+    low     - least strength matched
+    high    - greatest strength matched
+    cards   - mask of the cards a hand must hold
+    weight  - weight given to the hands matched
+    exclude - TRUE to remove the hands matched
+*/
+typedef struct rangeTerm
+{
+  handStrength low;
+  handStrength high;
+  uint64_t cards;
+  float weight;
+  bool exclude;
+} rangeTerm;
+
+/*
+  Range entries structure, the hands of a range in colex order laid out for
+  the equity engines.
+
+    numOfHands - hands
+    indices    - colex index of every hand
+    masks      - card mask of every hand
+    strengths  - strength of every hand
+    weights    - weight of every hand
+*/
+typedef struct rangeEntries
+{
+  uint32_t numOfHands;
+  handIndex * indices;
+  uint64_t * masks;
+  handStrength * strengths;
+  float * weights;
+} rangeEntries;
+
+/* State shared by the threads of the pairs engine */
+typedef struct pairsContext
+{
+  const rangeEntries * first;
+  const rangeEntries * second;
+  int numOfBlocks;
+  atomic_int nextBlock;
+  double (* sums)[3];
+  uint64_t * pairs;
+} pairsContext;
+
+/*
+  Weights and counts of the hands swept so far holding each set of one to
+  four cards, by the set's colex index, for inclusion and exclusion.
+
+    totalWeight - weight of the hands swept
+    numOfHands  - hands swept
+    weights     - weights[s] for sets of s cards, below five
+    counts      - counts[s] for sets of s cards, below five
+    self        - weight of every hand of the range swept, by colex index
+    swept       - bits of the hands swept, by colex index
+*/
+typedef struct rangeSweep
+{
+  double totalWeight;
+  uint64_t numOfHands;
+  double * weights[CARDS_PER_HAND];
+  uint32_t * counts[CARDS_PER_HAND];
+  const float * self;
+  const uint64_t * swept;
+} rangeSweep;
+
+/*
+  Function to create an empty range.
+
+  Input   = {handRange *: range}
+  Output  = {bool: success}
+*/
+bool createHandRange(handRange * range)
+{
+  memset(range, 0, sizeof(handRange));
+  range->bits = calloc(RANGE_WORDS, sizeof(uint64_t));
+  range->weights = calloc(NUM_OF_FIVE_CARD_HANDS, sizeof(float));
+  if((range->bits == NULL) || (range->weights == NULL))
+  {
+    freeHandRange(range);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*
+  Function to free the memory of a range.
+
+  Input   = {handRange *: range}
+  Output  = {void: NULL}
+*/
+void freeHandRange(handRange * range)
+{
+  free(range->bits);
+  free(range->weights);
+  memset(range, 0, sizeof(handRange));
+}
+
+/*
+  Function to read a category name, with a trailing '+' for the category or
+  better.
+
+  Input   = {char *: body, rangeTerm *: term}
+  Output  = {bool: success}
+*/
+static bool parseCategoryTerm(const char * body, rangeTerm * term)
+{
+  char name[16];
+  size_t length = strlen(body);
+  bool better = (length > 0) && (body[length - 1] == '+');
+  int category = NUM_INIT;
+
+  length -= (better == TRUE);
+  if(length >= sizeof(name))
+  {
+    return FALSE;
+  }
+  memcpy(name, body, length);
+  name[length] = '\0';
+  if(strcasecmp(name, "any") == 0)
+  {
+    return (better == FALSE);
+  }
+  for(category = HighCard; category <= StraightFlush; category ++)
+  {
+    if(strcasecmp(name, categoryNames[category]) == 0)
+    {
+      term->low = (handStrength)category << STRENGTH_CATEGORY_SHIFT;
+      term->high = (better == TRUE) ? MAX_RANGE_STRENGTH :
+        term->low + (1u << STRENGTH_CATEGORY_SHIFT) - 1;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/*
+  Function to read a run of two to four characters of one rank, such as
+  "TT", returning the characters read and the strength range of hands
+  whose largest group is that many cards of the rank.
+
+  Input   = {char *: text, handStrength *: low, handStrength *: high}
+  Output  = {int: numOfRead}, zero when the text starts with no such run
+*/
+static int parseRankGroup(const char * text, handStrength * low,
+  handStrength * high)
+{
+  static const pokerRank groupCategories[QUAD + 1] =
+  {
+    HighCard, HighCard, Pair, ThreeOfAKind, FourOfAKind
+  };
+  const char * found = (text[0] == '\0') ? NULL :
+    strchr(rangeRanks, toupper((unsigned char)text[0]));
+  int length = 1;
+
+  if(found == NULL)
+  {
+    return 0;
+  }
+  while(toupper((unsigned char)text[length]) == * found)
+  {
+    length ++;
+  }
+  if((length < PAIR) || (length > QUAD))
+  {
+    return 0;
+  }
+  * low = ((handStrength)groupCategories[length] <<
+    STRENGTH_CATEGORY_SHIFT) | ((handStrength)(found - rangeRanks) <<
+    ((STRENGTH_VALUES - 1) * STRENGTH_VALUE_BITS));
+  * high = * low + (1u << ((STRENGTH_VALUES - 1) * STRENGTH_VALUE_BITS)) - 1;
+  return length;
+}
+
+/*
+  Function to read a rank group term: "TT", "TT+" or "TT-KK".
+
+  Input   = {char *: body, rangeTerm *: term}
+  Output  = {bool: success}
+*/
+static bool parseGroupTerm(const char * body, rangeTerm * term)
+{
+  handStrength low = 0;
+  handStrength high = 0;
+  int length = parseRankGroup(body, & term->low, & term->high);
+
+  if(length == 0)
+  {
+    return FALSE;
+  }
+  body += length;
+  if((body[0] == '+') && (body[1] == '\0'))
+  {
+    term->high = MAX_RANGE_STRENGTH;
+    return TRUE;
+  }
+  if(body[0] == '-')
+  {
+    if((parseRankGroup(body + 1, & low, & high) != length) ||
+      (body[1 + length] != '\0') || (high < term->low))
+    {
+      return FALSE;
+    }
+    term->high = high;
+    return TRUE;
+  }
+  return (body[0] == '\0');
+}
+
+/*
+  Function to read a term of one to five distinct cards.
+
+  Input   = {char *: body, rangeTerm *: term}
+  Output  = {bool: success}
+*/
+static bool parseCardTerm(const char * body, rangeTerm * term)
+{
+  unsigned char cards[CARDS_PER_HAND];
+  int numOfCards = parseCardList(body, cards, CARDS_PER_HAND);
+  int cardNum = NUM_INIT;
+
+  if((numOfCards == INVALID_INT) || (numOfCards < 1))
+  {
+    return FALSE;
+  }
+  for(cardNum = NUM_INIT; cardNum < numOfCards; cardNum ++)
+  {
+    if((term->cards >> cards[cardNum]) & 1)
+    {
+      return FALSE;
+    }
+    term->cards |= 1ULL << cards[cardNum];
+  }
+  return TRUE;
+}
+
+/*
+  Function to read one term, trimming it in place.
+
+  Input   = {char *: text, rangeTerm *: term}
+  Output  = {bool: success}
+*/
+static bool parseRangeTerm(char * text, rangeTerm * term)
+{
+  char * weight = strchr(text, '@');
+  char * end = NULL;
+  size_t length = 0;
+
+  memset(term, 0, sizeof(rangeTerm));
+  term->high = MAX_RANGE_STRENGTH;
+  term->weight = 1.0f;
+  if(weight != NULL)
+  {
+    * weight ++ = '\0';
+    term->weight = (float)strtod(weight, & end);
+    while((end != weight) && isspace((unsigned char)* end))
+    {
+      end ++;
+    }
+    if((end == weight) || (* end != '\0') || !(term->weight >= 0.0f) ||
+      (term->weight > 1.0f))
+    {
+      return FALSE;
+    }
+  }
+  while(isspace((unsigned char)* text))
+  {
+    text ++;
+  }
+  if(* text == '!')
+  {
+    term->exclude = TRUE;
+    text ++;
+    while(isspace((unsigned char)* text))
+    {
+      text ++;
+    }
+  }
+  length = strlen(text);
+  while((length > 0) && isspace((unsigned char)text[length - 1]))
+  {
+    text[-- length] = '\0';
+  }
+  if(length == 0)
+  {
+    return FALSE;
+  }
+  return (parseCategoryTerm(text, term) == TRUE) ||
+    (parseGroupTerm(text, term) == TRUE) ||
+    (parseCardTerm(text, term) == TRUE);
+}
+
+/*
+  Function to split an expression into terms.
+
+  Input   = {char *: text, rangeTerm *: terms}
+  Output  = {int: numOfTerms}, INVALID_INT when a term cannot be read
+*/
+static int parseRangeTerms(const char * text, rangeTerm terms[MAX_RANGE_TERMS])
+{
+  char * copy = malloc(strlen(text) + 1);
+  char * start = copy;
+  char * comma = NULL;
+  int numOfTerms = NUM_INIT;
+
+  if(copy == NULL)
+  {
+    return INVALID_INT;
+  }
+  strcpy(copy, text);
+  while(start != NULL)
+  {
+    comma = strchr(start, ',');
+    if(comma != NULL)
+    {
+      * comma = '\0';
+    }
+    if((numOfTerms == MAX_RANGE_TERMS) ||
+      (parseRangeTerm(start, & terms[numOfTerms]) == FALSE))
+    {
+      numOfTerms = INVALID_INT;
+      break;
+    }
+    numOfTerms ++;
+    start = (comma == NULL) ? NULL : comma + 1;
+  }
+  free(copy);
+  return numOfTerms;
+}
+
+/*
+  Function to compile a range expression, matching every hand in colex
+  order against the terms.
+
+  Input   = {handRange *: range, char *: text}
+  Output  = {bool: success}
+*/
+bool compileHandRange(handRange * range, const char * text)
+{
+  rangeTerm terms[MAX_RANGE_TERMS];
+  unsigned char cards[CARDS_PER_HAND];
+  const rangeTerm * term = NULL;
+  handStrength strength = 0;
+  handIndex index = 0;
+  uint64_t mask = 0;
+  float weight = 0.0f;
+  int numOfTerms = parseRangeTerms(text, terms);
+  int termNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  memset(range->bits, 0, sizeof(uint64_t) * RANGE_WORDS);
+  memset(range->weights, 0, sizeof(float) * NUM_OF_FIVE_CARD_HANDS);
+  range->numOfHands = 0;
+  range->totalWeight = 0.0;
+  if(numOfTerms == INVALID_INT)
+  {
+    return FALSE;
+  }
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    cards[cardNum] = cardNum;
+  }
+  do
+  {
+    strength = evaluateCardIndices(cards, CARDS_PER_HAND);
+    mask = 0;
+    for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+    {
+      mask |= 1ULL << cards[cardNum];
+    }
+    weight = 0.0f;
+    for(termNum = NUM_INIT; termNum < numOfTerms; termNum ++)
+    {
+      term = & terms[termNum];
+      if((strength >= term->low) && (strength <= term->high) &&
+        ((mask & term->cards) == term->cards))
+      {
+        weight = (term->exclude == TRUE) ? 0.0f : term->weight;
+      }
+    }
+    if(weight > 0.0f)
+    {
+      range->bits[index >> 6] |= 1ULL << (index & 63);
+      range->weights[index] = weight;
+      range->numOfHands ++;
+      range->totalWeight += weight;
+    }
+    index ++;
+  } while(nextCombination(cards, CARDS_PER_HAND, STD_DECK_SIZE) == TRUE);
+  return TRUE;
+}
+
+/*
+  Function to free the entries of a range.
+
+  Input   = {rangeEntries *: entries}
+  Output  = {void: NULL}
+*/
+static void freeRangeEntries(rangeEntries * entries)
+{
+  free(entries->indices);
+  free(entries->masks);
+  free(entries->strengths);
+  free(entries->weights);
+  memset(entries, 0, sizeof(rangeEntries));
+}
+
+/*
+  Function to lay out the hands of a range for the engines.
+
+  Input   = {handRange *: range, rangeEntries *: entries}
+  Output  = {bool: success}
+*/
+static bool gatherRangeEntries(const handRange * range,
+  rangeEntries * entries)
+{
+  const size_t numOfHands = range->numOfHands + 1;
+  unsigned char cards[CARDS_PER_HAND];
+  uint64_t word = 0;
+  handIndex index = 0;
+  uint32_t wordNum = 0;
+  uint32_t entryNum = 0;
+  int cardNum = NUM_INIT;
+
+  memset(entries, 0, sizeof(rangeEntries));
+  entries->indices = malloc(sizeof(handIndex) * numOfHands);
+  entries->masks = malloc(sizeof(uint64_t) * numOfHands);
+  entries->strengths = malloc(sizeof(handStrength) * numOfHands);
+  entries->weights = malloc(sizeof(float) * numOfHands);
+  if((entries->indices == NULL) || (entries->masks == NULL) ||
+    (entries->strengths == NULL) || (entries->weights == NULL))
+  {
+    freeRangeEntries(entries);
+    return FALSE;
+  }
+  for(wordNum = 0; wordNum < RANGE_WORDS; wordNum ++)
+  {
+    for(word = range->bits[wordNum]; word != 0; word &= word - 1)
+    {
+      index = wordNum * 64 + __builtin_ctzll(word);
+      unrankHandIndices(index, cards);
+      entries->indices[entryNum] = index;
+      entries->masks[entryNum] = 0;
+      for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        entries->masks[entryNum] |= 1ULL << cards[cardNum];
+      }
+      entries->strengths[entryNum] = evaluateCardIndices(cards,
+        CARDS_PER_HAND);
+      entries->weights[entryNum] = range->weights[index];
+      entryNum ++;
+    }
+  }
+  entries->numOfHands = entryNum;
+  return TRUE;
+}
+
+/*
+  Function to compare one block of the first range with the whole second
+  range, a tile at a time so the tile stays in cache across the block.
+
+  Input   = {pairsContext *: context, int: blockNum}
+  Output  = {void: NULL}
+*/
+static void compareRangeBlock(pairsContext * context, int blockNum)
+{
+  const rangeEntries * first = context->first;
+  const rangeEntries * second = context->second;
+  const uint32_t start = (uint32_t)blockNum * RANGE_BLOCK_HANDS;
+  const uint32_t end = (start + RANGE_BLOCK_HANDS < first->numOfHands) ?
+    start + RANGE_BLOCK_HANDS : first->numOfHands;
+  double wins[RANGE_BLOCK_HANDS];
+  double ties[RANGE_BLOCK_HANDS];
+  double totals[RANGE_BLOCK_HANDS];
+  double win = 0.0;
+  double tie = 0.0;
+  double total = 0.0;
+  double weight = 0.0;
+  uint64_t mask = 0;
+  uint64_t pairs = 0;
+  handStrength strength = 0;
+  uint32_t tileStart = 0;
+  uint32_t tileEnd = 0;
+  uint32_t handNum = 0;
+  uint32_t otherNum = 0;
+
+  memset(wins, 0, sizeof(wins));
+  memset(ties, 0, sizeof(ties));
+  memset(totals, 0, sizeof(totals));
+  for(tileStart = 0; tileStart < second->numOfHands; tileStart = tileEnd)
+  {
+    tileEnd = (tileStart + RANGE_TILE_HANDS < second->numOfHands) ?
+      tileStart + RANGE_TILE_HANDS : second->numOfHands;
+    for(handNum = start; handNum < end; handNum ++)
+    {
+      mask = first->masks[handNum];
+      strength = first->strengths[handNum];
+      win = 0.0;
+      tie = 0.0;
+      total = 0.0;
+      for(otherNum = tileStart; otherNum < tileEnd; otherNum ++)
+      {
+        weight = ((second->masks[otherNum] & mask) == 0) ?
+          second->weights[otherNum] : 0.0;
+        pairs += ((second->masks[otherNum] & mask) == 0);
+        win += (second->strengths[otherNum] < strength) ? weight : 0.0;
+        tie += (second->strengths[otherNum] == strength) ? weight : 0.0;
+        total += weight;
+      }
+      wins[handNum - start] += win;
+      ties[handNum - start] += tie;
+      totals[handNum - start] += total;
+    }
+  }
+  win = 0.0;
+  tie = 0.0;
+  total = 0.0;
+  for(handNum = start; handNum < end; handNum ++)
+  {
+    win += first->weights[handNum] * wins[handNum - start];
+    tie += first->weights[handNum] * ties[handNum - start];
+    total += first->weights[handNum] * totals[handNum - start];
+  }
+  context->sums[blockNum][0] = win;
+  context->sums[blockNum][1] = tie;
+  context->sums[blockNum][2] = total;
+  context->pairs[blockNum] = pairs;
+}
+
+/*
+  Function run by every thread of the pairs engine: take blocks until none
+  are left.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void pairsWorker(void * contextPTR, int threadNum)
+{
+  pairsContext * context = (pairsContext *)contextPTR;
+  int blockNum = NUM_INIT;
+
+  (void)threadNum;
+  for(;;)
+  {
+    blockNum = atomic_fetch_add_explicit(& context->nextBlock, 1,
+      memory_order_relaxed);
+    if(blockNum >= context->numOfBlocks)
+    {
+      break;
+    }
+    compareRangeBlock(context, blockNum);
+  }
+}
+
+/*
+  Function to compute equity with the pairs engine, the block sums added
+  in block order.
+
+  Input   = {rangeEntries *: first, rangeEntries *: second,
+            int: numOfThreads, rangeEquity *: equity}
+  Output  = {bool: success}
+*/
+static bool pairsEquity(const rangeEntries * first,
+  const rangeEntries * second, int numOfThreads, rangeEquity * equity)
+{
+  pairsContext context;
+  double total = 0.0;
+  int blockNum = NUM_INIT;
+
+  context.first = first;
+  context.second = second;
+  context.numOfBlocks = (first->numOfHands + RANGE_BLOCK_HANDS - 1) /
+    RANGE_BLOCK_HANDS;
+  atomic_init(& context.nextBlock, 0);
+  context.sums = malloc(sizeof(double [3]) * (context.numOfBlocks + 1));
+  context.pairs = malloc(sizeof(uint64_t) * (context.numOfBlocks + 1));
+  if((context.sums == NULL) || (context.pairs == NULL))
+  {
+    free(context.sums);
+    free(context.pairs);
+    return FALSE;
+  }
+  runParallel(numOfThreads, pairsWorker, & context);
+  for(blockNum = NUM_INIT; blockNum < context.numOfBlocks; blockNum ++)
+  {
+    equity->win += context.sums[blockNum][0];
+    equity->tie += context.sums[blockNum][1];
+    total += context.sums[blockNum][2];
+    equity->numOfPairs += context.pairs[blockNum];
+  }
+  equity->loss = total - equity->win - equity->tie;
+  free(context.sums);
+  free(context.pairs);
+  return TRUE;
+}
+
+/*
+  Function to find the colex index of every subset of a hand's cards,
+  subset mask m holding the cards of the set bits.
+
+  Input   = {handIndex: index, uint32_t *: subsets}
+  Output  = {void: NULL}
+*/
+static void rangeSubsets(handIndex index, uint32_t subsets[NUM_OF_SUBSET_MASKS])
+{
+  unsigned char cards[CARDS_PER_HAND];
+  unsigned char members[CARDS_PER_HAND];
+  int mask = NUM_INIT;
+  int size = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  unrankHandIndices(index, cards);
+  for(mask = 1; mask < NUM_OF_SUBSET_MASKS - 1; mask ++)
+  {
+    size = NUM_INIT;
+    for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+    {
+      if((mask >> cardNum) & 1)
+      {
+        members[size ++] = cards[cardNum];
+      }
+    }
+    subsets[mask] = (uint32_t)rankCombination(members, size);
+  }
+  subsets[NUM_OF_SUBSET_MASKS - 1] = index;
+}
+
+/*
+  Function to find the weight and number of the swept hands sharing no card
+  with a hand: all of them, less those holding each of its cards, plus
+  those holding each pair and so on, less the hand itself when swept.
+
+  Input   = {rangeSweep *: sweep, uint32_t *: subsets, double *: weight}
+  Output  = {uint64_t: numOfHands}
+*/
+static uint64_t sweepDisjoint(const rangeSweep * sweep,
+  const uint32_t subsets[NUM_OF_SUBSET_MASKS], double * weight)
+{
+  const handIndex self = subsets[NUM_OF_SUBSET_MASKS - 1];
+  int64_t disjoint = (int64_t)sweep->numOfHands;
+  int mask = NUM_INIT;
+  int size = NUM_INIT;
+  int sign = NUM_INIT;
+
+  * weight = sweep->totalWeight;
+  for(mask = 1; mask < NUM_OF_SUBSET_MASKS - 1; mask ++)
+  {
+    size = __builtin_popcount(mask);
+    sign = (size % 2 == 1) ? -1 : 1;
+    * weight += sign * sweep->weights[size][subsets[mask]];
+    disjoint += sign * (int64_t)sweep->counts[size][subsets[mask]];
+  }
+  if((sweep->swept[self >> 6] >> (self & 63)) & 1)
+  {
+    * weight -= sweep->self[self];
+    disjoint --;
+  }
+  return (uint64_t)disjoint;
+}
+
+/*
+  Function to add a hand of the second range to the sweep.
+
+  Input   = {rangeSweep *: sweep, uint64_t *: swept, handIndex: index}
+  Output  = {void: NULL}
+*/
+static void sweepRangeHand(rangeSweep * sweep, uint64_t * swept,
+  handIndex index)
+{
+  uint32_t subsets[NUM_OF_SUBSET_MASKS];
+  const double weight = sweep->self[index];
+  int mask = NUM_INIT;
+
+  rangeSubsets(index, subsets);
+  sweep->totalWeight += weight;
+  sweep->numOfHands ++;
+  for(mask = 1; mask < NUM_OF_SUBSET_MASKS - 1; mask ++)
+  {
+    sweep->weights[__builtin_popcount(mask)][subsets[mask]] += weight;
+    sweep->counts[__builtin_popcount(mask)][subsets[mask]] ++;
+  }
+  swept[index >> 6] |= 1ULL << (index & 63);
+}
+
+/* Order sort keys, strength above entry number */
+static int compareRangeKeys(const void * first, const void * second)
+{
+  const uint64_t a = * (const uint64_t *)first;
+  const uint64_t b = * (const uint64_t *)second;
+  return (a > b) - (a < b);
+}
+
+/*
+  Function to sort the entries of a range by strength into keys.
+
+  Input   = {rangeEntries *: entries}
+  Output  = {uint64_t *: keys}, NULL when out of memory
+*/
+static uint64_t * sortRangeEntries(const rangeEntries * entries)
+{
+  uint64_t * keys = malloc(sizeof(uint64_t) * (entries->numOfHands + 1));
+  uint32_t entryNum = 0;
+
+  if(keys == NULL)
+  {
+    return NULL;
+  }
+  for(entryNum = 0; entryNum < entries->numOfHands; entryNum ++)
+  {
+    keys[entryNum] = ((uint64_t)entries->strengths[entryNum] <<
+      HAND_INDEX_BITS) | entryNum;
+  }
+  qsort(keys, entries->numOfHands, sizeof(uint64_t), compareRangeKeys);
+  return keys;
+}
+
+/*
+  Function to compute equity with the sweep engine. The first range's hands
+  are taken a group of equal strengths at a time: the second range's weaker
+  hands are swept before the group is measured, its equal ones after, and
+  what is left after the last group.
+
+  Input   = {handRange *: secondRange, rangeEntries *: first,
+            rangeEntries *: second, rangeEquity *: equity}
+  Output  = {bool: success}
+*/
+static bool sweepEquity(const handRange * secondRange,
+  const rangeEntries * first, const rangeEntries * second,
+  rangeEquity * equity)
+{
+  uint64_t * firstKeys = sortRangeEntries(first);
+  uint64_t * secondKeys = sortRangeEntries(second);
+  uint64_t * swept = calloc(RANGE_WORDS, sizeof(uint64_t));
+  double * weaker = malloc(sizeof(double) * (first->numOfHands + 1));
+  double * upTo = malloc(sizeof(double) * (first->numOfHands + 1));
+  uint32_t subsets[NUM_OF_SUBSET_MASKS];
+  rangeSweep sweep;
+  handStrength strength = 0;
+  double weight = 0.0;
+  double total = 0.0;
+  uint32_t groupStart = 0;
+  uint32_t groupEnd = 0;
+  uint32_t otherNum = 0;
+  uint32_t handNum = 0;
+  uint32_t entryNum = 0;
+  bool success = (firstKeys != NULL) && (secondKeys != NULL) &&
+    (swept != NULL) && (weaker != NULL) && (upTo != NULL);
+  int size = NUM_INIT;
+
+  memset(& sweep, 0, sizeof(sweep));
+  sweep.self = secondRange->weights;
+  sweep.swept = swept;
+  for(size = 1; size < CARDS_PER_HAND; size ++)
+  {
+    sweep.weights[size] = calloc(choose(STD_DECK_SIZE, size), sizeof(double));
+    sweep.counts[size] = calloc(choose(STD_DECK_SIZE, size),
+      sizeof(uint32_t));
+    success = success && (sweep.weights[size] != NULL) &&
+      (sweep.counts[size] != NULL);
+  }
+
+  for(groupStart = 0; (success == TRUE) && (groupStart < first->numOfHands);
+    groupStart = groupEnd)
+  {
+    strength = (handStrength)(firstKeys[groupStart] >> HAND_INDEX_BITS);
+    groupEnd = groupStart;
+    while((groupEnd < first->numOfHands) &&
+      ((firstKeys[groupEnd] >> HAND_INDEX_BITS) == strength))
+    {
+      groupEnd ++;
+    }
+    for(; (otherNum < second->numOfHands) &&
+      ((secondKeys[otherNum] >> HAND_INDEX_BITS) < strength); otherNum ++)
+    {
+      sweepRangeHand(& sweep, swept, second->indices[secondKeys[otherNum] &
+        SORT_ENTRY_MASK]);
+    }
+    for(handNum = groupStart; handNum < groupEnd; handNum ++)
+    {
+      entryNum = firstKeys[handNum] & SORT_ENTRY_MASK;
+      rangeSubsets(first->indices[entryNum], subsets);
+      sweepDisjoint(& sweep, subsets, & weaker[entryNum]);
+    }
+    for(; (otherNum < second->numOfHands) &&
+      ((secondKeys[otherNum] >> HAND_INDEX_BITS) == strength); otherNum ++)
+    {
+      sweepRangeHand(& sweep, swept, second->indices[secondKeys[otherNum] &
+        SORT_ENTRY_MASK]);
+    }
+    for(handNum = groupStart; handNum < groupEnd; handNum ++)
+    {
+      entryNum = firstKeys[handNum] & SORT_ENTRY_MASK;
+      rangeSubsets(first->indices[entryNum], subsets);
+      sweepDisjoint(& sweep, subsets, & upTo[entryNum]);
+    }
+  }
+  for(; (success == TRUE) && (otherNum < second->numOfHands); otherNum ++)
+  {
+    sweepRangeHand(& sweep, swept, second->indices[secondKeys[otherNum] &
+      SORT_ENTRY_MASK]);
+  }
+  for(entryNum = 0; (success == TRUE) && (entryNum < first->numOfHands);
+    entryNum ++)
+  {
+    rangeSubsets(first->indices[entryNum], subsets);
+    equity->numOfPairs += sweepDisjoint(& sweep, subsets, & weight);
+    equity->win += first->weights[entryNum] * weaker[entryNum];
+    equity->tie += first->weights[entryNum] * (upTo[entryNum] -
+      weaker[entryNum]);
+    total += first->weights[entryNum] * weight;
+  }
+  equity->loss = total - equity->win - equity->tie;
+
+  for(size = 1; size < CARDS_PER_HAND; size ++)
+  {
+    free(sweep.weights[size]);
+    free(sweep.counts[size]);
+  }
+  free(firstKeys);
+  free(secondKeys);
+  free(swept);
+  free(weaker);
+  free(upTo);
+  return success;
+}
+
+/*
+  Function to compute the showdown equity of one range against another.
+
+  Input   = {handRange *: first, handRange *: second, int: numOfThreads,
+            int: engine, rangeEquity *: equity}
+  Output  = {bool: success}
+*/
+bool computeRangeEquity(const handRange * first, const handRange * second,
+  int numOfThreads, int engine, rangeEquity * equity)
+{
+  rangeEntries firstEntries;
+  rangeEntries secondEntries;
+  bool success = FALSE;
+
+  memset(equity, 0, sizeof(rangeEquity));
+  if(engine == RANGE_ENGINE_AUTO)
+  {
+    engine = ((uint64_t)first->numOfHands * second->numOfHands >
+      RANGE_PAIRS_PER_THREAD * (numOfThreads < 1 ? 1 : numOfThreads)) ?
+      RANGE_ENGINE_SWEEP : RANGE_ENGINE_PAIRS;
+  }
+  equity->engine = engine;
+  if(gatherRangeEntries(first, & firstEntries) == FALSE)
+  {
+    return FALSE;
+  }
+  if(gatherRangeEntries(second, & secondEntries) == FALSE)
+  {
+    freeRangeEntries(& firstEntries);
+    return FALSE;
+  }
+  if(engine == RANGE_ENGINE_SWEEP)
+  {
+    success = sweepEquity(second, & firstEntries, & secondEntries, equity);
+  }
+  else
+  {
+    success = pairsEquity(& firstEntries, & secondEntries, numOfThreads,
+      equity);
+  }
+  freeRangeEntries(& firstEntries);
+  freeRangeEntries(& secondEntries);
+  return success;
+}
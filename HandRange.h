@@ -0,0 +1,128 @@
+#ifndef HandRange_h
+#define HandRange_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Colex hand indices */
+#include "HandIndex.h"
+
+/*
+  stdint.h is included for the bitset words and pair counts.
+*/
+#include <stdint.h>
+
+/* Words of a bitset over every colex hand index */
+#define RANGE_WORDS ((NUM_OF_FIVE_CARD_HANDS + 63) / 64)
+/* Terms a range expression may hold */
+#define MAX_RANGE_TERMS 32
+/* Pairs of hands a thread compares one by one before the sweep is used */
+#define RANGE_PAIRS_PER_THREAD (1ULL << 28)
+
+/* Engines of computeRangeEquity */
+#define RANGE_ENGINE_AUTO 0
+#define RANGE_ENGINE_PAIRS 1
+#define RANGE_ENGINE_SWEEP 2
+
+/* Whether a range holds the hand of a colex index */
+#define rangeHolds(range, index) \
+  (((range)->bits[(index) >> 6] >> ((index) & 63)) & 1)
+
+/*
+  Hand range structure
+
+  A weighted set of five card hands, dense over the colex hand index space:
+  bit i of bits is set when the range holds hand i, whose weight, above
+  zero and at most one, is weights[i]. Weights of hands left out are zero.
+
+    bits        - RANGE_WORDS words of membership bits
+    weights     - weight of every hand
+    numOfHands  - hands held
+    totalWeight - sum of the weights
+*/
+typedef struct handRange
+{
+  uint64_t * bits;
+  float * weights;
+  uint32_t numOfHands;
+  double totalWeight;
+} handRange;
+
+/*
+  Range equity structure, the weight of the pairs of hands sharing no card
+  that the first range wins, ties and loses, each pair weighing the product
+  of its hands' weights.
+
+    win        - weight of the pairs the first range's hand wins
+    tie        - weight of the pairs tied
+    loss       - weight of the pairs lost
+    numOfPairs - pairs sharing no card, whatever their weights
+    engine     - RANGE_ENGINE_PAIRS or RANGE_ENGINE_SWEEP, the engine used
+*/
+typedef struct rangeEquity
+{
+  double win;
+  double tie;
+  double loss;
+  uint64_t numOfPairs;
+  int engine;
+} rangeEquity;
+
+/*
+  Function to create an empty range.
+
+  Input   = {handRange *: range}
+  Output  = {bool: success}, FALSE when out of memory
+*/
+bool createHandRange(handRange *);
+
+/*
+  Function to free the memory of a range.
+
+  Input   = {handRange *: range}
+  Output  = {void: NULL}
+*/
+void freeHandRange(handRange *);
+
+/*
+  Function to compile a range expression into a range. An expression is a
+  list of terms separated by commas, applied from left to right, each
+  setting the weight of the hands it matches, or removing them when it
+  starts with '!'. A term ends with an optional "@weight" from 0 to 1, one
+  by default, and is, in either case:
+
+    any                    - every hand
+    pair, two-pair, trips, straight, flush, full-house, quads,
+    straight-flush, high-card
+                           - hands of the category, or of it or better
+                             with a trailing '+'
+    TT, TTT, TTTT          - a pair, trips or quads of a rank, "TT+" any
+                             hand at least as strong as a pair of tens and
+                             "TT-KK" pairs of tens to kings
+    AS KS, AHKHQHJHTH      - one to five cards, the hands holding them all
+
+  Input   = {handRange *: range, char *: text}
+  Output  = {bool: success}, FALSE when the expression cannot be read, the
+            range then being empty
+*/
+bool compileHandRange(handRange *, const char *);
+
+/*
+  Function to compute the showdown equity of one range against another
+  exactly, over every pair of hands sharing no card. The pairs engine
+  compares the pairs block by block, the threads splitting the first
+  range's blocks and each block of it meeting the second range a cache
+  sized tile at a time. The sweep engine takes both ranges in order of
+  strength once, counting by inclusion and exclusion the weight of the
+  second range's weaker hands that share no card with each hand of the
+  first. RANGE_ENGINE_AUTO picks the pairs engine unless there are more
+  than RANGE_PAIRS_PER_THREAD pairs for every thread. Sums are taken in
+  the same order whatever the threads.
+
+  Input   = {handRange *: first, handRange *: second, int: numOfThreads,
+            int: engine, rangeEquity *: equity}
+  Output  = {bool: success}, FALSE when out of memory
+*/
+bool computeRangeEquity(const handRange *, const handRange *, int, int,
+  rangeEquity *);
+
+#endif /* HandRange_h */
@@ -0,0 +1,668 @@
+#include "PlayStrategy.h"
+/* Worker threads */
+#include "PokerThreads.h"
+
+/* stdatomic.h is included for the batch counter. */
+#include <stdatomic.h>
+/* string.h is included for memset, memcpy and strcmp. */
+#include <string.h>
+
+/* Fewest players a hand can be played with */
+#define PLAY_MIN_PLAYERS 2
+/* The aggressive strategy bluffs one decision in this many */
+#define AGGRESSIVE_BLUFF_ODDS 8
+/* The aggressive strategy calls when the pot is this many times the call */
+#define AGGRESSIVE_POT_ODDS 3
+
+/* Size of a bet or raise on a street, the big bet on the last street */
+#define playBetSize(street) \
+  (((street) == PLAY_STREETS - 1) ? PLAY_BIG_BET : PLAY_SMALL_BET)
+
+/*
+  State of one hand of a batch.
+
+    cards        - the cards of every seat, CARDS_PER_HAND each, the first
+                   face down
+    strength     - strength of every seat's cards so far
+    showing      - strength of every seat's face up cards
+    putIn        - chips every seat has put in, ante included
+    streetBet    - chips every seat has put in on the street
+    currentBet   - chips every seat has to have put in on the street
+    pot          - chips in the pot
+    history      - actions of the hand, as in decisionBatch
+    numOfActions - actions of the hand so far
+    folded       - bit s set when seat s has folded
+    street       - street being bet
+    actor        - seat to act
+    pending      - players still to act before the street ends
+    numOfBets    - bets and raises made on the street
+    numOfActive  - players who have not folded
+    finished     - whether the pot has been paid
+*/
+typedef struct playTable
+{
+  unsigned char cards[MAX_PLAYERS * CARDS_PER_HAND];
+  handStrength strength[MAX_PLAYERS];
+  handStrength showing[MAX_PLAYERS];
+  int32_t putIn[MAX_PLAYERS];
+  int32_t streetBet[MAX_PLAYERS];
+  int32_t currentBet;
+  int32_t pot;
+  uint64_t history;
+  uint32_t numOfActions;
+  unsigned short folded;
+  unsigned char street;
+  unsigned char actor;
+  unsigned char pending;
+  unsigned char numOfBets;
+  unsigned char numOfActive;
+  bool finished;
+} playTable;
+
+/*
+  Results and arena of one thread. The scratch the thread plays its
+  batches in comes from its arena, which the thread creates itself so the
+  pages are on its node. The padding keeps the workers' results apart.
+*/
+typedef struct playWorker
+{
+  playResults results;
+  pokerArena arena;
+  bool created;
+  char padding[CACHE_LINE_SIZE];
+} playWorker;
+
+/* State shared by the play threads */
+typedef struct playContext
+{
+  const playConfig * config;
+  uint64_t numOfBatches;
+  atomic_ullong nextBatch;
+  playWorker * workers;
+} playContext;
+
+/*
+  Scratch of one play thread.
+
+    tables     - hands of the batch
+    queues     - hands waiting on every seat, PLAY_BATCH_TABLES a seat
+    batch      - decisions handed to a strategy
+    decisionOf - hand of every decision of the batch
+    actions    - actions the strategy chose
+*/
+typedef struct playScratch
+{
+  playTable * tables;
+  int * queues;
+  decisionBatch * batch;
+  int * decisionOf;
+  unsigned char * actions;
+} playScratch;
+
+/*
+  Function to check and call every decision.
+
+  Input   = {decisionBatch *: batch, unsigned char *: actions,
+            pokerRng *: rng, void *: state}
+  Output  = {void: NULL}
+*/
+static void passiveStrategy(const decisionBatch * batch,
+  unsigned char * actions, pokerRng * rng, const void * state)
+{
+  int decisionNum = NUM_INIT;
+  (void)rng;
+  (void)state;
+  for(decisionNum = NUM_INIT; decisionNum < batch->numOfDecisions;
+    decisionNum ++)
+  {
+    actions[decisionNum] = PLAY_CALL;
+  }
+}
+
+/*
+  Function to bet a pair or better that beats every board, call with any
+  other pair and fold the rest. The action is counted up from the
+  comparisons, so the loop has no branches.
+
+  Input   = {decisionBatch *: batch, unsigned char *: actions,
+            pokerRng *: rng, void *: state}
+  Output  = {void: NULL}
+*/
+static void tightStrategy(const decisionBatch * batch,
+  unsigned char * actions, pokerRng * rng, const void * state)
+{
+  int decisionNum = NUM_INIT;
+  int paired = NUM_INIT;
+  (void)rng;
+  (void)state;
+  for(decisionNum = NUM_INIT; decisionNum < batch->numOfDecisions;
+    decisionNum ++)
+  {
+    paired = (strengthCategory(batch->strength[decisionNum]) >= Pair);
+    actions[decisionNum] = (unsigned char)(paired + (paired &
+      (batch->strength[decisionNum] > batch->bestShowing[decisionNum])));
+  }
+}
+
+/*
+  Function to bet whenever the cards beat every board or a bluff is drawn,
+  call when the pot pays AGGRESSIVE_POT_ODDS to one and fold otherwise.
+
+  Input   = {decisionBatch *: batch, unsigned char *: actions,
+            pokerRng *: rng, void *: state}
+  Output  = {void: NULL}
+*/
+static void aggressiveStrategy(const decisionBatch * batch,
+  unsigned char * actions, pokerRng * rng, const void * state)
+{
+  int decisionNum = NUM_INIT;
+  bool bluff = FALSE;
+  (void)state;
+  for(decisionNum = NUM_INIT; decisionNum < batch->numOfDecisions;
+    decisionNum ++)
+  {
+    bluff = (randomBounded(rng, AGGRESSIVE_BLUFF_ODDS) == 0) ? TRUE : FALSE;
+    if((bluff == TRUE) ||
+      (batch->strength[decisionNum] > batch->bestShowing[decisionNum]))
+    {
+      actions[decisionNum] = PLAY_RAISE;
+    }
+    else if(batch->toCall[decisionNum] * AGGRESSIVE_POT_ODDS <=
+      batch->pot[decisionNum])
+    {
+      actions[decisionNum] = PLAY_CALL;
+    }
+    else
+    {
+      actions[decisionNum] = PLAY_FOLD;
+    }
+  }
+}
+
+/*
+  Function to pick every action at random.
+
+  Input   = {decisionBatch *: batch, unsigned char *: actions,
+            pokerRng *: rng, void *: state}
+  Output  = {void: NULL}
+*/
+static void randomStrategy(const decisionBatch * batch,
+  unsigned char * actions, pokerRng * rng, const void * state)
+{
+  int decisionNum = NUM_INIT;
+  (void)state;
+  for(decisionNum = NUM_INIT; decisionNum < batch->numOfDecisions;
+    decisionNum ++)
+  {
+    actions[decisionNum] = (unsigned char)randomBounded(rng, PLAY_ACTIONS);
+  }
+}
+
+/* The built in strategies, looked up by name */
+static const playStrategy builtInStrategies[] =
+{
+  {"passive", passiveStrategy, NULL},
+  {"tight", tightStrategy, NULL},
+  {"aggressive", aggressiveStrategy, NULL},
+  {"random", randomStrategy, NULL}
+};
+
+/*
+  Function to find a built in strategy by name.
+
+  Input   = {char *: name, playStrategy *: strategy}
+  Output  = {bool: found}
+*/
+bool findPlayStrategy(const char * name, playStrategy * strategy)
+{
+  int strategyNum = NUM_INIT;
+  for(strategyNum = NUM_INIT; strategyNum < (int)(sizeof(builtInStrategies) /
+    sizeof(builtInStrategies[0])); strategyNum ++)
+  {
+    if(strcmp(name, builtInStrategies[strategyNum].name) == 0)
+    {
+      * strategy = builtInStrategies[strategyNum];
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/*
+  Function to start a street: the cards of the seats still in are
+  evaluated once for every decision of the street, and the seat showing the
+  best cards acts first, the lowest seat on a tie.
+
+  Input   = {playTable *: table, int: street, int: numOfPlayers}
+  Output  = {void: NULL}
+*/
+static void startStreet(playTable * table, int street, int numOfPlayers)
+{
+  const int numOfCards = PLAY_FIRST_STREET_CARDS + street;
+  int best = INVALID_INT;
+  int seat = NUM_INIT;
+
+  table->street = (unsigned char)street;
+  table->currentBet = 0;
+  table->numOfBets = 0;
+  table->pending = table->numOfActive;
+  for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+  {
+    table->streetBet[seat] = 0;
+    if((table->folded & (1u << seat)) != 0)
+    {
+      continue;
+    }
+    table->strength[seat] = evaluateCardIndices(
+      table->cards + seat * CARDS_PER_HAND, numOfCards);
+    table->showing[seat] = evaluateCardIndices(
+      table->cards + seat * CARDS_PER_HAND + 1, numOfCards - 1);
+    if((best == INVALID_INT) || (table->showing[seat] > table->showing[best]))
+    {
+      best = seat;
+    }
+  }
+  table->actor = (unsigned char)best;
+}
+
+/*
+  Function to pay out a pot and record what every seat won.
+
+  Input   = {playTable *: table, int32_t *: won, int: numOfPlayers,
+            playResults *: results}
+  Output  = {void: NULL}
+*/
+static void settleTable(playTable * table, const int32_t * won,
+  int numOfPlayers, playResults * results)
+{
+  int seat = NUM_INIT;
+  for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+  {
+    results->chipsWon[seat] += won[seat] - table->putIn[seat];
+  }
+  table->finished = TRUE;
+}
+
+/*
+  Function to show down the hands still in. A split pot's odd chips go to
+  the lowest winning seats.
+
+  Input   = {playTable *: table, int: numOfPlayers, playResults *: results}
+  Output  = {void: NULL}
+*/
+static void showDown(playTable * table, int numOfPlayers,
+  playResults * results)
+{
+  handStrength strengths[MAX_PLAYERS];
+  int32_t won[MAX_PLAYERS];
+  unsigned int winners = 0;
+  int numOfWinners = NUM_INIT;
+  int32_t oddChips = 0;
+  int seat = NUM_INIT;
+
+  for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+  {
+    strengths[seat] = ((table->folded & (1u << seat)) != 0) ? 0 :
+      table->strength[seat];
+  }
+  winners = findWinners(strengths, numOfPlayers) & ~table->folded;
+  numOfWinners = __builtin_popcount(winners);
+  oddChips = table->pot % numOfWinners;
+  for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+  {
+    won[seat] = 0;
+    if((winners & (1u << seat)) != 0)
+    {
+      won[seat] = table->pot / numOfWinners + ((oddChips > 0) ? 1 : 0);
+      oddChips -= (oddChips > 0) ? 1 : 0;
+    }
+  }
+  results->showdowns ++;
+  settleTable(table, won, numOfPlayers, results);
+}
+
+/*
+  Function to apply the action of the seat to act and move the hand on to
+  the next seat, the next street or its end.
+
+  Input   = {playTable *: table, int: action, int: numOfPlayers,
+            playResults *: results}
+  Output  = {void: NULL}
+*/
+static void applyAction(playTable * table, int action, int numOfPlayers,
+  playResults * results)
+{
+  const int actor = table->actor;
+  int32_t won[MAX_PLAYERS];
+  int32_t amount = table->currentBet - table->streetBet[actor];
+  int seat = NUM_INIT;
+
+  if(((action == PLAY_FOLD) && (amount == 0)) || (action > PLAY_RAISE) ||
+    ((action == PLAY_RAISE) && (table->numOfBets >= PLAY_MAX_BETS)))
+  {
+    action = PLAY_CALL;
+  }
+  results->actions[action] ++;
+  table->history = (table->history << PLAY_ACTION_BITS) | (uint64_t)action;
+  table->numOfActions ++;
+  if(action == PLAY_FOLD)
+  {
+    table->folded |= (unsigned short)(1u << actor);
+    table->numOfActive --;
+    table->pending --;
+  }
+  else
+  {
+    if(action == PLAY_RAISE)
+    {
+      table->currentBet += playBetSize(table->street);
+      table->numOfBets ++;
+      amount = table->currentBet - table->streetBet[actor];
+      /* Everybody else still in has to answer the raise */
+      table->pending = table->numOfActive;
+    }
+    table->streetBet[actor] += amount;
+    table->putIn[actor] += amount;
+    table->pot += amount;
+    table->pending --;
+  }
+
+  if(table->numOfActive == 1)
+  {
+    for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+    {
+      won[seat] = ((table->folded & (1u << seat)) == 0) ? table->pot : 0;
+    }
+    settleTable(table, won, numOfPlayers, results);
+  }
+  else if(table->pending == 0)
+  {
+    if(table->street == PLAY_STREETS - 1)
+    {
+      showDown(table, numOfPlayers, results);
+    }
+    else
+    {
+      startStreet(table, table->street + 1, numOfPlayers);
+    }
+  }
+  else
+  {
+    seat = actor;
+    do
+    {
+      seat = (seat + 1) % numOfPlayers;
+    } while((table->folded & (1u << seat)) != 0);
+    table->actor = (unsigned char)seat;
+  }
+}
+
+/*
+  Function to add the decision of a hand's seat to act to a batch, copying
+  in only the cards the seat can see.
+
+  Input   = {decisionBatch *: batch, playTable *: table, int: numOfPlayers}
+  Output  = {void: NULL}
+*/
+static void addDecision(decisionBatch * batch, const playTable * table,
+  int numOfPlayers)
+{
+  const int decisionNum = batch->numOfDecisions;
+  const int actor = table->actor;
+  const int numOfCards = PLAY_FIRST_STREET_CARDS + table->street;
+  unsigned char * visible = batch->cards[decisionNum];
+  handStrength bestShowing = 0;
+  int first = NUM_INIT;
+  int seat = NUM_INIT;
+
+  memset(visible, PLAY_HIDDEN_CARD, numOfPlayers * CARDS_PER_HAND);
+  for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+  {
+    /* The hole card of another seat stays hidden */
+    first = (seat == actor) ? 0 : 1;
+    memcpy(visible + seat * CARDS_PER_HAND + first,
+      table->cards + seat * CARDS_PER_HAND + first, numOfCards - first);
+    if((seat != actor) && ((table->folded & (1u << seat)) == 0) &&
+      (table->showing[seat] > bestShowing))
+    {
+      bestShowing = table->showing[seat];
+    }
+  }
+  batch->street[decisionNum] = table->street;
+  batch->numOfBets[decisionNum] = table->numOfBets;
+  batch->numOfActive[decisionNum] = table->numOfActive;
+  batch->folded[decisionNum] = table->folded;
+  batch->strength[decisionNum] = table->strength[actor];
+  batch->bestShowing[decisionNum] = bestShowing;
+  batch->pot[decisionNum] = table->pot;
+  batch->toCall[decisionNum] = table->currentBet - table->streetBet[actor];
+  batch->betSize[decisionNum] = playBetSize(table->street);
+  batch->history[decisionNum] = table->history;
+  batch->numOfActions[decisionNum] = table->numOfActions;
+  batch->numOfDecisions ++;
+}
+
+/*
+  Function to play the hands of one batch. Every hand waits in the queue
+  of the seat to act. The seats take turns, each seat's strategy deciding
+  its whole queue in one call, and every hand not finished joins the queue
+  of its next seat, so no seat looks at hands waiting on another.
+
+  Input   = {playContext *: context, playScratch *: scratch,
+            playResults *: results, uint64_t: batchNum}
+  Output  = {void: NULL}
+*/
+static void playBatch(const playContext * context, playScratch * scratch,
+  playResults * results, uint64_t batchNum)
+{
+  const playConfig * config = context->config;
+  const int numOfPlayers = config->numOfPlayers;
+  decisionBatch * batch = scratch->batch;
+  unsigned char deck[STD_DECK_SIZE];
+  pokerRng dealRng;
+  pokerRng decideRng;
+  playTable * table = NULL;
+  uint64_t numOfTables = PLAY_BATCH_TABLES;
+  int queueSizes[MAX_PLAYERS];
+  int * queue = NULL;
+  int numOfLive = NUM_INIT;
+  int tableNum = NUM_INIT;
+  int decisionNum = NUM_INIT;
+  int seat = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  if(batchNum == context->numOfBatches - 1)
+  {
+    numOfTables = config->numOfHands - batchNum * PLAY_BATCH_TABLES;
+  }
+  seedRng(& dealRng, config->seed, batchNum);
+  seedRng(& decideRng, mixSeed(config->seed), batchNum);
+  for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    deck[cardNum] = cardNum;
+  }
+  for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+  {
+    queueSizes[seat] = 0;
+  }
+  for(tableNum = NUM_INIT; tableNum < (int)numOfTables; tableNum ++)
+  {
+    /* Dealt as the simulation deals, the rest of the deck carrying over */
+    table = & scratch->tables[tableNum];
+    shuffleCardIndices(& dealRng, deck, STD_DECK_SIZE,
+      numOfPlayers * CARDS_PER_HAND);
+    memcpy(table->cards, deck, numOfPlayers * CARDS_PER_HAND);
+    for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+    {
+      table->putIn[seat] = PLAY_ANTE;
+    }
+    table->pot = numOfPlayers * PLAY_ANTE;
+    table->history = 0;
+    table->numOfActions = 0;
+    table->folded = 0;
+    table->numOfActive = (unsigned char)numOfPlayers;
+    table->finished = FALSE;
+    startStreet(table, 0, numOfPlayers);
+    seat = table->actor;
+    scratch->queues[seat * PLAY_BATCH_TABLES + queueSizes[seat] ++] =
+      tableNum;
+  }
+  numOfLive = (int)numOfTables;
+
+  batch->numOfPlayers = numOfPlayers;
+  for(seat = NUM_INIT; numOfLive > 0; seat = (seat + 1) % numOfPlayers)
+  {
+    if(queueSizes[seat] == 0)
+    {
+      continue;
+    }
+    /* The queue is emptied into the batch first, as a hand can come back
+       to the same seat when it opens the next street */
+    queue = scratch->queues + seat * PLAY_BATCH_TABLES;
+    batch->seat = seat;
+    batch->numOfDecisions = 0;
+    for(decisionNum = NUM_INIT; decisionNum < queueSizes[seat];
+      decisionNum ++)
+    {
+      scratch->decisionOf[decisionNum] = queue[decisionNum];
+      addDecision(batch, & scratch->tables[queue[decisionNum]],
+        numOfPlayers);
+    }
+    queueSizes[seat] = 0;
+    config->strategies[seat].decide(batch, scratch->actions, & decideRng,
+      config->strategies[seat].state);
+    results->decisions += batch->numOfDecisions;
+    for(decisionNum = NUM_INIT; decisionNum < batch->numOfDecisions;
+      decisionNum ++)
+    {
+      tableNum = scratch->decisionOf[decisionNum];
+      table = & scratch->tables[tableNum];
+      applyAction(table, scratch->actions[decisionNum], numOfPlayers,
+        results);
+      if(table->finished == TRUE)
+      {
+        numOfLive --;
+      }
+      else
+      {
+        scratch->queues[table->actor * PLAY_BATCH_TABLES +
+          queueSizes[table->actor] ++] = tableNum;
+      }
+    }
+  }
+  results->hands += numOfTables;
+}
+
+/*
+  Function run by every play thread.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void playThread(void * argument, int threadNum)
+{
+  playContext * context = argument;
+  playWorker * worker = & context->workers[threadNum];
+  playScratch scratch;
+  uint64_t batchNum = 0;
+
+  if(createArena(& worker->arena, arenaBytes(sizeof(playTable) *
+    PLAY_BATCH_TABLES, 1) + arenaBytes(sizeof(int) * PLAY_BATCH_TABLES *
+    MAX_PLAYERS, 1) + arenaBytes(sizeof(int) * PLAY_BATCH_TABLES, 1) +
+    arenaBytes(sizeof(decisionBatch), 1) + arenaBytes(PLAY_BATCH_TABLES, 1),
+    context->config->backing) == FALSE)
+  {
+    return;
+  }
+  scratch.tables = arenaAlloc(& worker->arena,
+    sizeof(playTable) * PLAY_BATCH_TABLES);
+  scratch.queues = arenaAlloc(& worker->arena,
+    sizeof(int) * PLAY_BATCH_TABLES * MAX_PLAYERS);
+  scratch.decisionOf = arenaAlloc(& worker->arena,
+    sizeof(int) * PLAY_BATCH_TABLES);
+  scratch.batch = arenaAlloc(& worker->arena, sizeof(decisionBatch));
+  scratch.actions = arenaAlloc(& worker->arena, PLAY_BATCH_TABLES);
+  worker->created = TRUE;
+  batchNum = atomic_fetch_add(& context->nextBatch, 1);
+  while(batchNum < context->numOfBatches)
+  {
+    playBatch(context, & scratch, & worker->results, batchNum);
+    batchNum = atomic_fetch_add(& context->nextBatch, 1);
+  }
+}
+
+/*
+  Function to play hands on several threads.
+
+  Input   = {playConfig *: config, playResults *: results}
+  Output  = {bool: success}
+*/
+bool runPlay(const playConfig * config, playResults * results)
+{
+  playContext context;
+  const playWorker * worker = NULL;
+  int numOfThreads = config->numOfThreads;
+  int threadNum = NUM_INIT;
+  int seat = NUM_INIT;
+  int actionNum = NUM_INIT;
+  bool success = TRUE;
+
+  memset(results, 0, sizeof(playResults));
+  clearMemoryReport(& results->memory);
+  if((config->numOfPlayers < PLAY_MIN_PLAYERS) ||
+    (config->numOfPlayers > MAX_PLAYERS))
+  {
+    return FALSE;
+  }
+  for(seat = NUM_INIT; seat < config->numOfPlayers; seat ++)
+  {
+    if(config->strategies[seat].decide == NULL)
+    {
+      return FALSE;
+    }
+  }
+  if(numOfThreads < 1)
+  {
+    numOfThreads = 1;
+  }
+  if(numOfThreads > MAX_THREADS)
+  {
+    numOfThreads = MAX_THREADS;
+  }
+
+  memset(& context, 0, sizeof(playContext));
+  context.config = config;
+  context.numOfBatches = (config->numOfHands + PLAY_BATCH_TABLES - 1) /
+    PLAY_BATCH_TABLES;
+  atomic_init(& context.nextBatch, 0);
+  context.workers = calloc(numOfThreads, sizeof(playWorker));
+  if(context.workers == NULL)
+  {
+    return FALSE;
+  }
+  runParallel(numOfThreads, playThread, & context);
+  for(threadNum = NUM_INIT; threadNum < numOfThreads; threadNum ++)
+  {
+    worker = & context.workers[threadNum];
+    if(worker->created == FALSE)
+    {
+      success = FALSE;
+      continue;
+    }
+    results->hands += worker->results.hands;
+    results->decisions += worker->results.decisions;
+    results->showdowns += worker->results.showdowns;
+    for(actionNum = NUM_INIT; actionNum < PLAY_ACTIONS; actionNum ++)
+    {
+      results->actions[actionNum] += worker->results.actions[actionNum];
+    }
+    for(seat = NUM_INIT; seat < config->numOfPlayers; seat ++)
+    {
+      results->chipsWon[seat] += worker->results.chipsWon[seat];
+    }
+    addArenaReport(& results->memory, & worker->arena);
+    freeArena(& context.workers[threadNum].arena);
+  }
+  free(context.workers);
+  return success;
+}
@@ -0,0 +1,188 @@
+#ifndef PlayStrategy_h
+#define PlayStrategy_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Hand strengths */
+#include "HandEvaluator.h"
+/* Generator streams the strategies draw from */
+#include "PokerRandom.h"
+/* Arenas of the play threads */
+#include "PokerArena.h"
+
+/*
+  stdint.h is included for the chip counts and the action histories.
+*/
+#include <stdint.h>
+
+/* Tables played together, and the most decisions a strategy gets at once */
+#define PLAY_BATCH_TABLES 1024
+/* Betting streets, after the third, fourth and fifth card */
+#define PLAY_STREETS 3
+#define PLAY_FIRST_STREET_CARDS 3
+/* Chips each player antes, and the fixed bet of the early and last streets */
+#define PLAY_ANTE 1
+#define PLAY_SMALL_BET 2
+#define PLAY_BIG_BET 4
+/* Bets and raises allowed on a street */
+#define PLAY_MAX_BETS 4
+/* Actions of a decision: fold, check or call, bet or raise */
+#define PLAY_ACTIONS 3
+#define PLAY_FOLD 0
+#define PLAY_CALL 1
+#define PLAY_RAISE 2
+/* Bits of an action in a history, and the actions a history holds */
+#define PLAY_ACTION_BITS 2
+#define PLAY_HISTORY_ACTIONS 32
+/* Card a strategy sees in place of one it could not see at the table */
+#define PLAY_HIDDEN_CARD 0xFF
+/* Names of the built in strategies, for messages */
+#define PLAY_STRATEGY_NAMES "passive, tight, aggressive or random"
+
+/*
+  Decision batch structure
+
+  The decisions of one seat at many tables, an array for each field so a
+  strategy can run through them as vectors. The game is limit five card
+  stud: every player antes, is dealt three cards, the first face down and
+  the others face up, and one more face up card before each later street.
+  The player showing the best cards opens each street. A strategy sees only
+  what the player at the seat sees: their own cards and the face up cards
+  of the others. The cards are copied in seat by seat, seat s's at
+  s * CARDS_PER_HAND, with PLAY_HIDDEN_CARD in place of the hole cards of
+  the other seats and of the cards not dealt yet.
+
+    numOfDecisions - decisions in the batch
+    numOfPlayers   - players dealt at every table
+    seat           - seat deciding at every table
+    cards          - visible cards of the decision's table, as above
+    street         - street of the decision, the seat holding
+                     PLAY_FIRST_STREET_CARDS + street cards
+    numOfBets      - bets and raises made on the street
+    numOfActive    - players who have not folded
+    folded         - bit s set when seat s has folded
+    strength       - strength of the seat's cards so far
+    bestShowing    - strength of the best face up cards of the other
+                     players still in
+    pot            - chips in the pot
+    toCall         - chips the seat has to put in to call, zero to check
+    betSize        - fixed size of a bet or raise on the street
+    history        - last PLAY_HISTORY_ACTIONS actions of the hand,
+                     PLAY_ACTION_BITS each, the newest in the lowest bits
+    numOfActions   - actions of the hand so far
+*/
+typedef struct decisionBatch
+{
+  int numOfDecisions;
+  int numOfPlayers;
+  int seat;
+  unsigned char cards[PLAY_BATCH_TABLES][MAX_PLAYERS * CARDS_PER_HAND];
+  unsigned char street[PLAY_BATCH_TABLES];
+  unsigned char numOfBets[PLAY_BATCH_TABLES];
+  unsigned char numOfActive[PLAY_BATCH_TABLES];
+  unsigned short folded[PLAY_BATCH_TABLES];
+  handStrength strength[PLAY_BATCH_TABLES];
+  handStrength bestShowing[PLAY_BATCH_TABLES];
+  int32_t pot[PLAY_BATCH_TABLES];
+  int32_t toCall[PLAY_BATCH_TABLES];
+  int32_t betSize[PLAY_BATCH_TABLES];
+  uint64_t history[PLAY_BATCH_TABLES];
+  uint32_t numOfActions[PLAY_BATCH_TABLES];
+} decisionBatch;
+
+/*
+  Strategy function type
+
+  A strategy receives a batch of decisions, a generator stream it may draw
+  from and its own state, and writes PLAY_FOLD, PLAY_CALL or PLAY_RAISE for
+  every decision. Folding when there is nothing to call checks instead,
+  raising when PLAY_MAX_BETS bets were made calls, and so does any other
+  value. Strategies run on several threads at once, so they must not change
+  their state.
+*/
+typedef void (* strategyFunction)(const decisionBatch *, unsigned char *,
+  pokerRng *, const void *);
+
+/*
+  Play strategy structure
+
+    name   - name of the strategy
+    decide - function deciding a batch
+    state  - state passed to decide, NULL for none
+*/
+typedef struct playStrategy
+{
+  const char * name;
+  strategyFunction decide;
+  const void * state;
+} playStrategy;
+
+/*
+  Play configuration structure
+
+    numOfPlayers - players at every table, 2 to MAX_PLAYERS
+    numOfHands   - hands to play
+    seed         - seed of the generator streams: the hands of batch b of
+                   PLAY_BATCH_TABLES are dealt from stream b, and the
+                   strategies draw from stream b of the mixed seed
+    numOfThreads - worker threads
+    strategies   - strategy of every seat
+    backing      - arenaBacking of the arena of each thread
+*/
+typedef struct playConfig
+{
+  int numOfPlayers;
+  uint64_t numOfHands;
+  uint64_t seed;
+  int numOfThreads;
+  playStrategy strategies[MAX_PLAYERS];
+  int backing;
+} playConfig;
+
+/*
+  Play results structure, sums over every hand played.
+
+    hands     - hands played
+    decisions - decisions the strategies made
+    showdowns - hands that reached a showdown
+    actions   - actions taken, by PLAY_FOLD, PLAY_CALL and PLAY_RAISE,
+                after folds with nothing to call became checks and raises
+                over the limit calls
+    chipsWon  - chips every seat won less the chips it put in
+    memory    - size and peak usage of the threads' arenas
+*/
+typedef struct playResults
+{
+  uint64_t hands;
+  uint64_t decisions;
+  uint64_t showdowns;
+  uint64_t actions[PLAY_ACTIONS];
+  int64_t chipsWon[MAX_PLAYERS];
+  memoryReport memory;
+} playResults;
+
+/*
+  Function to find a built in strategy by name: passive checks and calls
+  every hand down, tight bets its pairs that beat every board and calls with
+  a pair, aggressive bets whenever it beats every board and bluffs one time
+  in eight, and random picks an action at random.
+
+  Input   = {char *: name, playStrategy *: strategy}
+  Output  = {bool: found}
+*/
+bool findPlayStrategy(const char *, playStrategy *);
+
+/*
+  Function to play hands on several threads. Each thread takes batches of
+  PLAY_BATCH_TABLES tables and plays them in step: every round the
+  decisions due at each seat are gathered into one batch and its strategy
+  decides them together. A batch depends on its streams alone, so the
+  results are the same on any number of threads.
+
+  Input   = {playConfig *: config, playResults *: results}
+  Output  = {bool: success}, FALSE for a bad configuration or too little
+            memory
+*/
+bool runPlay(const playConfig *, playResults *);
+
+#endif /* PlayStrategy_h */
@@ -0,0 +1,304 @@
+#include "PokerArena.h"
+
+/*
+  sys/mman.h is included for mmap, munmap and madvise, and string.h for
+  memset and strcmp.
+*/
+#include <sys/mman.h>
+#include <string.h>
+
+/* Names of the backings, in the order of arenaBacking */
+static const char * backingNames[NUM_OF_ARENA_BACKINGS] =
+{
+  "pages", "thp", "hugetlb"
+};
+
+/*
+  Function to round a size up to a multiple of a power of two.
+
+  Input   = {size_t: size, size_t: multiple}
+  Output  = {size_t: rounded}
+*/
+static size_t roundUp(size_t size, size_t multiple)
+{
+  return (size + multiple - 1) & ~(multiple - 1);
+}
+
+/*
+  Function to map normal pages starting on a huge page boundary, so the
+  kernel can back the whole mapping with transparent huge pages. More than
+  the size is mapped and the ends beyond the boundaries are unmapped.
+
+  Input   = {size_t: size}, a multiple of HUGE_PAGE_SIZE
+  Output  = {unsigned char *: base}, NULL when nothing can be mapped
+*/
+static unsigned char * mapAligned(size_t size)
+{
+  unsigned char * mapped = mmap(NULL, size + HUGE_PAGE_SIZE,
+    PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  unsigned char * base = NULL;
+
+  if(mapped == MAP_FAILED)
+  {
+    return NULL;
+  }
+  base = (unsigned char *)roundUp((size_t)mapped, HUGE_PAGE_SIZE);
+  if(base > mapped)
+  {
+    munmap(mapped, base - mapped);
+  }
+  munmap(base + size, mapped + HUGE_PAGE_SIZE - base);
+  return base;
+}
+
+/*
+  Function to create an arena, falling back from huge pages to transparent
+  huge pages to normal pages.
+
+  Input   = {pokerArena *: arena, size_t: size, int: backing}
+  Output  = {bool: success}
+*/
+bool createArena(pokerArena * arena, size_t size, int backing)
+{
+  void * mapped = MAP_FAILED;
+
+  memset(arena, 0, sizeof(pokerArena));
+  if((backing < ArenaPages) || (backing >= NUM_OF_ARENA_BACKINGS))
+  {
+    return FALSE;
+  }
+  size = roundUp((size > 0) ? size : 1, (backing == ArenaPages) ?
+    ARENA_ALIGNMENT : HUGE_PAGE_SIZE);
+#ifdef MAP_HUGETLB
+  if(backing == ArenaHugeTlb)
+  {
+    mapped = mmap(NULL, size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+#endif
+  if(mapped != MAP_FAILED)
+  {
+    arena->base = mapped;
+    arena->backing = ArenaHugeTlb;
+  }
+  else if(backing != ArenaPages)
+  {
+    /* The huge page pool is empty or absent, so ask for merged pages */
+    arena->base = mapAligned(size);
+    arena->backing = ArenaPages;
+#ifdef MADV_HUGEPAGE
+    if((arena->base != NULL) &&
+      (madvise(arena->base, size, MADV_HUGEPAGE) == 0))
+    {
+      arena->backing = ArenaTransparentHuge;
+    }
+#endif
+  }
+  else
+  {
+    mapped = mmap(NULL, size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    arena->base = (mapped != MAP_FAILED) ? mapped : NULL;
+    arena->backing = ArenaPages;
+  }
+  if(arena->base == NULL)
+  {
+    return FALSE;
+  }
+  arena->size = size;
+  return TRUE;
+}
+
+/*
+  Function to unmap an arena.
+
+  Input   = {pokerArena *: arena}
+  Output  = {void: NULL}
+*/
+void freeArena(pokerArena * arena)
+{
+  if(arena->base != NULL)
+  {
+    munmap(arena->base, arena->size);
+  }
+  memset(arena, 0, sizeof(pokerArena));
+}
+
+/*
+  Function to allocate bytes from an arena by bumping its offset.
+
+  Input   = {pokerArena *: arena, size_t: size}
+  Output  = {void *: bytes}
+*/
+void * arenaAlloc(pokerArena * arena, size_t size)
+{
+  unsigned char * bytes = NULL;
+
+  size = roundUp(size, ARENA_ALIGNMENT);
+  if((arena->base == NULL) || (size > arena->size - arena->used))
+  {
+    return NULL;
+  }
+  bytes = arena->base + arena->used;
+  arena->used += size;
+  if(arena->used > arena->peak)
+  {
+    arena->peak = arena->used;
+  }
+  return bytes;
+}
+
+/*
+  Function to release everything allocated after an offset.
+
+  Input   = {pokerArena *: arena, size_t: mark}
+  Output  = {void: NULL}
+*/
+void resetArena(pokerArena * arena, size_t mark)
+{
+  if(mark < arena->used)
+  {
+    arena->used = mark;
+  }
+}
+
+/*
+  Function to count the bytes of a number of allocations of a size.
+
+  Input   = {size_t: size, uint64_t: count}
+  Output  = {size_t: bytes}
+*/
+size_t arenaBytes(size_t size, uint64_t count)
+{
+  return roundUp(size, ARENA_ALIGNMENT) * count;
+}
+
+/*
+  Function to carve a pool of objects from an arena. The free list runs in
+  the order of the objects, so they are taken first to last.
+
+  Input   = {objectPool *: pool, pokerArena *: arena, size_t: objectSize,
+            uint64_t: numOfObjects}
+  Output  = {bool: success}
+*/
+bool createPool(objectPool * pool, pokerArena * arena, size_t objectSize,
+  uint64_t numOfObjects)
+{
+  uint64_t objectNum = 0;
+
+  memset(pool, 0, sizeof(objectPool));
+  pool->objectSize = roundUp((objectSize > sizeof(void *)) ? objectSize :
+    sizeof(void *), ARENA_ALIGNMENT);
+  pool->objects = arenaAlloc(arena, pool->objectSize * numOfObjects);
+  if((pool->objects == NULL) || (numOfObjects == 0))
+  {
+    return FALSE;
+  }
+  pool->numOfObjects = numOfObjects;
+  for(objectNum = 0; objectNum + 1 < numOfObjects; objectNum ++)
+  {
+    * (void * *)(pool->objects + objectNum * pool->objectSize) =
+      pool->objects + (objectNum + 1) * pool->objectSize;
+  }
+  * (void * *)(pool->objects + objectNum * pool->objectSize) = NULL;
+  pool->freeList = pool->objects;
+  return TRUE;
+}
+
+/*
+  Function to take the first free object of a pool.
+
+  Input   = {objectPool *: pool}
+  Output  = {void *: object}
+*/
+void * poolTake(objectPool * pool)
+{
+  void * object = pool->freeList;
+
+  if(object == NULL)
+  {
+    return NULL;
+  }
+  pool->freeList = * (void * *)object;
+  pool->inUse ++;
+  if(pool->inUse > pool->peakInUse)
+  {
+    pool->peakInUse = pool->inUse;
+  }
+  return object;
+}
+
+/*
+  Function to put an object at the front of its pool's free list.
+
+  Input   = {objectPool *: pool, void *: object}
+  Output  = {void: NULL}
+*/
+void poolGive(objectPool * pool, void * object)
+{
+  * (void * *)object = pool->freeList;
+  pool->freeList = object;
+  pool->inUse --;
+}
+
+/*
+  Function to clear a memory report.
+
+  Input   = {memoryReport *: report}
+  Output  = {void: NULL}
+*/
+void clearMemoryReport(memoryReport * report)
+{
+  memset(report, 0, sizeof(memoryReport));
+  report->backing = NUM_OF_ARENA_BACKINGS;
+}
+
+/*
+  Function to add an arena to a memory report.
+
+  Input   = {memoryReport *: report, pokerArena *: arena}
+  Output  = {void: NULL}
+*/
+void addArenaReport(memoryReport * report, const pokerArena * arena)
+{
+  report->numOfArenas ++;
+  report->reserved += arena->size;
+  report->peak += arena->peak;
+  if(arena->backing < report->backing)
+  {
+    report->backing = arena->backing;
+  }
+}
+
+/*
+  Function to name an arena backing.
+
+  Input   = {int: backing}
+  Output  = {char *: name}
+*/
+const char * arenaBackingName(int backing)
+{
+  return ((backing >= ArenaPages) && (backing < NUM_OF_ARENA_BACKINGS)) ?
+    backingNames[backing] : "none";
+}
+
+/*
+  Function to read the name of an arena backing.
+
+  Input   = {char *: text, int *: backing}
+  Output  = {bool: known}
+*/
+bool parseArenaBacking(const char * text, int * backing)
+{
+  int backingNum = NUM_INIT;
+  for(backingNum = NUM_INIT; backingNum < NUM_OF_ARENA_BACKINGS;
+    backingNum ++)
+  {
+    if(strcmp(text, backingNames[backingNum]) == 0)
+    {
+      * backing = backingNum;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
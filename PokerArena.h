@@ -0,0 +1,207 @@
+#ifndef PokerArena_h
+#define PokerArena_h
+
+/* Macros of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Cache line size, the alignment of every allocation */
+#include "PokerThreads.h"
+
+/*
+  stddef.h is included for size_t and stdint.h for the usage counters.
+*/
+#include <stddef.h>
+#include <stdint.h>
+
+/* Size of a huge page, the unit huge page arenas are reserved in */
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+/* Alignment of every allocation, so no two of them share a cache line */
+#define ARENA_ALIGNMENT CACHE_LINE_SIZE
+
+/*
+  Pages backing an arena, from the plainest to the largest. An arena asked
+  for huge pages it cannot get falls back to the next plainer backing and
+  records the one it got.
+
+    ArenaPages           - the normal pages of the system
+    ArenaTransparentHuge - normal pages the kernel is asked to merge into
+                           transparent huge pages
+    ArenaHugeTlb         - huge pages reserved from the system's huge page
+                           pool with MAP_HUGETLB
+*/
+typedef enum arenaBacking
+{
+  ArenaPages, ArenaTransparentHuge, ArenaHugeTlb, NUM_OF_ARENA_BACKINGS
+} arenaBacking;
+
+/*
+  Poker arena structure
+
+  One mapping handed out front to back by bumping an offset. Nothing is
+  freed on its own: resetting the arena to an earlier offset releases
+  everything allocated after it at once. The mapping is only given pages as
+  they are first written, and Linux places each page on the NUMA node of
+  the thread that writes it first, so an arena created and filled by the
+  thread using it lies on that thread's node. An arena is used by one
+  thread at a time.
+
+    base    - start of the mapping
+    size    - bytes mapped
+    used    - bytes handed out, the offset of the next allocation
+    peak    - most bytes ever handed out at once
+    backing - the arenaBacking got
+*/
+typedef struct pokerArena
+{
+  unsigned char * base;
+  size_t size;
+  size_t used;
+  size_t peak;
+  int backing;
+} pokerArena;
+
+/*
+  Object pool structure
+
+  Fixed size objects carved from an arena, taken and given back in constant
+  time through a list of the free ones threaded through the objects
+  themselves. Every object starts on a cache line.
+
+    objects      - the first object
+    objectSize   - bytes between two objects
+    numOfObjects - objects in the pool
+    freeList     - first free object, NULL when all are taken
+    inUse        - objects taken
+    peakInUse    - most objects ever taken at once
+*/
+typedef struct objectPool
+{
+  unsigned char * objects;
+  size_t objectSize;
+  uint64_t numOfObjects;
+  void * freeList;
+  uint64_t inUse;
+  uint64_t peakInUse;
+} objectPool;
+
+/*
+  Memory report structure, the arenas of one run added up.
+
+    numOfArenas - arenas created
+    reserved    - bytes the arenas mapped
+    peak        - sum of the arenas' peak usage
+    backing     - plainest backing any arena got, NUM_OF_ARENA_BACKINGS
+                  before the first arena is added
+*/
+typedef struct memoryReport
+{
+  int numOfArenas;
+  uint64_t reserved;
+  uint64_t peak;
+  int backing;
+} memoryReport;
+
+/*
+  Function to create an arena of at least a number of bytes. Huge page
+  arenas are rounded up to whole huge pages.
+
+  Input   = {pokerArena *: arena, size_t: size, int: backing}
+  Output  = {bool: success}, FALSE for an unknown backing or when not even
+            normal pages can be mapped
+*/
+bool createArena(pokerArena *, size_t, int);
+
+/*
+  Function to unmap an arena and everything allocated from it.
+
+  Input   = {pokerArena *: arena}
+  Output  = {void: NULL}
+*/
+void freeArena(pokerArena *);
+
+/*
+  Function to allocate bytes from an arena, aligned to ARENA_ALIGNMENT. The
+  bytes are zero the first time the arena hands them out, but hold what
+  they last held after a reset.
+
+  Input   = {pokerArena *: arena, size_t: size}
+  Output  = {void *: bytes}, NULL when the arena has too little room left
+*/
+void * arenaAlloc(pokerArena *, size_t);
+
+/*
+  Function to release everything allocated from an arena after an offset,
+  a value of its used member read earlier, zero to release everything.
+
+  Input   = {pokerArena *: arena, size_t: mark}
+  Output  = {void: NULL}
+*/
+void resetArena(pokerArena *, size_t);
+
+/*
+  Function to count the bytes an arena needs to hand out a number of
+  allocations of a size, padding included.
+
+  Input   = {size_t: size, uint64_t: count}
+  Output  = {size_t: bytes}
+*/
+size_t arenaBytes(size_t, uint64_t);
+
+/*
+  Function to carve a pool of objects from an arena, every object free.
+
+  Input   = {objectPool *: pool, pokerArena *: arena, size_t: objectSize,
+            uint64_t: numOfObjects}
+  Output  = {bool: success}, FALSE when the arena has too little room left
+*/
+bool createPool(objectPool *, pokerArena *, size_t, uint64_t);
+
+/*
+  Function to take a free object from a pool.
+
+  Input   = {objectPool *: pool}
+  Output  = {void *: object}, NULL when every object is taken
+*/
+void * poolTake(objectPool *);
+
+/*
+  Function to give an object back to the pool it was taken from.
+
+  Input   = {objectPool *: pool, void *: object}
+  Output  = {void: NULL}
+*/
+void poolGive(objectPool *, void *);
+
+/*
+  Function to clear a memory report before its first arena.
+
+  Input   = {memoryReport *: report}
+  Output  = {void: NULL}
+*/
+void clearMemoryReport(memoryReport *);
+
+/*
+  Function to add the size and peak usage of an arena to a report.
+
+  Input   = {memoryReport *: report, pokerArena *: arena}
+  Output  = {void: NULL}
+*/
+void addArenaReport(memoryReport *, const pokerArena *);
+
+/*
+  Function to name an arena backing, "pages", "thp" or "hugetlb", the
+  names parseArenaBacking reads.
+
+  Input   = {int: backing}
+  Output  = {char *: name}
+*/
+const char * arenaBackingName(int);
+
+/*
+  Function to read the name of an arena backing.
+
+  Input   = {char *: text, int *: backing}
+  Output  = {bool: known}
+*/
+bool parseArenaBacking(const char *, int *);
+
+#endif /* PokerArena_h */
@@ -0,0 +1,589 @@
+#include "PokerCheckpoint.h"
+
+/* string.h is included for memcmp, strlen, strchr and memcpy. */
+#include <string.h>
+/* unistd.h is included for fsync, so a checkpoint is on disk when renamed. */
+#include <unistd.h>
+
+/* First bytes of a checkpoint file, the last one its format version */
+#define CHECKPOINT_MAGIC "PKRCHKP1"
+#define CHECKPOINT_MAGIC_SIZE 8
+/* First bytes of a shard file, its format version following them */
+#define SHARD_MAGIC "PKRSHARD"
+#define SHARD_MAGIC_SIZE 8
+/* Suffix of the file a checkpoint is written to before the rename */
+#define CHECKPOINT_TEMP_SUFFIX ".tmp"
+/* FNV-1a constants of the checksum */
+#define CHECKSUM_BASIS 0xCBF29CE484222325ULL
+#define CHECKSUM_PRIME 0x100000001B3ULL
+
+/* Order tickets for qsort */
+static int compareTickets(const void * first, const void * second)
+{
+  const uint64_t firstTicket = * (const uint64_t *)first;
+  const uint64_t secondTicket = * (const uint64_t *)second;
+  return (firstTicket > secondTicket) - (firstTicket < secondTicket);
+}
+
+/*
+  Function to start a checkpoint state with nothing done.
+
+  Input   = {checkpointState *: state, uint64_t: key, uint64_t: numOfTickets}
+  Output  = {void: NULL}
+*/
+void clearCheckpoint(checkpointState * state, uint64_t key,
+  uint64_t numOfTickets)
+{
+  state->key = key;
+  state->numOfTickets = numOfTickets;
+  state->watermark = 0;
+  state->numExtra = 0;
+}
+
+/*
+  Function to start the progress of a worker.
+
+  Input   = {checkpointProgress *: progress}
+  Output  = {void: NULL}
+*/
+void clearProgress(checkpointProgress * progress)
+{
+  progress->inFlight = 0;
+  progress->numDone = 0;
+}
+
+/*
+  Function to note a ticket a worker has finished.
+
+  Input   = {checkpointProgress *: progress, uint64_t: ticket}
+  Output  = {void: NULL}
+*/
+void recordTicket(checkpointProgress * progress, uint64_t ticket)
+{
+  progress->recent[progress->numDone % CHECKPOINT_RING] = ticket;
+  progress->numDone ++;
+}
+
+/*
+  Function to determine whether a ticket is done, by binary search of the
+  tickets above the watermark.
+
+  Input   = {checkpointState *: state, uint64_t: ticket}
+  Output  = {bool: done}
+*/
+bool ticketDone(const checkpointState * state, uint64_t ticket)
+{
+  int low = 0;
+  int high = state->numExtra;
+  int middle = 0;
+
+  if(ticket < state->watermark)
+  {
+    return TRUE;
+  }
+  while(low < high)
+  {
+    middle = (low + high) / 2;
+    if(state->extra[middle] < ticket)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  return ((low < state->numExtra) && (state->extra[low] == ticket)) ?
+    TRUE : FALSE;
+}
+
+/*
+  Function to combine a resumed state with the progress of the workers.
+
+  Input   = {checkpointState *: combined, checkpointState *: resumed,
+            checkpointProgress *: progress, int: numOfWorkers}
+  Output  = {bool: success}
+*/
+bool combineProgress(checkpointState * combined,
+  const checkpointState * resumed, const checkpointProgress * progress,
+  int numOfWorkers)
+{
+  const checkpointProgress * worker = NULL;
+  uint64_t watermark = resumed->numOfTickets;
+  uint64_t numRemembered = 0;
+  uint64_t doneNum = 0;
+  int workerNum = NUM_INIT;
+  int extraNum = NUM_INIT;
+  int numExtra = 0;
+
+  /* No worker will finish a ticket below the lowest one in flight */
+  for(workerNum = NUM_INIT; workerNum < numOfWorkers; workerNum ++)
+  {
+    if(progress[workerNum].inFlight < watermark)
+    {
+      watermark = progress[workerNum].inFlight;
+    }
+  }
+  if(resumed->watermark > watermark)
+  {
+    watermark = resumed->watermark;
+  }
+
+  clearCheckpoint(combined, resumed->key, resumed->numOfTickets);
+  for(extraNum = NUM_INIT; extraNum < resumed->numExtra; extraNum ++)
+  {
+    if(resumed->extra[extraNum] >= watermark)
+    {
+      combined->extra[numExtra ++] = resumed->extra[extraNum];
+    }
+  }
+  for(workerNum = NUM_INIT; workerNum < numOfWorkers; workerNum ++)
+  {
+    worker = & progress[workerNum];
+    numRemembered = (worker->numDone < CHECKPOINT_RING) ? worker->numDone :
+      CHECKPOINT_RING;
+    /* Tickets rise, so once the oldest remembered is below the watermark so
+       is every ticket forgotten */
+    if((worker->numDone > CHECKPOINT_RING) &&
+      (worker->recent[worker->numDone % CHECKPOINT_RING] >= watermark))
+    {
+      return FALSE;
+    }
+    for(doneNum = worker->numDone - numRemembered; doneNum < worker->numDone;
+      doneNum ++)
+    {
+      if(worker->recent[doneNum % CHECKPOINT_RING] >= watermark)
+      {
+        if(numExtra == CHECKPOINT_MAX_EXTRA)
+        {
+          return FALSE;
+        }
+        combined->extra[numExtra ++] =
+          worker->recent[doneNum % CHECKPOINT_RING];
+      }
+    }
+  }
+
+  qsort(combined->extra, numExtra, sizeof(uint64_t), compareTickets);
+  extraNum = 0;
+  while((extraNum < numExtra) && (combined->extra[extraNum] == watermark))
+  {
+    extraNum ++;
+    watermark ++;
+  }
+  memmove(combined->extra, combined->extra + extraNum,
+    (numExtra - extraNum) * sizeof(uint64_t));
+  combined->watermark = watermark;
+  combined->numExtra = numExtra - extraNum;
+  return TRUE;
+}
+
+/*
+  Function to add bytes to an FNV-1a checksum.
+
+  Input   = {uint64_t: checksum, void *: bytes, size_t: size}
+  Output  = {uint64_t: checksum}
+*/
+static uint64_t addChecksum(uint64_t checksum, const void * bytes, size_t size)
+{
+  const unsigned char * next = bytes;
+  size_t byteNum = 0;
+  for(byteNum = 0; byteNum < size; byteNum ++)
+  {
+    checksum = (checksum ^ next[byteNum]) * CHECKSUM_PRIME;
+  }
+  return checksum;
+}
+
+/*
+  Function to write a block of a checkpoint and add it to the checksum.
+
+  Input   = {FILE *: stream, void *: bytes, size_t: size,
+            uint64_t *: checksum}
+  Output  = {bool: success}
+*/
+static bool writeBlock(FILE * stream, const void * bytes, size_t size,
+  uint64_t * checksum)
+{
+  * checksum = addChecksum(* checksum, bytes, size);
+  return ((size == 0) || (fwrite(bytes, size, 1, stream) == 1)) ? TRUE : FALSE;
+}
+
+/*
+  Function to read a block of a checkpoint and add it to the checksum.
+
+  Input   = {FILE *: stream, void *: bytes, size_t: size,
+            uint64_t *: checksum}
+  Output  = {bool: success}
+*/
+static bool readBlock(FILE * stream, void * bytes, size_t size,
+  uint64_t * checksum)
+{
+  if((size != 0) && (fread(bytes, size, 1, stream) != 1))
+  {
+    return FALSE;
+  }
+  * checksum = addChecksum(* checksum, bytes, size);
+  return TRUE;
+}
+
+/*
+  Function to open the temporary file a checkpoint or shard is written to
+  before it is renamed into place.
+
+  Input   = {char *: path, char * *: tempPath}
+  Output  = {FILE *: stream}, NULL on failure
+*/
+static FILE * openTempFile(const char * path, char * * tempPath)
+{
+  const size_t pathLength = strlen(path);
+  FILE * stream = NULL;
+
+  * tempPath = malloc(pathLength + sizeof(CHECKPOINT_TEMP_SUFFIX));
+  if(* tempPath == NULL)
+  {
+    return NULL;
+  }
+  memcpy(* tempPath, path, pathLength);
+  memcpy(* tempPath + pathLength, CHECKPOINT_TEMP_SUFFIX,
+    sizeof(CHECKPOINT_TEMP_SUFFIX));
+  stream = fopen(* tempPath, "wb");
+  if(stream == NULL)
+  {
+    free(* tempPath);
+    * tempPath = NULL;
+  }
+  return stream;
+}
+
+/*
+  Function to end a temporary file with its checksum, flush it to disk and
+  rename it over the file it replaces, or remove it when anything failed.
+
+  Input   = {FILE *: stream, char *: tempPath, char *: path,
+            uint64_t: checksum, bool: success}
+  Output  = {bool: success}
+*/
+static bool renameTempFile(FILE * stream, char * tempPath, const char * path,
+  uint64_t checksum, bool success)
+{
+  success = success && (fwrite(& checksum, sizeof(uint64_t), 1, stream) == 1) &&
+    (fflush(stream) == 0) && (fsync(fileno(stream)) == 0);
+  success = (fclose(stream) == 0) && success;
+  success = success && (rename(tempPath, path) == 0);
+  if(success == FALSE)
+  {
+    remove(tempPath);
+  }
+  free(tempPath);
+  return success;
+}
+
+/*
+  Function to write a checkpoint to a temporary file and rename it into
+  place.
+
+  Input   = {char *: path, checkpointState *: state, void *: totals,
+            size_t: totalsSize}
+  Output  = {bool: success}
+*/
+bool writeCheckpoint(const char * path, const checkpointState * state,
+  const void * totals, size_t totalsSize)
+{
+  const uint64_t numExtra = state->numExtra;
+  const uint64_t size = totalsSize;
+  uint64_t checksum = CHECKSUM_BASIS;
+  char * tempPath = NULL;
+  FILE * stream = openTempFile(path, & tempPath);
+  bool success = TRUE;
+
+  if(stream == NULL)
+  {
+    return FALSE;
+  }
+  success = writeBlock(stream, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE,
+    & checksum) &&
+    writeBlock(stream, & state->key, sizeof(uint64_t), & checksum) &&
+    writeBlock(stream, & state->numOfTickets, sizeof(uint64_t), & checksum) &&
+    writeBlock(stream, & state->watermark, sizeof(uint64_t), & checksum) &&
+    writeBlock(stream, & numExtra, sizeof(uint64_t), & checksum) &&
+    writeBlock(stream, state->extra, numExtra * sizeof(uint64_t),
+    & checksum) &&
+    writeBlock(stream, & size, sizeof(uint64_t), & checksum) &&
+    writeBlock(stream, totals, totalsSize, & checksum);
+  return renameTempFile(stream, tempPath, path, checksum, success);
+}
+
+/*
+  Function to read a checkpoint and check it belongs to the run.
+
+  Input   = {char *: path, checkpointState *: state, void *: totals,
+            size_t: totalsSize}
+  Output  = {bool: success}
+*/
+bool readCheckpoint(const char * path, checkpointState * state, void * totals,
+  size_t totalsSize)
+{
+  char magic[CHECKPOINT_MAGIC_SIZE];
+  uint64_t key = 0;
+  uint64_t numOfTickets = 0;
+  uint64_t watermark = 0;
+  uint64_t numExtra = 0;
+  uint64_t size = 0;
+  uint64_t checksum = CHECKSUM_BASIS;
+  uint64_t storedChecksum = 0;
+  FILE * stream = fopen(path, "rb");
+  bool success = TRUE;
+
+  if(stream == NULL)
+  {
+    return FALSE;
+  }
+  success = readBlock(stream, magic, CHECKPOINT_MAGIC_SIZE, & checksum) &&
+    (memcmp(magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE) == 0) &&
+    readBlock(stream, & key, sizeof(uint64_t), & checksum) &&
+    readBlock(stream, & numOfTickets, sizeof(uint64_t), & checksum) &&
+    readBlock(stream, & watermark, sizeof(uint64_t), & checksum) &&
+    readBlock(stream, & numExtra, sizeof(uint64_t), & checksum) &&
+    (key == state->key) && (numOfTickets == state->numOfTickets) &&
+    (watermark <= numOfTickets) && (numExtra <= CHECKPOINT_MAX_EXTRA) &&
+    readBlock(stream, state->extra, numExtra * sizeof(uint64_t),
+    & checksum) &&
+    readBlock(stream, & size, sizeof(uint64_t), & checksum) &&
+    (size == totalsSize) &&
+    readBlock(stream, totals, totalsSize, & checksum) &&
+    (fread(& storedChecksum, sizeof(uint64_t), 1, stream) == 1) &&
+    (storedChecksum == checksum);
+  fclose(stream);
+  if(success == FALSE)
+  {
+    return FALSE;
+  }
+  state->watermark = watermark;
+  state->numExtra = (int)numExtra;
+  return TRUE;
+}
+
+/*
+  Function to read a shard given as "i/N".
+
+  Input   = {char *: text, uint64_t *: shardNum, uint64_t *: numOfShards}
+  Output  = {bool: success}
+*/
+bool parseShardSpec(const char * text, uint64_t * shardNum,
+  uint64_t * numOfShards)
+{
+  const char * slash = strchr(text, '/');
+  char * end = NULL;
+
+  if((slash == NULL) || (text[0] < '0') || (text[0] > '9') ||
+    (slash[1] < '0') || (slash[1] > '9'))
+  {
+    return FALSE;
+  }
+  * shardNum = strtoull(text, & end, 10);
+  if(end != slash)
+  {
+    return FALSE;
+  }
+  * numOfShards = strtoull(slash + 1, & end, 10);
+  if((* end != '\0') || (* shardNum < 1) || (* shardNum > * numOfShards))
+  {
+    return FALSE;
+  }
+  (* shardNum) --;
+  return TRUE;
+}
+
+/*
+  Function to fill in the item range of a shard. The share of every shard
+  is split into the whole items of items / N and the remainder, so the
+  bounds never overflow.
+
+  Input   = {shardHeader *: shard, uint64_t: key, uint64_t: numOfItems,
+            uint64_t: shardNum, uint64_t: numOfShards}
+  Output  = {void: NULL}
+*/
+void setShardRange(shardHeader * shard, uint64_t key, uint64_t numOfItems,
+  uint64_t shardNum, uint64_t numOfShards)
+{
+  const uint64_t share = numOfItems / numOfShards;
+  const uint64_t remainder = numOfItems % numOfShards;
+
+  shard->key = key;
+  shard->numOfItems = numOfItems;
+  shard->shardNum = shardNum;
+  shard->numOfShards = numOfShards;
+  shard->first = share * shardNum + (remainder * shardNum) / numOfShards;
+  shard->last = share * (shardNum + 1) +
+    (remainder * (shardNum + 1)) / numOfShards;
+}
+
+/*
+  Function to write the results of a shard to a temporary file and rename
+  it into place.
+
+  Input   = {char *: path, shardHeader *: shard, void *: totals,
+            size_t: totalsSize}
+  Output  = {bool: success}
+*/
+bool writeShard(const char * path, const shardHeader * shard,
+  const void * totals, size_t totalsSize)
+{
+  const uint64_t version = SHARD_FORMAT_VERSION;
+  const uint64_t size = totalsSize;
+  uint64_t checksum = CHECKSUM_BASIS;
+  char * tempPath = NULL;
+  FILE * stream = openTempFile(path, & tempPath);
+  bool success = TRUE;
+
+  if(stream == NULL)
+  {
+    return FALSE;
+  }
+  success = writeBlock(stream, SHARD_MAGIC, SHARD_MAGIC_SIZE, & checksum) &&
+    writeBlock(stream, & version, sizeof(uint64_t), & checksum) &&
+    writeBlock(stream, shard, sizeof(shardHeader), & checksum) &&
+    writeBlock(stream, & size, sizeof(uint64_t), & checksum) &&
+    writeBlock(stream, totals, totalsSize, & checksum);
+  return renameTempFile(stream, tempPath, path, checksum, success);
+}
+
+/*
+  Function to read a shard file and check its format and checksum.
+
+  Input   = {char *: path, shardHeader *: shard, void *: totals,
+            size_t: totalsSize}
+  Output  = {bool: success}
+*/
+bool readShard(const char * path, shardHeader * shard, void * totals,
+  size_t totalsSize)
+{
+  char magic[SHARD_MAGIC_SIZE];
+  uint64_t version = 0;
+  uint64_t size = 0;
+  uint64_t checksum = CHECKSUM_BASIS;
+  uint64_t storedChecksum = 0;
+  FILE * stream = fopen(path, "rb");
+  bool success = TRUE;
+
+  if(stream == NULL)
+  {
+    return FALSE;
+  }
+  success = readBlock(stream, magic, SHARD_MAGIC_SIZE, & checksum) &&
+    (memcmp(magic, SHARD_MAGIC, SHARD_MAGIC_SIZE) == 0) &&
+    readBlock(stream, & version, sizeof(uint64_t), & checksum) &&
+    (version == SHARD_FORMAT_VERSION) &&
+    readBlock(stream, shard, sizeof(shardHeader), & checksum) &&
+    readBlock(stream, & size, sizeof(uint64_t), & checksum) &&
+    (size == totalsSize) &&
+    readBlock(stream, totals, totalsSize, & checksum) &&
+    (fread(& storedChecksum, sizeof(uint64_t), 1, stream) == 1) &&
+    (storedChecksum == checksum) && (shard->first <= shard->last) &&
+    (shard->last <= shard->numOfItems);
+  fclose(stream);
+  return success;
+}
+
+/* First item of a shard and where it was given, sorted on the item */
+typedef struct shardOrder
+{
+  uint64_t first;
+  int shardNum;
+} shardOrder;
+
+/* Order shards by their first item for qsort */
+static int compareShards(const void * first, const void * second)
+{
+  const shardOrder * firstShard = first;
+  const shardOrder * secondShard = second;
+  return (firstShard->first > secondShard->first) -
+    (firstShard->first < secondShard->first);
+}
+
+/*
+  Function to check that shards cover every item of their run once, by
+  sorting them on their first item and walking the ranges in order.
+
+  Input   = {shardHeader *: shards, int: numOfShards,
+            shardCoverage *: coverage}
+  Output  = {bool: complete}
+*/
+bool checkShardCoverage(const shardHeader * shards, int numOfShards,
+  shardCoverage * coverage)
+{
+  shardOrder * order = NULL;
+  uint64_t covered = 0;
+  int shardNum = NUM_INIT;
+  int previous = INVALID_INT;
+  int current = INVALID_INT;
+
+  coverage->status = SHARDS_COMPLETE;
+  coverage->first = INVALID_INT;
+  coverage->second = INVALID_INT;
+  coverage->gapFirst = 0;
+  coverage->gapLast = 0;
+  if(numOfShards < 1)
+  {
+    coverage->status = SHARDS_MISSING;
+    return FALSE;
+  }
+  for(shardNum = 1; shardNum < numOfShards; shardNum ++)
+  {
+    if((shards[shardNum].key != shards[0].key) ||
+      (shards[shardNum].numOfItems != shards[0].numOfItems))
+    {
+      coverage->status = SHARDS_MISMATCHED;
+      coverage->first = 0;
+      coverage->second = shardNum;
+      return FALSE;
+    }
+  }
+  order = malloc(numOfShards * sizeof(shardOrder));
+  if(order == NULL)
+  {
+    coverage->status = SHARDS_UNREADABLE;
+    return FALSE;
+  }
+  for(shardNum = NUM_INIT; shardNum < numOfShards; shardNum ++)
+  {
+    order[shardNum].first = shards[shardNum].first;
+    order[shardNum].shardNum = shardNum;
+  }
+  /* Empty shards hold nothing and cannot overlap, the rest must tile */
+  qsort(order, numOfShards, sizeof(shardOrder), compareShards);
+  for(shardNum = NUM_INIT; shardNum < numOfShards; shardNum ++)
+  {
+    current = order[shardNum].shardNum;
+    if(shards[current].first == shards[current].last)
+    {
+      continue;
+    }
+    if(shards[current].first > covered)
+    {
+      coverage->status = SHARDS_MISSING;
+      coverage->gapFirst = covered;
+      coverage->gapLast = shards[current].first;
+      break;
+    }
+    if(shards[current].first < covered)
+    {
+      coverage->status = SHARDS_OVERLAPPING;
+      coverage->first = previous;
+      coverage->second = current;
+      break;
+    }
+    covered = shards[current].last;
+    previous = current;
+  }
+  if((coverage->status == SHARDS_COMPLETE) &&
+    (covered < shards[0].numOfItems))
+  {
+    coverage->status = SHARDS_MISSING;
+    coverage->gapFirst = covered;
+    coverage->gapLast = shards[0].numOfItems;
+  }
+  free(order);
+  return (coverage->status == SHARDS_COMPLETE) ? TRUE : FALSE;
+}
@@ -0,0 +1,270 @@
+#ifndef PokerCheckpoint_h
+#define PokerCheckpoint_h
+
+/* Macros of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Most threads a run can have */
+#include "PokerThreads.h"
+/* Seed mixing, used for the checkpoint keys */
+#include "PokerRandom.h"
+
+/*
+  stdint.h is included for the ticket numbers, and stddef.h for the sizes of
+  the saved totals.
+*/
+#include <stdint.h>
+#include <stddef.h>
+
+/* Tickets each worker remembers finishing, most recent last */
+#define CHECKPOINT_RING 256
+/* Most finished tickets a checkpoint lists above its watermark */
+#define CHECKPOINT_MAX_EXTRA (MAX_THREADS * CHECKPOINT_RING)
+/* Seconds between checkpoints when none are given */
+#define DEFAULT_CHECKPOINT_SECONDS 60.0
+/* Format version of shard files, raised whenever their layout changes */
+#define SHARD_FORMAT_VERSION 1
+
+/* Outcomes of checking that shards cover a run */
+#define SHARDS_COMPLETE 0
+#define SHARDS_UNREADABLE 1
+#define SHARDS_MISMATCHED 2
+#define SHARDS_MISSING 3
+#define SHARDS_OVERLAPPING 4
+
+/*
+  Checkpoint configuration structure
+
+    path    - file the progress and totals of a run are saved to, NULL for
+              no checkpoints
+    seconds - time between checkpoints
+    resume  - TRUE to carry on from the file, skipping the work it holds
+*/
+typedef struct checkpointConfig
+{
+  const char * path;
+  double seconds;
+  bool resume;
+} checkpointConfig;
+
+/*
+  Checkpoint progress structure
+
+  What one worker has done, in the units its run hands out: the batches of a
+  simulation or the chunks of an enumeration, called tickets here. Tickets
+  are taken from a shared counter, so each worker takes them in increasing
+  order. A worker keeps its own copy and publishes it together with its
+  totals, under the same lock, so a published copy always describes exactly
+  the totals beside it.
+
+    inFlight - ticket being worked on, every later ticket of the worker is
+               above it; 0 before the first is taken and the number of
+               tickets once the worker is done
+    numDone  - tickets finished in this run
+    recent   - the last tickets finished, ticket i of the run at
+               recent[i % CHECKPOINT_RING]
+*/
+typedef struct checkpointProgress
+{
+  uint64_t inFlight;
+  uint64_t numDone;
+  uint64_t recent[CHECKPOINT_RING];
+} checkpointProgress;
+
+/*
+  Checkpoint state structure
+
+  The tickets of a run that are done: every ticket below the watermark and
+  the few above it listed in extra, in ascending order. It is large, so
+  callers allocate it.
+
+    key          - hash of everything the run's results depend on
+    numOfTickets - tickets of the whole run
+    watermark    - every ticket below it is done
+    numExtra     - tickets in extra
+    extra        - done tickets at or above the watermark
+*/
+typedef struct checkpointState
+{
+  uint64_t key;
+  uint64_t numOfTickets;
+  uint64_t watermark;
+  int numExtra;
+  uint64_t extra[CHECKPOINT_MAX_EXTRA];
+} checkpointState;
+
+/* Adds a setting of a run to its checkpoint key */
+#define mixCheckpointKey(key, value) \
+  (mixSeed((key) ^ (uint64_t)(value)) + 0x9E3779B97F4A7C15ULL)
+
+/*
+  Function to start a checkpoint state with nothing done.
+
+  Input   = {checkpointState *: state, uint64_t: key, uint64_t: numOfTickets}
+  Output  = {void: NULL}
+*/
+void clearCheckpoint(checkpointState *, uint64_t, uint64_t);
+
+/*
+  Function to start the progress of a worker.
+
+  Input   = {checkpointProgress *: progress}
+  Output  = {void: NULL}
+*/
+void clearProgress(checkpointProgress *);
+
+/*
+  Function to note a ticket a worker has finished.
+
+  Input   = {checkpointProgress *: progress, uint64_t: ticket}
+  Output  = {void: NULL}
+*/
+void recordTicket(checkpointProgress *, uint64_t);
+
+/*
+  Function to determine whether a ticket is done in a checkpoint state.
+
+  Input   = {checkpointState *: state, uint64_t: ticket}
+  Output  = {bool: done}
+*/
+bool ticketDone(const checkpointState *, uint64_t);
+
+/*
+  Function to combine the state a run resumed from with the published
+  progress of its workers. Every ticket below the lowest ticket in flight is
+  done, since no worker can still take one, and the tickets above it are
+  found in the workers' recent lists. The copies may be taken at different
+  times as long as each matches the totals read with it.
+
+  Input   = {checkpointState *: combined, checkpointState *: resumed,
+            checkpointProgress *: progress, int: numOfWorkers}
+  Output  = {bool: success}, FALSE when a worker has finished more tickets
+            above the watermark than it remembers, in which case the next
+            checkpoint is tried instead
+*/
+bool combineProgress(checkpointState *, const checkpointState *,
+  const checkpointProgress *, int);
+
+/*
+  Function to write a checkpoint atomically: the state and the totals of the
+  tickets it lists go to a temporary file that is flushed to disk and then
+  renamed over the checkpoint, so a checkpoint is always whole. Numbers are
+  stored in the byte order of the machine.
+
+  Input   = {char *: path, checkpointState *: state, void *: totals,
+            size_t: totalsSize}
+  Output  = {bool: success}
+*/
+bool writeCheckpoint(const char *, const checkpointState *, const void *,
+  size_t);
+
+/*
+  Function to read a checkpoint written by writeCheckpoint. The state must
+  hold the key and the number of tickets of the run, and the checkpoint is
+  only accepted when they match.
+
+  Input   = {char *: path, checkpointState *: state, void *: totals,
+            size_t: totalsSize}
+  Output  = {bool: success}
+*/
+bool readCheckpoint(const char *, checkpointState *, void *, size_t);
+
+/*
+  Shard header structure
+
+  A shard is the part of a run's work one process does on its own: a range
+  of the run's item indices, for example the completions of an enumeration.
+  Shard i of N holds indices i * items / N to (i + 1) * items / N, counting
+  the shards from 0 here and from 1 on the command line.
+
+    key         - hash of everything the run's results depend on, the same
+                  for every shard of the run
+    numOfItems  - items of the whole run
+    shardNum    - shard of the run, from 0
+    numOfShards - shards the run was split into
+    first       - first item of the shard
+    last        - one past the last item of the shard
+*/
+typedef struct shardHeader
+{
+  uint64_t key;
+  uint64_t numOfItems;
+  uint64_t shardNum;
+  uint64_t numOfShards;
+  uint64_t first;
+  uint64_t last;
+} shardHeader;
+
+/*
+  Shard coverage structure, what checkShardCoverage found.
+
+    status   - SHARDS_COMPLETE or what is wrong with the shards
+    first    - shard at fault, an index into the shards given, or the first
+               of two shards that do not belong together or overlap
+    second   - the other shard of two at fault
+    gapFirst - first item in no shard when some are missing
+    gapLast  - one past the last item of that gap
+*/
+typedef struct shardCoverage
+{
+  int status;
+  int first;
+  int second;
+  uint64_t gapFirst;
+  uint64_t gapLast;
+} shardCoverage;
+
+/*
+  Function to read a shard given as "i/N" on the command line, shard i of N
+  counting from 1.
+
+  Input   = {char *: text, uint64_t *: shardNum, uint64_t *: numOfShards}
+  Output  = {bool: success}, FALSE unless 1 <= i <= N, shardNum then being
+            i - 1
+*/
+bool parseShardSpec(const char *, uint64_t *, uint64_t *);
+
+/*
+  Function to fill in the item range of a shard of a run.
+
+  Input   = {shardHeader *: shard, uint64_t: key, uint64_t: numOfItems,
+            uint64_t: shardNum, uint64_t: numOfShards}
+  Output  = {void: NULL}
+*/
+void setShardRange(shardHeader *, uint64_t, uint64_t, uint64_t, uint64_t);
+
+/*
+  Function to write the results of a shard atomically, the same way as a
+  checkpoint: a failed or interrupted shard leaves no file, or the file of
+  an earlier run of it, and can simply be run again. The file starts with
+  the format version and the header, and the results follow.
+
+  Input   = {char *: path, shardHeader *: shard, void *: totals,
+            size_t: totalsSize}
+  Output  = {bool: success}
+*/
+bool writeShard(const char *, const shardHeader *, const void *, size_t);
+
+/*
+  Function to read a shard file written by writeShard.
+
+  Input   = {char *: path, shardHeader *: shard, void *: totals,
+            size_t: totalsSize}
+  Output  = {bool: success}, FALSE when the file cannot be read, is of
+            another format version, has results of another size or fails
+            its checksum
+*/
+bool readShard(const char *, shardHeader *, void *, size_t);
+
+/*
+  Function to check that shards belong to the same run and together cover
+  every item of it exactly once. Shards split in different ways may be
+  mixed as long as their ranges fit together.
+
+  Input   = {shardHeader *: shards, int: numOfShards,
+            shardCoverage *: coverage}
+  Output  = {bool: complete}, FALSE also when out of memory, the status
+            then being SHARDS_UNREADABLE with no shard at fault
+*/
+bool checkShardCoverage(const shardHeader *, int, shardCoverage *);
+
+#endif /* PokerCheckpoint_h */
@@ -0,0 +1,2927 @@
+#include "PokerModes.h"
+/* Card parsing and printing */
+#include "HandEvaluator.h"
+/* Exact stud equities */
+#include "StudEquity.h"
+/* Worker threads and timing */
+#include "PokerThreads.h"
+/* Suit canonical classes */
+#include "SuitIsomorphism.h"
+/* Simulated tables and their statistics */
+#include "PokerSimulation.h"
+/* Generator streams and shuffles */
+#include "PokerRandom.h"
+/* Batches of shuffled decks */
+#include "BatchShuffle.h"
+/* Five card draw discards */
+#include "DrawSolver.h"
+/* Seven card stud hands */
+#include "SevenStud.h"
+/* Tables dealt around rare hands */
+#include "RareHands.h"
+/* Producer, evaluator and writer stages */
+#include "PokerPipeline.h"
+/* Bitmap indices of deal files */
+#include "HandHistory.h"
+/* Shuffle fairness audits */
+#include "ShuffleAudit.h"
+/* Hand categories left after card removal */
+#include "CardRemoval.h"
+/* Jokers and wild ranks */
+#include "WildCards.h"
+/* Win odds of every hand against random opponents */
+#include "HandPercentile.h"
+/* Tables of any size dealt from shoes */
+#include "DynamicTable.h"
+/* Counterfactual regret solver of a stud betting game */
+#include "StudCfr.h"
+/* Hand ranges and range against range equity */
+#include "HandRange.h"
+/* Multi-table tournaments */
+#include "Tournament.h"
+/* Arenas and their huge page backings */
+#include "PokerArena.h"
+/* Batched play strategies and the play driver */
+#include "PlayStrategy.h"
+
+/* string.h is included for strcmp and strncmp. */
+#include <string.h>
+/* stdatomic.h is included for the batch counter of the stud simulation. */
+#include <stdatomic.h>
+/* ctype.h is included for toupper. */
+#include <ctype.h>
+/* math.h is included for HUGE_VAL, the time of a round not yet run. */
+#include <math.h>
+
+/* Exit statuses of the modes */
+#define MODE_SUCCESS 0
+#define MODE_FAILURE 1
+#define MAX_POSITIONALS 64
+/* Hands the wild mode deals before evaluating them */
+#define WILD_CHUNK_HANDS 4096
+/* Shard file the equity mode writes when given none, and its size */
+#define DEFAULT_SHARD_FILE "equity-%llu-of-%llu.shard"
+#define SHARD_NAME_SIZE 64
+/* Table file the percentile modes use when given none */
+#define DEFAULT_PERCENTILE_FILE "percentile.tbl"
+/* Dealt tables the showdown benchmark cycles through, and the rounds it
+   times each path over, keeping the fastest */
+#define SHOWDOWN_BENCH_DEALS 4096
+#define SHOWDOWN_BENCH_ROUNDS 5
+/* Tables the statistics benchmark simulates when given none, and the
+   rounds it times with and without statistics, keeping the fastest */
+#define STATS_BENCH_TABLES 4000000
+#define STATS_BENCH_ROUNDS 5
+
+/* Names of the hand ranks, from PokerTable.c */
+extern char * handRanks[NUM_OF_HAND_RANKS];
+
+/* Mode function type, given the arguments after the mode name */
+typedef int (* modeFunction)(int, const char * *);
+
+/* Entry of the mode table */
+typedef struct pokerMode
+{
+  const char * name;
+  modeFunction function;
+  const char * usage;
+} pokerMode;
+
+/*
+  Function to find the value of a single dash option such as -t 4.
+
+  Input   = {int: argc, char * *: argv, char *: name}
+  Output  = {char *: value}, NULL when the option is absent
+*/
+static const char * optionValue(int argc, const char * argv[],
+  const char * name)
+{
+  int argNum = NUM_INIT;
+  for(argNum = NUM_INIT; argNum + 1 < argc; argNum ++)
+  {
+    if(strcmp(argv[argNum], name) == 0)
+    {
+      return argv[argNum + 1];
+    }
+  }
+  return NULL;
+}
+
+/* Double dash options that take a value, unlike the other flags */
+static const char * valueFlags[] = {"--shard", "--trace", "--trace-every",
+  "--huge-pages", NULL};
+
+/*
+  Function to collect the arguments that are neither options nor option
+  values. Single dash options and the valueFlags take a value, other double
+  dash flags do not.
+
+  Input   = {int: argc, char * *: argv, char * *: positionals}
+  Output  = {int: numOfPositionals}
+*/
+static int collectPositionals(int argc, const char * argv[],
+  const char * positionals[MAX_POSITIONALS])
+{
+  int argNum = NUM_INIT;
+  int flagNum = NUM_INIT;
+  int numOfPositionals = NUM_INIT;
+  for(argNum = NUM_INIT; argNum < argc; argNum ++)
+  {
+    if(strncmp(argv[argNum], MODE_PREFIX, 2) == 0)
+    {
+      for(flagNum = NUM_INIT; valueFlags[flagNum] != NULL; flagNum ++)
+      {
+        if(strcmp(argv[argNum], valueFlags[flagNum]) == 0)
+        {
+          argNum ++;
+          break;
+        }
+      }
+      continue;
+    }
+    if((argv[argNum][0] == '-') && (argv[argNum][1] >= 'a') &&
+      (argv[argNum][1] <= 'z'))
+    {
+      argNum ++;
+      continue;
+    }
+    if(numOfPositionals < MAX_POSITIONALS)
+    {
+      positionals[numOfPositionals ++] = argv[argNum];
+    }
+  }
+  return numOfPositionals;
+}
+
+/*
+  Function to read the -t option, the number of worker threads, at most
+  MAX_THREADS.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: numOfThreads}
+*/
+static int threadOption(int argc, const char * argv[])
+{
+  const char * value = optionValue(argc, argv, "-t");
+  if(value != NULL && atoi(value) > 0)
+  {
+    /* Every run sizes its per thread records by MAX_THREADS */
+    return (atoi(value) > MAX_THREADS) ? MAX_THREADS : atoi(value);
+  }
+  return defaultThreadCount();
+}
+
+/*
+  Function to read the checkpoint options: -c file, -k seconds between
+  checkpoints and the --resume flag.
+
+  Input   = {int: argc, char * *: argv, checkpointConfig *: checkpoint}
+  Output  = {bool: valid}, FALSE when --resume is given without a file
+*/
+static bool checkpointOptions(int argc, const char * argv[],
+  checkpointConfig * checkpoint)
+{
+  const char * secondsText = optionValue(argc, argv, "-k");
+  int argNum = NUM_INIT;
+
+  checkpoint->path = optionValue(argc, argv, "-c");
+  checkpoint->seconds = ((secondsText != NULL) && (atof(secondsText) > 0.0)) ?
+    atof(secondsText) : DEFAULT_CHECKPOINT_SECONDS;
+  checkpoint->resume = FALSE;
+  for(argNum = NUM_INIT; argNum < argc; argNum ++)
+  {
+    if(strcmp(argv[argNum], "--resume") == 0)
+    {
+      checkpoint->resume = TRUE;
+    }
+  }
+  if((checkpoint->resume == TRUE) && (checkpoint->path == NULL))
+  {
+    printf("Give the checkpoint to resume from with -c\n");
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*
+  Function to read the trace options, --trace file and --trace-every
+  batches, and create the trace of a run. Without --trace-every about
+  TRACE_SAMPLED_BATCHES batches of the run are sampled.
+
+  Input   = {int: argc, char * *: argv, int: numOfThreads,
+            uint64_t: numOfTables, pokerTrace *: trace}
+  Output  = {bool: valid}, FALSE when the trace cannot be created; without
+            --trace the trace is left empty, with no buffers
+*/
+static bool traceOptions(int argc, const char * argv[], int numOfThreads,
+  uint64_t numOfTables, pokerTrace * trace)
+{
+  const char * everyText = optionValue(argc, argv, "--trace-every");
+  const uint64_t numOfBatches = (numOfTables + TABLES_PER_BATCH - 1) /
+    TABLES_PER_BATCH;
+  uint64_t sampleEvery = (numOfBatches + TRACE_SAMPLED_BATCHES - 1) /
+    TRACE_SAMPLED_BATCHES;
+
+  memset(trace, 0, sizeof(* trace));
+  if(optionValue(argc, argv, "--trace") == NULL)
+  {
+    return TRUE;
+  }
+  if((everyText != NULL) && (strtoull(everyText, NULL, 10) > 0))
+  {
+    sampleEvery = strtoull(everyText, NULL, 10);
+  }
+  if(createTrace(trace, numOfThreads, TRACE_RING_EVENTS,
+    (sampleEvery > 0) ? sampleEvery : 1) == FALSE)
+  {
+    printf("Not enough memory for the trace of %d threads\n", numOfThreads);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*
+  Function to write a trace to the file of the --trace option and free it.
+
+  Input   = {int: argc, char * *: argv, pokerTrace *: trace}
+  Output  = {bool: success}
+*/
+static bool saveTrace(int argc, const char * argv[], pokerTrace * trace)
+{
+  const char * traceName = optionValue(argc, argv, "--trace");
+  FILE * output = NULL;
+  bool success = TRUE;
+
+  if(trace->buffers == NULL)
+  {
+    return TRUE;
+  }
+  output = fopen(traceName, "w");
+  success = ((output != NULL) && (writeTraceJson(trace, output) == TRUE)) ?
+    TRUE : FALSE;
+  success = ((output != NULL) && (fclose(output) == 0)) ? success : FALSE;
+  if(success == TRUE)
+  {
+    fprintf(stderr, "Traced one batch in %llu to %s, %llu spans "
+      "overwritten\n", (unsigned long long)trace->sampleEvery, traceName,
+      (unsigned long long)traceDropped(trace));
+  }
+  else
+  {
+    printf("Cannot write the trace to %s\n", traceName);
+  }
+  freeTrace(trace);
+  return success;
+}
+
+/*
+  Function to read the --huge-pages option, thp or hugetlb, the backing of
+  the arenas of a run. Without it the arenas use normal pages.
+
+  Input   = {int: argc, char * *: argv, int *: backing}
+  Output  = {bool: valid}
+*/
+static bool memoryOptions(int argc, const char * argv[], int * backing)
+{
+  const char * backingText = optionValue(argc, argv, "--huge-pages");
+
+  * backing = ArenaPages;
+  if((backingText != NULL) &&
+    (parseArenaBacking(backingText, backing) == FALSE))
+  {
+    printf("Unknown huge pages %s, use thp or hugetlb\n", backingText);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*
+  Function to print the size and peak usage of the arenas of a run, with
+  the backing they got, which is plainer than asked for when the system
+  has no huge pages to give.
+
+  Input   = {FILE *: output, memoryReport *: memory}
+  Output  = {void: NULL}
+*/
+static void printMemory(FILE * output, const memoryReport * memory)
+{
+  fprintf(output, "Memory: %.2f MiB peak of %.2f MiB in %d arena%s backed "
+    "by %s\n", memory->peak / 1048576.0, memory->reserved / 1048576.0,
+    memory->numOfArenas, (memory->numOfArenas == 1) ? "" : "s",
+    arenaBackingName(memory->backing));
+}
+
+/*
+  Function to print a list of card indices.
+
+  Input   = {unsigned char *: cards, int: numOfCards}
+  Output  = {void: NULL}
+*/
+static void printCardIndices(const unsigned char * cards, int numOfCards)
+{
+  int cardNum = NUM_INIT;
+  for(cardNum = NUM_INIT; cardNum < numOfCards; cardNum ++)
+  {
+    printCardIndex(cards[cardNum]);
+    printf("  ");
+  }
+}
+
+/*
+  Function to print the equities of the players of a stud board.
+
+  Input   = {studBoard *: board, studEquity *: result}
+  Output  = {void: NULL}
+*/
+static void printStudEquity(const studBoard * board, const studEquity * result)
+{
+  int playrNum = NUM_INIT;
+  for(playrNum = NUM_INIT; playrNum < board->numOfPlayers; playrNum ++)
+  {
+    printf("Player %d] - ", playrNum + 1);
+    printCardIndices(board->known[playrNum], board->numKnown[playrNum]);
+    printf("- equity %7.4f%%  win %7.4f%%  tie %7.4f%%",
+      result->equity[playrNum] * 100.0,
+      (double)result->wins[playrNum] * 100.0 / (double)result->evaluated,
+      (double)result->ties[playrNum] * 100.0 / (double)result->evaluated);
+    if(result->exact == FALSE)
+    {
+      printf("  bounds [%.4f%%, %.4f%%]", result->equityLow[playrNum] * 100.0,
+        result->equityHigh[playrNum] * 100.0);
+    }
+    puts("\n");
+  }
+}
+
+/*
+  Equity mode, the exact equity of every player of a partially known stud
+  board. Each positional argument holds one player's known cards. With
+  --shard i/N only shard i of N of the completions is enumerated and its
+  totals are written to a shard file for the merge mode.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runEquityMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * deadText = optionValue(argc, argv, "-d");
+  const char * toleranceText = optionValue(argc, argv, "-e");
+  const char * shardText = optionValue(argc, argv, "--shard");
+  const char * outputName = optionValue(argc, argv, "-o");
+  char defaultName[SHARD_NAME_SIZE];
+  studBoard board;
+  studEquity result;
+  checkpointConfig checkpoint;
+  shardHeader shard;
+  uint64_t shardNum = 0;
+  uint64_t numOfShards = 0;
+  double tolerance = NO_EARLY_EXIT;
+  double started = 0.0;
+  int numOfPlayers = collectPositionals(argc, argv, positionals);
+  int playrNum = NUM_INIT;
+
+  memset(& board, 0, sizeof(board));
+  if((numOfPlayers < MIN_PLAYERS) || (numOfPlayers > MAX_PLAYERS))
+  {
+    printf("Give the known cards of 1 to %d players\n", MAX_PLAYERS);
+    return MODE_FAILURE;
+  }
+  board.numOfPlayers = numOfPlayers;
+  for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+  {
+    board.numKnown[playrNum] = parseCardList(positionals[playrNum],
+      board.known[playrNum], CARDS_PER_HAND);
+    if(board.numKnown[playrNum] == INVALID_INT)
+    {
+      printf("Cannot read the cards of player %d: %s\n", playrNum + 1,
+        positionals[playrNum]);
+      return MODE_FAILURE;
+    }
+  }
+  if(deadText != NULL)
+  {
+    board.numDead = parseCardList(deadText, board.dead, STD_DECK_SIZE);
+    if(board.numDead == INVALID_INT)
+    {
+      printf("Cannot read the dead cards: %s\n", deadText);
+      return MODE_FAILURE;
+    }
+  }
+  if(toleranceText != NULL)
+  {
+    tolerance = atof(toleranceText);
+  }
+  if(checkpointOptions(argc, argv, & checkpoint) == FALSE)
+  {
+    return MODE_FAILURE;
+  }
+  if(((checkpoint.path != NULL) || (shardText != NULL)) &&
+    (toleranceText != NULL))
+  {
+    printf("Checkpoints and shards need the exact equity, leave out -e\n");
+    return MODE_FAILURE;
+  }
+  if(shardText != NULL)
+  {
+    if(parseShardSpec(shardText, & shardNum, & numOfShards) == FALSE)
+    {
+      printf("Give the shard as i/N, shard i of N from 1 to N: %s\n",
+        shardText);
+      return MODE_FAILURE;
+    }
+    if(outputName == NULL)
+    {
+      snprintf(defaultName, SHARD_NAME_SIZE, DEFAULT_SHARD_FILE,
+        (unsigned long long)shardNum + 1, (unsigned long long)numOfShards);
+      outputName = defaultName;
+    }
+  }
+
+  started = currentSeconds();
+  if(shardText != NULL)
+  {
+    if(shardStudEquity(& board, shardNum, numOfShards,
+      threadOption(argc, argv), (checkpoint.path != NULL) ? & checkpoint :
+      NULL, outputName, & shard, & result) == FALSE)
+    {
+      printf("Cannot enumerate shard %s, the board repeats a card or has "
+        "too many completions, or %s or the checkpoint cannot be "
+        "written\n", shardText, outputName);
+      return MODE_FAILURE;
+    }
+    printf("Shard %s holds completions %llu to %llu of %llu, written to "
+      "%s\n", shardText, (unsigned long long)shard.first,
+      (unsigned long long)shard.last, (unsigned long long)shard.numOfItems,
+      outputName);
+  }
+  else if(checkpoint.path != NULL)
+  {
+    if(checkpointStudEquity(& board, threadOption(argc, argv), & checkpoint,
+      & result) == FALSE)
+    {
+      printf("Cannot %s the checkpoint %s, or the board repeats a card or "
+        "has too many completions\n", (checkpoint.resume == TRUE) ?
+        "resume from" : "write", checkpoint.path);
+      return MODE_FAILURE;
+    }
+  }
+  else if(computeStudEquity(& board, tolerance, threadOption(argc, argv),
+    & result) == FALSE)
+  {
+    printf("The board repeats a card or has too many completions\n");
+    return MODE_FAILURE;
+  }
+  printf("Evaluated %llu of %llu completions in %.3f s (%s)\n",
+    (unsigned long long)result.evaluated,
+    (unsigned long long)result.completions, currentSeconds() - started,
+    (result.exact == TRUE) ? "exact" : "stopped early");
+  printStudEquity(& board, & result);
+  return MODE_SUCCESS;
+}
+
+/*
+  Merge mode, the exact equities of a stud board from the shard files of
+  its completions. Every argument is a shard file; the merge fails, naming
+  the shards to run again, unless they cover every completion once.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runMergeMode(int argc, const char * argv[])
+{
+  studBoard board;
+  studEquity result;
+  shardCoverage coverage;
+
+  if(argc < 1)
+  {
+    printf("Give the shard files to merge\n");
+    return MODE_FAILURE;
+  }
+  if(mergeStudEquity(argv, argc, & board, & result, & coverage) == TRUE)
+  {
+    printf("Merged %d shards, %llu completions (exact)\n", argc,
+      (unsigned long long)result.completions);
+    printStudEquity(& board, & result);
+    return MODE_SUCCESS;
+  }
+  switch(coverage.status)
+  {
+    case SHARDS_UNREADABLE:
+      if(coverage.first == INVALID_INT)
+      {
+        printf("Not enough memory for the shards\n");
+      }
+      else
+      {
+        printf("Cannot read the shard %s, or it is not a whole shard of "
+          "an equity enumeration\n", argv[coverage.first]);
+      }
+      break;
+    case SHARDS_MISMATCHED:
+      printf("The shards %s and %s are of different boards\n",
+        argv[coverage.first], argv[coverage.second]);
+      break;
+    case SHARDS_OVERLAPPING:
+      printf("The shards %s and %s overlap\n", argv[coverage.first],
+        argv[coverage.second]);
+      break;
+    default:
+      printf("Completions %llu to %llu are in no shard\n",
+        (unsigned long long)coverage.gapFirst,
+        (unsigned long long)coverage.gapLast);
+      break;
+  }
+  return MODE_FAILURE;
+}
+
+/*
+  Categories mode, the exact frequency of every hand rank over all five card
+  hands, found by evaluating one hand of each suit class and weighting it by
+  the size of its class.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runCategoriesMode(int argc, const char * argv[])
+{
+  const canonicalClass * classes = NULL;
+  unsigned long long counts[NUM_OF_HAND_RANKS];
+  unsigned char cards[CARDS_PER_HAND];
+  unsigned long long total = 0;
+  double started = currentSeconds();
+  double built = 0.0;
+  int numOfClasses = NUM_INIT;
+  int classNum = NUM_INIT;
+  int rankNum = NUM_INIT;
+
+  (void)argc;
+  (void)argv;
+  classes = canonicalFiveCardClasses(& numOfClasses);
+  if(classes == NULL)
+  {
+    printf("Not enough memory for the class list\n");
+    return MODE_FAILURE;
+  }
+  built = currentSeconds();
+  memset(counts, 0, sizeof(counts));
+  for(classNum = NUM_INIT; classNum < numOfClasses; classNum ++)
+  {
+    unrankHandIndices(classes[classNum].index, cards);
+    counts[strengthCategory(evaluateCardIndices(cards, CARDS_PER_HAND))] +=
+      classes[classNum].multiplicity;
+    total += classes[classNum].multiplicity;
+  }
+  printf("%d suit classes covering %llu hands (list built in %.3f s, "
+    "evaluated in %.3f s)\n", numOfClasses, total, built - started,
+    currentSeconds() - built);
+  for(rankNum = NUM_OF_HAND_RANKS - 1; rankNum >= 0; rankNum --)
+  {
+    printf("%-16s %9llu  %10.6f%%\n", handRanks[rankNum], counts[rankNum],
+      (double)counts[rankNum] * 100.0 / (double)total);
+  }
+  return MODE_SUCCESS;
+}
+
+/*
+  Snapshot handler of the simulate mode, a progress line on stderr.
+
+  Input   = {pokerStats *: stats, void *: argument}
+  Output  = {void: NULL}
+*/
+static void printSnapshot(const pokerStats * stats, void * argument)
+{
+  const simulationConfig * config = argument;
+  fprintf(stderr, "%llu of %llu tables dealt\n",
+    (unsigned long long)stats->tables,
+    (unsigned long long)config->numOfTables);
+}
+
+/*
+  Simulate mode, deals random tables on several threads and exports the
+  statistics of the tables as CSV or JSON. The statistics only depend on the
+  seed, not on the number of threads.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runSimulateMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * formatText = optionValue(argc, argv, "-f");
+  const char * seedText = optionValue(argc, argv, "-s");
+  const char * snapshotText = optionValue(argc, argv, "-i");
+  const char * outputName = optionValue(argc, argv, "-o");
+  simulationConfig config;
+  pokerTrace trace;
+  memoryReport memory;
+  pokerStats * stats = NULL;
+  statsFormat format = StatsCsv;
+  FILE * output = stdout;
+  double started = 0.0;
+  double seconds = 0.0;
+  int numOfPositionals = collectPositionals(argc, argv, positionals);
+  int argNum = NUM_INIT;
+  int status = MODE_SUCCESS;
+
+  memset(& config, 0, sizeof(config));
+  if(numOfPositionals != 2)
+  {
+    printf("Give the number of players and the number of tables\n");
+    return MODE_FAILURE;
+  }
+  config.numOfPlayers = atoi(positionals[0]);
+  config.numOfTables = strtoull(positionals[1], NULL, 10);
+  config.seed = (seedText != NULL) ? strtoull(seedText, NULL, 0) : 1;
+  config.numOfThreads = threadOption(argc, argv);
+  config.recordStats = TRUE;
+  for(argNum = NUM_INIT; argNum < argc; argNum ++)
+  {
+    if(strcmp(argv[argNum], "--no-stats") == 0)
+    {
+      config.recordStats = FALSE;
+    }
+  }
+  if(checkpointOptions(argc, argv, & config.checkpoint) == FALSE)
+  {
+    return MODE_FAILURE;
+  }
+  if((config.numOfPlayers < MIN_PLAYERS) ||
+    (config.numOfPlayers > MAX_PLAYERS))
+  {
+    printf("Give 1 to %d players\n", MAX_PLAYERS);
+    return MODE_FAILURE;
+  }
+  if((snapshotText != NULL) && (atof(snapshotText) > 0.0))
+  {
+    config.snapshotSeconds = atof(snapshotText);
+    config.snapshot = printSnapshot;
+    config.snapshotArgument = & config;
+  }
+  if((formatText != NULL) && (parseStatsFormat(formatText, & format) == FALSE))
+  {
+    printf("Unknown format %s, use csv, json or none\n", formatText);
+    return MODE_FAILURE;
+  }
+  if(traceOptions(argc, argv, config.numOfThreads, config.numOfTables,
+    & trace) == FALSE)
+  {
+    return MODE_FAILURE;
+  }
+  config.trace = (trace.buffers != NULL) ? & trace : NULL;
+  config.memory = & memory;
+  if(memoryOptions(argc, argv, & config.backing) == FALSE)
+  {
+    freeTrace(& trace);
+    return MODE_FAILURE;
+  }
+
+  stats = malloc(sizeof(pokerStats));
+  if(stats == NULL)
+  {
+    printf("Not enough memory for the statistics\n");
+    freeTrace(& trace);
+    return MODE_FAILURE;
+  }
+  started = currentSeconds();
+  if(runSimulation(& config, stats) == FALSE)
+  {
+    if(config.checkpoint.path != NULL)
+    {
+      printf("Cannot %s the checkpoint %s\n",
+        (config.checkpoint.resume == TRUE) ? "resume from" : "write",
+        config.checkpoint.path);
+    }
+    else
+    {
+      printf("Not enough memory for the simulation\n");
+    }
+    free(stats);
+    freeTrace(& trace);
+    return MODE_FAILURE;
+  }
+  seconds = currentSeconds() - started;
+  if(saveTrace(argc, argv, & trace) == FALSE)
+  {
+    status = MODE_FAILURE;
+  }
+  fprintf(stderr, "Dealt %llu tables of %d in %.3f s, %.2fM tables/s%s\n",
+    (unsigned long long)config.numOfTables, config.numOfPlayers, seconds,
+    (double)config.numOfTables / seconds / 1e6,
+    (config.recordStats == TRUE) ? "" : " without statistics");
+  printMemory(stderr, & memory);
+
+  if((config.recordStats == TRUE) && (format != StatsNone))
+  {
+    if(outputName != NULL)
+    {
+      output = fopen(outputName, "w");
+    }
+    if(writeStats(output, stats, config.numOfPlayers, format) == FALSE)
+    {
+      printf("Cannot write the statistics to %s\n",
+        (outputName != NULL) ? outputName : "stdout");
+      status = MODE_FAILURE;
+    }
+    if((outputName != NULL) && (output != NULL))
+    {
+      fclose(output);
+    }
+  }
+  free(stats);
+  return status;
+}
+
+/*
+  Shuffle benchmark mode, the single thread deck throughput of
+  shuffleCardIndices, one deck at a time, against the batch shuffle on its
+  scalar and AVX2 paths.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runShuffleBenchMode(int argc, const char * argv[])
+{
+  const char * decksText = optionValue(argc, argv, "-n");
+  const char * dealtText = optionValue(argc, argv, "-d");
+  const char * pathNames[] = {"scalar", "AVX2"};
+  unsigned char * decks = NULL;
+  unsigned char deck[STD_DECK_SIZE];
+  pokerRng rng;
+  batchRng lanes;
+  long numOfDecks = (decksText != NULL) ? atol(decksText) : 4000000;
+  int dealt = (dealtText != NULL) ? atoi(dealtText) : STD_DECK_SIZE;
+  int batchSize = 256;
+  long deckNum = 0;
+  double started = 0.0;
+  double singleSeconds = 0.0;
+  double batchSeconds = 0.0;
+  int pathNum = NUM_INIT;
+
+  if((numOfDecks < batchSize) || (dealt < 1) || (dealt > STD_DECK_SIZE))
+  {
+    printf("Give at least %d decks and 1 to %d dealt cards\n", batchSize,
+      STD_DECK_SIZE);
+    return MODE_FAILURE;
+  }
+  decks = malloc(batchSize * STD_DECK_SIZE);
+  if(decks == NULL)
+  {
+    printf("Not enough memory for the decks\n");
+    return MODE_FAILURE;
+  }
+  numOfDecks -= numOfDecks % batchSize;
+
+  seedRng(& rng, 1, 0);
+  initDeckBatch(deck, 1, STD_DECK_SIZE);
+  started = currentSeconds();
+  for(deckNum = 0; deckNum < numOfDecks; deckNum ++)
+  {
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE, dealt);
+  }
+  singleSeconds = currentSeconds() - started;
+  printf("%ld decks, %d cards dealt from each, %u checksum\n", numOfDecks,
+    dealt, deck[0]);
+  printf("  one deck at a time   %8.2fM decks/s\n",
+    numOfDecks / singleSeconds / 1e6);
+
+  for(pathNum = ShuffleScalar; pathNum <= ShuffleAvx2; pathNum ++)
+  {
+    if((pathNum == ShuffleAvx2) && (batchShufflePath() != ShuffleAvx2))
+    {
+      printf("  batch, AVX2          not supported by this processor\n");
+      continue;
+    }
+    seedBatchRng(& lanes, 1, 0);
+    initDeckBatch(decks, batchSize, STD_DECK_SIZE);
+    started = currentSeconds();
+    for(deckNum = 0; deckNum < numOfDecks; deckNum += batchSize)
+    {
+      shuffleDeckBatchOn(& lanes, decks, batchSize, STD_DECK_SIZE, dealt,
+        pathNum);
+    }
+    batchSeconds = currentSeconds() - started;
+    printf("  batch, %-6s        %8.2fM decks/s  %.2fx  %u checksum\n",
+      pathNames[pathNum], numOfDecks / batchSeconds / 1e6,
+      singleSeconds / batchSeconds, decks[0]);
+  }
+  free(decks);
+  return MODE_SUCCESS;
+}
+
+/*
+  Showdown benchmark mode, times the showdown of every number of players
+  on the generic path, evaluateCardIndices for every hand and findWinners,
+  against the kernel selected for that number, on the same dealt tables.
+  The paths take turns over several rounds and the fastest round of each
+  is kept, so a busy machine slows both alike.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runShowdownBenchMode(int argc, const char * argv[])
+{
+  const char * tablesText = optionValue(argc, argv, "-n");
+  const char * seedText = optionValue(argc, argv, "-s");
+  unsigned char * deals = NULL;
+  handStrength strengths[MAX_PLAYERS];
+  showdownKernel showdown = NULL;
+  pokerRng rng;
+  long numOfTables = (tablesText != NULL) ? atol(tablesText) : 1000000;
+  long tableNum = 0;
+  unsigned int genericSum = 0;
+  unsigned int kernelSum = 0;
+  const unsigned char * cards = NULL;
+  double started = 0.0;
+  double seconds = 0.0;
+  double genericSeconds = 0.0;
+  double kernelSeconds = 0.0;
+  int numOfPlayers = NUM_INIT;
+  int roundNum = NUM_INIT;
+  int playrNum = NUM_INIT;
+  int dealNum = NUM_INIT;
+  int status = MODE_SUCCESS;
+
+  if(numOfTables < SHOWDOWN_BENCH_DEALS)
+  {
+    printf("Give at least %d tables\n", SHOWDOWN_BENCH_DEALS);
+    return MODE_FAILURE;
+  }
+  deals = malloc(SHOWDOWN_BENCH_DEALS * STD_DECK_SIZE);
+  if(deals == NULL)
+  {
+    printf("Not enough memory for the deals\n");
+    return MODE_FAILURE;
+  }
+  /* The deals fit in the caches, so the showdowns are timed, not memory */
+  seedRng(& rng, (seedText != NULL) ? strtoull(seedText, NULL, 0) : 1, 0);
+  for(dealNum = NUM_INIT; dealNum < SHOWDOWN_BENCH_DEALS; dealNum ++)
+  {
+    initDeckBatch(deals + dealNum * STD_DECK_SIZE, 1, STD_DECK_SIZE);
+    shuffleCardIndices(& rng, deals + dealNum * STD_DECK_SIZE, STD_DECK_SIZE,
+      MAX_PLAYERS * CARDS_PER_HAND);
+  }
+
+  printf("%ld tables of each number of players\n", numOfTables);
+  printf("  players  generic M/s   kernel M/s   speedup\n");
+  for(numOfPlayers = 2; numOfPlayers <= MAX_PLAYERS; numOfPlayers ++)
+  {
+    showdown = selectShowdownKernel(numOfPlayers);
+    genericSeconds = HUGE_VAL;
+    kernelSeconds = HUGE_VAL;
+    for(roundNum = NUM_INIT; roundNum < SHOWDOWN_BENCH_ROUNDS; roundNum ++)
+    {
+      genericSum = 0;
+      started = currentSeconds();
+      for(tableNum = 0; tableNum < numOfTables; tableNum ++)
+      {
+        cards = deals + (tableNum % SHOWDOWN_BENCH_DEALS) * STD_DECK_SIZE;
+        for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+        {
+          strengths[playrNum] = evaluateCardIndices(
+            cards + playrNum * CARDS_PER_HAND, CARDS_PER_HAND);
+        }
+        genericSum += findWinners(strengths, numOfPlayers) * (tableNum | 1);
+      }
+      seconds = currentSeconds() - started;
+      genericSeconds = (seconds < genericSeconds) ? seconds : genericSeconds;
+      kernelSum = 0;
+      started = currentSeconds();
+      for(tableNum = 0; tableNum < numOfTables; tableNum ++)
+      {
+        cards = deals + (tableNum % SHOWDOWN_BENCH_DEALS) * STD_DECK_SIZE;
+        kernelSum += showdown(cards, strengths) * (tableNum | 1);
+      }
+      seconds = currentSeconds() - started;
+      kernelSeconds = (seconds < kernelSeconds) ? seconds : kernelSeconds;
+    }
+    printf("  %7d %12.2f %12.2f %8.2fx%s\n", numOfPlayers,
+      numOfTables / genericSeconds / 1e6, numOfTables / kernelSeconds / 1e6,
+      genericSeconds / kernelSeconds,
+      (kernelSum == genericSum) ? "" : "  winners differ");
+    status = (kernelSum == genericSum) ? status : MODE_FAILURE;
+  }
+  free(deals);
+  return status;
+}
+
+/*
+  Statistics benchmark mode, times the simulation of the same tables with
+  and without statistics. The two take turns over several rounds and the
+  fastest round of each is kept, so a busy machine slows both alike.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runStatsBenchMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * tablesText = optionValue(argc, argv, "-n");
+  const char * seedText = optionValue(argc, argv, "-s");
+  simulationConfig config;
+  pokerStats * stats = NULL;
+  double started = 0.0;
+  double seconds = 0.0;
+  double withSeconds = HUGE_VAL;
+  double withoutSeconds = HUGE_VAL;
+  int roundNum = NUM_INIT;
+  int pass = NUM_INIT;
+
+  memset(& config, 0, sizeof(config));
+  if(collectPositionals(argc, argv, positionals) != 1)
+  {
+    printf("Give the number of players\n");
+    return MODE_FAILURE;
+  }
+  config.numOfPlayers = atoi(positionals[0]);
+  config.numOfTables = (tablesText != NULL) ?
+    strtoull(tablesText, NULL, 10) : STATS_BENCH_TABLES;
+  config.seed = (seedText != NULL) ? strtoull(seedText, NULL, 0) : 1;
+  config.numOfThreads = threadOption(argc, argv);
+  if((config.numOfPlayers < MIN_PLAYERS) ||
+    (config.numOfPlayers > MAX_PLAYERS) || (config.numOfTables < 1))
+  {
+    printf("Give 1 to %d players and at least one table\n", MAX_PLAYERS);
+    return MODE_FAILURE;
+  }
+  stats = malloc(sizeof(pokerStats));
+  if(stats == NULL)
+  {
+    printf("Not enough memory for the statistics\n");
+    return MODE_FAILURE;
+  }
+
+  for(roundNum = NUM_INIT; roundNum < STATS_BENCH_ROUNDS; roundNum ++)
+  {
+    for(pass = 0; pass < 2; pass ++)
+    {
+      config.recordStats = (pass == 0) ? TRUE : FALSE;
+      started = currentSeconds();
+      if(runSimulation(& config, stats) == FALSE)
+      {
+        printf("Not enough memory for the simulation\n");
+        free(stats);
+        return MODE_FAILURE;
+      }
+      seconds = currentSeconds() - started;
+      if(pass == 0)
+      {
+        withSeconds = (seconds < withSeconds) ? seconds : withSeconds;
+      }
+      else
+      {
+        withoutSeconds = (seconds < withoutSeconds) ? seconds :
+          withoutSeconds;
+      }
+    }
+  }
+  free(stats);
+  printf("%llu tables of %d on %d threads, fastest of %d rounds\n",
+    (unsigned long long)config.numOfTables, config.numOfPlayers,
+    config.numOfThreads, STATS_BENCH_ROUNDS);
+  printf("  without statistics %8.2fM tables/s\n",
+    (double)config.numOfTables / withoutSeconds / 1e6);
+  printf("  with statistics    %8.2fM tables/s  %.3fx the time, %+.1f%%\n",
+    (double)config.numOfTables / withSeconds / 1e6,
+    withSeconds / withoutSeconds, 100.0 * (withSeconds / withoutSeconds -
+    1.0));
+  return MODE_SUCCESS;
+}
+
+/*
+  Function to print the cards of a hand a draw option holds.
+
+  Input   = {unsigned char *: hand, int: held}
+  Output  = {void: NULL}
+*/
+static void printHeldCards(const unsigned char * hand, int held)
+{
+  int cardNum = NUM_INIT;
+  if(held == 0)
+  {
+    printf("nothing  ");
+  }
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    if((held >> cardNum) & 1)
+    {
+      printCardIndex(hand[cardNum]);
+      printf("  ");
+    }
+  }
+}
+
+/*
+  Draw mode, five card draw. Every hand, given or dealt, is solved for its
+  best discard, and dealt tables then draw their replacements from the rest
+  of the deck and go to showdown.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runDrawMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * seedText = optionValue(argc, argv, "-s");
+  const char * objectiveText = optionValue(argc, argv, "-o");
+  const char * optionsText = optionValue(argc, argv, "-k");
+  unsigned char hands[MAX_PLAYERS][CARDS_PER_HAND];
+  unsigned char deck[STD_DECK_SIZE];
+  drawSolution solutions[MAX_PLAYERS];
+  handStrength strengths[MAX_PLAYERS];
+  int order[NUM_OF_DRAW_OPTIONS];
+  drawObjective objective = DrawForStrength;
+  pokerRng rng;
+  const drawOption * option = NULL;
+  double started = 0.0;
+  double prepared = 0.0;
+  double solved = 0.0;
+  unsigned long long improved = 0;
+  unsigned int winners = 0;
+  int numOfPositionals = collectPositionals(argc, argv, positionals);
+  int numOfThreads = threadOption(argc, argv);
+  int numOfShown = (optionsText != NULL) ? atoi(optionsText) : 3;
+  int numOfPlayers = NUM_INIT;
+  int nextCard = NUM_INIT;
+  int dealt = FALSE;
+  int playrNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+  int optionNum = NUM_INIT;
+  int later = NUM_INIT;
+  int rankNum = NUM_INIT;
+
+  if((objectiveText != NULL) && (strcmp(objectiveText, "category") == 0))
+  {
+    objective = DrawForCategory;
+  }
+  else if((objectiveText != NULL) && (strcmp(objectiveText, "strength") != 0))
+  {
+    printf("Unknown objective %s, use strength or category\n", objectiveText);
+    return MODE_FAILURE;
+  }
+  if((numOfShown < 1) || (numOfShown > NUM_OF_DRAW_OPTIONS))
+  {
+    numOfShown = NUM_OF_DRAW_OPTIONS;
+  }
+  if((numOfPositionals == 1) && (strlen(positionals[0]) <= 2))
+  {
+    /* A number of players, deal them a table */
+    dealt = TRUE;
+    numOfPlayers = atoi(positionals[0]);
+    if((numOfPlayers < MIN_PLAYERS) || (numOfPlayers > MAX_PLAYERS))
+    {
+      printf("Give 1 to %d players\n", MAX_PLAYERS);
+      return MODE_FAILURE;
+    }
+    seedRng(& rng, (seedText != NULL) ? strtoull(seedText, NULL, 0) :
+      (uint64_t)time(NULL), 0);
+    initDeckBatch(deck, 1, STD_DECK_SIZE);
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE, STD_DECK_SIZE);
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      memcpy(hands[playrNum], deck + nextCard, CARDS_PER_HAND);
+      nextCard += CARDS_PER_HAND;
+    }
+  }
+  else
+  {
+    numOfPlayers = numOfPositionals;
+    if((numOfPlayers < MIN_PLAYERS) || (numOfPlayers > MAX_PLAYERS))
+    {
+      printf("Give a number of players or 1 to %d hands\n", MAX_PLAYERS);
+      return MODE_FAILURE;
+    }
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      if(parseCardList(positionals[playrNum], hands[playrNum],
+        CARDS_PER_HAND) != CARDS_PER_HAND)
+      {
+        printf("Cannot read five cards for player %d: %s\n", playrNum + 1,
+          positionals[playrNum]);
+        return MODE_FAILURE;
+      }
+    }
+  }
+
+  started = currentSeconds();
+  if(prepareDrawSolver(numOfThreads) == FALSE)
+  {
+    printf("Not enough memory for the draw tables\n");
+    return MODE_FAILURE;
+  }
+  prepared = currentSeconds();
+  if(solveDrawTable((const unsigned char (*)[CARDS_PER_HAND])hands,
+    numOfPlayers, objective, numOfThreads, solutions) == FALSE)
+  {
+    printf("The hands repeat a card\n");
+    return MODE_FAILURE;
+  }
+  solved = currentSeconds();
+  printf("Tables built in %.3f s, %d hands solved in %.3f ms\n\n",
+    prepared - started, numOfPlayers, (solved - prepared) * 1e3);
+
+  for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+  {
+    /* Options from best to worst by the objective */
+    for(optionNum = NUM_INIT; optionNum < NUM_OF_DRAW_OPTIONS; optionNum ++)
+    {
+      order[optionNum] = optionNum;
+    }
+    for(optionNum = 1; optionNum < NUM_OF_DRAW_OPTIONS; optionNum ++)
+    {
+      for(later = optionNum; later > 0; later --)
+      {
+        const drawOption * first = & solutions[playrNum].options[order[later - 1]];
+        const drawOption * second = & solutions[playrNum].options[order[later]];
+        double firstScore = (objective == DrawForCategory) ?
+          first->expectedCategory : first->expectedStrength;
+        double secondScore = (objective == DrawForCategory) ?
+          second->expectedCategory : second->expectedStrength;
+        if(secondScore <= firstScore)
+        {
+          break;
+        }
+        cardNum = order[later];
+        order[later] = order[later - 1];
+        order[later - 1] = cardNum;
+      }
+    }
+    printf("Player %d] - ", playrNum + 1);
+    printCardIndices(hands[playrNum], CARDS_PER_HAND);
+    printf("\n");
+    for(optionNum = NUM_INIT; optionNum < numOfShown; optionNum ++)
+    {
+      option = & solutions[playrNum].options[order[optionNum]];
+      printf("  %s hold ", (option->held == solutions[playrNum].best) ?
+        "*" : " ");
+      printHeldCards(hands[playrNum], option->held);
+      improved = 0;
+      for(rankNum = strengthCategory(evaluateCardIndices(hands[playrNum],
+        CARDS_PER_HAND)) + 1; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+      {
+        improved += option->categoryCounts[rankNum];
+      }
+      printf("- strength %.4f  category %.4f  improves %.2f%%\n",
+        option->expectedStrength, option->expectedCategory,
+        (double)improved * 100.0 / (double)option->outcomes);
+    }
+  }
+
+  if(dealt == TRUE)
+  {
+    /* Replace every discard from the rest of the deck, seat by seat */
+    printf("\nAfter the draw:\n");
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        if((((solutions[playrNum].best >> cardNum) & 1) == 0) &&
+          (nextCard < STD_DECK_SIZE))
+        {
+          hands[playrNum][cardNum] = deck[nextCard ++];
+        }
+      }
+      strengths[playrNum] = evaluateCardIndices(hands[playrNum],
+        CARDS_PER_HAND);
+    }
+    winners = findWinners(strengths, numOfPlayers);
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      printf("Player %d] - ", playrNum + 1);
+      printCardIndices(hands[playrNum], CARDS_PER_HAND);
+      printf("- %-16s%s\n", handRanks[strengthCategory(strengths[playrNum])],
+        ((winners >> playrNum) & 1) ? "  wins" : "");
+    }
+  }
+  return MODE_SUCCESS;
+}
+
+/* Hands of seven card stud dealt from one generator stream */
+#define STUD_HANDS_PER_BATCH 4096
+
+/* Tallies of the stud simulation, one per thread */
+typedef struct studTally
+{
+  uint64_t hands;
+  uint64_t communityHands;
+  uint64_t splitPots;
+  uint64_t winningRanks[NUM_OF_HAND_RANKS];
+  char padding[CACHE_LINE_SIZE];
+} studTally;
+
+/* State shared by the threads of the stud simulation */
+typedef struct studContext
+{
+  int numOfPlayers;
+  uint64_t seed;
+  uint64_t numOfHands;
+  uint64_t numOfBatches;
+  atomic_ullong nextBatch;
+  studTally tallies[MAX_THREADS];
+} studContext;
+
+/*
+  Function run by each thread of the stud simulation, playing batches of
+  hands on a table of its own.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void studWorker(void * argument, int threadNum)
+{
+  studContext * context = argument;
+  studTally * tally = & context->tallies[threadNum];
+  studTable table;
+  handStrength strengths[MAX_STUD_PLAYERS];
+  uint64_t batchNum = 0;
+  uint64_t handNum = 0;
+  uint64_t numOfHands = 0;
+  unsigned int winners = 0;
+
+  while((batchNum = atomic_fetch_add(& context->nextBatch, 1)) <
+    context->numOfBatches)
+  {
+    initStudTable(& table, context->numOfPlayers, context->seed, batchNum);
+    numOfHands = STUD_HANDS_PER_BATCH;
+    if(batchNum == context->numOfBatches - 1)
+    {
+      numOfHands = context->numOfHands - batchNum * STUD_HANDS_PER_BATCH;
+    }
+    for(handNum = 0; handNum < numOfHands; handNum ++)
+    {
+      winners = playStudHand(& table, strengths);
+      tally->hands ++;
+      tally->communityHands += (table.communityCard != NO_COMMUNITY_CARD);
+      tally->splitPots += ((winners & (winners - 1)) != 0);
+      tally->winningRanks[strengthCategory(
+        strengths[__builtin_ctz(winners)])] ++;
+    }
+  }
+}
+
+/*
+  Seven card stud mode. Without -n one hand is played street by street with
+  the table shown as the players see it; with -n that many hands are played
+  to showdown on several threads and the winning hands are counted.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runStudMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * seedText = optionValue(argc, argv, "-s");
+  const char * handsText = optionValue(argc, argv, "-n");
+  studContext * context = NULL;
+  studTally total;
+  studTable table;
+  handStrength strengths[MAX_STUD_PLAYERS];
+  uint64_t seed = 0;
+  unsigned int winners = 0;
+  double started = 0.0;
+  double seconds = 0.0;
+  int numOfPlayers = NUM_INIT;
+  int numOfThreads = NUM_INIT;
+  int threadNum = NUM_INIT;
+  int rankNum = NUM_INIT;
+  int seat = NUM_INIT;
+
+  if(collectPositionals(argc, argv, positionals) != 1)
+  {
+    printf("Give the number of players\n");
+    return MODE_FAILURE;
+  }
+  numOfPlayers = atoi(positionals[0]);
+  seed = (seedText != NULL) ? strtoull(seedText, NULL, 0) :
+    (uint64_t)time(NULL);
+  if(initStudTable(& table, numOfPlayers, seed, 0) == FALSE)
+  {
+    printf("Give 1 to %d players\n", MAX_STUD_PLAYERS);
+    return MODE_FAILURE;
+  }
+
+  if(handsText == NULL)
+  {
+    startStudHand(& table);
+    printStudTable(& table, FALSE);
+    while(dealStudStreet(& table) == TRUE)
+    {
+      printStudTable(& table, FALSE);
+    }
+    winners = studShowdown(& table, strengths);
+    printf("Showdown:\n");
+    for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+    {
+      printf("Seat %d] - ", seat + 1);
+      printCardIndices(table.cards[seat], table.numOfCards);
+      printf("- %-16s%s\n", handRanks[strengthCategory(strengths[seat])],
+        ((winners >> seat) & 1) ? "  wins" : "");
+    }
+    return MODE_SUCCESS;
+  }
+
+  context = calloc(1, sizeof(studContext));
+  if(context == NULL)
+  {
+    printf("Not enough memory for the simulation\n");
+    return MODE_FAILURE;
+  }
+  context->numOfPlayers = numOfPlayers;
+  context->seed = seed;
+  context->numOfHands = strtoull(handsText, NULL, 10);
+  context->numOfBatches = (context->numOfHands + STUD_HANDS_PER_BATCH - 1) /
+    STUD_HANDS_PER_BATCH;
+  atomic_init(& context->nextBatch, 0);
+  started = currentSeconds();
+  numOfThreads = runParallel(threadOption(argc, argv), studWorker, context);
+  seconds = currentSeconds() - started;
+
+  memset(& total, 0, sizeof(total));
+  for(threadNum = NUM_INIT; threadNum < numOfThreads; threadNum ++)
+  {
+    total.hands += context->tallies[threadNum].hands;
+    total.communityHands += context->tallies[threadNum].communityHands;
+    total.splitPots += context->tallies[threadNum].splitPots;
+    for(rankNum = NUM_INIT; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+    {
+      total.winningRanks[rankNum] +=
+        context->tallies[threadNum].winningRanks[rankNum];
+    }
+  }
+  free(context);
+  printf("Played %llu hands of %d players on %d threads in %.3f s, "
+    "%.2fM hands/s\n", (unsigned long long)total.hands, numOfPlayers,
+    numOfThreads, seconds, (double)total.hands / seconds / 1e6);
+  printf("Community card on seventh street %.4f%%, split pots %.4f%%\n",
+    (double)total.communityHands * 100.0 / (double)total.hands,
+    (double)total.splitPots * 100.0 / (double)total.hands);
+  printf("Winning hands:\n");
+  for(rankNum = NUM_OF_HAND_RANKS - 1; rankNum >= 0; rankNum --)
+  {
+    printf("%-16s %10.6f%%\n", handRanks[rankNum],
+      (double)total.winningRanks[rankNum] * 100.0 / (double)total.hands);
+  }
+  return MODE_SUCCESS;
+}
+
+/*
+  Rare hand mode. One seat is dealt a hand drawn uniformly from every hand
+  of a rank, optionally with a given lead card, and the other seats are dealt
+  from the rest of the deck. Without -n one table is shown; with -n that many
+  are played and the seat's results are given both for the sampled tables and,
+  through the importance weight, for real deals.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runRareMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * seedText = optionValue(argc, argv, "-s");
+  const char * tablesText = optionValue(argc, argv, "-n");
+  const char * leadText = optionValue(argc, argv, "-l");
+  const char * seatText = optionValue(argc, argv, "-p");
+  const char * valueNames = "23456789TJQKA";
+  const char * leadName = NULL;
+  unsigned char deck[STD_DECK_SIZE];
+  handStrength strengths[MAX_PLAYERS];
+  rareSampler sampler;
+  pokerRng rng;
+  uint64_t seed = 0;
+  unsigned long long numOfTables = 0;
+  unsigned long long tableNum = 0;
+  unsigned long long wins = 0;
+  unsigned long long ties = 0;
+  unsigned int winners = 0;
+  double started = 0.0;
+  double seconds = 0.0;
+  int category = INVALID_INT;
+  int leadValue = ANY_LEAD_VALUE;
+  int seat = NUM_INIT;
+  int numOfPlayers = NUM_INIT;
+  int playrNum = NUM_INIT;
+
+  if(collectPositionals(argc, argv, positionals) != 2)
+  {
+    printf("Give a hand rank and the number of players\n");
+    return MODE_FAILURE;
+  }
+  category = parseHandRank(positionals[0]);
+  numOfPlayers = atoi(positionals[1]);
+  seat = (seatText != NULL) ? atoi(seatText) - 1 : 0;
+  if(leadText != NULL)
+  {
+    leadName = (leadText[0] != '\0') ?
+      strchr(valueNames, toupper((unsigned char)leadText[0])) : NULL;
+    leadValue = (leadName != NULL) ? leadName - valueNames : INVALID_INT - 1;
+  }
+  if((category == INVALID_INT) || (numOfPlayers < MIN_PLAYERS) ||
+    (numOfPlayers > MAX_PLAYERS) || (seat < 0) || (seat >= numOfPlayers) ||
+    (leadValue < ANY_LEAD_VALUE))
+  {
+    printf("Give a hand rank by name or 0 to 8, %d to %d players, a seat "
+      "among them and a lead card from 2 to A\n", MIN_PLAYERS, MAX_PLAYERS);
+    return MODE_FAILURE;
+  }
+  if(initRareSampler(& sampler, category, leadValue, seat, numOfPlayers) ==
+    FALSE)
+  {
+    printf("No %s has that lead card\n", handRanks[category]);
+    return MODE_FAILURE;
+  }
+  seed = (seedText != NULL) ? strtoull(seedText, NULL, 0) :
+    (uint64_t)time(NULL);
+  seedRng(& rng, seed, 0);
+  printf("%s", handRanks[category]);
+  if(leadValue != ANY_LEAD_VALUE)
+  {
+    printf(" led by %c", valueNames[leadValue]);
+  }
+  printf(" for seat %d: %u of %d hands, weight %.6e\n", seat + 1,
+    sampler.numOfHands, NUM_OF_FIVE_CARD_HANDS, sampler.weight);
+
+  if(tablesText == NULL)
+  {
+    sampleRareTable(& sampler, & rng, deck);
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      strengths[playrNum] = evaluateCardIndices(
+        deck + playrNum * CARDS_PER_HAND, CARDS_PER_HAND);
+    }
+    winners = findWinners(strengths, numOfPlayers);
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      printf("Seat %d] - ", playrNum + 1);
+      printCardIndices(deck + playrNum * CARDS_PER_HAND, CARDS_PER_HAND);
+      printf("- %-16s%s\n", handRanks[strengthCategory(strengths[playrNum])],
+        ((winners >> playrNum) & 1) ? "  wins" : "");
+    }
+    return MODE_SUCCESS;
+  }
+
+  numOfTables = strtoull(tablesText, NULL, 10);
+  started = currentSeconds();
+  for(tableNum = 0; tableNum < numOfTables; tableNum ++)
+  {
+    sampleRareTable(& sampler, & rng, deck);
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      strengths[playrNum] = evaluateCardIndices(
+        deck + playrNum * CARDS_PER_HAND, CARDS_PER_HAND);
+    }
+    winners = findWinners(strengths, numOfPlayers);
+    wins += (winners == (1u << seat));
+    ties += ((winners >> seat) & 1) && (winners != (1u << seat));
+  }
+  seconds = currentSeconds() - started;
+  printf("Sampled %llu tables of %d players in %.3f s, %.2fM tables/s\n",
+    numOfTables, numOfPlayers, seconds, numOfTables / seconds / 1e6);
+  printf("Sampled tables:  seat %d wins %10.6f%%, ties %10.6f%%\n",
+    seat + 1, wins * 100.0 / numOfTables, ties * 100.0 / numOfTables);
+  printf("Real deals:      seat %d holds it %.6e, wins with it %.6e, "
+    "ties with it %.6e\n", seat + 1, sampler.weight,
+    sampler.weight * wins / numOfTables, sampler.weight * ties / numOfTables);
+  return MODE_SUCCESS;
+}
+
+/*
+  Function to print the metrics of one pipeline stage thread.
+
+  Input   = {char *: name, int: threadNum, stageMetrics *: metrics}
+  Output  = {void: NULL}
+*/
+static void printStageMetrics(const char * name, int threadNum,
+  const stageMetrics * metrics)
+{
+  const double busy = metrics->seconds - metrics->starved -
+    metrics->heldBack;
+  fprintf(stderr, "  %-9s %2d  %10llu tables  %8.2fM tables/s  "
+    "busy %5.1f%%  starved %5.1f%%  held back %5.1f%%  depth %.2f (max %u)\n",
+    name, threadNum, (unsigned long long)metrics->tables,
+    (busy > 0.0) ? (double)metrics->tables / busy / 1e6 : 0.0,
+    100.0 * busy / metrics->seconds, 100.0 * metrics->starved /
+    metrics->seconds, 100.0 * metrics->heldBack / metrics->seconds,
+    (metrics->depthSamples > 0) ? (double)metrics->depthSum /
+    (double)metrics->depthSamples : 0.0, metrics->maxDepth);
+}
+
+/*
+  Pipeline mode, deals tables through producer, evaluator and writer threads
+  connected by rings and reports where each stage spends its time. The
+  tables are the ones --simulate deals for the same seed.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runPipelineMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * seedText = optionValue(argc, argv, "-s");
+  const char * producersText = optionValue(argc, argv, "-p");
+  const char * evaluatorsText = optionValue(argc, argv, "-e");
+  const char * formatText = optionValue(argc, argv, "-f");
+  const char * outputName = optionValue(argc, argv, "-o");
+  const int numOfThreads = threadOption(argc, argv);
+  pipelineConfig config;
+  pokerTrace trace;
+  pipelineReport * report = NULL;
+  int numOfPositionals = collectPositionals(argc, argv, positionals);
+  int threadNum = NUM_INIT;
+  int status = MODE_SUCCESS;
+
+  memset(& config, 0, sizeof(config));
+  if(numOfPositionals != 2)
+  {
+    printf("Give the number of players and the number of tables\n");
+    return MODE_FAILURE;
+  }
+  config.numOfPlayers = atoi(positionals[0]);
+  config.numOfTables = strtoull(positionals[1], NULL, 10);
+  config.seed = (seedText != NULL) ? strtoull(seedText, NULL, 0) : 1;
+  /* By default the threads besides the writer are split between the other
+     two stages, evaluators first since ranking costs more than dealing */
+  config.numOfEvaluators = (evaluatorsText != NULL) ? atoi(evaluatorsText) :
+    numOfThreads / 2;
+  config.numOfProducers = (producersText != NULL) ? atoi(producersText) :
+    numOfThreads - 1 - config.numOfEvaluators;
+  config.numOfEvaluators = (config.numOfEvaluators < 1) ? 1 :
+    config.numOfEvaluators;
+  config.numOfProducers = (config.numOfProducers < 1) ? 1 :
+    config.numOfProducers;
+  config.format = DealText;
+  if(formatText != NULL)
+  {
+    if(strcmp(formatText, "text") == 0)
+    {
+      config.format = DealText;
+    }
+    else if(strcmp(formatText, "binary") == 0)
+    {
+      config.format = DealBinary;
+    }
+    else if(strcmp(formatText, "none") == 0)
+    {
+      config.format = DealNone;
+    }
+    else
+    {
+      printf("Unknown format %s, use text, binary or none\n", formatText);
+      return MODE_FAILURE;
+    }
+  }
+  if((config.numOfPlayers < MIN_PLAYERS) ||
+    (config.numOfPlayers > MAX_PLAYERS))
+  {
+    printf("Give 1 to %d players\n", MAX_PLAYERS);
+    return MODE_FAILURE;
+  }
+  if((config.numOfProducers > MAX_STAGE_THREADS) ||
+    (config.numOfEvaluators > MAX_STAGE_THREADS))
+  {
+    printf("Give 1 to %d producers and evaluators\n", MAX_STAGE_THREADS);
+    return MODE_FAILURE;
+  }
+  if(traceOptions(argc, argv, 1 + config.numOfProducers +
+    config.numOfEvaluators, config.numOfTables, & trace) == FALSE)
+  {
+    return MODE_FAILURE;
+  }
+  config.trace = (trace.buffers != NULL) ? & trace : NULL;
+  if(memoryOptions(argc, argv, & config.backing) == FALSE)
+  {
+    freeTrace(& trace);
+    return MODE_FAILURE;
+  }
+
+  config.output = stdout;
+  if((outputName != NULL) && (config.format != DealNone))
+  {
+    config.output = fopen(outputName, (config.format == DealBinary) ?
+      "wb" : "w");
+    if(config.output == NULL)
+    {
+      printf("Cannot open %s\n", outputName);
+      freeTrace(& trace);
+      return MODE_FAILURE;
+    }
+  }
+  report = malloc(sizeof(pipelineReport));
+  if((report == NULL) || (runPipeline(& config, report) == FALSE))
+  {
+    printf("Not enough memory or threads for the pipeline\n");
+    status = MODE_FAILURE;
+  }
+  else
+  {
+    if(report->written == FALSE)
+    {
+      printf("Cannot write the tables to %s\n",
+        (outputName != NULL) ? outputName : "stdout");
+      status = MODE_FAILURE;
+    }
+    fprintf(stderr, "Dealt %llu tables of %d in %.3f s, %.2fM tables/s with "
+      "%d producers and %d evaluators\n",
+      (unsigned long long)config.numOfTables, config.numOfPlayers,
+      report->seconds, (double)config.numOfTables / report->seconds / 1e6,
+      config.numOfProducers, config.numOfEvaluators);
+    for(threadNum = NUM_INIT; threadNum < config.numOfProducers; threadNum ++)
+    {
+      printStageMetrics("producer", threadNum, & report->producers[threadNum]);
+    }
+    for(threadNum = NUM_INIT; threadNum < config.numOfEvaluators;
+      threadNum ++)
+    {
+      printStageMetrics("evaluator", threadNum,
+        & report->evaluators[threadNum]);
+    }
+    printStageMetrics("writer", 0, & report->writer);
+    printMemory(stderr, & report->memory);
+    if(saveTrace(argc, argv, & trace) == FALSE)
+    {
+      status = MODE_FAILURE;
+    }
+  }
+  if(config.output != stdout)
+  {
+    fclose(config.output);
+  }
+  freeTrace(& trace);
+  free(report);
+  return status;
+}
+
+/*
+  Index mode, builds the bitmap index of a binary deal file written by
+  --pipeline.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runIndexMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * indexName = optionValue(argc, argv, "-o");
+  char defaultName[FILENAME_MAX];
+  uint64_t numIndexed = 0;
+  double started = 0.0;
+
+  if(collectPositionals(argc, argv, positionals) != 1)
+  {
+    printf("Give the deal file to index\n");
+    return MODE_FAILURE;
+  }
+  if(indexName == NULL)
+  {
+    snprintf(defaultName, sizeof(defaultName), "%s.idx", positionals[0]);
+    indexName = defaultName;
+  }
+  started = currentSeconds();
+  if(buildHistoryIndex(positionals[0], indexName, & numIndexed) == FALSE)
+  {
+    printf("Cannot index %s into %s\n", positionals[0], indexName);
+    return MODE_FAILURE;
+  }
+  printf("Indexed %llu deals into %s in %.3f s\n",
+    (unsigned long long)numIndexed, indexName, currentSeconds() - started);
+  return MODE_SUCCESS;
+}
+
+/*
+  Query mode, counts or lists the deals of an index matching a query.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runQueryMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * limitText = optionValue(argc, argv, "-l");
+  historyIndex index;
+  roaringBitmap result;
+  uint32_t * ids = NULL;
+  uint64_t limit = (limitText != NULL) ? strtoull(limitText, NULL, 10) : 0;
+  uint64_t numOfIds = 0;
+  uint64_t idNum = 0;
+  uint64_t count = 0;
+  double started = 0.0;
+  int errorAt = INVALID_INT;
+  int argNum = NUM_INIT;
+
+  if(collectPositionals(argc, argv, positionals) != 2)
+  {
+    printf("Give the index and the query\n");
+    return MODE_FAILURE;
+  }
+  for(argNum = NUM_INIT; argNum < argc; argNum ++)
+  {
+    if((strcmp(argv[argNum], "--ids") == 0) && (limitText == NULL))
+    {
+      limit = UINT64_MAX;
+    }
+  }
+  if(openHistoryIndex(& index, positionals[0]) == FALSE)
+  {
+    printf("Cannot open the index %s\n", positionals[0]);
+    return MODE_FAILURE;
+  }
+  started = currentSeconds();
+  if(queryHistoryIndex(& index, positionals[1], & result, & errorAt) ==
+    FALSE)
+  {
+    printf("Cannot read the query from position %d: %s\n", errorAt + 1,
+      positionals[1] + errorAt);
+    closeHistoryIndex(& index);
+    return MODE_FAILURE;
+  }
+  count = bitmapCardinality(& result);
+  printf("%llu of %llu deals match in %.3f ms\n", (unsigned long long)count,
+    (unsigned long long)index.header->numOfTables,
+    (currentSeconds() - started) * 1e3);
+  limit = (limit < count) ? limit : count;
+  ids = (limit > 0) ? malloc(sizeof(uint32_t) * limit) : NULL;
+  if(ids != NULL)
+  {
+    numOfIds = bitmapIds(& result, ids, limit);
+    for(idNum = 0; idNum < numOfIds; idNum ++)
+    {
+      printf("%u\n", ids[idNum]);
+    }
+    free(ids);
+  }
+  freeBitmap(& result);
+  closeHistoryIndex(& index);
+  return MODE_SUCCESS;
+}
+
+/*
+  Function to list the shuffles an audit can test.
+
+  Input   = {void: NULL}
+  Output  = {void: NULL}
+*/
+static void printShufflePlugins(void)
+{
+  int numOfPlugins = NUM_INIT;
+  const shufflePlugin * plugins = listShufflePlugins(& numOfPlugins);
+  int pluginNum = NUM_INIT;
+
+  printf("The shuffles are:\n");
+  for(pluginNum = NUM_INIT; pluginNum < numOfPlugins; pluginNum ++)
+  {
+    printf("  %-13s %s\n", plugins[pluginNum].name,
+      plugins[pluginNum].summary);
+  }
+}
+
+/*
+  Audit mode, shuffles a number of decks with one of the shuffle plugins on
+  every core and reports the goodness of fit tests of the permutations.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runAuditMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * decksText = optionValue(argc, argv, "-n");
+  const char * seedText = optionValue(argc, argv, "-s");
+  const char * alphaText = optionValue(argc, argv, "-a");
+  const char * name = "fisher-yates";
+  auditConfig config;
+  auditReport report;
+  const auditTest * test = NULL;
+  int numOfPositionals = collectPositionals(argc, argv, positionals);
+  int testNum = NUM_INIT;
+
+  if(numOfPositionals > 1)
+  {
+    printf("Give at most one shuffle to audit\n");
+    return MODE_FAILURE;
+  }
+  if(numOfPositionals == 1)
+  {
+    name = positionals[0];
+  }
+  config.plugin = findShufflePlugin(name);
+  config.numOfDecks = (decksText != NULL) ? strtoull(decksText, NULL, 10) :
+    10000000;
+  config.seed = (seedText != NULL) ? strtoull(seedText, NULL, 10) : 1;
+  config.numOfThreads = threadOption(argc, argv);
+  config.alpha = (alphaText != NULL) ? atof(alphaText) : DEFAULT_AUDIT_ALPHA;
+  if(config.plugin == NULL)
+  {
+    printf("Unknown shuffle %s. ", name);
+    printShufflePlugins();
+    return MODE_FAILURE;
+  }
+  if((config.numOfDecks < 1) || (config.alpha <= 0.0) ||
+    (config.alpha >= 0.5))
+  {
+    printf("Give at least 1 deck and a significance between 0 and 0.5\n");
+    return MODE_FAILURE;
+  }
+  if(auditShuffle(& config, & report) == FALSE)
+  {
+    printf("Not enough memory for the audit counts\n");
+    return MODE_FAILURE;
+  }
+
+  printf("Audit of %s, %llu decks on %d threads in %.3f s, "
+    "%.2fM decks/s\n", config.plugin->name,
+    (unsigned long long)report.numOfDecks, report.numOfThreads,
+    report.seconds, report.numOfDecks / report.seconds / 1e6);
+  printf("Prefixes of %d cards, each test failing at p < %g\n",
+    report.prefixLength, config.alpha);
+  printf("  %-27s %14s %9s %11s\n", "test", "statistic", "df/cells",
+    "p-value");
+  for(testNum = NUM_INIT; testNum < NUM_AUDIT_TESTS; testNum ++)
+  {
+    test = & report.tests[testNum];
+    printf("  %-27s %14.2f %9.0f %11.3g %s\n", test->name, test->statistic,
+      test->degrees, test->pValue, test->passed == TRUE ? "PASS" : "FAIL");
+  }
+  printf("%s\n", report.passed == TRUE ? "PASS" : "FAIL");
+  return report.passed == TRUE ? MODE_SUCCESS : MODE_FAILURE;
+}
+
+/*
+  Removal mode, the chances of each category for the five card hand of an
+  opponent once some cards have been seen, and the time one answer takes.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runRemovalMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  unsigned char seen[STD_DECK_SIZE];
+  removalOdds odds;
+  int numOfPositionals = collectPositionals(argc, argv, positionals);
+  int numOfSeen = NUM_INIT;
+  int repeatNum = NUM_INIT;
+  int category = NUM_INIT;
+  const int numOfRepeats = 1000000;
+  double started = 0.0;
+  double seconds = 0.0;
+
+  if(numOfPositionals > 1)
+  {
+    printf("Give the seen cards as one list\n");
+    return MODE_FAILURE;
+  }
+  if(numOfPositionals == 1)
+  {
+    numOfSeen = parseCardList(positionals[0], seen, STD_DECK_SIZE);
+  }
+  if((numOfSeen == INVALID_INT) ||
+    (cardRemovalOdds(seen, numOfSeen, & odds) == FALSE))
+  {
+    printf("Cannot read the seen cards, or a card repeats or fewer than "
+      "%d are unseen\n", CARDS_PER_HAND);
+    return MODE_FAILURE;
+  }
+  started = currentSeconds();
+  for(repeatNum = NUM_INIT; repeatNum < numOfRepeats; repeatNum ++)
+  {
+    cardRemovalOdds(seen, numOfSeen, & odds);
+  }
+  seconds = currentSeconds() - started;
+
+  printf("%d cards seen, %llu hands of the %d unseen, %.0f ns each\n",
+    numOfSeen, (unsigned long long)odds.numOfHands, odds.numOfUnseen,
+    seconds * 1e9 / numOfRepeats);
+  for(category = NUM_OF_HAND_RANKS - 1; category >= HighCard; category --)
+  {
+    printf("  %-16s %10llu %10.6f%%\n", handRanks[category],
+      (unsigned long long)odds.counts[category],
+      odds.probabilities[category] * 100.0);
+  }
+  return MODE_SUCCESS;
+}
+
+/*
+  Function to print the wild cards of a configuration.
+
+  Input   = {wildConfig *: config}
+  Output  = {void: NULL}
+*/
+static void printWildConfig(const wildConfig * config)
+{
+  const char * rankNames = "A23456789TJQK";
+  int rankNum = NUM_INIT;
+
+  printf("%s", (config->joker == TRUE) ? "joker " : "");
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_RANKS; rankNum ++)
+  {
+    if((config->wildRanks >> rankNum) & 1)
+    {
+      printf("%c ", rankNames[rankNum]);
+    }
+  }
+  printf("wild");
+}
+
+/*
+  Function to rank the hands given to the wild mode.
+
+  Input   = {char * *: hands, int: numOfHands, wildConfig *: config}
+  Output  = {int: exitStatus}
+*/
+static int rankWildHands(const char * hands[], int numOfHands,
+  const wildConfig * config)
+{
+  unsigned char cards[CARDS_PER_HAND];
+  uint64_t held = 0;
+  handStrength strength = 0;
+  int handNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  for(handNum = NUM_INIT; handNum < numOfHands; handNum ++)
+  {
+    held = 0;
+    if(parseWildCardList(hands[handNum], cards, CARDS_PER_HAND) ==
+      CARDS_PER_HAND)
+    {
+      for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        held |= (1ULL << cards[cardNum]);
+      }
+    }
+    if((__builtin_popcountll(held) != CARDS_PER_HAND) ||
+      ((held >> JOKER_INDEX) != 0 && config->joker == FALSE))
+    {
+      printf("Cannot read five different cards of the deck: %s\n",
+        hands[handNum]);
+      return MODE_FAILURE;
+    }
+    strength = evaluateWildHand(cards, config);
+    printf("%s - %s\n", hands[handNum],
+      wildCategoryName(strength >> STRENGTH_CATEGORY_SHIFT));
+  }
+  return MODE_SUCCESS;
+}
+
+/*
+  Wild mode, ranks the given hands with wild cards, or deals hands from the
+  wild deck and tallies their categories, timing the table driven wild
+  evaluation against the natural evaluator.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runWildMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * wildText = optionValue(argc, argv, "-w");
+  const char * handsText = optionValue(argc, argv, "-n");
+  const char * seedText = optionValue(argc, argv, "-s");
+  static unsigned char wildHands[WILD_CHUNK_HANDS * CARDS_PER_HAND];
+  static unsigned char naturalHands[WILD_CHUNK_HANDS * CARDS_PER_HAND];
+  unsigned long long counts[NUM_OF_WILD_HAND_RANKS];
+  unsigned char wildDeck[JOKER_DECK_SIZE];
+  unsigned char naturalDeck[STD_DECK_SIZE];
+  wildConfig config;
+  pokerRng rng;
+  unsigned long long numOfHands = (handsText != NULL) ?
+    strtoull(handsText, NULL, 10) : 1000000;
+  unsigned long long handNum = 0;
+  handStrength checksum = 0;
+  double started = 0.0;
+  double wildSeconds = 0.0;
+  double naturalSeconds = 0.0;
+  int numOfPositionals = collectPositionals(argc, argv, positionals);
+  int deckSize = NUM_INIT;
+  int chunkSize = NUM_INIT;
+  int chunkNum = NUM_INIT;
+  int category = NUM_INIT;
+
+  if(parseWildConfig((wildText != NULL) ? wildText : "deuces", & config) ==
+    FALSE)
+  {
+    printf("Give the wild cards as joker, deuces or ranks, as in "
+      "joker,deuces\n");
+    return MODE_FAILURE;
+  }
+  prepareWildTables();
+  if(numOfPositionals > 0)
+  {
+    return rankWildHands(positionals, numOfPositionals, & config);
+  }
+
+  memset(counts, 0, sizeof(counts));
+  deckSize = createWildDeck(wildDeck, & config);
+  createWildDeck(naturalDeck, & (wildConfig){FALSE, 0});
+  seedRng(& rng, (seedText != NULL) ? strtoull(seedText, NULL, 0) : 1, 0);
+  for(handNum = 0; handNum < numOfHands; handNum += chunkSize)
+  {
+    chunkSize = (numOfHands - handNum < WILD_CHUNK_HANDS) ?
+      (int)(numOfHands - handNum) : WILD_CHUNK_HANDS;
+    for(chunkNum = NUM_INIT; chunkNum < chunkSize; chunkNum ++)
+    {
+      shuffleCardIndices(& rng, wildDeck, deckSize, CARDS_PER_HAND);
+      memcpy(wildHands + chunkNum * CARDS_PER_HAND, wildDeck, CARDS_PER_HAND);
+      shuffleCardIndices(& rng, naturalDeck, STD_DECK_SIZE, CARDS_PER_HAND);
+      memcpy(naturalHands + chunkNum * CARDS_PER_HAND, naturalDeck,
+        CARDS_PER_HAND);
+    }
+    started = currentSeconds();
+    for(chunkNum = NUM_INIT; chunkNum < chunkSize; chunkNum ++)
+    {
+      counts[evaluateWildHand(wildHands + chunkNum * CARDS_PER_HAND,
+        & config) >> STRENGTH_CATEGORY_SHIFT] ++;
+    }
+    wildSeconds += currentSeconds() - started;
+    started = currentSeconds();
+    for(chunkNum = NUM_INIT; chunkNum < chunkSize; chunkNum ++)
+    {
+      checksum ^= evaluateCardIndices(naturalHands + chunkNum *
+        CARDS_PER_HAND, CARDS_PER_HAND);
+    }
+    naturalSeconds += currentSeconds() - started;
+  }
+
+  printf("%llu hands of a %d card deck, ", numOfHands, deckSize);
+  printWildConfig(& config);
+  printf("\n  wild %.1f ns/hand, natural %.1f ns/hand (%u checksum)\n",
+    wildSeconds * 1e9 / numOfHands, naturalSeconds * 1e9 / numOfHands,
+    checksum);
+  for(category = NUM_OF_WILD_HAND_RANKS - 1; category >= HighCard;
+    category --)
+  {
+    printf("  %-16s %10llu %10.6f%%\n", wildCategoryName(category),
+      counts[category], counts[category] * 100.0 / numOfHands);
+  }
+  return MODE_SUCCESS;
+}
+
+/*
+  Percentile build mode, writes the table of every hand's odds against 1 to
+  MAX_OPPONENTS random opponents.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runPercentileBuildMode(int argc, const char * argv[])
+{
+  const char * samplesText = optionValue(argc, argv, "-n");
+  const char * seedText = optionValue(argc, argv, "-s");
+  const char * fileName = optionValue(argc, argv, "-o");
+  percentileBuild build;
+  percentileTable table;
+  double started = 0.0;
+
+  build.samples = (samplesText != NULL) ? strtoull(samplesText, NULL, 10) :
+    DEFAULT_PERCENTILE_SAMPLES;
+  build.seed = (seedText != NULL) ? strtoull(seedText, NULL, 0) : 1;
+  build.numOfThreads = threadOption(argc, argv);
+  fileName = (fileName != NULL) ? fileName : DEFAULT_PERCENTILE_FILE;
+  if(build.samples < 1)
+  {
+    printf("Give at least one sample for each class\n");
+    return MODE_FAILURE;
+  }
+  started = currentSeconds();
+  if((buildPercentileTable(fileName, & build) == FALSE) ||
+    (openPercentileTable(& table, fileName) == FALSE))
+  {
+    printf("Cannot build the percentile table %s\n", fileName);
+    return MODE_FAILURE;
+  }
+  printf("Built %s, %d classes with %llu samples each on %d threads, in "
+    "%.1f s, standard error at most %.4f%%\n", fileName,
+    NUM_OF_CANONICAL_FIVE_CARD_HANDS, (unsigned long long)build.samples,
+    build.numOfThreads, currentSeconds() - started,
+    table.header->standardError * 100.0);
+  closePercentileTable(& table);
+  return MODE_SUCCESS;
+}
+
+/*
+  Percentile mode, looks up the odds of the given hands against -k random
+  opponents, or against every number of them.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runPercentileMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * opponentsText = optionValue(argc, argv, "-k");
+  unsigned char cards[CARDS_PER_HAND];
+  percentileTable table;
+  percentileOdds odds;
+  uint64_t held = 0;
+  int numOfPositionals = collectPositionals(argc, argv, positionals);
+  int numOfOpponents = (opponentsText != NULL) ? atoi(opponentsText) : 0;
+  int first = NUM_INIT;
+  int last = NUM_INIT;
+  int handNum = NUM_INIT;
+  int opponentNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  if((numOfPositionals < 2) || (numOfOpponents < 0) ||
+    (numOfOpponents > MAX_OPPONENTS))
+  {
+    printf("Give the table file and the hands, and 1 to %d opponents\n",
+      MAX_OPPONENTS);
+    return MODE_FAILURE;
+  }
+  if(openPercentileTable(& table, positionals[0]) == FALSE)
+  {
+    printf("Cannot open the percentile table %s\n", positionals[0]);
+    return MODE_FAILURE;
+  }
+  first = (numOfOpponents > 0) ? numOfOpponents : 1;
+  last = (numOfOpponents > 0) ? numOfOpponents : MAX_OPPONENTS;
+  for(handNum = 1; handNum < numOfPositionals; handNum ++)
+  {
+    held = 0;
+    if(parseCardList(positionals[handNum], cards, CARDS_PER_HAND) ==
+      CARDS_PER_HAND)
+    {
+      for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        held |= (1ULL << cards[cardNum]);
+      }
+    }
+    if(__builtin_popcountll(held) != CARDS_PER_HAND)
+    {
+      printf("Cannot read five different cards: %s\n", positionals[handNum]);
+      closePercentileTable(& table);
+      return MODE_FAILURE;
+    }
+    printf("%s\n", positionals[handNum]);
+    for(opponentNum = first; opponentNum <= last; opponentNum ++)
+    {
+      odds = lookupPercentile(& table, cards, opponentNum);
+      printf("  %d opponent%s win %8.4f%% tie %8.4f%%\n", opponentNum,
+        (opponentNum == 1) ? " " : "s", odds.win * 100.0, odds.tie * 100.0);
+    }
+  }
+  printf("Table of %llu samples a class, seed %llu, standard error at most "
+    "%.4f%%\n", (unsigned long long)table.header->samples,
+    (unsigned long long)table.header->seed,
+    table.header->standardError * 100.0);
+  closePercentileTable(& table);
+  return MODE_SUCCESS;
+}
+
+/*
+  Function to time dealing, sorting and evaluating standard tables in the
+  fixed layout of a pokerTable, the cards kept as indices, for comparing
+  with a dynamic table.
+
+  Input   = {int: numOfSeats, unsigned long long: numOfDeals, uint64_t: seed}
+  Output  = {double: seconds}
+*/
+static double timeFixedTables(int numOfSeats, unsigned long long numOfDeals,
+  uint64_t seed)
+{
+  unsigned char deck[STD_DECK_SIZE];
+  card hands[CARDS_PER_HAND][MAX_PLAYERS];
+  handStrength strengths[MAX_PLAYERS];
+  unsigned int checksum = 0;
+  unsigned long long dealNum = 0;
+  pokerRng rng;
+  double started = 0.0;
+  int cardNum = NUM_INIT;
+  int seatNum = NUM_INIT;
+
+  for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    deck[cardNum] = cardNum;
+  }
+  seedRng(& rng, seed, 0);
+  started = currentSeconds();
+  for(dealNum = 0; dealNum < numOfDeals; dealNum ++)
+  {
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE,
+      numOfSeats * CARDS_PER_HAND);
+    for(seatNum = NUM_INIT; seatNum < numOfSeats; seatNum ++)
+    {
+      for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        indexToCard(deck[seatNum * CARDS_PER_HAND + cardNum],
+          & hands[cardNum][seatNum]);
+      }
+      sortHand(hands, seatNum);
+      strengths[seatNum] = evaluateHand(hands, seatNum);
+    }
+    checksum ^= findWinners(strengths, numOfSeats);
+  }
+  if(checksum == UINT32_MAX)
+  {
+    printf("Checksum %u\n", checksum);
+  }
+  return currentSeconds() - started;
+}
+
+/*
+  Function to print the seats of a dynamic table with their categories,
+  marking the winners.
+
+  Input   = {dynamicTable *: table}
+  Output  = {void: NULL}
+*/
+static void printDynamicTable(const dynamicTable * table)
+{
+  int seatNum = NUM_INIT;
+
+  for(seatNum = NUM_INIT; seatNum < table->numOfSeats; seatNum ++)
+  {
+    printf("  %3d: ", seatNum + 1);
+    printCardIndices(table->hands + seatNum * CARDS_PER_HAND,
+      CARDS_PER_HAND);
+    printf(" %-16s%s\n", wildCategoryName(
+      table->strengths[seatNum] >> STRENGTH_CATEGORY_SHIFT),
+      (table->winners[seatNum] == 1) ? " winner" : "");
+  }
+}
+
+/*
+  Table mode, deals a table of any number of seats from a shoe of -d decks,
+  then times -n deals of dealing, sorting and evaluating and tallies their
+  categories. Standard tables are also timed in the fixed layout.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runTableMode(int argc, const char * argv[])
+{
+  const char * positionals[MAX_POSITIONALS];
+  const char * decksText = optionValue(argc, argv, "-d");
+  const char * dealsText = optionValue(argc, argv, "-n");
+  const char * seedText = optionValue(argc, argv, "-s");
+  unsigned long long counts[NUM_OF_WILD_HAND_RANKS];
+  dynamicTable table;
+  pokerRng rng;
+  uint64_t seed = (seedText != NULL) ? strtoull(seedText, NULL, 0) : 1;
+  unsigned long long numOfDeals = (dealsText != NULL) ?
+    strtoull(dealsText, NULL, 10) : 1000000;
+  unsigned long long dealNum = 0;
+  unsigned long long numOfCards = 0;
+  double seconds = 0.0;
+  double started = 0.0;
+  int numOfDecks = (decksText != NULL) ? atoi(decksText) : 1;
+  int numOfSeats = NUM_INIT;
+  int seatNum = NUM_INIT;
+  int category = NUM_INIT;
+
+  if(collectPositionals(argc, argv, positionals) != 1)
+  {
+    printf("Give the number of seats\n");
+    return MODE_FAILURE;
+  }
+  numOfSeats = atoi(positionals[0]);
+  if(createDynamicTable(& table, numOfSeats, numOfDecks) == FALSE)
+  {
+    printf("Give 1 to %d decks and at most 10 seats a deck\n",
+      MAX_SHOE_DECKS);
+    return MODE_FAILURE;
+  }
+  seedRng(& rng, seed, 0);
+  dealDynamicTable(& table, & rng);
+  sortDynamicHands(& table);
+  evaluateDynamicTable(& table);
+  printf("%d seats from %d deck%s%s\n", numOfSeats, numOfDecks,
+    (numOfDecks == 1) ? "" : "s",
+    (table.standard == TRUE) ? ", standard" : "");
+  printDynamicTable(& table);
+
+  memset(counts, 0, sizeof(counts));
+  started = currentSeconds();
+  for(dealNum = 0; dealNum < numOfDeals; dealNum ++)
+  {
+    dealDynamicTable(& table, & rng);
+    sortDynamicHands(& table);
+    evaluateDynamicTable(& table);
+    for(seatNum = NUM_INIT; seatNum < numOfSeats; seatNum ++)
+    {
+      counts[table.strengths[seatNum] >> STRENGTH_CATEGORY_SHIFT] ++;
+    }
+  }
+  seconds = currentSeconds() - started;
+  numOfCards = numOfDeals * numOfSeats * CARDS_PER_HAND;
+  printf("%llu deals, %.2f ns a card", numOfDeals,
+    (numOfCards > 0) ? seconds * 1e9 / numOfCards : 0.0);
+  if((table.standard == TRUE) && (numOfCards > 0))
+  {
+    printf(", fixed layout %.2f ns a card",
+      timeFixedTables(numOfSeats, numOfDeals, seed) * 1e9 / numOfCards);
+  }
+  printf("\n");
+  for(category = NUM_OF_WILD_HAND_RANKS - 1; (numOfCards > 0) &&
+    (category >= HighCard); category --)
+  {
+    printf("  %-16s %12llu %10.6f%%\n", wildCategoryName(category),
+      counts[category], counts[category] * 100.0 * CARDS_PER_HAND /
+      numOfCards);
+  }
+  freeDynamicTable(& table);
+  return MODE_SUCCESS;
+}
+
+/*
+  Function to print the average strategy of the first player's opening
+  decision for every bucket of the first street.
+
+  Input   = {cfrSolver *: solver}
+  Output  = {void: NULL}
+*/
+static void printOpeningStrategy(const cfrSolver * solver)
+{
+  double probabilities[CFR_MAX_ACTIONS];
+  int bucket = NUM_INIT;
+
+  printf("Opening strategy of the first player, weakest bucket first\n");
+  for(bucket = NUM_INIT; bucket < solver->config.numOfBuckets; bucket ++)
+  {
+    cfrAverageStrategy(solver, 0, bucket, probabilities);
+    printf("  bucket %d: check %5.1f%% bet %5.1f%%\n", bucket,
+      probabilities[0] * 100.0, probabilities[1] * 100.0);
+  }
+}
+
+/*
+  CFR mode, solves the limit stud betting game for -n iterations, measuring
+  the exploitability every -i iterations, and saves the tables with -o or
+  carries on from tables loaded with -l.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runCfrMode(int argc, const char * argv[])
+{
+  const char * bucketsText = optionValue(argc, argv, "-b");
+  const char * iterationsText = optionValue(argc, argv, "-n");
+  const char * intervalText = optionValue(argc, argv, "-i");
+  const char * dealsText = optionValue(argc, argv, "-d");
+  const char * seedText = optionValue(argc, argv, "-s");
+  const char * savePath = optionValue(argc, argv, "-o");
+  const char * loadPath = optionValue(argc, argv, "-l");
+  static cfrSolver solver;
+  cfrConfig config;
+  uint64_t numOfIterations = (iterationsText != NULL) ?
+    strtoull(iterationsText, NULL, 10) : 10000000;
+  uint64_t interval = (intervalText != NULL) ?
+    strtoull(intervalText, NULL, 10) : 0;
+  uint64_t done = 0;
+  uint64_t step = 0;
+  uint64_t loaded = 0;
+  double gameValue = 0.0;
+  double exploitability = 0.0;
+  double started = 0.0;
+  double seconds = 0.0;
+  int argNum = NUM_INIT;
+
+  config.numOfBuckets = (bucketsText != NULL) ? atoi(bucketsText) :
+    DEFAULT_CFR_BUCKETS;
+  config.numOfDeals = (dealsText != NULL) ? strtoull(dealsText, NULL, 10) :
+    DEFAULT_CFR_DEALS;
+  config.seed = (seedText != NULL) ? strtoull(seedText, NULL, 0) : 1;
+  config.numOfThreads = threadOption(argc, argv);
+  config.plus = FALSE;
+  for(argNum = NUM_INIT; argNum < argc; argNum ++)
+  {
+    if(strcmp(argv[argNum], "--plus") == 0)
+    {
+      config.plus = TRUE;
+    }
+  }
+  started = currentSeconds();
+  if(createCfrSolver(& solver, & config) == FALSE)
+  {
+    printf("Give %d to %d buckets and 1 to %u deals\n", MIN_CFR_BUCKETS,
+      MAX_CFR_BUCKETS, UINT32_MAX);
+    return MODE_FAILURE;
+  }
+  printf("%d buckets a street, %llu deals, %d nodes, %u slots, %s, built "
+    "in %.2f s\n", config.numOfBuckets,
+    (unsigned long long)config.numOfDeals, solver.numOfNodes,
+    solver.numOfSlots, (config.plus == TRUE) ? "CFR+" : "CFR",
+    currentSeconds() - started);
+  if((loadPath != NULL) && (loadCfrStrategy(& solver, loadPath) == FALSE))
+  {
+    printf("Cannot load %s, or it was saved with other buckets, deals or "
+      "seed\n", loadPath);
+    freeCfrSolver(& solver);
+    return MODE_FAILURE;
+  }
+  loaded = solver.iterations;
+  interval = (interval > 0) ? interval : numOfIterations;
+  for(done = 0; done < numOfIterations; done += step)
+  {
+    step = (numOfIterations - done < interval) ? numOfIterations - done :
+      interval;
+    started = currentSeconds();
+    if(runCfrIterations(& solver, step) == FALSE)
+    {
+      printf("Out of memory\n");
+      freeCfrSolver(& solver);
+      return MODE_FAILURE;
+    }
+    seconds += currentSeconds() - started;
+    exploitability = cfrExploitability(& solver, & gameValue);
+    printf("%12llu iterations, %.2f M/min, exploitability %.5f chips, "
+      "value %+.5f\n", (unsigned long long)solver.iterations,
+      (seconds > 0.0) ? (solver.iterations - loaded) / seconds * 60e-6 :
+      0.0, exploitability, gameValue);
+  }
+  printOpeningStrategy(& solver);
+  if((savePath != NULL) && (saveCfrStrategy(& solver, savePath) == FALSE))
+  {
+    printf("Cannot save %s\n", savePath);
+    freeCfrSolver(& solver);
+    return MODE_FAILURE;
+  }
+  freeCfrSolver(& solver);
+  return MODE_SUCCESS;
+}
+
+/*
+  Range mode, compiles two range expressions and prints the showdown
+  equity of the first against the second.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runRangeMode(int argc, const char * argv[])
+{
+  static const char * const engineNames[] = {"auto", "pairs", "sweep"};
+  const char * positionals[MAX_POSITIONALS];
+  const char * engineText = optionValue(argc, argv, "-e");
+  handRange ranges[2];
+  rangeEquity equity;
+  double started = 0.0;
+  double compiled = 0.0;
+  double total = 0.0;
+  bool success = TRUE;
+  int numOfPositionals = collectPositionals(argc, argv, positionals);
+  int numOfThreads = threadOption(argc, argv);
+  int engine = RANGE_ENGINE_AUTO;
+  int rangeNum = NUM_INIT;
+
+  while((engineText != NULL) && (engine <= RANGE_ENGINE_SWEEP) &&
+    (strcmp(engineText, engineNames[engine]) != 0))
+  {
+    engine ++;
+  }
+  if((numOfPositionals != 2) || (engine > RANGE_ENGINE_SWEEP))
+  {
+    printf("Give two range expressions, and an engine of auto, pairs or "
+      "sweep\n");
+    return MODE_FAILURE;
+  }
+  if(createHandRange(& ranges[0]) == FALSE)
+  {
+    printf("Out of memory\n");
+    return MODE_FAILURE;
+  }
+  if(createHandRange(& ranges[1]) == FALSE)
+  {
+    freeHandRange(& ranges[0]);
+    printf("Out of memory\n");
+    return MODE_FAILURE;
+  }
+  started = currentSeconds();
+  for(rangeNum = NUM_INIT; (success == TRUE) && (rangeNum < 2); rangeNum ++)
+  {
+    success = compileHandRange(& ranges[rangeNum], positionals[rangeNum]);
+    if(success == FALSE)
+    {
+      printf("Cannot read the range: %s\n", positionals[rangeNum]);
+      break;
+    }
+    printf("Range %d: %s\n  %u hands, weight %.2f\n", rangeNum + 1,
+      positionals[rangeNum], ranges[rangeNum].numOfHands,
+      ranges[rangeNum].totalWeight);
+  }
+  compiled = currentSeconds();
+  if((success == TRUE) && (computeRangeEquity(& ranges[0], & ranges[1],
+    numOfThreads, engine, & equity) == FALSE))
+  {
+    printf("Out of memory\n");
+    success = FALSE;
+  }
+  if(success == TRUE)
+  {
+    total = equity.win + equity.tie + equity.loss;
+    printf("%llu pairs of hands sharing no card, %s engine\n",
+      (unsigned long long)equity.numOfPairs, engineNames[equity.engine]);
+    if(total > 0.0)
+    {
+      printf("Range 1 wins %8.4f%% ties %8.4f%% loses %8.4f%%, "
+        "equity %8.4f%%\n", equity.win / total * 100.0,
+        equity.tie / total * 100.0, equity.loss / total * 100.0,
+        (equity.win + equity.tie / 2.0) / total * 100.0);
+    }
+    printf("Compiled in %.3f s, equity in %.3f s\n", compiled - started,
+      currentSeconds() - compiled);
+  }
+  freeHandRange(& ranges[0]);
+  freeHandRange(& ranges[1]);
+  return (success == TRUE) ? MODE_SUCCESS : MODE_FAILURE;
+}
+
+/*
+  Function to print the share of tournaments the hero finished within the
+  best places, beside the share of an average player.
+
+  Input   = {tournamentResults *: results, int: numOfPlayers, char *: label,
+            int: places}
+  Output  = {void: NULL}
+*/
+static void printFinishShare(const tournamentResults * results,
+  int numOfPlayers, const char * label, int places)
+{
+  uint64_t finished = 0;
+  int placeNum = NUM_INIT;
+
+  places = (places < 1) ? 1 : ((places > numOfPlayers) ? numOfPlayers :
+    places);
+  for(placeNum = NUM_INIT; placeNum < places; placeNum ++)
+  {
+    finished += results->heroFinishes[placeNum];
+  }
+  printf("  %-12s %5d place%s %8.4f%%, average %8.4f%%\n", label, places,
+    (places == 1) ? " " : "s", 100.0 * finished / results->tournaments,
+    100.0 * places / numOfPlayers);
+}
+
+/*
+  Tournament mode, simulates tournaments where every player goes all in
+  with a range of hands or folds, and prints where the hero finished.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runTournamentMode(int argc, const char * argv[])
+{
+  const char * tournamentsText = optionValue(argc, argv, "-n");
+  const char * playersText = optionValue(argc, argv, "-p");
+  const char * seatsText = optionValue(argc, argv, "-k");
+  const char * chipsText = optionValue(argc, argv, "-c");
+  const char * levelText = optionValue(argc, argv, "-l");
+  const char * seedText = optionValue(argc, argv, "-s");
+  const char * fieldText = optionValue(argc, argv, "-f");
+  const char * heroText = optionValue(argc, argv, "-r");
+  const char * outputName = optionValue(argc, argv, "-o");
+  handRange fieldRange;
+  handRange heroRange;
+  tournamentConfig config;
+  tournamentResults results;
+  FILE * output = NULL;
+  double started = 0.0;
+  double seconds = 0.0;
+  double meanPlace = 0.0;
+  int status = MODE_SUCCESS;
+  int placeNum = NUM_INIT;
+
+  config.numOfPlayers = (playersText != NULL) ? atoi(playersText) :
+    DEFAULT_TOURNAMENT_PLAYERS;
+  config.seatsPerTable = (seatsText != NULL) ? atoi(seatsText) :
+    DEFAULT_TOURNAMENT_SEATS;
+  config.startingStack = (chipsText != NULL) ? atoll(chipsText) :
+    DEFAULT_STARTING_STACK;
+  config.levelRounds = (levelText != NULL) ? atoi(levelText) :
+    DEFAULT_LEVEL_ROUNDS;
+  config.numOfTournaments = (tournamentsText != NULL) ?
+    strtoull(tournamentsText, NULL, 10) : 10000;
+  config.seed = (seedText != NULL) ? strtoull(seedText, NULL, 0) : 1;
+  config.numOfThreads = threadOption(argc, argv);
+  if(memoryOptions(argc, argv, & config.backing) == FALSE)
+  {
+    return MODE_FAILURE;
+  }
+  fieldText = (fieldText != NULL) ? fieldText : "TT+";
+  heroText = (heroText != NULL) ? heroText : fieldText;
+  if((config.numOfTournaments < 1) || (config.numOfPlayers < 2) ||
+    (config.numOfPlayers > MAX_TOURNAMENT_PLAYERS))
+  {
+    printf("Give at least one tournament of 2 to %d players\n",
+      MAX_TOURNAMENT_PLAYERS);
+    return MODE_FAILURE;
+  }
+  if(createHandRange(& fieldRange) == FALSE)
+  {
+    printf("Out of memory\n");
+    return MODE_FAILURE;
+  }
+  if(createHandRange(& heroRange) == FALSE)
+  {
+    freeHandRange(& fieldRange);
+    printf("Out of memory\n");
+    return MODE_FAILURE;
+  }
+  if((compileHandRange(& fieldRange, fieldText) == FALSE) ||
+    (compileHandRange(& heroRange, heroText) == FALSE))
+  {
+    printf("Cannot read the ranges %s and %s\n", heroText, fieldText);
+    freeHandRange(& fieldRange);
+    freeHandRange(& heroRange);
+    return MODE_FAILURE;
+  }
+  config.heroRange = & heroRange;
+  config.fieldRange = & fieldRange;
+  started = currentSeconds();
+  if(runTournaments(& config, & results) == FALSE)
+  {
+    printf("Give 2 to %d seats a table, chips and rounds a level, or there "
+      "is not enough memory\n", MAX_PLAYERS);
+    freeHandRange(& fieldRange);
+    freeHandRange(& heroRange);
+    return MODE_FAILURE;
+  }
+  seconds = currentSeconds() - started;
+
+  printf("%llu tournaments of %d players at %d seats, %lld chips, blinds up "
+    "every %d rounds\n", (unsigned long long)results.tournaments,
+    config.numOfPlayers, config.seatsPerTable,
+    (long long)config.startingStack, config.levelRounds);
+  printf("Hero all in with %s (%u hands), field with %s (%u hands)\n",
+    heroText, heroRange.numOfHands, fieldText, fieldRange.numOfHands);
+  printf("Per tournament: %.1f rounds, %.1f hands, %.1f moves, %.1f tables "
+    "broken\n", (double)results.rounds / results.tournaments,
+    (double)results.hands / results.tournaments,
+    (double)results.moves / results.tournaments,
+    (double)results.tablesBroken / results.tournaments);
+  for(placeNum = NUM_INIT; placeNum < config.numOfPlayers; placeNum ++)
+  {
+    meanPlace += (placeNum + 1.0) * results.heroFinishes[placeNum];
+  }
+  printf("Hero finishes, mean place %.2f against %.2f:\n",
+    meanPlace / results.tournaments, (config.numOfPlayers + 1) / 2.0);
+  printFinishShare(& results, config.numOfPlayers, "first", 1);
+  printFinishShare(& results, config.numOfPlayers, "top three", 3);
+  printFinishShare(& results, config.numOfPlayers, "final table",
+    config.seatsPerTable);
+  printFinishShare(& results, config.numOfPlayers, "top 15%",
+    (config.numOfPlayers * 15 + 99) / 100);
+  printf("%.3f s, %.0f tournaments/s, %.2fM hands/s\n", seconds,
+    results.tournaments / seconds, results.hands / seconds / 1e6);
+  printMemory(stdout, & results.memory);
+  if((results.chipErrors != 0) || (results.maxSpread > 1))
+  {
+    printf("Chips went missing %llu times, tables differed by %d\n",
+      (unsigned long long)results.chipErrors, results.maxSpread);
+    status = MODE_FAILURE;
+  }
+
+  if(outputName != NULL)
+  {
+    output = fopen(outputName, "w");
+    if(output == NULL)
+    {
+      printf("Cannot write the finishes to %s\n", outputName);
+      status = MODE_FAILURE;
+    }
+    for(placeNum = NUM_INIT; (output != NULL) &&
+      (placeNum < config.numOfPlayers); placeNum ++)
+    {
+      fprintf(output, "%s%d,%llu,%.8f\n", (placeNum == 0) ?
+        "place,tournaments,share\n" : "", placeNum + 1,
+        (unsigned long long)results.heroFinishes[placeNum],
+        (double)results.heroFinishes[placeNum] / results.tournaments);
+    }
+    if(output != NULL)
+    {
+      fclose(output);
+    }
+  }
+  freeTournamentResults(& results);
+  freeHandRange(& fieldRange);
+  freeHandRange(& heroRange);
+  return status;
+}
+
+/*
+  Play mode, plays limit five card stud hands between a strategy at every
+  seat and prints what each seat won.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+static int runPlayMode(int argc, const char * argv[])
+{
+  const char * handsText = optionValue(argc, argv, "-n");
+  const char * seedText = optionValue(argc, argv, "-s");
+  const char * positionals[MAX_POSITIONALS];
+  playConfig config;
+  playResults results;
+  double started = 0.0;
+  double seconds = 0.0;
+  int64_t chipSum = 0;
+  uint64_t numOfActions = 0;
+  int numOfPositionals = collectPositionals(argc, argv, positionals);
+  int seat = NUM_INIT;
+  int status = MODE_SUCCESS;
+
+  memset(& config, 0, sizeof(config));
+  if((numOfPositionals < 2) || (numOfPositionals > MAX_PLAYERS))
+  {
+    printf("Give a strategy for each of 2 to %d seats\n", MAX_PLAYERS);
+    return MODE_FAILURE;
+  }
+  for(seat = NUM_INIT; seat < numOfPositionals; seat ++)
+  {
+    if(findPlayStrategy(positionals[seat], & config.strategies[seat]) ==
+      FALSE)
+    {
+      printf("Unknown strategy %s, use %s\n", positionals[seat],
+        PLAY_STRATEGY_NAMES);
+      return MODE_FAILURE;
+    }
+  }
+  config.numOfPlayers = numOfPositionals;
+  config.numOfHands = (handsText != NULL) ? strtoull(handsText, NULL, 10) :
+    1000000;
+  config.seed = (seedText != NULL) ? strtoull(seedText, NULL, 0) : 1;
+  config.numOfThreads = threadOption(argc, argv);
+  if(memoryOptions(argc, argv, & config.backing) == FALSE)
+  {
+    return MODE_FAILURE;
+  }
+  if(config.numOfHands < 1)
+  {
+    printf("Give at least one hand\n");
+    return MODE_FAILURE;
+  }
+  started = currentSeconds();
+  if(runPlay(& config, & results) == FALSE)
+  {
+    printf("Not enough memory to play\n");
+    return MODE_FAILURE;
+  }
+  seconds = currentSeconds() - started;
+
+  numOfActions = results.actions[PLAY_FOLD] + results.actions[PLAY_CALL] +
+    results.actions[PLAY_RAISE];
+  printf("%llu hands of limit five card stud, %d players, ante %d, bets "
+    "%d and %d\n", (unsigned long long)results.hands, config.numOfPlayers,
+    PLAY_ANTE, PLAY_SMALL_BET, PLAY_BIG_BET);
+  printf("Per hand: %.2f decisions, %.2f%% showdowns; actions %.2f%% fold, "
+    "%.2f%% check or call, %.2f%% bet or raise\n",
+    (double)results.decisions / results.hands,
+    100.0 * results.showdowns / results.hands,
+    100.0 * results.actions[PLAY_FOLD] / numOfActions,
+    100.0 * results.actions[PLAY_CALL] / numOfActions,
+    100.0 * results.actions[PLAY_RAISE] / numOfActions);
+  for(seat = NUM_INIT; seat < config.numOfPlayers; seat ++)
+  {
+    printf("  seat %2d %-12s %+10.4f chips a hand\n", seat + 1,
+      config.strategies[seat].name,
+      (double)results.chipsWon[seat] / results.hands);
+    chipSum += results.chipsWon[seat];
+  }
+  printf("%.3f s, %.2fM hands/s, %.2fM decisions/s\n", seconds,
+    results.hands / seconds / 1e6, results.decisions / seconds / 1e6);
+  printMemory(stdout, & results.memory);
+  if(chipSum != 0)
+  {
+    printf("Chips won add up to %lld, not zero\n", (long long)chipSum);
+    status = MODE_FAILURE;
+  }
+  return status;
+}
+
+/* Table of the analysis modes */
+static const pokerMode pokerModes[] =
+{
+  {
+    "--equity", runEquityMode,
+    "[-t threads] [-e tolerance] [-d \"dead cards\"] [-c checkpoint] "
+    "[-k seconds] [--resume] [--shard i/N] [-o shard file] "
+    "\"known cards\" ..."
+  },
+  {
+    "--merge", runMergeMode, "shard file ..."
+  },
+  {
+    "--categories", runCategoriesMode, ""
+  },
+  {
+    "--simulate", runSimulateMode,
+    "[-t threads] [-s seed] [-f csv|json|none] [-o file] [-i seconds] "
+    "[-c checkpoint] [-k seconds] [--resume] "
+    "[--trace file] [--trace-every batches] [--huge-pages thp|hugetlb] "
+    "[--no-stats] players tables"
+  },
+  {
+    "--shuffle-bench", runShuffleBenchMode, "[-n decks] [-d dealt]"
+  },
+  {
+    "--showdown-bench", runShowdownBenchMode, "[-n tables] [-s seed]"
+  },
+  {
+    "--stats-bench", runStatsBenchMode, "[-t threads] [-n tables] [-s seed] "
+    "players"
+  },
+  {
+    "--draw", runDrawMode,
+    "[-t threads] [-s seed] [-o strength|category] [-k options shown] "
+    "players | \"hand\" ..."
+  },
+  {
+    "--stud7", runStudMode, "[-s seed] [-n hands] [-t threads] players"
+  },
+  {
+    "--rare", runRareMode,
+    "[-s seed] [-n tables] [-l lead] [-p seat] rank players"
+  },
+  {
+    "--pipeline", runPipelineMode,
+    "[-t threads] [-p producers] [-e evaluators] [-s seed] "
+    "[-f text|binary|none] [-o file] [--trace file] "
+    "[--trace-every batches] [--huge-pages thp|hugetlb] players tables"
+  },
+  {
+    "--index", runIndexMode, "[-o index] dealfile"
+  },
+  {
+    "--query", runQueryMode, "[-l limit] [--ids] index \"query\""
+  },
+  {
+    "--audit", runAuditMode,
+    "[-t threads] [-n decks] [-s seed] [-a alpha] [shuffle]"
+  },
+  {
+    "--removal", runRemovalMode, "[\"seen cards\"]"
+  },
+  {
+    "--wild", runWildMode,
+    "[-w joker|deuces|ranks] [-n hands] [-s seed] [\"hand\" ...]"
+  },
+  {
+    "--percentile-build", runPercentileBuildMode,
+    "[-t threads] [-n samples] [-s seed] [-o file]"
+  },
+  {
+    "--percentile", runPercentileMode, "[-k opponents] file \"hand\" ..."
+  },
+  {
+    "--table", runTableMode, "[-d decks] [-n deals] [-s seed] seats"
+  },
+  {
+    "--cfr", runCfrMode,
+    "[-t threads] [-b buckets] [-n iterations] [-i interval] [-d deals] "
+    "[-s seed] [--plus] [-o file] [-l file]"
+  },
+  {
+    "--range", runRangeMode,
+    "[-t threads] [-e auto|pairs|sweep] \"range\" \"range\""
+  },
+  {
+    "--tournament", runTournamentMode,
+    "[-t threads] [-n tournaments] [-p players] [-k seats] [-c chips] "
+    "[-l rounds] [-s seed] [-f \"field range\"] [-r \"hero range\"] "
+    "[-o file] [--huge-pages thp|hugetlb]"
+  },
+  {
+    "--play", runPlayMode,
+    "[-t threads] [-n hands] [-s seed] [--huge-pages thp|hugetlb] "
+    "strategy strategy ..."
+  }
+};
+
+/*
+  Function to determine whether the command line asks for an analysis mode.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {bool: isMode}
+*/
+bool isPokerMode(int argc, const char * argv[])
+{
+  if((argc > 1) && (strncmp(argv[1], MODE_PREFIX, 2) == 0))
+  {
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/*
+  Function to run the analysis mode named by the first argument, or list the
+  modes when the name is unknown.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+int runPokerMode(int argc, const char * argv[])
+{
+  const int numOfModes = sizeof(pokerModes) / sizeof(pokerModes[0]);
+  int modeNum = NUM_INIT;
+  for(modeNum = NUM_INIT; modeNum < numOfModes; modeNum ++)
+  {
+    if(strcmp(argv[1], pokerModes[modeNum].name) == 0)
+    {
+      return pokerModes[modeNum].function(argc - 2, argv + 2);
+    }
+  }
+  printf("Unknown mode %s, the modes are:\n", argv[1]);
+  for(modeNum = NUM_INIT; modeNum < numOfModes; modeNum ++)
+  {
+    printf("  %s %s %s\n", argv[0], pokerModes[modeNum].name,
+      pokerModes[modeNum].usage);
+  }
+  return MODE_FAILURE;
+}
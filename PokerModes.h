@@ -0,0 +1,27 @@
+#ifndef PokerModes_h
+#define PokerModes_h
+
+/* Macros and types of the simulated Poker Table. */
+#include "PokerTable.h"
+
+/* Prefix of a mode argument, for example --equity */
+#define MODE_PREFIX "--"
+
+/*
+  Function to determine whether the command line asks for one of the
+  analysis modes rather than the classic table printout.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {bool: isMode}
+*/
+bool isPokerMode(int, const char * *);
+
+/*
+  Function to run the analysis mode named by the first argument.
+
+  Input   = {int: argc, char * *: argv}
+  Output  = {int: exitStatus}
+*/
+int runPokerMode(int, const char * *);
+
+#endif /* PokerModes_h */
@@ -0,0 +1,729 @@
+#include "PokerPipeline.h"
+/* Hand strengths and showdowns */
+#include "HandEvaluator.h"
+/* Generator streams and shuffles */
+#include "PokerRandom.h"
+/* Batch size and streams shared with the simulation */
+#include "PokerSimulation.h"
+
+/* string.h is included for memcpy and memset. */
+#include <string.h>
+/* sched.h is included for sched_yield, the wait of a blocked stage. */
+#include <sched.h>
+
+/* Spins on an empty or full ring before a stage yields its processor */
+#define PIPELINE_SPINS 64
+/* Longest line of the text output: five cards of three characters per seat,
+   seat separators and the winners */
+#define DEAL_LINE_SIZE (MAX_PLAYERS * (CARDS_PER_HAND * 3 + 2) + 64)
+/* Bytes of the winner mask of a binary record */
+#define WINNER_MASK_SIZE 2
+
+/* Names of the hand ranks, from PokerTable.c */
+extern char * handRanks[NUM_OF_HAND_RANKS];
+
+/*
+  Table batch structure, the unit passed down the pipeline. Batches belong to
+  the producer that deals them and go back to it once written. Each batch is
+  an object of the run's pool with its cards right after it.
+
+    batchNum   - batch of the run, dealt from generator stream batchNum
+    producer   - producer the batch belongs to
+    numOfTables - tables in the batch
+    cards      - numOfPlayers * CARDS_PER_HAND card indices per table
+    winners    - winner mask of each table
+    categories - hand rank of each table's winning hand
+*/
+typedef struct tableBatch
+{
+  uint64_t batchNum;
+  int producer;
+  int numOfTables;
+  unsigned char * cards;
+  unsigned short winners[TABLES_PER_BATCH];
+  unsigned char categories[TABLES_PER_BATCH];
+} tableBatch;
+
+/*
+  State shared by the pipeline threads. Producer p deals the batches b with
+  b % numOfProducers == p and passes batch b to evaluator b % numOfEvaluators
+  through its own ring, dealt[p][e], so every ring has one producer and one
+  consumer and holds its batches in order. Evaluator e passes its batches to
+  the writer through evaluated[e], and the writer hands each batch back to
+  its producer through free[p]. A waiting stage gives up once stop is set,
+  when not every stage could be started.
+*/
+typedef struct pipelineContext
+{
+  const pipelineConfig * config;
+  pipelineReport * report;
+  uint64_t numOfBatches;
+  double started;
+  int cardsPerTable;
+  showdownKernel showdown;
+  pokerArena arena;
+  objectPool batches;
+  spscRing * dealt;
+  spscRing * evaluated;
+  spscRing * free;
+  atomic_int stop;
+} pipelineContext;
+
+/*
+  Function to empty a ring.
+
+  Input   = {spscRing *: ring}
+  Output  = {void: NULL}
+*/
+void initRing(spscRing * ring)
+{
+  atomic_init(& ring->tail, 0);
+  atomic_init(& ring->head, 0);
+  ring->cachedHead = 0;
+  ring->cachedTail = 0;
+}
+
+/*
+  Function to queue a pointer, called only by the ring's producer.
+
+  Input   = {spscRing *: ring, void *: item}
+  Output  = {bool: queued}
+*/
+bool ringPush(spscRing * ring, void * item)
+{
+  const unsigned int tail = atomic_load_explicit(& ring->tail,
+    memory_order_relaxed);
+  if(tail - ring->cachedHead == PIPELINE_RING_SLOTS)
+  {
+    ring->cachedHead = atomic_load_explicit(& ring->head,
+      memory_order_acquire);
+    if(tail - ring->cachedHead == PIPELINE_RING_SLOTS)
+    {
+      return FALSE;
+    }
+  }
+  ring->slots[tail & (PIPELINE_RING_SLOTS - 1)] = item;
+  atomic_store_explicit(& ring->tail, tail + 1, memory_order_release);
+  return TRUE;
+}
+
+/*
+  Function to take the oldest pointer, called only by the ring's consumer.
+
+  Input   = {spscRing *: ring}
+  Output  = {void *: item}
+*/
+void * ringPop(spscRing * ring)
+{
+  const unsigned int head = atomic_load_explicit(& ring->head,
+    memory_order_relaxed);
+  void * item = NULL;
+  if(head == ring->cachedTail)
+  {
+    ring->cachedTail = atomic_load_explicit(& ring->tail,
+      memory_order_acquire);
+    if(head == ring->cachedTail)
+    {
+      return NULL;
+    }
+  }
+  item = ring->slots[head & (PIPELINE_RING_SLOTS - 1)];
+  atomic_store_explicit(& ring->head, head + 1, memory_order_release);
+  return item;
+}
+
+/*
+  Function to count the pointers queued.
+
+  Input   = {spscRing *: ring}
+  Output  = {unsigned int: depth}
+*/
+unsigned int ringDepth(spscRing * ring)
+{
+  return atomic_load_explicit(& ring->tail, memory_order_acquire) -
+    atomic_load_explicit(& ring->head, memory_order_relaxed);
+}
+
+/*
+  Function to take a batch from a ring, waiting while it is empty and
+  noting the depth found and the time waited, and tracing the wait when the
+  batch the thread works on next is sampled. For a producer that is the
+  batch it deals into the free batch it waits for.
+
+  Input   = {spscRing *: ring, atomic_int *: stop, stageMetrics *: metrics,
+            pokerTrace *: trace, int: threadNum, uint64_t: batchNum}
+  Output  = {tableBatch *: batch}, NULL when the pipeline was stopped
+*/
+static tableBatch * takeBatch(spscRing * ring, atomic_int * stop,
+  stageMetrics * metrics, pokerTrace * trace, int threadNum,
+  uint64_t batchNum)
+{
+  const unsigned int depth = ringDepth(ring);
+  tableBatch * batch = ringPop(ring);
+  double waitStarted = 0.0;
+  int spins = 0;
+
+  metrics->depthSum += depth;
+  metrics->depthSamples ++;
+  if(depth > metrics->maxDepth)
+  {
+    metrics->maxDepth = depth;
+  }
+  if(batch != NULL)
+  {
+    return batch;
+  }
+  waitStarted = currentSeconds();
+  while((batch = ringPop(ring)) == NULL)
+  {
+    if(++ spins >= PIPELINE_SPINS)
+    {
+      if(atomic_load_explicit(stop, memory_order_acquire) != 0)
+      {
+        return NULL;
+      }
+      sched_yield();
+      spins = 0;
+    }
+  }
+  metrics->starved += currentSeconds() - waitStarted;
+  if(traceSampled(trace, batchNum))
+  {
+    recordTraceSpan(trace, threadNum, TraceStarved, batchNum, waitStarted);
+  }
+  return batch;
+}
+
+/*
+  Function to pass a batch on through a ring, waiting while it is full, and
+  tracing the wait when the batch is sampled.
+
+  Input   = {spscRing *: ring, atomic_int *: stop, tableBatch *: batch,
+            stageMetrics *: metrics, pokerTrace *: trace, int: threadNum}
+  Output  = {bool: passed}, FALSE when the pipeline was stopped
+*/
+static bool passBatch(spscRing * ring, atomic_int * stop, tableBatch * batch,
+  stageMetrics * metrics, pokerTrace * trace, int threadNum)
+{
+  const uint64_t batchNum = batch->batchNum;
+  double waitStarted = 0.0;
+  int spins = 0;
+
+  if(ringPush(ring, batch) == TRUE)
+  {
+    return TRUE;
+  }
+  waitStarted = currentSeconds();
+  while(ringPush(ring, batch) == FALSE)
+  {
+    if(++ spins >= PIPELINE_SPINS)
+    {
+      if(atomic_load_explicit(stop, memory_order_acquire) != 0)
+      {
+        return FALSE;
+      }
+      sched_yield();
+      spins = 0;
+    }
+  }
+  metrics->heldBack += currentSeconds() - waitStarted;
+  /* The batch may already be on its way, so its number was kept */
+  if(traceSampled(trace, batchNum))
+  {
+    recordTraceSpan(trace, threadNum, TraceHeldBack, batchNum, waitStarted);
+  }
+  return TRUE;
+}
+
+/*
+  Function run by a producer, shuffling and dealing its batches exactly as
+  the simulation deals them.
+
+  Input   = {pipelineContext *: context, int: producerNum}
+  Output  = {void: NULL}
+*/
+static void produceBatches(pipelineContext * context, int producerNum)
+{
+  const pipelineConfig * config = context->config;
+  const int cardsPerTable = context->cardsPerTable;
+  const int threadNum = 1 + producerNum;
+  stageMetrics * metrics = & context->report->producers[producerNum];
+  unsigned char deck[STD_DECK_SIZE];
+  tableBatch * batch = NULL;
+  pokerRng rng;
+  uint64_t batchNum = 0;
+  uint64_t numOfTables = 0;
+  double batchStarted = 0.0;
+  double phaseStarted = 0.0;
+  int tableNum = 0;
+  int cardNum = NUM_INIT;
+
+  for(batchNum = producerNum; batchNum < context->numOfBatches;
+    batchNum += config->numOfProducers)
+  {
+    batch = takeBatch(& context->free[producerNum], & context->stop, metrics,
+      config->trace, threadNum, batchNum);
+    if(batch == NULL)
+    {
+      break;
+    }
+    batchStarted = currentSeconds();
+    numOfTables = TABLES_PER_BATCH;
+    if(batchNum == context->numOfBatches - 1)
+    {
+      numOfTables = config->numOfTables - batchNum * TABLES_PER_BATCH;
+    }
+    batch->batchNum = batchNum;
+    batch->numOfTables = (int)numOfTables;
+    seedRng(& rng, config->seed, batchNum);
+    for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+    {
+      deck[cardNum] = cardNum;
+    }
+    tableNum = 0;
+    if(traceSampled(config->trace, batchNum))
+    {
+      /* The traced tables are dealt exactly as the others below */
+      for(; (tableNum < batch->numOfTables) &&
+        (tableNum < TRACE_TABLES_PER_BATCH); tableNum ++)
+      {
+        phaseStarted = currentSeconds();
+        shuffleCardIndices(& rng, deck, STD_DECK_SIZE, cardsPerTable);
+        phaseStarted = recordTraceSpan(config->trace, threadNum,
+          TraceShuffle, batchNum, phaseStarted);
+        memcpy(batch->cards + tableNum * cardsPerTable, deck, cardsPerTable);
+        recordTraceSpan(config->trace, threadNum, TraceDeal, batchNum,
+          phaseStarted);
+      }
+    }
+    for(; tableNum < batch->numOfTables; tableNum ++)
+    {
+      shuffleCardIndices(& rng, deck, STD_DECK_SIZE, cardsPerTable);
+      memcpy(batch->cards + tableNum * cardsPerTable, deck, cardsPerTable);
+    }
+    if(traceSampled(config->trace, batchNum))
+    {
+      recordTraceSpan(config->trace, threadNum, TraceBatch, batchNum,
+        batchStarted);
+    }
+    metrics->batches ++;
+    metrics->tables += numOfTables;
+    if(passBatch(& context->dealt[producerNum * config->numOfEvaluators +
+      batchNum % config->numOfEvaluators], & context->stop, batch, metrics,
+      config->trace, threadNum) == FALSE)
+    {
+      break;
+    }
+  }
+  metrics->seconds = currentSeconds() - context->started;
+}
+
+/*
+  Function run by an evaluator, ranking every hand of its batches and
+  finding the winners of each table.
+
+  Input   = {pipelineContext *: context, int: evaluatorNum}
+  Output  = {void: NULL}
+*/
+static void evaluateBatches(pipelineContext * context, int evaluatorNum)
+{
+  const pipelineConfig * config = context->config;
+  const int numOfPlayers = config->numOfPlayers;
+  const int cardsPerTable = context->cardsPerTable;
+  const int threadNum = 1 + config->numOfProducers + evaluatorNum;
+  stageMetrics * metrics = & context->report->evaluators[evaluatorNum];
+  handStrength strengths[MAX_PLAYERS];
+  handStrength best = 0;
+  tableBatch * batch = NULL;
+  const unsigned char * cards = NULL;
+  uint64_t batchNum = 0;
+  double batchStarted = 0.0;
+  double phaseStarted = 0.0;
+  bool traced = FALSE;
+  int tableNum = 0;
+  int playrNum = NUM_INIT;
+
+  for(batchNum = evaluatorNum; batchNum < context->numOfBatches;
+    batchNum += config->numOfEvaluators)
+  {
+    batch = takeBatch(& context->dealt[(batchNum % config->numOfProducers) *
+      config->numOfEvaluators + evaluatorNum], & context->stop, metrics,
+      config->trace, threadNum, batchNum);
+    if(batch == NULL)
+    {
+      break;
+    }
+    traced = traceSampled(config->trace, batchNum) ? TRUE : FALSE;
+    batchStarted = (traced == TRUE) ? currentSeconds() : 0.0;
+    for(tableNum = 0; tableNum < batch->numOfTables; tableNum ++)
+    {
+      cards = batch->cards + tableNum * cardsPerTable;
+      if((traced == FALSE) || (tableNum >= TRACE_TABLES_PER_BATCH))
+      {
+        /* The best hand is held by the lowest winner */
+        batch->winners[tableNum] = context->showdown(cards, strengths);
+        batch->categories[tableNum] = strengthCategory(
+          strengths[__builtin_ctz(batch->winners[tableNum])]);
+        continue;
+      }
+      /* The phases of the first tables of a traced batch are timed apart */
+      phaseStarted = currentSeconds();
+      best = 0;
+      for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+      {
+        strengths[playrNum] = evaluateCardIndices(
+          cards + playrNum * CARDS_PER_HAND, CARDS_PER_HAND);
+        best = (strengths[playrNum] > best) ? strengths[playrNum] : best;
+      }
+      phaseStarted = recordTraceSpan(config->trace, threadNum,
+        TraceEvaluate, batchNum, phaseStarted);
+      batch->winners[tableNum] = findWinners(strengths, numOfPlayers);
+      batch->categories[tableNum] = strengthCategory(best);
+      recordTraceSpan(config->trace, threadNum, TraceShowdown, batchNum,
+        phaseStarted);
+    }
+    if(traced == TRUE)
+    {
+      recordTraceSpan(config->trace, threadNum, TraceBatch, batchNum,
+        batchStarted);
+    }
+    metrics->batches ++;
+    metrics->tables += batch->numOfTables;
+    if(passBatch(& context->evaluated[evaluatorNum], & context->stop, batch,
+      metrics, config->trace, threadNum) == FALSE)
+    {
+      break;
+    }
+  }
+  metrics->seconds = currentSeconds() - context->started;
+}
+
+/*
+  Function to write the tables of a batch as text, one line per table with
+  the seats' cards and the winning seats and hand rank.
+
+  Input   = {pipelineContext *: context, tableBatch *: batch}
+  Output  = {bool: success}
+*/
+static bool writeTextBatch(const pipelineContext * context,
+  const tableBatch * batch)
+{
+  const char * rankNames = "A23456789TJQK";
+  const char * suitNames = "HDCS";
+  const int numOfPlayers = context->config->numOfPlayers;
+  const unsigned char * cards = NULL;
+  char line[DEAL_LINE_SIZE];
+  int length = 0;
+  int tableNum = 0;
+  int playrNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  for(tableNum = 0; tableNum < batch->numOfTables; tableNum ++)
+  {
+    cards = batch->cards + tableNum * context->cardsPerTable;
+    length = 0;
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        line[length ++] = rankNames[* cards / NUM_OF_SUITS];
+        line[length ++] = suitNames[* cards % NUM_OF_SUITS];
+        line[length ++] = ' ';
+        cards ++;
+      }
+      line[length ++] = '|';
+      line[length ++] = ' ';
+    }
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      if((batch->winners[tableNum] >> playrNum) & 1u)
+      {
+        length += snprintf(line + length, sizeof(line) - length, "%d ",
+          playrNum + 1);
+      }
+    }
+    length += snprintf(line + length, sizeof(line) - length, "%s\n",
+      handRanks[batch->categories[tableNum]]);
+    if(fwrite(line, 1, length, context->config->output) != (size_t)length)
+    {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/*
+  Function to write the tables of a batch as binary deal records.
+
+  Input   = {pipelineContext *: context, tableBatch *: batch}
+  Output  = {bool: success}
+*/
+static bool writeBinaryBatch(const pipelineContext * context,
+  const tableBatch * batch)
+{
+  FILE * output = context->config->output;
+  const int cardsPerTable = context->cardsPerTable;
+  int tableNum = 0;
+
+  for(tableNum = 0; tableNum < batch->numOfTables; tableNum ++)
+  {
+    if((fwrite(batch->cards + tableNum * cardsPerTable, 1, cardsPerTable,
+      output) != (size_t)cardsPerTable) ||
+      (fwrite(& batch->winners[tableNum], WINNER_MASK_SIZE, 1, output) != 1))
+    {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/*
+  Function run by the writer, writing the batches in order and handing each
+  back to its producer.
+
+  Input   = {pipelineContext *: context}
+  Output  = {void: NULL}
+*/
+static void writeBatches(pipelineContext * context)
+{
+  const pipelineConfig * config = context->config;
+  pipelineReport * report = context->report;
+  stageMetrics * metrics = & report->writer;
+  dealFileHeader header;
+  tableBatch * batch = NULL;
+  uint64_t batchNum = 0;
+  double outputStarted = 0.0;
+
+  if(config->format == DealBinary)
+  {
+    memset(& header, 0, sizeof(header));
+    memcpy(header.magic, DEAL_FILE_MAGIC, DEAL_MAGIC_SIZE);
+    header.numOfPlayers = config->numOfPlayers;
+    header.recordSize = context->cardsPerTable + WINNER_MASK_SIZE;
+    header.numOfTables = config->numOfTables;
+    header.seed = config->seed;
+    if(fwrite(& header, sizeof(header), 1, config->output) != 1)
+    {
+      report->written = FALSE;
+    }
+  }
+  for(batchNum = 0; batchNum < context->numOfBatches; batchNum ++)
+  {
+    batch = takeBatch(& context->evaluated[batchNum %
+      config->numOfEvaluators], & context->stop, metrics, config->trace, 0,
+      batchNum);
+    outputStarted = currentSeconds();
+    /* After a failed write the batches still flow so the stages finish */
+    if((report->written == TRUE) && (config->format == DealText))
+    {
+      report->written = writeTextBatch(context, batch);
+    }
+    else if((report->written == TRUE) && (config->format == DealBinary))
+    {
+      report->written = writeBinaryBatch(context, batch);
+    }
+    if(traceSampled(config->trace, batchNum))
+    {
+      recordTraceSpan(config->trace, 0, TraceOutput, batchNum,
+        outputStarted);
+    }
+    metrics->batches ++;
+    metrics->tables += batch->numOfTables;
+    passBatch(& context->free[batch->producer], & context->stop, batch,
+      metrics, config->trace, 0);
+  }
+  if((config->format != DealNone) && (fflush(config->output) != 0))
+  {
+    report->written = FALSE;
+  }
+  metrics->seconds = currentSeconds() - context->started;
+}
+
+/*
+  Function to make every waiting stage give up, called when not every stage
+  could be started.
+
+  Input   = {void *: context}
+  Output  = {void: NULL}
+*/
+static void stopPipeline(void * argument)
+{
+  pipelineContext * context = argument;
+
+  atomic_store_explicit(& context->stop, 1, memory_order_release);
+}
+
+/*
+  Function run by every pipeline thread: thread 0 writes, the next
+  numOfProducers produce and the rest evaluate.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void pipelineThread(void * argument, int threadNum)
+{
+  pipelineContext * context = argument;
+  const int numOfProducers = context->config->numOfProducers;
+
+  if(threadNum == 0)
+  {
+    writeBatches(context);
+  }
+  else if(threadNum <= numOfProducers)
+  {
+    produceBatches(context, threadNum - 1);
+  }
+  else
+  {
+    evaluateBatches(context, threadNum - 1 - numOfProducers);
+  }
+}
+
+/*
+  Function to deal tables through the producer, evaluator and writer
+  stages.
+
+  Input   = {pipelineConfig *: config, pipelineReport *: report}
+  Output  = {bool: success}
+*/
+bool runPipeline(const pipelineConfig * config, pipelineReport * report)
+{
+  pipelineContext context;
+  const int numOfProducers = config->numOfProducers;
+  const int numOfEvaluators = config->numOfEvaluators;
+  const int numOfBatchesHeld = numOfProducers * PIPELINE_POOL_BATCHES;
+  tableBatch * batch = NULL;
+  size_t batchSize = 0;
+  int batchNum = 0;
+  int ringNum = 0;
+  bool success = FALSE;
+
+  memset(report, 0, sizeof(* report));
+  report->written = TRUE;
+  if((config->numOfPlayers < MIN_PLAYERS) ||
+    (config->numOfPlayers > MAX_PLAYERS) || (numOfProducers < 1) ||
+    (numOfProducers > MAX_STAGE_THREADS) || (numOfEvaluators < 1) ||
+    (numOfEvaluators > MAX_STAGE_THREADS) ||
+    ((config->format != DealNone) && (config->output == NULL)))
+  {
+    return FALSE;
+  }
+  memset(& context, 0, sizeof(context));
+  context.config = config;
+  context.report = report;
+  context.numOfBatches = (config->numOfTables + TABLES_PER_BATCH - 1) /
+    TABLES_PER_BATCH;
+  context.cardsPerTable = config->numOfPlayers * CARDS_PER_HAND;
+  context.showdown = selectShowdownKernel(config->numOfPlayers);
+  batchSize = arenaBytes(sizeof(tableBatch), 1) + TABLES_PER_BATCH *
+    context.cardsPerTable;
+
+  /* One arena holds every batch and ring. A batch's cards are first
+     written by its producer, so under first touch they lie on the
+     producer's node */
+  if((createArena(& context.arena, arenaBytes(batchSize, numOfBatchesHeld) +
+    arenaBytes(sizeof(spscRing), numOfProducers * numOfEvaluators +
+    numOfEvaluators + numOfProducers), config->backing) == TRUE) &&
+    (createPool(& context.batches, & context.arena, batchSize,
+    numOfBatchesHeld) == TRUE))
+  {
+    context.dealt = arenaAlloc(& context.arena,
+      sizeof(spscRing) * numOfProducers * numOfEvaluators);
+    context.evaluated = arenaAlloc(& context.arena,
+      sizeof(spscRing) * numOfEvaluators);
+    context.free = arenaAlloc(& context.arena,
+      sizeof(spscRing) * numOfProducers);
+  }
+
+  if((context.dealt != NULL) && (context.evaluated != NULL) &&
+    (context.free != NULL))
+  {
+    for(ringNum = 0; ringNum < numOfProducers * numOfEvaluators; ringNum ++)
+    {
+      initRing(& context.dealt[ringNum]);
+    }
+    for(ringNum = 0; ringNum < numOfEvaluators; ringNum ++)
+    {
+      initRing(& context.evaluated[ringNum]);
+    }
+    for(ringNum = 0; ringNum < numOfProducers; ringNum ++)
+    {
+      initRing(& context.free[ringNum]);
+    }
+    if(config->trace != NULL)
+    {
+      nameTraceThread(config->trace, 0, "writer", INVALID_INT);
+      for(ringNum = 0; ringNum < numOfProducers; ringNum ++)
+      {
+        nameTraceThread(config->trace, 1 + ringNum, "producer", ringNum);
+      }
+      for(ringNum = 0; ringNum < numOfEvaluators; ringNum ++)
+      {
+        nameTraceThread(config->trace, 1 + numOfProducers + ringNum,
+          "evaluator", ringNum);
+      }
+    }
+    /* Every producer starts with its pool of batches free */
+    for(batchNum = 0; batchNum < numOfBatchesHeld; batchNum ++)
+    {
+      batch = poolTake(& context.batches);
+      batch->producer = batchNum / PIPELINE_POOL_BATCHES;
+      batch->cards = (unsigned char *)batch +
+        arenaBytes(sizeof(tableBatch), 1);
+      ringPush(& context.free[batch->producer], batch);
+    }
+    /* The stages wait on each other, so they all run or none does */
+    atomic_init(& context.stop, 0);
+    context.started = currentSeconds();
+    success = (runTogether(1 + numOfProducers + numOfEvaluators,
+      pipelineThread, & context, stopPipeline) ==
+      1 + numOfProducers + numOfEvaluators) ? TRUE : FALSE;
+    report->seconds = currentSeconds() - context.started;
+  }
+  clearMemoryReport(& report->memory);
+  addArenaReport(& report->memory, & context.arena);
+  freeArena(& context.arena);
+  return success;
+}
+
+/*
+  Function to read the header of a binary deal file.
+
+  Input   = {FILE *: input, dealFileHeader *: header}
+  Output  = {bool: success}
+*/
+bool readDealHeader(FILE * input, dealFileHeader * header)
+{
+  if((fread(header, sizeof(* header), 1, input) != 1) ||
+    (memcmp(header->magic, DEAL_FILE_MAGIC, DEAL_MAGIC_SIZE) != 0) ||
+    (header->numOfPlayers < MIN_PLAYERS) ||
+    (header->numOfPlayers > MAX_PLAYERS) ||
+    (header->recordSize != header->numOfPlayers * CARDS_PER_HAND +
+    WINNER_MASK_SIZE))
+  {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*
+  Function to read the next table of a binary deal file.
+
+  Input   = {FILE *: input, dealFileHeader *: header, unsigned char *: cards,
+            unsigned int *: winners}
+  Output  = {bool: success}
+*/
+bool readDealRecord(FILE * input, const dealFileHeader * header,
+  unsigned char * cards, unsigned int * winners)
+{
+  const size_t cardsPerTable = header->numOfPlayers * CARDS_PER_HAND;
+  unsigned short mask = 0;
+
+  if((fread(cards, 1, cardsPerTable, input) != cardsPerTable) ||
+    (fread(& mask, WINNER_MASK_SIZE, 1, input) != 1))
+  {
+    return FALSE;
+  }
+  * winners = mask;
+  return TRUE;
+}
@@ -0,0 +1,232 @@
+#ifndef PokerPipeline_h
+#define PokerPipeline_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Cache line size and most threads a run can have */
+#include "PokerThreads.h"
+/* Timelines of the phases of sampled batches */
+#include "PokerTrace.h"
+/* Arena holding the batches and the rings */
+#include "PokerArena.h"
+
+/*
+  stdatomic.h is included for the ring indices, stdint.h for the table counts
+  and stdio.h for the output file.
+*/
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Slots of every ring, a power of two */
+#define PIPELINE_RING_SLOTS 8
+/* Batches each producer deals into, at most the slots of a ring */
+#define PIPELINE_POOL_BATCHES 8
+/* Most producer or evaluator threads */
+#define MAX_STAGE_THREADS 64
+/* Magic number starting a binary deal file */
+#define DEAL_FILE_MAGIC "PKRDEAL1"
+#define DEAL_MAGIC_SIZE 8
+
+/* Output formats of the dealt tables */
+typedef enum dealFormat
+{
+  DealNone, DealText, DealBinary
+} dealFormat;
+
+/*
+  Single producer single consumer ring structure
+
+  A bounded lock-free queue of pointers between exactly two threads. The
+  indices only grow, the ring is full when they are PIPELINE_RING_SLOTS
+  apart. Each side keeps the last value it read of the other side's index,
+  so it only touches the other side's cache line when the ring looks full
+  or empty.
+
+    tail       - next slot the producer fills, written by the producer
+    cachedHead - producer's copy of head
+    head       - next slot the consumer empties, written by the consumer
+    cachedTail - consumer's copy of tail
+    slots      - the queued pointers
+*/
+typedef struct spscRing
+{
+  atomic_uint tail;
+  unsigned int cachedHead;
+  char tailPadding[CACHE_LINE_SIZE];
+  atomic_uint head;
+  unsigned int cachedTail;
+  char headPadding[CACHE_LINE_SIZE];
+  void * slots[PIPELINE_RING_SLOTS];
+} spscRing;
+
+/*
+  Stage metrics structure
+
+  What one stage thread did during a run. Waits are the time spent with an
+  empty input ring (starved) or a full output ring (held back), the rest of
+  the thread's time is busy. The depth is that of the thread's input ring
+  each time it takes a batch, the free batches for a producer.
+
+    batches       - batches handled
+    tables        - tables handled
+    seconds       - time from the start of the run to the thread's end
+    starved       - seconds waiting for input
+    heldBack      - seconds waiting for room to pass a batch on
+    depthSum      - sum of the input depths seen
+    depthSamples  - input depths seen
+    maxDepth      - deepest input seen
+*/
+typedef struct stageMetrics
+{
+  uint64_t batches;
+  uint64_t tables;
+  double seconds;
+  double starved;
+  double heldBack;
+  uint64_t depthSum;
+  uint64_t depthSamples;
+  unsigned int maxDepth;
+} stageMetrics;
+
+/*
+  Pipeline configuration structure
+
+    numOfPlayers    - seats at every table
+    numOfTables     - tables dealt
+    seed            - seed of the generator streams, batch b of
+                      TABLES_PER_BATCH tables using stream b as the
+                      simulation does
+    numOfProducers  - threads shuffling and dealing
+    numOfEvaluators - threads ranking hands and finding the winners
+    format          - how the writer thread outputs each table
+    output          - file the tables go to
+    trace           - trace the stages record the phases and waits of the
+                      sampled batches in, NULL for none; the writer is
+                      thread 0, then come the producers and the evaluators
+    backing         - arenaBacking of the arena holding the batches and the
+                      rings
+*/
+typedef struct pipelineConfig
+{
+  int numOfPlayers;
+  uint64_t numOfTables;
+  uint64_t seed;
+  int numOfProducers;
+  int numOfEvaluators;
+  dealFormat format;
+  FILE * output;
+  pokerTrace * trace;
+  int backing;
+} pipelineConfig;
+
+/*
+  Pipeline report structure
+
+    seconds    - wall time of the run
+    producers  - metrics of each producer
+    evaluators - metrics of each evaluator
+    writer     - metrics of the writer
+    memory     - size and peak usage of the arena of the run
+    written    - FALSE when the output could not be written
+*/
+typedef struct pipelineReport
+{
+  double seconds;
+  stageMetrics producers[MAX_STAGE_THREADS];
+  stageMetrics evaluators[MAX_STAGE_THREADS];
+  stageMetrics writer;
+  memoryReport memory;
+  bool written;
+} pipelineReport;
+
+/*
+  Binary deal file header structure, followed by one record per table of
+  numOfPlayers * CARDS_PER_HAND card indices, seat by seat, and the winner
+  mask as two bytes, bit s set when seat s wins or ties. Numbers are stored
+  in the byte order of the machine.
+
+    magic        - DEAL_FILE_MAGIC
+    numOfPlayers - seats at every table
+    recordSize   - bytes of every record
+    numOfTables  - records in the file
+    seed         - seed the tables were dealt with
+*/
+typedef struct dealFileHeader
+{
+  char magic[DEAL_MAGIC_SIZE];
+  uint32_t numOfPlayers;
+  uint32_t recordSize;
+  uint64_t numOfTables;
+  uint64_t seed;
+} dealFileHeader;
+
+/*
+  Function to empty a ring.
+
+  Input   = {spscRing *: ring}
+  Output  = {void: NULL}
+*/
+void initRing(spscRing *);
+
+/*
+  Function to queue a pointer, called only by the ring's producer.
+
+  Input   = {spscRing *: ring, void *: item}
+  Output  = {bool: queued}, FALSE when the ring is full
+*/
+bool ringPush(spscRing *, void *);
+
+/*
+  Function to take the oldest pointer, called only by the ring's consumer.
+
+  Input   = {spscRing *: ring}
+  Output  = {void *: item}, NULL when the ring is empty
+*/
+void * ringPop(spscRing *);
+
+/*
+  Function to count the pointers queued, exact for the consumer and a lower
+  bound for anybody else.
+
+  Input   = {spscRing *: ring}
+  Output  = {unsigned int: depth}
+*/
+unsigned int ringDepth(spscRing *);
+
+/*
+  Function to deal tables through a pipeline of producer threads that
+  shuffle and deal, evaluator threads that rank the hands and find the
+  winners and one writer thread that outputs the tables, connected by
+  bounded single producer single consumer rings of batches. Every stage
+  waits when its input is empty or its output is full, so the slowest stage
+  sets the pace, and the metrics show which one it is. Batches are written
+  in order, so the output only depends on the seed. The stages need all
+  their threads running at once, numOfProducers + numOfEvaluators + 1 of
+  them, and when one cannot be started the others are stopped.
+
+  Input   = {pipelineConfig *: config, pipelineReport *: report}
+  Output  = {bool: success}, FALSE for a bad configuration, no memory or a
+            stage thread that cannot be started
+*/
+bool runPipeline(const pipelineConfig *, pipelineReport *);
+
+/*
+  Function to read the header of a binary deal file.
+
+  Input   = {FILE *: input, dealFileHeader *: header}
+  Output  = {bool: success}
+*/
+bool readDealHeader(FILE *, dealFileHeader *);
+
+/*
+  Function to read the next table of a binary deal file.
+
+  Input   = {FILE *: input, dealFileHeader *: header, unsigned char *: cards,
+            unsigned int *: winners}
+  Output  = {bool: success}, FALSE at the end of the file
+*/
+bool readDealRecord(FILE *, const dealFileHeader *, unsigned char *,
+  unsigned int *);
+
+#endif /* PokerPipeline_h */
@@ -0,0 +1,120 @@
+#include "PokerRandom.h"
+
+/* Golden ratio increment of the splitmix64 sequence */
+#define SPLITMIX_INCREMENT 0x9E3779B97F4A7C15ULL
+
+/*
+  Function to mix a 64 bit value with the splitmix64 finalizer.
+
+  Input   = {uint64_t: value}
+  Output  = {uint64_t: mixed}
+*/
+uint64_t mixSeed(uint64_t value)
+{
+  value += SPLITMIX_INCREMENT;
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+
+/*
+  Function to seed a generator from a seed and a stream number.
+
+  Input   = {pokerRng *: rng, uint64_t: seed, uint64_t: stream}
+  Output  = {void: NULL}
+*/
+void seedRng(pokerRng * rng, uint64_t seed, uint64_t stream)
+{
+  int wordNum = 0;
+  uint64_t mixed = mixSeed(seed) ^ mixSeed(stream * SPLITMIX_INCREMENT + 1);
+
+  /* Expand the combined seed with splitmix64, never leaving an all zero state */
+  for(wordNum = 0; wordNum < RNG_STATE_WORDS; wordNum ++)
+  {
+    mixed += SPLITMIX_INCREMENT;
+    rng->state[wordNum] = mixSeed(mixed);
+  }
+  if((rng->state[0] | rng->state[1] | rng->state[2] | rng->state[3]) == 0)
+  {
+    rng->state[0] = SPLITMIX_INCREMENT;
+  }
+}
+
+/* Rotate a 64 bit value left */
+static inline uint64_t rotateLeft(uint64_t value, int bits)
+{
+  return (value << bits) | (value >> (64 - bits));
+}
+
+/*
+  Function to produce the next 64 random bits of a generator.
+
+  Input   = {pokerRng *: rng}
+  Output  = {uint64_t: bits}
+*/
+uint64_t nextRandom(pokerRng * rng)
+{
+  uint64_t * s = rng->state;
+  const uint64_t result = rotateLeft(s[1] * 5, 7) * 9;
+  const uint64_t shifted = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= shifted;
+  s[3] = rotateLeft(s[3], 45);
+  return result;
+}
+
+/*
+  Function to produce an unbiased random integer in [0, range).
+
+  Input   = {pokerRng *: rng, uint32_t: range}
+  Output  = {uint32_t: value}
+*/
+uint32_t randomBounded(pokerRng * rng, uint32_t range)
+{
+  uint64_t product = (nextRandom(rng) >> 32) * (uint64_t)range;
+  uint32_t low = (uint32_t)product;
+
+  /* Reject the few products that would over-represent low values */
+  if(low < range)
+  {
+    const uint32_t threshold = (uint32_t)(- range) % range;
+    while(low < threshold)
+    {
+      product = (nextRandom(rng) >> 32) * (uint64_t)range;
+      low = (uint32_t)product;
+    }
+  }
+  return (uint32_t)(product >> 32);
+}
+
+/*
+  Function to shuffle the first count entries of an array of card indices.
+  Cards are selected front to back, so the first dealt entries are final as
+  soon as they have been chosen.
+
+  Input   = {pokerRng *: rng, unsigned char *: cards, int: count, int: dealt}
+  Output  = {void: NULL}
+*/
+void shuffleCardIndices(pokerRng * rng, unsigned char * cards, int count,
+  int dealt)
+{
+  int cardNum = 0;
+  unsigned char tempCard = 0;
+  uint32_t selected = 0;
+
+  if(dealt > count - 1)
+  {
+    dealt = count - 1;
+  }
+  for(cardNum = 0; cardNum < dealt; cardNum ++)
+  {
+    selected = cardNum + randomBounded(rng, count - cardNum);
+    tempCard = cards[cardNum];
+    cards[cardNum] = cards[selected];
+    cards[selected] = tempCard;
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef PokerRandom_h
+#define PokerRandom_h
+
+/*
+  stdint.h is included for the fixed width integer types used by the generator
+  state.
+*/
+#include <stdint.h>
+
+/* Number of 64 bit words in the generator state */
+#define RNG_STATE_WORDS 4
+
+/*
+  Random number generator structure
+
+  A pokerRng is a xoshiro256** generator. Unlike rand() every thread can own
+  its own generator, and a generator can be seeded from a (seed, stream) pair
+  so that any stream of a simulation can be reproduced on its own.
+*/
+typedef struct pokerRng
+{
+  uint64_t state[RNG_STATE_WORDS];
+} pokerRng;
+
+/*
+  Function to seed a generator from a seed and a stream number. Different
+  streams of the same seed are statistically independent.
+
+  Input   = {pokerRng *: rng, uint64_t: seed, uint64_t: stream}
+  Output  = {void: NULL}
+*/
+void seedRng(pokerRng *, uint64_t, uint64_t);
+
+/*
+  Function to produce the next 64 random bits of a generator.
+
+  Input   = {pokerRng *: rng}
+  Output  = {uint64_t: bits}
+*/
+uint64_t nextRandom(pokerRng *);
+
+/*
+  Function to produce an unbiased random integer in [0, range) using Lemire's
+  multiply and reject method, replacing the biased rand() % range.
+
+  Input   = {pokerRng *: rng, uint32_t: range}
+  Output  = {uint32_t: value}
+*/
+uint32_t randomBounded(pokerRng *, uint32_t);
+
+/*
+  Function to shuffle the first count entries of an array of card indices with
+  the modern Fisher-Yates algorithm. Only the first dealt entries are
+  guaranteed to be a uniform random selection, so callers that only need a
+  few cards from the top of the deck can pass a smaller dealt count.
+
+  Input   = {pokerRng *: rng, unsigned char *: cards, int: count, int: dealt}
+  Output  = {void: NULL}
+*/
+void shuffleCardIndices(pokerRng *, unsigned char *, int, int);
+
+/*
+  Function to mix a 64 bit value, used to derive seeds.
+
+  Input   = {uint64_t: value}
+  Output  = {uint64_t: mixed}
+*/
+uint64_t mixSeed(uint64_t);
+
+#endif /* PokerRandom_h */
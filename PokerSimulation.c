@@ -0,0 +1,441 @@
+#include "PokerSimulation.h"
+/* Hand strengths and showdowns */
+#include "HandEvaluator.h"
+/* Generator streams and shuffles */
+#include "PokerRandom.h"
+/* Worker threads */
+#include "PokerThreads.h"
+
+/* stdatomic.h is included for the batch counter and the snapshot locks. */
+#include <stdatomic.h>
+/* string.h is included for memcpy. */
+#include <string.h>
+/* time.h is included for nanosleep, the snapshot thread's wait. */
+#include <time.h>
+/* math.h is included for HUGE_VAL, the due time of a disabled snapshot. */
+#include <math.h>
+
+/* Longest single wait of the snapshot thread, so it notices the end quickly */
+#define SNAPSHOT_POLL_SECONDS 0.01
+
+/* Tag of the checkpoints of simulations */
+#define SIMULATION_CHECKPOINT_TAG 0x53494D554C415445ULL
+
+/*
+  Statistics of one worker. The worker alone writes stats and progress, with
+  no atomics. When snapshots or checkpoints are on it copies both to the
+  published copies after each batch under a sequence lock: the sequence is
+  odd while the copy is being written, so the snapshot thread retries any
+  copy that overlapped a write. Each part sits on its own cache lines.
+*/
+typedef struct simulationWorker
+{
+  pokerStats stats;
+  checkpointProgress progress;
+  char statsPadding[CACHE_LINE_SIZE];
+  atomic_uint sequence;
+  pokerStats published;
+  checkpointProgress publishedProgress;
+  char publishedPadding[CACHE_LINE_SIZE];
+} simulationWorker;
+
+/* State shared by the simulation threads */
+typedef struct simulationContext
+{
+  const simulationConfig * config;
+  uint64_t numOfBatches;
+  int numOfWorkers;
+  atomic_ullong nextBatch;
+  atomic_int finishedWorkers;
+  bool publishing;
+  simulationWorker * workers;
+  checkpointState * resumed;
+  pokerStats resumedStats;
+  checkpointState * combined;
+  checkpointProgress * progressCopies;
+  showdownKernel showdown;
+  pokerArena arena;
+} simulationContext;
+
+/*
+  Function to deal and evaluate the tables of one batch. When the batch is
+  sampled the first tables are timed phase by phase and the batch as a
+  whole.
+
+  Input   = {simulationContext *: context, pokerStats *: stats,
+            uint64_t: batchNum, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void dealBatch(const simulationContext * context, pokerStats * stats,
+  uint64_t batchNum, int threadNum)
+{
+  const simulationConfig * config = context->config;
+  const int numOfPlayers = config->numOfPlayers;
+  const bool traced = traceSampled(config->trace, batchNum) ? TRUE : FALSE;
+  unsigned char deck[STD_DECK_SIZE];
+  handStrength strengths[MAX_PLAYERS];
+  pokerRng rng;
+  uint64_t numOfTables = TABLES_PER_BATCH;
+  uint64_t tableNum = 0;
+  unsigned int winners = 0;
+  double batchStarted = (traced == TRUE) ? currentSeconds() : 0.0;
+  double phaseStarted = 0.0;
+  int playrNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  if(batchNum == context->numOfBatches - 1)
+  {
+    numOfTables = config->numOfTables - batchNum * TABLES_PER_BATCH;
+  }
+  seedRng(& rng, config->seed, batchNum);
+  for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    deck[cardNum] = cardNum;
+  }
+  for(tableNum = 0; (traced == TRUE) && (tableNum < numOfTables) &&
+    (tableNum < TRACE_TABLES_PER_BATCH); tableNum ++)
+  {
+    /* The traced tables are dealt exactly as the others below */
+    phaseStarted = currentSeconds();
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE,
+      numOfPlayers * CARDS_PER_HAND);
+    phaseStarted = recordTraceSpan(config->trace, threadNum, TraceShuffle,
+      batchNum, phaseStarted);
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      strengths[playrNum] = evaluateCardIndices(
+        deck + playrNum * CARDS_PER_HAND, CARDS_PER_HAND);
+    }
+    phaseStarted = recordTraceSpan(config->trace, threadNum, TraceEvaluate,
+      batchNum, phaseStarted);
+    winners = findWinners(strengths, numOfPlayers);
+    if(config->recordStats == TRUE)
+    {
+      recordTable(stats, strengths, numOfPlayers, winners);
+    }
+    recordTraceSpan(config->trace, threadNum, TraceShowdown, batchNum,
+      phaseStarted);
+  }
+  for(; tableNum < numOfTables; tableNum ++)
+  {
+    /* Only the dealt cards need shuffling, the rest of the deck carries over */
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE,
+      numOfPlayers * CARDS_PER_HAND);
+    winners = context->showdown(deck, strengths);
+    if(config->recordStats == TRUE)
+    {
+      recordTable(stats, strengths, numOfPlayers, winners);
+    }
+  }
+  if(traced == TRUE)
+  {
+    recordTraceSpan(config->trace, threadNum, TraceBatch, batchNum,
+      batchStarted);
+  }
+}
+
+/*
+  Function to copy a worker's statistics where the snapshot thread reads
+  them.
+
+  Input   = {simulationWorker *: worker}
+  Output  = {void: NULL}
+*/
+static void publishStats(simulationWorker * worker)
+{
+  unsigned int sequence = atomic_load_explicit(& worker->sequence,
+    memory_order_relaxed);
+  atomic_store_explicit(& worker->sequence, sequence + 1,
+    memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  memcpy(& worker->published, & worker->stats, sizeof(pokerStats));
+  memcpy(& worker->publishedProgress, & worker->progress,
+    sizeof(checkpointProgress));
+  atomic_store_explicit(& worker->sequence, sequence + 2,
+    memory_order_release);
+}
+
+/*
+  Function to read a consistent copy of a worker's published statistics and
+  the progress they belong to.
+
+  Input   = {simulationWorker *: worker, pokerStats *: copy,
+            checkpointProgress *: progress}
+  Output  = {void: NULL}
+*/
+static void readPublishedStats(simulationWorker * worker, pokerStats * copy,
+  checkpointProgress * progress)
+{
+  unsigned int before = 0;
+  unsigned int after = 0;
+  do
+  {
+    before = atomic_load_explicit(& worker->sequence, memory_order_acquire);
+    memcpy(copy, & worker->published, sizeof(pokerStats));
+    memcpy(progress, & worker->publishedProgress, sizeof(checkpointProgress));
+    atomic_thread_fence(memory_order_acquire);
+    after = atomic_load_explicit(& worker->sequence, memory_order_relaxed);
+  } while(((before & 1) != 0) || (before != after));
+}
+
+/*
+  Function to wait up to a number of seconds, returning early once every
+  worker has finished.
+
+  Input   = {simulationContext *: context, double: seconds}
+  Output  = {bool: finished}
+*/
+static bool waitForWorkers(simulationContext * context, double seconds)
+{
+  struct timespec pause;
+  double waited = 0.0;
+  double step = 0.0;
+  while(atomic_load(& context->finishedWorkers) < context->numOfWorkers)
+  {
+    if(waited >= seconds)
+    {
+      return FALSE;
+    }
+    step = (seconds - waited < SNAPSHOT_POLL_SECONDS) ?
+      seconds - waited : SNAPSHOT_POLL_SECONDS;
+    pause.tv_sec = (time_t)step;
+    pause.tv_nsec = (long)((step - (double)pause.tv_sec) * 1e9);
+    nanosleep(& pause, NULL);
+    waited += step;
+  }
+  return TRUE;
+}
+
+/*
+  Function run by the snapshot thread, merging the published statistics of
+  every worker until the workers finish, and handing them to the snapshot
+  handler or saving them with the batches they hold as each falls due.
+
+  Input   = {simulationContext *: context}
+  Output  = {void: NULL}
+*/
+static void snapshotLoop(simulationContext * context)
+{
+  const simulationConfig * config = context->config;
+  pokerStats merged;
+  pokerStats copy;
+  double now = currentSeconds();
+  double nextSnapshot = now + config->snapshotSeconds;
+  double nextCheckpoint = now + config->checkpoint.seconds;
+  double nextDue = 0.0;
+  int workerNum = NUM_INIT;
+
+  if(config->snapshot == NULL)
+  {
+    nextSnapshot = HUGE_VAL;
+  }
+  if(config->checkpoint.path == NULL)
+  {
+    nextCheckpoint = HUGE_VAL;
+  }
+  nextDue = (nextSnapshot < nextCheckpoint) ? nextSnapshot : nextCheckpoint;
+  while(waitForWorkers(context, nextDue - now) == FALSE)
+  {
+    memcpy(& merged, & context->resumedStats, sizeof(pokerStats));
+    for(workerNum = NUM_INIT; workerNum < context->numOfWorkers; workerNum ++)
+    {
+      readPublishedStats(& context->workers[workerNum], & copy,
+        & context->progressCopies[workerNum]);
+      mergeStats(& merged, & copy);
+    }
+    now = currentSeconds();
+    if(now >= nextSnapshot)
+    {
+      config->snapshot(& merged, config->snapshotArgument);
+      nextSnapshot = now + config->snapshotSeconds;
+    }
+    if(now >= nextCheckpoint)
+    {
+      /* A failed checkpoint leaves the last one in place until the next */
+      if(combineProgress(context->combined, context->resumed,
+        context->progressCopies, context->numOfWorkers) == TRUE)
+      {
+        writeCheckpoint(config->checkpoint.path, context->combined, & merged,
+          sizeof(pokerStats));
+      }
+      nextCheckpoint = now + config->checkpoint.seconds;
+    }
+    nextDue = (nextSnapshot < nextCheckpoint) ? nextSnapshot : nextCheckpoint;
+    now = currentSeconds();
+  }
+}
+
+/*
+  Function to take the next batch not already held by the resumed
+  checkpoint.
+
+  Input   = {simulationContext *: context}
+  Output  = {uint64_t: batchNum}, numOfBatches when none are left
+*/
+static uint64_t takeBatch(simulationContext * context)
+{
+  uint64_t batchNum = 0;
+  do
+  {
+    batchNum = atomic_fetch_add(& context->nextBatch, 1);
+  } while((batchNum < context->numOfBatches) && (context->resumed != NULL) &&
+    (ticketDone(context->resumed, batchNum) == TRUE));
+  return (batchNum < context->numOfBatches) ? batchNum :
+    context->numOfBatches;
+}
+
+/*
+  Function run by every simulation thread. The thread after the workers, if
+  any, takes the snapshots.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void simulationThread(void * argument, int threadNum)
+{
+  simulationContext * context = argument;
+  simulationWorker * worker = NULL;
+  uint64_t batchNum = 0;
+
+  if(threadNum >= context->numOfWorkers)
+  {
+    snapshotLoop(context);
+    return;
+  }
+  worker = & context->workers[threadNum];
+  clearProgress(& worker->progress);
+  batchNum = takeBatch(context);
+  while(batchNum < context->numOfBatches)
+  {
+    dealBatch(context, & worker->stats, batchNum, threadNum);
+    recordTicket(& worker->progress, batchNum);
+    /* The next batch is taken before publishing, so the published copy
+       names a batch in flight that every later batch is above */
+    batchNum = takeBatch(context);
+    worker->progress.inFlight = batchNum;
+    if(context->publishing == TRUE)
+    {
+      publishStats(worker);
+    }
+  }
+  atomic_fetch_add(& context->finishedWorkers, 1);
+}
+
+/*
+  Function to deal and evaluate a number of tables on several threads.
+
+  Input   = {simulationConfig *: config, pokerStats *: result}
+  Output  = {bool: success}
+*/
+bool runSimulation(const simulationConfig * config, pokerStats * result)
+{
+  simulationContext * context = NULL;
+  uint64_t key = SIMULATION_CHECKPOINT_TAG;
+  int numOfThreads = config->numOfThreads;
+  int workerNum = NUM_INIT;
+  bool success = TRUE;
+
+  clearStats(result);
+  if((config->numOfPlayers < MIN_PLAYERS) ||
+    (config->numOfPlayers > MAX_PLAYERS))
+  {
+    return FALSE;
+  }
+  if(numOfThreads < 1)
+  {
+    numOfThreads = 1;
+  }
+  if(numOfThreads > MAX_THREADS - 1)
+  {
+    numOfThreads = MAX_THREADS - 1;
+  }
+
+  context = calloc(1, sizeof(simulationContext));
+  if(context == NULL)
+  {
+    return FALSE;
+  }
+  context->config = config;
+  context->numOfBatches = (config->numOfTables + TABLES_PER_BATCH - 1) /
+    TABLES_PER_BATCH;
+  context->numOfWorkers = numOfThreads;
+  context->showdown = selectShowdownKernel(config->numOfPlayers);
+  context->publishing = ((config->snapshot != NULL) ||
+    (config->checkpoint.path != NULL)) ? TRUE : FALSE;
+  atomic_init(& context->nextBatch, 0);
+  atomic_init(& context->finishedWorkers, 0);
+  /* The workers' records start on cache lines, so their padding keeps
+     them apart, and the pages each worker writes first are on its node */
+  if(createArena(& context->arena, arenaBytes(sizeof(simulationWorker) *
+    numOfThreads, 1) + arenaBytes(sizeof(checkpointProgress) *
+    numOfThreads, 1) + ((config->checkpoint.path != NULL) ?
+    arenaBytes(sizeof(checkpointState), 2) : 0), config->backing) == TRUE)
+  {
+    context->workers = arenaAlloc(& context->arena,
+      sizeof(simulationWorker) * numOfThreads);
+    context->progressCopies = arenaAlloc(& context->arena,
+      sizeof(checkpointProgress) * numOfThreads);
+  }
+  if(config->checkpoint.path != NULL)
+  {
+    context->resumed = arenaAlloc(& context->arena, sizeof(checkpointState));
+    context->combined = arenaAlloc(& context->arena,
+      sizeof(checkpointState));
+    success = ((context->resumed != NULL) && (context->combined != NULL)) ?
+      TRUE : FALSE;
+  }
+  success = ((context->workers != NULL) &&
+    (context->progressCopies != NULL)) ? success : FALSE;
+
+  /* Everything the statistics depend on goes in the key */
+  key = mixCheckpointKey(key, config->numOfPlayers);
+  key = mixCheckpointKey(key, config->numOfTables);
+  key = mixCheckpointKey(key, config->seed);
+  key = mixCheckpointKey(key, config->recordStats);
+  key = mixCheckpointKey(key, TABLES_PER_BATCH);
+  key = mixCheckpointKey(key, sizeof(pokerStats));
+  if((success == TRUE) && (context->resumed != NULL))
+  {
+    clearCheckpoint(context->resumed, key, context->numOfBatches);
+    if(config->checkpoint.resume == TRUE)
+    {
+      success = readCheckpoint(config->checkpoint.path, context->resumed,
+        & context->resumedStats, sizeof(pokerStats));
+    }
+  }
+
+  if(success == TRUE)
+  {
+    for(workerNum = NUM_INIT; workerNum < numOfThreads; workerNum ++)
+    {
+      atomic_init(& context->workers[workerNum].sequence, 0);
+      if(config->trace != NULL)
+      {
+        nameTraceThread(config->trace, workerNum, "worker", workerNum);
+      }
+    }
+    runParallel((context->publishing == TRUE) ? numOfThreads + 1 :
+      numOfThreads, simulationThread, context);
+    mergeStats(result, & context->resumedStats);
+    for(workerNum = NUM_INIT; workerNum < numOfThreads; workerNum ++)
+    {
+      mergeStats(result, & context->workers[workerNum].stats);
+    }
+  }
+  if((success == TRUE) && (context->combined != NULL))
+  {
+    /* The last checkpoint holds every batch */
+    clearCheckpoint(context->combined, key, context->numOfBatches);
+    context->combined->watermark = context->numOfBatches;
+    success = writeCheckpoint(config->checkpoint.path, context->combined,
+      result, sizeof(pokerStats));
+  }
+  if(config->memory != NULL)
+  {
+    clearMemoryReport(config->memory);
+    addArenaReport(config->memory, & context->arena);
+  }
+  freeArena(& context->arena);
+  free(context);
+  return success;
+}
@@ -0,0 +1,86 @@
+#ifndef PokerSimulation_h
+#define PokerSimulation_h
+
+/* Macros and types of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Statistics of the simulated tables */
+#include "PokerStats.h"
+/* Checkpoints of the batches dealt */
+#include "PokerCheckpoint.h"
+/* Timelines of the phases of sampled batches */
+#include "PokerTrace.h"
+/* Arenas holding the workers' statistics */
+#include "PokerArena.h"
+
+/*
+  stdint.h is included for the table counts and the seed.
+*/
+#include <stdint.h>
+
+/*
+  Tables dealt from one generator stream. Batch b always uses stream b of the
+  seed, so a simulation gives the same statistics on any number of threads.
+*/
+#define TABLES_PER_BATCH 4096
+
+/*
+  Snapshot handler type
+
+  A snapshot handler receives the statistics merged so far and the argument
+  given with it. It runs on the snapshot thread while the workers go on.
+*/
+typedef void (* snapshotHandler)(const pokerStats *, void *);
+
+/*
+  Simulation configuration structure
+
+    numOfPlayers     - seats dealt at every table
+    numOfTables      - tables to deal
+    seed             - seed of the generator streams
+    numOfThreads     - worker threads
+    recordStats      - FALSE to only deal and evaluate, for timing
+    snapshotSeconds  - time between snapshots
+    snapshot         - snapshot handler, NULL for no snapshots
+    snapshotArgument - argument passed to the snapshot handler
+    checkpoint       - file the batches dealt and their statistics are saved
+                       to and whether to resume from it
+    trace            - trace the workers record the phases of the sampled
+                       batches in, worker w as thread w, NULL for none
+    backing          - arenaBacking of the arena holding the workers'
+                       statistics and the checkpoint state
+    memory           - report of that arena's size and peak usage, NULL
+                       for none
+*/
+typedef struct simulationConfig
+{
+  int numOfPlayers;
+  uint64_t numOfTables;
+  uint64_t seed;
+  int numOfThreads;
+  bool recordStats;
+  double snapshotSeconds;
+  snapshotHandler snapshot;
+  void * snapshotArgument;
+  checkpointConfig checkpoint;
+  pokerTrace * trace;
+  int backing;
+  memoryReport * memory;
+} simulationConfig;
+
+/*
+  Function to deal and evaluate a number of tables on several threads. Each
+  thread adds into its own statistics, which are merged when all tables are
+  dealt, and, when a snapshot handler or a checkpoint file is given, copied
+  out at batch boundaries for the snapshot thread to merge. The snapshot
+  thread also writes the checkpoints, so the workers never wait for the
+  disk, and a last checkpoint holding every batch is written at the end.
+  Statistics are sums over batches, so a resumed run ends with exactly the
+  statistics of an uninterrupted one.
+
+  Input   = {simulationConfig *: config, pokerStats *: result}
+  Output  = {bool: success}, FALSE for a bad number of players, a checkpoint
+            that cannot be resumed or written, or too little memory
+*/
+bool runSimulation(const simulationConfig *, pokerStats *);
+
+#endif /* PokerSimulation_h */
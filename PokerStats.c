@@ -0,0 +1,279 @@
+#include "PokerStats.h"
+
+/* string.h is included for memset and strcmp. */
+#include <string.h>
+
+/* Names of the hand ranks, from PokerTable.c */
+extern char * handRanks[NUM_OF_HAND_RANKS];
+/* Names of the ranks, from PokerTable.c */
+extern char * namedRanks[NUM_OF_RANKS];
+
+/* Rank name of an ace high value, 0 for a Two up to 12 for an Ace */
+#define valueName(value) namedRanks[((value) + 1) % NUM_OF_RANKS]
+
+/*
+  Function to clear a set of statistics.
+
+  Input   = {pokerStats *: stats}
+  Output  = {void: NULL}
+*/
+void clearStats(pokerStats * stats)
+{
+  memset(stats, 0, sizeof(* stats));
+}
+
+/*
+  Function to record one table.
+
+  Input   = {pokerStats *: stats, handStrength *: strengths,
+            int: numOfHands, unsigned int: winnerMask}
+  Output  = {void: NULL}
+*/
+void recordTable(pokerStats * stats, const handStrength * strengths,
+  int numOfHands, unsigned int winnerMask)
+{
+  unsigned int present = 0;
+  unsigned int repeated = 0;
+  unsigned int rankBit = 0;
+  int playrNum = NUM_INIT;
+  pokerRank winningCategory = HighCard;
+
+  stats->tables ++;
+  for(playrNum = NUM_INIT; playrNum < numOfHands; playrNum ++)
+  {
+    rankBit = 1u << strengthCategory(strengths[playrNum]);
+    stats->categoryBySeat[playrNum][strengthCategory(strengths[playrNum])] ++;
+    stats->strengthHistogram[strengthBucket(strengths[playrNum])] ++;
+    repeated |= present & rankBit;
+    present |= rankBit;
+  }
+  stats->ranksPresent[present] ++;
+  stats->ranksRepeated[repeated] ++;
+
+  /* Every winner holds the same strength, the lowest winner stands for all */
+  playrNum = __builtin_ctz(winnerMask);
+  winningCategory = strengthCategory(strengths[playrNum]);
+  stats->winningHistogram[strengthBucket(strengths[playrNum])] ++;
+  if((winnerMask & (winnerMask - 1)) == 0)
+  {
+    stats->winsByCategory[winningCategory] ++;
+  }
+  else
+  {
+    stats->tiesByCategory[winningCategory] ++;
+  }
+}
+
+/*
+  Function to count the tables holding a hand of each of two ranks.
+
+  Input   = {pokerStats *: stats, pokerRank: first, pokerRank: second}
+  Output  = {uint64_t: tables}
+*/
+uint64_t coOccurrence(const pokerStats * stats, pokerRank first,
+  pokerRank second)
+{
+  const unsigned int wanted = (1u << first) | (1u << second);
+  const uint64_t * tablesBySet = (first == second) ?
+    stats->ranksRepeated : stats->ranksPresent;
+  unsigned int rankSet = 0;
+  uint64_t tables = 0;
+
+  for(rankSet = 0; rankSet < (1u << NUM_OF_HAND_RANKS); rankSet ++)
+  {
+    if((rankSet & wanted) == wanted)
+    {
+      tables += tablesBySet[rankSet];
+    }
+  }
+  return tables;
+}
+
+/*
+  Function to add one set of statistics into another. Every member is a
+  counter, so the structure is added as a flat array.
+
+  Input   = {pokerStats *: total, pokerStats *: part}
+  Output  = {void: NULL}
+*/
+void mergeStats(pokerStats * total, const pokerStats * part)
+{
+  uint64_t * totalCounters = (uint64_t *)total;
+  const uint64_t * partCounters = (const uint64_t *)part;
+  size_t counterNum = 0;
+  for(counterNum = 0; counterNum < sizeof(pokerStats) / sizeof(uint64_t);
+    counterNum ++)
+  {
+    totalCounters[counterNum] += partCounters[counterNum];
+  }
+}
+
+/*
+  Function to read the name of an export format.
+
+  Input   = {char *: name, statsFormat *: format}
+  Output  = {bool: success}
+*/
+bool parseStatsFormat(const char * name, statsFormat * format)
+{
+  if(strcmp(name, "csv") == 0)
+  {
+    * format = StatsCsv;
+  }
+  else if(strcmp(name, "json") == 0)
+  {
+    * format = StatsJson;
+  }
+  else if(strcmp(name, "none") == 0)
+  {
+    * format = StatsNone;
+  }
+  else
+  {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/* Write one CSV row */
+static void writeCsvRow(FILE * stream, const char * table, const char * row,
+  const char * column, uint64_t count)
+{
+  fprintf(stream, "%s,%s,%s,%llu\n", table, row, column,
+    (unsigned long long)count);
+}
+
+/* Write the statistics as CSV */
+static void writeStatsCsv(FILE * stream, const pokerStats * stats,
+  int numOfSeats)
+{
+  char seatName[16];
+  char bucketName[32];
+  int playrNum = NUM_INIT;
+  int rankNum = NUM_INIT;
+  int otherNum = NUM_INIT;
+  int bucketNum = NUM_INIT;
+
+  fprintf(stream, "table,row,column,count\n");
+  writeCsvRow(stream, "tables", "all", "all", stats->tables);
+  for(playrNum = NUM_INIT; playrNum < numOfSeats; playrNum ++)
+  {
+    snprintf(seatName, sizeof(seatName), "seat %d", playrNum + 1);
+    for(rankNum = NUM_INIT; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+    {
+      writeCsvRow(stream, "categoryBySeat", seatName, handRanks[rankNum],
+        stats->categoryBySeat[playrNum][rankNum]);
+    }
+  }
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+  {
+    writeCsvRow(stream, "winsByCategory", handRanks[rankNum], "wins",
+      stats->winsByCategory[rankNum]);
+    writeCsvRow(stream, "winsByCategory", handRanks[rankNum], "ties",
+      stats->tiesByCategory[rankNum]);
+  }
+  for(bucketNum = NUM_INIT; bucketNum < STRENGTH_BUCKETS; bucketNum ++)
+  {
+    snprintf(bucketName, sizeof(bucketName), "%s %s",
+      handRanks[bucketNum / NUM_OF_RANKS],
+      valueName(bucketNum % NUM_OF_RANKS));
+    writeCsvRow(stream, "strengthHistogram", bucketName, "dealt",
+      stats->strengthHistogram[bucketNum]);
+    writeCsvRow(stream, "strengthHistogram", bucketName, "won",
+      stats->winningHistogram[bucketNum]);
+  }
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+  {
+    for(otherNum = NUM_INIT; otherNum < NUM_OF_HAND_RANKS; otherNum ++)
+    {
+      writeCsvRow(stream, "coOccurrence", handRanks[rankNum],
+        handRanks[otherNum], coOccurrence(stats, rankNum, otherNum));
+    }
+  }
+}
+
+/* Write an array of counters as a JSON array */
+static void writeJsonArray(FILE * stream, const uint64_t * counters,
+  int numOfCounters)
+{
+  int counterNum = NUM_INIT;
+  fprintf(stream, "[");
+  for(counterNum = NUM_INIT; counterNum < numOfCounters; counterNum ++)
+  {
+    fprintf(stream, "%s%llu", (counterNum > 0) ? ", " : "",
+      (unsigned long long)counters[counterNum]);
+  }
+  fprintf(stream, "]");
+}
+
+/* Write the statistics as a JSON object */
+static void writeStatsJson(FILE * stream, const pokerStats * stats,
+  int numOfSeats)
+{
+  uint64_t pairCounts[NUM_OF_HAND_RANKS];
+  int playrNum = NUM_INIT;
+  int rankNum = NUM_INIT;
+  int otherNum = NUM_INIT;
+
+  fprintf(stream, "{\n  \"tables\": %llu,\n  \"categories\": [",
+    (unsigned long long)stats->tables);
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+  {
+    fprintf(stream, "%s\"%s\"", (rankNum > 0) ? ", " : "",
+      handRanks[rankNum]);
+  }
+  fprintf(stream, "],\n  \"categoryBySeat\": [\n");
+  for(playrNum = NUM_INIT; playrNum < numOfSeats; playrNum ++)
+  {
+    fprintf(stream, "    ");
+    writeJsonArray(stream, stats->categoryBySeat[playrNum],
+      NUM_OF_HAND_RANKS);
+    fprintf(stream, "%s\n", (playrNum + 1 < numOfSeats) ? "," : "");
+  }
+  fprintf(stream, "  ],\n  \"winsByCategory\": ");
+  writeJsonArray(stream, stats->winsByCategory, NUM_OF_HAND_RANKS);
+  fprintf(stream, ",\n  \"tiesByCategory\": ");
+  writeJsonArray(stream, stats->tiesByCategory, NUM_OF_HAND_RANKS);
+  fprintf(stream, ",\n  \"strengthBuckets\": \"rank * 13 + leading card "
+    "(0 = Two ... 12 = Ace)\",\n  \"strengthHistogram\": ");
+  writeJsonArray(stream, stats->strengthHistogram, STRENGTH_BUCKETS);
+  fprintf(stream, ",\n  \"winningHistogram\": ");
+  writeJsonArray(stream, stats->winningHistogram, STRENGTH_BUCKETS);
+  fprintf(stream, ",\n  \"coOccurrence\": [\n");
+  for(rankNum = NUM_INIT; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+  {
+    for(otherNum = NUM_INIT; otherNum < NUM_OF_HAND_RANKS; otherNum ++)
+    {
+      pairCounts[otherNum] = coOccurrence(stats, rankNum, otherNum);
+    }
+    fprintf(stream, "    ");
+    writeJsonArray(stream, pairCounts, NUM_OF_HAND_RANKS);
+    fprintf(stream, "%s\n", (rankNum + 1 < NUM_OF_HAND_RANKS) ? "," : "");
+  }
+  fprintf(stream, "  ]\n}\n");
+}
+
+/*
+  Function to write statistics as CSV or JSON.
+
+  Input   = {FILE *: stream, pokerStats *: stats, int: numOfSeats,
+            statsFormat: format}
+  Output  = {bool: success}
+*/
+bool writeStats(FILE * stream, const pokerStats * stats, int numOfSeats,
+  statsFormat format)
+{
+  if(stream == NULL)
+  {
+    return FALSE;
+  }
+  if(format == StatsCsv)
+  {
+    writeStatsCsv(stream, stats, numOfSeats);
+  }
+  else if(format == StatsJson)
+  {
+    writeStatsJson(stream, stats, numOfSeats);
+  }
+  return ferror(stream) ? FALSE : TRUE;
+}
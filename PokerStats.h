@@ -0,0 +1,116 @@
+#ifndef PokerStats_h
+#define PokerStats_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Hand strengths */
+#include "HandEvaluator.h"
+
+/*
+  stdint.h is included for the 64 bit counters.
+*/
+#include <stdint.h>
+
+/*
+  The strength histogram has one bucket per hand rank and leading card, the
+  card that decides the hand first (the pair of a pair, the high card of a
+  straight, and so on).
+*/
+#define STRENGTH_BUCKETS (NUM_OF_HAND_RANKS * NUM_OF_RANKS)
+#define strengthBucket(strength) \
+  (strengthCategory(strength) * NUM_OF_RANKS + \
+  (((strength) >> ((STRENGTH_VALUES - 1) * STRENGTH_VALUE_BITS)) & 0xF))
+
+/* Export formats of the statistics */
+typedef enum statsFormat
+{
+  StatsNone, StatsCsv, StatsJson
+} statsFormat;
+
+/*
+  Poker statistics structure
+
+  Counters gathered over many tables. Every counter is a plain sum, so the
+  statistics of separate runs, threads or batches are merged by adding them.
+
+    categoryBySeat     - hands of each rank dealt to each seat
+    winsByCategory     - tables won outright by a hand of each rank
+    tiesByCategory     - tables split between hands of each rank
+    strengthHistogram  - hands dealt, by strength bucket
+    winningHistogram   - winning hands, by strength bucket
+    ranksPresent       - tables by the set of hand ranks dealt, bit r set
+                         when some seat holds a hand of rank r
+    ranksRepeated      - tables by the set of hand ranks dealt to two or
+                         more seats
+
+  Co-occurrence of two ranks at a table is read from these two sets by
+  coOccurrence rather than counted pair by pair while dealing, which keeps
+  recording a table to one increment per counter with no data dependent
+  loops.
+*/
+typedef struct pokerStats
+{
+  uint64_t tables;
+  uint64_t categoryBySeat[MAX_PLAYERS][NUM_OF_HAND_RANKS];
+  uint64_t winsByCategory[NUM_OF_HAND_RANKS];
+  uint64_t tiesByCategory[NUM_OF_HAND_RANKS];
+  uint64_t strengthHistogram[STRENGTH_BUCKETS];
+  uint64_t winningHistogram[STRENGTH_BUCKETS];
+  uint64_t ranksPresent[1 << NUM_OF_HAND_RANKS];
+  uint64_t ranksRepeated[1 << NUM_OF_HAND_RANKS];
+} pokerStats;
+
+/*
+  Function to clear a set of statistics.
+
+  Input   = {pokerStats *: stats}
+  Output  = {void: NULL}
+*/
+void clearStats(pokerStats *);
+
+/*
+  Function to record one table given the strength of every seat and the
+  winners found by findWinners.
+
+  Input   = {pokerStats *: stats, handStrength *: strengths,
+            int: numOfHands, unsigned int: winnerMask}
+  Output  = {void: NULL}
+*/
+void recordTable(pokerStats *, const handStrength *, int, unsigned int);
+
+/*
+  Function to add one set of statistics into another.
+
+  Input   = {pokerStats *: total, pokerStats *: part}
+  Output  = {void: NULL}
+*/
+void mergeStats(pokerStats *, const pokerStats *);
+
+/*
+  Function to count the tables holding a hand of each of two ranks, or for
+  a rank with itself, the tables holding two or more hands of that rank.
+
+  Input   = {pokerStats *: stats, pokerRank: first, pokerRank: second}
+  Output  = {uint64_t: tables}
+*/
+uint64_t coOccurrence(const pokerStats *, pokerRank, pokerRank);
+
+/*
+  Function to read the name of an export format, csv, json or none.
+
+  Input   = {char *: name, statsFormat *: format}
+  Output  = {bool: success}
+*/
+bool parseStatsFormat(const char *, statsFormat *);
+
+/*
+  Function to write statistics as CSV, one row per counter with the columns
+  table,row,column,count, or as a JSON object of arrays.
+
+  Input   = {FILE *: stream, pokerStats *: stats, int: numOfSeats,
+            statsFormat: format}
+  Output  = {bool: success}
+*/
+bool writeStats(FILE *, const pokerStats *, int, statsFormat);
+
+#endif /* PokerStats_h */
@@ -96,7 +96,7 @@ typedef struct pokerTable
   Input   = {card *: newCard, rank: newRank, suit: newSuit}
   Output  = {bool: success}
 */
-bool createCard(card [STD_DECK_SIZE], rank, suit);
+bool createCard(card *, rank, suit);
 
 /*
   Function to compare two cards for
@@ -108,7 +108,7 @@ bool createCard(card [STD_DECK_SIZE], rank, suit);
   Input   = {card *: cardPTR}
   Output  = {void: NULL}
 */
-void printCard(card [STD_DECK_SIZE]);
+void printCard(card *);
 
 /*
   Function to populate an array of 52 cards with the standard ranks and suits.
@@ -0,0 +1,168 @@
+#include "PokerThreads.h"
+
+/* pthread.h is included for the worker threads. */
+#include <pthread.h>
+/* unistd.h is included for sysconf, to count the online processors. */
+#include <unistd.h>
+/* time.h is included for clock_gettime. */
+#include <time.h>
+
+/* Arguments handed to each worker thread */
+typedef struct workerArgs
+{
+  parallelTask task;
+  void * context;
+  int threadNum;
+} workerArgs;
+
+/* Thread entry point, unpacks the arguments and runs the task */
+static void * runWorker(void * argsPTR)
+{
+  workerArgs * args = argsPTR;
+  args->task(args->context, args->threadNum);
+  return NULL;
+}
+
+/*
+  Function to determine the number of threads to use when the user gives none.
+
+  Input   = {void: NULL}
+  Output  = {int: numOfThreads}
+*/
+int defaultThreadCount(void)
+{
+  long online = sysconf(_SC_NPROCESSORS_ONLN);
+  if(online < 1)
+  {
+    return 1;
+  }
+  if(online > MAX_THREADS)
+  {
+    return MAX_THREADS;
+  }
+  return (int)online;
+}
+
+/*
+  Function to start threads 1 to numOfThreads - 1 of a task, noting which
+  started.
+
+  Input   = {int: numOfThreads, parallelTask: task, void *: context,
+            pthread_t *: threads, workerArgs *: args, int *: started}
+  Output  = {int: threadsStarted}, counting the calling thread
+*/
+static int startWorkers(int numOfThreads, parallelTask task, void * context,
+  pthread_t * threads, workerArgs * args, int * started)
+{
+  int numStarted = 1;
+  int threadNum = 0;
+
+  for(threadNum = 0; threadNum < numOfThreads; threadNum ++)
+  {
+    args[threadNum].task = task;
+    args[threadNum].context = context;
+    args[threadNum].threadNum = threadNum;
+    started[threadNum] = 0;
+  }
+  for(threadNum = 1; threadNum < numOfThreads; threadNum ++)
+  {
+    started[threadNum] = pthread_create(& threads[threadNum], NULL, runWorker,
+      & args[threadNum]) == 0;
+    numStarted += started[threadNum];
+  }
+  return numStarted;
+}
+
+/*
+  Function to run a task on a number of threads and wait for all of them.
+  Threads that cannot be started are run on the calling thread instead, so
+  every thread number is always run exactly once.
+
+  Input   = {int: numOfThreads, parallelTask: task, void *: context}
+  Output  = {int: threadsRun}
+*/
+int runParallel(int numOfThreads, parallelTask task, void * context)
+{
+  pthread_t threads[MAX_THREADS];
+  workerArgs args[MAX_THREADS];
+  int started[MAX_THREADS];
+  int threadNum = 0;
+
+  if(numOfThreads < 1)
+  {
+    numOfThreads = 1;
+  }
+  if(numOfThreads > MAX_THREADS)
+  {
+    numOfThreads = MAX_THREADS;
+  }
+  startWorkers(numOfThreads, task, context, threads, args, started);
+  /* The calling thread does its own share of the work */
+  task(context, 0);
+  for(threadNum = 1; threadNum < numOfThreads; threadNum ++)
+  {
+    if(started[threadNum])
+    {
+      pthread_join(threads[threadNum], NULL);
+    }
+    else
+    {
+      task(context, threadNum);
+    }
+  }
+  return numOfThreads;
+}
+
+/*
+  Function to run a task whose threads wait on each other, all at once or
+  not at all.
+
+  Input   = {int: numOfThreads, parallelTask: task, void *: context,
+            void (*)(void *): stop}
+  Output  = {int: threadsStarted}
+*/
+int runTogether(int numOfThreads, parallelTask task, void * context,
+  void (* stop)(void *))
+{
+  pthread_t threads[MAX_THREADS];
+  workerArgs args[MAX_THREADS];
+  int started[MAX_THREADS];
+  int numStarted = 0;
+  int threadNum = 0;
+
+  if((numOfThreads < 1) || (numOfThreads > MAX_THREADS))
+  {
+    return 0;
+  }
+  numStarted = startWorkers(numOfThreads, task, context, threads, args,
+    started);
+  if(numStarted == numOfThreads)
+  {
+    task(context, 0);
+  }
+  else
+  {
+    stop(context);
+  }
+  for(threadNum = 1; threadNum < numOfThreads; threadNum ++)
+  {
+    if(started[threadNum])
+    {
+      pthread_join(threads[threadNum], NULL);
+    }
+  }
+  return numStarted;
+}
+
+/*
+  Function to read a monotonic clock in seconds.
+
+  Input   = {void: NULL}
+  Output  = {double: seconds}
+*/
+double currentSeconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, & now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
@@ -0,0 +1,58 @@
+#ifndef PokerThreads_h
+#define PokerThreads_h
+
+/* Upper bound on worker threads used by the parallel modes */
+#define MAX_THREADS 256
+
+/* Size of a cache line, used to pad per-thread data */
+#define CACHE_LINE_SIZE 64
+
+/*
+  Parallel task type
+
+  A parallel task receives the shared context and the number of the thread
+  running it. Tasks split their own work, normally by taking chunks from an
+  atomic counter kept in the context.
+*/
+typedef void (* parallelTask)(void *, int);
+
+/*
+  Function to determine the number of threads to use when the user gives none,
+  one per online processor.
+
+  Input   = {void: NULL}
+  Output  = {int: numOfThreads}
+*/
+int defaultThreadCount(void);
+
+/*
+  Function to run a task on a number of threads and wait for all of them. The
+  calling thread runs thread number zero itself.
+
+  Input   = {int: numOfThreads, parallelTask: task, void *: context}
+  Output  = {int: threadsRun}
+*/
+int runParallel(int, parallelTask, void *);
+
+/*
+  Function to run a task whose threads wait on each other, so they must all
+  run at once. The calling thread runs thread number zero only when every
+  other thread started. Otherwise stop is called with the context so the
+  threads that did start can return, and they are joined.
+
+  Input   = {int: numOfThreads, parallelTask: task, void *: context,
+            void (*)(void *): stop}
+  Output  = {int: threadsStarted}, counting the calling thread, so less than
+            numOfThreads when the task did not run
+*/
+int runTogether(int, parallelTask, void *, void (*)(void *));
+
+/*
+  Function to read a monotonic clock in seconds, used for throughput figures.
+
+  Input   = {void: NULL}
+  Output  = {double: seconds}
+*/
+double currentSeconds(void);
+
+#endif /* PokerThreads_h */
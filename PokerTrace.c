@@ -0,0 +1,199 @@
+#include "PokerTrace.h"
+
+/* string.h is included for memset. */
+#include <string.h>
+
+/* Names of the phases in the trace, in the order of tracePhase */
+static const char * traceNames[NUM_OF_TRACE_PHASES] =
+{
+  "batch", "shuffle", "deal", "evaluate", "showdown", "output", "starved",
+  "held back"
+};
+
+/* Categories of the phases, whole batches, single tables or waits */
+static const char * traceCategories[NUM_OF_TRACE_PHASES] =
+{
+  "batch", "table", "table", "table", "table", "batch", "wait", "wait"
+};
+
+/*
+  Function to create a trace with a ring for each thread.
+
+  Input   = {pokerTrace *: trace, int: numOfThreads, uint64_t: capacity,
+            uint64_t: sampleEvery}
+  Output  = {bool: success}
+*/
+bool createTrace(pokerTrace * trace, int numOfThreads, uint64_t capacity,
+  uint64_t sampleEvery)
+{
+  int threadNum = NUM_INIT;
+
+  memset(trace, 0, sizeof(* trace));
+  if((numOfThreads < 1) || (numOfThreads > MAX_THREADS) || (capacity == 0) ||
+    ((capacity & (capacity - 1)) != 0) || (sampleEvery == 0))
+  {
+    return FALSE;
+  }
+  trace->buffers = calloc(numOfThreads, sizeof(traceBuffer));
+  if(trace->buffers == NULL)
+  {
+    return FALSE;
+  }
+  trace->numOfThreads = numOfThreads;
+  trace->capacity = capacity;
+  trace->sampleEvery = sampleEvery;
+  for(threadNum = NUM_INIT; threadNum < numOfThreads; threadNum ++)
+  {
+    trace->buffers[threadNum].events = malloc(capacity * sizeof(traceEvent));
+    if(trace->buffers[threadNum].events == NULL)
+    {
+      freeTrace(trace);
+      return FALSE;
+    }
+    snprintf(trace->buffers[threadNum].name, TRACE_NAME_SIZE, "thread %d",
+      threadNum);
+  }
+  trace->origin = currentSeconds();
+  return TRUE;
+}
+
+/*
+  Function to free the rings of a trace.
+
+  Input   = {pokerTrace *: trace}
+  Output  = {void: NULL}
+*/
+void freeTrace(pokerTrace * trace)
+{
+  int threadNum = NUM_INIT;
+  if(trace->buffers != NULL)
+  {
+    for(threadNum = NUM_INIT; threadNum < trace->numOfThreads; threadNum ++)
+    {
+      free(trace->buffers[threadNum].events);
+    }
+  }
+  free(trace->buffers);
+  memset(trace, 0, sizeof(* trace));
+}
+
+/*
+  Function to name a thread of a trace.
+
+  Input   = {pokerTrace *: trace, int: threadNum, char *: role,
+            int: roleNum}
+  Output  = {void: NULL}
+*/
+void nameTraceThread(pokerTrace * trace, int threadNum, const char * role,
+  int roleNum)
+{
+  if((threadNum < 0) || (threadNum >= trace->numOfThreads))
+  {
+    return;
+  }
+  if(roleNum < 0)
+  {
+    snprintf(trace->buffers[threadNum].name, TRACE_NAME_SIZE, "%s", role);
+  }
+  else
+  {
+    snprintf(trace->buffers[threadNum].name, TRACE_NAME_SIZE, "%s %d", role,
+      roleNum);
+  }
+}
+
+/*
+  Function to record a span of a thread ending now.
+
+  Input   = {pokerTrace *: trace, int: threadNum, int: phase,
+            uint64_t: batchNum, double: started}
+  Output  = {double: now}
+*/
+double recordTraceSpan(pokerTrace * trace, int threadNum, int phase,
+  uint64_t batchNum, double started)
+{
+  const double now = currentSeconds();
+  traceBuffer * buffer = NULL;
+  traceEvent * event = NULL;
+
+  if((threadNum < 0) || (threadNum >= trace->numOfThreads))
+  {
+    return now;
+  }
+  buffer = & trace->buffers[threadNum];
+  event = & buffer->events[buffer->numRecorded & (trace->capacity - 1)];
+  event->start = started - trace->origin;
+  event->end = now - trace->origin;
+  event->batchNum = batchNum;
+  event->phase = phase;
+  buffer->numRecorded ++;
+  return now;
+}
+
+/*
+  Function to count the spans that were overwritten.
+
+  Input   = {pokerTrace *: trace}
+  Output  = {uint64_t: dropped}
+*/
+uint64_t traceDropped(const pokerTrace * trace)
+{
+  uint64_t dropped = 0;
+  int threadNum = NUM_INIT;
+  for(threadNum = NUM_INIT; threadNum < trace->numOfThreads; threadNum ++)
+  {
+    if(trace->buffers[threadNum].numRecorded > trace->capacity)
+    {
+      dropped += trace->buffers[threadNum].numRecorded - trace->capacity;
+    }
+  }
+  return dropped;
+}
+
+/*
+  Function to write a trace as Chrome trace event JSON, the spans of each
+  thread oldest first.
+
+  Input   = {pokerTrace *: trace, FILE *: output}
+  Output  = {bool: success}
+*/
+bool writeTraceJson(const pokerTrace * trace, FILE * output)
+{
+  const traceBuffer * buffer = NULL;
+  const traceEvent * event = NULL;
+  uint64_t first = 0;
+  uint64_t eventNum = 0;
+  int threadNum = NUM_INIT;
+
+  fprintf(output, "{\"traceEvents\":[\n");
+  for(threadNum = NUM_INIT; threadNum < trace->numOfThreads; threadNum ++)
+  {
+    fprintf(output, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+      "\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n", threadNum,
+      trace->buffers[threadNum].name);
+  }
+  for(threadNum = NUM_INIT; threadNum < trace->numOfThreads; threadNum ++)
+  {
+    buffer = & trace->buffers[threadNum];
+    first = (buffer->numRecorded > trace->capacity) ?
+      buffer->numRecorded - trace->capacity : 0;
+    for(eventNum = first; eventNum < buffer->numRecorded; eventNum ++)
+    {
+      event = & buffer->events[eventNum & (trace->capacity - 1)];
+      fprintf(output, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+        "\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+        "\"args\":{\"batch\":%llu}},\n", traceNames[event->phase],
+        traceCategories[event->phase], threadNum, event->start * 1e6,
+        (event->end - event->start) * 1e6,
+        (unsigned long long)event->batchNum);
+    }
+  }
+  /* The metadata event closes the list, so no event needs to know it is
+     the last */
+  fprintf(output, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+    "\"args\":{\"name\":\"StudPoker\"}}\n],\n\"displayTimeUnit\":\"ns\","
+    "\"otherData\":{\"sampleEvery\":%llu,\"dropped\":%llu}}\n",
+    (unsigned long long)trace->sampleEvery,
+    (unsigned long long)traceDropped(trace));
+  return (ferror(output) == 0) ? TRUE : FALSE;
+}
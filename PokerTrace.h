@@ -0,0 +1,155 @@
+#ifndef PokerTrace_h
+#define PokerTrace_h
+
+/* Macros of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Cache line size, most threads a run can have and the clock */
+#include "PokerThreads.h"
+/* Seed mixing, which picks the batches sampled */
+#include "PokerRandom.h"
+
+/*
+  stdint.h is included for the event counts and batch numbers, and stdio.h
+  for the trace file.
+*/
+#include <stdint.h>
+#include <stdio.h>
+
+/* Events each thread keeps by default, a power of two */
+#define TRACE_RING_EVENTS 16384
+/* Batches a run samples when given no sampling interval */
+#define TRACE_SAMPLED_BATCHES 1024
+/* Tables at the start of a sampled batch traced phase by phase */
+#define TRACE_TABLES_PER_BATCH 16
+/* Longest thread name */
+#define TRACE_NAME_SIZE 32
+
+/* Phases a span can time, in the order of traceNames */
+typedef enum tracePhase
+{
+  TraceBatch, TraceShuffle, TraceDeal, TraceEvaluate, TraceShowdown,
+  TraceOutput, TraceStarved, TraceHeldBack, NUM_OF_TRACE_PHASES
+} tracePhase;
+
+/*
+  Trace event structure, one timed span of a thread.
+
+    start    - seconds from the start of the trace to the start of the span
+    end      - seconds from the start of the trace to the end of the span
+    batchNum - batch the span worked on
+    phase    - the tracePhase timed
+*/
+typedef struct traceEvent
+{
+  double start;
+  double end;
+  uint64_t batchNum;
+  int phase;
+} traceEvent;
+
+/*
+  Trace buffer structure, the ring of one thread. Only its thread writes it,
+  with no locks or atomics, and it is read once the threads have finished.
+  When the ring is full the newest span overwrites the oldest, so a run of
+  any length keeps at most capacity spans per thread.
+
+    events      - the ring, span i at events[i % capacity]
+    numRecorded - spans recorded, of which the last capacity are kept
+    name        - name the thread is shown under
+*/
+typedef struct traceBuffer
+{
+  traceEvent * events;
+  uint64_t numRecorded;
+  char name[TRACE_NAME_SIZE];
+  char padding[CACHE_LINE_SIZE];
+} traceBuffer;
+
+/*
+  Poker trace structure
+
+  Spans of the threads of one run. A run only traces one batch in
+  sampleEvery, timing the whole batch and the phases of its first
+  TRACE_TABLES_PER_BATCH tables, so tracing costs a clock read per traced
+  phase and nothing on the batches left out. Batches are picked by a hash
+  of their number rather than every sampleEvery-th, which a stage taking
+  every k-th batch might never see.
+
+    numOfThreads - threads with a ring
+    capacity     - spans every ring holds
+    sampleEvery  - one batch in sampleEvery is traced, on average
+    origin       - clock reading the spans are timed from
+    buffers      - ring of every thread
+*/
+typedef struct pokerTrace
+{
+  int numOfThreads;
+  uint64_t capacity;
+  uint64_t sampleEvery;
+  double origin;
+  traceBuffer * buffers;
+} pokerTrace;
+
+/* Whether a run traces a batch, FALSE when it has no trace */
+#define traceSampled(trace, batchNum) \
+  (((trace) != NULL) && \
+  (mixSeed((uint64_t)(batchNum)) % (trace)->sampleEvery == 0))
+
+/*
+  Function to create a trace with a ring for each thread.
+
+  Input   = {pokerTrace *: trace, int: numOfThreads, uint64_t: capacity,
+            uint64_t: sampleEvery}
+  Output  = {bool: success}, FALSE for no threads, a capacity that is not a
+            power of two, no sampling interval or too little memory
+*/
+bool createTrace(pokerTrace *, int, uint64_t, uint64_t);
+
+/*
+  Function to free the rings of a trace.
+
+  Input   = {pokerTrace *: trace}
+  Output  = {void: NULL}
+*/
+void freeTrace(pokerTrace *);
+
+/*
+  Function to name a thread of a trace, for example "producer 2".
+
+  Input   = {pokerTrace *: trace, int: threadNum, char *: role,
+            int: roleNum}, roleNum below zero for no number
+  Output  = {void: NULL}
+*/
+void nameTraceThread(pokerTrace *, int, const char *, int);
+
+/*
+  Function to record a span of a thread that started at a given clock
+  reading and ends now. Threads without a ring are ignored.
+
+  Input   = {pokerTrace *: trace, int: threadNum, int: phase,
+            uint64_t: batchNum, double: started}
+  Output  = {double: now}, the clock reading ending the span, which can
+            start the next one
+*/
+double recordTraceSpan(pokerTrace *, int, int, uint64_t, double);
+
+/*
+  Function to count the spans that were overwritten.
+
+  Input   = {pokerTrace *: trace}
+  Output  = {uint64_t: dropped}
+*/
+uint64_t traceDropped(const pokerTrace *);
+
+/*
+  Function to write a trace as Chrome trace event JSON, which Perfetto and
+  chrome://tracing open: one complete event per span, timed in
+  microseconds, with the batch number as its argument, and one metadata
+  event naming each thread.
+
+  Input   = {pokerTrace *: trace, FILE *: output}
+  Output  = {bool: success}
+*/
+bool writeTraceJson(const pokerTrace *, FILE *);
+
+#endif /* PokerTrace_h */
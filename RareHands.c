@@ -0,0 +1,215 @@
+#include "RareHands.h"
+/* Strength buckets, one per hand rank and lead card */
+#include "PokerStats.h"
+/* Colex combinations and binomial coefficients */
+#include "Combinatorics.h"
+
+/* pthread.h is included for the lock around building the table. */
+#include <pthread.h>
+/* stdatomic.h is included for the ready flag. */
+#include <stdatomic.h>
+/* ctype.h is included for tolower and isalnum. */
+#include <ctype.h>
+
+/* Names of the hand ranks, from PokerTable.c */
+extern char * handRanks[NUM_OF_HAND_RANKS];
+
+/* Colex index of every five card hand, sorted by strength bucket */
+static handIndex * sortedHands = NULL;
+/* Position in sortedHands of the first hand of each bucket, and the end */
+static uint32_t bucketStarts[STRENGTH_BUCKETS + 1];
+static pthread_mutex_t prepareLock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int rareReady = 0;
+
+/*
+  Function to build the sorted hand table with a counting sort over the
+  strength buckets, visiting the hands in colex order so that a hand's index
+  is simply its position in the walk.
+
+  Input   = {void: NULL}
+  Output  = {bool: success}
+*/
+bool prepareRareHands(void)
+{
+  unsigned char cards[CARDS_PER_HAND] = {0, 1, 2, 3, 4};
+  unsigned char * buckets = NULL;
+  uint32_t next[STRENGTH_BUCKETS];
+  handIndex index = 0;
+  int bucket = 0;
+
+  if(atomic_load_explicit(& rareReady, memory_order_acquire) != 0)
+  {
+    return TRUE;
+  }
+  pthread_mutex_lock(& prepareLock);
+  if(atomic_load_explicit(& rareReady, memory_order_relaxed) != 0)
+  {
+    pthread_mutex_unlock(& prepareLock);
+    return TRUE;
+  }
+  sortedHands = malloc(sizeof(handIndex) * NUM_OF_FIVE_CARD_HANDS);
+  buckets = malloc(NUM_OF_FIVE_CARD_HANDS);
+  if((sortedHands == NULL) || (buckets == NULL))
+  {
+    free(sortedHands);
+    free(buckets);
+    sortedHands = NULL;
+    pthread_mutex_unlock(& prepareLock);
+    return FALSE;
+  }
+
+  for(bucket = 0; bucket <= STRENGTH_BUCKETS; bucket ++)
+  {
+    bucketStarts[bucket] = 0;
+  }
+  do
+  {
+    buckets[index] = strengthBucket(evaluateCardIndices(cards,
+      CARDS_PER_HAND));
+    bucketStarts[buckets[index] + 1] ++;
+    index ++;
+  } while(nextCombination(cards, CARDS_PER_HAND, STD_DECK_SIZE) == TRUE);
+  for(bucket = 0; bucket < STRENGTH_BUCKETS; bucket ++)
+  {
+    bucketStarts[bucket + 1] += bucketStarts[bucket];
+    next[bucket] = bucketStarts[bucket];
+  }
+  for(index = 0; index < NUM_OF_FIVE_CARD_HANDS; index ++)
+  {
+    sortedHands[next[buckets[index]] ++] = index;
+  }
+  free(buckets);
+
+  atomic_store_explicit(& rareReady, 1, memory_order_release);
+  pthread_mutex_unlock(& prepareLock);
+  return TRUE;
+}
+
+/*
+  Function to set up a sampler over one hand rank or one bucket of it.
+
+  Input   = {rareSampler *: sampler, pokerRank: category, int: leadValue,
+            int: seat, int: numOfPlayers}
+  Output  = {bool: success}
+*/
+bool initRareSampler(rareSampler * sampler, pokerRank category,
+  int leadValue, int seat, int numOfPlayers)
+{
+  const int firstBucket = category * NUM_OF_RANKS +
+    ((leadValue == ANY_LEAD_VALUE) ? 0 : leadValue);
+  const int endBucket = (leadValue == ANY_LEAD_VALUE) ?
+    firstBucket + NUM_OF_RANKS : firstBucket + 1;
+
+  if(((int)category < HighCard) || (category > StraightFlush) ||
+    ((leadValue != ANY_LEAD_VALUE) &&
+    ((leadValue < 0) || (leadValue > ACE_HIGH_VALUE))) ||
+    (numOfPlayers < 1) || (numOfPlayers > MAX_PLAYERS) || (seat < 0) ||
+    (seat >= numOfPlayers) || (prepareRareHands() == FALSE))
+  {
+    return FALSE;
+  }
+  sampler->category = category;
+  sampler->leadValue = leadValue;
+  sampler->seat = seat;
+  sampler->numOfPlayers = numOfPlayers;
+  sampler->first = bucketStarts[firstBucket];
+  sampler->numOfHands = bucketStarts[endBucket] - bucketStarts[firstBucket];
+  sampler->weight = (double)sampler->numOfHands / NUM_OF_FIVE_CARD_HANDS;
+  return (sampler->numOfHands > 0) ? TRUE : FALSE;
+}
+
+/*
+  Function to deal a table around a hand drawn from the sampler's set.
+
+  Input   = {rareSampler *: sampler, pokerRng *: rng, unsigned char *: deck}
+  Output  = {handIndex: index}
+*/
+handIndex sampleRareTable(const rareSampler * sampler, pokerRng * rng,
+  unsigned char * deck)
+{
+  const handIndex index = sortedHands[sampler->first +
+    randomBounded(rng, sampler->numOfHands)];
+  unsigned char * rest = deck + CARDS_PER_HAND;
+  unsigned char held[CARDS_PER_HAND];
+  uint64_t heldMask = 0;
+  int numRest = 0;
+  int cardNum = 0;
+
+  /* The set hand goes first, the rest of the deck after it */
+  unrankHandIndices(index, held);
+  for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    deck[cardNum] = held[cardNum];
+    heldMask |= 1ULL << held[cardNum];
+  }
+  for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    if(((heldMask >> cardNum) & 1) == 0)
+    {
+      rest[numRest ++] = cardNum;
+    }
+  }
+  shuffleCardIndices(rng, rest, STD_DECK_SIZE - CARDS_PER_HAND,
+    (sampler->numOfPlayers - 1) * CARDS_PER_HAND);
+
+  /* Then swap it round to the sampler's seat */
+  if(sampler->seat > 0)
+  {
+    for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+    {
+      deck[cardNum] = deck[sampler->seat * CARDS_PER_HAND + cardNum];
+      deck[sampler->seat * CARDS_PER_HAND + cardNum] = held[cardNum];
+    }
+  }
+  return index;
+}
+
+/*
+  Function to read a hand rank by number or by name.
+
+  Input   = {char *: text}
+  Output  = {int: category}
+*/
+int parseHandRank(const char * text)
+{
+  const char * name = NULL;
+  const char * given = NULL;
+  int rankNum = 0;
+
+  if((text[0] >= '0') && (text[0] < '0' + NUM_OF_HAND_RANKS) &&
+    (text[1] == '\0'))
+  {
+    return text[0] - '0';
+  }
+  for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+  {
+    name = handRanks[rankNum];
+    given = text;
+    while((* name != '\0') || (* given != '\0'))
+    {
+      if((* name != '\0') && (isalnum((unsigned char)* name) == 0))
+      {
+        name ++;
+      }
+      else if((* given != '\0') && (isalnum((unsigned char)* given) == 0))
+      {
+        given ++;
+      }
+      else if(tolower((unsigned char)* name) ==
+        tolower((unsigned char)* given))
+      {
+        name ++;
+        given ++;
+      }
+      else
+      {
+        break;
+      }
+    }
+    if((* name == '\0') && (* given == '\0'))
+    {
+      return rankNum;
+    }
+  }
+  return INVALID_INT;
+}
@@ -0,0 +1,94 @@
+#ifndef RareHands_h
+#define RareHands_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Hand strengths */
+#include "HandEvaluator.h"
+/* Colex hand indices */
+#include "HandIndex.h"
+/* Generator the tables are dealt with */
+#include "PokerRandom.h"
+
+/*
+  stdint.h is included for the sizes of the hand sets.
+*/
+#include <stdint.h>
+
+/* Leaves the lead card of a rare hand open */
+#define ANY_LEAD_VALUE INVALID_INT
+
+/*
+  Rare hand sampler structure
+
+  A set of five card hands, every hand of one rank optionally narrowed to
+  one lead card (the card that decides the hand first: the quads of four of
+  a kind, the high card of a straight, the top card of a flush and so on),
+  and the seat that is dealt a hand of the set.
+
+    category     - hand rank of the set
+    leadValue    - ace high value of the lead card, 0 for a Two up to 12 for
+                   an Ace, or ANY_LEAD_VALUE
+    seat         - seat dealt a hand of the set
+    numOfPlayers - players dealt at every table, more than seat
+    first        - position of the set in the sorted hand table
+    numOfHands   - hands in the set
+    weight       - importance weight of every sampled table, the chance a
+                   real deal gives the seat a hand of the set, numOfHands /
+                   C(52, 5)
+*/
+typedef struct rareSampler
+{
+  pokerRank category;
+  int leadValue;
+  int seat;
+  int numOfPlayers;
+  uint32_t first;
+  uint32_t numOfHands;
+  double weight;
+} rareSampler;
+
+/*
+  Function to build the table of every five card hand by colex index, sorted
+  by hand rank then lead card, so each set a sampler can ask for is one
+  contiguous range. It takes about 10 MB, is built once and is shared by
+  every later call.
+
+  Input   = {void: NULL}
+  Output  = {bool: success}
+*/
+bool prepareRareHands(void);
+
+/*
+  Function to set up a sampler, building the hand table first if needed.
+
+  Input   = {rareSampler *: sampler, pokerRank: category, int: leadValue,
+            int: seat, int: numOfPlayers}
+  Output  = {bool: success}, FALSE when the set is empty, the seat is not
+            one of the players or the table cannot be built
+*/
+bool initRareSampler(rareSampler *, pokerRank, int, int, int);
+
+/*
+  Function to deal a table whose sampler seat holds a hand drawn uniformly
+  from the set, the other seats being dealt uniformly from the remaining 47
+  cards. Hands are laid out as by the simulation, seat s holding cards
+  s * CARDS_PER_HAND to s * CARDS_PER_HAND + 4. A mean over such tables
+  multiplied by the sampler weight estimates the mean over real deals of the
+  same quantity counted only when the seat holds a hand of the set.
+
+  Input   = {rareSampler *: sampler, pokerRng *: rng, unsigned char *: deck}
+  Output  = {handIndex: index}, colex index of the sampled hand
+*/
+handIndex sampleRareTable(const rareSampler *, pokerRng *, unsigned char *);
+
+/*
+  Function to read a hand rank by its number, 0 for High Card up to 8, or by
+  its name ignoring case, spaces and dashes, as in "straight-flush".
+
+  Input   = {char *: text}
+  Output  = {int: category}, INVALID_INT when nothing matches
+*/
+int parseHandRank(const char *);
+
+#endif /* RareHands_h */
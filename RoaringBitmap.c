@@ -0,0 +1,501 @@
+#include "RoaringBitmap.h"
+
+/* string.h is included for memcpy and memset. */
+#include <string.h>
+
+/* Containers first allocated for a bitmap */
+#define MIN_CONTAINERS 16
+
+/* Operations that combine two containers */
+typedef enum bitmapOperation
+{
+  OperationAnd, OperationOr, OperationAndNot
+} bitmapOperation;
+
+/*
+  Function to start an empty bitmap.
+
+  Input   = {roaringBitmap *: bitmap}
+  Output  = {void: NULL}
+*/
+void initBitmap(roaringBitmap * bitmap)
+{
+  bitmap->numOfContainers = 0;
+  bitmap->capacity = 0;
+  bitmap->containers = NULL;
+  bitmap->borrowed = FALSE;
+}
+
+/*
+  Function to free what a bitmap owns.
+
+  Input   = {roaringBitmap *: bitmap}
+  Output  = {void: NULL}
+*/
+void freeBitmap(roaringBitmap * bitmap)
+{
+  int containerNum = 0;
+  if(bitmap->borrowed == FALSE)
+  {
+    for(containerNum = 0; containerNum < bitmap->numOfContainers;
+      containerNum ++)
+    {
+      free(bitmap->containers[containerNum].values);
+      free(bitmap->containers[containerNum].words);
+    }
+  }
+  free(bitmap->containers);
+  initBitmap(bitmap);
+}
+
+/*
+  Function to add a container to the end of a bitmap.
+
+  Input   = {roaringBitmap *: bitmap, bitmapContainer *: container}
+  Output  = {bool: success}
+*/
+bool appendContainer(roaringBitmap * bitmap, const bitmapContainer * container)
+{
+  bitmapContainer * grown = NULL;
+  int capacity = 0;
+
+  if(bitmap->numOfContainers == bitmap->capacity)
+  {
+    capacity = (bitmap->capacity < MIN_CONTAINERS) ? MIN_CONTAINERS :
+      bitmap->capacity * 2;
+    grown = realloc(bitmap->containers, sizeof(bitmapContainer) * capacity);
+    if(grown == NULL)
+    {
+      return FALSE;
+    }
+    bitmap->containers = grown;
+    bitmap->capacity = capacity;
+  }
+  bitmap->containers[bitmap->numOfContainers ++] = * container;
+  return TRUE;
+}
+
+/*
+  Function to add a container given as bits, as an array when it is small
+  enough. Empty containers are left out.
+
+  Input   = {roaringBitmap *: bitmap, uint32_t: key, uint64_t *: words}
+  Output  = {bool: success}
+*/
+static bool storeWords(roaringBitmap * bitmap, uint32_t key,
+  const uint64_t * words)
+{
+  bitmapContainer container;
+  uint64_t bits = 0;
+  int wordNum = 0;
+
+  memset(& container, 0, sizeof(container));
+  container.key = key;
+  for(wordNum = 0; wordNum < CONTAINER_WORDS; wordNum ++)
+  {
+    container.cardinality += __builtin_popcountll(words[wordNum]);
+  }
+  if(container.cardinality == 0)
+  {
+    return TRUE;
+  }
+  if(container.cardinality <= ARRAY_CONTAINER_LIMIT)
+  {
+    container.values = malloc(sizeof(uint16_t) * container.cardinality);
+    if(container.values == NULL)
+    {
+      return FALSE;
+    }
+    container.cardinality = 0;
+    for(wordNum = 0; wordNum < CONTAINER_WORDS; wordNum ++)
+    {
+      for(bits = words[wordNum]; bits != 0; bits &= bits - 1)
+      {
+        container.values[container.cardinality ++] =
+          (uint16_t)(wordNum * 64 + __builtin_ctzll(bits));
+      }
+    }
+  }
+  else
+  {
+    container.words = malloc(sizeof(uint64_t) * CONTAINER_WORDS);
+    if(container.words == NULL)
+    {
+      return FALSE;
+    }
+    memcpy(container.words, words, sizeof(uint64_t) * CONTAINER_WORDS);
+  }
+  if(appendContainer(bitmap, & container) == FALSE)
+  {
+    free(container.values);
+    free(container.words);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*
+  Function to add a container given as sorted values, as bits when there
+  are too many for an array.
+
+  Input   = {roaringBitmap *: bitmap, uint32_t: key, uint16_t *: values,
+            uint32_t: count}
+  Output  = {bool: success}
+*/
+static bool storeValues(roaringBitmap * bitmap, uint32_t key,
+  const uint16_t * values, uint32_t count)
+{
+  bitmapContainer container;
+  uint64_t words[CONTAINER_WORDS];
+  uint32_t valueNum = 0;
+
+  if(count == 0)
+  {
+    return TRUE;
+  }
+  if(count > ARRAY_CONTAINER_LIMIT)
+  {
+    memset(words, 0, sizeof(words));
+    for(valueNum = 0; valueNum < count; valueNum ++)
+    {
+      words[values[valueNum] >> 6] |= 1ULL << (values[valueNum] & 63);
+    }
+    return storeWords(bitmap, key, words);
+  }
+  memset(& container, 0, sizeof(container));
+  container.key = key;
+  container.cardinality = count;
+  container.values = malloc(sizeof(uint16_t) * count);
+  if(container.values == NULL)
+  {
+    return FALSE;
+  }
+  memcpy(container.values, values, sizeof(uint16_t) * count);
+  if(appendContainer(bitmap, & container) == FALSE)
+  {
+    free(container.values);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/* Write the bits of a container to a word buffer */
+static void containerWords(const bitmapContainer * container,
+  uint64_t * words)
+{
+  uint32_t valueNum = 0;
+  if(container->words != NULL)
+  {
+    memcpy(words, container->words, sizeof(uint64_t) * CONTAINER_WORDS);
+    return;
+  }
+  memset(words, 0, sizeof(uint64_t) * CONTAINER_WORDS);
+  for(valueNum = 0; valueNum < container->cardinality; valueNum ++)
+  {
+    words[container->values[valueNum] >> 6] |=
+      1ULL << (container->values[valueNum] & 63);
+  }
+}
+
+/* Determine whether a container holds a value */
+static bool containerHolds(const bitmapContainer * container, uint16_t value)
+{
+  int low = 0;
+  int high = (int)container->cardinality;
+  int middle = 0;
+
+  if(container->words != NULL)
+  {
+    return ((container->words[value >> 6] >> (value & 63)) & 1) ? TRUE :
+      FALSE;
+  }
+  while(low < high)
+  {
+    middle = (low + high) / 2;
+    if(container->values[middle] < value)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  return ((low < (int)container->cardinality) &&
+    (container->values[low] == value)) ? TRUE : FALSE;
+}
+
+/*
+  Function to combine two containers of the same key. Arrays are merged or
+  filtered value by value, anything involving a bitmap goes word by word.
+
+  Input   = {roaringBitmap *: result, bitmapOperation: operation,
+            bitmapContainer *: first, bitmapContainer *: second}
+  Output  = {bool: success}
+*/
+static bool combineContainers(roaringBitmap * result,
+  bitmapOperation operation, const bitmapContainer * first,
+  const bitmapContainer * second)
+{
+  uint16_t values[2 * ARRAY_CONTAINER_LIMIT];
+  uint64_t words[CONTAINER_WORDS];
+  uint64_t otherWords[CONTAINER_WORDS];
+  const bitmapContainer * filtered = first;
+  const bitmapContainer * filter = second;
+  uint32_t count = 0;
+  uint32_t firstNum = 0;
+  uint32_t secondNum = 0;
+  int wordNum = 0;
+
+  if((operation == OperationAnd) && (first->values == NULL) &&
+    (second->values != NULL))
+  {
+    filtered = second;
+    filter = first;
+  }
+  if(((operation == OperationAnd) || (operation == OperationAndNot)) &&
+    (filtered->values != NULL))
+  {
+    /* An array keeps the values the other container holds, or lacks */
+    for(firstNum = 0; firstNum < filtered->cardinality; firstNum ++)
+    {
+      if(containerHolds(filter, filtered->values[firstNum]) ==
+        ((operation == OperationAnd) ? TRUE : FALSE))
+      {
+        values[count ++] = filtered->values[firstNum];
+      }
+    }
+    return storeValues(result, first->key, values, count);
+  }
+  if((operation == OperationOr) && (first->values != NULL) &&
+    (second->values != NULL))
+  {
+    while((firstNum < first->cardinality) ||
+      (secondNum < second->cardinality))
+    {
+      if((secondNum == second->cardinality) ||
+        ((firstNum < first->cardinality) &&
+        (first->values[firstNum] < second->values[secondNum])))
+      {
+        values[count ++] = first->values[firstNum ++];
+      }
+      else if((firstNum == first->cardinality) ||
+        (second->values[secondNum] < first->values[firstNum]))
+      {
+        values[count ++] = second->values[secondNum ++];
+      }
+      else
+      {
+        values[count ++] = first->values[firstNum ++];
+        secondNum ++;
+      }
+    }
+    return storeValues(result, first->key, values, count);
+  }
+  containerWords(first, words);
+  containerWords(second, otherWords);
+  for(wordNum = 0; wordNum < CONTAINER_WORDS; wordNum ++)
+  {
+    if(operation == OperationAnd)
+    {
+      words[wordNum] &= otherWords[wordNum];
+    }
+    else if(operation == OperationOr)
+    {
+      words[wordNum] |= otherWords[wordNum];
+    }
+    else
+    {
+      words[wordNum] &= ~otherWords[wordNum];
+    }
+  }
+  return storeWords(result, first->key, words);
+}
+
+/* Copy a container into a result bitmap */
+static bool copyContainer(roaringBitmap * result,
+  const bitmapContainer * container)
+{
+  if(container->values != NULL)
+  {
+    return storeValues(result, container->key, container->values,
+      container->cardinality);
+  }
+  return storeWords(result, container->key, container->words);
+}
+
+/*
+  Function to combine two bitmaps key by key. Keys only in the first are
+  kept by Or and AndNot, keys only in the second by Or.
+
+  Input   = {roaringBitmap *: result, bitmapOperation: operation,
+            roaringBitmap *: first, roaringBitmap *: second}
+  Output  = {bool: success}
+*/
+static bool combineBitmaps(roaringBitmap * result, bitmapOperation operation,
+  const roaringBitmap * first, const roaringBitmap * second)
+{
+  const bitmapContainer * firstContainer = NULL;
+  const bitmapContainer * secondContainer = NULL;
+  int firstNum = 0;
+  int secondNum = 0;
+  bool success = TRUE;
+
+  while((success == TRUE) && ((firstNum < first->numOfContainers) ||
+    (secondNum < second->numOfContainers)))
+  {
+    firstContainer = (firstNum < first->numOfContainers) ?
+      & first->containers[firstNum] : NULL;
+    secondContainer = (secondNum < second->numOfContainers) ?
+      & second->containers[secondNum] : NULL;
+    if((secondContainer == NULL) || ((firstContainer != NULL) &&
+      (firstContainer->key < secondContainer->key)))
+    {
+      if(operation != OperationAnd)
+      {
+        success = copyContainer(result, firstContainer);
+      }
+      firstNum ++;
+    }
+    else if((firstContainer == NULL) ||
+      (secondContainer->key < firstContainer->key))
+    {
+      if(operation == OperationOr)
+      {
+        success = copyContainer(result, secondContainer);
+      }
+      secondNum ++;
+    }
+    else
+    {
+      success = combineContainers(result, operation, firstContainer,
+        secondContainer);
+      firstNum ++;
+      secondNum ++;
+    }
+  }
+  return success;
+}
+
+/*
+  Function to fill a bitmap with every id below a count.
+
+  Input   = {roaringBitmap *: bitmap, uint64_t: count}
+  Output  = {bool: success}
+*/
+bool bitmapRange(roaringBitmap * bitmap, uint64_t count)
+{
+  uint64_t words[CONTAINER_WORDS];
+  uint64_t key = 0;
+  uint64_t remaining = 0;
+  int wordNum = 0;
+
+  for(key = 0; key * CONTAINER_IDS < count; key ++)
+  {
+    remaining = count - key * CONTAINER_IDS;
+    for(wordNum = 0; wordNum < CONTAINER_WORDS; wordNum ++)
+    {
+      if(remaining >= 64)
+      {
+        words[wordNum] = ~0ULL;
+        remaining -= 64;
+      }
+      else
+      {
+        words[wordNum] = (1ULL << remaining) - 1;
+        remaining = 0;
+      }
+    }
+    if(storeWords(bitmap, (uint32_t)key, words) == FALSE)
+    {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/*
+  Functions to combine two bitmaps into a third.
+
+  Input   = {roaringBitmap *: result, roaringBitmap *: first,
+            roaringBitmap *: second}
+  Output  = {bool: success}
+*/
+bool bitmapAnd(roaringBitmap * result, const roaringBitmap * first,
+  const roaringBitmap * second)
+{
+  return combineBitmaps(result, OperationAnd, first, second);
+}
+
+bool bitmapOr(roaringBitmap * result, const roaringBitmap * first,
+  const roaringBitmap * second)
+{
+  return combineBitmaps(result, OperationOr, first, second);
+}
+
+bool bitmapAndNot(roaringBitmap * result, const roaringBitmap * first,
+  const roaringBitmap * second)
+{
+  return combineBitmaps(result, OperationAndNot, first, second);
+}
+
+/*
+  Function to count the ids of a bitmap.
+
+  Input   = {roaringBitmap *: bitmap}
+  Output  = {uint64_t: cardinality}
+*/
+uint64_t bitmapCardinality(const roaringBitmap * bitmap)
+{
+  uint64_t cardinality = 0;
+  int containerNum = 0;
+  for(containerNum = 0; containerNum < bitmap->numOfContainers;
+    containerNum ++)
+  {
+    cardinality += bitmap->containers[containerNum].cardinality;
+  }
+  return cardinality;
+}
+
+/*
+  Function to list the smallest ids of a bitmap in ascending order.
+
+  Input   = {roaringBitmap *: bitmap, uint32_t *: ids, uint64_t: maxIds}
+  Output  = {uint64_t: numOfIds}
+*/
+uint64_t bitmapIds(const roaringBitmap * bitmap, uint32_t * ids,
+  uint64_t maxIds)
+{
+  const bitmapContainer * container = NULL;
+  uint64_t numOfIds = 0;
+  uint64_t bits = 0;
+  uint32_t valueNum = 0;
+  int containerNum = 0;
+  int wordNum = 0;
+
+  for(containerNum = 0; (containerNum < bitmap->numOfContainers) &&
+    (numOfIds < maxIds); containerNum ++)
+  {
+    container = & bitmap->containers[containerNum];
+    if(container->values != NULL)
+    {
+      for(valueNum = 0; (valueNum < container->cardinality) &&
+        (numOfIds < maxIds); valueNum ++)
+      {
+        ids[numOfIds ++] = (container->key << 16) | container->values[valueNum];
+      }
+      continue;
+    }
+    for(wordNum = 0; (wordNum < CONTAINER_WORDS) && (numOfIds < maxIds);
+      wordNum ++)
+    {
+      for(bits = container->words[wordNum]; (bits != 0) &&
+        (numOfIds < maxIds); bits &= bits - 1)
+      {
+        ids[numOfIds ++] = (container->key << 16) |
+          (uint32_t)(wordNum * 64 + __builtin_ctzll(bits));
+      }
+    }
+  }
+  return numOfIds;
+}
@@ -0,0 +1,127 @@
+#ifndef RoaringBitmap_h
+#define RoaringBitmap_h
+
+/* bool, TRUE and FALSE of the simulated Poker Table. */
+#include "PokerTable.h"
+
+/*
+  stdint.h is included for the 32 bit ids and the container words.
+*/
+#include <stdint.h>
+
+/* Ids each container covers, those sharing the top 16 bits */
+#define CONTAINER_IDS 65536
+/* 64 bit words of a bitmap container */
+#define CONTAINER_WORDS (CONTAINER_IDS / 64)
+/* Most ids a container keeps as a sorted array, above it a bitmap is
+   smaller */
+#define ARRAY_CONTAINER_LIMIT 4096
+
+/*
+  Bitmap container structure
+
+  The ids of a bitmap sharing their top 16 bits, as a sorted array of their
+  low 16 bits when there are at most ARRAY_CONTAINER_LIMIT of them and as a
+  bitmap of CONTAINER_WORDS words otherwise, so a container never takes more
+  than 8 KB. Exactly one of values and words is set.
+
+    key         - top 16 bits of the ids
+    cardinality - ids in the container, never 0
+    values      - sorted low bits of an array container
+    words       - bits of a bitmap container
+*/
+typedef struct bitmapContainer
+{
+  uint32_t key;
+  uint32_t cardinality;
+  uint16_t * values;
+  uint64_t * words;
+} bitmapContainer;
+
+/*
+  Roaring bitmap structure
+
+  A compressed set of 32 bit ids, kept as containers in ascending key order
+  with the empty ones left out. Set operations work container by container
+  and pick the cheaper form for each result. A borrowed bitmap points into
+  memory owned elsewhere, such as a mapped index file, and is never written.
+
+    numOfContainers - containers in use
+    capacity        - containers allocated
+    containers      - the containers
+    borrowed        - TRUE when the container data is not owned
+*/
+typedef struct roaringBitmap
+{
+  int numOfContainers;
+  int capacity;
+  bitmapContainer * containers;
+  bool borrowed;
+} roaringBitmap;
+
+/*
+  Function to start an empty bitmap.
+
+  Input   = {roaringBitmap *: bitmap}
+  Output  = {void: NULL}
+*/
+void initBitmap(roaringBitmap *);
+
+/*
+  Function to free what a bitmap owns, leaving it empty.
+
+  Input   = {roaringBitmap *: bitmap}
+  Output  = {void: NULL}
+*/
+void freeBitmap(roaringBitmap *);
+
+/*
+  Function to add a container to the end of a bitmap, taking ownership of
+  its data unless the bitmap is borrowed. Its key must be above every key
+  already there.
+
+  Input   = {roaringBitmap *: bitmap, bitmapContainer *: container}
+  Output  = {bool: success}
+*/
+bool appendContainer(roaringBitmap *, const bitmapContainer *);
+
+/*
+  Function to fill a bitmap with every id below a count.
+
+  Input   = {roaringBitmap *: bitmap, uint64_t: count}
+  Output  = {bool: success}
+*/
+bool bitmapRange(roaringBitmap *, uint64_t);
+
+/*
+  Functions to combine two bitmaps into a third, which must be empty and
+  different from both: the ids in both, in either, or in the first and not
+  the second.
+
+  Input   = {roaringBitmap *: result, roaringBitmap *: first,
+            roaringBitmap *: second}
+  Output  = {bool: success}
+*/
+bool bitmapAnd(roaringBitmap *, const roaringBitmap *,
+  const roaringBitmap *);
+bool bitmapOr(roaringBitmap *, const roaringBitmap *, const roaringBitmap *);
+bool bitmapAndNot(roaringBitmap *, const roaringBitmap *,
+  const roaringBitmap *);
+
+/*
+  Function to count the ids of a bitmap.
+
+  Input   = {roaringBitmap *: bitmap}
+  Output  = {uint64_t: cardinality}
+*/
+uint64_t bitmapCardinality(const roaringBitmap *);
+
+/*
+  Function to list the smallest ids of a bitmap in ascending order.
+
+  Input   = {roaringBitmap *: bitmap, uint32_t *: ids, uint64_t: maxIds}
+  Output  = {uint64_t: numOfIds}
+*/
+uint64_t bitmapIds(const roaringBitmap *, uint32_t *, uint64_t);
+
+#endif /* RoaringBitmap_h */
@@ -0,0 +1,400 @@
+#include "SevenStud.h"
+
+/* string.h is included for memcpy. */
+#include <string.h>
+
+/* Position of each suit in bridge order, indexed by suit: H, D, C, S */
+static const unsigned char bridgeSuitOrder[NUM_OF_SUITS] = {2, 1, 0, 3};
+
+/* Bring-in key of a card, lowest brings it in */
+#define bringInKey(index) \
+  (cardIndexValue[(index)] * NUM_OF_SUITS + \
+  bridgeSuitOrder[cardIndexSuit(index)])
+
+/* Shift of the category in an up card key, above two rank masks */
+#define UP_KEY_CATEGORY_SHIFT (2 * NUM_OF_RANKS)
+
+/*
+  Function to order the up cards of a seat without the full evaluator. Four
+  or fewer cards can make neither a straight nor a flush, so the category
+  follows from the rank masks, and the masks of the grouped ranks then of the
+  loose ranks break ties the same way handStrength does. With a community
+  card five cards show and the evaluator is used instead.
+
+  Input   = {studTable *: table, int: seat}
+  Output  = {uint32_t: key}, ordered like the visible strengths
+*/
+static inline uint32_t upCardKey(const studTable * table, int seat)
+{
+  const unsigned short * upRanks = table->upRanks[seat];
+  uint32_t grouped = 0;
+  pokerRank category = HighCard;
+
+  if(table->communityCard != NO_COMMUNITY_CARD)
+  {
+    return studVisibleStrength(table, seat);
+  }
+  if(upRanks[QUAD - 1] != 0)
+  {
+    category = FourOfAKind;
+    grouped = upRanks[QUAD - 1];
+  }
+  else if(upRanks[TRIPLE - 1] != 0)
+  {
+    category = ThreeOfAKind;
+    grouped = upRanks[TRIPLE - 1];
+  }
+  else if(upRanks[PAIR - 1] != 0)
+  {
+    grouped = upRanks[PAIR - 1];
+    category = (grouped & (grouped - 1)) ? TwoPair : Pair;
+  }
+  return ((uint32_t)category << UP_KEY_CATEGORY_SHIFT) |
+    (grouped << NUM_OF_RANKS) | (upRanks[0] & ~grouped);
+}
+
+/*
+  Function to add a card dealt face up to the rank masks of a seat.
+
+  Input   = {studTable *: table, int: seat, unsigned char: card}
+  Output  = {void: NULL}
+*/
+static inline void showStudCard(studTable * table, int seat,
+  unsigned char card)
+{
+  unsigned short * upRanks = table->upRanks[seat];
+  const unsigned short bit = 1u << cardIndexValue[card];
+
+  upRanks[QUAD - 1] |= upRanks[TRIPLE - 1] & bit;
+  upRanks[TRIPLE - 1] |= upRanks[PAIR - 1] & bit;
+  upRanks[PAIR - 1] |= upRanks[0] & bit;
+  upRanks[0] |= bit;
+}
+
+/*
+  Function to deal the next card of the deck, shuffling one card ahead so a
+  hand only pays for the cards it uses.
+
+  Input   = {studTable *: table}
+  Output  = {unsigned char: card}
+*/
+static inline unsigned char dealStudCard(studTable * table)
+{
+  const int selected = table->nextCard +
+    randomBounded(& table->rng, STD_DECK_SIZE - table->nextCard);
+  const unsigned char dealtCard = table->deck[selected];
+  table->deck[selected] = table->deck[table->nextCard];
+  table->deck[table->nextCard ++] = dealtCard;
+  return dealtCard;
+}
+
+/*
+  Function to seat players at a table and seed its deck.
+
+  Input   = {studTable *: table, int: numOfPlayers, uint64_t: seed,
+            uint64_t: stream}
+  Output  = {bool: success}
+*/
+bool initStudTable(studTable * table, int numOfPlayers, uint64_t seed,
+  uint64_t stream)
+{
+  int cardNum = NUM_INIT;
+
+  if((numOfPlayers < MIN_PLAYERS) || (numOfPlayers > MAX_STUD_PLAYERS))
+  {
+    return FALSE;
+  }
+  table->numOfPlayers = numOfPlayers;
+  seedRng(& table->rng, seed, stream);
+  for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    table->deck[cardNum] = cardNum;
+  }
+  table->nextCard = 0;
+  table->street = ThirdStreet;
+  table->numOfCards = 0;
+  table->folded = 0;
+  table->communityCard = NO_COMMUNITY_CARD;
+  table->bringIn = 0;
+  table->numActing = 0;
+  return TRUE;
+}
+
+/*
+  Function to list the seats still in, going round from a first seat.
+
+  Input   = {studTable *: table, int: firstSeat}
+  Output  = {void: NULL}
+*/
+static void orderSeatsFrom(studTable * table, int firstSeat)
+{
+  int offset = NUM_INIT;
+  int seat = NUM_INIT;
+
+  table->numActing = 0;
+  for(offset = NUM_INIT; offset < table->numOfPlayers; offset ++)
+  {
+    seat = (firstSeat + offset) % table->numOfPlayers;
+    if(((table->folded >> seat) & 1) == 0)
+    {
+      table->actingOrder[table->numActing ++] = seat;
+    }
+  }
+}
+
+/*
+  Function to start a new hand and deal third street.
+
+  Input   = {studTable *: table}
+  Output  = {void: NULL}
+*/
+void startStudHand(studTable * table)
+{
+  const int numOfPlayers = table->numOfPlayers;
+  int cardNum = NUM_INIT;
+  int seat = NUM_INIT;
+  int key = 0;
+  int lowestKey = STD_DECK_SIZE;
+
+  /* The deck is never put back in order, any order shuffles as well */
+  table->nextCard = 0;
+  table->street = ThirdStreet;
+  table->folded = 0;
+  table->communityCard = NO_COMMUNITY_CARD;
+  for(cardNum = NUM_INIT; cardNum < THIRD_STREET_CARDS; cardNum ++)
+  {
+    for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+    {
+      table->cards[seat][cardNum] = dealStudCard(table);
+    }
+  }
+  table->numOfCards = THIRD_STREET_CARDS;
+  for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+  {
+    /* Two down cards and the door card face up */
+    table->faceUp[seat] = 1 << (THIRD_STREET_CARDS - 1);
+    memset(table->upRanks[seat], 0, sizeof(table->upRanks[seat]));
+    showStudCard(table, seat, table->cards[seat][THIRD_STREET_CARDS - 1]);
+    key = bringInKey(table->cards[seat][THIRD_STREET_CARDS - 1]);
+    if(key < lowestKey)
+    {
+      lowestKey = key;
+      table->bringIn = seat;
+    }
+  }
+  orderSeatsFrom(table, table->bringIn);
+}
+
+/*
+  Function to find the strength a seat shows on its up cards, counting the
+  community card when there is one.
+
+  Input   = {studTable *: table, int: seat}
+  Output  = {handStrength: strength}
+*/
+handStrength studVisibleStrength(const studTable * table, int seat)
+{
+  unsigned char upCards[STUD_CARDS + 1];
+  int numUp = 0;
+  int cardNum = NUM_INIT;
+
+  for(cardNum = NUM_INIT; cardNum < table->numOfCards; cardNum ++)
+  {
+    if((table->faceUp[seat] >> cardNum) & 1)
+    {
+      upCards[numUp ++] = table->cards[seat][cardNum];
+    }
+  }
+  if(table->communityCard != NO_COMMUNITY_CARD)
+  {
+    upCards[numUp ++] = table->communityCard;
+  }
+  return evaluateCardIndices(upCards, numUp);
+}
+
+/*
+  Function to deal the next street to every seat still in.
+
+  Input   = {studTable *: table}
+  Output  = {bool: dealt}
+*/
+bool dealStudStreet(studTable * table)
+{
+  const int numOfPlayers = table->numOfPlayers;
+  const int numIn = numOfPlayers - __builtin_popcount(table->folded);
+  uint32_t key = 0;
+  uint32_t bestKey = 0;
+  int firstSeat = INVALID_INT;
+  int seat = NUM_INIT;
+  bool faceUp = TRUE;
+
+  if(table->street == SeventhStreet)
+  {
+    return FALSE;
+  }
+  table->street ++;
+  faceUp = (table->street == SeventhStreet) ? FALSE : TRUE;
+  if((faceUp == FALSE) && (STD_DECK_SIZE - table->nextCard < numIn))
+  {
+    table->communityCard = dealStudCard(table);
+  }
+  else
+  {
+    for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+    {
+      if(((table->folded >> seat) & 1) == 0)
+      {
+        table->cards[seat][table->numOfCards] = dealStudCard(table);
+        if(faceUp == TRUE)
+        {
+          table->faceUp[seat] |= 1 << table->numOfCards;
+          showStudCard(table, seat, table->cards[seat][table->numOfCards]);
+        }
+      }
+    }
+    table->numOfCards ++;
+  }
+
+  /* The best hand showing acts first */
+  for(seat = NUM_INIT; seat < numOfPlayers; seat ++)
+  {
+    if(((table->folded >> seat) & 1) == 0)
+    {
+      key = upCardKey(table, seat);
+      if((firstSeat == INVALID_INT) || (key > bestKey))
+      {
+        bestKey = key;
+        firstSeat = seat;
+      }
+    }
+  }
+  orderSeatsFrom(table, firstSeat);
+  return TRUE;
+}
+
+/*
+  Function to fold a seat.
+
+  Input   = {studTable *: table, int: seat}
+  Output  = {bool: success}
+*/
+bool foldStudSeat(studTable * table, int seat)
+{
+  int actingNum = NUM_INIT;
+  int keptNum = NUM_INIT;
+
+  if((seat < 0) || (seat >= table->numOfPlayers) ||
+    ((table->folded >> seat) & 1) || (table->numActing <= 1))
+  {
+    return FALSE;
+  }
+  table->folded |= 1u << seat;
+  for(actingNum = NUM_INIT; actingNum < table->numActing; actingNum ++)
+  {
+    if(table->actingOrder[actingNum] != seat)
+    {
+      table->actingOrder[keptNum ++] = table->actingOrder[actingNum];
+    }
+  }
+  table->numActing = keptNum;
+  return TRUE;
+}
+
+/*
+  Function to compare the best five card hands of the seats still in.
+
+  Input   = {studTable *: table, handStrength [MAX_STUD_PLAYERS]: strengths}
+  Output  = {unsigned int: winnerMask}
+*/
+unsigned int studShowdown(const studTable * table, handStrength * strengths)
+{
+  unsigned char cards[STUD_CARDS];
+  int numOfCards = table->numOfCards;
+  int seat = NUM_INIT;
+
+  for(seat = NUM_INIT; seat < table->numOfPlayers; seat ++)
+  {
+    if((table->folded >> seat) & 1)
+    {
+      strengths[seat] = 0;
+      continue;
+    }
+    memcpy(cards, table->cards[seat], table->numOfCards);
+    if(table->communityCard != NO_COMMUNITY_CARD)
+    {
+      cards[table->numOfCards] = table->communityCard;
+      numOfCards = table->numOfCards + 1;
+    }
+    strengths[seat] = evaluateCardIndices(cards, numOfCards);
+  }
+  return findWinners(strengths, table->numOfPlayers);
+}
+
+/*
+  Function to play a whole hand with every seat staying in.
+
+  Input   = {studTable *: table, handStrength [MAX_STUD_PLAYERS]: strengths}
+  Output  = {unsigned int: winnerMask}
+*/
+unsigned int playStudHand(studTable * table, handStrength * strengths)
+{
+  startStudHand(table);
+  while(dealStudStreet(table) == TRUE)
+  {
+  }
+  return studShowdown(table, strengths);
+}
+
+/*
+  Function to print the table as a player sees it.
+
+  Input   = {studTable *: table, bool: showDownCards}
+  Output  = {void: NULL}
+*/
+void printStudTable(const studTable * table, bool showDownCards)
+{
+  const char * streetNames[] = {"Third", "Fourth", "Fifth", "Sixth",
+    "Seventh"};
+  int seat = NUM_INIT;
+  int cardNum = NUM_INIT;
+  int actingNum = NUM_INIT;
+
+  printf("%s street:\n", streetNames[table->street]);
+  for(seat = NUM_INIT; seat < table->numOfPlayers; seat ++)
+  {
+    printf("Seat %d] - ", seat + 1);
+    for(cardNum = NUM_INIT; cardNum < table->numOfCards; cardNum ++)
+    {
+      if((showDownCards == TRUE) || ((table->faceUp[seat] >> cardNum) & 1))
+      {
+        printCardIndex(table->cards[seat][cardNum]);
+      }
+      else
+      {
+        printf("[ ?-? ]");
+      }
+      printf("%s", ((table->faceUp[seat] >> cardNum) & 1) ? "^ " : "  ");
+    }
+    if((table->folded >> seat) & 1)
+    {
+      printf(" folded");
+    }
+    else if((table->street == ThirdStreet) && (seat == table->bringIn))
+    {
+      printf(" brings in");
+    }
+    printf("\n");
+  }
+  if(table->communityCard != NO_COMMUNITY_CARD)
+  {
+    printf("Community card - ");
+    printCardIndex(table->communityCard);
+    printf("\n");
+  }
+  printf("Acting order:");
+  for(actingNum = NUM_INIT; actingNum < table->numActing; actingNum ++)
+  {
+    printf(" %d", table->actingOrder[actingNum] + 1);
+  }
+  printf("\n\n");
+}
@@ -0,0 +1,144 @@
+#ifndef SevenStud_h
+#define SevenStud_h
+
+/* Cards and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Hand strengths */
+#include "HandEvaluator.h"
+/* Generator of the deck */
+#include "PokerRandom.h"
+
+/* Cards a seven card stud hand ends with */
+#define STUD_CARDS 7
+/* Most players a stud table seats, seven cards each nearly uses the deck */
+#define MAX_STUD_PLAYERS 8
+/* Cards dealt on third street, two face down and one face up */
+#define THIRD_STREET_CARDS 3
+/* Marks a table without a community card */
+#define NO_COMMUNITY_CARD 0xFF
+
+/* Streets of a hand, third street deals three cards and the rest one */
+typedef enum studStreet
+{
+  ThirdStreet, FourthStreet, FifthStreet, SixthStreet, SeventhStreet
+} studStreet;
+
+/*
+  Stud table structure
+
+  The whole state of one seven card stud hand, with nothing allocated, so a
+  table can be reused for any number of hands. Seat 0 sits at the dealer's
+  left and acting order runs up the seat numbers.
+
+    numOfPlayers  - seats dealt in
+    rng           - generator the deck is shuffled with
+    deck          - the deck, shuffled one card ahead of the deal
+    nextCard      - position in the deck of the next card to deal
+    street        - street last dealt
+    numOfCards    - cards held by every seat still in
+    cards         - cards of each seat in the order they were dealt
+    faceUp        - bit i set when card i of a seat is face up
+    upRanks       - ranks a seat shows, upRanks[s][k] holding those showing
+                    more than k times, kept as the cards are dealt
+    folded        - bit s set once seat s has folded
+    communityCard - card shared by every seat on seventh street when the
+                    deck cannot give each seat its own, else
+                    NO_COMMUNITY_CARD
+    bringIn       - seat forced to open on third street
+    actingOrder   - seats still in, in the order they act on this street
+    numActing     - seats in actingOrder
+*/
+typedef struct studTable
+{
+  int numOfPlayers;
+  pokerRng rng;
+  unsigned char deck[STD_DECK_SIZE];
+  int nextCard;
+  studStreet street;
+  int numOfCards;
+  unsigned char cards[MAX_STUD_PLAYERS][STUD_CARDS];
+  unsigned char faceUp[MAX_STUD_PLAYERS];
+  unsigned short upRanks[MAX_STUD_PLAYERS][QUAD];
+  unsigned int folded;
+  unsigned char communityCard;
+  int bringIn;
+  int actingOrder[MAX_STUD_PLAYERS];
+  int numActing;
+} studTable;
+
+/*
+  Function to seat players at a table and seed its deck. The deck starts in
+  order and is shuffled as it is dealt.
+
+  Input   = {studTable *: table, int: numOfPlayers, uint64_t: seed,
+            uint64_t: stream}
+  Output  = {bool: success}
+*/
+bool initStudTable(studTable *, int, uint64_t, uint64_t);
+
+/*
+  Function to start a new hand: every seat is back in and is dealt third
+  street, two cards face down and one face up. The lowest up card brings
+  it in, ties going to the lower suit in bridge order (clubs, diamonds,
+  hearts, spades), and acting starts with the bring-in.
+
+  Input   = {studTable *: table}
+  Output  = {void: NULL}
+*/
+void startStudHand(studTable *);
+
+/*
+  Function to deal the next street to every seat still in: one card face up
+  on fourth to sixth street and one face down on seventh. When the deck has
+  too few cards left for seventh street a single community card is turned
+  face up for everybody instead. The seat showing the best hand on its up
+  cards acts first, the lowest seat winning ties.
+
+  Input   = {studTable *: table}
+  Output  = {bool: dealt}, FALSE once seventh street has been dealt
+*/
+bool dealStudStreet(studTable *);
+
+/*
+  Function to fold a seat, removing it from the acting order.
+
+  Input   = {studTable *: table, int: seat}
+  Output  = {bool: success}, FALSE when it was the last seat in
+*/
+bool foldStudSeat(studTable *, int);
+
+/*
+  Function to find the strength a seat shows on its up cards.
+
+  Input   = {studTable *: table, int: seat}
+  Output  = {handStrength: strength}
+*/
+handStrength studVisibleStrength(const studTable *, int);
+
+/*
+  Function to compare the best five card hands of the seats still in.
+  Folded seats get strength zero.
+
+  Input   = {studTable *: table, handStrength [MAX_STUD_PLAYERS]: strengths}
+  Output  = {unsigned int: winnerMask}
+*/
+unsigned int studShowdown(const studTable *, handStrength *);
+
+/*
+  Function to play a whole hand with every seat staying in.
+
+  Input   = {studTable *: table, handStrength [MAX_STUD_PLAYERS]: strengths}
+  Output  = {unsigned int: winnerMask}
+*/
+unsigned int playStudHand(studTable *, handStrength *);
+
+/*
+  Function to print the table as a player sees it, down cards hidden unless
+  asked for.
+
+  Input   = {studTable *: table, bool: showDownCards}
+  Output  = {void: NULL}
+*/
+void printStudTable(const studTable *, bool);
+
+#endif /* SevenStud_h */
@@ -0,0 +1,636 @@
+#include "ShuffleAudit.h"
+/* Card indices of the legacy shuffle's cards */
+#include "HandEvaluator.h"
+/* Generator streams and shuffles */
+#include "PokerRandom.h"
+/* Batches of decks shuffled side by side */
+#include "BatchShuffle.h"
+/* Worker threads */
+#include "PokerThreads.h"
+
+/* stdatomic.h is included for the batch counter. */
+#include <stdatomic.h>
+/* stdlib.h is included for calloc and free. */
+#include <stdlib.h>
+/* string.h is included for strcmp and memset. */
+#include <string.h>
+/* math.h is included for sqrt, cbrt, erfc, fabs and HUGE_VAL. */
+#include <math.h>
+
+/* Cells of the card position and adjacent pair counts */
+#define POSITION_CELLS (STD_DECK_SIZE * STD_DECK_SIZE)
+/* Longest permutation prefix counted */
+#define MAX_PREFIX_LENGTH 3
+/* Fewest decks expected in each prefix cell before a prefix is lengthened */
+#define MIN_PREFIX_EXPECTED 5
+/* Bits a rand15 draw keeps, those of rand() where RAND_MAX is 32767 */
+#define RAND15_BITS 15
+
+/* Tests of an audit, in report order */
+typedef enum auditTestNum
+{
+  PositionTest, PositionDeviationTest, PairTest, PairDeviationTest,
+  PrefixTest
+} auditTestNum;
+
+/*
+  Counts of one thread, each thread's on cache lines of its own.
+
+    positions - decks placing a card at a position, card * 52 + position
+    pairs     - decks with one card right before another, first * 52 + second
+    prefixes  - decks starting with a prefix, the prefix's cards in base 52
+    state     - generator state of the plugin
+    decks     - batch being shuffled
+*/
+typedef struct auditWorker
+{
+  uint64_t positions[POSITION_CELLS];
+  uint64_t pairs[POSITION_CELLS];
+  uint64_t * prefixes;
+  void * state;
+  unsigned char * decks;
+  char padding[CACHE_LINE_SIZE];
+} auditWorker;
+
+/* State shared by the audit threads */
+typedef struct auditContext
+{
+  const auditConfig * config;
+  uint64_t numOfBatches;
+  int prefixLength;
+  atomic_ullong nextBatch;
+  auditWorker * workers;
+} auditContext;
+
+/*
+  Functions of the fisher-yates plugin, shuffleCardIndices on a pokerRng.
+*/
+static void seedPokerRng(void * state, uint64_t seed, uint64_t stream)
+{
+  seedRng((pokerRng *)state, seed, stream);
+}
+
+static void shuffleFisherYates(void * state, unsigned char * decks,
+  int numOfDecks)
+{
+  int deckNum = NUM_INIT;
+
+  for(deckNum = NUM_INIT; deckNum < numOfDecks; deckNum ++)
+  {
+    shuffleCardIndices((pokerRng *)state, decks + deckNum * STD_DECK_SIZE,
+      STD_DECK_SIZE, STD_DECK_SIZE);
+  }
+}
+
+/*
+  Functions of the batch plugin, shuffleDeckBatch on its fastest path.
+*/
+static void seedBatchLanes(void * state, uint64_t seed, uint64_t stream)
+{
+  seedBatchRng((batchRng *)state, seed, stream);
+}
+
+static void shuffleBatch(void * state, unsigned char * decks, int numOfDecks)
+{
+  shuffleDeckBatch((batchRng *)state, decks, numOfDecks, STD_DECK_SIZE,
+    STD_DECK_SIZE);
+}
+
+/*
+  Function of the rand15 plugin: Fisher-Yates drawing 15 bits at a time and
+  reducing them with a remainder, the way rand() % range behaves where
+  RAND_MAX is 32767. Low remainders come up slightly more often, a bias of
+  about one part in 630 that only a long audit sees.
+*/
+static void shuffleRand15(void * state, unsigned char * decks, int numOfDecks)
+{
+  unsigned char * deck = decks;
+  unsigned char swapped = 0;
+  int deckNum = NUM_INIT;
+  int range = NUM_INIT;
+  int selected = NUM_INIT;
+
+  for(deckNum = NUM_INIT; deckNum < numOfDecks; deckNum ++)
+  {
+    deck = decks + deckNum * STD_DECK_SIZE;
+    for(range = STD_DECK_SIZE; range > 1; range --)
+    {
+      selected = (int)(nextRandom((pokerRng *)state) >> (64 - RAND15_BITS))
+        % range;
+      swapped = deck[selected];
+      deck[selected] = deck[range - 1];
+      deck[range - 1] = swapped;
+    }
+  }
+}
+
+/*
+  Function of the legacy plugin: modernFisherYatesShuffle on a fresh deck,
+  read back as card indices. It reseeds rand() from the clock on every call.
+*/
+static void shuffleLegacy(void * state, unsigned char * decks, int numOfDecks)
+{
+  card deck[STD_DECK_SIZE];
+  int deckNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  (void)state;
+  for(deckNum = NUM_INIT; deckNum < numOfDecks; deckNum ++)
+  {
+    createDeck(deck);
+    modernFisherYatesShuffle(deck);
+    for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+    {
+      decks[deckNum * STD_DECK_SIZE + cardNum] = cardToIndex(& deck[cardNum]);
+    }
+  }
+}
+
+/* Shuffles that can be audited */
+static const shufflePlugin shufflePlugins[] =
+{
+  {"fisher-yates", "shuffleCardIndices, Fisher-Yates on xoshiro256**",
+    sizeof(pokerRng), seedPokerRng, shuffleFisherYates, TRUE},
+  {"batch", "shuffleDeckBatch, eight xoshiro128** lanes side by side",
+    sizeof(batchRng), seedBatchLanes, shuffleBatch, TRUE},
+  {"rand15", "Fisher-Yates with a 15 bit rand() % range, slightly biased",
+    sizeof(pokerRng), seedPokerRng, shuffleRand15, TRUE},
+  {"legacy", "modernFisherYatesShuffle, srand(time(0)) and rand() % range",
+    0, NULL, shuffleLegacy, FALSE}
+};
+
+/*
+  Function to find a shuffle plugin by name.
+
+  Input   = {char *: name}
+  Output  = {shufflePlugin *: plugin}, NULL when there is none of that name
+*/
+const shufflePlugin * findShufflePlugin(const char * name)
+{
+  int pluginNum = NUM_INIT;
+  const int numOfPlugins = sizeof(shufflePlugins) / sizeof(shufflePlugin);
+
+  for(pluginNum = NUM_INIT; pluginNum < numOfPlugins; pluginNum ++)
+  {
+    if(strcmp(shufflePlugins[pluginNum].name, name) == 0)
+    {
+      return & shufflePlugins[pluginNum];
+    }
+  }
+  return NULL;
+}
+
+/*
+  Function to list the shuffle plugins.
+
+  Input   = {int *: numOfPlugins}
+  Output  = {shufflePlugin *: plugins}
+*/
+const shufflePlugin * listShufflePlugins(int * numOfPlugins)
+{
+  * numOfPlugins = sizeof(shufflePlugins) / sizeof(shufflePlugin);
+  return shufflePlugins;
+}
+
+/*
+  Function to count the permutations of a shuffled batch. Deck d of the
+  whole audit records its adjacent pair at positions d % 51 and d % 51 + 1.
+
+  Input   = {auditWorker *: worker, int: prefixLength, int: numOfDecks,
+            uint64_t: firstDeck}
+  Output  = {void: NULL}
+*/
+static void countBatch(auditWorker * worker, int prefixLength,
+  int numOfDecks, uint64_t firstDeck)
+{
+  const unsigned char * deck = worker->decks;
+  int pairPosition = (int)(firstDeck % (STD_DECK_SIZE - 1));
+  int deckNum = NUM_INIT;
+  int position = NUM_INIT;
+  int prefix = NUM_INIT;
+
+  for(deckNum = NUM_INIT; deckNum < numOfDecks; deckNum ++)
+  {
+    for(position = NUM_INIT; position < STD_DECK_SIZE; position ++)
+    {
+      worker->positions[deck[position] * STD_DECK_SIZE + position] ++;
+    }
+    worker->pairs[deck[pairPosition] * STD_DECK_SIZE +
+      deck[pairPosition + 1]] ++;
+    prefix = NUM_INIT;
+    for(position = NUM_INIT; position < prefixLength; position ++)
+    {
+      prefix = prefix * STD_DECK_SIZE + deck[position];
+    }
+    worker->prefixes[prefix] ++;
+    if(++ pairPosition == STD_DECK_SIZE - 1)
+    {
+      pairPosition = NUM_INIT;
+    }
+    deck += STD_DECK_SIZE;
+  }
+}
+
+/*
+  Function run by every audit thread: take batches until none are left,
+  shuffle them from ordered decks on the batch's own stream and count them.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void auditThread(void * contextPTR, int threadNum)
+{
+  auditContext * context = (auditContext *)contextPTR;
+  const auditConfig * config = context->config;
+  const shufflePlugin * plugin = config->plugin;
+  auditWorker * worker = & context->workers[threadNum];
+  uint64_t batchNum = 0;
+  uint64_t firstDeck = 0;
+  int numOfDecks = NUM_INIT;
+
+  for(;;)
+  {
+    batchNum = atomic_fetch_add_explicit(& context->nextBatch, 1,
+      memory_order_relaxed);
+    if(batchNum >= context->numOfBatches)
+    {
+      break;
+    }
+    firstDeck = batchNum * AUDIT_BATCH_DECKS;
+    numOfDecks = AUDIT_BATCH_DECKS;
+    if(config->numOfDecks - firstDeck < AUDIT_BATCH_DECKS)
+    {
+      numOfDecks = (int)(config->numOfDecks - firstDeck);
+    }
+    if(plugin->seed != NULL)
+    {
+      plugin->seed(worker->state, config->seed, batchNum);
+    }
+    initDeckBatch(worker->decks, numOfDecks, STD_DECK_SIZE);
+    plugin->shuffle(worker->state, worker->decks, numOfDecks);
+    countBatch(worker, context->prefixLength, numOfDecks, firstDeck);
+  }
+}
+
+/*
+  Function to give the chance a chi-square variable exceeds a value, with
+  the Wilson-Hilferty normal approximation, accurate to a few per cent of
+  the p-value at the thousands of degrees of freedom tested here.
+
+  Input   = {double: statistic, double: degrees}
+  Output  = {double: pValue}
+*/
+static double chiSquareTail(double statistic, double degrees)
+{
+  const double spread = 2.0 / (9.0 * degrees);
+  const double z = (cbrt(statistic / degrees) - (1.0 - spread)) /
+    sqrt(spread);
+
+  return 0.5 * erfc(z / sqrt(2.0));
+}
+
+/*
+  Function to fill in a chi-square test, which fails when the statistic is
+  either too large, the counts too uneven, or too small, the counts too
+  even for chance.
+
+  Input   = {auditTest *: test, char *: name, double: statistic,
+            double: degrees, double: alpha}
+  Output  = {void: NULL}
+*/
+static void chiSquareTest(auditTest * test, const char * name,
+  double statistic, double degrees, double alpha)
+{
+  test->name = name;
+  test->statistic = statistic;
+  test->degrees = degrees;
+  test->pValue = chiSquareTail(statistic, degrees);
+  test->passed = (test->pValue >= alpha && test->pValue <= 1.0 - alpha)
+    ? TRUE : FALSE;
+}
+
+/*
+  Function to fill in a deviation test from the largest standardised
+  deviation of any of a number of cells, its p-value bounded above by
+  Bonferroni's inequality.
+
+  Input   = {auditTest *: test, char *: name, double: largest,
+            double: numOfCells, double: alpha}
+  Output  = {void: NULL}
+*/
+static void deviationTest(auditTest * test, const char * name,
+  double largest, double numOfCells, double alpha)
+{
+  test->name = name;
+  test->statistic = largest;
+  test->degrees = numOfCells;
+  test->pValue = fmin(1.0, numOfCells * erfc(largest / sqrt(2.0)));
+  test->passed = (test->pValue >= alpha) ? TRUE : FALSE;
+}
+
+/*
+  Function to test the card position counts: every card should sit at every
+  position of 1 in 52 decks.
+
+  Input   = {auditReport *: report, uint64_t *: positions, double: alpha}
+  Output  = {void: NULL}
+*/
+static void testPositions(auditReport * report, const uint64_t * positions,
+  double alpha)
+{
+  const double decks = (double)report->numOfDecks;
+  const double expected = decks / STD_DECK_SIZE;
+  const double spread = sqrt(expected * (STD_DECK_SIZE - 1) / STD_DECK_SIZE);
+  double statistic = 0.0;
+  double largest = 0.0;
+  double deviation = 0.0;
+  int cellNum = NUM_INIT;
+
+  for(cellNum = NUM_INIT; cellNum < POSITION_CELLS; cellNum ++)
+  {
+    deviation = (double)positions[cellNum] - expected;
+    statistic += deviation * deviation / expected;
+    largest = fmax(largest, fabs(deviation) / spread);
+  }
+  /* Each deck fills every row and column once, leaving 51 * 51 degrees */
+  chiSquareTest(& report->tests[PositionTest], "card positions",
+    statistic * (STD_DECK_SIZE - 1) / STD_DECK_SIZE,
+    (STD_DECK_SIZE - 1) * (STD_DECK_SIZE - 1), alpha);
+  deviationTest(& report->tests[PositionDeviationTest],
+    "largest position deviation", largest, POSITION_CELLS, alpha);
+}
+
+/*
+  Function to give the cells of the counts of a sequence of cards, every
+  card of it a digit in base 52.
+
+  Input   = {int: length}
+  Output  = {int: numOfCells}
+*/
+static int sequenceCells(int length)
+{
+  int cells = 1;
+  int cardNum = NUM_INIT;
+
+  for(cardNum = NUM_INIT; cardNum < length; cardNum ++)
+  {
+    cells *= STD_DECK_SIZE;
+  }
+  return cells;
+}
+
+/*
+  Function to give the ordered choices of distinct cards of a length.
+
+  Input   = {int: length}
+  Output  = {int: numOfChoices}
+*/
+static int distinctChoices(int length)
+{
+  int choices = 1;
+  int cardNum = NUM_INIT;
+
+  for(cardNum = NUM_INIT; cardNum < length; cardNum ++)
+  {
+    choices *= STD_DECK_SIZE - cardNum;
+  }
+  return choices;
+}
+
+/*
+  Function to add up a chi-square over the counts of a sequence of cards in
+  which every ordered choice of distinct cards is equally likely, and find
+  the largest standardised deviation of a cell. Cells repeating a card can
+  never be filled by a permutation; any count in one makes both infinite.
+
+  Input   = {uint64_t *: counts, int: length, double: expected,
+            double: spread, double *: largest}
+  Output  = {double: statistic}
+*/
+static double sequenceStatistic(const uint64_t * counts, int length,
+  double expected, double spread, double * largest)
+{
+  const int numOfCells = sequenceCells(length);
+  unsigned long long seen = 0;
+  double statistic = 0.0;
+  double deviation = 0.0;
+  bool distinct = TRUE;
+  int cellNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+  int digits = NUM_INIT;
+
+  * largest = 0.0;
+  for(cellNum = NUM_INIT; cellNum < numOfCells; cellNum ++)
+  {
+    seen = 0;
+    distinct = TRUE;
+    digits = cellNum;
+    for(cardNum = NUM_INIT; cardNum < length; cardNum ++)
+    {
+      if((seen >> (digits % STD_DECK_SIZE)) & 1)
+      {
+        distinct = FALSE;
+      }
+      seen |= 1ULL << (digits % STD_DECK_SIZE);
+      digits /= STD_DECK_SIZE;
+    }
+    if(distinct == TRUE)
+    {
+      deviation = (double)counts[cellNum] - expected;
+      statistic += deviation * deviation / expected;
+      * largest = fmax(* largest, fabs(deviation) / spread);
+    }
+    else if(counts[cellNum] != 0)
+    {
+      * largest = HUGE_VAL;
+      return HUGE_VAL;
+    }
+  }
+  return statistic;
+}
+
+/*
+  Function to test the adjacent pair and prefix counts, every ordered pair
+  or prefix of distinct cards being equally likely.
+
+  Input   = {auditReport *: report, uint64_t *: pairs, uint64_t *: prefixes,
+            double: alpha}
+  Output  = {void: NULL}
+*/
+static void testSequences(auditReport * report, const uint64_t * pairs,
+  const uint64_t * prefixes, double alpha)
+{
+  const double decks = (double)report->numOfDecks;
+  const int numOfPairs = distinctChoices(2);
+  const int numOfPrefixes = distinctChoices(report->prefixLength);
+  const double pairExpected = decks / numOfPairs;
+  const double prefixExpected = decks / numOfPrefixes;
+  double largest = 0.0;
+  double statistic = 0.0;
+
+  statistic = sequenceStatistic(pairs, 2, pairExpected,
+    sqrt(pairExpected * (numOfPairs - 1) / numOfPairs), & largest);
+  chiSquareTest(& report->tests[PairTest], "adjacent pairs", statistic,
+    numOfPairs - 1, alpha);
+  deviationTest(& report->tests[PairDeviationTest], "largest pair deviation",
+    largest, numOfPairs, alpha);
+  statistic = sequenceStatistic(prefixes, report->prefixLength,
+    prefixExpected,
+    sqrt(prefixExpected * (numOfPrefixes - 1) / numOfPrefixes), & largest);
+  chiSquareTest(& report->tests[PrefixTest], "permutation prefixes",
+    statistic, numOfPrefixes - 1, alpha);
+}
+
+/*
+  Function to choose the prefix length, the longest expecting at least
+  MIN_PREFIX_EXPECTED decks in each cell.
+
+  Input   = {uint64_t: numOfDecks}
+  Output  = {int: prefixLength}
+*/
+static int choosePrefixLength(uint64_t numOfDecks)
+{
+  int length = MAX_PREFIX_LENGTH;
+
+  while(length > 1 &&
+    numOfDecks < (uint64_t)MIN_PREFIX_EXPECTED * distinctChoices(length))
+  {
+    length --;
+  }
+  return length;
+}
+
+/*
+  Function to free the counts and buffers of the audit threads.
+
+  Input   = {auditWorker *: workers, int: numOfWorkers}
+  Output  = {void: NULL}
+*/
+static void freeAuditWorkers(auditWorker * workers, int numOfWorkers)
+{
+  int workerNum = NUM_INIT;
+
+  for(workerNum = NUM_INIT; workerNum < numOfWorkers; workerNum ++)
+  {
+    free(workers[workerNum].prefixes);
+    free(workers[workerNum].state);
+    free(workers[workerNum].decks);
+  }
+  free(workers);
+}
+
+/*
+  Function to allocate the counts and buffers of the audit threads.
+
+  Input   = {int: numOfWorkers, size_t: stateSize, int: prefixLength}
+  Output  = {auditWorker *: workers}, NULL when there is not enough memory
+*/
+static auditWorker * allocateAuditWorkers(int numOfWorkers, size_t stateSize,
+  int prefixLength)
+{
+  auditWorker * workers = calloc(numOfWorkers, sizeof(auditWorker));
+  const int prefixCells = sequenceCells(prefixLength);
+  int workerNum = NUM_INIT;
+
+  if(workers == NULL)
+  {
+    return NULL;
+  }
+  for(workerNum = NUM_INIT; workerNum < numOfWorkers; workerNum ++)
+  {
+    workers[workerNum].prefixes = calloc(prefixCells, sizeof(uint64_t));
+    workers[workerNum].state = calloc(1, stateSize > 0 ? stateSize : 1);
+    workers[workerNum].decks = malloc(AUDIT_BATCH_DECKS * STD_DECK_SIZE);
+    if(workers[workerNum].prefixes == NULL ||
+      workers[workerNum].state == NULL || workers[workerNum].decks == NULL)
+    {
+      freeAuditWorkers(workers, workerNum + 1);
+      return NULL;
+    }
+  }
+  return workers;
+}
+
+/*
+  Function to add the counts of every thread into those of the first.
+
+  Input   = {auditWorker *: workers, int: numOfWorkers, int: prefixLength}
+  Output  = {void: NULL}
+*/
+static void mergeAuditCounts(auditWorker * workers, int numOfWorkers,
+  int prefixLength)
+{
+  const int prefixCells = sequenceCells(prefixLength);
+  int workerNum = NUM_INIT;
+  int cellNum = NUM_INIT;
+
+  for(workerNum = 1; workerNum < numOfWorkers; workerNum ++)
+  {
+    for(cellNum = NUM_INIT; cellNum < POSITION_CELLS; cellNum ++)
+    {
+      workers[0].positions[cellNum] += workers[workerNum].positions[cellNum];
+      workers[0].pairs[cellNum] += workers[workerNum].pairs[cellNum];
+    }
+    for(cellNum = NUM_INIT; cellNum < prefixCells; cellNum ++)
+    {
+      workers[0].prefixes[cellNum] += workers[workerNum].prefixes[cellNum];
+    }
+  }
+}
+
+/*
+  Function to audit a shuffle.
+
+  Input   = {auditConfig *: config, auditReport *: report}
+  Output  = {bool: success}, FALSE when there is not enough memory
+*/
+bool auditShuffle(const auditConfig * config, auditReport * report)
+{
+  auditContext context;
+  double started = 0.0;
+  int numOfWorkers = config->numOfThreads;
+  int testNum = NUM_INIT;
+
+  memset(report, 0, sizeof(auditReport));
+  context.config = config;
+  context.numOfBatches = (config->numOfDecks + AUDIT_BATCH_DECKS - 1) /
+    AUDIT_BATCH_DECKS;
+  context.prefixLength = choosePrefixLength(config->numOfDecks);
+  atomic_init(& context.nextBatch, 0);
+  if(config->plugin->threadSafe == FALSE || numOfWorkers < 1)
+  {
+    numOfWorkers = 1;
+  }
+  if((uint64_t)numOfWorkers > context.numOfBatches)
+  {
+    numOfWorkers = context.numOfBatches > 0 ? (int)context.numOfBatches : 1;
+  }
+  context.workers = allocateAuditWorkers(numOfWorkers,
+    config->plugin->stateSize, context.prefixLength);
+  if(context.workers == NULL)
+  {
+    return FALSE;
+  }
+
+  started = currentSeconds();
+  runParallel(numOfWorkers, auditThread, & context);
+  report->seconds = currentSeconds() - started;
+  mergeAuditCounts(context.workers, numOfWorkers, context.prefixLength);
+
+  report->numOfDecks = config->numOfDecks;
+  report->numOfThreads = numOfWorkers;
+  report->prefixLength = context.prefixLength;
+  testPositions(report, context.workers[0].positions, config->alpha);
+  testSequences(report, context.workers[0].pairs, context.workers[0].prefixes,
+    config->alpha);
+  report->passed = TRUE;
+  for(testNum = NUM_INIT; testNum < NUM_AUDIT_TESTS; testNum ++)
+  {
+    if(report->tests[testNum].passed == FALSE)
+    {
+      report->passed = FALSE;
+    }
+  }
+  freeAuditWorkers(context.workers, numOfWorkers);
+  return TRUE;
+}
@@ -0,0 +1,140 @@
+#ifndef ShuffleAudit_h
+#define ShuffleAudit_h
+
+/* Cards and decks of the simulated Poker Table. */
+#include "PokerTable.h"
+
+/*
+  stdint.h is included for the deck counts and stddef.h for the sizes of the
+  generator states.
+*/
+#include <stdint.h>
+#include <stddef.h>
+
+/* Tests of an audit */
+#define NUM_AUDIT_TESTS 5
+/* Chance of failing a fair shuffle a test allows when none is given */
+#define DEFAULT_AUDIT_ALPHA 1e-4
+/* Decks each thread shuffles from one generator stream */
+#define AUDIT_BATCH_DECKS 4096
+
+/*
+  Shuffle plugin structure
+
+  A shuffle under audit. The auditor hands it batches of ordered decks of
+  STD_DECK_SIZE card indices, back to back, and reads the permutations it
+  leaves. Every thread owns a generator state of stateSize bytes, seeded
+  afresh for each batch from the audit seed and the batch number, so an
+  audit gives the same results on any number of threads.
+
+    name       - name the plugin is chosen by
+    summary    - one line description
+    stateSize  - bytes of the generator state, 0 for none
+    seed       - seeds a state from a seed and a stream, may be NULL
+    shuffle    - shuffles a batch of decks in place
+    threadSafe - FALSE when the shuffle keeps global state, such as rand(),
+                 and has to be audited on one thread
+*/
+typedef struct shufflePlugin
+{
+  const char * name;
+  const char * summary;
+  size_t stateSize;
+  void (* seed)(void *, uint64_t, uint64_t);
+  void (* shuffle)(void *, unsigned char *, int);
+  bool threadSafe;
+} shufflePlugin;
+
+/*
+  Audit test structure, the outcome of one goodness of fit test.
+
+    name      - what the test measures
+    statistic - chi-square or largest standardised deviation
+    degrees   - degrees of freedom, or cells compared for a deviation test
+    pValue    - chance a fair shuffle gives a statistic this far out
+    passed    - TRUE when the p-value is inside the allowed band
+*/
+typedef struct auditTest
+{
+  const char * name;
+  double statistic;
+  double degrees;
+  double pValue;
+  bool passed;
+} auditTest;
+
+/*
+  Audit configuration structure
+
+    plugin       - shuffle audited
+    numOfDecks   - decks shuffled
+    seed         - seed of the generator streams
+    numOfThreads - threads shuffling, 1 for a plugin that is not thread safe
+    alpha        - chance of failing a fair shuffle each test allows
+*/
+typedef struct auditConfig
+{
+  const shufflePlugin * plugin;
+  uint64_t numOfDecks;
+  uint64_t seed;
+  int numOfThreads;
+  double alpha;
+} auditConfig;
+
+/*
+  Audit report structure
+
+    numOfDecks   - decks shuffled
+    numOfThreads - threads that shuffled
+    seconds      - wall time of the shuffles and counts
+    prefixLength - cards of the permutation prefixes counted
+    tests        - outcome of each test
+    passed       - TRUE when every test passed
+*/
+typedef struct auditReport
+{
+  uint64_t numOfDecks;
+  int numOfThreads;
+  double seconds;
+  int prefixLength;
+  auditTest tests[NUM_AUDIT_TESTS];
+  bool passed;
+} auditReport;
+
+/*
+  Function to find a shuffle plugin by name. The plugins are fisher-yates
+  (shuffleCardIndices), batch (the eight lane batch shuffle), rand15 (a
+  Fisher-Yates reduced with rand() % range from a 15 bit generator, as on
+  platforms whose RAND_MAX is 32767) and legacy (modernFisherYatesShuffle
+  itself).
+
+  Input   = {char *: name}
+  Output  = {shufflePlugin *: plugin}, NULL when there is none of that name
+*/
+const shufflePlugin * findShufflePlugin(const char *);
+
+/*
+  Function to list the shuffle plugins.
+
+  Input   = {int *: numOfPlugins}
+  Output  = {shufflePlugin *: plugins}
+*/
+const shufflePlugin * listShufflePlugins(int *);
+
+/*
+  Function to audit a shuffle. The threads count, in counters of their own,
+  the position of every card, the ordered pair at one position pair of each
+  deck, turning through the 51 of them, and the first cards of each
+  permutation, then the counts are merged and tested. Pearson chi-square
+  tests cover the card positions, scaled by 51/52 since each deck places
+  every card once, the adjacent pairs and the prefixes, and the largest
+  standardised deviation of a single card position or pair is tested with
+  a Bonferroni bound. Prefixes are three cards long when there are enough
+  decks to expect five of each, and shorter otherwise.
+
+  Input   = {auditConfig *: config, auditReport *: report}
+  Output  = {bool: success}, FALSE when there is not enough memory
+*/
+bool auditShuffle(const auditConfig *, auditReport *);
+
+#endif /* ShuffleAudit_h */
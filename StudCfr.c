@@ -0,0 +1,898 @@
+#include "StudCfr.h"
+/* Colex combinations */
+#include "Combinatorics.h"
+/* Generator streams and shuffles */
+#include "PokerRandom.h"
+/* Worker threads */
+#include "PokerThreads.h"
+
+/* string.h is included for memcmp, memcpy and memset. */
+#include <string.h>
+
+/* Cards dealt to the two players */
+#define CFR_PLAYERS 2
+#define CFR_DEALT_CARDS (CFR_PLAYERS * CARDS_PER_HAND)
+/* Decisions of a street at most, and so the depth of the betting tree */
+#define CFR_STREET_DECISIONS (CFR_MAX_BETS + 2)
+#define CFR_MAX_DEPTH (CFR_STREETS * CFR_STREET_DECISIONS + 1)
+/* Mask of a bucket sequence in a packed deal */
+#define CFR_SEQUENCE_MASK ((1U << CFR_SEQUENCE_BITS) - 1)
+
+/* Sequence of a player, and player 0's outcome, of a packed deal */
+#define dealSequence(deal, player) \
+  (((deal) >> ((player) * CFR_SEQUENCE_BITS)) & CFR_SEQUENCE_MASK)
+#define dealOutcome(deal) ((int)((deal) >> (2 * CFR_SEQUENCE_BITS)) - 1)
+
+/*
+  One thread's additions to the tables during a batch, padded so threads
+  never share a cache line.
+
+    regretDeltas   - regrets added
+    strategyDeltas - strategy added
+*/
+typedef struct cfrWorker
+{
+  float * regretDeltas;
+  float * strategyDeltas;
+  char padding[CACHE_LINE_SIZE];
+} cfrWorker;
+
+/* State shared by the threads of a batch */
+typedef struct cfrContext
+{
+  const cfrSolver * solver;
+  cfrWorker * workers;
+  float weight;
+} cfrContext;
+
+/* Vectors of a best response at every depth of the betting tree */
+typedef struct responseSpace
+{
+  double * reach[CFR_MAX_DEPTH];
+  double * values[CFR_MAX_DEPTH][CFR_MAX_ACTIONS];
+} responseSpace;
+
+/* Order strengths */
+static int compareStrengths(const void * first, const void * second)
+{
+  const handStrength a = * (const handStrength *)first;
+  const handStrength b = * (const handStrength *)second;
+  return (a > b) - (a < b);
+}
+
+/*
+  Function to find the bucket thresholds of a street by ranking every hand
+  of as many cards.
+
+  Input   = {cfrSolver *: solver, int: street}
+  Output  = {bool: success}
+*/
+static bool findThresholds(cfrSolver * solver, int street)
+{
+  const int numOfCards = CFR_FIRST_STREET_CARDS + street;
+  const int numOfBuckets = solver->config.numOfBuckets;
+  const uint64_t numOfHands = choose(STD_DECK_SIZE, numOfCards);
+  handStrength * strengths = malloc(sizeof(handStrength) * numOfHands);
+  unsigned char positions[CARDS_PER_HAND];
+  uint64_t handNum = 0;
+  int cardNum = NUM_INIT;
+  int bucket = NUM_INIT;
+
+  if(strengths == NULL)
+  {
+    return FALSE;
+  }
+  for(cardNum = NUM_INIT; cardNum < numOfCards; cardNum ++)
+  {
+    positions[cardNum] = cardNum;
+  }
+  do
+  {
+    strengths[handNum ++] = evaluateCardIndices(positions, numOfCards);
+  } while(nextCombination(positions, numOfCards, STD_DECK_SIZE) == TRUE);
+  qsort(strengths, numOfHands, sizeof(handStrength), compareStrengths);
+  for(bucket = 1; bucket < numOfBuckets; bucket ++)
+  {
+    solver->thresholds[street][bucket - 1] =
+      strengths[numOfHands * bucket / numOfBuckets];
+  }
+  free(strengths);
+  return TRUE;
+}
+
+/*
+  Function to find the bucket of a strength on a street, the number of
+  thresholds it reaches.
+
+  Input   = {cfrSolver *: solver, int: street, handStrength: strength}
+  Output  = {int: bucket}
+*/
+static int strengthBucket(const cfrSolver * solver, int street,
+  handStrength strength)
+{
+  int bucket = NUM_INIT;
+
+  while((bucket < solver->config.numOfBuckets - 1) &&
+    (strength >= solver->thresholds[street][bucket]))
+  {
+    bucket ++;
+  }
+  return bucket;
+}
+
+/*
+  Function to add a node to the betting tree.
+
+  Input   = {cfrSolver *: solver, int: type, int: player, int: street,
+            int: contribution}
+  Output  = {int: nodeNum}, INVALID_INT when the tree is full
+*/
+static int addNode(cfrSolver * solver, int type, int player, int street,
+  int contribution)
+{
+  cfrNode * node = NULL;
+
+  if(solver->numOfNodes == MAX_CFR_NODES)
+  {
+    return INVALID_INT;
+  }
+  node = & solver->nodes[solver->numOfNodes];
+  memset(node, 0, sizeof(cfrNode));
+  node->type = type;
+  node->player = player;
+  node->street = street;
+  node->contribution = contribution;
+  return solver->numOfNodes ++;
+}
+
+/* Declared ahead, the streets and their decisions build each other */
+static int buildDecision(cfrSolver *, int, int, int, const int [CFR_PLAYERS]);
+
+/*
+  Function to build what follows a street once the bets are matched: the
+  next street, opened by player 0, or the showdown.
+
+  Input   = {cfrSolver *: solver, int: street, int *: contributions}
+  Output  = {int: nodeNum}, INVALID_INT when the tree is full
+*/
+static int buildStreetEnd(cfrSolver * solver, int street,
+  const int contributions[CFR_PLAYERS])
+{
+  if(street + 1 < CFR_STREETS)
+  {
+    return buildDecision(solver, street + 1, 0, 0, contributions);
+  }
+  return addNode(solver, CFR_SHOWDOWN_NODE, 0, street, contributions[0]);
+}
+
+/*
+  Function to build a decision and the tree below it. A player facing a bet
+  folds, calls or raises while raises are left; otherwise they check or
+  bet, and a check by the second player ends the street.
+
+  Input   = {cfrSolver *: solver, int: street, int: player, int: numOfBets,
+            int *: contributions}
+  Output  = {int: nodeNum}, INVALID_INT when the tree is full
+*/
+static int buildDecision(cfrSolver * solver, int street, int player,
+  int numOfBets, const int contributions[CFR_PLAYERS])
+{
+  const int betSize = (street == CFR_STREETS - 1) ? CFR_BIG_BET :
+    CFR_SMALL_BET;
+  const int other = 1 - player;
+  const bool facing = (contributions[player] < contributions[other]) ?
+    TRUE : FALSE;
+  int next[CFR_PLAYERS];
+  int children[CFR_MAX_ACTIONS];
+  unsigned char actions[CFR_MAX_ACTIONS];
+  int nodeNum = addNode(solver, CFR_DECISION_NODE, player, street, 0);
+  int numOfActions = NUM_INIT;
+  int actionNum = NUM_INIT;
+
+  if(nodeNum == INVALID_INT)
+  {
+    return INVALID_INT;
+  }
+  if(facing == TRUE)
+  {
+    actions[numOfActions] = CFR_FOLD;
+    children[numOfActions ++] = addNode(solver, CFR_FOLD_NODE, player, street,
+      contributions[player]);
+    memcpy(next, contributions, sizeof(next));
+    next[player] = next[other];
+    actions[numOfActions] = CFR_CALL;
+    children[numOfActions ++] = buildStreetEnd(solver, street, next);
+  }
+  else
+  {
+    actions[numOfActions] = CFR_CALL;
+    children[numOfActions ++] = (player == 1) ?
+      buildStreetEnd(solver, street, contributions) :
+      buildDecision(solver, street, other, numOfBets, contributions);
+  }
+  if(numOfBets < CFR_MAX_BETS)
+  {
+    memcpy(next, contributions, sizeof(next));
+    next[player] = next[other] + betSize;
+    actions[numOfActions] = CFR_RAISE;
+    children[numOfActions ++] = buildDecision(solver, street, other,
+      numOfBets + 1, next);
+  }
+  for(actionNum = NUM_INIT; actionNum < numOfActions; actionNum ++)
+  {
+    if(children[actionNum] == INVALID_INT)
+    {
+      return INVALID_INT;
+    }
+    solver->nodes[nodeNum].actions[actionNum] = actions[actionNum];
+    solver->nodes[nodeNum].children[actionNum] = children[actionNum];
+  }
+  solver->nodes[nodeNum].numOfActions = numOfActions;
+  return nodeNum;
+}
+
+/*
+  Function to deal the fixed deals of the abstract game and tally the
+  chance and showdown of every pair of bucket sequences.
+
+  Input   = {cfrSolver *: solver}
+  Output  = {void: NULL}
+*/
+static void dealAbstractGame(cfrSolver * solver)
+{
+  const int numOfSequences = solver->numOfSequences;
+  const double share = 1.0 / solver->config.numOfDeals;
+  unsigned char deck[STD_DECK_SIZE];
+  handStrength strengths[CFR_PLAYERS];
+  uint32_t sequences[CFR_PLAYERS];
+  pokerRng rng;
+  uint64_t dealNum = 0;
+  size_t pair = 0;
+  int outcome = NUM_INIT;
+  int player = NUM_INIT;
+  int street = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    deck[cardNum] = cardNum;
+  }
+  seedRng(& rng, solver->config.seed, 0);
+  for(dealNum = 0; dealNum < solver->config.numOfDeals; dealNum ++)
+  {
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE, CFR_DEALT_CARDS);
+    for(player = NUM_INIT; player < CFR_PLAYERS; player ++)
+    {
+      sequences[player] = 0;
+      for(street = NUM_INIT; street < CFR_STREETS; street ++)
+      {
+        strengths[player] = evaluateCardIndices(deck + player *
+          CARDS_PER_HAND, CFR_FIRST_STREET_CARDS + street);
+        sequences[player] = sequences[player] * solver->config.numOfBuckets +
+          strengthBucket(solver, street, strengths[player]);
+      }
+    }
+    outcome = (strengths[0] > strengths[1]) - (strengths[0] < strengths[1]);
+    solver->deals[dealNum] = sequences[0] |
+      (sequences[1] << CFR_SEQUENCE_BITS) |
+      ((uint32_t)(outcome + 1) << (2 * CFR_SEQUENCE_BITS));
+    pair = (size_t)sequences[0] * numOfSequences + sequences[1];
+    solver->weights[pair] += share;
+    solver->outcomes[pair] += share * outcome;
+  }
+}
+
+/*
+  Function to create a solver.
+
+  Input   = {cfrSolver *: solver, cfrConfig *: config}
+  Output  = {bool: success}
+*/
+bool createCfrSolver(cfrSolver * solver, const cfrConfig * config)
+{
+  const int contributions[CFR_PLAYERS] = {CFR_ANTE, CFR_ANTE};
+  uint64_t numOfPrefixes = 1;
+  size_t numOfPairs = 0;
+  int nodeNum = NUM_INIT;
+  int street = NUM_INIT;
+
+  memset(solver, 0, sizeof(cfrSolver));
+  if((config->numOfBuckets < MIN_CFR_BUCKETS) ||
+    (config->numOfBuckets > MAX_CFR_BUCKETS) || (config->numOfDeals < 1) ||
+    (config->numOfDeals > UINT32_MAX) || (config->numOfThreads < 1))
+  {
+    return FALSE;
+  }
+  solver->config = * config;
+  /* Iterations are counted per thread run, and at most MAX_THREADS run */
+  if(solver->config.numOfThreads > MAX_THREADS)
+  {
+    solver->config.numOfThreads = MAX_THREADS;
+  }
+  solver->numOfSequences = 1;
+  for(street = CFR_STREETS - 1; street >= 0; street --)
+  {
+    solver->divisors[street] = solver->numOfSequences;
+    solver->numOfSequences *= config->numOfBuckets;
+  }
+  for(street = NUM_INIT; street < CFR_STREETS; street ++)
+  {
+    if(findThresholds(solver, street) == FALSE)
+    {
+      return FALSE;
+    }
+  }
+  if(buildDecision(solver, 0, 0, 0, contributions) == INVALID_INT)
+  {
+    return FALSE;
+  }
+  for(nodeNum = NUM_INIT; nodeNum < solver->numOfNodes; nodeNum ++)
+  {
+    if(solver->nodes[nodeNum].type == CFR_DECISION_NODE)
+    {
+      numOfPrefixes = solver->numOfSequences /
+        solver->divisors[solver->nodes[nodeNum].street];
+      solver->nodes[nodeNum].firstSlot = solver->numOfSlots;
+      solver->numOfSlots += numOfPrefixes *
+        solver->nodes[nodeNum].numOfActions;
+    }
+  }
+
+  numOfPairs = (size_t)solver->numOfSequences * solver->numOfSequences;
+  solver->regrets = calloc(solver->numOfSlots, sizeof(float));
+  solver->strategySums = calloc(solver->numOfSlots, sizeof(float));
+  solver->deals = malloc(sizeof(uint32_t) * config->numOfDeals);
+  solver->weights = calloc(numOfPairs, sizeof(double));
+  solver->outcomes = calloc(numOfPairs, sizeof(double));
+  if((solver->regrets == NULL) || (solver->strategySums == NULL) ||
+    (solver->deals == NULL) || (solver->weights == NULL) ||
+    (solver->outcomes == NULL))
+  {
+    freeCfrSolver(solver);
+    return FALSE;
+  }
+  dealAbstractGame(solver);
+  return TRUE;
+}
+
+/*
+  Function to free the tables of a solver.
+
+  Input   = {cfrSolver *: solver}
+  Output  = {void: NULL}
+*/
+void freeCfrSolver(cfrSolver * solver)
+{
+  free(solver->regrets);
+  free(solver->strategySums);
+  free(solver->deals);
+  free(solver->weights);
+  free(solver->outcomes);
+  solver->regrets = NULL;
+  solver->strategySums = NULL;
+  solver->deals = NULL;
+  solver->weights = NULL;
+  solver->outcomes = NULL;
+}
+
+/*
+  Function to match regrets: every action in proportion to its positive
+  regret, or all alike when none is positive.
+
+  Input   = {float *: regrets, int: numOfActions, double *: strategy}
+  Output  = {void: NULL}
+*/
+static void matchRegrets(const float * regrets, int numOfActions,
+  double strategy[CFR_MAX_ACTIONS])
+{
+  double total = 0.0;
+  int actionNum = NUM_INIT;
+
+  for(actionNum = NUM_INIT; actionNum < numOfActions; actionNum ++)
+  {
+    strategy[actionNum] = (regrets[actionNum] > 0.0f) ? regrets[actionNum] :
+      0.0;
+    total += strategy[actionNum];
+  }
+  for(actionNum = NUM_INIT; actionNum < numOfActions; actionNum ++)
+  {
+    strategy[actionNum] = (total > 0.0) ? strategy[actionNum] / total :
+      1.0 / numOfActions;
+  }
+}
+
+/*
+  Function to traverse the betting tree for one player over one deal,
+  exploring every action of that player and one sampled action of the
+  other, and return the traverser's sampled value.
+
+  Input   = {cfrSolver *: solver, cfrWorker *: worker, pokerRng *: rng,
+            int: nodeNum, uint32_t: deal, int: traverser, float: weight}
+  Output  = {double: value}
+*/
+static double traverseCfr(const cfrSolver * solver, cfrWorker * worker,
+  pokerRng * rng, int nodeNum, uint32_t deal, int traverser, float weight)
+{
+  const cfrNode * node = & solver->nodes[nodeNum];
+  double strategy[CFR_MAX_ACTIONS];
+  double values[CFR_MAX_ACTIONS];
+  double nodeValue = 0.0;
+  double sample = 0.0;
+  uint32_t slot = 0;
+  int actionNum = NUM_INIT;
+
+  if(node->type == CFR_FOLD_NODE)
+  {
+    return (node->player == traverser) ? -node->contribution :
+      node->contribution;
+  }
+  if(node->type == CFR_SHOWDOWN_NODE)
+  {
+    return node->contribution * dealOutcome(deal) *
+      ((traverser == 0) ? 1 : -1);
+  }
+  slot = node->firstSlot + dealSequence(deal, node->player) /
+    solver->divisors[node->street] * node->numOfActions;
+  matchRegrets(solver->regrets + slot, node->numOfActions, strategy);
+  if(node->player == traverser)
+  {
+    for(actionNum = NUM_INIT; actionNum < node->numOfActions; actionNum ++)
+    {
+      values[actionNum] = traverseCfr(solver, worker, rng,
+        node->children[actionNum], deal, traverser, weight);
+      nodeValue += strategy[actionNum] * values[actionNum];
+    }
+    for(actionNum = NUM_INIT; actionNum < node->numOfActions; actionNum ++)
+    {
+      worker->regretDeltas[slot + actionNum] += values[actionNum] -
+        nodeValue;
+    }
+    return nodeValue;
+  }
+  for(actionNum = NUM_INIT; actionNum < node->numOfActions; actionNum ++)
+  {
+    worker->strategyDeltas[slot + actionNum] += weight * strategy[actionNum];
+  }
+  sample = (nextRandom(rng) >> 11) * 0x1.0p-53;
+  for(actionNum = NUM_INIT; actionNum < node->numOfActions - 1; actionNum ++)
+  {
+    sample -= strategy[actionNum];
+    if(sample < 0.0)
+    {
+      break;
+    }
+  }
+  return traverseCfr(solver, worker, rng, node->children[actionNum], deal,
+    traverser, weight);
+}
+
+/*
+  Function run by every thread of a batch: its share of the iterations on
+  a generator stream of its own for the batch.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void cfrThread(void * contextPTR, int threadNum)
+{
+  cfrContext * context = (cfrContext *)contextPTR;
+  const cfrSolver * solver = context->solver;
+  cfrWorker * worker = & context->workers[threadNum];
+  pokerRng rng;
+  uint32_t deal = 0;
+  int iterationNum = NUM_INIT;
+  int traverser = NUM_INIT;
+
+  seedRng(& rng, solver->config.seed, 1 + solver->batches * MAX_THREADS +
+    threadNum);
+  for(iterationNum = NUM_INIT; iterationNum < CFR_BATCH_ITERATIONS;
+    iterationNum ++)
+  {
+    for(traverser = NUM_INIT; traverser < CFR_PLAYERS; traverser ++)
+    {
+      deal = solver->deals[randomBounded(& rng,
+        (uint32_t)solver->config.numOfDeals)];
+      traverseCfr(solver, worker, & rng, 0, deal, traverser,
+        context->weight);
+    }
+  }
+}
+
+/*
+  Function to run external sampling iterations on the threads.
+
+  Input   = {cfrSolver *: solver, uint64_t: numOfIterations}
+  Output  = {bool: success}
+*/
+bool runCfrIterations(cfrSolver * solver, uint64_t numOfIterations)
+{
+  const int numOfThreads = solver->config.numOfThreads;
+  const uint64_t batchIterations = (uint64_t)numOfThreads *
+    CFR_BATCH_ITERATIONS;
+  cfrContext context;
+  uint64_t done = 0;
+  uint32_t slot = 0;
+  bool success = TRUE;
+  int threadNum = NUM_INIT;
+
+  context.solver = solver;
+  context.workers = calloc(numOfThreads, sizeof(cfrWorker));
+  success = (context.workers != NULL) ? TRUE : FALSE;
+  for(threadNum = NUM_INIT; success == TRUE && threadNum < numOfThreads;
+    threadNum ++)
+  {
+    context.workers[threadNum].regretDeltas = calloc(solver->numOfSlots,
+      sizeof(float));
+    context.workers[threadNum].strategyDeltas = calloc(solver->numOfSlots,
+      sizeof(float));
+    success = (context.workers[threadNum].regretDeltas != NULL) &&
+      (context.workers[threadNum].strategyDeltas != NULL);
+  }
+  for(done = 0; success == TRUE && done < numOfIterations;
+    done += batchIterations)
+  {
+    /* CFR+ weighs the average strategy by the batch it was played in */
+    context.weight = (solver->config.plus == TRUE) ?
+      (float)(solver->batches + 1) : 1.0f;
+    runParallel(numOfThreads, cfrThread, & context);
+    for(threadNum = NUM_INIT; threadNum < numOfThreads; threadNum ++)
+    {
+      for(slot = 0; slot < solver->numOfSlots; slot ++)
+      {
+        solver->regrets[slot] += context.workers[threadNum].regretDeltas[slot];
+        solver->strategySums[slot] +=
+          context.workers[threadNum].strategyDeltas[slot];
+      }
+      memset(context.workers[threadNum].regretDeltas, 0,
+        sizeof(float) * solver->numOfSlots);
+      memset(context.workers[threadNum].strategyDeltas, 0,
+        sizeof(float) * solver->numOfSlots);
+    }
+    for(slot = 0; (solver->config.plus == TRUE) &&
+      (slot < solver->numOfSlots); slot ++)
+    {
+      solver->regrets[slot] = (solver->regrets[slot] > 0.0f) ?
+        solver->regrets[slot] : 0.0f;
+    }
+    solver->batches ++;
+    solver->iterations += batchIterations;
+  }
+  for(threadNum = NUM_INIT; (context.workers != NULL) &&
+    (threadNum < numOfThreads); threadNum ++)
+  {
+    free(context.workers[threadNum].regretDeltas);
+    free(context.workers[threadNum].strategyDeltas);
+  }
+  free(context.workers);
+  return success;
+}
+
+/*
+  Function to find the average strategy of a decision for a bucket prefix.
+
+  Input   = {cfrSolver *: solver, int: nodeNum, int: prefix,
+            double *: probabilities}
+  Output  = {void: NULL}
+*/
+void cfrAverageStrategy(const cfrSolver * solver, int nodeNum, int prefix,
+  double * probabilities)
+{
+  const cfrNode * node = & solver->nodes[nodeNum];
+  const float * sums = solver->strategySums + node->firstSlot +
+    (uint32_t)prefix * node->numOfActions;
+  double total = 0.0;
+  int actionNum = NUM_INIT;
+
+  for(actionNum = NUM_INIT; actionNum < node->numOfActions; actionNum ++)
+  {
+    total += sums[actionNum];
+  }
+  for(actionNum = NUM_INIT; actionNum < node->numOfActions; actionNum ++)
+  {
+    probabilities[actionNum] = (total > 0.0) ? sums[actionNum] / total :
+      1.0 / node->numOfActions;
+  }
+}
+
+/*
+  Function to give the chance weighted value of a terminal to the
+  responder for each of their sequences, against the reach of each of the
+  other player's.
+
+  Input   = {cfrSolver *: solver, cfrNode *: node, int: responder,
+            double *: reach, double *: values}
+  Output  = {void: NULL}
+*/
+static void terminalValues(const cfrSolver * solver, const cfrNode * node,
+  int responder, const double * reach, double * values)
+{
+  const int numOfSequences = solver->numOfSequences;
+  const double * table = (node->type == CFR_FOLD_NODE) ? solver->weights :
+    solver->outcomes;
+  double scale = node->contribution;
+  int sequence = NUM_INIT;
+  int other = NUM_INIT;
+
+  if(node->type == CFR_FOLD_NODE)
+  {
+    scale = (node->player == responder) ? -scale : scale;
+  }
+  else if(responder == 1)
+  {
+    scale = -scale;
+  }
+  memset(values, 0, sizeof(double) * numOfSequences);
+  /* The table is player 0 major, walked in its own order */
+  for(sequence = NUM_INIT; sequence < numOfSequences; sequence ++)
+  {
+    for(other = NUM_INIT; other < numOfSequences; other ++)
+    {
+      if(responder == 0)
+      {
+        values[sequence] += reach[other] *
+          table[(size_t)sequence * numOfSequences + other];
+      }
+      else
+      {
+        values[other] += reach[sequence] *
+          table[(size_t)sequence * numOfSequences + other];
+      }
+    }
+  }
+  for(sequence = NUM_INIT; sequence < numOfSequences; sequence ++)
+  {
+    values[sequence] *= scale;
+  }
+}
+
+/*
+  Function to find the value of every sequence of the responder below a
+  node, against the average strategy of the other player reaching it with
+  each of theirs. The responder plays a best response, choosing one action
+  for all the sequences sharing a prefix, or the average strategy when
+  best is FALSE.
+
+  Input   = {cfrSolver *: solver, responseSpace *: space, int: depth,
+            int: nodeNum, int: responder, bool: best, double *: values}
+  Output  = {void: NULL}
+*/
+static void respondCfr(const cfrSolver * solver, responseSpace * space,
+  int depth, int nodeNum, int responder, bool best, double * values)
+{
+  const cfrNode * node = & solver->nodes[nodeNum];
+  const int numOfSequences = solver->numOfSequences;
+  const double * reach = space->reach[depth];
+  double * childReach = NULL;
+  double probabilities[CFR_MAX_ACTIONS];
+  double totals[CFR_MAX_ACTIONS];
+  int divisor = NUM_INIT;
+  int chosen = NUM_INIT;
+  int prefix = NUM_INIT;
+  int sequence = NUM_INIT;
+  int actionNum = NUM_INIT;
+
+  if(node->type != CFR_DECISION_NODE)
+  {
+    terminalValues(solver, node, responder, reach, values);
+    return;
+  }
+  divisor = solver->divisors[node->street];
+  childReach = space->reach[depth + 1];
+  if(node->player != responder)
+  {
+    memset(values, 0, sizeof(double) * numOfSequences);
+    for(actionNum = NUM_INIT; actionNum < node->numOfActions; actionNum ++)
+    {
+      for(sequence = NUM_INIT; sequence < numOfSequences; sequence ++)
+      {
+        if(sequence % divisor == 0)
+        {
+          cfrAverageStrategy(solver, nodeNum, sequence / divisor,
+            probabilities);
+        }
+        childReach[sequence] = reach[sequence] * probabilities[actionNum];
+      }
+      respondCfr(solver, space, depth + 1, node->children[actionNum],
+        responder, best, space->values[depth][0]);
+      for(sequence = NUM_INIT; sequence < numOfSequences; sequence ++)
+      {
+        values[sequence] += space->values[depth][0][sequence];
+      }
+    }
+    return;
+  }
+
+  memcpy(childReach, reach, sizeof(double) * numOfSequences);
+  for(actionNum = NUM_INIT; actionNum < node->numOfActions; actionNum ++)
+  {
+    respondCfr(solver, space, depth + 1, node->children[actionNum],
+      responder, best, space->values[depth][actionNum]);
+  }
+  /* The sequences of a prefix lie in a row of divisor sequences */
+  for(prefix = NUM_INIT; prefix < numOfSequences / divisor; prefix ++)
+  {
+    memset(totals, 0, sizeof(totals));
+    for(actionNum = NUM_INIT; actionNum < node->numOfActions; actionNum ++)
+    {
+      for(sequence = prefix * divisor; sequence < (prefix + 1) * divisor;
+        sequence ++)
+      {
+        totals[actionNum] += space->values[depth][actionNum][sequence];
+      }
+    }
+    cfrAverageStrategy(solver, nodeNum, prefix, probabilities);
+    chosen = NUM_INIT;
+    for(actionNum = 1; actionNum < node->numOfActions; actionNum ++)
+    {
+      chosen = (totals[actionNum] > totals[chosen]) ? actionNum : chosen;
+    }
+    for(sequence = prefix * divisor; sequence < (prefix + 1) * divisor;
+      sequence ++)
+    {
+      values[sequence] = 0.0;
+      for(actionNum = NUM_INIT; actionNum < node->numOfActions; actionNum ++)
+      {
+        if(best == TRUE)
+        {
+          values[sequence] += (actionNum == chosen) ?
+            space->values[depth][actionNum][sequence] : 0.0;
+        }
+        else
+        {
+          values[sequence] += probabilities[actionNum] *
+            space->values[depth][actionNum][sequence];
+        }
+      }
+    }
+  }
+}
+
+/*
+  Function to find the value of the responder over the whole game.
+
+  Input   = {cfrSolver *: solver, responseSpace *: space, int: responder,
+            bool: best, double *: values}
+  Output  = {double: value}
+*/
+static double responseValue(const cfrSolver * solver, responseSpace * space,
+  int responder, bool best, double * values)
+{
+  double value = 0.0;
+  int sequence = NUM_INIT;
+
+  for(sequence = NUM_INIT; sequence < solver->numOfSequences; sequence ++)
+  {
+    space->reach[0][sequence] = 1.0;
+  }
+  respondCfr(solver, space, 0, 0, responder, best, values);
+  for(sequence = NUM_INIT; sequence < solver->numOfSequences; sequence ++)
+  {
+    value += values[sequence];
+  }
+  return value;
+}
+
+/*
+  Function to measure the exploitability of the average strategy.
+
+  Input   = {cfrSolver *: solver, double *: gameValue}
+  Output  = {double: exploitability}, negative when out of memory
+*/
+double cfrExploitability(const cfrSolver * solver, double * gameValue)
+{
+  const size_t vectorSize = solver->numOfSequences;
+  responseSpace space;
+  double * block = malloc(sizeof(double) * vectorSize *
+    (CFR_MAX_DEPTH * (CFR_MAX_ACTIONS + 1) + 1));
+  double * values = block;
+  double exploitability = 0.0;
+  int depth = NUM_INIT;
+  int actionNum = NUM_INIT;
+
+  if(block == NULL)
+  {
+    return INVALID_INT;
+  }
+  for(depth = NUM_INIT; depth < CFR_MAX_DEPTH; depth ++)
+  {
+    space.reach[depth] = block + vectorSize * (1 + depth *
+      (CFR_MAX_ACTIONS + 1));
+    for(actionNum = NUM_INIT; actionNum < CFR_MAX_ACTIONS; actionNum ++)
+    {
+      space.values[depth][actionNum] = space.reach[depth] + vectorSize *
+        (actionNum + 1);
+    }
+  }
+  exploitability = (responseValue(solver, & space, 0, TRUE, values) +
+    responseValue(solver, & space, 1, TRUE, values)) / CFR_PLAYERS;
+  if(gameValue != NULL)
+  {
+    * gameValue = responseValue(solver, & space, 0, FALSE, values);
+  }
+  free(block);
+  return exploitability;
+}
+
+/*
+  Function to save the tables of a solver.
+
+  Input   = {cfrSolver *: solver, char *: path}
+  Output  = {bool: success}
+*/
+bool saveCfrStrategy(const cfrSolver * solver, const char * path)
+{
+  FILE * output = fopen(path, "wb");
+  cfrHeader header;
+  bool success = FALSE;
+
+  if(output == NULL)
+  {
+    return FALSE;
+  }
+  memset(& header, 0, sizeof(header));
+  memcpy(header.magic, CFR_MAGIC, CFR_MAGIC_SIZE);
+  header.numOfBuckets = solver->config.numOfBuckets;
+  header.numOfSlots = solver->numOfSlots;
+  header.numOfDeals = solver->config.numOfDeals;
+  header.seed = solver->config.seed;
+  header.iterations = solver->iterations;
+  header.batches = solver->batches;
+  header.plus = (solver->config.plus == TRUE);
+  success = ((fwrite(& header, sizeof(header), 1, output) == 1) &&
+    (fwrite(solver->regrets, sizeof(float), solver->numOfSlots, output) ==
+    solver->numOfSlots) && (fwrite(solver->strategySums, sizeof(float),
+    solver->numOfSlots, output) == solver->numOfSlots)) ? TRUE : FALSE;
+  if(fclose(output) != 0)
+  {
+    success = FALSE;
+  }
+  return success;
+}
+
+/*
+  Function to load saved tables into a solver.
+
+  Input   = {cfrSolver *: solver, char *: path}
+  Output  = {bool: success}
+*/
+bool loadCfrStrategy(cfrSolver * solver, const char * path)
+{
+  FILE * input = fopen(path, "rb");
+  cfrHeader header;
+  float * regrets = NULL;
+  float * strategySums = NULL;
+  bool success = FALSE;
+
+  if(input == NULL)
+  {
+    return FALSE;
+  }
+  success = ((fread(& header, sizeof(header), 1, input) == 1) &&
+    (memcmp(header.magic, CFR_MAGIC, CFR_MAGIC_SIZE) == 0) &&
+    (header.numOfBuckets == (uint32_t)solver->config.numOfBuckets) &&
+    (header.numOfSlots == solver->numOfSlots) &&
+    (header.numOfDeals == solver->config.numOfDeals) &&
+    (header.seed == solver->config.seed)) ? TRUE : FALSE;
+  /* Tables are only replaced once the whole file has been read */
+  if(success == TRUE)
+  {
+    regrets = malloc(sizeof(float) * solver->numOfSlots);
+    strategySums = malloc(sizeof(float) * solver->numOfSlots);
+    success = ((regrets != NULL) && (strategySums != NULL) &&
+      (fread(regrets, sizeof(float), solver->numOfSlots, input) ==
+      solver->numOfSlots) && (fread(strategySums, sizeof(float),
+      solver->numOfSlots, input) == solver->numOfSlots)) ? TRUE : FALSE;
+    if(success == TRUE)
+    {
+      memcpy(solver->regrets, regrets, sizeof(float) * solver->numOfSlots);
+      memcpy(solver->strategySums, strategySums,
+        sizeof(float) * solver->numOfSlots);
+      solver->iterations = header.iterations;
+      solver->batches = header.batches;
+    }
+    free(regrets);
+    free(strategySums);
+  }
+  fclose(input);
+  return success;
+}
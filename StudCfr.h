@@ -0,0 +1,242 @@
+#ifndef StudCfr_h
+#define StudCfr_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Hand strengths */
+#include "HandEvaluator.h"
+
+/*
+  stdint.h is included for the table sizes and counts.
+*/
+#include <stdint.h>
+
+/* Magic number starting a saved strategy file */
+#define CFR_MAGIC "PKRCFR01"
+#define CFR_MAGIC_SIZE 8
+/* Betting streets, after the third, fourth and fifth card */
+#define CFR_STREETS 3
+#define CFR_FIRST_STREET_CARDS 3
+/* Chips each player antes, and the fixed bet of every street */
+#define CFR_ANTE 1
+#define CFR_SMALL_BET 1
+#define CFR_BIG_BET 2
+/* Bets and raises allowed on a street */
+#define CFR_MAX_BETS 2
+/* Actions of a decision: fold, check or call, bet or raise */
+#define CFR_MAX_ACTIONS 3
+#define CFR_FOLD 0
+#define CFR_CALL 1
+#define CFR_RAISE 2
+/* Nodes of the betting tree, which holds a few hundred */
+#define MAX_CFR_NODES 1024
+/* Strength buckets of a street */
+#define MIN_CFR_BUCKETS 2
+#define MAX_CFR_BUCKETS 10
+#define DEFAULT_CFR_BUCKETS 8
+/* Deals of the abstract game by default */
+#define DEFAULT_CFR_DEALS 1000000
+/* Iterations each thread runs between merges of the tables */
+#define CFR_BATCH_ITERATIONS 2048
+
+/*
+  CFR node structure, one node of the betting tree. Decision nodes keep
+  their regrets and strategy sums at slots firstSlot + prefix *
+  numOfActions + action, prefix being the acting player's buckets of the
+  streets so far, the first street's the most significant digit.
+
+    type         - CFR_DECISION_NODE, CFR_FOLD_NODE or CFR_SHOWDOWN_NODE
+    player       - player acting, or folding
+    street       - street of the node
+    numOfActions - actions of a decision
+    actions      - CFR_FOLD, CFR_CALL or CFR_RAISE of every action
+    children     - node each action leads to
+    contribution - chips a player has put in: the folder's at a fold, each
+                   player's at a showdown
+    firstSlot    - slot of the first action of bucket prefix 0
+*/
+typedef struct cfrNode
+{
+  unsigned char type;
+  unsigned char player;
+  unsigned char street;
+  unsigned char numOfActions;
+  unsigned char actions[CFR_MAX_ACTIONS];
+  int children[CFR_MAX_ACTIONS];
+  int contribution;
+  uint32_t firstSlot;
+} cfrNode;
+
+/* Types of the betting tree nodes */
+#define CFR_DECISION_NODE 0
+#define CFR_FOLD_NODE 1
+#define CFR_SHOWDOWN_NODE 2
+
+/*
+  CFR configuration structure
+
+    numOfBuckets - strength buckets of every street
+    numOfDeals   - deals sampled once to make the abstract game
+    seed         - seed of the deals and of the sampled iterations
+    numOfThreads - threads running iterations, at most MAX_THREADS
+    plus         - TRUE for CFR+: regrets floored at zero and the average
+                   strategy weighted by batch
+*/
+typedef struct cfrConfig
+{
+  int numOfBuckets;
+  uint64_t numOfDeals;
+  uint64_t seed;
+  int numOfThreads;
+  bool plus;
+} cfrConfig;
+
+/*
+  CFR solver structure
+
+  The abstract game deals each of two players five cards, the first three
+  at once, and bets after the third, fourth and fifth card. A player sees
+  only the bucket of the strength of their own cards on every street, the
+  percentile of evaluateCardIndices among all hands of as many cards, so
+  the game has perfect recall. Chance picks one of numOfDeals fixed deals,
+  which makes the game finite and its exploitability exact.
+
+    config         - configuration
+    numOfSequences - bucket sequences of a player, numOfBuckets to the
+                     power CFR_STREETS
+    divisors       - what a sequence is divided by for its prefix up to a
+                     street
+    thresholds     - least strength of every bucket above the first, by
+                     street
+    numOfNodes     - nodes of the betting tree, the root first
+    nodes          - betting tree
+    numOfSlots     - regrets and strategy sums
+    regrets        - cumulative regret of every slot
+    strategySums   - cumulative strategy of every slot
+    deals          - bucket sequences and showdown of every deal: player 0's
+                     sequence, player 1's above CFR_SEQUENCE_BITS and the
+                     outcome for player 0 plus one above twice that
+    weights        - chance of each pair of sequences, player 0's major
+    outcomes       - chance of each pair times player 0's showdown outcome
+    iterations     - iterations run, each traversing once for each player
+    batches        - batches run
+*/
+typedef struct cfrSolver
+{
+  cfrConfig config;
+  int numOfSequences;
+  int divisors[CFR_STREETS];
+  handStrength thresholds[CFR_STREETS][MAX_CFR_BUCKETS - 1];
+  int numOfNodes;
+  cfrNode nodes[MAX_CFR_NODES];
+  uint32_t numOfSlots;
+  float * regrets;
+  float * strategySums;
+  uint32_t * deals;
+  double * weights;
+  double * outcomes;
+  uint64_t iterations;
+  uint64_t batches;
+} cfrSolver;
+
+/* Bits of a bucket sequence in a packed deal */
+#define CFR_SEQUENCE_BITS 12
+
+/*
+  CFR header structure, at the start of a saved strategy file, followed by
+  the regrets then the strategy sums as floats. Numbers are stored in the
+  byte order of the machine.
+
+    magic        - CFR_MAGIC
+    numOfBuckets - buckets of the solver saved
+    numOfSlots   - slots of each table
+    numOfDeals   - deals of the abstract game
+    seed         - seed of the deals
+    iterations   - iterations run
+    batches      - batches run
+    plus         - one for CFR+
+*/
+typedef struct cfrHeader
+{
+  char magic[CFR_MAGIC_SIZE];
+  uint32_t numOfBuckets;
+  uint32_t numOfSlots;
+  uint64_t numOfDeals;
+  uint64_t seed;
+  uint64_t iterations;
+  uint64_t batches;
+  uint32_t plus;
+  uint32_t reserved;
+} cfrHeader;
+
+/*
+  Function to create a solver: the bucket thresholds from every hand of
+  three, four and five cards, the betting tree, the deals of the abstract
+  game and zeroed tables.
+
+  Input   = {cfrSolver *: solver, cfrConfig *: config}
+  Output  = {bool: success}, FALSE for a bad configuration or too little
+            memory
+*/
+bool createCfrSolver(cfrSolver *, const cfrConfig *);
+
+/*
+  Function to free the tables of a solver.
+
+  Input   = {cfrSolver *: solver}
+  Output  = {void: NULL}
+*/
+void freeCfrSolver(cfrSolver *);
+
+/*
+  Function to run external sampling iterations on the threads. Each thread
+  runs its share of a batch against the tables as they were at the start of
+  the batch, on its own generator stream, adding into its own copies of the
+  tables, and the copies are merged in thread order at the end of the
+  batch. Iterations are rounded up to whole batches.
+
+  Input   = {cfrSolver *: solver, uint64_t: numOfIterations}
+  Output  = {bool: success}, FALSE when out of memory
+*/
+bool runCfrIterations(cfrSolver *, uint64_t);
+
+/*
+  Function to find the average strategy of a decision for a bucket prefix.
+
+  Input   = {cfrSolver *: solver, int: nodeNum, int: prefix,
+            double *: probabilities}
+  Output  = {void: NULL}
+*/
+void cfrAverageStrategy(const cfrSolver *, int, int, double *);
+
+/*
+  Function to measure the exploitability of the average strategy in chips
+  a hand: the mean of what a best response gains as each player against
+  it. The best responses are exact, found over every bucket sequence of the
+  abstract game at once.
+
+  Input   = {cfrSolver *: solver, double *: gameValue}
+  Output  = {double: exploitability}, the value of the average strategy to
+            player 0 in gameValue unless it is NULL
+*/
+double cfrExploitability(const cfrSolver *, double *);
+
+/*
+  Function to save the tables of a solver.
+
+  Input   = {cfrSolver *: solver, char *: path}
+  Output  = {bool: success}
+*/
+bool saveCfrStrategy(const cfrSolver *, const char *);
+
+/*
+  Function to load saved tables into a solver created with the same
+  buckets, deals and seed.
+
+  Input   = {cfrSolver *: solver, char *: path}
+  Output  = {bool: success}, FALSE when the file cannot be read or was
+            saved by a different solver
+*/
+bool loadCfrStrategy(cfrSolver *, const char *);
+
+#endif /* StudCfr_h */
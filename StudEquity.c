@@ -0,0 +1,905 @@
+#include "StudEquity.h"
+/* Binomial coefficients and combination unranking */
+#include "Combinatorics.h"
+/* Worker threads */
+#include "PokerThreads.h"
+
+/* string.h is included for memset. */
+#include <string.h>
+/* stdatomic.h is included for the chunk counter and the shared totals. */
+#include <stdatomic.h>
+/* time.h is included for nanosleep, the checkpoint thread's wait. */
+#include <time.h>
+
+/* Bounds on the number of completions handed out at a time */
+#define MIN_CHUNK_SIZE 256
+#define MAX_CHUNK_SIZE 65536
+#define CHUNKS_PER_THREAD 64
+/* Threads the chunks of a checkpointed enumeration are sized for, so that a
+   run can resume on any number of threads */
+#define CHECKPOINT_CHUNK_THREADS 64
+/* Tag of the checkpoints and shards of enumerations */
+#define EQUITY_CHECKPOINT_TAG 0x4551554954494553ULL
+/* Longest single wait of the checkpoint thread */
+#define CHECKPOINT_POLL_SECONDS 0.01
+
+/* Totals of the completions a thread has evaluated */
+typedef struct equityTotals
+{
+  uint64_t evaluated;
+  uint64_t wins[MAX_PLAYERS];
+  uint64_t ties[MAX_PLAYERS];
+  uint64_t equityUnits[MAX_PLAYERS];
+} equityTotals;
+
+/* Results saved in a shard file, the board they belong to and its totals */
+typedef struct equityShard
+{
+  studBoard board;
+  equityTotals totals;
+} equityShard;
+
+/*
+  Tallies of one thread, padded so threads never share a cache line. When
+  checkpointing, the thread copies its totals and progress to the published
+  copies after each chunk under a sequence lock, as the simulation does.
+*/
+typedef struct equityTally
+{
+  equityTotals totals;
+  checkpointProgress progress;
+  char padding[CACHE_LINE_SIZE];
+  atomic_uint sequence;
+  equityTotals published;
+  checkpointProgress publishedProgress;
+  char publishedPadding[CACHE_LINE_SIZE];
+} equityTally;
+
+/* State shared by the enumerating threads */
+typedef struct equityContext
+{
+  const studBoard * board;
+  unsigned char pool[STD_DECK_SIZE];
+  int poolSize;
+  int numUnknown[MAX_PLAYERS];
+  uint64_t radix[MAX_PLAYERS];
+  uint64_t rangeFirst;
+  uint64_t completions;
+  uint64_t chunkSize;
+  uint64_t numOfChunks;
+  uint64_t chunkStride;
+  double tolerance;
+  atomic_ullong nextChunk;
+  atomic_ullong sharedEvaluated;
+  atomic_ullong sharedUnits[MAX_PLAYERS];
+  atomic_int stop;
+  int numOfWorkers;
+  atomic_int finishedWorkers;
+  const checkpointConfig * checkpoint;
+  checkpointState * resumed;
+  equityTotals resumedTotals;
+  checkpointState * combined;
+  checkpointProgress progressCopies[MAX_THREADS];
+  equityTally tallies[MAX_THREADS];
+} equityContext;
+
+/*
+  Enumeration state of one thread. Player p draws its unknown cards from its
+  own pool, the deck pool less the cards drawn by the players before it, so a
+  completion is one combination per player.
+*/
+typedef struct completionCursor
+{
+  unsigned char pools[MAX_PLAYERS][STD_DECK_SIZE];
+  int poolSizes[MAX_PLAYERS];
+  unsigned char positions[MAX_PLAYERS][CARDS_PER_HAND];
+  unsigned char hands[MAX_PLAYERS][CARDS_PER_HAND];
+} completionCursor;
+
+/* Greatest common divisor, used to pick a chunk stride */
+static uint64_t greatestCommonDivisor(uint64_t first, uint64_t second)
+{
+  uint64_t remainder = 0;
+  while(second != 0)
+  {
+    remainder = first % second;
+    first = second;
+    second = remainder;
+  }
+  return first;
+}
+
+/*
+  Function to count the completions of a board.
+
+  Input   = {studBoard *: board, uint64_t *: completions}
+  Output  = {bool: success}
+*/
+bool countCompletions(const studBoard * board, uint64_t * completions)
+{
+  bool used[STD_DECK_SIZE];
+  int poolSize = STD_DECK_SIZE;
+  int playrNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+  int unknown = NUM_INIT;
+
+  if((board->numOfPlayers < MIN_PLAYERS) ||
+    (board->numOfPlayers > MAX_PLAYERS) || (board->numDead < 0) ||
+    (board->numDead > STD_DECK_SIZE))
+  {
+    return FALSE;
+  }
+  memset(used, 0, sizeof(used));
+  /* Every known card has to be a real card and appear only once */
+  for(playrNum = NUM_INIT; playrNum < board->numOfPlayers; playrNum ++)
+  {
+    if((board->numKnown[playrNum] < 0) ||
+      (board->numKnown[playrNum] > CARDS_PER_HAND))
+    {
+      return FALSE;
+    }
+    for(cardNum = NUM_INIT; cardNum < board->numKnown[playrNum]; cardNum ++)
+    {
+      if((board->known[playrNum][cardNum] >= STD_DECK_SIZE) ||
+        used[board->known[playrNum][cardNum]])
+      {
+        return FALSE;
+      }
+      used[board->known[playrNum][cardNum]] = TRUE;
+      poolSize --;
+    }
+  }
+  for(cardNum = NUM_INIT; cardNum < board->numDead; cardNum ++)
+  {
+    if((board->dead[cardNum] >= STD_DECK_SIZE) || used[board->dead[cardNum]])
+    {
+      return FALSE;
+    }
+    used[board->dead[cardNum]] = TRUE;
+    poolSize --;
+  }
+
+  * completions = 1;
+  for(playrNum = NUM_INIT; playrNum < board->numOfPlayers; playrNum ++)
+  {
+    unknown = CARDS_PER_HAND - board->numKnown[playrNum];
+    if((unknown > poolSize) ||
+      (multiplyCounts(* completions, choose(poolSize, unknown), completions)
+      == FALSE))
+    {
+      return FALSE;
+    }
+    poolSize -= unknown;
+  }
+  return TRUE;
+}
+
+/* Rebuild the pools and hands of every player from a given player on */
+static void refreshPlayers(const equityContext * context,
+  completionCursor * cursor, int firstPlayer)
+{
+  const studBoard * board = context->board;
+  bool taken[STD_DECK_SIZE];
+  int playrNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+  int poolNum = NUM_INIT;
+  int kept = NUM_INIT;
+  const unsigned char * pool = NULL;
+
+  for(playrNum = firstPlayer; playrNum < board->numOfPlayers; playrNum ++)
+  {
+    pool = cursor->pools[playrNum];
+    for(cardNum = NUM_INIT; cardNum < context->numUnknown[playrNum];
+      cardNum ++)
+    {
+      cursor->hands[playrNum][board->numKnown[playrNum] + cardNum] =
+        pool[cursor->positions[playrNum][cardNum]];
+    }
+    if(playrNum + 1 == board->numOfPlayers)
+    {
+      break;
+    }
+    /* The next player's pool loses the cards this player drew */
+    memset(taken, 0, cursor->poolSizes[playrNum] * sizeof(bool));
+    for(cardNum = NUM_INIT; cardNum < context->numUnknown[playrNum];
+      cardNum ++)
+    {
+      taken[cursor->positions[playrNum][cardNum]] = TRUE;
+    }
+    kept = NUM_INIT;
+    for(poolNum = NUM_INIT; poolNum < cursor->poolSizes[playrNum]; poolNum ++)
+    {
+      if(taken[poolNum] == FALSE)
+      {
+        cursor->pools[playrNum + 1][kept ++] = pool[poolNum];
+      }
+    }
+    cursor->poolSizes[playrNum + 1] = kept;
+  }
+}
+
+/* Place a cursor on a completion index by unranking one combination each */
+static void seekCompletion(const equityContext * context,
+  completionCursor * cursor, uint64_t index)
+{
+  const studBoard * board = context->board;
+  int playrNum = NUM_INIT;
+
+  for(playrNum = board->numOfPlayers - 1; playrNum >= 0; playrNum --)
+  {
+    unrankCombination(index % context->radix[playrNum],
+      context->numUnknown[playrNum], cursor->positions[playrNum]);
+    index /= context->radix[playrNum];
+  }
+  for(playrNum = NUM_INIT; playrNum < board->numOfPlayers; playrNum ++)
+  {
+    memcpy(cursor->hands[playrNum], board->known[playrNum],
+      board->numKnown[playrNum]);
+  }
+  memcpy(cursor->pools[0], context->pool, context->poolSize);
+  cursor->poolSizes[0] = context->poolSize;
+  refreshPlayers(context, cursor, 0);
+}
+
+/*
+  Step a cursor to the next completion index. The last player changes
+  fastest, like the lowest digit of a counter.
+*/
+static void stepCompletion(const equityContext * context,
+  completionCursor * cursor)
+{
+  int playrNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+  int unknown = NUM_INIT;
+
+  for(playrNum = context->board->numOfPlayers - 1; playrNum >= 0; playrNum --)
+  {
+    unknown = context->numUnknown[playrNum];
+    if(unknown == 0)
+    {
+      continue;
+    }
+    if(nextCombination(cursor->positions[playrNum], unknown,
+      cursor->poolSizes[playrNum]) == TRUE)
+    {
+      refreshPlayers(context, cursor, playrNum);
+      return;
+    }
+    for(cardNum = NUM_INIT; cardNum < unknown; cardNum ++)
+    {
+      cursor->positions[playrNum][cardNum] = cardNum;
+    }
+  }
+  refreshPlayers(context, cursor, 0);
+}
+
+/*
+  Decide whether the completions left can still reorder the players by more
+  than the tolerance. The evaluated count is read before the equities, so
+  the bounds are only ever too wide.
+*/
+static bool rankingSettled(equityContext * context)
+{
+  const int numOfPlayers = context->board->numOfPlayers;
+  uint64_t units[MAX_PLAYERS];
+  uint64_t evaluated = atomic_load(& context->sharedEvaluated);
+  double total = (double)context->completions * EQUITY_UNITS;
+  double remaining = (double)(context->completions - evaluated) *
+    EQUITY_UNITS;
+  int first = NUM_INIT;
+  int second = NUM_INIT;
+
+  for(first = NUM_INIT; first < numOfPlayers; first ++)
+  {
+    units[first] = atomic_load(& context->sharedUnits[first]);
+  }
+  for(first = NUM_INIT; first < numOfPlayers; first ++)
+  {
+    for(second = NUM_INIT; second < numOfPlayers; second ++)
+    {
+      /* The player ahead has to stay ahead of the best the other can do */
+      if((first != second) && (units[first] >= units[second]) &&
+        ((double)units[first] / total + context->tolerance <
+        ((double)units[second] + remaining) / total))
+      {
+        return FALSE;
+      }
+    }
+  }
+  return TRUE;
+}
+
+/* Copy a thread's totals and progress where the checkpoint thread reads them */
+static void publishTally(equityTally * tally)
+{
+  unsigned int sequence = atomic_load_explicit(& tally->sequence,
+    memory_order_relaxed);
+  atomic_store_explicit(& tally->sequence, sequence + 1,
+    memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  memcpy(& tally->published, & tally->totals, sizeof(equityTotals));
+  memcpy(& tally->publishedProgress, & tally->progress,
+    sizeof(checkpointProgress));
+  atomic_store_explicit(& tally->sequence, sequence + 2,
+    memory_order_release);
+}
+
+/* Read a consistent copy of a thread's published totals and progress */
+static void readPublishedTally(equityTally * tally, equityTotals * totals,
+  checkpointProgress * progress)
+{
+  unsigned int before = 0;
+  unsigned int after = 0;
+  do
+  {
+    before = atomic_load_explicit(& tally->sequence, memory_order_acquire);
+    memcpy(totals, & tally->published, sizeof(equityTotals));
+    memcpy(progress, & tally->publishedProgress, sizeof(checkpointProgress));
+    atomic_thread_fence(memory_order_acquire);
+    after = atomic_load_explicit(& tally->sequence, memory_order_relaxed);
+  } while(((before & 1) != 0) || (before != after));
+}
+
+/* Add one set of totals to another */
+static void addTotals(equityTotals * sum, const equityTotals * totals)
+{
+  int playrNum = NUM_INIT;
+  sum->evaluated += totals->evaluated;
+  for(playrNum = NUM_INIT; playrNum < MAX_PLAYERS; playrNum ++)
+  {
+    sum->wins[playrNum] += totals->wins[playrNum];
+    sum->ties[playrNum] += totals->ties[playrNum];
+    sum->equityUnits[playrNum] += totals->equityUnits[playrNum];
+  }
+}
+
+/*
+  Checkpoint thread body, saving the totals of the chunks done so far every
+  interval until the workers finish.
+*/
+static void checkpointLoop(equityContext * context)
+{
+  const checkpointConfig * checkpoint = context->checkpoint;
+  struct timespec pause;
+  equityTotals merged;
+  equityTotals copy;
+  double waited = 0.0;
+  int threadNum = NUM_INIT;
+
+  pause.tv_sec = 0;
+  pause.tv_nsec = (long)(CHECKPOINT_POLL_SECONDS * 1e9);
+  while(atomic_load(& context->finishedWorkers) < context->numOfWorkers)
+  {
+    nanosleep(& pause, NULL);
+    waited += CHECKPOINT_POLL_SECONDS;
+    if(waited < checkpoint->seconds)
+    {
+      continue;
+    }
+    waited = 0.0;
+    memcpy(& merged, & context->resumedTotals, sizeof(equityTotals));
+    for(threadNum = NUM_INIT; threadNum < context->numOfWorkers; threadNum ++)
+    {
+      readPublishedTally(& context->tallies[threadNum], & copy,
+        & context->progressCopies[threadNum]);
+      addTotals(& merged, & copy);
+    }
+    if(combineProgress(context->combined, context->resumed,
+      context->progressCopies, context->numOfWorkers) == TRUE)
+    {
+      writeCheckpoint(checkpoint->path, context->combined, & merged,
+        sizeof(equityTotals));
+    }
+  }
+}
+
+/* Take the next chunk ticket not already held by the resumed checkpoint */
+static uint64_t takeTicket(equityContext * context)
+{
+  uint64_t ticket = 0;
+  do
+  {
+    ticket = atomic_fetch_add(& context->nextChunk, 1);
+  } while((ticket < context->numOfChunks) && (context->resumed != NULL) &&
+    (ticketDone(context->resumed, ticket) == TRUE));
+  return (ticket < context->numOfChunks) ? ticket : context->numOfChunks;
+}
+
+/*
+  Thread body, evaluates chunks of completions until none are left. With a
+  checkpoint the thread after the workers saves the checkpoints.
+*/
+static void equityWorker(void * contextPTR, int threadNum)
+{
+  equityContext * context = contextPTR;
+  equityTally * tally = & context->tallies[threadNum];
+  equityTotals * totals = & tally->totals;
+  const int numOfPlayers = context->board->numOfPlayers;
+  completionCursor cursor;
+  handStrength strengths[MAX_PLAYERS];
+  uint64_t chunkUnits[MAX_PLAYERS];
+  uint64_t ticket = 0;
+  uint64_t chunkNum = 0;
+  uint64_t first = 0;
+  uint64_t last = 0;
+  uint64_t index = 0;
+  unsigned int winners = 0;
+  unsigned int share = 0;
+  int playrNum = NUM_INIT;
+
+  if(threadNum >= context->numOfWorkers)
+  {
+    checkpointLoop(context);
+    return;
+  }
+  clearProgress(& tally->progress);
+  while((atomic_load(& context->stop) == 0) &&
+    ((ticket = takeTicket(context)) < context->numOfChunks))
+  {
+    /* Striding over the chunks spreads early results over the whole space */
+    chunkNum = (ticket * context->chunkStride) % context->numOfChunks;
+    first = context->rangeFirst + chunkNum * context->chunkSize;
+    last = first + context->chunkSize;
+    if(last > context->rangeFirst + context->completions)
+    {
+      last = context->rangeFirst + context->completions;
+    }
+    memset(chunkUnits, 0, sizeof(chunkUnits));
+    seekCompletion(context, & cursor, first);
+    for(index = first; index < last; index ++)
+    {
+      for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+      {
+        strengths[playrNum] = evaluateCardIndices(cursor.hands[playrNum],
+          CARDS_PER_HAND);
+      }
+      winners = findWinners(strengths, numOfPlayers);
+      share = EQUITY_UNITS / __builtin_popcount(winners);
+      for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+      {
+        if((winners >> playrNum) & 1u)
+        {
+          chunkUnits[playrNum] += share;
+          if(share == EQUITY_UNITS)
+          {
+            totals->wins[playrNum] ++;
+          }
+          else
+          {
+            totals->ties[playrNum] ++;
+          }
+        }
+      }
+      if(index + 1 < last)
+      {
+        stepCompletion(context, & cursor);
+      }
+    }
+    totals->evaluated += last - first;
+    for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+    {
+      totals->equityUnits[playrNum] += chunkUnits[playrNum];
+    }
+
+    if(context->checkpoint != NULL)
+    {
+      /* Every later ticket of this thread is above the one it takes next,
+         which is all the published copy needs to promise */
+      recordTicket(& tally->progress, ticket);
+      tally->progress.inFlight = atomic_load(& context->nextChunk);
+      publishTally(tally);
+    }
+    if(context->tolerance >= 0.0)
+    {
+      /* Publish the chunk, equities before the count they belong to */
+      for(playrNum = NUM_INIT; playrNum < numOfPlayers; playrNum ++)
+      {
+        atomic_fetch_add(& context->sharedUnits[playrNum],
+          chunkUnits[playrNum]);
+      }
+      atomic_fetch_add(& context->sharedEvaluated, last - first);
+      if(rankingSettled(context) == TRUE)
+      {
+        atomic_store(& context->stop, 1);
+      }
+    }
+  }
+  if(context->checkpoint != NULL)
+  {
+    tally->progress.inFlight = context->numOfChunks;
+    publishTally(tally);
+  }
+  atomic_fetch_add(& context->finishedWorkers, 1);
+}
+
+/*
+  Function to list the cards of the deck that are neither known nor dead.
+
+  Input   = {studBoard *: board, unsigned char *: pool}
+  Output  = {int: poolSize}
+*/
+static int fillPool(const studBoard * board, unsigned char * pool)
+{
+  bool used[STD_DECK_SIZE];
+  int poolSize = NUM_INIT;
+  int playrNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  memset(used, 0, sizeof(used));
+  for(playrNum = NUM_INIT; playrNum < board->numOfPlayers; playrNum ++)
+  {
+    for(cardNum = NUM_INIT; cardNum < board->numKnown[playrNum]; cardNum ++)
+    {
+      used[board->known[playrNum][cardNum]] = TRUE;
+    }
+  }
+  for(cardNum = NUM_INIT; cardNum < board->numDead; cardNum ++)
+  {
+    used[board->dead[cardNum]] = TRUE;
+  }
+  for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    if(used[cardNum] == FALSE)
+    {
+      pool[poolSize ++] = cardNum;
+    }
+  }
+  return poolSize;
+}
+
+/*
+  Function to hash everything the completions of a board and their order
+  depend on, the key of its checkpoints and shards.
+
+  Input   = {studBoard *: board}
+  Output  = {uint64_t: key}
+*/
+static uint64_t boardKey(const studBoard * board)
+{
+  unsigned char pool[STD_DECK_SIZE];
+  uint64_t key = EQUITY_CHECKPOINT_TAG;
+  int poolSize = fillPool(board, pool);
+  int playrNum = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  key = mixCheckpointKey(key, board->numOfPlayers);
+  for(playrNum = NUM_INIT; playrNum < board->numOfPlayers; playrNum ++)
+  {
+    key = mixCheckpointKey(key, board->numKnown[playrNum]);
+    for(cardNum = NUM_INIT; cardNum < board->numKnown[playrNum]; cardNum ++)
+    {
+      key = mixCheckpointKey(key, board->known[playrNum][cardNum]);
+    }
+  }
+  for(cardNum = NUM_INIT; cardNum < poolSize; cardNum ++)
+  {
+    key = mixCheckpointKey(key, pool[cardNum]);
+  }
+  return key;
+}
+
+/*
+  Function to turn the totals of an enumeration into its result.
+
+  Input   = {studBoard *: board, equityTotals *: totals,
+            uint64_t: completions, studEquity *: result}
+  Output  = {void: NULL}
+*/
+static void finishEquity(const studBoard * board, const equityTotals * totals,
+  uint64_t completions, studEquity * result)
+{
+  double total = (double)completions * EQUITY_UNITS;
+  int playrNum = NUM_INIT;
+
+  memset(result, 0, sizeof(* result));
+  result->completions = completions;
+  result->evaluated = totals->evaluated;
+  for(playrNum = NUM_INIT; playrNum < board->numOfPlayers; playrNum ++)
+  {
+    result->wins[playrNum] = totals->wins[playrNum];
+    result->ties[playrNum] = totals->ties[playrNum];
+    result->equityUnits[playrNum] = totals->equityUnits[playrNum];
+  }
+  result->exact = (result->evaluated == result->completions) ? TRUE : FALSE;
+  for(playrNum = NUM_INIT; playrNum < board->numOfPlayers; playrNum ++)
+  {
+    if(result->evaluated > 0)
+    {
+      result->equity[playrNum] = (double)result->equityUnits[playrNum] /
+        ((double)result->evaluated * EQUITY_UNITS);
+    }
+    result->equityLow[playrNum] = (double)result->equityUnits[playrNum] /
+      total;
+    result->equityHigh[playrNum] = ((double)result->equityUnits[playrNum] +
+      (double)(result->completions - result->evaluated) * EQUITY_UNITS) /
+      total;
+  }
+}
+
+/*
+  Function to enumerate the completions of a board, or of one shard of
+  them, optionally saving and resuming checkpoints of the chunks done. The
+  result of a shard counts the completions of the shard alone.
+
+  Input   = {studBoard *: board, double: tolerance, int: numOfThreads,
+            shardHeader *: shard, checkpointConfig *: checkpoint,
+            equityTotals *: totals, studEquity *: result}
+  Output  = {bool: success}
+*/
+static bool enumerateEquity(const studBoard * board, double tolerance,
+  int numOfThreads, const shardHeader * shard,
+  const checkpointConfig * checkpoint, equityTotals * totals,
+  studEquity * result)
+{
+  equityContext * context = NULL;
+  uint64_t completions = 0;
+  uint64_t remaining = 0;
+  uint64_t key = 0;
+  int playrNum = NUM_INIT;
+  int threadNum = NUM_INIT;
+  bool success = TRUE;
+
+  memset(result, 0, sizeof(* result));
+  if(countCompletions(board, & completions) == FALSE)
+  {
+    return FALSE;
+  }
+  context = calloc(1, sizeof(* context));
+  if(context == NULL)
+  {
+    return FALSE;
+  }
+  context->board = board;
+  context->completions = completions;
+  if(shard != NULL)
+  {
+    context->rangeFirst = shard->first;
+    context->completions = shard->last - shard->first;
+  }
+  context->tolerance = tolerance;
+  context->checkpoint = checkpoint;
+
+  /* The pool is every card that is neither known nor dead */
+  context->poolSize = fillPool(board, context->pool);
+  remaining = context->poolSize;
+  for(playrNum = NUM_INIT; playrNum < board->numOfPlayers; playrNum ++)
+  {
+    context->numUnknown[playrNum] = CARDS_PER_HAND - board->numKnown[playrNum];
+    context->radix[playrNum] = choose(remaining,
+      context->numUnknown[playrNum]);
+    remaining -= context->numUnknown[playrNum];
+  }
+
+  if(numOfThreads < 1)
+  {
+    numOfThreads = defaultThreadCount();
+  }
+  /* The tallies hold MAX_THREADS workers, and a checkpointing run keeps one
+     thread for the checkpoints */
+  if(numOfThreads > ((checkpoint != NULL) ? MAX_THREADS - 1 : MAX_THREADS))
+  {
+    numOfThreads = (checkpoint != NULL) ? MAX_THREADS - 1 : MAX_THREADS;
+  }
+  context->chunkSize = context->completions / ((uint64_t)((checkpoint != NULL)
+    ? CHECKPOINT_CHUNK_THREADS : numOfThreads) * CHUNKS_PER_THREAD);
+  if(context->chunkSize < MIN_CHUNK_SIZE)
+  {
+    context->chunkSize = MIN_CHUNK_SIZE;
+  }
+  if(context->chunkSize > MAX_CHUNK_SIZE)
+  {
+    context->chunkSize = MAX_CHUNK_SIZE;
+  }
+  context->numOfChunks = (context->completions + context->chunkSize - 1) /
+    context->chunkSize;
+  /* Any stride coprime to the number of chunks visits every chunk once */
+  context->chunkStride = (context->numOfChunks * 5) / 8 + 1;
+  while(greatestCommonDivisor(context->chunkStride, context->numOfChunks) != 1)
+  {
+    context->chunkStride ++;
+  }
+  atomic_init(& context->nextChunk, 0);
+  atomic_init(& context->sharedEvaluated, 0);
+  atomic_init(& context->stop, 0);
+  atomic_init(& context->finishedWorkers, 0);
+  for(playrNum = NUM_INIT; playrNum < MAX_PLAYERS; playrNum ++)
+  {
+    atomic_init(& context->sharedUnits[playrNum], 0);
+  }
+  for(threadNum = NUM_INIT; threadNum < MAX_THREADS; threadNum ++)
+  {
+    atomic_init(& context->tallies[threadNum].sequence, 0);
+  }
+  context->numOfWorkers = numOfThreads;
+
+  if(checkpoint != NULL)
+  {
+    /* Everything the chunks and their totals depend on goes in the key */
+    key = boardKey(board);
+    if(shard != NULL)
+    {
+      key = mixCheckpointKey(key, shard->first);
+      key = mixCheckpointKey(key, shard->last);
+    }
+    key = mixCheckpointKey(key, context->chunkSize);
+    key = mixCheckpointKey(key, context->chunkStride);
+    key = mixCheckpointKey(key, sizeof(equityTotals));
+    context->resumed = malloc(sizeof(checkpointState));
+    context->combined = malloc(sizeof(checkpointState));
+    success = ((context->resumed != NULL) && (context->combined != NULL)) ?
+      TRUE : FALSE;
+    if(success == TRUE)
+    {
+      clearCheckpoint(context->resumed, key, context->numOfChunks);
+      if(checkpoint->resume == TRUE)
+      {
+        success = readCheckpoint(checkpoint->path, context->resumed,
+          & context->resumedTotals, sizeof(equityTotals));
+      }
+    }
+  }
+
+  if(success == TRUE)
+  {
+    numOfThreads = runParallel((checkpoint != NULL) ? numOfThreads + 1 :
+      numOfThreads, equityWorker, context) - ((checkpoint != NULL) ? 1 : 0);
+    memcpy(totals, & context->resumedTotals, sizeof(equityTotals));
+    for(threadNum = NUM_INIT; threadNum < numOfThreads; threadNum ++)
+    {
+      addTotals(totals, & context->tallies[threadNum].totals);
+    }
+  }
+  if((success == TRUE) && (checkpoint != NULL))
+  {
+    /* The last checkpoint holds every chunk */
+    clearCheckpoint(context->combined, key, context->numOfChunks);
+    context->combined->watermark = context->numOfChunks;
+    success = writeCheckpoint(checkpoint->path, context->combined, totals,
+      sizeof(equityTotals));
+  }
+  completions = context->completions;
+  free(context->resumed);
+  free(context->combined);
+  free(context);
+  if(success == FALSE)
+  {
+    return FALSE;
+  }
+  finishEquity(board, totals, completions, result);
+  return TRUE;
+}
+
+/*
+  Function to compute the equity of every player by evaluating every
+  completion of the board.
+
+  Input   = {studBoard *: board, double: tolerance, int: numOfThreads,
+            studEquity *: result}
+  Output  = {bool: success}
+*/
+bool computeStudEquity(const studBoard * board, double tolerance,
+  int numOfThreads, studEquity * result)
+{
+  equityTotals totals;
+  return enumerateEquity(board, tolerance, numOfThreads, NULL, NULL,
+    & totals, result);
+}
+
+/*
+  Function to compute the exact equity of every player with checkpoints.
+
+  Input   = {studBoard *: board, int: numOfThreads,
+            checkpointConfig *: checkpoint, studEquity *: result}
+  Output  = {bool: success}
+*/
+bool checkpointStudEquity(const studBoard * board, int numOfThreads,
+  const checkpointConfig * checkpoint, studEquity * result)
+{
+  equityTotals totals;
+  return enumerateEquity(board, NO_EARLY_EXIT, numOfThreads, NULL,
+    checkpoint, & totals, result);
+}
+
+/*
+  Function to enumerate one shard of the completions of a board and write
+  its totals to a shard file.
+
+  Input   = {studBoard *: board, uint64_t: shardNum, uint64_t: numOfShards,
+            int: numOfThreads, checkpointConfig *: checkpoint,
+            char *: path, shardHeader *: shard, studEquity *: result}
+  Output  = {bool: success}
+*/
+bool shardStudEquity(const studBoard * board, uint64_t shardNum,
+  uint64_t numOfShards, int numOfThreads, const checkpointConfig * checkpoint,
+  const char * path, shardHeader * shard, studEquity * result)
+{
+  equityShard saved;
+  uint64_t completions = 0;
+
+  if((numOfShards < 1) || (shardNum >= numOfShards) ||
+    (countCompletions(board, & completions) == FALSE))
+  {
+    return FALSE;
+  }
+  setShardRange(shard, boardKey(board), completions, shardNum, numOfShards);
+  /* Copied field by field so no padding bytes reach the file */
+  memset(& saved, 0, sizeof(saved));
+  saved.board.numOfPlayers = board->numOfPlayers;
+  memcpy(saved.board.known, board->known, sizeof(board->known));
+  memcpy(saved.board.numKnown, board->numKnown, sizeof(board->numKnown));
+  memcpy(saved.board.dead, board->dead, sizeof(board->dead));
+  saved.board.numDead = board->numDead;
+  if(enumerateEquity(board, NO_EARLY_EXIT, numOfThreads, shard, checkpoint,
+    & saved.totals, result) == FALSE)
+  {
+    return FALSE;
+  }
+  return writeShard(path, shard, & saved, sizeof(saved));
+}
+
+/*
+  Function to merge the shard files of a board's completions.
+
+  Input   = {char * *: paths, int: numOfPaths, studBoard *: board,
+            studEquity *: result, shardCoverage *: coverage}
+  Output  = {bool: success}
+*/
+bool mergeStudEquity(const char * const * paths, int numOfPaths,
+  studBoard * board, studEquity * result, shardCoverage * coverage)
+{
+  shardHeader * shards = NULL;
+  equityShard * saved = NULL;
+  equityTotals totals;
+  uint64_t completions = 0;
+  int pathNum = NUM_INIT;
+  bool success = TRUE;
+
+  memset(board, 0, sizeof(* board));
+  memset(result, 0, sizeof(* result));
+  /* Zeroed, so no header is read before a file fills it */
+  if(numOfPaths > 0)
+  {
+    shards = calloc(numOfPaths + 1, sizeof(shardHeader));
+    saved = calloc(numOfPaths + 1, sizeof(equityShard));
+  }
+  if((shards == NULL) || (saved == NULL))
+  {
+    free(shards);
+    free(saved);
+    coverage->status = SHARDS_UNREADABLE;
+    coverage->first = INVALID_INT;
+    return FALSE;
+  }
+  for(pathNum = NUM_INIT; pathNum < numOfPaths; pathNum ++)
+  {
+    /* A shard is only written once every completion of it is evaluated */
+    if((readShard(paths[pathNum], & shards[pathNum], & saved[pathNum],
+      sizeof(equityShard)) == FALSE) ||
+      (countCompletions(& saved[pathNum].board, & completions) == FALSE) ||
+      (completions != shards[pathNum].numOfItems) ||
+      (saved[pathNum].totals.evaluated !=
+      shards[pathNum].last - shards[pathNum].first) ||
+      (boardKey(& saved[pathNum].board) != shards[pathNum].key))
+    {
+      coverage->status = SHARDS_UNREADABLE;
+      coverage->first = pathNum;
+      coverage->second = INVALID_INT;
+      success = FALSE;
+      break;
+    }
+  }
+  success = success && checkShardCoverage(shards, numOfPaths, coverage);
+  if(success == TRUE)
+  {
+    memcpy(board, & saved[0].board, sizeof(studBoard));
+    memset(& totals, 0, sizeof(totals));
+    for(pathNum = NUM_INIT; pathNum < numOfPaths; pathNum ++)
+    {
+      addTotals(& totals, & saved[pathNum].totals);
+    }
+    finishEquity(board, & totals, shards[0].numOfItems, result);
+  }
+  free(shards);
+  free(saved);
+  return success;
+}
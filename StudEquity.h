@@ -0,0 +1,134 @@
+#ifndef StudEquity_h
+#define StudEquity_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Hand strengths and card indices */
+#include "HandEvaluator.h"
+/* Checkpoints of the chunks enumerated, and shard files */
+#include "PokerCheckpoint.h"
+
+/*
+  stdint.h is included for the 64 bit completion counts.
+*/
+#include <stdint.h>
+
+/*
+  Equity units of one completion. Every split of a pot between 1 to
+  MAX_PLAYERS winners is a whole number of units, so equities are summed
+  exactly.
+*/
+#define EQUITY_UNITS 2520
+/* Tolerance that disables the early exit */
+#define NO_EARLY_EXIT -1.0
+
+/*
+  Stud board structure
+
+  A stud board holds the known cards of every player, for example their
+  up-cards, and the cards known to be out of play. The unknown cards of each
+  player are filled from the rest of the deck.
+*/
+typedef struct studBoard
+{
+  int numOfPlayers;
+  unsigned char known[MAX_PLAYERS][CARDS_PER_HAND];
+  int numKnown[MAX_PLAYERS];
+  unsigned char dead[STD_DECK_SIZE];
+  int numDead;
+} studBoard;
+
+/*
+  Stud equity structure
+
+  The result of an enumeration. Equities are exact when every completion was
+  evaluated, otherwise they are the equities of the completions evaluated so
+  far and every final equity lies between the low and high bounds.
+*/
+typedef struct studEquity
+{
+  uint64_t completions;
+  uint64_t evaluated;
+  uint64_t wins[MAX_PLAYERS];
+  uint64_t ties[MAX_PLAYERS];
+  uint64_t equityUnits[MAX_PLAYERS];
+  double equity[MAX_PLAYERS];
+  double equityLow[MAX_PLAYERS];
+  double equityHigh[MAX_PLAYERS];
+  bool exact;
+} studEquity;
+
+/*
+  Function to count the completions of a board, the ways of filling every
+  player's unknown cards from the rest of the deck.
+
+  Input   = {studBoard *: board, uint64_t *: completions}
+  Output  = {bool: success}, FALSE for an invalid board or when the count
+            does not fit in 64 bits
+*/
+bool countCompletions(const studBoard *, uint64_t *);
+
+/*
+  Function to compute the equity of every player by evaluating every
+  completion of the board. Completion indices are split into equal chunks
+  that the threads take in turn. With a tolerance of zero or more the
+  enumeration stops once the completions left cannot change the order of the
+  players' equities by more than the tolerance.
+
+  Input   = {studBoard *: board, double: tolerance, int: numOfThreads,
+            studEquity *: result}
+  Output  = {bool: success}
+*/
+bool computeStudEquity(const studBoard *, double, int, studEquity *);
+
+/*
+  Function to compute the exact equity of every player like
+  computeStudEquity, saving the chunks done and their totals to a checkpoint
+  file at intervals and optionally resuming from it. Chunks are sized the
+  same whatever the number of threads, so a run can resume on any number,
+  and the totals are exact sums, so a resumed run gives the same result as
+  an uninterrupted one. A last checkpoint holding every chunk is written at
+  the end.
+
+  Input   = {studBoard *: board, int: numOfThreads,
+            checkpointConfig *: checkpoint, studEquity *: result}
+  Output  = {bool: success}, FALSE also when the checkpoint cannot be
+            resumed or written
+*/
+bool checkpointStudEquity(const studBoard *, int, const checkpointConfig *,
+  studEquity *);
+
+/*
+  Function to enumerate one shard of the completions of a board, exactly,
+  and write its totals and the board to a shard file. Shard i of N takes
+  the completion indices from i * C / N to (i + 1) * C / N of the C
+  completions, so separate processes, on one machine or several, can each
+  take a shard and mergeStudEquity adds them up. A shard may checkpoint
+  like checkpointStudEquity, and as the file is only renamed into place
+  when whole, a failed shard is simply run again. The result holds the
+  totals of the shard's completions alone.
+
+  Input   = {studBoard *: board, uint64_t: shardNum, uint64_t: numOfShards,
+            int: numOfThreads, checkpointConfig *: checkpoint, NULL for
+            none, char *: path, shardHeader *: shard, studEquity *: result}
+  Output  = {bool: success}, FALSE for an invalid board or shard, or when
+            the checkpoint or the shard file cannot be read or written
+*/
+bool shardStudEquity(const studBoard *, uint64_t, uint64_t, int,
+  const checkpointConfig *, const char *, shardHeader *, studEquity *);
+
+/*
+  Function to merge the shard files of a board into its exact equities.
+  Every file must hold a whole shard of the same board, and together they
+  must cover every completion exactly once; the coverage tells which file
+  failed, which two files do not fit together or which completions are in
+  no file.
+
+  Input   = {char * *: paths, int: numOfPaths, studBoard *: board,
+            studEquity *: result, shardCoverage *: coverage}
+  Output  = {bool: success}
+*/
+bool mergeStudEquity(const char * const *, int, studBoard *, studEquity *,
+  shardCoverage *);
+
+#endif /* StudEquity_h */
@@ -0,0 +1,201 @@
+#include "SuitIsomorphism.h"
+/* Card indices */
+#include "HandEvaluator.h"
+
+/* pthread.h is included for pthread_once, the class list is built once. */
+#include <pthread.h>
+
+/* Bits of a suit key holding the ranks of the cards, above the dead ranks */
+#define CARD_KEY_SHIFT NUM_OF_RANKS
+
+/* Factorials of the sizes of groups of identical suits */
+static const int suitGroupFactorial[NUM_OF_SUITS + 1] = {1, 1, 2, 6, 24};
+
+/* Class list, built by buildClassList */
+static canonicalClass * classList = NULL;
+static int numOfClassesBuilt = 0;
+static pthread_once_t classListOnce = PTHREAD_ONCE_INIT;
+
+/* Order two suits by descending key */
+#define sortSuits(first, second) \
+  do \
+  { \
+    if(keys[order[second]] > keys[order[first]]) \
+    { \
+      int swapped = order[first]; \
+      order[first] = order[second]; \
+      order[second] = swapped; \
+    } \
+  } while(0)
+
+/*
+  Function to relabel the suits of a set of cards and dead cards into
+  canonical form.
+
+  Input   = {unsigned char *: cards, int: numOfCards, unsigned char *: dead,
+            int: numDead, unsigned char *: canonicalCards,
+            unsigned char *: canonicalDead}
+  Output  = {int: multiplicity}
+*/
+int canonicalizeCards(const unsigned char * cards, int numOfCards,
+  const unsigned char * dead, int numDead, unsigned char * canonicalCards,
+  unsigned char * canonicalDead)
+{
+  uint32_t keys[NUM_OF_SUITS] = {0, 0, 0, 0};
+  int order[NUM_OF_SUITS] = {H, D, C, S};
+  int relabel[NUM_OF_SUITS];
+  int stabilizer = 1;
+  int groupSize = 1;
+  int cardNum = NUM_INIT;
+  int suitNum = NUM_INIT;
+
+  /* Each suit's key is its card ranks above its dead ranks */
+  for(cardNum = NUM_INIT; cardNum < numOfCards; cardNum ++)
+  {
+    keys[cardIndexSuit(cards[cardNum])] |=
+      1u << (cardIndexRank(cards[cardNum]) + CARD_KEY_SHIFT);
+  }
+  for(cardNum = NUM_INIT; cardNum < numDead; cardNum ++)
+  {
+    keys[cardIndexSuit(dead[cardNum])] |= 1u << cardIndexRank(dead[cardNum]);
+  }
+  /* Five comparison sorting network over the four suits */
+  sortSuits(0, 1);
+  sortSuits(2, 3);
+  sortSuits(0, 2);
+  sortSuits(1, 3);
+  sortSuits(1, 2);
+  for(suitNum = NUM_INIT; suitNum < NUM_OF_SUITS; suitNum ++)
+  {
+    relabel[order[suitNum]] = suitNum;
+    /* Suits with identical keys can be swapped without changing anything */
+    if((suitNum > 0) && (keys[order[suitNum]] == keys[order[suitNum - 1]]))
+    {
+      groupSize ++;
+    }
+    else
+    {
+      stabilizer *= suitGroupFactorial[groupSize];
+      groupSize = 1;
+    }
+  }
+  stabilizer *= suitGroupFactorial[groupSize];
+
+  if(canonicalCards != NULL)
+  {
+    for(cardNum = NUM_INIT; cardNum < numOfCards; cardNum ++)
+    {
+      canonicalCards[cardNum] = makeCardIndex(cardIndexRank(cards[cardNum]),
+        relabel[cardIndexSuit(cards[cardNum])]);
+    }
+  }
+  if(canonicalDead != NULL)
+  {
+    for(cardNum = NUM_INIT; cardNum < numDead; cardNum ++)
+    {
+      canonicalDead[cardNum] = makeCardIndex(cardIndexRank(dead[cardNum]),
+        relabel[cardIndexSuit(dead[cardNum])]);
+    }
+  }
+  return NUM_OF_SUIT_PERMUTATIONS / stabilizer;
+}
+
+/*
+  Function to find the colex index of the canonical form of a five card hand.
+
+  Input   = {unsigned char [CARDS_PER_HAND]: cards, int *: multiplicity}
+  Output  = {handIndex: canonicalIndex}
+*/
+handIndex canonicalHandIndex(const unsigned char cards[CARDS_PER_HAND],
+  int * multiplicity)
+{
+  unsigned char canonicalCards[CARDS_PER_HAND];
+  int classSize = canonicalizeCards(cards, CARDS_PER_HAND, NULL, 0,
+    canonicalCards, NULL);
+  if(multiplicity != NULL)
+  {
+    * multiplicity = classSize;
+  }
+  return rankHandIndices(canonicalCards);
+}
+
+/*
+  Function to build the class list, every hand that is its own canonical
+  form, in colex order.
+
+  Input   = {void: NULL}
+  Output  = {void: NULL}
+*/
+static void buildClassList(void)
+{
+  unsigned char cards[CARDS_PER_HAND];
+  handIndex index = 0;
+  int multiplicity = 0;
+
+  classList = malloc(sizeof(canonicalClass) *
+    NUM_OF_CANONICAL_FIVE_CARD_HANDS);
+  if(classList == NULL)
+  {
+    return;
+  }
+  for(index = 0; index < NUM_OF_FIVE_CARD_HANDS; index ++)
+  {
+    unrankHandIndices(index, cards);
+    if((canonicalHandIndex(cards, & multiplicity) == index) &&
+      (numOfClassesBuilt < NUM_OF_CANONICAL_FIVE_CARD_HANDS))
+    {
+      classList[numOfClassesBuilt].index = index;
+      classList[numOfClassesBuilt].multiplicity = multiplicity;
+      numOfClassesBuilt ++;
+    }
+  }
+}
+
+/*
+  Function to list the canonical five card classes in colex order.
+
+  Input   = {int *: numOfClasses}
+  Output  = {canonicalClass *: classes}
+*/
+const canonicalClass * canonicalFiveCardClasses(int * numOfClasses)
+{
+  pthread_once(& classListOnce, buildClassList);
+  * numOfClasses = numOfClassesBuilt;
+  return classList;
+}
+
+/*
+  Function to find the position in the class list of the class of a hand, by
+  binary search over the colex ordered list.
+
+  Input   = {unsigned char [CARDS_PER_HAND]: cards}
+  Output  = {int: classNum}
+*/
+int canonicalClassNumber(const unsigned char cards[CARDS_PER_HAND])
+{
+  handIndex index = 0;
+  int low = 0;
+  int high = 0;
+  int middle = 0;
+
+  pthread_once(& classListOnce, buildClassList);
+  if(classList == NULL)
+  {
+    return INVALID_INT;
+  }
+  index = canonicalHandIndex(cards, NULL);
+  high = numOfClassesBuilt - 1;
+  while(low < high)
+  {
+    middle = (low + high) / 2;
+    if(classList[middle].index < index)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  return low;
+}
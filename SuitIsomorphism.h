@@ -0,0 +1,70 @@
+#ifndef SuitIsomorphism_h
+#define SuitIsomorphism_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Colex hand indices */
+#include "HandIndex.h"
+
+/* Number of ways to relabel the four suits */
+#define NUM_OF_SUIT_PERMUTATIONS 24
+/* Number of five card hands that differ other than by relabelling suits */
+#define NUM_OF_CANONICAL_FIVE_CARD_HANDS 134459
+
+/*
+  Canonical class structure
+
+  One five card hand that is its own canonical form, with the number of
+  hands (its multiplicity) that relabel to it.
+*/
+typedef struct canonicalClass
+{
+  handIndex index;
+  unsigned char multiplicity;
+} canonicalClass;
+
+/*
+  Function to relabel the suits of a set of cards, and optionally of a set of
+  dead cards that has to be relabelled along with it, into canonical form.
+  Suits are ordered by the ranks they hold in the cards, then by the ranks
+  they hold among the dead cards, and renamed H, D, C, S in that order. Two
+  inputs relabel to the same canonical form exactly when some suit
+  permutation maps one onto the other. Either output may be NULL.
+
+  Input   = {unsigned char *: cards, int: numOfCards, unsigned char *: dead,
+            int: numDead, unsigned char *: canonicalCards,
+            unsigned char *: canonicalDead}
+  Output  = {int: multiplicity}, the number of distinct inputs with this
+            canonical form, 24 divided by the number of suit permutations
+            that leave the input unchanged
+*/
+int canonicalizeCards(const unsigned char *, int, const unsigned char *, int,
+  unsigned char *, unsigned char *);
+
+/*
+  Function to find the colex index of the canonical form of a five card hand.
+
+  Input   = {unsigned char [CARDS_PER_HAND]: cards, int *: multiplicity}
+  Output  = {handIndex: canonicalIndex}
+*/
+handIndex canonicalHandIndex(const unsigned char [CARDS_PER_HAND], int *);
+
+/*
+  Function to list the canonical five card classes in colex order. The list
+  is built on first use and shared by every caller.
+
+  Input   = {int *: numOfClasses}
+  Output  = {canonicalClass *: classes}, NULL when out of memory
+*/
+const canonicalClass * canonicalFiveCardClasses(int *);
+
+/*
+  Function to find the position in the class list of the class of a hand,
+  building the list first if needed.
+
+  Input   = {unsigned char [CARDS_PER_HAND]: cards}
+  Output  = {int: classNum}, INVALID_INT when the list cannot be built
+*/
+int canonicalClassNumber(const unsigned char [CARDS_PER_HAND]);
+
+#endif /* SuitIsomorphism_h */
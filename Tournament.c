@@ -0,0 +1,736 @@
+#include "Tournament.h"
+/* Hand strengths */
+#include "HandEvaluator.h"
+/* Colex hand indices, looked up in the ranges */
+#include "HandIndex.h"
+/* Generator streams and shuffles */
+#include "PokerRandom.h"
+/* Worker threads */
+#include "PokerThreads.h"
+
+/* stdatomic.h is included for the tournament counter. */
+#include <stdatomic.h>
+/* string.h is included for memset. */
+#include <string.h>
+
+/* Seat holding nobody */
+#define EMPTY_SEAT INVALID_INT
+
+/*
+  Tournament player structure
+
+    stack     - chips left
+    handStart - chips at the start of the hand being played
+    tieBreak  - random order among players busting with equal stacks
+    table     - table seated at
+    seat      - seat at the table
+*/
+typedef struct tournamentPlayer
+{
+  int64_t stack;
+  int64_t handStart;
+  uint64_t tieBreak;
+  int table;
+  int seat;
+} tournamentPlayer;
+
+/*
+  Tournament table structure
+
+    seats      - player in every seat, EMPTY_SEAT for none
+    numOfSeated - players seated
+    button     - seat of the button
+*/
+typedef struct tournamentTable
+{
+  int seats[MAX_PLAYERS];
+  int numOfSeated;
+  int button;
+} tournamentTable;
+
+/*
+  Tournament pools structure, what one thread plays tournaments in. The
+  results come first in the arena and stay; each tournament allocates the
+  rest after them and the arena is reset to the mark when the next starts.
+
+    players      - every player
+    tables       - every table a tournament can need
+    activeTables - tables in play
+    numOfActive  - tables in play
+    freeTables   - tables out of play
+    numOfFree    - tables out of play
+    busted       - players busted in the round being played
+    numOfBusted  - players busted in the round
+    deck         - deck the hands are dealt from
+    results      - sums over the thread's tournaments
+    arena        - memory of the thread, sized for one tournament
+    mark         - offset of the arena after the results
+    created      - FALSE when the arena could not be created
+*/
+typedef struct tournamentPools
+{
+  tournamentPlayer * players;
+  tournamentTable * tables;
+  int * activeTables;
+  int numOfActive;
+  int * freeTables;
+  int numOfFree;
+  int * busted;
+  int numOfBusted;
+  unsigned char deck[STD_DECK_SIZE];
+  tournamentResults results;
+  pokerArena arena;
+  size_t mark;
+  bool created;
+} tournamentPools;
+
+/* State shared by the tournament threads */
+typedef struct tournamentContext
+{
+  const tournamentConfig * config;
+  atomic_ullong nextTournament;
+  tournamentPools * pools;
+} tournamentContext;
+
+/*
+  Function to create the arena of a thread, sized for the results and the
+  pools of one tournament, and allocate the results.
+
+  Input   = {tournamentPools *: pools, tournamentConfig *: config}
+  Output  = {bool: success}
+*/
+static bool createTournamentPools(tournamentPools * pools,
+  const tournamentConfig * config)
+{
+  const int numOfTables = (config->numOfPlayers + config->seatsPerTable - 1) /
+    config->seatsPerTable;
+
+  memset(pools, 0, sizeof(tournamentPools));
+  if(createArena(& pools->arena, arenaBytes(sizeof(uint64_t) *
+    config->numOfPlayers, 1) + arenaBytes(sizeof(tournamentPlayer) *
+    config->numOfPlayers, 1) + arenaBytes(sizeof(tournamentTable) *
+    numOfTables, 1) + arenaBytes(sizeof(int) * numOfTables, 2) +
+    arenaBytes(sizeof(int) * config->numOfPlayers, 1),
+    config->backing) == FALSE)
+  {
+    return FALSE;
+  }
+  pools->results.heroFinishes = arenaAlloc(& pools->arena,
+    sizeof(uint64_t) * config->numOfPlayers);
+  pools->mark = pools->arena.used;
+  pools->created = TRUE;
+  return TRUE;
+}
+
+/*
+  Function to seat a player in the first empty seat of a table.
+
+  Input   = {tournamentPools *: pools, int: tableNum, int: playerNum}
+  Output  = {void: NULL}
+*/
+static void seatPlayer(tournamentPools * pools, int tableNum, int playerNum)
+{
+  tournamentTable * table = & pools->tables[tableNum];
+  int seatNum = NUM_INIT;
+
+  while(table->seats[seatNum] != EMPTY_SEAT)
+  {
+    seatNum ++;
+  }
+  table->seats[seatNum] = playerNum;
+  table->numOfSeated ++;
+  pools->players[playerNum].table = tableNum;
+  pools->players[playerNum].seat = seatNum;
+}
+
+/*
+  Function to find the next occupied seat after a seat.
+
+  Input   = {tournamentTable *: table, int: seatNum}
+  Output  = {int: seatNum}
+*/
+static int nextOccupiedSeat(const tournamentTable * table, int seatNum)
+{
+  do
+  {
+    seatNum = (seatNum + 1) % MAX_PLAYERS;
+  } while(table->seats[seatNum] == EMPTY_SEAT);
+  return seatNum;
+}
+
+/*
+  Function to start a tournament: the deck in order, full stacks, and the
+  players seated in a random order round the fewest tables that hold them.
+
+  Input   = {tournamentPools *: pools, tournamentConfig *: config,
+            pokerRng *: rng}
+  Output  = {void: NULL}
+*/
+static void startTournament(tournamentPools * pools,
+  const tournamentConfig * config, pokerRng * rng)
+{
+  const int numOfTables = (config->numOfPlayers + config->seatsPerTable - 1) /
+    config->seatsPerTable;
+  int * order = NULL;
+  int swapped = NUM_INIT;
+  int playerNum = NUM_INIT;
+  int tableNum = NUM_INIT;
+  int seatNum = NUM_INIT;
+  int other = NUM_INIT;
+  int cardNum = NUM_INIT;
+
+  /* The last tournament's pools go back at once; the arena is sized for
+     exactly these, so none of them can fail */
+  resetArena(& pools->arena, pools->mark);
+  pools->players = arenaAlloc(& pools->arena,
+    sizeof(tournamentPlayer) * config->numOfPlayers);
+  pools->tables = arenaAlloc(& pools->arena,
+    sizeof(tournamentTable) * numOfTables);
+  pools->activeTables = arenaAlloc(& pools->arena, sizeof(int) * numOfTables);
+  pools->freeTables = arenaAlloc(& pools->arena, sizeof(int) * numOfTables);
+  pools->busted = arenaAlloc(& pools->arena,
+    sizeof(int) * config->numOfPlayers);
+  order = pools->busted;
+
+  /* The deck starts in order, so a tournament does not depend on the last */
+  for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    pools->deck[cardNum] = cardNum;
+  }
+  for(playerNum = NUM_INIT; playerNum < config->numOfPlayers; playerNum ++)
+  {
+    pools->players[playerNum].stack = config->startingStack;
+    order[playerNum] = playerNum;
+  }
+  for(playerNum = config->numOfPlayers - 1; playerNum > 0; playerNum --)
+  {
+    other = randomBounded(rng, playerNum + 1);
+    swapped = order[playerNum];
+    order[playerNum] = order[other];
+    order[other] = swapped;
+  }
+  for(tableNum = NUM_INIT; tableNum < numOfTables; tableNum ++)
+  {
+    for(seatNum = NUM_INIT; seatNum < MAX_PLAYERS; seatNum ++)
+    {
+      pools->tables[tableNum].seats[seatNum] = EMPTY_SEAT;
+    }
+    pools->tables[tableNum].numOfSeated = 0;
+    pools->tables[tableNum].button = 0;
+    pools->activeTables[tableNum] = tableNum;
+  }
+  pools->numOfActive = numOfTables;
+  pools->numOfFree = 0;
+  for(playerNum = NUM_INIT; playerNum < config->numOfPlayers; playerNum ++)
+  {
+    seatPlayer(pools, playerNum % numOfTables, order[playerNum]);
+  }
+}
+
+/*
+  Function to share out the pots of a hand. The smallest stake still in
+  play among the players in the hand makes a pot of that much from every
+  stake, won by the best of those players, and so on up; odd chips go to
+  the winners nearest the button's left. What nobody in the hand matched
+  goes back.
+
+  Input   = {tournamentPools *: pools, int *: order, int: numOfSeated,
+            int64_t *: stakes, bool *: live, handStrength *: strengths},
+            the arrays in order round the table from the big blind
+  Output  = {void: NULL}
+*/
+static void settlePots(tournamentPools * pools, const int * order,
+  int numOfSeated, int64_t * stakes, const bool * live,
+  const handStrength * strengths)
+{
+  bool winners[MAX_PLAYERS];
+  int64_t level = 0;
+  int64_t pot = 0;
+  int64_t share = 0;
+  int64_t odd = 0;
+  handStrength best = 0;
+  int numOfWinners = NUM_INIT;
+  int playerNum = NUM_INIT;
+
+  for(;;)
+  {
+    level = 0;
+    best = 0;
+    for(playerNum = NUM_INIT; playerNum < numOfSeated; playerNum ++)
+    {
+      if((live[playerNum] == TRUE) && (stakes[playerNum] > 0))
+      {
+        level = ((level == 0) || (stakes[playerNum] < level)) ?
+          stakes[playerNum] : level;
+        best = (strengths[playerNum] > best) ? strengths[playerNum] : best;
+      }
+    }
+    if(level == 0)
+    {
+      break;
+    }
+    pot = 0;
+    numOfWinners = NUM_INIT;
+    for(playerNum = NUM_INIT; playerNum < numOfSeated; playerNum ++)
+    {
+      winners[playerNum] = ((live[playerNum] == TRUE) &&
+        (stakes[playerNum] > 0) && (strengths[playerNum] == best)) ?
+        TRUE : FALSE;
+      numOfWinners += winners[playerNum];
+      share = (stakes[playerNum] < level) ? stakes[playerNum] : level;
+      pot += share;
+      stakes[playerNum] -= share;
+    }
+    share = pot / numOfWinners;
+    odd = pot % numOfWinners;
+    for(playerNum = NUM_INIT; playerNum < numOfSeated; playerNum ++)
+    {
+      if(winners[playerNum] == TRUE)
+      {
+        pools->players[order[playerNum]].stack += share + (odd > 0);
+        odd -= (odd > 0);
+      }
+    }
+  }
+  for(playerNum = NUM_INIT; playerNum < numOfSeated; playerNum ++)
+  {
+    pools->players[order[playerNum]].stack += stakes[playerNum];
+  }
+}
+
+/*
+  Function to put chips of a player into their stake, all they have left
+  when they have too few.
+
+  Input   = {tournamentPlayer *: player, int64_t *: stake, int64_t: chips}
+  Output  = {void: NULL}
+*/
+static void stakeChips(tournamentPlayer * player, int64_t * stake,
+  int64_t chips)
+{
+  chips = (chips < player->stack) ? chips : player->stack;
+  player->stack -= chips;
+  * stake += chips;
+}
+
+/*
+  Function to play one hand at a table. Players are taken from the big
+  blind, the first seat after the button, round the table. A player with
+  no chips left after the ante is all in and stays in the hand.
+
+  Input   = {tournamentPools *: pools, tournamentConfig *: config,
+            int: tableNum, int64_t: bigBlind, int64_t: ante,
+            pokerRng *: rng}
+  Output  = {void: NULL}
+*/
+static void playTableHand(tournamentPools * pools,
+  const tournamentConfig * config, int tableNum, int64_t bigBlind,
+  int64_t ante, pokerRng * rng)
+{
+  tournamentTable * table = & pools->tables[tableNum];
+  tournamentPlayer * player = NULL;
+  const handRange * range = NULL;
+  const unsigned char * cards = NULL;
+  int order[MAX_PLAYERS];
+  int64_t stakes[MAX_PLAYERS];
+  bool live[MAX_PLAYERS];
+  bool inRange[MAX_PLAYERS];
+  handStrength strengths[MAX_PLAYERS];
+  handIndex index = 0;
+  bool shoved = FALSE;
+  int numOfSeated = table->numOfSeated;
+  int seatNum = NUM_INIT;
+  int playerNum = NUM_INIT;
+
+  if(numOfSeated < 2)
+  {
+    return;
+  }
+  seatNum = table->button;
+  for(playerNum = NUM_INIT; playerNum < numOfSeated; playerNum ++)
+  {
+    seatNum = nextOccupiedSeat(table, seatNum);
+    order[playerNum] = table->seats[seatNum];
+  }
+  table->button = pools->players[order[0]].seat;
+  shuffleCardIndices(rng, pools->deck, STD_DECK_SIZE,
+    numOfSeated * CARDS_PER_HAND);
+  for(playerNum = NUM_INIT; playerNum < numOfSeated; playerNum ++)
+  {
+    player = & pools->players[order[playerNum]];
+    player->handStart = player->stack;
+    stakes[playerNum] = 0;
+    stakeChips(player, & stakes[playerNum], ante);
+    cards = pools->deck + playerNum * CARDS_PER_HAND;
+    strengths[playerNum] = evaluateCardIndices(cards, CARDS_PER_HAND);
+    index = rankHandIndices(cards);
+    range = (order[playerNum] == 0) ? config->heroRange : config->fieldRange;
+    inRange[playerNum] = rangeHolds(range, index) ? TRUE : FALSE;
+  }
+  stakeChips(& pools->players[order[0]], & stakes[0], bigBlind);
+  for(playerNum = 1; playerNum < numOfSeated; playerNum ++)
+  {
+    player = & pools->players[order[playerNum]];
+    live[playerNum] = ((player->stack == 0) || (inRange[playerNum] == TRUE)) ?
+      TRUE : FALSE;
+    if((player->stack > 0) && (inRange[playerNum] == TRUE))
+    {
+      shoved = TRUE;
+      stakeChips(player, & stakes[playerNum], player->stack);
+    }
+  }
+  /* The big blind checks when nobody went all in */
+  live[0] = ((shoved == FALSE) || (inRange[0] == TRUE) ||
+    (pools->players[order[0]].stack == 0)) ? TRUE : FALSE;
+  if((shoved == TRUE) && (inRange[0] == TRUE))
+  {
+    stakeChips(& pools->players[order[0]], & stakes[0],
+      pools->players[order[0]].stack);
+  }
+  settlePots(pools, order, numOfSeated, stakes, live, strengths);
+}
+
+/*
+  Function to order the players busted in a round, most chips at the start
+  of the hand first, and give the hero's place when the hero is among them.
+
+  Input   = {tournamentPools *: pools, int: numOfLeft}
+  Output  = {void: NULL}
+*/
+static void placeBustedPlayers(tournamentPools * pools, int numOfLeft)
+{
+  const tournamentPlayer * players = pools->players;
+  int * busted = pools->busted;
+  int inserted = NUM_INIT;
+  int bustNum = NUM_INIT;
+  int slot = NUM_INIT;
+
+  for(bustNum = 1; bustNum < pools->numOfBusted; bustNum ++)
+  {
+    inserted = busted[bustNum];
+    for(slot = bustNum; (slot > 0) &&
+      ((players[busted[slot - 1]].handStart < players[inserted].handStart) ||
+      ((players[busted[slot - 1]].handStart == players[inserted].handStart) &&
+      (players[busted[slot - 1]].tieBreak < players[inserted].tieBreak)));
+      slot --)
+    {
+      busted[slot] = busted[slot - 1];
+    }
+    busted[slot] = inserted;
+  }
+  for(bustNum = NUM_INIT; bustNum < pools->numOfBusted; bustNum ++)
+  {
+    if(busted[bustNum] == 0)
+    {
+      pools->results.heroFinishes[numOfLeft + bustNum] ++;
+    }
+  }
+}
+
+/*
+  Function to find the active table with the fewest or the most players,
+  the later one on ties.
+
+  Input   = {tournamentPools *: pools, bool: most}
+  Output  = {int: activeNum}
+*/
+static int extremeTable(const tournamentPools * pools, bool most)
+{
+  int found = NUM_INIT;
+  int seated = NUM_INIT;
+  int activeNum = NUM_INIT;
+
+  for(activeNum = 1; activeNum < pools->numOfActive; activeNum ++)
+  {
+    seated = pools->tables[pools->activeTables[activeNum]].numOfSeated;
+    if(((most == TRUE) && (seated >= pools->tables[pools->activeTables[
+      found]].numOfSeated)) || ((most == FALSE) && (seated <=
+      pools->tables[pools->activeTables[found]].numOfSeated)))
+    {
+      found = activeNum;
+    }
+  }
+  return found;
+}
+
+/*
+  Function to move a player to the table with the fewest players.
+
+  Input   = {tournamentPools *: pools, int: playerNum}
+  Output  = {void: NULL}
+*/
+static void movePlayer(tournamentPools * pools, int playerNum)
+{
+  tournamentPlayer * player = & pools->players[playerNum];
+  tournamentTable * table = & pools->tables[player->table];
+
+  table->seats[player->seat] = EMPTY_SEAT;
+  table->numOfSeated --;
+  seatPlayer(pools, pools->activeTables[extremeTable(pools, FALSE)],
+    playerNum);
+  pools->results.moves ++;
+}
+
+/*
+  Function to break tables while the players left fit on fewer, the
+  smallest table first, its players going to the smallest tables left, then
+  to move the player due the big blind next from the biggest table to the
+  smallest until no two tables differ by more than one player.
+
+  Input   = {tournamentPools *: pools, int: numOfLeft, int: seatsPerTable}
+  Output  = {void: NULL}
+*/
+static void balanceTables(tournamentPools * pools, int numOfLeft,
+  int seatsPerTable)
+{
+  const int numOfNeeded = (numOfLeft + seatsPerTable - 1) / seatsPerTable;
+  tournamentTable * table = NULL;
+  int tableNum = NUM_INIT;
+  int activeNum = NUM_INIT;
+  int seatNum = NUM_INIT;
+  int spread = NUM_INIT;
+
+  while(pools->numOfActive > numOfNeeded)
+  {
+    activeNum = extremeTable(pools, FALSE);
+    tableNum = pools->activeTables[activeNum];
+    pools->activeTables[activeNum] =
+      pools->activeTables[-- pools->numOfActive];
+    pools->freeTables[pools->numOfFree ++] = tableNum;
+    pools->results.tablesBroken ++;
+    table = & pools->tables[tableNum];
+    for(seatNum = NUM_INIT; seatNum < MAX_PLAYERS; seatNum ++)
+    {
+      if(table->seats[seatNum] != EMPTY_SEAT)
+      {
+        movePlayer(pools, table->seats[seatNum]);
+      }
+    }
+  }
+  for(;;)
+  {
+    table = & pools->tables[pools->activeTables[extremeTable(pools, TRUE)]];
+    spread = table->numOfSeated - pools->tables[pools->activeTables[
+      extremeTable(pools, FALSE)]].numOfSeated;
+    if(spread <= 1)
+    {
+      break;
+    }
+    movePlayer(pools, table->seats[nextOccupiedSeat(table, table->button)]);
+  }
+  pools->results.maxSpread = (spread > pools->results.maxSpread) ? spread :
+    pools->results.maxSpread;
+}
+
+/*
+  Function to play a tournament to its last player. After every round the
+  busted players are placed, the chips are counted and the tables are
+  broken and balanced.
+
+  Input   = {tournamentPools *: pools, tournamentConfig *: config,
+            uint64_t: tournamentNum}
+  Output  = {void: NULL}
+*/
+static void playTournament(tournamentPools * pools,
+  const tournamentConfig * config, uint64_t tournamentNum)
+{
+  const int64_t totalChips = config->startingStack * config->numOfPlayers;
+  tournamentTable * table = NULL;
+  pokerRng rng;
+  int64_t bigBlind = (config->startingStack / STARTING_BIG_BLINDS > 2) ?
+    config->startingStack / STARTING_BIG_BLINDS : 2;
+  int64_t counted = 0;
+  uint64_t round = 0;
+  int numOfLeft = config->numOfPlayers;
+  int activeNum = NUM_INIT;
+  int seatNum = NUM_INIT;
+  int playerNum = NUM_INIT;
+
+  seedRng(& rng, config->seed, tournamentNum);
+  startTournament(pools, config, & rng);
+  while(numOfLeft > 1)
+  {
+    if((round > 0) && (round % config->levelRounds == 0))
+    {
+      bigBlind += (bigBlind / 2 > 1) ? bigBlind / 2 : 1;
+      bigBlind = (bigBlind < totalChips) ? bigBlind : totalChips;
+    }
+    for(activeNum = NUM_INIT; activeNum < pools->numOfActive; activeNum ++)
+    {
+      playTableHand(pools, config, pools->activeTables[activeNum], bigBlind,
+        (bigBlind / BIG_BLIND_ANTES > 1) ? bigBlind / BIG_BLIND_ANTES : 1,
+        & rng);
+      pools->results.hands += (pools->tables[
+        pools->activeTables[activeNum]].numOfSeated > 1);
+    }
+    round ++;
+
+    pools->numOfBusted = 0;
+    counted = 0;
+    for(activeNum = NUM_INIT; activeNum < pools->numOfActive; activeNum ++)
+    {
+      table = & pools->tables[pools->activeTables[activeNum]];
+      for(seatNum = NUM_INIT; seatNum < MAX_PLAYERS; seatNum ++)
+      {
+        playerNum = table->seats[seatNum];
+        if(playerNum == EMPTY_SEAT)
+        {
+          continue;
+        }
+        counted += pools->players[playerNum].stack;
+        if(pools->players[playerNum].stack == 0)
+        {
+          pools->players[playerNum].tieBreak = nextRandom(& rng);
+          pools->busted[pools->numOfBusted ++] = playerNum;
+          table->seats[seatNum] = EMPTY_SEAT;
+          table->numOfSeated --;
+        }
+      }
+    }
+    pools->results.chipErrors += (counted != totalChips);
+    numOfLeft -= pools->numOfBusted;
+    placeBustedPlayers(pools, numOfLeft);
+    if(numOfLeft > 1)
+    {
+      balanceTables(pools, numOfLeft, config->seatsPerTable);
+    }
+  }
+  for(activeNum = NUM_INIT; activeNum < pools->numOfActive; activeNum ++)
+  {
+    table = & pools->tables[pools->activeTables[activeNum]];
+    for(seatNum = NUM_INIT; seatNum < MAX_PLAYERS; seatNum ++)
+    {
+      if(table->seats[seatNum] == 0)
+      {
+        pools->results.heroFinishes[0] ++;
+      }
+    }
+  }
+  pools->results.rounds += round;
+  pools->results.tournaments ++;
+}
+
+/*
+  Function run by every tournament thread: take chunks of tournaments until
+  none are left.
+
+  Input   = {void *: context, int: threadNum}
+  Output  = {void: NULL}
+*/
+static void tournamentWorker(void * contextPTR, int threadNum)
+{
+  tournamentContext * context = (tournamentContext *)contextPTR;
+  const uint64_t numOfTournaments = context->config->numOfTournaments;
+  uint64_t first = 0;
+  uint64_t tournamentNum = 0;
+
+  /* The thread creates its own arena, so it lies on the thread's node */
+  if(createTournamentPools(& context->pools[threadNum], context->config) ==
+    FALSE)
+  {
+    return;
+  }
+  for(;;)
+  {
+    first = atomic_fetch_add_explicit(& context->nextTournament,
+      TOURNAMENT_CHUNK, memory_order_relaxed);
+    if(first >= numOfTournaments)
+    {
+      break;
+    }
+    for(tournamentNum = first; (tournamentNum < first + TOURNAMENT_CHUNK) &&
+      (tournamentNum < numOfTournaments); tournamentNum ++)
+    {
+      playTournament(& context->pools[threadNum], context->config,
+        tournamentNum);
+    }
+  }
+}
+
+/*
+  Function to simulate tournaments on several threads and add up what each
+  thread found.
+
+  Input   = {tournamentConfig *: config, tournamentResults *: results}
+  Output  = {bool: success}
+*/
+bool runTournaments(const tournamentConfig * config,
+  tournamentResults * results)
+{
+  const int numOfThreads = (config->numOfThreads < 1) ? 1 :
+    ((config->numOfThreads > MAX_THREADS) ? MAX_THREADS :
+    config->numOfThreads);
+  tournamentContext context;
+  const tournamentResults * found = NULL;
+  bool success = TRUE;
+  int threadNum = NUM_INIT;
+  int placeNum = NUM_INIT;
+
+  memset(results, 0, sizeof(tournamentResults));
+  if((config->numOfPlayers < 2) ||
+    (config->numOfPlayers > MAX_TOURNAMENT_PLAYERS) ||
+    (config->seatsPerTable < 2) || (config->seatsPerTable > MAX_PLAYERS) ||
+    (config->startingStack < 1) || (config->levelRounds < 1) ||
+    (config->heroRange == NULL) || (config->fieldRange == NULL))
+  {
+    return FALSE;
+  }
+  results->heroFinishes = calloc(config->numOfPlayers, sizeof(uint64_t));
+  context.config = config;
+  atomic_init(& context.nextTournament, 0);
+  context.pools = calloc(numOfThreads, sizeof(tournamentPools));
+  success = (results->heroFinishes != NULL) && (context.pools != NULL);
+  if(success == TRUE)
+  {
+    runParallel(numOfThreads, tournamentWorker, & context);
+  }
+  clearMemoryReport(& results->memory);
+  for(threadNum = NUM_INIT; (success == TRUE) && (threadNum < numOfThreads);
+    threadNum ++)
+  {
+    success = context.pools[threadNum].created;
+  }
+  for(threadNum = NUM_INIT; (context.pools != NULL) &&
+    (threadNum < numOfThreads); threadNum ++)
+  {
+    found = & context.pools[threadNum].results;
+    if(success == TRUE)
+    {
+      results->tournaments += found->tournaments;
+      results->rounds += found->rounds;
+      results->hands += found->hands;
+      results->moves += found->moves;
+      results->tablesBroken += found->tablesBroken;
+      results->chipErrors += found->chipErrors;
+      results->maxSpread = (found->maxSpread > results->maxSpread) ?
+        found->maxSpread : results->maxSpread;
+      for(placeNum = NUM_INIT; placeNum < config->numOfPlayers; placeNum ++)
+      {
+        results->heroFinishes[placeNum] += found->heroFinishes[placeNum];
+      }
+    }
+    if(context.pools[threadNum].created == TRUE)
+    {
+      addArenaReport(& results->memory, & context.pools[threadNum].arena);
+    }
+    freeArena(& context.pools[threadNum].arena);
+  }
+  free(context.pools);
+  if(success == FALSE)
+  {
+    freeTournamentResults(results);
+  }
+  return success;
+}
+
+/*
+  Function to free the finish counts of tournament results.
+
+  Input   = {tournamentResults *: results}
+  Output  = {void: NULL}
+*/
+void freeTournamentResults(tournamentResults * results)
+{
+  free(results->heroFinishes);
+  results->heroFinishes = NULL;
+}
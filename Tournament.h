@@ -0,0 +1,118 @@
+#ifndef Tournament_h
+#define Tournament_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Hand ranges the players go all in with */
+#include "HandRange.h"
+/* Arenas of the tournament threads */
+#include "PokerArena.h"
+
+/*
+  stdint.h is included for the chip stacks and the counters.
+*/
+#include <stdint.h>
+
+/* Most players a tournament seats */
+#define MAX_TOURNAMENT_PLAYERS 1000000
+/* Defaults of a tournament */
+#define DEFAULT_TOURNAMENT_PLAYERS 180
+#define DEFAULT_TOURNAMENT_SEATS 9
+#define DEFAULT_STARTING_STACK 1500
+#define DEFAULT_LEVEL_ROUNDS 10
+/* Big blinds in a starting stack, and antes in a big blind */
+#define STARTING_BIG_BLINDS 50
+#define BIG_BLIND_ANTES 10
+/* Tournaments a thread takes at a time */
+#define TOURNAMENT_CHUNK 16
+
+/*
+  Tournament configuration structure
+
+  Every player starts with the same stack. Each round every table plays one
+  hand: all seated players ante, the player after the button posts the big
+  blind and everyone is dealt five cards. Every other player goes all in
+  when their hand is in their range and folds otherwise; the big blind
+  calls with a hand in their range when somebody went all in. The blinds
+  and antes grow by half every levelRounds rounds. Player 0, the hero,
+  plays heroRange; the field plays fieldRange.
+
+    numOfPlayers     - players entering
+    seatsPerTable    - seats of a table, 2 to MAX_PLAYERS
+    startingStack    - chips of every player at the start
+    levelRounds      - rounds of a blind level
+    heroRange        - hands player 0 goes all in with
+    fieldRange       - hands the other players go all in with
+    numOfTournaments - tournaments to simulate
+    seed             - seed of the generator streams, tournament t using
+                       stream t
+    numOfThreads     - worker threads
+    backing          - arenaBacking of the arena of each thread
+*/
+typedef struct tournamentConfig
+{
+  int numOfPlayers;
+  int seatsPerTable;
+  int64_t startingStack;
+  int levelRounds;
+  const handRange * heroRange;
+  const handRange * fieldRange;
+  uint64_t numOfTournaments;
+  uint64_t seed;
+  int numOfThreads;
+  int backing;
+} tournamentConfig;
+
+/*
+  Tournament results structure, sums over every tournament simulated.
+
+    tournaments  - tournaments simulated
+    heroFinishes - tournaments the hero finished in each place, place p
+                   at p - 1, numOfPlayers of them
+    rounds       - rounds played
+    hands        - hands played, a hand at every table of a round
+    moves        - players moved to break or balance tables
+    tablesBroken - tables broken up as players busted
+    chipErrors   - rounds after which the stacks did not add up to the
+                   chips handed out, zero unless the simulator is wrong
+    maxSpread    - most players by which two tables differed after
+                   balancing, at most one
+    memory       - size and peak usage of the threads' arenas
+*/
+typedef struct tournamentResults
+{
+  uint64_t tournaments;
+  uint64_t * heroFinishes;
+  uint64_t rounds;
+  uint64_t hands;
+  uint64_t moves;
+  uint64_t tablesBroken;
+  uint64_t chipErrors;
+  int maxSpread;
+  memoryReport memory;
+} tournamentResults;
+
+/*
+  Function to simulate tournaments on several threads. Each thread takes
+  chunks of tournaments, playing them one at a time in an arena the thread
+  creates itself, so its memory lies on the thread's NUMA node. Each
+  tournament takes its players and tables from the arena and hands them
+  back at once when it ends, so no hand allocates memory. A tournament depends
+  on its seed stream alone, so the results are the same on any number of
+  threads.
+
+  Input   = {tournamentConfig *: config, tournamentResults *: results}
+  Output  = {bool: success}, FALSE for a bad configuration or too little
+            memory
+*/
+bool runTournaments(const tournamentConfig *, tournamentResults *);
+
+/*
+  Function to free the finish counts of tournament results.
+
+  Input   = {tournamentResults *: results}
+  Output  = {void: NULL}
+*/
+void freeTournamentResults(tournamentResults *);
+
+#endif /* Tournament_h */
@@ -0,0 +1,383 @@
+#include "WildCards.h"
+/* Colex combinations and binomial coefficients */
+#include "Combinatorics.h"
+
+/* pthread.h is included for the lock around building the tables. */
+#include <pthread.h>
+/* stdatomic.h is included for the ready flag. */
+#include <stdatomic.h>
+/* string.h is included for strcmp, memset and memcpy. */
+#include <string.h>
+/* ctype.h is included for toupper and tolower. */
+#include <ctype.h>
+
+/* Names of the hand ranks, from PokerTable.c */
+extern char * handRanks[NUM_OF_HAND_RANKS];
+
+/* Multisets of at most four ranks, C(13 + 4 - 1, 4) */
+#define MAX_RANK_MULTISETS 1820
+/* Natural cards a table is kept for, the rest of the hand being wild */
+#define MAX_TABLE_NATURALS (CARDS_PER_HAND - 1)
+/* Tables for natural cards of different suits and of one suit */
+#define NUM_OF_SUITINGS 2
+/* Longest name of a wild configuration term */
+#define WILD_TERM_SIZE 16
+
+/*
+  Strength of the best hand for every number of natural cards, whether
+  they share a suit and multiset index of their ace high values.
+*/
+static handStrength wildTables[MAX_TABLE_NATURALS + 1][NUM_OF_SUITINGS]
+  [MAX_RANK_MULTISETS];
+static pthread_mutex_t prepareLock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int wildReady = 0;
+
+/* Rank enumeration value of an ace high value */
+#define valueRank(value) (((value) + 1) % NUM_OF_RANKS)
+
+/*
+  Function to read one term of a wild configuration.
+
+  Input   = {char *: term, wildConfig *: config}
+  Output  = {bool: success}
+*/
+static bool readWildTerm(const char * term, wildConfig * config)
+{
+  const char * rankNames = "A23456789TJQK";
+  int rankNum = NUM_INIT;
+
+  if(strcmp(term, "joker") == 0)
+  {
+    config->joker = TRUE;
+    return TRUE;
+  }
+  if(strcmp(term, "deuces") == 0)
+  {
+    config->wildRanks |= 1U << TWO;
+    return TRUE;
+  }
+  if(term[0] != '\0' && term[1] == '\0')
+  {
+    for(rankNum = NUM_INIT; rankNum < NUM_OF_RANKS; rankNum ++)
+    {
+      if(rankNames[rankNum] == toupper((unsigned char)term[0]))
+      {
+        config->wildRanks |= 1U << rankNum;
+        return TRUE;
+      }
+    }
+  }
+  return FALSE;
+}
+
+/*
+  Function to read a wild configuration.
+
+  Input   = {char *: text, wildConfig *: config}
+  Output  = {bool: success}
+*/
+bool parseWildConfig(const char * text, wildConfig * config)
+{
+  char term[WILD_TERM_SIZE];
+  int length = NUM_INIT;
+
+  config->joker = FALSE;
+  config->wildRanks = 0;
+  while(* text != '\0')
+  {
+    if((* text == ' ') || (* text == ',') || (* text == '+'))
+    {
+      text ++;
+      continue;
+    }
+    for(length = NUM_INIT; (text[length] != '\0') && (text[length] != ' ') &&
+      (text[length] != ',') && (text[length] != '+'); length ++)
+    {
+      if(length == WILD_TERM_SIZE - 1)
+      {
+        return FALSE;
+      }
+      term[length] = tolower((unsigned char)text[length]);
+    }
+    term[length] = '\0';
+    if(readWildTerm(term, config) == FALSE)
+    {
+      return FALSE;
+    }
+    text += length;
+  }
+  return TRUE;
+}
+
+/*
+  Function to fill a deck with the card indices of a wild configuration.
+
+  Input   = {unsigned char *: deck, wildConfig *: config}
+  Output  = {int: deckSize}
+*/
+int createWildDeck(unsigned char * deck, const wildConfig * config)
+{
+  int cardNum = NUM_INIT;
+
+  for(cardNum = NUM_INIT; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    deck[cardNum] = cardNum;
+  }
+  if(config->joker == TRUE)
+  {
+    deck[cardNum ++] = JOKER_INDEX;
+  }
+  return cardNum;
+}
+
+/*
+  Function to read a list of cards that may hold jokers.
+
+  Input   = {char *: text, unsigned char *: indices, int: maxCards}
+  Output  = {int: numOfCards}, INVALID_INT when the list cannot be read
+*/
+int parseWildCardList(const char * text, unsigned char * indices,
+  int maxCards)
+{
+  int numOfCards = NUM_INIT;
+  while(* text != '\0')
+  {
+    if((* text == ' ') || (* text == ',') || (* text == '-'))
+    {
+      text ++;
+      continue;
+    }
+    if(numOfCards == maxCards)
+    {
+      return INVALID_INT;
+    }
+    if((toupper((unsigned char)text[0]) == 'J') &&
+      (toupper((unsigned char)text[1]) == 'K'))
+    {
+      indices[numOfCards] = JOKER_INDEX;
+    }
+    else if(parseCardIndex(text, & indices[numOfCards]) == FALSE)
+    {
+      return INVALID_INT;
+    }
+    numOfCards ++;
+    text += 2;
+  }
+  return numOfCards;
+}
+
+/*
+  Function to give the strength of five cards of known ace high values,
+  which may repeat a card, the cards sharing a suit when flushable. A flush
+  needs five different values.
+
+  Input   = {int *: counts, bool: flushable}
+  Output  = {handStrength: strength}
+*/
+static handStrength valueCountStrength(const int counts[NUM_OF_RANKS],
+  bool flushable)
+{
+  unsigned char cards[CARDS_PER_HAND];
+  int numOfCards = NUM_INIT;
+  int numOfValues = NUM_INIT;
+  int value = NUM_INIT;
+  int copyNum = NUM_INIT;
+
+  for(value = NUM_INIT; value < NUM_OF_RANKS; value ++)
+  {
+    if(counts[value] == CARDS_PER_HAND)
+    {
+      return fiveOfAKindStrength(value);
+    }
+    for(copyNum = NUM_INIT; copyNum < counts[value]; copyNum ++)
+    {
+      cards[numOfCards ++] = makeCardIndex(valueRank(value), copyNum);
+    }
+    numOfValues += (counts[value] > 0);
+  }
+  /* Five different values are all of suit 0, move one off unless suited */
+  if((numOfValues == CARDS_PER_HAND) && (flushable == FALSE))
+  {
+    cards[0] ++;
+  }
+  return evaluateCardIndices(cards, CARDS_PER_HAND);
+}
+
+/*
+  Function to find the best hand wild cards complete from natural cards of
+  known values, trying every multiset of values for the wild cards.
+
+  Input   = {int *: naturalCounts, int: numOfWild, bool: suited}
+  Output  = {handStrength: strength}
+*/
+static handStrength bestSubstitution(const int naturalCounts[NUM_OF_RANKS],
+  int numOfWild, bool suited)
+{
+  unsigned char positions[CARDS_PER_HAND];
+  int counts[NUM_OF_RANKS];
+  handStrength best = 0;
+  handStrength strength = 0;
+  bool flushable = FALSE;
+  int wildNum = NUM_INIT;
+  int value = NUM_INIT;
+
+  for(wildNum = NUM_INIT; wildNum < numOfWild; wildNum ++)
+  {
+    positions[wildNum] = wildNum;
+  }
+  do
+  {
+    memcpy(counts, naturalCounts, sizeof(counts));
+    for(wildNum = NUM_INIT; wildNum < numOfWild; wildNum ++)
+    {
+      counts[positions[wildNum] - wildNum] ++;
+    }
+    flushable = suited;
+    for(value = NUM_INIT; value < NUM_OF_RANKS; value ++)
+    {
+      if(counts[value] > 1)
+      {
+        flushable = FALSE;
+      }
+    }
+    strength = valueCountStrength(counts, flushable);
+    best = (strength > best) ? strength : best;
+  } while(nextCombination(positions, numOfWild,
+    NUM_OF_RANKS + numOfWild - 1) == TRUE);
+  return best;
+}
+
+/*
+  Function to build the best substitution tables.
+
+  Input   = {void: NULL}
+  Output  = {bool: success}
+*/
+bool prepareWildTables(void)
+{
+  unsigned char positions[MAX_TABLE_NATURALS];
+  int counts[NUM_OF_RANKS];
+  int numOfNatural = NUM_INIT;
+  int suiting = NUM_INIT;
+  int cardNum = NUM_INIT;
+  int index = NUM_INIT;
+
+  if(atomic_load_explicit(& wildReady, memory_order_acquire) != 0)
+  {
+    return TRUE;
+  }
+  pthread_mutex_lock(& prepareLock);
+  if(atomic_load_explicit(& wildReady, memory_order_relaxed) != 0)
+  {
+    pthread_mutex_unlock(& prepareLock);
+    return TRUE;
+  }
+  /* Natural multisets are walked in colex order of their positions */
+  for(numOfNatural = 1; numOfNatural <= MAX_TABLE_NATURALS; numOfNatural ++)
+  {
+    for(cardNum = NUM_INIT; cardNum < numOfNatural; cardNum ++)
+    {
+      positions[cardNum] = cardNum;
+    }
+    index = NUM_INIT;
+    do
+    {
+      memset(counts, 0, sizeof(counts));
+      for(cardNum = NUM_INIT; cardNum < numOfNatural; cardNum ++)
+      {
+        counts[positions[cardNum] - cardNum] ++;
+      }
+      for(suiting = NUM_INIT; suiting < NUM_OF_SUITINGS; suiting ++)
+      {
+        wildTables[numOfNatural][suiting][index] = bestSubstitution(counts,
+          CARDS_PER_HAND - numOfNatural, (suiting == 1) ? TRUE : FALSE);
+      }
+      index ++;
+    } while(nextCombination(positions, numOfNatural,
+      NUM_OF_RANKS + numOfNatural - 1) == TRUE);
+  }
+  atomic_store_explicit(& wildReady, 1, memory_order_release);
+  pthread_mutex_unlock(& prepareLock);
+  return TRUE;
+}
+
+/*
+  Function to determine the strength of a five card hand under a wild
+  configuration.
+
+  Input   = {unsigned char *: cards, wildConfig *: config}
+  Output  = {handStrength: strength}
+*/
+handStrength evaluateWildHand(const unsigned char * cards,
+  const wildConfig * config)
+{
+  unsigned char values[CARDS_PER_HAND];
+  unsigned char inserted = 0;
+  unsigned int wild = 0;
+  unsigned int suits = 0;
+  int numOfNatural = NUM_INIT;
+  int cardNum = NUM_INIT;
+  int slot = NUM_INIT;
+
+  /* The joker's rank bit lies above every rank, it is always wild */
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    wild |= ((config->wildRanks | (1U << NUM_OF_RANKS)) >>
+      cardIndexRank(cards[cardNum]) & 1) << cardNum;
+  }
+  if(wild == 0)
+  {
+    return evaluateCardIndices(cards, CARDS_PER_HAND);
+  }
+  /* The tables are built on the first wild hand if nobody built them */
+  if(atomic_load_explicit(& wildReady, memory_order_acquire) == 0)
+  {
+    prepareWildTables();
+  }
+  for(cardNum = NUM_INIT; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    if((wild >> cardNum) & 1)
+    {
+      continue;
+    }
+    /* Insertion sort of at most four values */
+    inserted = cardIndexValue[cards[cardNum]];
+    for(slot = numOfNatural; (slot > 0) && (values[slot - 1] > inserted);
+      slot --)
+    {
+      values[slot] = values[slot - 1];
+    }
+    values[slot] = inserted;
+    suits |= 1U << cardIndexSuit(cards[cardNum]);
+    numOfNatural ++;
+  }
+  if(numOfNatural == 0)
+  {
+    return fiveOfAKindStrength(ACE_HIGH_VALUE);
+  }
+  for(cardNum = NUM_INIT; cardNum < numOfNatural; cardNum ++)
+  {
+    values[cardNum] += cardNum;
+  }
+  return wildTables[numOfNatural][(suits & (suits - 1)) == 0 ? 1 : 0]
+    [rankCombination(values, numOfNatural)];
+}
+
+/*
+  Function to name the category of a wild hand strength.
+
+  Input   = {int: category}
+  Output  = {char *: name}
+*/
+const char * wildCategoryName(int category)
+{
+  if(category == FIVE_OF_A_KIND)
+  {
+    return "Five of a Kind";
+  }
+  if((category >= HighCard) && (category < NUM_OF_HAND_RANKS))
+  {
+    return handRanks[category];
+  }
+  return "Unknown";
+}
@@ -0,0 +1,110 @@
+#ifndef WildCards_h
+#define WildCards_h
+
+/* Cards, hands and hand ranks of the simulated Poker Table. */
+#include "PokerTable.h"
+/* Hand strengths */
+#include "HandEvaluator.h"
+
+/*
+  stdint.h is included for the wild rank mask.
+*/
+#include <stdint.h>
+
+/* The joker, the card a joker deck adds after the 52 standard ones */
+#define JOKER_INDEX STD_DECK_SIZE
+#define JOKER_DECK_SIZE (STD_DECK_SIZE + 1)
+/*
+  Category only wild cards make, above StraightFlush. It is kept out of
+  pokerRank so the tables sized by NUM_OF_HAND_RANKS are unchanged; a
+  strength of this category carries the rank of the five in its first
+  value.
+*/
+#define FIVE_OF_A_KIND NUM_OF_HAND_RANKS
+#define NUM_OF_WILD_HAND_RANKS (NUM_OF_HAND_RANKS + 1)
+
+/* Strength of five of a kind of an ace high value */
+#define fiveOfAKindStrength(value) \
+  (((handStrength)FIVE_OF_A_KIND << STRENGTH_CATEGORY_SHIFT) | \
+  ((handStrength)(value) << ((STRENGTH_VALUES - 1) * STRENGTH_VALUE_BITS)))
+
+/*
+  Wild configuration structure
+
+  A wild card stands for any rank and suit, even a card already in the
+  hand, so five of a kind is possible and beats a straight flush. A flush
+  still needs five different ranks.
+
+    joker     - TRUE when the deck holds the joker, which is always wild
+    wildRanks - bit r set when every card of rank r is wild, rank as in the
+                rank enumeration, so deuces wild is 1 << TWO
+*/
+typedef struct wildConfig
+{
+  bool joker;
+  uint32_t wildRanks;
+} wildConfig;
+
+/*
+  Function to read a wild configuration: names and rank characters
+  separated by spaces, commas or plus signs. "joker" adds the joker,
+  "deuces" makes the Twos wild and a rank character from A23456789TJQK
+  makes that rank wild, as in "joker,deuces" or "2+J".
+
+  Input   = {char *: text, wildConfig *: config}
+  Output  = {bool: success}, FALSE when the text cannot be read
+*/
+bool parseWildConfig(const char *, wildConfig *);
+
+/*
+  Function to fill a deck with the card indices of a wild configuration, the
+  joker last when there is one.
+
+  Input   = {unsigned char *: deck, wildConfig *: config}
+  Output  = {int: deckSize}
+*/
+int createWildDeck(unsigned char *, const wildConfig *);
+
+/*
+  Function to read a list of cards that may hold jokers, written JK, and
+  otherwise read as by parseCardList.
+
+  Input   = {char *: text, unsigned char *: indices, int: maxCards}
+  Output  = {int: numOfCards}, INVALID_INT when the list cannot be read
+*/
+int parseWildCardList(const char *, unsigned char *, int);
+
+/*
+  Function to build the best substitution tables. For every multiset of
+  ranks of one to four natural cards, and whether those cards share a suit,
+  the table holds the strength of the best hand the remaining wild cards
+  complete, so a wild hand is evaluated with one lookup. The tables hold a
+  few thousand strengths and are built once, on first use.
+
+  Input   = {void: NULL}
+  Output  = {bool: success}
+*/
+bool prepareWildTables(void);
+
+/*
+  Function to determine the strength of a five card hand under a wild
+  configuration. A hand without wild cards is evaluated as a natural one;
+  otherwise the ranks of the natural cards are sorted into a multiset index
+  and looked up. The tables are built by the first wild hand when
+  prepareWildTables has not been called.
+
+  Input   = {unsigned char *: cards, wildConfig *: config}
+  Output  = {handStrength: strength}
+*/
+handStrength evaluateWildHand(const unsigned char *, const wildConfig *);
+
+/*
+  Function to name the category of a wild hand strength, including five of
+  a kind.
+
+  Input   = {int: category}
+  Output  = {char *: name}
+*/
+const char * wildCategoryName(int);
+
+#endif /* WildCards_h */
@@ -0,0 +1,4153 @@
+/*
+  Differential checker for the hand evaluators.
+
+  Every one of the 2,598,960 five card hands, followed by a number of randomly
+  dealt tables, is ranked three ways:
+
+    legacy    - assignRank and determineWinner, the is* predicates of
+                PokerTable.c
+    optimized - evaluateCardIndices and findWinners of HandEvaluator.c
+    reference - the rules below, written as plainly as possible
+
+  Reference rules:
+    1. A flush is five cards of one suit.
+    2. A straight is five distinct consecutive ranks. The Ace is the highest
+       rank (T-J-Q-K-A) or the lowest (A-2-3-4-5), never both (no Q-K-A-2-3).
+       The high card of A-2-3-4-5 is the Five.
+    3. Categories, from best to worst: straight flush, four of a kind, full
+       house, flush, straight, three of a kind, two pairs, one pair, high
+       card.
+    4. Equal categories are split by comparing ranks grouped by how many
+       times they appear (most copies first, then highest rank first); a
+       straight is compared by its high card only.
+
+  The optimized evaluator has to agree with the reference on every hand and
+  every table, each disagreement is reported with its cards and fails the
+  run. The legacy code is known to disagree with the reference (it misses
+  T-J-Q-K-A straights, accepts straight flushes whose last card is off suit
+  and misses some four of a kinds), so its disagreements are tallied by
+  category instead of failing the run.
+*/
+
+/* Status returned when every check passed, and when one did not */
+#define PASSED_STATUS 0
+#define FAILED_STATUS 1
+#define DEFAULT_TABLES 1000000
+#define DEFAULT_SEED 20190401ULL
+#define TABLES_PER_CHUNK 4096
+/* Hands with a given highest card are at most C(51, 4) */
+#define MAX_HANDS_PER_TOP_CARD 249900
+/* Size of the simulations compared across thread counts */
+#define STATS_TABLES 300000
+#define STATS_PLAYERS 6
+/* Batch shuffle check: decks compared across paths, and the small decks
+   whose orderings are counted */
+#define SHUFFLE_DECKS 1003
+#define SHUFFLE_ROUNDS 200
+#define ORDER_DECK_SIZE 4
+#define NUM_OF_ORDERS 24
+#define ORDER_SAMPLES 480000
+/* Hands whose draw options are enumerated draw by draw */
+#define DRAW_HANDS 2
+/* Seven card stud hands checked street by street */
+#define STUD_CHECK_HANDS 200000
+/* Rare hand check: tables per lead card, and draws of the straight flushes
+   counted to test they are even */
+#define RARE_SAMPLES 2000
+#define RARE_UNIFORM_HANDS 40
+#define RARE_UNIFORM_SAMPLES 400000
+/* Chi-square with 39 degrees of freedom exceeded with probability 0.001 */
+#define RARE_CHI_SQUARE_LIMIT 72.05
+/* Tables of the checkpoint check, and its intervals in seconds */
+#define CHECKPOINT_TABLES 2000000
+#define CHECKPOINT_SECONDS 0.005
+#define CHECKPOINT_SNAPSHOT_SECONDS 0.02
+/* Longest path of the temporary files the checks write */
+#define TEMP_PATH_SIZE 64
+/* Tables of the pipeline check and its stage threads */
+#define PIPELINE_TABLES 150000
+#define PIPELINE_PRODUCERS 2
+#define PIPELINE_EVALUATORS 3
+/* Deals of the history index check, three full containers and a partial */
+#define HISTORY_DEALS 200000
+#define HISTORY_QUERIES 7
+/*
+  Negations in front of the last history query, far more than the stack
+  would take one call each, and parentheses past the nesting limit
+*/
+#define HISTORY_DEEP_NEGATIONS 120001
+#define HISTORY_DEEP_PARENTHESES 257
+/* Chi-square with 23 degrees of freedom exceeded with probability 0.001 */
+#define ORDER_CHI_SQUARE_LIMIT 49.73
+/* Decks of the shuffle audits, enough for three card prefixes, and of the
+   audit of the legacy shuffle */
+#define AUDIT_DECKS 700000
+#define LEGACY_AUDIT_DECKS 20000
+/* Card removal check: sets of seen cards whose unseen hands are enumerated */
+#define REMOVAL_SETS 8
+/* Wild hand check: hands compared with trying every substitution, by
+   number of wild cards */
+#define MAX_CHECKED_WILDS 4
+/* Percentile check: samples of the table built, hands whose odds against
+   one opponent are enumerated, deals simulated against the table's mean
+   odds and how far those may stray */
+#define PERCENTILE_SAMPLES 64
+#define PERCENTILE_HANDS 6
+#define PERCENTILE_DEALS 200000
+#define PERCENTILE_TOLERANCE 0.006
+/* Dynamic table check: hands of a shoe compared with the plain rules, hands
+   of one suit of a shoe, where repeated cards make flushes, and tables */
+#define SHOE_DECKS 4
+#define SHOE_HANDS 400000
+#define SHOE_SUITED_HANDS 40000
+#define SHOE_TABLES 2000
+#define SHOE_SEATS 40
+/* CFR check: buckets and deals of the small game solved, and iterations */
+#define CHECK_CFR_BUCKETS 3
+#define CHECK_CFR_DEALS 2000
+#define CHECK_CFR_ITERATIONS 200000
+/* Range check: relative tolerance between the equity engines */
+#define RANGE_TOLERANCE 1e-9
+/* Tournament check: tournaments of each configuration, and the standard
+   errors the hero's mean place may stray from the middle */
+#define CHECK_TOURNAMENTS 3000
+#define TOURNAMENT_MEAN_ERRORS 5.0
+/* Equity check: boards enumerated against brute force, and the tolerance
+   of the early exit, wide enough that the first board stops early */
+#define CHECK_EQUITY_BOARDS 3
+#define CHECK_EQUITY_TOLERANCE 0.25
+/* Shard check: players, known cards of each, dead cards and shards */
+#define SHARD_PLAYERS 3
+#define SHARD_KNOWN 4
+#define SHARD_DEAD 2
+#define CHECK_SHARDS 5
+/* Batches between traced batches and spans kept by the small trace ring */
+#define CHECK_TRACE_EVERY 3
+#define CHECK_TRACE_SMALL_RING 8
+/* Bytes of the checked arena and objects of the checked pool */
+#define CHECK_ARENA_BYTES 16384
+#define CHECK_POOL_OBJECTS 8
+/* Play check: hands of each run, not a whole number of batches, and the
+   players at the audited tables */
+#define CHECK_PLAY_HANDS 5000
+#define CHECK_PLAY_PLAYERS 6
+/* Showdown kernel check: tables dealt for every number of players */
+#define CHECK_KERNEL_TABLES 20000
+
+/* Cards, hands and legacy ranking of the Poker Table */
+#include "PokerTable.h"
+/* Optimized evaluator */
+#include "HandEvaluator.h"
+/* Random numbers for the fuzzed tables */
+#include "PokerRandom.h"
+/* Worker threads */
+#include "PokerThreads.h"
+/* Colex hand indices */
+#include "HandIndex.h"
+/* Binomial coefficients */
+#include "Combinatorics.h"
+/* Suit canonical forms */
+#include "SuitIsomorphism.h"
+/* Simulated tables and their statistics */
+#include "PokerSimulation.h"
+/* Batches of shuffled decks */
+#include "BatchShuffle.h"
+/* Five card draw discards */
+#include "DrawSolver.h"
+/* Seven card stud hands */
+#include "SevenStud.h"
+/* Tables dealt around rare hands */
+#include "RareHands.h"
+/* Strength buckets */
+#include "PokerStats.h"
+/* Producer, evaluator and writer stages */
+#include "PokerPipeline.h"
+/* Bitmap indices of deal files */
+#include "HandHistory.h"
+/* Shuffle fairness audits */
+#include "ShuffleAudit.h"
+/* Hand categories left after card removal */
+#include "CardRemoval.h"
+/* Jokers and wild ranks */
+#include "WildCards.h"
+/* Win odds of every hand against random opponents */
+#include "HandPercentile.h"
+/* Tables of any size dealt from shoes */
+#include "DynamicTable.h"
+/* Counterfactual regret solver of a stud betting game */
+#include "StudCfr.h"
+/* Hand ranges and range against range equity */
+#include "HandRange.h"
+/* Multi-table tournaments */
+#include "Tournament.h"
+/* Stud equity enumeration, its shards and their merge */
+#include "StudEquity.h"
+/* Trace of the sampled batches of a run */
+#include "PokerTrace.h"
+/* Arenas and object pools */
+#include "PokerArena.h"
+/* Batched play strategies and the play driver */
+#include "PlayStrategy.h"
+
+/* string.h is included for memset and strcmp. */
+#include <string.h>
+/* stdatomic.h is included for the work counters shared by the threads. */
+#include <stdatomic.h>
+/* unistd.h is included for getpid, naming the checkpoint files. */
+#include <unistd.h>
+/* math.h is included for fabs, comparing the percentile odds. */
+#include <math.h>
+
+/* Names of the hand ranks, from PokerTable.c */
+extern char * handRanks[NUM_OF_HAND_RANKS];
+
+/* Results of one thread, padded so threads never share a cache line */
+typedef struct diffResults
+{
+  unsigned long long handsChecked;
+  unsigned long long tablesChecked;
+  unsigned long long optimizedMismatches;
+  unsigned long long legacyDeviations[NUM_OF_HAND_RANKS][NUM_OF_HAND_RANKS];
+  unsigned char legacyExamples[NUM_OF_HAND_RANKS][NUM_OF_HAND_RANKS]
+    [CARDS_PER_HAND];
+  unsigned long long legacyWinnerDeviations;
+  double legacySeconds;
+  double optimizedSeconds;
+  double rankSeconds;
+  double unrankSeconds;
+  unsigned long long canonicalClasses;
+  unsigned long long canonicalWeight;
+  char padding[CACHE_LINE_SIZE];
+} diffResults;
+
+/* State shared by the checking threads */
+typedef struct diffContext
+{
+  atomic_int nextTopCard;
+  atomic_llong nextTable;
+  long long numOfTables;
+  unsigned long long seed;
+  bool verbose;
+  diffResults results[MAX_THREADS];
+} diffContext;
+
+/* Rank of a card by the reference rules, from 2 for a Two up to 14 for an Ace */
+static int referenceValue(unsigned char index)
+{
+  rank cardRank = cardIndexRank(index);
+  if(cardRank == ACE)
+  {
+    return 14;
+  }
+  return cardRank + 1;
+}
+
+/*
+  Reference comparison key of a five card hand, the category followed by the
+  grouped ranks of rule 4, each packed into 4 bits.
+*/
+static unsigned long referenceKey(const unsigned char cards[CARDS_PER_HAND])
+{
+  int counts[15] = {0};
+  int values[CARDS_PER_HAND];
+  int ordered[CARDS_PER_HAND];
+  int numOrdered = 0;
+  int copies = 0;
+  int value = 0;
+  int cardNum = 0;
+  int high = 0;
+  bool flush = TRUE;
+  bool straight = FALSE;
+  pokerRank category = HighCard;
+  unsigned long key = 0;
+
+  for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    values[cardNum] = referenceValue(cards[cardNum]);
+    counts[values[cardNum]] ++;
+    if(cardIndexSuit(cards[cardNum]) != cardIndexSuit(cards[0]))
+    {
+      flush = FALSE;
+    }
+  }
+  /* Group ranks by copies, most copies first, then highest rank first */
+  for(copies = QUAD; copies >= 1; copies --)
+  {
+    for(value = 14; value >= 2; value --)
+    {
+      if(counts[value] == copies)
+      {
+        ordered[numOrdered ++] = value;
+      }
+    }
+  }
+  /* Five distinct ranks are a straight when they are consecutive */
+  if(numOrdered == CARDS_PER_HAND)
+  {
+    if(ordered[0] - ordered[4] == CARDS_PER_HAND - 1)
+    {
+      straight = TRUE;
+      high = ordered[0];
+    }
+    else if((ordered[0] == 14) && (ordered[1] == 5) && (ordered[4] == 2))
+    {
+      straight = TRUE;
+      high = 5;
+    }
+  }
+
+  if(straight && flush)
+  {
+    category = StraightFlush;
+  }
+  else if(counts[ordered[0]] == QUAD)
+  {
+    category = FourOfAKind;
+  }
+  else if((counts[ordered[0]] == TRIPLE) && (counts[ordered[1]] == PAIR))
+  {
+    category = FullHouse;
+  }
+  else if(flush)
+  {
+    category = Flush;
+  }
+  else if(straight)
+  {
+    category = Straight;
+  }
+  else if(counts[ordered[0]] == TRIPLE)
+  {
+    category = ThreeOfAKind;
+  }
+  else if((counts[ordered[0]] == PAIR) && (counts[ordered[1]] == PAIR))
+  {
+    category = TwoPair;
+  }
+  else if(counts[ordered[0]] == PAIR)
+  {
+    category = Pair;
+  }
+
+  key = category;
+  if(straight)
+  {
+    return (key << 20) | ((unsigned long)high << 16);
+  }
+  for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    key <<= 4;
+    if(cardNum < numOrdered)
+    {
+      key |= ordered[cardNum];
+    }
+  }
+  return key;
+}
+
+/* Print a hand given by card indices */
+static void printIndexHand(const unsigned char cards[CARDS_PER_HAND])
+{
+  int cardNum = 0;
+  for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    printCardIndex(cards[cardNum]);
+    printf("  ");
+  }
+}
+
+/* Place a hand given by card indices into seat zero of a hands array */
+static void seatHand(card hands[CARDS_PER_HAND][MAX_PLAYERS],
+  const unsigned char cards[CARDS_PER_HAND])
+{
+  int cardNum = 0;
+  for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    indexToCard(cards[cardNum], & hands[cardNum][0]);
+  }
+}
+
+/*
+  Compare the three rankings of one hand. An optimized mismatch is printed,
+  a legacy deviation from the reference is tallied.
+*/
+static void compareHand(diffContext * context, diffResults * results,
+  const unsigned char cards[CARDS_PER_HAND], pokerRank legacyRank,
+  handStrength strength, unsigned long key)
+{
+  /* Number of tie-break values each category uses */
+  static const int valuesPerCategory[NUM_OF_HAND_RANKS] =
+  {
+    5, 4, 3, 3, 1, 5, 2, 2, 1
+  };
+  pokerRank referenceRank = (pokerRank)(key >> 20);
+  pokerRank optimizedRank = strengthCategory(strength);
+  unsigned long optimizedKey = optimizedRank;
+  int valueNum = 0;
+
+  /* Translate the optimized tie-break values into reference ranks */
+  for(valueNum = 0; valueNum < STRENGTH_VALUES; valueNum ++)
+  {
+    optimizedKey <<= 4;
+    if(valueNum < valuesPerCategory[optimizedRank])
+    {
+      optimizedKey |= ((strength >> ((STRENGTH_VALUES - 1 - valueNum) *
+        STRENGTH_VALUE_BITS)) & 0xF) + 2;
+    }
+  }
+  if(optimizedKey != key)
+  {
+    results->optimizedMismatches ++;
+    flockfile(stdout);
+    printf("MISMATCH hand ");
+    printIndexHand(cards);
+    printf(" optimized %06lx reference %06lx\n", optimizedKey, key);
+    funlockfile(stdout);
+  }
+  if(legacyRank != referenceRank)
+  {
+    if(results->legacyDeviations[referenceRank][legacyRank] == 0)
+    {
+      memcpy(results->legacyExamples[referenceRank][legacyRank], cards,
+        CARDS_PER_HAND);
+    }
+    results->legacyDeviations[referenceRank][legacyRank] ++;
+    if(context->verbose == TRUE)
+    {
+      flockfile(stdout);
+      printf("legacy deviation ");
+      printIndexHand(cards);
+      printf(" legacy %d reference %d\n", legacyRank, referenceRank);
+      funlockfile(stdout);
+    }
+  }
+}
+
+/*
+  Check every hand whose highest card is a given card index. The legacy and
+  optimized rankings are timed over the same list of hands.
+*/
+static void checkTopCard(diffContext * context, diffResults * results,
+  int topCard, unsigned char (* handList)[CARDS_PER_HAND],
+  pokerRank * legacyRanks, handStrength * strengths, handIndex * indices,
+  unsigned char (* unrankedList)[CARDS_PER_HAND])
+{
+  card hands[CARDS_PER_HAND][MAX_PLAYERS];
+  int multiplicity = 0;
+  int numOfHands = 0;
+  int handNum = 0;
+  int first = 0;
+  int second = 0;
+  int third = 0;
+  int fourth = 0;
+  double started = 0.0;
+
+  for(fourth = 3; fourth < topCard; fourth ++)
+  {
+    for(third = 2; third < fourth; third ++)
+    {
+      for(second = 1; second < third; second ++)
+      {
+        for(first = 0; first < second; first ++)
+        {
+          handList[numOfHands][0] = first;
+          handList[numOfHands][1] = second;
+          handList[numOfHands][2] = third;
+          handList[numOfHands][3] = fourth;
+          handList[numOfHands][4] = topCard;
+          numOfHands ++;
+        }
+      }
+    }
+  }
+
+  /* Unused seats stay sorted so the legacy sortHands has nothing to swap */
+  memset(hands, 0, sizeof(hands));
+  started = currentSeconds();
+  for(handNum = 0; handNum < numOfHands; handNum ++)
+  {
+    seatHand(hands, handList[handNum]);
+    legacyRanks[handNum] = assignRank(hands, 0);
+  }
+  results->legacySeconds += currentSeconds() - started;
+
+  started = currentSeconds();
+  for(handNum = 0; handNum < numOfHands; handNum ++)
+  {
+    strengths[handNum] = evaluateCardIndices(handList[handNum],
+      CARDS_PER_HAND);
+  }
+  results->optimizedSeconds += currentSeconds() - started;
+
+  /*
+    The hands were listed in colex order, so their indices have to count up
+    from C(topCard, 5) and unrank back to the same cards.
+  */
+  started = currentSeconds();
+  rankHandBatch((const unsigned char (*)[CARDS_PER_HAND])handList, indices,
+    numOfHands);
+  results->rankSeconds += currentSeconds() - started;
+  started = currentSeconds();
+  unrankHandBatch(indices, unrankedList, numOfHands);
+  results->unrankSeconds += currentSeconds() - started;
+  for(handNum = 0; handNum < numOfHands; handNum ++)
+  {
+    if((indices[handNum] != choose(topCard, CARDS_PER_HAND) + handNum) ||
+      (memcmp(unrankedList[handNum], handList[handNum], CARDS_PER_HAND) != 0))
+    {
+      results->optimizedMismatches ++;
+      flockfile(stdout);
+      printf("MISMATCH hand ");
+      printIndexHand(handList[handNum]);
+      printf(" colex index %u expected %llu\n", indices[handNum],
+        (unsigned long long)(choose(topCard, CARDS_PER_HAND) + handNum));
+      funlockfile(stdout);
+    }
+  }
+
+  for(handNum = 0; handNum < numOfHands; handNum ++)
+  {
+    compareHand(context, results, handList[handNum], legacyRanks[handNum],
+      strengths[handNum], referenceKey(handList[handNum]));
+  }
+
+  /*
+    Count the hands that are their own canonical form, weighted by their
+    multiplicity, and check that relabelling suits never changes a strength.
+  */
+  for(handNum = 0; handNum < numOfHands; handNum ++)
+  {
+    multiplicity = canonicalizeCards(handList[handNum], CARDS_PER_HAND, NULL,
+      0, unrankedList[handNum], NULL);
+    if(rankHandIndices(unrankedList[handNum]) == indices[handNum])
+    {
+      results->canonicalClasses ++;
+      results->canonicalWeight += multiplicity;
+    }
+    if(evaluateCardIndices(unrankedList[handNum], CARDS_PER_HAND) !=
+      strengths[handNum])
+    {
+      results->optimizedMismatches ++;
+      flockfile(stdout);
+      printf("MISMATCH hand ");
+      printIndexHand(handList[handNum]);
+      printf(" changes strength when its suits are relabelled\n");
+      funlockfile(stdout);
+    }
+  }
+  results->handsChecked += numOfHands;
+}
+
+/*
+  Check one randomly dealt table, seat by seat and then its winners, dealing
+  through the legacy createDeck and dealHands.
+*/
+static void checkTable(diffContext * context, diffResults * results,
+  long long tableNum)
+{
+  pokerRng rng;
+  card deck[STD_DECK_SIZE];
+  card hands[CARDS_PER_HAND][MAX_PLAYERS];
+  unsigned char order[STD_DECK_SIZE];
+  unsigned char seatCards[MAX_PLAYERS][CARDS_PER_HAND];
+  unsigned long keys[MAX_PLAYERS];
+  handStrength strengths[MAX_PLAYERS];
+  pokerRank legacyRanks[MAX_PLAYERS];
+  int legacyWinners[MAX_PLAYERS];
+  unsigned long bestKey = 0;
+  pokerRank bestRank = HighCard;
+  unsigned int referenceWinners = 0;
+  unsigned int optimizedWinners = 0;
+  int numOfHands = 0;
+  int playrNum = 0;
+  int cardNum = 0;
+
+  seedRng(& rng, context->seed, (uint64_t)tableNum);
+  numOfHands = MIN_PLAYERS + randomBounded(& rng, MAX_PLAYERS);
+  for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    order[cardNum] = cardNum;
+  }
+  shuffleCardIndices(& rng, order, STD_DECK_SIZE, STD_DECK_SIZE);
+  createDeck(deck);
+  for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    indexToCard(order[cardNum], & deck[cardNum]);
+  }
+  dealHands(deck, hands);
+
+  for(playrNum = 0; playrNum < numOfHands; playrNum ++)
+  {
+    for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+    {
+      seatCards[playrNum][cardNum] = cardToIndex(& hands[cardNum][playrNum]);
+    }
+    keys[playrNum] = referenceKey(seatCards[playrNum]);
+    strengths[playrNum] = evaluateCardIndices(seatCards[playrNum],
+      CARDS_PER_HAND);
+    legacyRanks[playrNum] = assignRank(hands, playrNum);
+    compareHand(context, results, seatCards[playrNum], legacyRanks[playrNum],
+      strengths[playrNum], keys[playrNum]);
+    if(keys[playrNum] > bestKey)
+    {
+      bestKey = keys[playrNum];
+    }
+    if((pokerRank)(keys[playrNum] >> 20) > bestRank)
+    {
+      bestRank = (pokerRank)(keys[playrNum] >> 20);
+    }
+  }
+
+  /* Optimized winners have to match the reference exactly */
+  for(playrNum = 0; playrNum < numOfHands; playrNum ++)
+  {
+    if(keys[playrNum] == bestKey)
+    {
+      referenceWinners |= 1u << playrNum;
+    }
+  }
+  optimizedWinners = findWinners(strengths, numOfHands);
+  if(optimizedWinners != referenceWinners)
+  {
+    results->optimizedMismatches ++;
+    flockfile(stdout);
+    printf("MISMATCH table %lld winners optimized %03x reference %03x\n",
+      tableNum, optimizedWinners, referenceWinners);
+    for(playrNum = 0; playrNum < numOfHands; playrNum ++)
+    {
+      printf("  seat %d ", playrNum + 1);
+      printIndexHand(seatCards[playrNum]);
+      printf("\n");
+    }
+    funlockfile(stdout);
+  }
+
+  /* Legacy winners only look at categories */
+  determineWinner(legacyWinners, hands, numOfHands);
+  for(playrNum = 0; playrNum < numOfHands; playrNum ++)
+  {
+    if
+    (
+      (legacyWinners[playrNum] > 0) !=
+      ((pokerRank)(keys[playrNum] >> 20) == bestRank)
+    )
+    {
+      results->legacyWinnerDeviations ++;
+      break;
+    }
+  }
+  results->tablesChecked ++;
+}
+
+/* Thread body, the exhaustive pass followed by a share of the fuzzed tables */
+static void diffWorker(void * contextPTR, int threadNum)
+{
+  diffContext * context = contextPTR;
+  diffResults * results = & context->results[threadNum];
+  unsigned char (* handList)[CARDS_PER_HAND] = NULL;
+  pokerRank * legacyRanks = NULL;
+  handStrength * strengths = NULL;
+  handIndex * indices = NULL;
+  unsigned char (* unrankedList)[CARDS_PER_HAND] = NULL;
+  int topCard = 0;
+  long long firstTable = 0;
+  long long tableNum = 0;
+
+  handList = malloc(sizeof(* handList) * MAX_HANDS_PER_TOP_CARD);
+  legacyRanks = malloc(sizeof(* legacyRanks) * MAX_HANDS_PER_TOP_CARD);
+  strengths = malloc(sizeof(* strengths) * MAX_HANDS_PER_TOP_CARD);
+  indices = malloc(sizeof(* indices) * MAX_HANDS_PER_TOP_CARD);
+  unrankedList = malloc(sizeof(* unrankedList) * MAX_HANDS_PER_TOP_CARD);
+  if((handList != NULL) && (legacyRanks != NULL) && (strengths != NULL) &&
+    (indices != NULL) && (unrankedList != NULL))
+  {
+    /* Largest groups first so the threads finish together */
+    while((topCard = atomic_fetch_sub(& context->nextTopCard, 1)) >=
+      CARDS_PER_HAND - 1)
+    {
+      checkTopCard(context, results, topCard, handList, legacyRanks,
+        strengths, indices, unrankedList);
+    }
+  }
+  else
+  {
+    results->optimizedMismatches ++;
+    printf("Thread %d could not allocate its hand list\n", threadNum);
+  }
+  free(handList);
+  free(legacyRanks);
+  free(strengths);
+  free(indices);
+  free(unrankedList);
+
+  while((firstTable = atomic_fetch_add(& context->nextTable,
+    TABLES_PER_CHUNK)) < context->numOfTables)
+  {
+    for(tableNum = firstTable; (tableNum < firstTable + TABLES_PER_CHUNK) &&
+      (tableNum < context->numOfTables); tableNum ++)
+    {
+      checkTable(context, results, tableNum);
+    }
+  }
+}
+
+/* Print the tallied legacy deviations, with an example hand for each */
+static void printLegacyDeviations(diffResults * total)
+{
+  int referenceRank = 0;
+  int legacyRank = 0;
+  unsigned long long deviations = 0;
+
+  printf("\nLegacy deviations from the reference (reference -> legacy):\n");
+  for(referenceRank = 0; referenceRank < NUM_OF_HAND_RANKS; referenceRank ++)
+  {
+    for(legacyRank = 0; legacyRank < NUM_OF_HAND_RANKS; legacyRank ++)
+    {
+      if(total->legacyDeviations[referenceRank][legacyRank] == 0)
+      {
+        continue;
+      }
+      deviations += total->legacyDeviations[referenceRank][legacyRank];
+      printf("  %-15s -> %-15s %10llu  e.g. ", handRanks[referenceRank],
+        handRanks[legacyRank],
+        total->legacyDeviations[referenceRank][legacyRank]);
+      printIndexHand(total->legacyExamples[referenceRank][legacyRank]);
+      printf("\n");
+    }
+  }
+  printf("  total %llu hands, %llu tables with different winners\n",
+    deviations, total->legacyWinnerDeviations);
+}
+
+/* Snapshot handler of the statistics check, counting the snapshots */
+static void countSnapshot(const pokerStats * stats, void * argument)
+{
+  (void)stats;
+  (* (int *)argument) ++;
+}
+
+/*
+  Function to check that simulation statistics do not depend on the number
+  of threads or on snapshots being taken, that their counters add up, and
+  to time the cost of gathering them.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkSimulationStats(uint64_t seed,
+  int numOfThreads)
+{
+  static pokerStats single;
+  static pokerStats threaded;
+  simulationConfig config;
+  unsigned long long mismatches = 0;
+  uint64_t seatTotal = 0;
+  double started = 0.0;
+  double withStats = 0.0;
+  double withoutStats = 0.0;
+  int numOfSnapshots = 0;
+  int playrNum = 0;
+  int rankNum = 0;
+
+  memset(& config, 0, sizeof(config));
+  config.numOfPlayers = STATS_PLAYERS;
+  config.numOfTables = STATS_TABLES;
+  config.seed = seed;
+  config.numOfThreads = 1;
+  config.recordStats = TRUE;
+  started = currentSeconds();
+  runSimulation(& config, & single);
+  withStats = currentSeconds() - started;
+
+  config.recordStats = FALSE;
+  started = currentSeconds();
+  runSimulation(& config, & threaded);
+  withoutStats = currentSeconds() - started;
+
+  config.recordStats = TRUE;
+  config.numOfThreads = numOfThreads + 1;
+  config.snapshotSeconds = 0.001;
+  config.snapshot = countSnapshot;
+  config.snapshotArgument = & numOfSnapshots;
+  runSimulation(& config, & threaded);
+
+  if(memcmp(& single, & threaded, sizeof(pokerStats)) != 0)
+  {
+    mismatches ++;
+    printf("MISMATCH statistics on %d threads differ from one thread\n",
+      numOfThreads + 1);
+  }
+  for(playrNum = 0; playrNum < STATS_PLAYERS; playrNum ++)
+  {
+    seatTotal = 0;
+    for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+    {
+      seatTotal += single.categoryBySeat[playrNum][rankNum];
+    }
+    if(seatTotal != single.tables)
+    {
+      mismatches ++;
+      printf("MISMATCH seat %d holds %llu hands in %llu tables\n",
+        playrNum + 1, (unsigned long long)seatTotal,
+        (unsigned long long)single.tables);
+    }
+  }
+  seatTotal = 0;
+  for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+  {
+    seatTotal += single.winsByCategory[rankNum] +
+      single.tiesByCategory[rankNum];
+  }
+  if((single.tables != STATS_TABLES) || (seatTotal != STATS_TABLES))
+  {
+    mismatches ++;
+    printf("MISMATCH %llu tables with %llu showdowns, expected %d\n",
+      (unsigned long long)single.tables, (unsigned long long)seatTotal,
+      STATS_TABLES);
+  }
+  printf("Statistics: identical on 1 and %d threads (%d snapshots), "
+    "gathering costs %.1f%% of throughput\n", numOfThreads + 1,
+    numOfSnapshots, (withStats - withoutStats) * 100.0 / withStats);
+  return mismatches;
+}
+
+/*
+  Checkpoint copy structure, the snapshot handler of the checkpoint check
+  saves the first checkpoint written to a second file so the run can be
+  resumed from it later.
+*/
+typedef struct checkpointCopy
+{
+  const char * path;
+  const char * copyPath;
+  bool copied;
+} checkpointCopy;
+
+/* Snapshot handler of the checkpoint check, copying a checkpoint once */
+static void copyCheckpoint(const pokerStats * stats, void * argument)
+{
+  checkpointCopy * copy = argument;
+  unsigned char buffer[BUFSIZ];
+  FILE * source = NULL;
+  FILE * target = NULL;
+  size_t numRead = 0;
+
+  (void)stats;
+  if(copy->copied == TRUE)
+  {
+    return;
+  }
+  source = fopen(copy->path, "rb");
+  if(source == NULL)
+  {
+    return;
+  }
+  target = fopen(copy->copyPath, "wb");
+  if(target != NULL)
+  {
+    while((numRead = fread(buffer, 1, sizeof(buffer), source)) > 0)
+    {
+      fwrite(buffer, 1, numRead, target);
+    }
+    copy->copied = (fclose(target) == 0) ? TRUE : FALSE;
+  }
+  fclose(source);
+}
+
+/*
+  Function to check that a simulation resumed from a checkpoint taken part
+  way through, on another number of threads, gives the same statistics as an
+  uninterrupted run, and that a checkpoint of another run is refused.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkCheckpointResume(uint64_t seed,
+  int numOfThreads)
+{
+  static pokerStats whole;
+  static pokerStats resumed;
+  char path[TEMP_PATH_SIZE];
+  char copyPath[TEMP_PATH_SIZE];
+  simulationConfig config;
+  checkpointCopy copy;
+  unsigned long long mismatches = 0;
+
+  snprintf(path, sizeof(path), "/tmp/pokerDiffCheck-%ld.ckpt",
+    (long)getpid());
+  snprintf(copyPath, sizeof(copyPath), "/tmp/pokerDiffCheck-%ld.mid",
+    (long)getpid());
+  copy.path = path;
+  copy.copyPath = copyPath;
+  copy.copied = FALSE;
+
+  memset(& config, 0, sizeof(config));
+  config.numOfPlayers = STATS_PLAYERS;
+  config.numOfTables = CHECKPOINT_TABLES;
+  config.seed = seed;
+  config.numOfThreads = numOfThreads;
+  config.recordStats = TRUE;
+  config.snapshotSeconds = CHECKPOINT_SNAPSHOT_SECONDS;
+  config.snapshot = copyCheckpoint;
+  config.snapshotArgument = & copy;
+  config.checkpoint.path = path;
+  config.checkpoint.seconds = CHECKPOINT_SECONDS;
+  if(runSimulation(& config, & whole) == FALSE)
+  {
+    mismatches ++;
+    printf("MISMATCH cannot write the checkpoint %s\n", path);
+  }
+
+  if(copy.copied == TRUE)
+  {
+    config.numOfThreads = numOfThreads + 1;
+    config.snapshot = NULL;
+    config.checkpoint.path = copyPath;
+    config.checkpoint.resume = TRUE;
+    if((runSimulation(& config, & resumed) == FALSE) ||
+      (memcmp(& whole, & resumed, sizeof(pokerStats)) != 0))
+    {
+      mismatches ++;
+      printf("MISMATCH statistics resumed on %d threads differ from an "
+        "uninterrupted run\n", numOfThreads + 1);
+    }
+  }
+  config.seed = seed + 1;
+  config.checkpoint.path = path;
+  config.checkpoint.resume = TRUE;
+  if(runSimulation(& config, & resumed) == TRUE)
+  {
+    mismatches ++;
+    printf("MISMATCH the checkpoint of seed %llu resumed a run of seed "
+      "%llu\n", (unsigned long long)seed, (unsigned long long)config.seed);
+  }
+  remove(path);
+  remove(copyPath);
+  printf("Checkpoints: %s\n", (copy.copied == TRUE) ?
+    "resumed part way through on another number of threads" :
+    "run too short to resume part way through");
+  return mismatches;
+}
+
+/*
+  Function to check that the pipeline deals the tables of the simulation in
+  order and finds their winners, by reading back its binary output.
+
+  Input   = {uint64_t: seed}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkPipeline(uint64_t seed)
+{
+  static pokerStats simulated;
+  static pokerStats piped;
+  static pipelineReport report;
+  simulationConfig simulation;
+  pipelineConfig config;
+  dealFileHeader header;
+  unsigned char cards[MAX_PLAYERS * CARDS_PER_HAND];
+  handStrength strengths[MAX_PLAYERS];
+  unsigned long long mismatches = 0;
+  unsigned int winners = 0;
+  uint64_t numRead = 0;
+  FILE * output = tmpfile();
+  int playrNum = 0;
+
+  if(output == NULL)
+  {
+    printf("MISMATCH cannot open a file for the pipeline\n");
+    return 1;
+  }
+  memset(& config, 0, sizeof(config));
+  config.numOfPlayers = STATS_PLAYERS;
+  config.numOfTables = PIPELINE_TABLES;
+  config.seed = seed;
+  config.numOfProducers = PIPELINE_PRODUCERS;
+  config.numOfEvaluators = PIPELINE_EVALUATORS;
+  config.format = DealBinary;
+  config.output = output;
+  if((runPipeline(& config, & report) == FALSE) || (report.written == FALSE))
+  {
+    printf("MISMATCH the pipeline did not run\n");
+    fclose(output);
+    return 1;
+  }
+
+  rewind(output);
+  clearStats(& piped);
+  if((readDealHeader(output, & header) == FALSE) ||
+    (header.numOfPlayers != STATS_PLAYERS) ||
+    (header.numOfTables != PIPELINE_TABLES) || (header.seed != seed))
+  {
+    mismatches ++;
+    printf("MISMATCH the pipeline wrote a bad header\n");
+  }
+  while((mismatches == 0) &&
+    (readDealRecord(output, & header, cards, & winners) == TRUE))
+  {
+    for(playrNum = 0; playrNum < STATS_PLAYERS; playrNum ++)
+    {
+      strengths[playrNum] = evaluateCardIndices(cards +
+        playrNum * CARDS_PER_HAND, CARDS_PER_HAND);
+    }
+    if(findWinners(strengths, STATS_PLAYERS) != winners)
+    {
+      mismatches ++;
+      printf("MISMATCH pipeline table %llu has winners %x\n",
+        (unsigned long long)numRead, winners);
+    }
+    recordTable(& piped, strengths, STATS_PLAYERS, winners);
+    numRead ++;
+  }
+  fclose(output);
+
+  memset(& simulation, 0, sizeof(simulation));
+  simulation.numOfPlayers = STATS_PLAYERS;
+  simulation.numOfTables = PIPELINE_TABLES;
+  simulation.seed = seed;
+  simulation.numOfThreads = 1;
+  simulation.recordStats = TRUE;
+  runSimulation(& simulation, & simulated);
+  if((numRead != PIPELINE_TABLES) ||
+    (memcmp(& simulated, & piped, sizeof(pokerStats)) != 0))
+  {
+    mismatches ++;
+    printf("MISMATCH the pipeline read back %llu tables unlike the "
+      "simulation's\n", (unsigned long long)numRead);
+  }
+  printf("Pipeline: %llu tables through %d producers and %d evaluators "
+    "match the simulation, writer starved %.0f%% of %.2f s\n",
+    (unsigned long long)numRead, PIPELINE_PRODUCERS, PIPELINE_EVALUATORS,
+    100.0 * report.writer.starved / report.writer.seconds, report.seconds);
+  return mismatches;
+}
+
+/*
+  Queries of the history index check, answered by queryMatches. The last is
+  HISTORY_DEEP_NEGATIONS negations of s1.won, written in when the check runs.
+*/
+static const char * historyQueries[HISTORY_QUERIES] =
+{
+  "s3.flush.lost", "!(s2.highcard) & s3.won",
+  "(s1.onepair | s2.onepair) - s3.lost", "s1.split | s4.split",
+  "all - s6.lost", "s2.twopairs & !s5.highcard & (s1.won | s6.split)", NULL
+};
+
+/*
+  Function to answer a query of the history index check directly from the
+  hand ranks and outcomes of one deal.
+
+  Input   = {int: queryNum, int *: categories, int *: outcomes}
+  Output  = {bool: matches}
+*/
+static bool queryMatches(int queryNum, const int * categories,
+  const int * outcomes)
+{
+  switch(queryNum)
+  {
+    case 0:
+      return ((categories[2] == Flush) && (outcomes[2] == OutcomeLost)) ?
+        TRUE : FALSE;
+    case 1:
+      return ((categories[1] != HighCard) && (outcomes[2] == OutcomeWon)) ?
+        TRUE : FALSE;
+    case 2:
+      return (((categories[0] == Pair) || (categories[1] == Pair)) &&
+        (outcomes[2] != OutcomeLost)) ? TRUE : FALSE;
+    case 3:
+      return ((outcomes[0] == OutcomeSplit) ||
+        (outcomes[3] == OutcomeSplit)) ? TRUE : FALSE;
+    case 4:
+      return (outcomes[5] != OutcomeLost) ? TRUE : FALSE;
+    case 5:
+      return ((categories[1] == TwoPair) && (categories[4] != HighCard) &&
+        ((outcomes[0] == OutcomeWon) || (outcomes[5] == OutcomeSplit))) ?
+        TRUE : FALSE;
+    default:
+      return (outcomes[0] != OutcomeWon) ? TRUE : FALSE;
+  }
+}
+
+/*
+  Function to check that the bitmap index of a deal file answers queries
+  with exactly the deals a scan of the file finds.
+
+  Input   = {uint64_t: seed}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkHistoryIndex(uint64_t seed)
+{
+  static pipelineReport report;
+  static uint32_t expected[HISTORY_QUERIES][HISTORY_DEALS];
+  static uint32_t found[HISTORY_DEALS];
+  static char deepQuery[HISTORY_DEEP_NEGATIONS + 2 *
+    HISTORY_DEEP_PARENTHESES + sizeof("s1.won")];
+  char dealPath[TEMP_PATH_SIZE];
+  char indexPath[TEMP_PATH_SIZE];
+  uint64_t numExpected[HISTORY_QUERIES];
+  pipelineConfig config;
+  dealFileHeader header;
+  historyIndex index;
+  roaringBitmap result;
+  unsigned char cards[MAX_PLAYERS * CARDS_PER_HAND];
+  handStrength strengths[MAX_PLAYERS];
+  int categories[MAX_PLAYERS];
+  int outcomes[MAX_PLAYERS];
+  unsigned long long mismatches = 0;
+  unsigned int winners = 0;
+  uint64_t numIndexed = 0;
+  uint64_t numFound = 0;
+  uint32_t dealNum = 0;
+  double started = 0.0;
+  double queryMillis = 0.0;
+  int queryNum = 0;
+  int playrNum = 0;
+  int errorAt = 0;
+  FILE * deals = NULL;
+
+  snprintf(dealPath, sizeof(dealPath), "/tmp/pokerDiffCheck-%ld.deals",
+    (long)getpid());
+  snprintf(indexPath, sizeof(indexPath), "/tmp/pokerDiffCheck-%ld.idx",
+    (long)getpid());
+  memset(& config, 0, sizeof(config));
+  config.numOfPlayers = STATS_PLAYERS;
+  config.numOfTables = HISTORY_DEALS;
+  config.seed = seed;
+  config.numOfProducers = 1;
+  config.numOfEvaluators = 1;
+  config.format = DealBinary;
+  config.output = fopen(dealPath, "wb");
+  if((config.output == NULL) || (runPipeline(& config, & report) == FALSE) ||
+    (fclose(config.output) != 0) ||
+    (buildHistoryIndex(dealPath, indexPath, & numIndexed) == FALSE) ||
+    (openHistoryIndex(& index, indexPath) == FALSE))
+  {
+    printf("MISMATCH cannot deal and index %s\n", dealPath);
+    remove(dealPath);
+    remove(indexPath);
+    return 1;
+  }
+
+  /* Deep negation is read in a loop, not one call per ! */
+  memset(deepQuery, '!', HISTORY_DEEP_NEGATIONS);
+  strcpy(deepQuery + HISTORY_DEEP_NEGATIONS, "s1.won");
+  historyQueries[HISTORY_QUERIES - 1] = deepQuery;
+
+  /* The answers a scan of the deal file gives */
+  memset(numExpected, 0, sizeof(numExpected));
+  deals = fopen(dealPath, "rb");
+  if((deals == NULL) || (readDealHeader(deals, & header) == FALSE))
+  {
+    mismatches ++;
+  }
+  for(dealNum = 0; (mismatches == 0) && (dealNum < HISTORY_DEALS);
+    dealNum ++)
+  {
+    if(readDealRecord(deals, & header, cards, & winners) == FALSE)
+    {
+      mismatches ++;
+      break;
+    }
+    for(playrNum = 0; playrNum < STATS_PLAYERS; playrNum ++)
+    {
+      strengths[playrNum] = evaluateCardIndices(cards +
+        playrNum * CARDS_PER_HAND, CARDS_PER_HAND);
+      categories[playrNum] = strengthCategory(strengths[playrNum]);
+      outcomes[playrNum] = (((winners >> playrNum) & 1u) == 0) ?
+        OutcomeLost : ((__builtin_popcount(winners) > 1) ? OutcomeSplit :
+        OutcomeWon);
+    }
+    for(queryNum = 0; queryNum < HISTORY_QUERIES; queryNum ++)
+    {
+      if(queryMatches(queryNum, categories, outcomes) == TRUE)
+      {
+        expected[queryNum][numExpected[queryNum] ++] = dealNum;
+      }
+    }
+  }
+  if(deals != NULL)
+  {
+    fclose(deals);
+  }
+
+  for(queryNum = 0; (mismatches == 0) && (queryNum < HISTORY_QUERIES);
+    queryNum ++)
+  {
+    started = currentSeconds();
+    if(queryHistoryIndex(& index, historyQueries[queryNum], & result,
+      & errorAt) == FALSE)
+    {
+      mismatches ++;
+      printf("MISMATCH cannot read query %d at %d\n", queryNum, errorAt);
+      continue;
+    }
+    queryMillis += (currentSeconds() - started) * 1e3;
+    numFound = bitmapIds(& result, found, HISTORY_DEALS);
+    if((bitmapCardinality(& result) != numExpected[queryNum]) ||
+      (numFound != numExpected[queryNum]) || (memcmp(found,
+      expected[queryNum], sizeof(uint32_t) * numFound) != 0))
+    {
+      mismatches ++;
+      printf("MISMATCH query %d found %llu deals, a scan %llu\n",
+        queryNum, (unsigned long long)numFound,
+        (unsigned long long)numExpected[queryNum]);
+    }
+    freeBitmap(& result);
+  }
+  if(queryHistoryIndex(& index, "s1.flush & s7", & result, & errorAt) ==
+    TRUE)
+  {
+    mismatches ++;
+    freeBitmap(& result);
+    printf("MISMATCH a query of seat 7 of 6 was answered\n");
+  }
+
+  /* Parentheses nested past the limit are refused */
+  memset(deepQuery, '(', HISTORY_DEEP_PARENTHESES);
+  strcpy(deepQuery + HISTORY_DEEP_PARENTHESES, "s1.won");
+  memset(deepQuery + HISTORY_DEEP_PARENTHESES + strlen("s1.won"), ')',
+    HISTORY_DEEP_PARENTHESES);
+  deepQuery[2 * HISTORY_DEEP_PARENTHESES + strlen("s1.won")] = '\0';
+  if(queryHistoryIndex(& index, deepQuery, & result, & errorAt) == TRUE)
+  {
+    mismatches ++;
+    freeBitmap(& result);
+    printf("MISMATCH a query nested %d deep was answered\n",
+      HISTORY_DEEP_PARENTHESES);
+  }
+  deepQuery[2 * HISTORY_DEEP_PARENTHESES + strlen("s1.won") - 1] = '\0';
+  if(queryHistoryIndex(& index, deepQuery + 1, & result, & errorAt) == FALSE)
+  {
+    mismatches ++;
+    printf("MISMATCH a query nested %d deep was refused\n",
+      HISTORY_DEEP_PARENTHESES - 1);
+  }
+  else
+  {
+    freeBitmap(& result);
+  }
+  closeHistoryIndex(& index);
+  remove(dealPath);
+  remove(indexPath);
+  printf("History index: %d queries over %llu deals match a scan, "
+    "%.3f ms in all\n", HISTORY_QUERIES, (unsigned long long)numIndexed,
+    queryMillis);
+  return mismatches;
+}
+
+/*
+  Function to check the closed form card removal counts against ranking
+  every five card hand of the unseen cards, for seen sets of several sizes
+  dealt at random.
+
+  Input   = {uint64_t: seed}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkCardRemoval(uint64_t seed)
+{
+  const int seenSizes[REMOVAL_SETS] = {0, 2, 5, 7, 12, 21, 33, 47};
+  const unsigned char repeated[2] = {7, 7};
+  unsigned long long enumerated[NUM_OF_HAND_RANKS];
+  unsigned char deck[STD_DECK_SIZE];
+  unsigned char positions[CARDS_PER_HAND];
+  unsigned char cards[CARDS_PER_HAND];
+  removalOdds odds;
+  pokerRng rng;
+  unsigned long long mismatches = 0;
+  unsigned long long hands = 0;
+  double formSeconds = 0.0;
+  double started = 0.0;
+  int setNum = 0;
+  int numOfSeen = 0;
+  int cardNum = 0;
+  int category = 0;
+
+  seedRng(& rng, seed, 4);
+  for(setNum = 0; setNum < REMOVAL_SETS; setNum ++)
+  {
+    numOfSeen = seenSizes[setNum];
+    for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+    {
+      deck[cardNum] = cardNum;
+    }
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE, numOfSeen);
+    started = currentSeconds();
+    if(cardRemovalOdds(deck, numOfSeen, & odds) == FALSE)
+    {
+      mismatches ++;
+      printf("MISMATCH card removal refused %d seen cards\n", numOfSeen);
+      continue;
+    }
+    formSeconds += currentSeconds() - started;
+
+    memset(enumerated, 0, sizeof(enumerated));
+    for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+    {
+      positions[cardNum] = cardNum;
+    }
+    hands = 0;
+    do
+    {
+      for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        cards[cardNum] = deck[numOfSeen + positions[cardNum]];
+      }
+      enumerated[strengthCategory(evaluateCardIndices(cards,
+        CARDS_PER_HAND))] ++;
+      hands ++;
+    } while(nextCombination(positions, CARDS_PER_HAND,
+      STD_DECK_SIZE - numOfSeen) == TRUE);
+
+    if(hands != odds.numOfHands)
+    {
+      mismatches ++;
+      printf("MISMATCH %d seen cards leave %llu hands, not %llu\n",
+        numOfSeen, hands, (unsigned long long)odds.numOfHands);
+    }
+    for(category = 0; category < NUM_OF_HAND_RANKS; category ++)
+    {
+      if(enumerated[category] != odds.counts[category])
+      {
+        mismatches ++;
+        printf("MISMATCH %d seen cards: %llu hands of %s, counted %llu\n",
+          numOfSeen, enumerated[category], handRanks[category],
+          (unsigned long long)odds.counts[category]);
+      }
+    }
+  }
+  if(cardRemovalOdds(repeated, 2, & odds) == TRUE)
+  {
+    mismatches ++;
+    printf("MISMATCH card removal accepted a repeated card\n");
+  }
+  printf("Card removal: %d seen sets match enumeration, %.2f us per set\n",
+    REMOVAL_SETS, formSeconds * 1e6 / REMOVAL_SETS);
+  return mismatches;
+}
+
+/*
+  Function to find the best hand wild cards complete by trying every card
+  for each of them, a card already held included, five of a rank being five
+  of a kind.
+
+  Input   = {unsigned char *: naturals, int: numOfNatural}
+  Output  = {handStrength: strength}
+*/
+static handStrength substituteWildCards(const unsigned char * naturals,
+  int numOfNatural)
+{
+  const int numOfWild = CARDS_PER_HAND - numOfNatural;
+  unsigned char positions[CARDS_PER_HAND];
+  unsigned char cards[CARDS_PER_HAND];
+  handStrength best = 0;
+  handStrength strength = 0;
+  int cardNum = 0;
+  int sameRank = 0;
+
+  memcpy(cards, naturals, numOfNatural);
+  for(cardNum = 0; cardNum < numOfWild; cardNum ++)
+  {
+    positions[cardNum] = cardNum;
+  }
+  do
+  {
+    for(cardNum = 0; cardNum < numOfWild; cardNum ++)
+    {
+      cards[numOfNatural + cardNum] = positions[cardNum] - cardNum;
+    }
+    sameRank = 0;
+    for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+    {
+      sameRank += (cardIndexRank(cards[cardNum]) == cardIndexRank(cards[0]));
+    }
+    strength = (sameRank == CARDS_PER_HAND) ?
+      (((handStrength)FIVE_OF_A_KIND << STRENGTH_CATEGORY_SHIFT) |
+      ((handStrength)cardIndexValue[cards[0]] <<
+      ((STRENGTH_VALUES - 1) * STRENGTH_VALUE_BITS))) :
+      evaluateCardIndices(cards, CARDS_PER_HAND);
+    best = (strength > best) ? strength : best;
+  } while(nextCombination(positions, numOfWild,
+    STD_DECK_SIZE + numOfWild - 1) == TRUE);
+  return best;
+}
+
+/*
+  Function to check the wild card tables: every deuces wild hand is ranked
+  and the categories counted against the published counts, and hands of a
+  joker deck with deuces wild are compared with trying every substitution.
+
+  Input   = {uint64_t: seed}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkWildCards(uint64_t seed)
+{
+  const unsigned long long deucesCounts[NUM_OF_WILD_HAND_RANKS] = {799680,
+    1225008, 95040, 355080, 62232, 14472, 12672, 31552, 2552, 672};
+  const int checkedHands[MAX_CHECKED_WILDS + 1] = {0, 3000, 1000, 100, 10};
+  const unsigned char wildCards[CARDS_PER_HAND] = {JOKER_INDEX, 4, 5, 6, 7};
+  unsigned long long counts[NUM_OF_WILD_HAND_RANKS];
+  unsigned char naturals[STD_DECK_SIZE - NUM_OF_SUITS];
+  unsigned char positions[CARDS_PER_HAND] = {0, 1, 2, 3, 4};
+  unsigned char cards[CARDS_PER_HAND];
+  wildConfig config;
+  pokerRng rng;
+  unsigned long long mismatches = 0;
+  handStrength expected = 0;
+  handStrength found = 0;
+  int numOfWild = 0;
+  int handNum = 0;
+  int cardNum = 0;
+  int category = 0;
+
+  if(prepareWildTables() == FALSE)
+  {
+    printf("MISMATCH the wild tables cannot be built\n");
+    return 1;
+  }
+  parseWildConfig("deuces", & config);
+  memset(counts, 0, sizeof(counts));
+  do
+  {
+    counts[evaluateWildHand(positions, & config) >>
+      STRENGTH_CATEGORY_SHIFT] ++;
+  } while(nextCombination(positions, CARDS_PER_HAND, STD_DECK_SIZE) == TRUE);
+  for(category = 0; category < NUM_OF_WILD_HAND_RANKS; category ++)
+  {
+    if(counts[category] != deucesCounts[category])
+    {
+      mismatches ++;
+      printf("MISMATCH deuces wild deals %llu hands of %s, not %llu\n",
+        counts[category], wildCategoryName(category),
+        deucesCounts[category]);
+    }
+  }
+
+  /* Natural cards are the 48 that are not Twos, dealt after the wild ones */
+  parseWildConfig("joker,deuces", & config);
+  seedRng(& rng, seed, 5);
+  for(numOfWild = 1; numOfWild <= MAX_CHECKED_WILDS; numOfWild ++)
+  {
+    for(handNum = 0; handNum < checkedHands[numOfWild]; handNum ++)
+    {
+      memcpy(cards, wildCards, CARDS_PER_HAND);
+      shuffleCardIndices(& rng, cards, CARDS_PER_HAND, numOfWild);
+      for(cardNum = 0; cardNum < STD_DECK_SIZE - NUM_OF_SUITS; cardNum ++)
+      {
+        naturals[cardNum] = (cardNum < NUM_OF_SUITS) ? cardNum :
+          cardNum + NUM_OF_SUITS;
+      }
+      shuffleCardIndices(& rng, naturals, STD_DECK_SIZE - NUM_OF_SUITS,
+        CARDS_PER_HAND - numOfWild);
+      memcpy(cards + numOfWild, naturals, CARDS_PER_HAND - numOfWild);
+      expected = substituteWildCards(naturals, CARDS_PER_HAND - numOfWild);
+      found = evaluateWildHand(cards, & config);
+      if(found != expected)
+      {
+        mismatches ++;
+        printf("MISMATCH wild hand ");
+        for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+        {
+          printf("%d ", cards[cardNum]);
+        }
+        printf("strength %x, substitution %x\n", found, expected);
+      }
+    }
+  }
+  printf("Wild cards: deuces wild counts match, %d hands with 1 to %d wild "
+    "cards match substitution\n", checkedHands[1] + checkedHands[2] +
+    checkedHands[3] + checkedHands[4], MAX_CHECKED_WILDS);
+  return mismatches;
+}
+
+/*
+  Function to check the percentile table: odds against one opponent have to
+  match enumerating every opponent hand for hands dealt at random, wins and
+  losses against one opponent have to balance over all hands, and the mean
+  odds against 1 to MAX_OPPONENTS opponents have to agree with simulated
+  deals.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkHandPercentile(uint64_t seed,
+  int numOfThreads)
+{
+  const double opponentHands = (double)choose(STD_DECK_SIZE - CARDS_PER_HAND,
+    CARDS_PER_HAND);
+  const canonicalClass * classes = NULL;
+  char path[TEMP_PATH_SIZE];
+  unsigned long long dealtWins[MAX_OPPONENTS];
+  double tableWins[MAX_OPPONENTS];
+  unsigned char deck[STD_DECK_SIZE];
+  unsigned char positions[CARDS_PER_HAND];
+  unsigned char cards[CARDS_PER_HAND];
+  percentileBuild build;
+  percentileTable table;
+  percentileOdds odds;
+  pokerRng rng;
+  unsigned long long mismatches = 0;
+  unsigned long long wins = 0;
+  unsigned long long ties = 0;
+  unsigned long long rising = 0;
+  const percentileOdds * classOdds = NULL;
+  handStrength strength = 0;
+  handStrength opponent = 0;
+  handStrength best = 0;
+  double meanTie = 0.0;
+  double started = 0.0;
+  double buildSeconds = 0.0;
+  int numOfClasses = 0;
+  int classNum = 0;
+  int handNum = 0;
+  int cardNum = 0;
+  int opponentNum = 0;
+
+  snprintf(path, sizeof(path), "/tmp/pokerDiffCheck-%ld.pctl",
+    (long)getpid());
+  build.samples = PERCENTILE_SAMPLES;
+  build.seed = seed;
+  build.numOfThreads = numOfThreads;
+  started = currentSeconds();
+  if((buildPercentileTable(path, & build) == FALSE) ||
+    (openPercentileTable(& table, path) == FALSE))
+  {
+    remove(path);
+    printf("MISMATCH the percentile table cannot be built\n");
+    return 1;
+  }
+  buildSeconds = currentSeconds() - started;
+
+  /* The hand is dealt first, its opponents are enumerated from the rest */
+  seedRng(& rng, seed, 6);
+  for(handNum = 0; handNum < PERCENTILE_HANDS; handNum ++)
+  {
+    for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+    {
+      deck[cardNum] = cardNum;
+    }
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE, CARDS_PER_HAND);
+    strength = evaluateCardIndices(deck, CARDS_PER_HAND);
+    for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+    {
+      positions[cardNum] = cardNum;
+    }
+    wins = 0;
+    ties = 0;
+    do
+    {
+      for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        cards[cardNum] = deck[CARDS_PER_HAND + positions[cardNum]];
+      }
+      opponent = evaluateCardIndices(cards, CARDS_PER_HAND);
+      wins += (strength > opponent);
+      ties += (strength == opponent);
+    } while(nextCombination(positions, CARDS_PER_HAND,
+      STD_DECK_SIZE - CARDS_PER_HAND) == TRUE);
+    odds = lookupPercentile(& table, deck, 1);
+    if((fabs(odds.win - wins / opponentHands) > 0.5 / opponentHands) ||
+      (fabs(odds.tie - ties / opponentHands) > 0.5 / opponentHands))
+    {
+      mismatches ++;
+      printf("MISMATCH percentile of ");
+      printIndexHand(deck);
+      printf(" win %.7f tie %.7f, enumerated %.7f %.7f\n", odds.win,
+        odds.tie, wins / opponentHands, ties / opponentHands);
+    }
+  }
+
+  classes = canonicalFiveCardClasses(& numOfClasses);
+  memset(tableWins, 0, sizeof(tableWins));
+  for(classNum = 0; classNum < numOfClasses; classNum ++)
+  {
+    classOdds = table.odds + classNum * MAX_OPPONENTS;
+    for(opponentNum = 0; opponentNum < MAX_OPPONENTS; opponentNum ++)
+    {
+      tableWins[opponentNum] += classes[classNum].multiplicity *
+        classOdds[opponentNum].win;
+      /* Another opponent never makes a win or a tie more likely */
+      rising += (opponentNum > 0) && ((classOdds[opponentNum].win >
+        classOdds[opponentNum - 1].win + 1e-6f) ||
+        (classOdds[opponentNum].win + classOdds[opponentNum].tie >
+        classOdds[opponentNum - 1].win + classOdds[opponentNum - 1].tie +
+        1e-6f));
+    }
+    meanTie += classes[classNum].multiplicity *
+      table.odds[classNum * MAX_OPPONENTS].tie;
+  }
+  for(opponentNum = 0; opponentNum < MAX_OPPONENTS; opponentNum ++)
+  {
+    tableWins[opponentNum] /= NUM_OF_FIVE_CARD_HANDS;
+  }
+  meanTie /= NUM_OF_FIVE_CARD_HANDS;
+  if((rising > 0) || (table.header->standardError <= 0.0) ||
+    (table.header->standardError > 0.5))
+  {
+    mismatches ++;
+    printf("MISMATCH %llu odds rise with the opponents, standard error "
+      "%.4f\n", rising, table.header->standardError);
+  }
+  if(fabs(tableWins[0] - (1.0 - meanTie) / 2.0) > 1e-6)
+  {
+    mismatches ++;
+    printf("MISMATCH mean win %.7f against one opponent, ties %.7f\n",
+      tableWins[0], meanTie);
+  }
+
+  /* Wins of the first hand of a full table against the next k */
+  memset(dealtWins, 0, sizeof(dealtWins));
+  seedRng(& rng, seed, 7);
+  for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    deck[cardNum] = cardNum;
+  }
+  for(handNum = 0; handNum < PERCENTILE_DEALS; handNum ++)
+  {
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE,
+      MAX_PLAYERS * CARDS_PER_HAND);
+    strength = evaluateCardIndices(deck, CARDS_PER_HAND);
+    best = 0;
+    for(opponentNum = 0; opponentNum < MAX_OPPONENTS; opponentNum ++)
+    {
+      opponent = evaluateCardIndices(deck + (opponentNum + 1) *
+        CARDS_PER_HAND, CARDS_PER_HAND);
+      best = (opponent > best) ? opponent : best;
+      dealtWins[opponentNum] += (best < strength);
+    }
+  }
+  for(opponentNum = 0; opponentNum < MAX_OPPONENTS; opponentNum ++)
+  {
+    if(fabs(tableWins[opponentNum] - (double)dealtWins[opponentNum] /
+      PERCENTILE_DEALS) > PERCENTILE_TOLERANCE)
+    {
+      mismatches ++;
+      printf("MISMATCH mean win %.4f against %d opponents, %.4f dealt\n",
+        tableWins[opponentNum], opponentNum + 1,
+        (double)dealtWins[opponentNum] / PERCENTILE_DEALS);
+    }
+  }
+  closePercentileTable(& table);
+  remove(path);
+  printf("Hand percentile: built in %.1f s, %d hands match enumeration, "
+    "mean wins against 1 to %d opponents match %d deals\n", buildSeconds,
+    PERCENTILE_HANDS, MAX_OPPONENTS, PERCENTILE_DEALS);
+  return mismatches;
+}
+
+/*
+  Function to rank five cards of a shoe by the plain rules, values from 0
+  for a Two to 12 for an Ace: five of a rank is five of a kind, above a
+  straight flush, and five cards of one suit are a flush unless they make
+  a straight flush, four of a kind or a full house.
+  The values of a flush and of a high card are the cards' values, highest
+  first; the other categories give no values.
+
+  Input   = {unsigned char *: cards}
+  Output  = {handStrength: strength}
+*/
+static handStrength referenceShoeStrength(const unsigned char * cards)
+{
+  int counts[NUM_OF_RANKS];
+  int values[CARDS_PER_HAND];
+  int largest = 0;
+  int pairs = 0;
+  int cardNum = 0;
+  int other = 0;
+  int swap = 0;
+  int rankNum = 0;
+  bool oneSuit = TRUE;
+  bool straight = FALSE;
+  pokerRank category = HighCard;
+  handStrength strength = 0;
+
+  memset(counts, 0, sizeof(counts));
+  for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    counts[cardIndexRank(cards[cardNum])] ++;
+    values[cardNum] = referenceValue(cards[cardNum]) - 2;
+    if(cardIndexSuit(cards[cardNum]) != cardIndexSuit(cards[0]))
+    {
+      oneSuit = FALSE;
+    }
+  }
+  for(rankNum = 0; rankNum < NUM_OF_RANKS; rankNum ++)
+  {
+    largest = (counts[rankNum] > largest) ? counts[rankNum] : largest;
+    pairs += (counts[rankNum] == PAIR);
+  }
+  if(largest == CARDS_PER_HAND)
+  {
+    return ((handStrength)FIVE_OF_A_KIND << STRENGTH_CATEGORY_SHIFT) |
+      ((handStrength)values[0] << ((STRENGTH_VALUES - 1) *
+      STRENGTH_VALUE_BITS));
+  }
+  /* Sort the values, highest first */
+  for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    for(other = cardNum + 1; other < CARDS_PER_HAND; other ++)
+    {
+      if(values[other] > values[cardNum])
+      {
+        swap = values[cardNum];
+        values[cardNum] = values[other];
+        values[other] = swap;
+      }
+    }
+  }
+  if(largest == 1)
+  {
+    straight = ((values[0] - values[4] == 4) || ((values[0] == 12) &&
+      (values[1] == 3))) ? TRUE : FALSE;
+  }
+  if((oneSuit == TRUE) && (straight == TRUE))
+  {
+    category = StraightFlush;
+  }
+  else if(largest == QUAD)
+  {
+    category = FourOfAKind;
+  }
+  else if((largest == TRIPLE) && (pairs == 1))
+  {
+    category = FullHouse;
+  }
+  else if(oneSuit == TRUE)
+  {
+    category = Flush;
+  }
+  else if(straight == TRUE)
+  {
+    category = Straight;
+  }
+  else if(largest == TRIPLE)
+  {
+    category = ThreeOfAKind;
+  }
+  else if(pairs == 2)
+  {
+    category = TwoPair;
+  }
+  else if(pairs == 1)
+  {
+    category = Pair;
+  }
+  strength = (handStrength)category << STRENGTH_CATEGORY_SHIFT;
+  if((category == Flush) || (category == HighCard))
+  {
+    for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+    {
+      strength |= (handStrength)values[cardNum] <<
+        ((STRENGTH_VALUES - 1 - cardNum) * STRENGTH_VALUE_BITS);
+    }
+  }
+  return strength;
+}
+
+/*
+  Function to compare the strength of five cards of a shoe with the plain
+  rules, the values only where the rules give them.
+
+  Input   = {unsigned char *: cards}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long compareShoeHand(const unsigned char * cards)
+{
+  const handStrength found = evaluateShoeHand(cards);
+  const handStrength expected = referenceShoeStrength(cards);
+  const int category = found >> STRENGTH_CATEGORY_SHIFT;
+  bool valued = ((category == Flush) || (category == HighCard) ||
+    (category == FIVE_OF_A_KIND)) ? TRUE : FALSE;
+
+  if((category == (int)(expected >> STRENGTH_CATEGORY_SHIFT)) &&
+    ((valued == FALSE) || (found == expected)))
+  {
+    return 0;
+  }
+  printf("MISMATCH shoe hand ");
+  printIndexHand(cards);
+  printf(" strength %x, rules %x\n", found, expected);
+  return 1;
+}
+
+/*
+  Function to check the dynamic tables: every hand of one deck has to rank
+  as evaluateCardIndices ranks it, hands of a shoe, some of one suit so
+  that repeated cards make flushes, have to follow the plain rules, and
+  tables dealt from a shoe have to deal no card more often than the shoe
+  holds it and mark the strongest seats.
+
+  Input   = {uint64_t: seed}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkDynamicTable(uint64_t seed)
+{
+  unsigned char positions[CARDS_PER_HAND] = {0, 1, 2, 3, 4};
+  unsigned char suited[SHOE_DECKS * NUM_OF_RANKS];
+  int dealt[STD_DECK_SIZE];
+  dynamicTable table;
+  pokerRng rng;
+  unsigned long long mismatches = 0;
+  unsigned long long fiveOfAKinds = 0;
+  unsigned long long repeatedFlushes = 0;
+  handStrength best = 0;
+  handStrength strength = 0;
+  int numOfWinners = 0;
+  int marked = 0;
+  int handNum = 0;
+  int cardNum = 0;
+  int seatNum = 0;
+
+  do
+  {
+    if(evaluateShoeHand(positions) != evaluateCardIndices(positions,
+      CARDS_PER_HAND))
+    {
+      mismatches ++;
+      printf("MISMATCH shoe strength of ");
+      printIndexHand(positions);
+      printf("\n");
+    }
+  } while(nextCombination(positions, CARDS_PER_HAND, STD_DECK_SIZE) == TRUE);
+
+  if(createDynamicTable(& table, SHOE_SEATS, SHOE_DECKS) == FALSE)
+  {
+    printf("MISMATCH a table of %d seats and %d decks cannot be created\n",
+      SHOE_SEATS, SHOE_DECKS);
+    return mismatches + 1;
+  }
+  seedRng(& rng, seed, 8);
+  for(handNum = 0; handNum < SHOE_HANDS; handNum ++)
+  {
+    shuffleCardIndices(& rng, table.shoe, table.shoeSize, CARDS_PER_HAND);
+    mismatches += compareShoeHand(table.shoe);
+    fiveOfAKinds += (evaluateShoeHand(table.shoe) >>
+      STRENGTH_CATEGORY_SHIFT) == FIVE_OF_A_KIND;
+  }
+  for(cardNum = 0; cardNum < SHOE_DECKS * NUM_OF_RANKS; cardNum ++)
+  {
+    suited[cardNum] = makeCardIndex(cardNum % NUM_OF_RANKS, S);
+  }
+  for(handNum = 0; handNum < SHOE_SUITED_HANDS; handNum ++)
+  {
+    shuffleCardIndices(& rng, suited, SHOE_DECKS * NUM_OF_RANKS,
+      CARDS_PER_HAND);
+    mismatches += compareShoeHand(suited);
+    strength = evaluateShoeHand(suited);
+    /* evaluateCardIndices counts a repeated card once towards a flush */
+    repeatedFlushes += (strengthCategory(strength) == Flush) &&
+      (strengthCategory(evaluateCardIndices(suited, CARDS_PER_HAND)) !=
+      Flush);
+  }
+
+  for(handNum = 0; handNum < SHOE_TABLES; handNum ++)
+  {
+    dealDynamicTable(& table, & rng);
+    sortDynamicHands(& table);
+    numOfWinners = evaluateDynamicTable(& table);
+    memset(dealt, 0, sizeof(dealt));
+    best = 0;
+    marked = 0;
+    for(seatNum = 0; seatNum < SHOE_SEATS; seatNum ++)
+    {
+      for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        dealt[table.hands[seatNum * CARDS_PER_HAND + cardNum]] ++;
+        if((cardNum > 0) && (table.hands[seatNum * CARDS_PER_HAND +
+          cardNum] < table.hands[seatNum * CARDS_PER_HAND + cardNum - 1]))
+        {
+          mismatches ++;
+          printf("MISMATCH seat %d of shoe table %d is not sorted\n",
+            seatNum, handNum);
+        }
+      }
+      if(table.strengths[seatNum] != evaluateShoeHand(table.hands +
+        seatNum * CARDS_PER_HAND))
+      {
+        mismatches ++;
+        printf("MISMATCH seat %d of shoe table %d has strength %x\n",
+          seatNum, handNum, table.strengths[seatNum]);
+      }
+      best = (table.strengths[seatNum] > best) ? table.strengths[seatNum] :
+        best;
+    }
+    for(seatNum = 0; seatNum < SHOE_SEATS; seatNum ++)
+    {
+      marked += table.winners[seatNum];
+      if(table.winners[seatNum] != (table.strengths[seatNum] == best))
+      {
+        mismatches ++;
+        printf("MISMATCH seat %d of shoe table %d is marked %d\n", seatNum,
+          handNum, table.winners[seatNum]);
+      }
+    }
+    for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+    {
+      if(dealt[cardNum] > SHOE_DECKS)
+      {
+        mismatches ++;
+        printf("MISMATCH shoe table %d deals card %d %d times\n", handNum,
+          cardNum, dealt[cardNum]);
+      }
+    }
+    if(marked != numOfWinners)
+    {
+      mismatches ++;
+      printf("MISMATCH shoe table %d marks %d winners, not %d\n", handNum,
+        marked, numOfWinners);
+    }
+  }
+  freeDynamicTable(& table);
+  printf("Dynamic tables: every standard hand, %d shoe hands with %llu five "
+    "of a kinds and %d suited ones with %llu repeated card flushes match "
+    "the rules, %d tables of %d seats\n", SHOE_HANDS, fiveOfAKinds,
+    SHOE_SUITED_HANDS, repeatedFlushes, SHOE_TABLES, SHOE_SEATS);
+  return mismatches;
+}
+
+/*
+  Function to find, deal by deal, what a player gains against the average
+  strategy of a solver: the chance each deal reaches every node through
+  the other player's choices is carried down the tree, then values are
+  summed up it, the player choosing for each of their bucket prefixes the
+  action best over all deals sharing it, or following the average strategy
+  when best is FALSE. Children come after their parents in the tree.
+
+  Input   = {cfrSolver *: solver, int: responder, bool: best,
+            double *: reach, double *: values}
+  Output  = {double: value}
+*/
+static double dealResponse(const cfrSolver * solver, int responder,
+  bool best, double * reach, double * values)
+{
+  const int numOfDeals = solver->config.numOfDeals;
+  const uint32_t mask = (1U << CFR_SEQUENCE_BITS) - 1;
+  double probabilities[CFR_MAX_ACTIONS];
+  double totals[MAX_CFR_BUCKETS * MAX_CFR_BUCKETS * MAX_CFR_BUCKETS]
+    [CFR_MAX_ACTIONS];
+  const cfrNode * node = NULL;
+  uint32_t deal = 0;
+  double value = 0.0;
+  int nodeNum = 0;
+  int dealNum = 0;
+  int actionNum = 0;
+  int prefix = 0;
+  int chosen = 0;
+  int outcome = 0;
+
+  for(dealNum = 0; dealNum < numOfDeals; dealNum ++)
+  {
+    reach[dealNum] = 1.0;
+  }
+  for(nodeNum = 0; nodeNum < solver->numOfNodes; nodeNum ++)
+  {
+    node = & solver->nodes[nodeNum];
+    for(actionNum = 0; (node->type == CFR_DECISION_NODE) &&
+      (actionNum < node->numOfActions); actionNum ++)
+    {
+      for(dealNum = 0; dealNum < numOfDeals; dealNum ++)
+      {
+        deal = solver->deals[dealNum];
+        cfrAverageStrategy(solver, nodeNum, ((deal >> (node->player *
+          CFR_SEQUENCE_BITS)) & mask) / solver->divisors[node->street],
+          probabilities);
+        reach[(size_t)node->children[actionNum] * numOfDeals + dealNum] =
+          reach[(size_t)nodeNum * numOfDeals + dealNum] *
+          ((node->player == responder) ? 1.0 : probabilities[actionNum]);
+      }
+    }
+  }
+  for(nodeNum = solver->numOfNodes - 1; nodeNum >= 0; nodeNum --)
+  {
+    node = & solver->nodes[nodeNum];
+    memset(totals, 0, sizeof(totals));
+    for(dealNum = 0; dealNum < numOfDeals; dealNum ++)
+    {
+      deal = solver->deals[dealNum];
+      outcome = (int)(deal >> (2 * CFR_SEQUENCE_BITS)) - 1;
+      value = 0.0;
+      if(node->type == CFR_FOLD_NODE)
+      {
+        value = (node->player == responder) ? -node->contribution :
+          node->contribution;
+      }
+      else if(node->type == CFR_SHOWDOWN_NODE)
+      {
+        value = node->contribution * outcome * ((responder == 0) ? 1 : -1);
+      }
+      if(node->type != CFR_DECISION_NODE)
+      {
+        values[(size_t)nodeNum * numOfDeals + dealNum] = value * reach[
+          (size_t)nodeNum * numOfDeals + dealNum] / numOfDeals;
+        continue;
+      }
+      prefix = ((deal >> (node->player * CFR_SEQUENCE_BITS)) & mask) /
+        solver->divisors[node->street];
+      for(actionNum = 0; actionNum < node->numOfActions; actionNum ++)
+      {
+        totals[prefix][actionNum] += values[(size_t)node->children[
+          actionNum] * numOfDeals + dealNum];
+      }
+    }
+    for(dealNum = 0; (node->type == CFR_DECISION_NODE) &&
+      (dealNum < numOfDeals); dealNum ++)
+    {
+      deal = solver->deals[dealNum];
+      prefix = ((deal >> (node->player * CFR_SEQUENCE_BITS)) & mask) /
+        solver->divisors[node->street];
+      cfrAverageStrategy(solver, nodeNum, prefix, probabilities);
+      chosen = 0;
+      for(actionNum = 1; actionNum < node->numOfActions; actionNum ++)
+      {
+        chosen = (totals[prefix][actionNum] > totals[prefix][chosen]) ?
+          actionNum : chosen;
+      }
+      value = 0.0;
+      for(actionNum = 0; actionNum < node->numOfActions; actionNum ++)
+      {
+        if((node->player != responder) || (best == FALSE))
+        {
+          value += ((node->player != responder) ? 1.0 :
+            probabilities[actionNum]) * values[(size_t)node->children[
+            actionNum] * numOfDeals + dealNum];
+        }
+        else if(actionNum == chosen)
+        {
+          value = values[(size_t)node->children[actionNum] * numOfDeals +
+            dealNum];
+        }
+      }
+      values[(size_t)nodeNum * numOfDeals + dealNum] = value;
+    }
+  }
+  value = 0.0;
+  for(dealNum = 0; dealNum < numOfDeals; dealNum ++)
+  {
+    value += values[dealNum];
+  }
+  return value;
+}
+
+/*
+  Function to compare the exploitability and game value of a solver with
+  those found deal by deal.
+
+  Input   = {cfrSolver *: solver, double *: reach, double *: values,
+            char *: stage, double *: exploitability}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long compareCfrResponses(const cfrSolver * solver,
+  double * reach, double * values, const char * stage,
+  double * exploitability)
+{
+  double gameValue = 0.0;
+  double dealtValue = dealResponse(solver, 0, FALSE, reach, values);
+  double dealtExploitability = (dealResponse(solver, 0, TRUE, reach,
+    values) + dealResponse(solver, 1, TRUE, reach, values)) / 2.0;
+
+  * exploitability = cfrExploitability(solver, & gameValue);
+  if((fabs(* exploitability - dealtExploitability) > 1e-9) ||
+    (fabs(gameValue - dealtValue) > 1e-9) || (* exploitability < 0.0))
+  {
+    printf("MISMATCH %s strategy: exploitability %.9f and value %.9f, "
+      "deal by deal %.9f and %.9f\n", stage, * exploitability, gameValue,
+      dealtExploitability, dealtValue);
+    return 1;
+  }
+  return 0;
+}
+
+/*
+  Function to check the CFR solver on a small game: the exploitability and
+  game value of the first, uniform strategy and of a trained one have to
+  match those found deal by deal, training has to more than halve the
+  exploitability and saved tables have to load back unchanged.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkStudCfr(uint64_t seed, int numOfThreads)
+{
+  static cfrSolver solver;
+  char path[TEMP_PATH_SIZE];
+  cfrConfig config;
+  double * reach = NULL;
+  double * values = NULL;
+  unsigned long long mismatches = 0;
+  double uniform = 0.0;
+  double trained = 0.0;
+  double loaded = 0.0;
+  double started = 0.0;
+  double seconds = 0.0;
+
+  config.numOfBuckets = CHECK_CFR_BUCKETS;
+  config.numOfDeals = CHECK_CFR_DEALS;
+  config.seed = seed;
+  config.numOfThreads = numOfThreads;
+  config.plus = FALSE;
+  if(createCfrSolver(& solver, & config) == FALSE)
+  {
+    printf("MISMATCH the CFR solver cannot be created\n");
+    return 1;
+  }
+  reach = malloc(sizeof(double) * solver.numOfNodes * CHECK_CFR_DEALS);
+  values = malloc(sizeof(double) * solver.numOfNodes * CHECK_CFR_DEALS);
+  if((reach == NULL) || (values == NULL))
+  {
+    free(reach);
+    free(values);
+    freeCfrSolver(& solver);
+    printf("MISMATCH out of memory for the CFR check\n");
+    return 1;
+  }
+  mismatches += compareCfrResponses(& solver, reach, values, "uniform",
+    & uniform);
+  started = currentSeconds();
+  runCfrIterations(& solver, CHECK_CFR_ITERATIONS);
+  seconds = currentSeconds() - started;
+  mismatches += compareCfrResponses(& solver, reach, values, "trained",
+    & trained);
+  if(trained * 2.0 > uniform)
+  {
+    mismatches ++;
+    printf("MISMATCH CFR left exploitability %.5f, from %.5f\n", trained,
+      uniform);
+  }
+
+  snprintf(path, sizeof(path), "/tmp/pokerDiffCheck-%ld.cfr",
+    (long)getpid());
+  if((saveCfrStrategy(& solver, path) == FALSE) ||
+    (runCfrIterations(& solver, 1) == FALSE) ||
+    (loadCfrStrategy(& solver, path) == FALSE))
+  {
+    mismatches ++;
+    printf("MISMATCH CFR tables cannot be saved to and loaded from %s\n",
+      path);
+  }
+  loaded = cfrExploitability(& solver, NULL);
+  if(loaded != trained)
+  {
+    mismatches ++;
+    printf("MISMATCH loaded CFR tables have exploitability %.9f, not %.9f\n",
+      loaded, trained);
+  }
+  remove(path);
+  free(reach);
+  free(values);
+  freeCfrSolver(& solver);
+  printf("Stud CFR: %d iterations, %.1f M/min, exploitability %.4f from "
+    "%.4f matches a deal by deal best response\n", CHECK_CFR_ITERATIONS,
+    CHECK_CFR_ITERATIONS / seconds * 60e-6, trained, uniform);
+  return mismatches;
+}
+
+/*
+  Function to give the weight a checked range expression sets on a hand,
+  read from its reference key: 0 "flush", 1 "TT+", 2 "trips, !first" and
+  3 "full-house+@0.25, QQQ-AAA@0.5, first second".
+
+  Input   = {int: rangeNum, unsigned char *: cards, unsigned char: first,
+            unsigned char: second}
+  Output  = {float: weight}
+*/
+static float referenceRangeWeight(int rangeNum,
+  const unsigned char cards[CARDS_PER_HAND], unsigned char first,
+  unsigned char second)
+{
+  const unsigned long key = referenceKey(cards);
+  const pokerRank category = (pokerRank)(key >> 20);
+  const int top = (int)((key >> 16) & 15);
+  bool holdsFirst = FALSE;
+  bool holdsSecond = FALSE;
+  int cardNum = 0;
+
+  for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+  {
+    holdsFirst = (cards[cardNum] == first) ? TRUE : holdsFirst;
+    holdsSecond = (cards[cardNum] == second) ? TRUE : holdsSecond;
+  }
+  switch(rangeNum)
+  {
+    case 0:
+      return (category == Flush) ? 1.0f : 0.0f;
+    case 1:
+      return ((category > Pair) || ((category == Pair) && (top >= 10))) ?
+        1.0f : 0.0f;
+    case 2:
+      return ((category == ThreeOfAKind) && (holdsFirst == FALSE)) ?
+        1.0f : 0.0f;
+    default:
+      if((holdsFirst == TRUE) && (holdsSecond == TRUE))
+      {
+        return 1.0f;
+      }
+      if((category == ThreeOfAKind) && (top >= 12))
+      {
+        return 0.5f;
+      }
+      return (category >= FullHouse) ? 0.25f : 0.0f;
+  }
+}
+
+/*
+  Function to find the equity of one range against another one pair of
+  hands at a time, by reference keys.
+
+  Input   = {handRange *: first, handRange *: second, rangeEquity *: equity}
+  Output  = {bool: success}
+*/
+static bool referenceRangeEquity(const handRange * first,
+  const handRange * second, rangeEquity * equity)
+{
+  const handRange * ranges[2] = {first, second};
+  unsigned long * keys[2] = {NULL, NULL};
+  uint64_t * masks[2] = {NULL, NULL};
+  float * weights[2] = {NULL, NULL};
+  unsigned char cards[CARDS_PER_HAND];
+  handIndex index = 0;
+  uint32_t handNum = 0;
+  uint32_t otherNum = 0;
+  double weight = 0.0;
+  bool success = TRUE;
+  int rangeNum = 0;
+  int cardNum = 0;
+
+  memset(equity, 0, sizeof(rangeEquity));
+  for(rangeNum = 0; rangeNum < 2; rangeNum ++)
+  {
+    keys[rangeNum] = malloc(sizeof(unsigned long) *
+      (ranges[rangeNum]->numOfHands + 1));
+    masks[rangeNum] = calloc(ranges[rangeNum]->numOfHands + 1,
+      sizeof(uint64_t));
+    weights[rangeNum] = malloc(sizeof(float) *
+      (ranges[rangeNum]->numOfHands + 1));
+    success = success && (keys[rangeNum] != NULL) &&
+      (masks[rangeNum] != NULL) && (weights[rangeNum] != NULL);
+    handNum = 0;
+    for(index = 0; (success == TRUE) && (index < NUM_OF_FIVE_CARD_HANDS);
+      index ++)
+    {
+      if(rangeHolds(ranges[rangeNum], index))
+      {
+        unrankHandIndices(index, cards);
+        keys[rangeNum][handNum] = referenceKey(cards);
+        for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+        {
+          masks[rangeNum][handNum] |= 1ULL << cards[cardNum];
+        }
+        weights[rangeNum][handNum ++] = ranges[rangeNum]->weights[index];
+      }
+    }
+  }
+  for(handNum = 0; (success == TRUE) && (handNum < first->numOfHands);
+    handNum ++)
+  {
+    for(otherNum = 0; otherNum < second->numOfHands; otherNum ++)
+    {
+      if((masks[0][handNum] & masks[1][otherNum]) != 0)
+      {
+        continue;
+      }
+      weight = (double)weights[0][handNum] * weights[1][otherNum];
+      equity->numOfPairs ++;
+      if(keys[0][handNum] > keys[1][otherNum])
+      {
+        equity->win += weight;
+      }
+      else if(keys[0][handNum] == keys[1][otherNum])
+      {
+        equity->tie += weight;
+      }
+      else
+      {
+        equity->loss += weight;
+      }
+    }
+  }
+  for(rangeNum = 0; rangeNum < 2; rangeNum ++)
+  {
+    free(keys[rangeNum]);
+    free(masks[rangeNum]);
+    free(weights[rangeNum]);
+  }
+  return success;
+}
+
+/*
+  Function to compare two equities of the same ranges.
+
+  Input   = {rangeEquity *: found, rangeEquity *: expected, char *: stage}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long compareRangeEquity(const rangeEquity * found,
+  const rangeEquity * expected, const char * stage)
+{
+  const double scale = expected->win + expected->tie + expected->loss + 1.0;
+
+  if((found->numOfPairs != expected->numOfPairs) ||
+    (fabs(found->win - expected->win) > RANGE_TOLERANCE * scale) ||
+    (fabs(found->tie - expected->tie) > RANGE_TOLERANCE * scale) ||
+    (fabs(found->loss - expected->loss) > RANGE_TOLERANCE * scale))
+  {
+    printf("MISMATCH %s range equity: %llu pairs win %.6f tie %.6f loss "
+      "%.6f, expected %llu pairs win %.6f tie %.6f loss %.6f\n", stage,
+      (unsigned long long)found->numOfPairs, found->win, found->tie,
+      found->loss, (unsigned long long)expected->numOfPairs, expected->win,
+      expected->tie, expected->loss);
+    return 1;
+  }
+  return 0;
+}
+
+/*
+  Function to check hand ranges: compiled expressions have to give every
+  hand the weight the reference rules give it, bad expressions have to be
+  refused, both equity engines have to agree with comparing every pair by
+  reference keys and with each other, and a range has to break even
+  against itself.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkHandRange(uint64_t seed, int numOfThreads)
+{
+  static const char * const badRanges[] =
+  {
+    "", "flush,", "TT-KKK", "pair@2", "AS AS", "QQ+x", "straight-flush++"
+  };
+  const char * rankText = "A23456789TJQK";
+  const char * suitText = "HDCS";
+  char texts[4][96];
+  char cardTexts[2][3];
+  unsigned char held[2];
+  unsigned char cards[CARDS_PER_HAND];
+  handRange ranges[4];
+  handRange small[2];
+  rangeEquity pairs;
+  rangeEquity sweep;
+  rangeEquity expected;
+  pokerRng rng;
+  unsigned long long mismatches = 0;
+  unsigned long long wrongHands = 0;
+  handIndex index = 0;
+  float weight = 0.0f;
+  bool success = TRUE;
+  int rangeNum = 0;
+  int cardNum = 0;
+  int badNum = 0;
+
+  seedRng(& rng, seed, 9);
+  held[0] = randomBounded(& rng, STD_DECK_SIZE);
+  held[1] = (held[0] + 1 + randomBounded(& rng, STD_DECK_SIZE - 1)) %
+    STD_DECK_SIZE;
+  for(cardNum = 0; cardNum < 2; cardNum ++)
+  {
+    cardTexts[cardNum][0] = rankText[cardIndexRank(held[cardNum])];
+    cardTexts[cardNum][1] = suitText[cardIndexSuit(held[cardNum])];
+    cardTexts[cardNum][2] = '\0';
+  }
+  snprintf(texts[0], sizeof(texts[0]), "flush");
+  snprintf(texts[1], sizeof(texts[1]), "TT+");
+  snprintf(texts[2], sizeof(texts[2]), "trips, !%s", cardTexts[0]);
+  snprintf(texts[3], sizeof(texts[3]),
+    "full-house+@0.25, qqq-AAA @ 0.5, %s %s", cardTexts[0], cardTexts[1]);
+  for(rangeNum = 0; rangeNum < 4; rangeNum ++)
+  {
+    success = (createHandRange(& ranges[rangeNum]) == TRUE) && success;
+  }
+  success = (createHandRange(& small[0]) == TRUE) && success;
+  success = (createHandRange(& small[1]) == TRUE) && success;
+  if(success == FALSE)
+  {
+    printf("MISMATCH out of memory for the range check\n");
+    return 1;
+  }
+
+  for(rangeNum = 0; rangeNum < 4; rangeNum ++)
+  {
+    if(compileHandRange(& ranges[rangeNum], texts[rangeNum]) == FALSE)
+    {
+      mismatches ++;
+      printf("MISMATCH the range %s cannot be compiled\n", texts[rangeNum]);
+    }
+  }
+  for(index = 0; index < NUM_OF_FIVE_CARD_HANDS; index ++)
+  {
+    unrankHandIndices(index, cards);
+    for(rangeNum = 0; rangeNum < 4; rangeNum ++)
+    {
+      weight = referenceRangeWeight(rangeNum, cards, held[0], held[1]);
+      if((ranges[rangeNum].weights[index] != weight) ||
+        ((int)rangeHolds(& ranges[rangeNum], index) != (weight > 0.0f)))
+      {
+        if(wrongHands ++ < 5)
+        {
+          printf("MISMATCH range %s gives ", texts[rangeNum]);
+          printIndexHand(cards);
+          printf(" weight %.2f, not %.2f\n", ranges[rangeNum].weights[index],
+            weight);
+        }
+      }
+    }
+  }
+  mismatches += wrongHands;
+  for(badNum = 0; badNum < (int)(sizeof(badRanges) / sizeof(badRanges[0]));
+    badNum ++)
+  {
+    if(compileHandRange(& small[0], badRanges[badNum]) == TRUE)
+    {
+      mismatches ++;
+      printf("MISMATCH the bad range \"%s\" was compiled\n",
+        badRanges[badNum]);
+    }
+  }
+
+  snprintf(texts[0], sizeof(texts[0]), "straight-flush, KKK, AAA@0.25, !%s",
+    cardTexts[1]);
+  if((compileHandRange(& small[0], "quads, AAA@0.5") == FALSE) ||
+    (compileHandRange(& small[1], texts[0]) == FALSE) ||
+    (referenceRangeEquity(& small[0], & small[1], & expected) == FALSE) ||
+    (computeRangeEquity(& small[0], & small[1], numOfThreads,
+    RANGE_ENGINE_PAIRS, & pairs) == FALSE) ||
+    (computeRangeEquity(& small[0], & small[1], numOfThreads,
+    RANGE_ENGINE_SWEEP, & sweep) == FALSE))
+  {
+    mismatches ++;
+    printf("MISMATCH the small range equities cannot be computed\n");
+  }
+  else
+  {
+    mismatches += compareRangeEquity(& pairs, & expected, "pairs engine");
+    mismatches += compareRangeEquity(& sweep, & expected, "sweep engine");
+  }
+  if((computeRangeEquity(& ranges[3], & ranges[0], numOfThreads,
+    RANGE_ENGINE_PAIRS, & pairs) == FALSE) ||
+    (computeRangeEquity(& ranges[3], & ranges[0], numOfThreads,
+    RANGE_ENGINE_SWEEP, & sweep) == FALSE))
+  {
+    mismatches ++;
+    printf("MISMATCH the weighted range equities cannot be computed\n");
+  }
+  else
+  {
+    mismatches += compareRangeEquity(& sweep, & pairs, "weighted");
+  }
+  if((computeRangeEquity(& ranges[2], & ranges[2], numOfThreads,
+    RANGE_ENGINE_SWEEP, & sweep) == FALSE) || (sweep.win != sweep.loss))
+  {
+    mismatches ++;
+    printf("MISMATCH a range wins %.1f and loses %.1f against itself\n",
+      sweep.win, sweep.loss);
+  }
+
+  for(rangeNum = 0; rangeNum < 4; rangeNum ++)
+  {
+    freeHandRange(& ranges[rangeNum]);
+  }
+  freeHandRange(& small[0]);
+  freeHandRange(& small[1]);
+  printf("Hand ranges: 4 expressions match the reference rules on every "
+    "hand, %llu weighted pairs agree across engines\n",
+    (unsigned long long)pairs.numOfPairs);
+  return mismatches;
+}
+
+/*
+  Function to check tournaments. With the hero playing like the field the
+  hero's places have to average the middle place; chips must never go
+  missing and tables never differ by more than one player after balancing;
+  every tournament has to place the hero once; and one thread in normal
+  pages has to give the same results as several in huge pages. Heads up
+  tables with an odd number of players leave a player alone at a table for
+  a round.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkTournament(uint64_t seed, int numOfThreads)
+{
+  static const int players[2] = {60, 7};
+  static const int seats[2] = {6, 2};
+  handRange range;
+  tournamentConfig config;
+  tournamentResults results;
+  tournamentResults single;
+  unsigned long long mismatches = 0;
+  uint64_t placed = 0;
+  double meanPlace = 0.0;
+  double tolerance = 0.0;
+  int configNum = 0;
+  int placeNum = 0;
+
+  if((createHandRange(& range) == FALSE) ||
+    (compileHandRange(& range, "TT+") == FALSE))
+  {
+    freeHandRange(& range);
+    printf("MISMATCH the tournament range cannot be compiled\n");
+    return 1;
+  }
+  for(configNum = 0; configNum < 2; configNum ++)
+  {
+    config.numOfPlayers = players[configNum];
+    config.seatsPerTable = seats[configNum];
+    config.startingStack = 300;
+    config.levelRounds = 5;
+    config.heroRange = & range;
+    config.fieldRange = & range;
+    config.numOfTournaments = CHECK_TOURNAMENTS;
+    config.seed = seed + configNum;
+    config.numOfThreads = 1;
+    config.backing = ArenaPages;
+    if(runTournaments(& config, & single) == FALSE)
+    {
+      mismatches ++;
+      printf("MISMATCH tournaments of %d players cannot be run\n",
+        config.numOfPlayers);
+      continue;
+    }
+    config.numOfThreads = numOfThreads;
+    config.backing = ArenaTransparentHuge;
+    if(runTournaments(& config, & results) == FALSE)
+    {
+      freeTournamentResults(& single);
+      mismatches ++;
+      printf("MISMATCH tournaments of %d players cannot be run\n",
+        config.numOfPlayers);
+      continue;
+    }
+    placed = 0;
+    meanPlace = 0.0;
+    for(placeNum = 0; placeNum < config.numOfPlayers; placeNum ++)
+    {
+      placed += results.heroFinishes[placeNum];
+      meanPlace += (placeNum + 1.0) * results.heroFinishes[placeNum];
+    }
+    meanPlace /= CHECK_TOURNAMENTS;
+    tolerance = TOURNAMENT_MEAN_ERRORS * sqrt(((double)config.numOfPlayers *
+      config.numOfPlayers - 1.0) / 12.0 / CHECK_TOURNAMENTS);
+    if((results.tournaments != CHECK_TOURNAMENTS) ||
+      (placed != CHECK_TOURNAMENTS) || (results.chipErrors != 0) ||
+      (results.maxSpread > 1))
+    {
+      mismatches ++;
+      printf("MISMATCH %llu tournaments of %d players placed the hero %llu "
+        "times, lost chips %llu times and left tables %d apart\n",
+        (unsigned long long)results.tournaments, config.numOfPlayers,
+        (unsigned long long)placed, (unsigned long long)results.chipErrors,
+        results.maxSpread);
+    }
+    if(fabs(meanPlace - (config.numOfPlayers + 1) / 2.0) > tolerance)
+    {
+      mismatches ++;
+      printf("MISMATCH a hero playing like the field of %d averages place "
+        "%.2f, not %.2f\n", config.numOfPlayers, meanPlace,
+        (config.numOfPlayers + 1) / 2.0);
+    }
+    if((results.rounds != single.rounds) || (results.hands != single.hands) ||
+      (results.moves != single.moves) ||
+      (memcmp(results.heroFinishes, single.heroFinishes,
+      sizeof(uint64_t) * config.numOfPlayers) != 0))
+    {
+      mismatches ++;
+      printf("MISMATCH tournaments of %d players differ on %d threads\n",
+        config.numOfPlayers, numOfThreads);
+    }
+    printf("Tournaments: %d of %d players at %d seats, hero mean place "
+      "%.2f, %.1f moves each\n", CHECK_TOURNAMENTS, config.numOfPlayers,
+      config.seatsPerTable, meanPlace,
+      (double)results.moves / CHECK_TOURNAMENTS);
+    freeTournamentResults(& results);
+    freeTournamentResults(& single);
+  }
+  freeHandRange(& range);
+  return mismatches;
+}
+
+/*
+  Function to add up the equities of every completion of a board by brute
+  force: each player's unknown cards are chosen in turn as ascending
+  combinations of the cards nobody holds.
+
+  Input   = {studBoard *: board, unsigned char [][]: hands, bool *: used,
+            int: playrNum, int: cardNum, int: nextCard, studEquity *: result}
+  Output  = {void: NULL}
+*/
+static void bruteForceEquity(const studBoard * board,
+  unsigned char hands[MAX_PLAYERS][CARDS_PER_HAND], bool used[STD_DECK_SIZE],
+  int playrNum, int cardNum, int nextCard, studEquity * result)
+{
+  handStrength strengths[MAX_PLAYERS];
+  unsigned int winners = 0;
+  int card = 0;
+
+  if(playrNum == board->numOfPlayers)
+  {
+    for(card = 0; card < board->numOfPlayers; card ++)
+    {
+      strengths[card] = evaluateCardIndices(hands[card], CARDS_PER_HAND);
+    }
+    winners = findWinners(strengths, board->numOfPlayers);
+    for(card = 0; card < board->numOfPlayers; card ++)
+    {
+      if((winners & (1u << card)) != 0)
+      {
+        result->equityUnits[card] += EQUITY_UNITS /
+          __builtin_popcount(winners);
+        result->wins[card] += (__builtin_popcount(winners) == 1);
+        result->ties[card] += (__builtin_popcount(winners) > 1);
+      }
+    }
+    result->completions ++;
+    return;
+  }
+  if(cardNum == CARDS_PER_HAND)
+  {
+    bruteForceEquity(board, hands, used, playrNum + 1,
+      (playrNum + 1 < board->numOfPlayers) ? board->numKnown[playrNum + 1] :
+      0, 0, result);
+    return;
+  }
+  for(card = nextCard; card < STD_DECK_SIZE; card ++)
+  {
+    if(used[card] == FALSE)
+    {
+      used[card] = TRUE;
+      hands[playrNum][cardNum] = card;
+      bruteForceEquity(board, hands, used, playrNum, cardNum + 1, card + 1,
+        result);
+      used[card] = FALSE;
+    }
+  }
+}
+
+/*
+  Function to check exact equity enumeration: on small random boards the
+  wins, ties and equity units of every player have to be those of brute
+  force, on one thread and on several, and an enumeration stopped early on
+  its tolerance has to bound every exact equity.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkStudEquity(uint64_t seed, int numOfThreads)
+{
+  static const int numOfPlayers[CHECK_EQUITY_BOARDS] = {3, 2, 2};
+  static const int numKnown[CHECK_EQUITY_BOARDS][MAX_PLAYERS] =
+  {
+    {4, 4, 4}, {3, 4}, {3, 3}
+  };
+  static const int numDead[CHECK_EQUITY_BOARDS] = {2, 0, 4};
+  unsigned char hands[MAX_PLAYERS][CARDS_PER_HAND];
+  unsigned char deck[STD_DECK_SIZE];
+  bool used[STD_DECK_SIZE];
+  pokerRng rng;
+  studBoard board;
+  studEquity brute;
+  studEquity single;
+  studEquity parallel;
+  studEquity early;
+  unsigned long long mismatches = 0;
+  unsigned long long stoppedEarly = 0;
+  int boardNum = 0;
+  int playrNum = 0;
+  int cardNum = 0;
+  int dealt = 0;
+
+  for(boardNum = 0; boardNum < CHECK_EQUITY_BOARDS; boardNum ++)
+  {
+    for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+    {
+      deck[cardNum] = cardNum;
+      used[cardNum] = FALSE;
+    }
+    seedRng(& rng, seed, 20 + boardNum);
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE, STD_DECK_SIZE);
+    memset(& board, 0, sizeof(board));
+    board.numOfPlayers = numOfPlayers[boardNum];
+    dealt = 0;
+    for(playrNum = 0; playrNum < board.numOfPlayers; playrNum ++)
+    {
+      board.numKnown[playrNum] = numKnown[boardNum][playrNum];
+      for(cardNum = 0; cardNum < board.numKnown[playrNum]; cardNum ++)
+      {
+        board.known[playrNum][cardNum] = deck[dealt];
+        hands[playrNum][cardNum] = deck[dealt];
+        used[deck[dealt ++]] = TRUE;
+      }
+    }
+    board.numDead = numDead[boardNum];
+    for(cardNum = 0; cardNum < board.numDead; cardNum ++)
+    {
+      board.dead[cardNum] = deck[dealt];
+      used[deck[dealt ++]] = TRUE;
+    }
+
+    memset(& brute, 0, sizeof(brute));
+    bruteForceEquity(& board, hands, used, 0, board.numKnown[0], 0, & brute);
+    if((computeStudEquity(& board, NO_EARLY_EXIT, 1, & single) == FALSE) ||
+      (computeStudEquity(& board, NO_EARLY_EXIT, numOfThreads + 1,
+      & parallel) == FALSE) || (single.exact == FALSE) ||
+      (single.completions != brute.completions) ||
+      (parallel.completions != brute.completions) ||
+      (memcmp(single.wins, brute.wins, sizeof(brute.wins)) != 0) ||
+      (memcmp(single.ties, brute.ties, sizeof(brute.ties)) != 0) ||
+      (memcmp(single.equityUnits, brute.equityUnits,
+      sizeof(brute.equityUnits)) != 0) ||
+      (memcmp(parallel.equityUnits, brute.equityUnits,
+      sizeof(brute.equityUnits)) != 0))
+    {
+      mismatches ++;
+      printf("MISMATCH board %d enumerates other equities than brute "
+        "force\n", boardNum);
+      continue;
+    }
+
+    /* The bounds of an early exit hold the exact equities */
+    if(computeStudEquity(& board, CHECK_EQUITY_TOLERANCE, 1, & early) ==
+      FALSE)
+    {
+      mismatches ++;
+      printf("MISMATCH board %d cannot be enumerated with a tolerance\n",
+        boardNum);
+      continue;
+    }
+    stoppedEarly += (early.evaluated < early.completions);
+    for(playrNum = 0; playrNum < board.numOfPlayers; playrNum ++)
+    {
+      if((early.equityLow[playrNum] > single.equity[playrNum] + 1e-12) ||
+        (early.equityHigh[playrNum] < single.equity[playrNum] - 1e-12))
+      {
+        mismatches ++;
+        printf("MISMATCH board %d player %d equity %.6f is outside the "
+          "early bounds %.6f to %.6f\n", boardNum, playrNum,
+          single.equity[playrNum], early.equityLow[playrNum],
+          early.equityHigh[playrNum]);
+      }
+    }
+  }
+  if(stoppedEarly == 0)
+  {
+    mismatches ++;
+    printf("MISMATCH no enumeration stopped early on a tolerance of %.2f\n",
+      CHECK_EQUITY_TOLERANCE);
+  }
+  printf("Stud equity: %d boards match brute force on 1 and %d threads, "
+    "%llu stopped early within their bounds\n", CHECK_EQUITY_BOARDS,
+    numOfThreads + 1, stoppedEarly);
+  return mismatches;
+}
+
+/*
+  Function to check sharded enumeration: the shards of a random board,
+  enumerated on different numbers of threads and merged in any order, have
+  to add up to exactly the totals of one enumeration of every completion,
+  and the merge has to refuse a missing, repeated, foreign or damaged shard.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkShardMerge(uint64_t seed, int numOfThreads)
+{
+  char paths[CHECK_SHARDS + 1][TEMP_PATH_SIZE];
+  const char * merged[CHECK_SHARDS + 1];
+  unsigned char deck[STD_DECK_SIZE];
+  pokerRng rng;
+  studBoard board;
+  studBoard other;
+  studBoard mergedBoard;
+  studEquity whole;
+  studEquity result;
+  shardHeader shards[CHECK_SHARDS];
+  shardHeader otherShard;
+  shardCoverage coverage;
+  FILE * stream = NULL;
+  unsigned long long mismatches = 0;
+  int shardNum = 0;
+  int playrNum = 0;
+  int cardNum = 0;
+
+  for(shardNum = 0; shardNum <= CHECK_SHARDS; shardNum ++)
+  {
+    snprintf(paths[shardNum], TEMP_PATH_SIZE, "/tmp/pokerDiffCheck-%ld.shard%d",
+      (long)getpid(), shardNum);
+  }
+  for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    deck[cardNum] = cardNum;
+  }
+  seedRng(& rng, seed, 10);
+  shuffleCardIndices(& rng, deck, STD_DECK_SIZE,
+    SHARD_PLAYERS * SHARD_KNOWN + SHARD_DEAD);
+  memset(& board, 0, sizeof(board));
+  board.numOfPlayers = SHARD_PLAYERS;
+  for(playrNum = 0; playrNum < SHARD_PLAYERS; playrNum ++)
+  {
+    board.numKnown[playrNum] = SHARD_KNOWN;
+    memcpy(board.known[playrNum], deck + playrNum * SHARD_KNOWN, SHARD_KNOWN);
+  }
+  board.numDead = SHARD_DEAD;
+  memcpy(board.dead, deck + SHARD_PLAYERS * SHARD_KNOWN, SHARD_DEAD);
+  if(computeStudEquity(& board, NO_EARLY_EXIT, 1, & whole) == FALSE)
+  {
+    printf("MISMATCH the shard board cannot be enumerated\n");
+    return 1;
+  }
+
+  /* Every shard on its own number of threads, merged last to first */
+  for(shardNum = 0; shardNum < CHECK_SHARDS; shardNum ++)
+  {
+    if(shardStudEquity(& board, shardNum, CHECK_SHARDS,
+      1 + shardNum % numOfThreads, NULL, paths[shardNum], & shards[shardNum],
+      & result) == FALSE)
+    {
+      printf("MISMATCH shard %d of %d cannot be written\n", shardNum + 1,
+        CHECK_SHARDS);
+      return mismatches + 1;
+    }
+    merged[CHECK_SHARDS - 1 - shardNum] = paths[shardNum];
+  }
+  if((mergeStudEquity(merged, CHECK_SHARDS, & mergedBoard, & result,
+    & coverage) == FALSE) || (result.completions != whole.completions) ||
+    (result.evaluated != whole.evaluated) ||
+    (memcmp(result.wins, whole.wins, sizeof(whole.wins)) != 0) ||
+    (memcmp(result.ties, whole.ties, sizeof(whole.ties)) != 0) ||
+    (memcmp(result.equityUnits, whole.equityUnits,
+    sizeof(whole.equityUnits)) != 0) ||
+    (memcmp(mergedBoard.known, board.known, sizeof(board.known)) != 0))
+  {
+    mismatches ++;
+    printf("MISMATCH %d merged shards differ from one enumeration of %llu "
+      "completions\n", CHECK_SHARDS, (unsigned long long)whole.completions);
+  }
+
+  /* Leaving out the second shard has to name its completions, and taking
+     the first one twice instead has to be an overlap */
+  merged[CHECK_SHARDS - 2] = paths[0];
+  if((mergeStudEquity(merged, CHECK_SHARDS - 1, & mergedBoard, & result,
+    & coverage) == TRUE) || (coverage.status != SHARDS_MISSING) ||
+    (coverage.gapFirst != shards[1].first) ||
+    (coverage.gapLast != shards[1].last))
+  {
+    mismatches ++;
+    printf("MISMATCH merging without shard 2 did not find completions "
+      "%llu to %llu missing\n", (unsigned long long)shards[1].first,
+      (unsigned long long)shards[1].last);
+  }
+  if((mergeStudEquity(merged, CHECK_SHARDS, & mergedBoard, & result,
+    & coverage) == TRUE) || (coverage.status != SHARDS_OVERLAPPING))
+  {
+    mismatches ++;
+    printf("MISMATCH merging shard 1 twice did not find an overlap\n");
+  }
+
+  /* A shard of a board with one dead card less belongs to another run */
+  memcpy(& other, & board, sizeof(board));
+  other.numDead --;
+  if(shardStudEquity(& other, 1, CHECK_SHARDS, numOfThreads, NULL,
+    paths[CHECK_SHARDS], & otherShard, & result) == FALSE)
+  {
+    mismatches ++;
+    printf("MISMATCH the shard of another board cannot be written\n");
+  }
+  merged[0] = paths[CHECK_SHARDS];
+  merged[1] = paths[0];
+  if((mergeStudEquity(merged, 2, & mergedBoard, & result, & coverage) ==
+    TRUE) || (coverage.status != SHARDS_MISMATCHED))
+  {
+    mismatches ++;
+    printf("MISMATCH a shard of another board was merged\n");
+  }
+
+  /* A damaged byte has to fail the checksum */
+  stream = fopen(paths[2], "r+b");
+  if(stream != NULL)
+  {
+    fseek(stream, -(long)(sizeof(uint64_t) + 1), SEEK_END);
+    fputc(fgetc(stream) ^ 1, stream);
+    fclose(stream);
+  }
+  for(shardNum = 0; shardNum < CHECK_SHARDS; shardNum ++)
+  {
+    merged[shardNum] = paths[shardNum];
+  }
+  if((mergeStudEquity(merged, CHECK_SHARDS, & mergedBoard, & result,
+    & coverage) == TRUE) || (coverage.status != SHARDS_UNREADABLE) ||
+    (coverage.first != 2))
+  {
+    mismatches ++;
+    printf("MISMATCH a damaged shard was merged\n");
+  }
+  for(shardNum = 0; shardNum <= CHECK_SHARDS; shardNum ++)
+  {
+    remove(paths[shardNum]);
+  }
+  printf("Shards: %d shards of %llu completions merge to one enumeration, "
+    "missing, repeated, foreign and damaged shards refused\n", CHECK_SHARDS,
+    (unsigned long long)whole.completions);
+  return mismatches;
+}
+
+/*
+  Function to check the spans of a trace: every batch span has to be of a
+  sampled batch, each sampled batch needs spansPerBatch of them, and every
+  table span has to lie within the next batch span of its thread, which
+  has to be of the same batch.
+
+  Input   = {pokerTrace *: trace, uint64_t: numOfTables,
+            int: spansPerBatch, char *: run}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkTraceSpans(const pokerTrace * trace,
+  uint64_t numOfTables, int spansPerBatch, const char * run)
+{
+  const traceBuffer * buffer = NULL;
+  const traceEvent * event = NULL;
+  const traceEvent * batch = NULL;
+  unsigned long long mismatches = 0;
+  uint64_t numOfBatches = (numOfTables + TABLES_PER_BATCH - 1) /
+    TABLES_PER_BATCH;
+  uint64_t expected = 0;
+  uint64_t batchSpans = 0;
+  uint64_t eventNum = 0;
+  uint64_t nextNum = 0;
+  uint64_t batchNum = 0;
+  int threadNum = 0;
+
+  for(batchNum = 0; batchNum < numOfBatches; batchNum ++)
+  {
+    expected += traceSampled(trace, batchNum) ? spansPerBatch : 0;
+  }
+  for(threadNum = 0; threadNum < trace->numOfThreads; threadNum ++)
+  {
+    buffer = & trace->buffers[threadNum];
+    for(eventNum = 0; eventNum < buffer->numRecorded; eventNum ++)
+    {
+      event = & buffer->events[eventNum];
+      if(event->phase == TraceBatch)
+      {
+        batchSpans ++;
+        if(!traceSampled(trace, event->batchNum) ||
+          (event->batchNum >= numOfBatches))
+        {
+          mismatches ++;
+          printf("MISMATCH the %s traced batch %llu, which is not sampled\n",
+            run, (unsigned long long)event->batchNum);
+        }
+      }
+      if((event->phase < TraceShuffle) || (event->phase > TraceShowdown))
+      {
+        continue;
+      }
+      batch = NULL;
+      for(nextNum = eventNum + 1; (batch == NULL) &&
+        (nextNum < buffer->numRecorded); nextNum ++)
+      {
+        if(buffer->events[nextNum].phase == TraceBatch)
+        {
+          batch = & buffer->events[nextNum];
+        }
+      }
+      if((batch == NULL) || (batch->batchNum != event->batchNum) ||
+        (event->start < batch->start) || (event->end > batch->end) ||
+        (event->start > event->end))
+      {
+        mismatches ++;
+        printf("MISMATCH a %s table span of batch %llu lies outside its "
+          "batch\n", run, (unsigned long long)event->batchNum);
+        return mismatches;
+      }
+    }
+  }
+  if((batchSpans != expected) || (expected == 0))
+  {
+    mismatches ++;
+    printf("MISMATCH the %s traced %llu batch spans instead of %llu\n", run,
+      (unsigned long long)batchSpans, (unsigned long long)expected);
+  }
+  return mismatches;
+}
+
+/*
+  Function to check tracing: a traced simulation and a traced pipeline have
+  to deal exactly what untraced runs do, record nested spans of the sampled
+  batches only, keep the newest spans of a full ring counting the rest as
+  dropped, and write their trace.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkTrace(uint64_t seed, int numOfThreads)
+{
+  static pokerStats untraced;
+  static pokerStats traced;
+  static pipelineReport report;
+  simulationConfig config;
+  pipelineConfig pipeline;
+  pokerTrace trace;
+  pokerTrace small;
+  const traceBuffer * buffer = NULL;
+  const traceEvent * event = NULL;
+  FILE * outputs[2] = {NULL, NULL};
+  unsigned long long mismatches = 0;
+  uint64_t recorded = 0;
+  uint64_t smallRecorded = 0;
+  uint64_t kept = 0;
+  uint64_t eventNum = 0;
+  double lastEnd = 0.0;
+  bool ordered = TRUE;
+  int threadNum = 0;
+  int runNum = 0;
+  int byte = 0;
+
+  memset(& config, 0, sizeof(config));
+  config.numOfPlayers = STATS_PLAYERS;
+  config.numOfTables = STATS_TABLES;
+  config.seed = seed;
+  config.numOfThreads = 1;
+  config.recordStats = TRUE;
+  runSimulation(& config, & untraced);
+  if((createTrace(& trace, numOfThreads + 1, TRACE_RING_EVENTS,
+    CHECK_TRACE_EVERY) == FALSE) || (createTrace(& small, numOfThreads + 1,
+    CHECK_TRACE_SMALL_RING, CHECK_TRACE_EVERY) == FALSE))
+  {
+    printf("MISMATCH cannot create a trace\n");
+    freeTrace(& trace);
+    freeTrace(& small);
+    return 1;
+  }
+  config.numOfThreads = numOfThreads + 1;
+  config.trace = & trace;
+  runSimulation(& config, & traced);
+  if(memcmp(& untraced, & traced, sizeof(pokerStats)) != 0)
+  {
+    mismatches ++;
+    printf("MISMATCH a traced simulation differs from an untraced one\n");
+  }
+  mismatches += checkTraceSpans(& trace, STATS_TABLES, 1, "simulation");
+
+  for(threadNum = 0; threadNum <= numOfThreads; threadNum ++)
+  {
+    recorded += trace.buffers[threadNum].numRecorded;
+  }
+  outputs[0] = tmpfile();
+  if((outputs[0] == NULL) || (writeTraceJson(& trace, outputs[0]) == FALSE))
+  {
+    mismatches ++;
+    printf("MISMATCH the simulation trace cannot be written\n");
+  }
+  if(outputs[0] != NULL)
+  {
+    fclose(outputs[0]);
+  }
+  freeTrace(& trace);
+
+  /* The same run into rings of a few spans records as many, keeping the
+     newest of each thread oldest first */
+  config.trace = & small;
+  runSimulation(& config, & traced);
+  for(threadNum = 0; threadNum <= numOfThreads; threadNum ++)
+  {
+    buffer = & small.buffers[threadNum];
+    smallRecorded += buffer->numRecorded;
+    for(eventNum = (buffer->numRecorded > CHECK_TRACE_SMALL_RING) ?
+      buffer->numRecorded - CHECK_TRACE_SMALL_RING : 0;
+      eventNum < buffer->numRecorded; eventNum ++)
+    {
+      event = & buffer->events[eventNum % CHECK_TRACE_SMALL_RING];
+      if(event->end < lastEnd)
+      {
+        ordered = FALSE;
+      }
+      lastEnd = event->end;
+      kept ++;
+    }
+    lastEnd = 0.0;
+  }
+  if((smallRecorded != recorded) || (ordered == FALSE) ||
+    (traceDropped(& small) != recorded - kept))
+  {
+    mismatches ++;
+    printf("MISMATCH a small trace ring dropped %llu of %llu spans\n",
+      (unsigned long long)traceDropped(& small),
+      (unsigned long long)smallRecorded);
+  }
+  freeTrace(& small);
+
+  /* A traced pipeline has to write the bytes of an untraced one */
+  memset(& pipeline, 0, sizeof(pipeline));
+  pipeline.numOfPlayers = STATS_PLAYERS;
+  pipeline.numOfTables = PIPELINE_TABLES;
+  pipeline.seed = seed;
+  pipeline.numOfProducers = PIPELINE_PRODUCERS;
+  pipeline.numOfEvaluators = PIPELINE_EVALUATORS;
+  pipeline.format = DealBinary;
+  if(createTrace(& trace, 1 + PIPELINE_PRODUCERS + PIPELINE_EVALUATORS,
+    TRACE_RING_EVENTS, CHECK_TRACE_EVERY) == FALSE)
+  {
+    printf("MISMATCH cannot create a pipeline trace\n");
+    return mismatches + 1;
+  }
+  for(runNum = 0; runNum < 2; runNum ++)
+  {
+    outputs[runNum] = tmpfile();
+    pipeline.output = outputs[runNum];
+    pipeline.trace = (runNum == 1) ? & trace : NULL;
+    if((outputs[runNum] == NULL) ||
+      (runPipeline(& pipeline, & report) == FALSE) ||
+      (report.written == FALSE))
+    {
+      mismatches ++;
+      printf("MISMATCH the pipeline did not run\n");
+    }
+  }
+  if((outputs[0] != NULL) && (outputs[1] != NULL))
+  {
+    rewind(outputs[0]);
+    rewind(outputs[1]);
+    do
+    {
+      byte = fgetc(outputs[0]);
+      if(byte != fgetc(outputs[1]))
+      {
+        mismatches ++;
+        printf("MISMATCH a traced pipeline wrote other deals\n");
+        break;
+      }
+    }
+    while(byte != EOF);
+  }
+  for(runNum = 0; runNum < 2; runNum ++)
+  {
+    if(outputs[runNum] != NULL)
+    {
+      fclose(outputs[runNum]);
+    }
+  }
+  mismatches += checkTraceSpans(& trace, PIPELINE_TABLES, 2, "pipeline");
+  freeTrace(& trace);
+  printf("Tracing: %llu spans of one batch in %d traced without changing "
+    "the simulation or the pipeline, %llu dropped by rings of %d\n",
+    (unsigned long long)recorded, CHECK_TRACE_EVERY,
+    (unsigned long long)(recorded - kept), CHECK_TRACE_SMALL_RING);
+  return mismatches;
+}
+
+/*
+  Function to check arenas and object pools: allocations have to be
+  aligned, zero and apart, a reset has to hand the same bytes out again and
+  keep the peak, a full arena or pool has to refuse, a pool has to hand back
+  the object given last, and a simulation in a huge page arena has to give
+  the statistics of one in normal pages.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkArena(uint64_t seed, int numOfThreads)
+{
+  static const size_t sizes[3] = {1, 100, ARENA_ALIGNMENT + 1};
+  static pokerStats plain;
+  static pokerStats huge;
+  unsigned char * bytes[3] = {NULL, NULL, NULL};
+  void * objects[CHECK_POOL_OBJECTS + 1];
+  pokerArena arena;
+  objectPool pool;
+  simulationConfig config;
+  memoryReport memory;
+  unsigned long long mismatches = 0;
+  size_t mark = 0;
+  size_t peak = 0;
+  size_t byteNum = 0;
+  int allocNum = 0;
+  int objectNum = 0;
+
+  if(createArena(& arena, CHECK_ARENA_BYTES, ArenaPages) == FALSE)
+  {
+    printf("MISMATCH an arena cannot be created\n");
+    return 1;
+  }
+  for(allocNum = 0; allocNum < 3; allocNum ++)
+  {
+    bytes[allocNum] = arenaAlloc(& arena, sizes[allocNum]);
+    for(byteNum = 0; (bytes[allocNum] != NULL) &&
+      (byteNum < sizes[allocNum]); byteNum ++)
+    {
+      mismatches += (bytes[allocNum][byteNum] != 0);
+      bytes[allocNum][byteNum] = 0xFF;
+    }
+    if((bytes[allocNum] == NULL) ||
+      ((size_t)bytes[allocNum] % ARENA_ALIGNMENT != 0) ||
+      ((allocNum > 0) && (bytes[allocNum] < bytes[allocNum - 1] +
+      sizes[allocNum - 1])))
+    {
+      mismatches ++;
+      printf("MISMATCH arena allocation %d of %zu bytes is misplaced\n",
+        allocNum, sizes[allocNum]);
+    }
+  }
+  mark = arena.used;
+  bytes[0] = arenaAlloc(& arena, CHECK_ARENA_BYTES / 2);
+  peak = arena.peak;
+  resetArena(& arena, mark);
+  if((bytes[0] == NULL) || (arenaAlloc(& arena, 1) != bytes[0]) ||
+    (arena.peak != peak) || (arenaAlloc(& arena, CHECK_ARENA_BYTES) != NULL))
+  {
+    mismatches ++;
+    printf("MISMATCH an arena reset or a full arena went wrong\n");
+  }
+
+  /* A pool of tables, taken first to last and the last given taken first */
+  resetArena(& arena, 0);
+  if(createPool(& pool, & arena, sizeof(pokerTable), CHECK_POOL_OBJECTS) ==
+    FALSE)
+  {
+    printf("MISMATCH a pool of %d tables does not fit %d bytes\n",
+      CHECK_POOL_OBJECTS, CHECK_ARENA_BYTES);
+    freeArena(& arena);
+    return mismatches + 1;
+  }
+  for(objectNum = 0; objectNum <= CHECK_POOL_OBJECTS; objectNum ++)
+  {
+    objects[objectNum] = poolTake(& pool);
+  }
+  for(objectNum = 0; objectNum < CHECK_POOL_OBJECTS; objectNum ++)
+  {
+    if((objects[objectNum] == NULL) ||
+      ((size_t)objects[objectNum] % ARENA_ALIGNMENT != 0) ||
+      ((objectNum > 0) && ((unsigned char *)objects[objectNum] <
+      (unsigned char *)objects[objectNum - 1] + sizeof(pokerTable))))
+    {
+      mismatches ++;
+      printf("MISMATCH pool object %d is misplaced\n", objectNum);
+    }
+  }
+  poolGive(& pool, objects[2]);
+  poolGive(& pool, objects[5]);
+  if((objects[CHECK_POOL_OBJECTS] != NULL) ||
+    (poolTake(& pool) != objects[5]) || (poolTake(& pool) != objects[2]) ||
+    (poolTake(& pool) != NULL) || (pool.inUse != CHECK_POOL_OBJECTS) ||
+    (pool.peakInUse != CHECK_POOL_OBJECTS))
+  {
+    mismatches ++;
+    printf("MISMATCH a pool handed out the wrong objects\n");
+  }
+  freeArena(& arena);
+
+  /* Huge pages fall back when the system has none, but never fail */
+  if((createArena(& arena, 1, ArenaHugeTlb) == FALSE) ||
+    (arena.size % HUGE_PAGE_SIZE != 0) || (arena.backing > ArenaHugeTlb))
+  {
+    mismatches ++;
+    printf("MISMATCH a huge page arena cannot be created\n");
+  }
+  freeArena(& arena);
+
+  memset(& config, 0, sizeof(config));
+  config.numOfPlayers = STATS_PLAYERS;
+  config.numOfTables = STATS_TABLES;
+  config.seed = seed;
+  config.numOfThreads = 1;
+  config.recordStats = TRUE;
+  runSimulation(& config, & plain);
+  config.numOfThreads = numOfThreads + 1;
+  config.backing = ArenaHugeTlb;
+  config.memory = & memory;
+  if((runSimulation(& config, & huge) == FALSE) ||
+    (memcmp(& plain, & huge, sizeof(pokerStats)) != 0) ||
+    (memory.numOfArenas != 1) || (memory.peak == 0) ||
+    (memory.peak > memory.reserved))
+  {
+    mismatches ++;
+    printf("MISMATCH a simulation in huge pages differs from one in normal "
+      "pages\n");
+  }
+  printf("Arenas: aligned, reset and pooled allocations handed out right, a "
+    "simulation in %s pages matches normal pages\n",
+    arenaBackingName(memory.backing));
+  return mismatches;
+}
+
+/* Decisions the auditing strategy found wrong, on every thread */
+static atomic_ullong playAuditErrors;
+
+/*
+  Strategy checking every decision of its batch against the cards before
+  picking an action at random: only the seat's own cards and the others'
+  face up cards dealt so far may be shown, the strengths have to be those
+  of the seat's cards and of the best board still in, and the pot, the call
+  and the bet have to fit the street.
+
+  Input   = {decisionBatch *: batch, unsigned char *: actions,
+            pokerRng *: rng, void *: state}
+  Output  = {void: NULL}
+*/
+static void auditStrategy(const decisionBatch * batch,
+  unsigned char * actions, pokerRng * rng, const void * state)
+{
+  const int seat = batch->seat;
+  handStrength bestShowing = 0;
+  handStrength showing = 0;
+  unsigned long long errors = 0;
+  const unsigned char * cards = NULL;
+  int numOfCards = 0;
+  int decisionNum = 0;
+  int playrNum = 0;
+  int cardNum = 0;
+
+  (void)state;
+  for(decisionNum = 0; decisionNum < batch->numOfDecisions; decisionNum ++)
+  {
+    numOfCards = PLAY_FIRST_STREET_CARDS + batch->street[decisionNum];
+    bestShowing = 0;
+    for(playrNum = 0; playrNum < batch->numOfPlayers; playrNum ++)
+    {
+      cards = batch->cards[decisionNum] + playrNum * CARDS_PER_HAND;
+      for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        errors += ((cards[cardNum] == PLAY_HIDDEN_CARD) !=
+          ((cardNum >= numOfCards) || ((cardNum == 0) && (playrNum != seat))));
+      }
+      if((playrNum == seat) ||
+        ((batch->folded[decisionNum] & (1u << playrNum)) != 0))
+      {
+        continue;
+      }
+      showing = evaluateCardIndices(batch->cards[decisionNum] +
+        playrNum * CARDS_PER_HAND + 1, numOfCards - 1);
+      bestShowing = (showing > bestShowing) ? showing : bestShowing;
+    }
+    errors += (batch->street[decisionNum] >= PLAY_STREETS) ||
+      ((batch->folded[decisionNum] & (1u << seat)) != 0) ||
+      (batch->numOfActive[decisionNum] != batch->numOfPlayers -
+      __builtin_popcount(batch->folded[decisionNum])) ||
+      (batch->numOfActive[decisionNum] < 2) ||
+      (batch->strength[decisionNum] != evaluateCardIndices(
+      batch->cards[decisionNum] + seat * CARDS_PER_HAND, numOfCards)) ||
+      (batch->bestShowing[decisionNum] != bestShowing) ||
+      (batch->betSize[decisionNum] != ((batch->street[decisionNum] ==
+      PLAY_STREETS - 1) ? PLAY_BIG_BET : PLAY_SMALL_BET)) ||
+      (batch->toCall[decisionNum] < 0) ||
+      (batch->toCall[decisionNum] % batch->betSize[decisionNum] != 0) ||
+      (batch->toCall[decisionNum] > batch->numOfBets[decisionNum] *
+      batch->betSize[decisionNum]) ||
+      (batch->numOfBets[decisionNum] > PLAY_MAX_BETS) ||
+      (batch->pot[decisionNum] < batch->numOfPlayers * PLAY_ANTE) ||
+      ((batch->numOfActions[decisionNum] > 0) &&
+      (batch->history[decisionNum] & 3) > PLAY_RAISE);
+    actions[decisionNum] = (unsigned char)randomBounded(rng, PLAY_ACTIONS);
+  }
+  atomic_fetch_add(& playAuditErrors, errors);
+}
+
+/*
+  Function to check the play driver. Audited random play has to show every
+  strategy right decisions, keep the chips whole and give the same results
+  on one thread as on several. Passive players never fold or raise, so
+  every hand is an ante showdown whose winnings are worked out here
+  directly. A tight player has to beat a passive one.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkPlay(uint64_t seed, int numOfThreads)
+{
+  int64_t expected[MAX_PLAYERS];
+  handStrength strengths[MAX_PLAYERS];
+  unsigned char deck[STD_DECK_SIZE];
+  playConfig config;
+  playResults single;
+  playResults parallel;
+  pokerRng rng;
+  unsigned long long mismatches = 0;
+  uint64_t handNum = 0;
+  int64_t chipSum = 0;
+  unsigned int winners = 0;
+  int numOfWinners = 0;
+  int oddChips = 0;
+  int playrNum = 0;
+  int cardNum = 0;
+
+  memset(& config, 0, sizeof(config));
+  config.numOfPlayers = CHECK_PLAY_PLAYERS;
+  config.numOfHands = CHECK_PLAY_HANDS;
+  config.seed = seed;
+  config.numOfThreads = 1;
+  for(playrNum = 0; playrNum < CHECK_PLAY_PLAYERS; playrNum ++)
+  {
+    config.strategies[playrNum].name = "audit";
+    config.strategies[playrNum].decide = auditStrategy;
+  }
+  atomic_store(& playAuditErrors, 0);
+  runPlay(& config, & single);
+  config.numOfThreads = numOfThreads + 1;
+  if((runPlay(& config, & parallel) == FALSE) ||
+    (memcmp(& single, & parallel, offsetof(playResults, memory)) != 0))
+  {
+    mismatches ++;
+    printf("MISMATCH play on %d threads differs from play on one\n",
+      numOfThreads + 1);
+  }
+  for(playrNum = 0; playrNum < CHECK_PLAY_PLAYERS; playrNum ++)
+  {
+    chipSum += single.chipsWon[playrNum];
+  }
+  if((single.hands != CHECK_PLAY_HANDS) || (chipSum != 0) ||
+    (atomic_load(& playAuditErrors) != 0))
+  {
+    mismatches ++;
+    printf("MISMATCH %llu wrong decisions, %llu of %d hands played, chips "
+      "off by %lld\n", (unsigned long long)atomic_load(& playAuditErrors),
+      (unsigned long long)single.hands, CHECK_PLAY_HANDS, (long long)chipSum);
+  }
+
+  /* Every hand is dealt as its batch deals it and shown down for the antes */
+  config.numOfPlayers = STATS_PLAYERS;
+  for(playrNum = 0; playrNum < STATS_PLAYERS; playrNum ++)
+  {
+    findPlayStrategy("passive", & config.strategies[playrNum]);
+    expected[playrNum] = 0;
+  }
+  for(handNum = 0; handNum < CHECK_PLAY_HANDS; handNum ++)
+  {
+    if(handNum % PLAY_BATCH_TABLES == 0)
+    {
+      seedRng(& rng, seed, handNum / PLAY_BATCH_TABLES);
+      for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+      {
+        deck[cardNum] = cardNum;
+      }
+    }
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE,
+      STATS_PLAYERS * CARDS_PER_HAND);
+    for(playrNum = 0; playrNum < STATS_PLAYERS; playrNum ++)
+    {
+      strengths[playrNum] = evaluateCardIndices(
+        deck + playrNum * CARDS_PER_HAND, CARDS_PER_HAND);
+    }
+    winners = findWinners(strengths, STATS_PLAYERS);
+    numOfWinners = __builtin_popcount(winners);
+    oddChips = (STATS_PLAYERS * PLAY_ANTE) % numOfWinners;
+    for(playrNum = 0; playrNum < STATS_PLAYERS; playrNum ++)
+    {
+      expected[playrNum] -= PLAY_ANTE;
+      if((winners & (1u << playrNum)) != 0)
+      {
+        expected[playrNum] += (STATS_PLAYERS * PLAY_ANTE) / numOfWinners +
+          ((oddChips > 0) ? 1 : 0);
+        oddChips -= (oddChips > 0) ? 1 : 0;
+      }
+    }
+  }
+  if((runPlay(& config, & single) == FALSE) ||
+    (single.showdowns != CHECK_PLAY_HANDS) ||
+    (single.actions[PLAY_FOLD] != 0) || (single.actions[PLAY_RAISE] != 0) ||
+    (memcmp(single.chipsWon, expected, sizeof(int64_t) * STATS_PLAYERS) !=
+    0))
+  {
+    mismatches ++;
+    printf("MISMATCH passive play is not a showdown of the antes\n");
+  }
+
+  config.numOfPlayers = 2;
+  findPlayStrategy("tight", & config.strategies[0]);
+  if((runPlay(& config, & single) == FALSE) || (single.chipsWon[0] <= 0))
+  {
+    mismatches ++;
+    printf("MISMATCH a tight player lost to a passive one\n");
+  }
+  printf("Play: %d audited hands decided right on 1 and %d threads, passive "
+    "play shows down the antes, tight beats passive\n", CHECK_PLAY_HANDS,
+    numOfThreads + 1);
+  return mismatches;
+}
+
+/*
+  Function to check the showdown kernels: the kernel of every number of
+  players has to give the strengths and winners of evaluateCardIndices and
+  findWinners on the same dealt tables, and there must be no kernel outside
+  MIN_PLAYERS to MAX_PLAYERS.
+
+  Input   = {uint64_t: seed}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkShowdownKernels(uint64_t seed)
+{
+  handStrength generic[MAX_PLAYERS];
+  handStrength kernel[MAX_PLAYERS];
+  unsigned char deck[STD_DECK_SIZE];
+  showdownKernel showdown = NULL;
+  pokerRng rng;
+  unsigned long long mismatches = 0;
+  unsigned int winners = 0;
+  int numOfPlayers = 0;
+  int tableNum = 0;
+  int playrNum = 0;
+  int cardNum = 0;
+
+  for(cardNum = 0; cardNum < STD_DECK_SIZE; cardNum ++)
+  {
+    deck[cardNum] = cardNum;
+  }
+  for(numOfPlayers = MIN_PLAYERS; numOfPlayers <= MAX_PLAYERS;
+    numOfPlayers ++)
+  {
+    showdown = selectShowdownKernel(numOfPlayers);
+    seedRng(& rng, seed, numOfPlayers);
+    for(tableNum = 0; (showdown != NULL) && (tableNum < CHECK_KERNEL_TABLES);
+      tableNum ++)
+    {
+      shuffleCardIndices(& rng, deck, STD_DECK_SIZE,
+        numOfPlayers * CARDS_PER_HAND);
+      for(playrNum = 0; playrNum < numOfPlayers; playrNum ++)
+      {
+        generic[playrNum] = evaluateCardIndices(
+          deck + playrNum * CARDS_PER_HAND, CARDS_PER_HAND);
+      }
+      winners = showdown(deck, kernel);
+      if((winners != findWinners(generic, numOfPlayers)) ||
+        (memcmp(generic, kernel, numOfPlayers * sizeof(handStrength)) != 0))
+      {
+        mismatches ++;
+        break;
+      }
+    }
+    if((showdown == NULL) || (tableNum < CHECK_KERNEL_TABLES))
+    {
+      printf("MISMATCH the showdown kernel of %d players differs from "
+        "the generic showdown\n", numOfPlayers);
+    }
+    mismatches += (showdown == NULL);
+  }
+  if((selectShowdownKernel(MIN_PLAYERS - 1) != NULL) ||
+    (selectShowdownKernel(MAX_PLAYERS + 1) != NULL))
+  {
+    mismatches ++;
+    printf("MISMATCH a showdown kernel exists for too few or many players\n");
+  }
+  printf("Showdown kernels: %d to %d players match the generic showdown on "
+    "%d tables each\n", MIN_PLAYERS, MAX_PLAYERS, CHECK_KERNEL_TABLES);
+  return mismatches;
+}
+
+/*
+  Function to check the shuffle auditor: the fisher-yates and batch shuffles
+  have to pass with the same tests on one thread and on several, and the
+  legacy shuffle, which reseeds from the clock for every deck, has to fail.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkShuffleAudit(uint64_t seed, int numOfThreads)
+{
+  const char * fairShuffles[] = {"fisher-yates", "batch"};
+  const int numOfFair = sizeof(fairShuffles) / sizeof(fairShuffles[0]);
+  auditConfig config;
+  auditReport single;
+  auditReport parallel;
+  unsigned long long mismatches = 0;
+  int shuffleNum = NUM_INIT;
+
+  config.numOfDecks = AUDIT_DECKS;
+  config.seed = seed;
+  config.alpha = DEFAULT_AUDIT_ALPHA;
+  for(shuffleNum = NUM_INIT; shuffleNum < numOfFair; shuffleNum ++)
+  {
+    config.plugin = findShufflePlugin(fairShuffles[shuffleNum]);
+    config.numOfThreads = 1;
+    if(auditShuffle(& config, & single) == FALSE)
+    {
+      printf("MISMATCH not enough memory to audit %s\n",
+        fairShuffles[shuffleNum]);
+      return mismatches + 1;
+    }
+    config.numOfThreads = numOfThreads + 1;
+    if(auditShuffle(& config, & parallel) == FALSE)
+    {
+      printf("MISMATCH not enough memory to audit %s\n",
+        fairShuffles[shuffleNum]);
+      return mismatches + 1;
+    }
+    if(memcmp(single.tests, parallel.tests, sizeof(single.tests)) != 0)
+    {
+      mismatches ++;
+      printf("MISMATCH audit of %s differs on %d threads\n",
+        fairShuffles[shuffleNum], parallel.numOfThreads);
+    }
+    if(single.passed == FALSE)
+    {
+      mismatches ++;
+      printf("MISMATCH fair shuffle %s failed its audit\n",
+        fairShuffles[shuffleNum]);
+    }
+  }
+
+  config.plugin = findShufflePlugin("legacy");
+  config.numOfDecks = LEGACY_AUDIT_DECKS;
+  if(auditShuffle(& config, & single) == FALSE)
+  {
+    printf("MISMATCH not enough memory to audit legacy\n");
+    return mismatches + 1;
+  }
+  if(single.passed == TRUE)
+  {
+    mismatches ++;
+    printf("MISMATCH the legacy shuffle passed its audit\n");
+  }
+  printf("Shuffle audit: fisher-yates and batch pass on %d decks, "
+    "legacy fails\n", AUDIT_DECKS);
+  return mismatches;
+}
+
+/*
+  Function to check that both paths of the batch shuffle give the same decks
+  and that the batch shuffle orders a small deck uniformly.
+
+  Input   = {uint64_t: seed}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkBatchShuffle(uint64_t seed)
+{
+  static unsigned char scalarDecks[SHUFFLE_DECKS * STD_DECK_SIZE];
+  static unsigned char vectorDecks[SHUFFLE_DECKS * STD_DECK_SIZE];
+  unsigned char orderDecks[SHUFFLE_LANES * 4 * ORDER_DECK_SIZE];
+  unsigned long orderCounts[NUM_OF_ORDERS];
+  batchRng scalarRng;
+  batchRng vectorRng;
+  unsigned long long mismatches = 0;
+  double chiSquare = 0.0;
+  double expected = (double)ORDER_SAMPLES / NUM_OF_ORDERS;
+  int numOfDecks = SHUFFLE_LANES * 4;
+  int roundNum = 0;
+  int deckNum = 0;
+  int cardNum = 0;
+  int order = 0;
+  int later = 0;
+
+  seedBatchRng(& scalarRng, seed, 0);
+  seedBatchRng(& vectorRng, seed, 0);
+  initDeckBatch(scalarDecks, SHUFFLE_DECKS, STD_DECK_SIZE);
+  initDeckBatch(vectorDecks, SHUFFLE_DECKS, STD_DECK_SIZE);
+  for(roundNum = 0; roundNum < SHUFFLE_ROUNDS; roundNum ++)
+  {
+    shuffleDeckBatchOn(& scalarRng, scalarDecks, SHUFFLE_DECKS,
+      STD_DECK_SIZE, STD_DECK_SIZE - roundNum % 3, ShuffleScalar);
+    shuffleDeckBatchOn(& vectorRng, vectorDecks, SHUFFLE_DECKS,
+      STD_DECK_SIZE, STD_DECK_SIZE - roundNum % 3, ShuffleAvx2);
+  }
+  if((memcmp(scalarDecks, vectorDecks, sizeof(scalarDecks)) != 0) ||
+    (memcmp(& scalarRng, & vectorRng, sizeof(batchRng)) != 0))
+  {
+    mismatches ++;
+    printf("MISMATCH batch shuffle paths give different decks\n");
+  }
+
+  /* Count the orderings of a four card deck, numbered by a Lehmer code */
+  memset(orderCounts, 0, sizeof(orderCounts));
+  initDeckBatch(orderDecks, numOfDecks, ORDER_DECK_SIZE);
+  for(roundNum = 0; roundNum < ORDER_SAMPLES / numOfDecks; roundNum ++)
+  {
+    shuffleDeckBatch(& vectorRng, orderDecks, numOfDecks, ORDER_DECK_SIZE,
+      ORDER_DECK_SIZE);
+    for(deckNum = 0; deckNum < numOfDecks; deckNum ++)
+    {
+      const unsigned char * deck = orderDecks + deckNum * ORDER_DECK_SIZE;
+      order = 0;
+      for(cardNum = 0; cardNum < ORDER_DECK_SIZE; cardNum ++)
+      {
+        order *= ORDER_DECK_SIZE - cardNum;
+        for(later = cardNum + 1; later < ORDER_DECK_SIZE; later ++)
+        {
+          order += deck[later] < deck[cardNum];
+        }
+      }
+      orderCounts[order] ++;
+    }
+  }
+  for(order = 0; order < NUM_OF_ORDERS; order ++)
+  {
+    chiSquare += (orderCounts[order] - expected) *
+      (orderCounts[order] - expected) / expected;
+  }
+  if(chiSquare > ORDER_CHI_SQUARE_LIMIT)
+  {
+    mismatches ++;
+    printf("MISMATCH batch shuffle orderings chi-square %.2f above %.2f\n",
+      chiSquare, ORDER_CHI_SQUARE_LIMIT);
+  }
+  printf("Batch shuffle: %s path matches scalar, four card orderings "
+    "chi-square %.2f (23 df)\n",
+    (batchShufflePath() == ShuffleAvx2) ? "AVX2" : "scalar", chiSquare);
+  return mismatches;
+}
+
+/*
+  Function to check the draw solver against enumerating every draw of every
+  option of a few random hands.
+
+  Input   = {uint64_t: seed, int: numOfThreads}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkDrawSolver(uint64_t seed, int numOfThreads)
+{
+  unsigned char deck[STD_DECK_SIZE];
+  unsigned char pool[DRAW_POOL_SIZE];
+  unsigned char positions[CARDS_PER_HAND];
+  unsigned char cards[CARDS_PER_HAND];
+  unsigned long long counts[NUM_OF_HAND_RANKS];
+  unsigned long long mismatches = 0;
+  unsigned long long draws = 0;
+  drawSolution solution;
+  handStrength strength = 0;
+  pokerRng rng;
+  double rankSum = 0.0;
+  double solvedSum = 0.0;
+  double started = 0.0;
+  double enumerated = 0.0;
+  int handNum = 0;
+  int held = 0;
+  int numDrawn = 0;
+  int numHeld = 0;
+  int cardNum = 0;
+  int rankNum = 0;
+  int denseRank = 0;
+
+  started = currentSeconds();
+  if(prepareDrawSolver(numOfThreads) == FALSE)
+  {
+    printf("MISMATCH the draw tables cannot be built\n");
+    return 1;
+  }
+  printf("Draw solver: tables built in %.2f s", currentSeconds() - started);
+  seedRng(& rng, seed, 1);
+  for(handNum = 0; handNum < DRAW_HANDS; handNum ++)
+  {
+    initDeckBatch(deck, 1, STD_DECK_SIZE);
+    shuffleCardIndices(& rng, deck, STD_DECK_SIZE, CARDS_PER_HAND);
+    memcpy(pool, deck + CARDS_PER_HAND, DRAW_POOL_SIZE);
+    solveDraw(deck, DrawForStrength, & solution);
+    started = currentSeconds();
+    for(held = 0; held < NUM_OF_DRAW_OPTIONS; held ++)
+    {
+      numHeld = 0;
+      for(cardNum = 0; cardNum < CARDS_PER_HAND; cardNum ++)
+      {
+        if((held >> cardNum) & 1)
+        {
+          cards[numHeld ++] = deck[cardNum];
+        }
+      }
+      numDrawn = CARDS_PER_HAND - numHeld;
+      memset(counts, 0, sizeof(counts));
+      rankSum = 0.0;
+      draws = 0;
+      for(cardNum = 0; cardNum < numDrawn; cardNum ++)
+      {
+        positions[cardNum] = cardNum;
+      }
+      do
+      {
+        for(cardNum = 0; cardNum < numDrawn; cardNum ++)
+        {
+          cards[numHeld + cardNum] = pool[positions[cardNum]];
+        }
+        strength = evaluateCardIndices(cards, CARDS_PER_HAND);
+        denseRank = strengthDenseRank(strength);
+        counts[strengthCategory(strength)] ++;
+        rankSum += denseRank;
+        draws ++;
+      } while((numDrawn > 0) &&
+        (nextCombination(positions, numDrawn, DRAW_POOL_SIZE) == TRUE));
+
+      solvedSum = solution.options[held].expectedStrength *
+        solution.options[held].outcomes * (NUM_OF_DISTINCT_STRENGTHS - 1);
+      if((draws != solution.options[held].outcomes) ||
+        (solvedSum - rankSum > 0.5) || (rankSum - solvedSum > 0.5))
+      {
+        mismatches ++;
+      }
+      for(rankNum = 0; rankNum < NUM_OF_HAND_RANKS; rankNum ++)
+      {
+        if(counts[rankNum] != solution.options[held].categoryCounts[rankNum])
+        {
+          mismatches ++;
+        }
+      }
+    }
+    enumerated += currentSeconds() - started;
+  }
+  printf(", %d hands compared with enumerating each draw (%.2f s per hand)\n",
+    DRAW_HANDS, enumerated / DRAW_HANDS);
+  if(mismatches != 0)
+  {
+    printf("MISMATCH %llu draw outcomes differ from enumeration\n",
+      mismatches);
+  }
+  return mismatches;
+}
+
+/*
+  Function to check the seven card stud engine: hands are dealt street by
+  street with random folds, and the bring-in, the first seat to act, the
+  cards dealt and the winners are compared with a direct computation.
+
+  Input   = {uint64_t: seed}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkSevenStud(uint64_t seed)
+{
+  /* Suit order of the bring-in, clubs lowest, indexed by suit: H, D, C, S */
+  const int bridgeOrder[NUM_OF_SUITS] = {2, 1, 0, 3};
+  unsigned char cards[STUD_CARDS + 1];
+  handStrength strengths[MAX_STUD_PLAYERS];
+  handStrength expected[MAX_STUD_PLAYERS];
+  handStrength strength = 0;
+  handStrength best = 0;
+  studTable table;
+  pokerRng rng;
+  uint64_t dealt = 0;
+  unsigned long long mismatches = 0;
+  unsigned long long communityHands = 0;
+  unsigned int winners = 0;
+  unsigned char doorCard = 0;
+  int handNum = 0;
+  int numOfPlayers = 0;
+  int numIn = 0;
+  int seat = 0;
+  int cardNum = 0;
+  int numOfCards = 0;
+  int lowest = 0;
+  int key = 0;
+  int first = 0;
+
+  seedRng(& rng, seed, 2);
+  for(handNum = 0; handNum < STUD_CHECK_HANDS; handNum ++)
+  {
+    numOfPlayers = MIN_PLAYERS + handNum % MAX_STUD_PLAYERS;
+    initStudTable(& table, numOfPlayers, seed, handNum);
+    startStudHand(& table);
+    first = INVALID_INT;
+    for(seat = 0; seat < numOfPlayers; seat ++)
+    {
+      doorCard = table.cards[seat][THIRD_STREET_CARDS - 1];
+      key = referenceValue(doorCard) * NUM_OF_SUITS +
+        bridgeOrder[cardIndexSuit(doorCard)];
+      if((first == INVALID_INT) || (key < lowest))
+      {
+        lowest = key;
+        first = seat;
+      }
+    }
+    mismatches += (table.bringIn != first) || (table.actingOrder[0] != first);
+    while(dealStudStreet(& table) == TRUE)
+    {
+      best = 0;
+      first = INVALID_INT;
+      for(seat = 0; seat < numOfPlayers; seat ++)
+      {
+        if(((table.folded >> seat) & 1) == 0)
+        {
+          strength = studVisibleStrength(& table, seat);
+          if((first == INVALID_INT) || (strength > best))
+          {
+            best = strength;
+            first = seat;
+          }
+        }
+      }
+      mismatches += (table.actingOrder[0] != first);
+      if((table.street != SeventhStreet) && (randomBounded(& rng, 4) == 0))
+      {
+        foldStudSeat(& table,
+          table.actingOrder[randomBounded(& rng, table.numActing)]);
+      }
+    }
+
+    /* Every card dealt once, and a community card only when needed */
+    dealt = 0;
+    for(cardNum = 0; cardNum < table.nextCard; cardNum ++)
+    {
+      dealt |= 1ULL << table.deck[cardNum];
+    }
+    mismatches += (__builtin_popcountll(dealt) != table.nextCard);
+    numIn = numOfPlayers - __builtin_popcount(table.folded);
+    if(table.communityCard != NO_COMMUNITY_CARD)
+    {
+      communityHands ++;
+      mismatches += (table.nextCard - 1 + numIn <= STD_DECK_SIZE);
+    }
+
+    winners = studShowdown(& table, strengths);
+    best = 0;
+    for(seat = 0; seat < numOfPlayers; seat ++)
+    {
+      expected[seat] = 0;
+      if(((table.folded >> seat) & 1) == 0)
+      {
+        numOfCards = table.numOfCards;
+        memcpy(cards, table.cards[seat], numOfCards);
+        if(table.communityCard != NO_COMMUNITY_CARD)
+        {
+          cards[numOfCards ++] = table.communityCard;
+        }
+        expected[seat] = evaluateCardIndices(cards, numOfCards);
+        best = (expected[seat] > best) ? expected[seat] : best;
+      }
+      mismatches += (strengths[seat] != expected[seat]);
+    }
+    for(seat = 0; seat < numOfPlayers; seat ++)
+    {
+      mismatches += (((winners >> seat) & 1) !=
+        (unsigned int)((((table.folded >> seat) & 1) == 0) &&
+        (expected[seat] == best)));
+    }
+  }
+  printf("Seven card stud: %d hands checked street by street, %llu with a "
+    "community card\n", STUD_CHECK_HANDS, communityHands);
+  if(mismatches != 0)
+  {
+    printf("MISMATCH %llu stud deals, orders or winners differ\n",
+      mismatches);
+  }
+  return mismatches;
+}
+
+/*
+  Function to check the rare hand sampler: the sets of every hand rank must
+  have the known sizes, sampled hands must belong to their set and sit at the
+  sampler's seat with the table dealt from distinct cards, and the forty
+  straight flushes must be drawn evenly.
+
+  Input   = {uint64_t: seed}
+  Output  = {unsigned long long: mismatches}
+*/
+static unsigned long long checkRareHands(uint64_t seed)
+{
+  const uint32_t setSizes[NUM_OF_HAND_RANKS] = {1302540, 1098240, 123552,
+    54912, 10200, 5108, 3744, 624, 40};
+  unsigned long long counts[RARE_UNIFORM_HANDS];
+  unsigned char deck[STD_DECK_SIZE];
+  rareSampler sampler;
+  pokerRng rng;
+  handStrength strength = 0;
+  handIndex index = 0;
+  uint64_t dealt = 0;
+  unsigned long long mismatches = 0;
+  double totalWeight = 0.0;
+  double expected = 0.0;
+  double chiSquare = 0.0;
+  double started = 0.0;
+  int category = 0;
+  int leadValue = 0;
+  int sampleNum = 0;
+  int numOfPlayers = 0;
+  int cardNum = 0;
+
+  started = currentSeconds();
+  if(prepareRareHands() == FALSE)
+  {
+    printf("MISMATCH the rare hand table cannot be built\n");
+    return 1;
+  }
+  printf("Rare hands: table built in %.2f s", currentSeconds() - started);
+  seedRng(& rng, seed, 3);
+  for(category = 0; category < NUM_OF_HAND_RANKS; category ++)
+  {
+    initRareSampler(& sampler, category, ANY_LEAD_VALUE, 0, 1);
+    mismatches += (sampler.numOfHands != setSizes[category]);
+    totalWeight += sampler.weight;
+    for(leadValue = 0; leadValue <= ACE_HIGH_VALUE; leadValue ++)
+    {
+      if(initRareSampler(& sampler, category, leadValue,
+        leadValue % MAX_PLAYERS, MAX_PLAYERS) == FALSE)
+      {
+        continue;
+      }
+      /* A seat past the last player is refused */
+      mismatches += initRareSampler(& sampler, category, leadValue,
+        sampler.seat, sampler.seat);
+      for(sampleNum = 0; sampleNum < RARE_SAMPLES; sampleNum ++)
+      {
+        numOfPlayers = sampler.seat + 1 +
+          randomBounded(& rng, MAX_PLAYERS - sampler.seat);
+        initRareSampler(& sampler, category, leadValue, sampler.seat,
+          numOfPlayers);
+        index = sampleRareTable(& sampler, & rng, deck);
+        strength = evaluateCardIndices(
+          deck + sampler.seat * CARDS_PER_HAND, CARDS_PER_HAND);
+        mismatches += (strengthCategory(strength) != (pokerRank)category) ||
+          ((int)strengthBucket(strength) !=
+          category * NUM_OF_RANKS + leadValue) ||
+          (rankHandIndices(deck + sampler.seat * CARDS_PER_HAND) != index);
+        dealt = 0;
+        for(cardNum = 0; cardNum < numOfPlayers * CARDS_PER_HAND; cardNum ++)
+        {
+          dealt |= 1ULL << deck[cardNum];
+        }
+        mismatches += (__builtin_popcountll(dealt) !=
+          numOfPlayers * CARDS_PER_HAND);
+      }
+    }
+  }
+  if((totalWeight < 1.0 - 1e-12) || (totalWeight > 1.0 + 1e-12))
+  {
+    mismatches ++;
+  }
+
+  /* Every straight flush equally often */
+  memset(counts, 0, sizeof(counts));
+  initRareSampler(& sampler, StraightFlush, ANY_LEAD_VALUE, 0, 1);
+  for(sampleNum = 0; sampleNum < RARE_UNIFORM_SAMPLES; sampleNum ++)
+  {
+    sampleRareTable(& sampler, & rng, deck);
+    strength = evaluateCardIndices(deck, CARDS_PER_HAND);
+    counts[(strengthBucket(strength) % NUM_OF_RANKS - WHEEL_HIGH_VALUE) *
+      NUM_OF_SUITS + cardIndexSuit(deck[0])] ++;
+  }
+  expected = (double)RARE_UNIFORM_SAMPLES / RARE_UNIFORM_HANDS;
+  for(sampleNum = 0; sampleNum < RARE_UNIFORM_HANDS; sampleNum ++)
+  {
+    chiSquare += (counts[sampleNum] - expected) *
+      (counts[sampleNum] - expected) / expected;
+  }
+  printf(", set sizes and %d tables per lead card checked, straight flush "
+    "chi-square %.2f (39 df)\n", RARE_SAMPLES, chiSquare);
+  if(chiSquare > RARE_CHI_SQUARE_LIMIT)
+  {
+    mismatches ++;
+  }
+  if(mismatches != 0)
+  {
+    printf("MISMATCH %llu rare hand sets or samples are wrong\n", mismatches);
+  }
+  return mismatches;
+}
+
+int main(int argc, const char * argv[])
+{
+  static diffContext context;
+  diffResults total;
+  int numOfThreads = defaultThreadCount();
+  int argNum = 0;
+  int threadNum = 0;
+  int referenceRank = 0;
+  int legacyRank = 0;
+  double started = 0.0;
+  double elapsed = 0.0;
+
+  context.numOfTables = DEFAULT_TABLES;
+  context.seed = DEFAULT_SEED;
+  context.verbose = FALSE;
+  for(argNum = 1; argNum < argc; argNum ++)
+  {
+    if((strcmp(argv[argNum], "-t") == 0) && (argNum + 1 < argc))
+    {
+      numOfThreads = atoi(argv[++ argNum]);
+    }
+    else if((strcmp(argv[argNum], "-n") == 0) && (argNum + 1 < argc))
+    {
+      context.numOfTables = atoll(argv[++ argNum]);
+    }
+    else if((strcmp(argv[argNum], "-s") == 0) && (argNum + 1 < argc))
+    {
+      context.seed = strtoull(argv[++ argNum], NULL, 10);
+    }
+    else if(strcmp(argv[argNum], "-v") == 0)
+    {
+      context.verbose = TRUE;
+    }
+    else
+    {
+      printf("usage: %s [-t threads] [-n tables] [-s seed] [-v]\n", argv[0]);
+      return FAILED_STATUS;
+    }
+  }
+  atomic_init(& context.nextTopCard, STD_DECK_SIZE - 1);
+  atomic_init(& context.nextTable, 0);
+
+  started = currentSeconds();
+  numOfThreads = runParallel(numOfThreads, diffWorker, & context);
+  elapsed = currentSeconds() - started;
+
+  memset(& total, 0, sizeof(total));
+  for(threadNum = 0; threadNum < numOfThreads; threadNum ++)
+  {
+    diffResults * results = & context.results[threadNum];
+    total.handsChecked += results->handsChecked;
+    total.tablesChecked += results->tablesChecked;
+    total.optimizedMismatches += results->optimizedMismatches;
+    total.legacyWinnerDeviations += results->legacyWinnerDeviations;
+    total.legacySeconds += results->legacySeconds;
+    total.optimizedSeconds += results->optimizedSeconds;
+    total.rankSeconds += results->rankSeconds;
+    total.unrankSeconds += results->unrankSeconds;
+    total.canonicalClasses += results->canonicalClasses;
+    total.canonicalWeight += results->canonicalWeight;
+    for(referenceRank = 0; referenceRank < NUM_OF_HAND_RANKS; referenceRank ++)
+    {
+      for(legacyRank = 0; legacyRank < NUM_OF_HAND_RANKS; legacyRank ++)
+      {
+        if
+        (
+          (total.legacyDeviations[referenceRank][legacyRank] == 0) &&
+          (results->legacyDeviations[referenceRank][legacyRank] != 0)
+        )
+        {
+          memcpy(total.legacyExamples[referenceRank][legacyRank],
+            results->legacyExamples[referenceRank][legacyRank],
+            CARDS_PER_HAND);
+        }
+        total.legacyDeviations[referenceRank][legacyRank] +=
+          results->legacyDeviations[referenceRank][legacyRank];
+      }
+    }
+  }
+
+  printf("Checked %llu hands and %llu tables on %d threads in %.2f s\n",
+    total.handsChecked, total.tablesChecked, numOfThreads, elapsed);
+  printf("Throughput per thread: legacy %.2f M hands/s, optimized %.2f M "
+    "hands/s (%.1fx)\n", total.handsChecked / total.legacySeconds / 1e6,
+    total.handsChecked / total.optimizedSeconds / 1e6,
+    total.legacySeconds / total.optimizedSeconds);
+  printf("Colex index: rank %.1f ns/hand, unrank %.1f ns/hand\n",
+    total.rankSeconds * 1e9 / total.handsChecked,
+    total.unrankSeconds * 1e9 / total.handsChecked);
+  printf("Suit classes: %llu canonical hands covering %llu hands\n",
+    total.canonicalClasses, total.canonicalWeight);
+  if((total.canonicalClasses != NUM_OF_CANONICAL_FIVE_CARD_HANDS) ||
+    (total.canonicalWeight != NUM_OF_FIVE_CARD_HANDS))
+  {
+    total.optimizedMismatches ++;
+    printf("MISMATCH expected %d canonical hands covering %d hands\n",
+      NUM_OF_CANONICAL_FIVE_CARD_HANDS, NUM_OF_FIVE_CARD_HANDS);
+  }
+  total.optimizedMismatches += checkSimulationStats(context.seed,
+    numOfThreads);
+  total.optimizedMismatches += checkCheckpointResume(context.seed,
+    numOfThreads);
+  total.optimizedMismatches += checkPipeline(context.seed);
+  total.optimizedMismatches += checkHistoryIndex(context.seed);
+  total.optimizedMismatches += checkBatchShuffle(context.seed);
+  total.optimizedMismatches += checkShuffleAudit(context.seed, numOfThreads);
+  total.optimizedMismatches += checkDrawSolver(context.seed, numOfThreads);
+  total.optimizedMismatches += checkSevenStud(context.seed);
+  total.optimizedMismatches += checkRareHands(context.seed);
+  total.optimizedMismatches += checkCardRemoval(context.seed);
+  total.optimizedMismatches += checkWildCards(context.seed);
+  total.optimizedMismatches += checkHandPercentile(context.seed,
+    numOfThreads);
+  total.optimizedMismatches += checkDynamicTable(context.seed);
+  total.optimizedMismatches += checkStudCfr(context.seed, numOfThreads);
+  total.optimizedMismatches += checkHandRange(context.seed, numOfThreads);
+  total.optimizedMismatches += checkTournament(context.seed, numOfThreads);
+  total.optimizedMismatches += checkStudEquity(context.seed, numOfThreads);
+  total.optimizedMismatches += checkShardMerge(context.seed, numOfThreads);
+  total.optimizedMismatches += checkTrace(context.seed, numOfThreads);
+  total.optimizedMismatches += checkArena(context.seed, numOfThreads);
+  total.optimizedMismatches += checkPlay(context.seed, numOfThreads);
+  total.optimizedMismatches += checkShowdownKernels(context.seed);
+  printLegacyDeviations(& total);
+  if(total.optimizedMismatches != 0)
+  {
+    printf("\nFAILED: %llu optimized mismatches\n", total.optimizedMismatches);
+    return FAILED_STATUS;
+  }
+  printf("\nPASSED: optimized evaluator matches the reference\n");
+  return PASSED_STATUS;
+}
@@ -2,6 +2,8 @@
 #define EXECUTIONSTATUS 0
 /* Functions from DeckOfCards.c */
 #include "PokerTable.h"
+/* Analysis modes, selected with a leading --mode argument */
+#include "PokerModes.h"
 
 /*
 Function to validate the command-line input provided by the user. This program
@@ -27,6 +29,10 @@ int main(int argc, const char * argv[])
   int handNum = NUM_INIT;
   int checkNumOfHands = NUM_INIT;
   char * message = NUM_INIT;
+  if(isPokerMode(argc, argv) == TRUE)
+  {
+    return runPokerMode(argc, argv);
+  }
   if(validateUserInput(argc, argv, & checkNumOfHands) == TRUE)
   {
     pokerTable table;